@@ -0,0 +1,42 @@
+#include "Common/Samplers.hlsl"
+#include "Common/Common.hlsl"
+
+BEGIN_OBJECT_DATA
+END_OBJECT_DATA
+
+BEGIN_BINDLESS_MATERIAL_DATA
+    float4 m_tint;
+    uint m_diffuse;
+    uint3 m_padding0;
+    float4 m_padding1[14];
+END_BINDLESS_MATERIAL_DATA
+
+struct VertexInput
+{
+    float4 positionOS : POSITION;
+    float3 normalOS : NORMAL;
+    float2 uv : TEXCOORD;
+};
+
+struct FragInput
+{
+    float4 positionHS : SV_POSITION;
+    float3 normalWS : NORMAL;
+    float2 uv : TEXCOORD0;
+};
+
+FragInput VsMain(VertexInput input)
+{
+    FragInput o;
+    ObjectData object = ObjectTable[g_object_index];
+    o.positionHS = ObjectToClip(input.positionOS.xyz, object.m_model, m_view, m_projection);
+    o.normalWS = ObjectToWorldNormal(DecodeVertexNormal(input.positionOS, input.normalOS), object.m_model_i);
+    o.uv = input.uv;
+    return o;
+}
+
+float4 PsMain(FragInput input) : SV_TARGET
+{
+    MaterialData material = MaterialTable[g_material_index];
+    return TextureTable[NonUniformResourceIndex(material.m_diffuse)].Sample(LinearSampler, input.uv) * material.m_tint;
+}
@@ -1,6 +1,8 @@
+// the layout has to match InstanceData of the engine, the renderer packs one element per drawn object.
 #define BEGIN_INSTANCE_DATA struct InstanceData {\
     float4x4 m_model;\
-	float4x4 m_model_i;
+	float4x4 m_model_i;\
+	float4 m_color;
 
 #define END_INSTANCE_DATA };\
 StructuredBuffer<InstanceData> InstanceBuffer : register(t0);
@@ -11,12 +13,74 @@ StructuredBuffer<InstanceData> InstanceBuffer : register(t0);
 #define BEGIN_MATERIAL_DATA(x) cbuffer MaterialConstants : register(x) {
 #define END_MATERIAL_DATA }
 
-#define BEGIN_OBJECT_DATA cbuffer ObjectConstants : register(b1) {\
-    float4x4 m_model;\
-    float4x4 m_model_i;\
+// camera matrices are bound once per pass, the object constants live in a persistent slot per object.
+#define BEGIN_OBJECT_DATA cbuffer CameraConstants : register(b0) {\
     float4x4 m_view;\
     float4x4 m_view_i;\
     float4x4 m_projection;\
-    float4x4 m_projection_i;
+    float4x4 m_projection_i;\
+};\
+cbuffer ObjectConstants : register(b1) {\
+    float4x4 m_model;\
+    float4x4 m_model_i;\
+    float4 m_position_offset;\
+    float4 m_position_scale;
+
+#define END_OBJECT_DATA };
+
+// bindless draws read the object and the material from persistent tables, indexed by two root constants per draw.
+// the layout has to match ObjectConstants of the engine, elements are padded to the 256 byte slots of the pools.
+struct ObjectData
+{
+    float4x4 m_model;
+    float4x4 m_model_i;
+    float4 m_position_offset;
+    float4 m_position_scale;
+    float4 m_object_padding[6];
+};
+
+// the members of the material have to be padded to 256 bytes, textures are uint indices into TextureTable.
+#define BEGIN_BINDLESS_MATERIAL_DATA struct MaterialData {
+#define END_BINDLESS_MATERIAL_DATA };\
+cbuffer DrawIndices : register(b0, space1) {\
+    uint g_object_index;\
+    uint g_material_index;\
+};\
+StructuredBuffer<ObjectData> ObjectTable : register(t0, space1);\
+StructuredBuffer<MaterialData> MaterialTable : register(t1, space1);\
+Texture2D<float4> TextureTable[] : register(t0, space2);
+
+
+// the engine stores column vector matrices and the shaders read them column major, which transposes them:
+// points are row vectors multiplied on the left of every matrix.
+float4 ObjectToClip(float3 positionOS, float4x4 model, float4x4 view, float4x4 projection)
+{
+    return mul(mul(mul(float4(positionOS, 1), model), view), projection);
+}
+
+// object space position of a vertex, m_model already dequantizes COMPACT positions for ObjectToClip.
+float3 DequantizePosition(float3 position, float4 offset, float4 scale)
+{
+    return offset.xyz + position * scale.xyz;
+}
+
+// normals go through the inverse transpose of the model matrix.
+float3 ObjectToWorldNormal(float3 normalOS, float4x4 modelInverse)
+{
+    return mul((float3x3) modelInverse, normalOS);
+}
+
+// normals of COMPACT vertices are octahedral snorm16x2, see VertexPacking::DecodeOctahedron of the engine.
+float3 OctahedronDecode(float2 e)
+{
+    float3 n = float3(e, 1 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0);
+    n.xy += n.xy >= 0 ? -t : t;
+    return normalize(n);
+}
 
-#define END_OBJECT_DATA };
\ No newline at end of file
+// declare the position as float4 to tell the formats apart, w is 1 for float positions and 0 for COMPACT ones.
+float3 DecodeVertexNormal(float4 positionOS, float3 normalOS)
+{
+    return positionOS.w > 0.5 ? normalOS : OctahedronDecode(normalOS.xy);
+}
@@ -5,12 +5,11 @@ BEGIN_OBJECT_DATA
 END_OBJECT_DATA
 
 BEGIN_INSTANCE_DATA
-    float4 m_diffuseBias;
 END_INSTANCE_DATA
 
 struct InstanceVertexInput
 {
-    float3 positionOS : POSITION;
+    float4 positionOS : POSITION;
     float3 normalOS : NORMAL;
     float2 uv : TEXCOORD;
     uint   instanceId : SV_InstanceID;
@@ -28,10 +27,10 @@ Texture2D<float4> diffuse : register(t1);
 FragInput VsMain(InstanceVertexInput input)
 {
     FragInput o;
-    float4 worldPosition = mul(m_model, float4(input.positionOS, 1));
-    o.positionHS = mul(m_projection, mul(m_view, worldPosition));
-    o.normalWS = mul((float3x3) transpose(m_model_i), input.normalOS);
-    float4 diffuseBias = InstanceBuffer[input.instanceId].m_diffuseBias;
+    InstanceData instance = InstanceBuffer[input.instanceId];
+    o.positionHS = ObjectToClip(input.positionOS.xyz, instance.m_model, m_view, m_projection);
+    o.normalWS = ObjectToWorldNormal(DecodeVertexNormal(input.positionOS, input.normalOS), instance.m_model_i);
+    float4 diffuseBias = instance.m_color;
     o.uv = input.uv * diffuseBias.xy + diffuseBias.zw;
     return o;
 }
@@ -1,17 +1,11 @@
-cbuffer ObjectConstants : register(b1) {
-    float4x4 m_model;
-    float4x4 m_view;
-    float4x4 m_projection;
-    float4x4 m_model_i;
-	float4x4 m_view_i;
-    float4x4 m_projection_i;
-};
+#include "Common/Common.hlsl"
+
+BEGIN_OBJECT_DATA
+END_OBJECT_DATA
 
 struct SimpleVertexInput
 {
     float3 position : POSITION;
-    float3 normal : NORMAL;
-    float2 uv : TEXCOORD;
 };
 
 struct FragInput
@@ -19,10 +13,10 @@ struct FragInput
     float4 position : SV_POSITION;
 };
 
+// the shaders of the occluders compute the position with the same ObjectToClip.
 FragInput VsMain(SimpleVertexInput input)
 {
     FragInput o;
-    float4 worldPosition = mul(m_model, float4(input.position, 1));
-    o.position = mul(m_projection, mul(m_view, worldPosition));
+    o.position = ObjectToClip(input.position, m_model, m_view, m_projection);
     return o;
 }
\ No newline at end of file
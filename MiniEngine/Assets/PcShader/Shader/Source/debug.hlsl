@@ -39,7 +39,7 @@ FragInput VsMain(SimpleVertexInput input)
     FragInput o;
     float4 worldPosition = float4(input.position, 1);
     o.position = mul(mul(mul(worldPosition, m_model), m_view), m_projection);
-    o.color = float4(input.position + 0.5, 1);
+    o.color = float4(DequantizePosition(input.position, m_position_offset, m_position_scale) + 0.5, 1);
     //o.position = mul(m_proj, mul(m_view, mul(m_model, worldPosition)));
     //o.position = float4(input.position, 1);
     return o;
@@ -7,31 +7,37 @@ struct SimpleVertexInput
     float3 color : COLOR;
     float3 normal : NORMAL;
     float2 uv : TEXCOORD;
+    uint instanceId : SV_InstanceID;
 };
 
 struct FragInput
 {
     float4 position : SV_POSITION;
     float2 uv : TEXCOORD;
+    nointerpolation float4 color : COLOR;
 };
 
 BEGIN_OBJECT_DATA
 END_OBJECT_DATA
 
+BEGIN_INSTANCE_DATA
+END_INSTANCE_DATA
+
 BEGIN_MATERIAL_DATA(b2)
 float4 color;
 float4 blendFactor;
 float4 TextUV;
 END_MATERIAL_DATA
 
-Texture2D tex : register(t0);
+Texture2D tex : register(t1);
 
 FragInput VsMain(SimpleVertexInput input)
 {
     FragInput o;
-    float4 worldPosition = float4(input.position, 1);
-    o.position = mul(mul(mul(worldPosition, m_model), m_view), m_projection);
+    InstanceData instance = InstanceBuffer[input.instanceId];
+    o.position = ObjectToClip(input.position, instance.m_model, m_view, m_projection);
     o.uv = input.uv;
+    o.color = instance.m_color;
     //o.position = mul(m_proj, mul(m_view, mul(m_model, worldPosition)));
     //o.position = float4(input.position, 1);
     return o;
@@ -39,5 +45,5 @@ FragInput VsMain(SimpleVertexInput input)
 
 float4 PsMain(FragInput input) : SV_TARGET
 {
-    return tex.Sample(LinearSampler, input.uv + color.xy);
+    return tex.Sample(LinearSampler, input.uv + input.color.xy);
 }
\ No newline at end of file
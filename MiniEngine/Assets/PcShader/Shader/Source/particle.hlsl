@@ -6,17 +6,22 @@ struct SimpleVertexInput
     float3 color : COLOR;
     float3 normal : NORMAL;
     float2 uv : TEXCOORD;
+    uint instanceId : SV_InstanceID;
 };
 
 struct FragInput
 {
     float4 position : SV_POSITION;
     float2 uv : TEXCOORD;
+    nointerpolation float4 color : COLOR;
 };
 
 BEGIN_OBJECT_DATA
 END_OBJECT_DATA
 
+BEGIN_INSTANCE_DATA
+END_INSTANCE_DATA
+
 BEGIN_MATERIAL_DATA(b2)
 float4 color;
 float4 blendFactor;
@@ -27,12 +32,14 @@ FragInput VsMain(SimpleVertexInput input)
 {
     FragInput o;
     float4 worldPosition = float4(input.position, 1);
-    o.position = mul(mul(mul(worldPosition, m_model), m_view), m_projection);
+    InstanceData instance = InstanceBuffer[input.instanceId];
+    o.position = mul(mul(mul(worldPosition, instance.m_model), m_view), m_projection);
     o.uv = input.uv;
+    o.color = instance.m_color;
     return o;
 }
 
 float4 PsMain(FragInput input) : SV_TARGET
 {
-    return color;
+    return input.color;
 }
\ No newline at end of file
@@ -29,8 +29,7 @@ Texture2D tex : register(t0);
 FragInput VsMain(SimpleVertexInput input)
 {
     FragInput o;
-    float4 worldPosition = float4(input.position, 1);
-    o.position = mul(mul(mul(worldPosition, m_model), m_view), m_projection);
+    o.position = ObjectToClip(input.position, m_model, m_view, m_projection);
     o.uv = input.uv;
     return o;
 }
@@ -4,6 +4,8 @@
 
 #include <iostream>
 
+#include "Engine/Utility/Telemetry/Telemetry.h"
+
 NavigationMap* NavigationMap::sInstance = nullptr;
 
 
@@ -29,6 +31,7 @@ void NavigationMap::setAiMap(MapData* mapData)
 
 std::vector<std::pair<int, int>> NavigationMap::pathFinding(int startX, int startZ, int endX, int endZ) const
 {
+    TELEMETRY_COUNT(PATH_QUERIES, 1);
     std::vector<std::pair<int, int>> path;
     if (startX == endX && startZ == endZ)
     {
@@ -10,9 +10,13 @@
 #include "Component/RenderComponent/Camera.h"
 
 #include "Dependencies/rapidxml/rapidxml_utils.hpp"
+#include "FileManager/FileManager.h"
 #include "Utility/GameTime/GameTime.h"
+#include "Utility/Profiler/Profiler.h"
+#include "Utility/Telemetry/Telemetry.h"
 #include "Utility/ThreadPool/ThreadPool.h"
 #include "Memory/TankinMemory.h"
+#include "Memory/MemoryTracker.h"
 #include "render/Renderer.h"
 #include "Scene/Scene.h"
 #include "InputControl/TankinInput.h"
@@ -48,6 +52,10 @@ void Application::sInit()
    //Load configure file
    Application::sLoadConfigFile();
 
+#ifdef ENABLE_PROFILER
+   Profiler::sInit();
+#endif
+
    //need Initiate self first
    sThreadPool = new ThreadPool(8, 32, 300, RejectionPolicy::ThrowException);
    
@@ -78,7 +86,9 @@ void Application::sInit()
 #endif
    //Renderer
    Renderer::GetInstance().initialize();
-#ifdef WIN32
+   FileManager::sLoadShaderCache("Shader/ShaderCache.bin");
+   FileManager::sLoadPipelineStates("Shader/PipelineStates.bin", "Shader/PipelineLibrary.bin");
+#if defined(WIN32) && !defined(USE_NULL_RHI)
    ImguiManager::sGetInstance()->init();
 #endif
 
@@ -96,6 +106,33 @@ void Application::sLoadConfigFile()
    doc->parse<0>(xmlFile->data());
    auto rootnode = doc->first_node("Engine");
    Scene::sSceneFilePath = sDataPath + rootnode->first_attribute("DefaultScene")->value();
+
+   //optional memory budgets in MB, e.g. <MemoryBudget Render="512" Assets="256"/>
+   if (auto budgetNode = rootnode->first_node("MemoryBudget"))
+   {
+      for (uint8_t i = 0; i < static_cast<uint8_t>(MemoryTag::COUNT); ++i)
+      {
+         MemoryTag tag = static_cast<MemoryTag>(i);
+         if (auto attribute = budgetNode->first_attribute(MemoryTracker::GetTagName(tag)))
+         {
+            MemoryTracker::SetBudget(tag, std::stoull(attribute->value()) * 1024 * 1024);
+         }
+      }
+   }
+
+#ifdef ENABLE_TELEMETRY
+   //optional telemetry dump settings, e.g. <Telemetry Output="Telemetry/" DumpInterval="5"/>, DumpInterval="0" disables dumping
+   TpString telemetryOutput;
+   float telemetryDumpInterval = 5.0f;
+   if (auto telemetryNode = rootnode->first_node("Telemetry"))
+   {
+      if (auto attribute = telemetryNode->first_attribute("Output"))
+         telemetryOutput = attribute->value();
+      if (auto attribute = telemetryNode->first_attribute("DumpInterval"))
+         telemetryDumpInterval = std::stof(attribute->value());
+   }
+   Telemetry::sInit(telemetryOutput, telemetryDumpInterval, sThreadPool);
+#endif
 }
 
 void Application::sRun()
@@ -119,8 +156,12 @@ void Application::sRun()
    	while (!isQuit)
 #endif
    {
+      PROFILE_FRAME();
+      PROFILE_SCOPE("Application::sRun");
+
       if (Scene::sNeedLoadScene)
       {
+         PROFILE_SCOPE("Scene::sLoadScene");
          Scene::sLoadScene();
          GameTime::sFreshGameTime(); //avoid loading time influence fps compute
          if (Scene::sDirectEnterGamePlay)
@@ -132,38 +173,74 @@ void Application::sRun()
       
       DEBUG_PRINT("---------------------New Frame------------------------\n");
 
-      Component::sFixedUpdateAllComponent();
+      {
+         PROFILE_SCOPE("Component::sFixedUpdateAllComponent");
+         TELEMETRY_TIMER(GAMEPLAY);
+         Component::sFixedUpdateAllComponent();
+      }
 
       //Physics
       //do not update in Editor mode
       if (sRunningType != EngineRunningType::Editor)
       {
+         PROFILE_SCOPE("PhysicSystem::update");
+         TELEMETRY_TIMER(PHYSICS);
          PhysicSystem::getInstance().update(GameTime::sGetFixedDeltaTime());
       }
       
       //GameLogic
-      Component::sUpdateAllComponent();
+      {
+         PROFILE_SCOPE("Component::sUpdateAllComponent");
+         TELEMETRY_TIMER(GAMEPLAY);
+         Component::sUpdateAllComponent();
+      }
       
       //imGui
-#ifdef WIN32
-      ImguiManager::sGetInstance()->flushFrame();
+#if defined(WIN32) && !defined(USE_NULL_RHI)
+      {
+         PROFILE_SCOPE("ImguiManager::flushFrame");
+         ImguiManager::sGetInstance()->flushFrame();
+      }
 #endif
       
       //render
       DEBUG_PRINT("Render Starts\n");
-      Camera::sRenderScene(); 
+      {
+         PROFILE_SCOPE("Camera::sRenderScene");
+         TELEMETRY_TIMER(RENDER);
+         Camera::sRenderScene();
+      }
       
       DEBUG_PRINT("Render End\n");
       
 
-      //Update Timer
-      GameTime::sUpdate();
+      //Update Timer, includes the frame limiter wait
+      {
+         PROFILE_SCOPE("GameTime::sUpdate");
+         GameTime::sUpdate();
+      }
 
       TankinInput::sGetInstance()->update();
 
-      ComponentFactory::sGarbageCollect();
-      GameObjectFactory::sGarbageCollect();
+      {
+         PROFILE_SCOPE("GarbageCollect");
+         ComponentFactory::sGarbageCollect();
+         GameObjectFactory::sGarbageCollect();
+      }
+
+#ifdef ENABLE_TELEMETRY
+      Telemetry::sEndFrame();
+#endif
    }
+
+   FileManager::sSavePipelineStates("Shader/PipelineStates.bin", "Shader/PipelineLibrary.bin");
+
+#ifdef ENABLE_TELEMETRY
+   Telemetry::sShutdown();
+#endif
+
+   MemoryTracker::PrintSnapshot(MemoryTracker::TakeSnapshot(), "Memory at shutdown");
+   MemoryTracker::ReportLeaks();
 }
 
 void Application::sSetRunningType(EngineRunningType type)
@@ -19,6 +19,9 @@ enum EngineRunningType:uint8_t
 class Application
 {
 public:
+    //priority of thread pool tasks the current frame waits for, ahead of asset loading which uses 1
+    static constexpr int FRAME_TASK_PRIORITY = 2;
+
     static const std::string& sGetDataPath() { return sDataPath; }
     static void sSetDataPath(const std::string& dataPath) { sDataPath = dataPath; }
     static ThreadPool* sGetThreadPool() {return sThreadPool;}
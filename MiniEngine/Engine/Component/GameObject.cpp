@@ -51,6 +51,11 @@ Component* GameObject::addComponentWithoutCalling(const TpString& componentName)
     cm->mGameObject = this;
     
     mComponents[componentName] = cm;
+    if (mTransform != nullptr)
+    {
+        //renderable components change the visibility proxy of this object
+        mTransform->markMoved();
+    }
 
     //do not call awake and onEnable
     if (dynamic_cast<MonoBehavior*>(cm) == nullptr)
@@ -223,6 +228,11 @@ Component* GameObject::addComponent(const std::string& componentName)
     cm->mGameObject = this;
     
     mComponents[componentName] = cm;
+    if (mTransform != nullptr)
+    {
+        //renderable components change the visibility proxy of this object
+        mTransform->markMoved();
+    }
 
     //we need call awake and onEnable after bind go
     cm->awake();
@@ -239,6 +249,10 @@ void GameObject::removeComponent(const std::string& componentName)
     ComponentFactory::sDestroyComponent(iter->second);
     
     mComponents.erase(iter);
+    if (mTransform != nullptr)
+    {
+        mTransform->markMoved();
+    }
 }
 
 Component* GameObject::getComponent(const std::string& componentName)
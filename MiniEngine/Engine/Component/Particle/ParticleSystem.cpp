@@ -8,9 +8,17 @@
 #include "Engine/render/MeshData.h"
 #include "Engine/render/Renderer.h"
 #include "Engine/Utility/Random.h"
+#include "Engine/Utility/Telemetry/Telemetry.h"
 
 REGISTER_COMPONENT(ParticleSystem, "ParticleSystem")
 
+namespace
+{
+    // variables of the particle material constants
+    constexpr uint64_t COLOR_ID = MaterialInstance::PropertyId("color");
+    constexpr uint64_t BLEND_FACTOR_ID = MaterialInstance::PropertyId("blendFactor");
+}
+
 void ParticleSystem::awake()
 {
     mTransform = mGameObject->getTransform();
@@ -70,18 +78,51 @@ void ParticleSystem::activateParticles()
             mIsStop = true;
         }
     }
+    if (count > 0)
+    {
+        //the whole spawn sphere, so the bounds of a still emitter stay the same while it emits
+        const Vector3 position = mTransform->getWorldPosition();
+        const float radius = std::abs(mRandomRadius);
+        const float min[3] = {position.v.x - radius, position.v.y - radius, position.v.z - radius};
+        const float max[3] = {position.v.x + radius, position.v.y + radius, position.v.z + radius};
+        mSpawnBounds[0].Merge(BoundingBox::FromMinMax(min, max));
+    }
 }
 
 void ParticleSystem::update()
 {
+    //particles live at most 1.5 lifetimes, see activateParticles
+    mSpawnBoundsAge += GameTime::sGetDeltaTime();
+    if (mSpawnBoundsAge >= mLifeTimeSecond * 1.5f)
+    {
+        mSpawnBounds[1] = mSpawnBounds[0];
+        mSpawnBounds[0] = {};
+        mSpawnBoundsAge = 0;
+    }
+
     activateParticles();
+    mAliveCount = 0;
     for (auto& particle : mParticles)
     {
         if (!particle.mIsDie)
         {
             particle.update(GameTime::sGetDeltaTime(), mAirResistanceCoefficient);
+            ++mAliveCount;
         }
     }
+    TELEMETRY_COUNT(PARTICLES_ALIVE, mAliveCount);
+
+    //the scene proxy only needs an update when the bounds change, not every time the particles move
+    BoundingBox bounds;
+    if (!getWorldBounds(bounds))
+    {
+        bounds = {};
+    }
+    if (memcmp(&bounds, &mProxyBounds, sizeof(BoundingBox)) != 0)
+    {
+        mProxyBounds = bounds;
+        mTransform->markMoved();
+    }
 }
 
 void ParticleSystem::prepareRenderList()
@@ -99,12 +140,7 @@ void ParticleSystem::prepareRenderList()
 
             renderItem.mMaterial = particle.mMaterialGpu.get();
 
-            // const Blob& cbuffer = particle.mMaterialGpu->GetConstantBuffer(0);
-            struct alignas(256) UniversalCBuffer
-            {
-                float mColor[4];
-                float mBlendFactor[4];
-            }universalCBuffer;
+            float color[4];
             
             if (isFire)
             {
@@ -125,22 +161,20 @@ void ParticleSystem::prepareRenderList()
                     finalColor.value = Vector3::Lerp(Color::BLACK.value, Color::RED.value, lerpFactor-0.4);
                 }
 
-                universalCBuffer.mColor[0] = finalColor.value.v.x;
-                universalCBuffer.mColor[1] = finalColor.value.v.y;
-                universalCBuffer.mColor[2] = finalColor.value.v.z;
-                universalCBuffer.mColor[3] = 1;
-                universalCBuffer.mBlendFactor[0] = 1;
-                particle.mMaterialGpu->UpdateConstantBuffer(0, &universalCBuffer, sizeof(universalCBuffer));
+                color[0] = finalColor.value.v.x;
+                color[1] = finalColor.value.v.y;
+                color[2] = finalColor.value.v.z;
             }
             else
             {
-                universalCBuffer.mColor[0] = mColor.value.v.x;
-                universalCBuffer.mColor[1] = mColor.value.v.y;
-                universalCBuffer.mColor[2] = mColor.value.v.z;
-                universalCBuffer.mColor[3] = 1;
-                universalCBuffer.mBlendFactor[0] = 1;
-                particle.mMaterialGpu->UpdateConstantBuffer(0, &universalCBuffer, sizeof(universalCBuffer));
+                color[0] = mColor.value.v.x;
+                color[1] = mColor.value.v.y;
+                color[2] = mColor.value.v.z;
             }
+            color[3] = 1;
+            particle.mMaterialGpu->SetConstant(COLOR_ID, color);
+            particle.mMaterialGpu->SetConstant(BLEND_FACTOR_ID, 1.0f);
+            renderItem.mColor = {color[0], color[1], color[2], color[3]};
             
             Camera* currentCamera = Camera::sGetCurrentCamera();
             ASSERT(currentCamera, TEXT("current camera is null!"));
@@ -149,6 +183,30 @@ void ParticleSystem::prepareRenderList()
     }
 }
 
+bool ParticleSystem::getWorldBounds(BoundingBox& bounds) const
+{
+    if (mAliveCount == 0)
+        return false;
+    const BoundingBox& meshBounds = FileManager::sGetLoadedMeshBounds(mMeshName);
+    if (!meshBounds.IsValid())
+        return false;
+    bounds = mSpawnBounds[0];
+    bounds.Merge(mSpawnBounds[1]);
+    if (!bounds.IsValid())
+        return false;
+
+    //furthest a particle travels from its spawn point, the air resistance only slows it down
+    const float lifeTime = mLifeTimeSecond * 1.5f;
+    const float travel = std::abs(mParticleSpeed) * lifeTime + 0.5f * mAcceleration.Length() * lifeTime * lifeTime;
+    //largest particle mesh, see Particle::getModelMatrix
+    const float scale = 0.01f * std::max(std::abs(mRandomSizeRange.v.x), std::abs(mRandomSizeRange.v.y));
+    for (int i = 0; i < 3; ++i)
+    {
+        bounds.mExtents[i] += travel + scale * (std::abs(meshBounds.mCenter[i]) + meshBounds.mExtents[i]);
+    }
+    return true;
+}
+
 Vector3 ParticleSystem::getRandomDirectionInCone(Vector3 forward, Vector3 right, float coneAngleRad) const
 {
     float randomAxisAngle = Random::Float() * 2 * MathUtils::PI;
@@ -3,6 +3,7 @@
 #include "Engine/Component/Transform.h"
 #include "Particle.h"
 #include "Engine/render/Color.h"
+#include "Engine/render/BoundingBox.h"
 
 class ParticleSystem:public Component
 {
@@ -17,6 +18,8 @@ public:
     
     void activateParticles();
     void prepareRenderList();
+    //reach of the emitter over the lifetime of its particles, returns false when there is nothing to render
+    bool getWorldBounds(BoundingBox& bounds) const;
     Vector3 getRandomDirectionInCone(Vector3 forward, Vector3 right, float coneAngleRad) const;
     rapidxml::xml_node<>* serialize(rapidxml::xml_document<>* doc, rapidxml::xml_node<>* father,
         const TpString& value) override;
@@ -50,6 +53,12 @@ public:
 private:
     Transform* mTransform = nullptr;
     std::vector<Particle> mParticles;
+    int64_t mAliveCount = 0;
+    //spawn points of the current and the previous lifetime window, every alive particle was spawned in one of them
+    BoundingBox mSpawnBounds[2];
+    float mSpawnBoundsAge = 0;
+    //bounds last given to the scene proxy
+    BoundingBox mProxyBounds;
 
     //render
     TpString mTextureName;
@@ -9,7 +9,11 @@
 #include "Engine/Component/Physics/RigidBody.h"
 #include "Engine/Component/TGUI/ImageTGUI.h"
 #include "Engine/Utility/MacroUtility.h"
+#include "Engine/render/SceneOctree.h"
 #include "Engine/render/Renderer.h"
+#include "Engine/Utility/Profiler/Profiler.h"
+#include "Engine/Utility/Telemetry/Telemetry.h"
+#include "Engine/Utility/ThreadPool/ThreadPool.h"
 #include "Engine/Window/Frame.h"
 
 static ComponentRegister::Register<Camera> TankControllerRegister("Camera");
@@ -33,6 +37,26 @@ Vector2 Camera::transformWorldToScreen(const Vector3& worldPos) const
     return {result.v.x, result.v.y};
 }
 
+float Camera::getScreenSize(const BoundingBox& worldBounds) const
+{
+    const float radius = std::sqrt(worldBounds.mExtents[0] * worldBounds.mExtents[0] +
+        worldBounds.mExtents[1] * worldBounds.mExtents[1] + worldBounds.mExtents[2] * worldBounds.mExtents[2]);
+    const Matrix4x4& projection = mRenderList.mCameraConstants.mProjection;
+    if (mType == CameraType::Orthographic)
+    {
+        return radius * projection.m.m[1][1];
+    }
+    //the projection divides by the view space depth
+    const Matrix4x4& view = mRenderList.mCameraConstants.mView;
+    const float depth = view.m.m[2][0] * worldBounds.mCenter[0] + view.m.m[2][1] * worldBounds.mCenter[1] +
+        view.m.m[2][2] * worldBounds.mCenter[2] + view.m.m[2][3];
+    if (depth <= radius)
+    {
+        return FLT_MAX;
+    }
+    return radius * projection.m.m[1][1] / depth;
+}
+
 rapidxml::xml_node<>* Camera::serialize(rapidxml::xml_document<>* doc, rapidxml::xml_node<>* father,
     const TpString& value)
 {
@@ -189,6 +213,16 @@ void Camera::setOrthographicMatrix(const float width, const float height, const
 }
 
 
+namespace
+{
+    //visible objects are split into chunks extracted on the thread pool, every chunk fills its own list
+    constexpr uint32_t MAX_EXTRACTION_TASKS = 4;
+    constexpr uint32_t MIN_PROXIES_PER_EXTRACTION_TASK = 64;
+    std::vector<RenderItem> sTaskRenderItems[MAX_EXTRACTION_TASKS];
+    //set while the thread extracts a chunk, render items go there instead of the camera's list
+    thread_local std::vector<RenderItem>* tTaskRenderItems = nullptr;
+}
+
 void Camera::clearRenderList()
 {
     //DEBUG_PRINT("<%s> Camera Component clearRenderList()\n", mGameObject->getName().c_str());
@@ -198,6 +232,11 @@ void Camera::clearRenderList()
 void Camera::addRenderItem(const RenderItem& item)
 {
     //DEBUG_PRINT("<%s> Camera Component addRenderItem()\n", mGameObject->getName().c_str());
+    if (tTaskRenderItems != nullptr)
+    {
+        tTaskRenderItems->push_back(item);
+        return;
+    }
     mRenderList.mOpaqueList.push_back(item);
 }
 
@@ -209,6 +248,115 @@ void Camera::setDepth(const unsigned char depth)
 }
 
 ///render all gameObject which has meshRenderer component in this scene
+namespace
+{
+    //renderable objects with bounds, the payload is their Transform
+    SceneOctree sSceneOctree;
+    //renderable objects that are never culled, like ui, in the order they became renderable
+    std::vector<Transform*> sUnboundedProxies;
+    std::vector<void*> sVisibleProxies;
+    //static transforms, like the root of the tree in Transform.cpp, may be destroyed after the proxies above
+    bool sSceneProxiesDestroyed = false;
+    struct SceneProxiesGuard
+    {
+        ~SceneProxiesGuard() { sSceneProxiesDestroyed = true; }
+    } sSceneProxiesGuard;
+
+    bool sIsActiveInHierarchy(const Transform* transform)
+    {
+        for (; transform != nullptr; transform = transform->getParent())
+        {
+            if (!transform->getGameObject()->isActive())
+                return false;
+        }
+        return true;
+    }
+}
+
+void Camera::sUpdateSceneProxy(Transform* transform)
+{
+    GameObject* go = transform->getGameObject();
+    BoundingBox bounds;
+    bool unbounded = false;
+    if (go != nullptr)
+    {
+        //ui is laid out by its canvas and always rendered
+        unbounded = go->getComponent("ImageTGUI") || go->getComponent("Button") || go->getComponent("TextTGUI");
+
+        //the moved transforms are also the dirty set of the persistent object constants
+        Renderer& renderer = Renderer::GetInstance();
+        for (const char* name : {"ImageTGUI", "Button"})
+        {
+            if (ImageTGUI* image = dynamic_cast<ImageTGUI*>(go->getComponent(name)))
+                renderer.invalidateObjectConstants(image->getObjectSlot());
+        }
+
+        BoundingBox componentBounds;
+        if (MeshRenderer* meshRenderer = dynamic_cast<MeshRenderer*>(go->getComponent("MeshRenderer")))
+        {
+            renderer.invalidateObjectConstants(meshRenderer->getObjectSlot());
+            if (meshRenderer->getWorldBounds(componentBounds))
+                bounds.Merge(componentBounds);
+            else
+                unbounded = true;
+        }
+        if (ParticleSystem* particle = dynamic_cast<ParticleSystem*>(go->getComponent("ParticleSystem")))
+        {
+            if (particle->getWorldBounds(componentBounds))
+                bounds.Merge(componentBounds);
+        }
+        //colliders without a mesh are only drawn by debug cameras, they follow the mesh bounds otherwise
+        if (!bounds.IsValid() && go->getComponent("RigidBody"))
+            unbounded = true;
+    }
+
+    if (unbounded || !bounds.IsValid())
+    {
+        if (transform->mSceneHandle != SceneOctree::INVALID_HANDLE)
+        {
+            sSceneOctree.Remove(transform->mSceneHandle);
+            transform->mSceneHandle = SceneOctree::INVALID_HANDLE;
+        }
+        if (unbounded && !transform->mSceneUnbounded)
+        {
+            sUnboundedProxies.push_back(transform);
+            transform->mSceneUnbounded = true;
+        }
+        else if (!unbounded && transform->mSceneUnbounded)
+        {
+            sUnboundedProxies.erase(std::find(sUnboundedProxies.begin(), sUnboundedProxies.end(), transform));
+            transform->mSceneUnbounded = false;
+        }
+        return;
+    }
+
+    if (transform->mSceneUnbounded)
+    {
+        sUnboundedProxies.erase(std::find(sUnboundedProxies.begin(), sUnboundedProxies.end(), transform));
+        transform->mSceneUnbounded = false;
+    }
+    if (transform->mSceneHandle == SceneOctree::INVALID_HANDLE)
+        transform->mSceneHandle = sSceneOctree.Insert(transform, bounds);
+    else
+        sSceneOctree.Update(transform->mSceneHandle, bounds);
+}
+
+void Camera::sRemoveSceneProxy(Transform* transform)
+{
+    if (sSceneProxiesDestroyed)
+        return;
+    if (transform->mSceneHandle != SceneOctree::INVALID_HANDLE)
+    {
+        sSceneOctree.Remove(transform->mSceneHandle);
+        transform->mSceneHandle = SceneOctree::INVALID_HANDLE;
+    }
+    if (transform->mSceneUnbounded)
+    {
+        sUnboundedProxies.erase(std::find(sUnboundedProxies.begin(), sUnboundedProxies.end(), transform));
+        transform->mSceneUnbounded = false;
+    }
+}
+
 void Camera::sRenderScene()
 {
     std::function<void(const Transform* transform)> func =
@@ -217,7 +365,7 @@ void Camera::sRenderScene()
             GameObject* go = transform->getGameObject();
             ASSERT(go != nullptr, TEXT("GameObject pointer is nullptr"));
             
-            if (!(go->isActive()))
+            if (!sIsActiveInHierarchy(transform))
             {
                 return;
             }
@@ -286,6 +434,12 @@ void Camera::sRenderScene()
                 renderer->prepareRenderList();
             }
         };
+
+    //bring the scene partition up to date with everything that moved since the last frame
+    {
+        PROFILE_SCOPE("Camera::updateScenePartition");
+        Transform::sFlushMovedTransforms(sUpdateSceneProxy);
+    }
     
     Renderer& renderer = Renderer::GetInstance();
     
@@ -316,8 +470,73 @@ void Camera::sRenderScene()
         camera->uploadMatrix();
 
         //iterate all go to render
-        Transform* root = Transform::sGetRoot();
-        root->foreachActiveLevelOrder(func);
+        {
+            PROFILE_SCOPE("Camera::prepareRenderList");
+            //query the scene partition with the view projection of this camera
+            const CameraConstants& constants = sCurrentCamera->mRenderList.mCameraConstants;
+            Frustum frustum = Frustum::FromViewProjection(constants.mProjection * constants.mView);
+            sVisibleProxies.clear();
+            uint32_t numVisible = sSceneOctree.Query(frustum, sVisibleProxies);
+            sCurrentCamera->mCullingStats = {numVisible, sSceneOctree.Size() - numVisible};
+            TELEMETRY_COUNT(VISIBLE_OBJECTS, numVisible);
+            TELEMETRY_COUNT(CULLED_OBJECTS, sSceneOctree.Size() - numVisible);
+
+            ThreadPool* threadPool = Application::sGetThreadPool();
+            const uint32_t numTasks = threadPool == nullptr ? 1 :
+                std::max(1u, std::min(MAX_EXTRACTION_TASKS, numVisible / MIN_PROXIES_PER_EXTRACTION_TASK));
+            if (numTasks == 1)
+            {
+                for (void* proxy : sVisibleProxies)
+                {
+                    func(static_cast<const Transform*>(proxy));
+                }
+            }
+            else
+            {
+                PROFILE_SCOPE("Camera::extractInParallel");
+                auto extractChunk = [&func](uint32_t task, uint32_t begin, uint32_t end)
+                {
+                    std::vector<RenderItem>& renderItems = sTaskRenderItems[task];
+                    renderItems.clear();
+                    tTaskRenderItems = &renderItems;
+                    for (uint32_t i = begin; i < end; ++i)
+                    {
+                        func(static_cast<const Transform*>(sVisibleProxies[i]));
+                    }
+                    tTaskRenderItems = nullptr;
+                };
+                std::future<void> extractions[MAX_EXTRACTION_TASKS];
+                for (uint32_t task = 1; task < numTasks; ++task)
+                {
+                    extractions[task] = threadPool->enqueue(Application::FRAME_TASK_PRIORITY, extractChunk,
+                        task, numVisible * task / numTasks, numVisible * (task + 1) / numTasks);
+                }
+                //the main thread extracts the first chunk instead of idling
+                extractChunk(0, 0, numVisible / numTasks);
+                for (uint32_t task = 1; task < numTasks; ++task)
+                {
+                    extractions[task].wait();
+                }
+                for (uint32_t task = 1; task < numTasks; ++task)
+                {
+                    extractions[task].get();
+                }
+
+                //chunks are merged in order, the list matches a serial walk and the renderer sorts it by key
+                std::vector<RenderItem>& opaqueList = sCurrentCamera->mRenderList.mOpaqueList;
+                for (uint32_t task = 0; task < numTasks; ++task)
+                {
+                    std::vector<RenderItem>& renderItems = sTaskRenderItems[task];
+                    opaqueList.insert(opaqueList.end(), std::make_move_iterator(renderItems.begin()), std::make_move_iterator(renderItems.end()));
+                    renderItems.clear();
+                }
+            }
+            //ui goes last so it stays on top of the scene
+            for (const Transform* transform : sUnboundedProxies)
+            {
+                func(transform);
+            }
+        }
 
         //Upload RenderList and Start Render---------------------------------------------------------------------------
         //sCurrentCamera->mRenderList.printSelf();
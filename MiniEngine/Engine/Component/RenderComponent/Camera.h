@@ -23,11 +23,20 @@ class Camera final:public Component
 public:
     friend class ComponentFactory;
     friend class ComponentRegister;
+    friend class Transform;
     
     //render
     static void sRenderScene();
     static Camera* sGetCurrentCamera(){return sCurrentCamera;}
 
+    //frustum culling result of the last rendered frame
+    struct CullingStats
+    {
+        uint32_t mVisible = 0;
+        uint32_t mCulled = 0;
+    };
+    const CullingStats& getCullingStats() const {return mCullingStats;}
+
     void start() override;
     void onEnable() override;
     void update() override;
@@ -48,6 +57,9 @@ public:
 
     //transform 3d pos and 2d pos
     Vector2 transformWorldToScreen(const Vector3& worldPos) const;
+    //diameter of the bounding sphere of the bounds on screen as a fraction of the viewport height, for level of detail
+    //selection. uses the matrices uploaded for the frame being rendered
+    float getScreenSize(const BoundingBox& worldBounds) const;
 
     static Camera* sGetMainCamera() {return sMainCamera;}
     static void sSetMainCamera(Camera* camera) {sMainCamera = camera; camera->isMainCamera = true;}
@@ -79,6 +91,10 @@ private:
     ~Camera() override;
     
     void uploadMatrix();
+
+    //scene partition, objects are refreshed after their transform moved and removed with their transform
+    static void sUpdateSceneProxy(Transform* transform);
+    static void sRemoveSceneProxy(Transform* transform);
     
     //projection
     Matrix4x4 mProjectiveMatrix;
@@ -105,6 +121,9 @@ private:
     //render item list which need to be rendered each frame
     RenderList mRenderList;
 
+    //objects with bounds that passed or failed the frustum test
+    CullingStats mCullingStats;
+
     //whether render collider
     bool mRenderCollider = false;
 
@@ -1,5 +1,7 @@
 ﻿#include "MeshFilter.h"
+#include "MeshRenderer.h"
 #include "../GameObject.h"
+#include "../Transform.h"
 #include "Engine/FileManager/FileManager.h"
 #include "Engine/render/MeshData.h"
 
@@ -16,13 +18,34 @@ void MeshFilter::update()
     DEBUG_PRINT("<%s> MeshFilter Component Update()\n", mGameObject->getName().c_str());
 }
 
+void MeshFilter::onDestory()
+{
+    //the renderer of this object caches the filter
+    MeshRenderer* renderer = dynamic_cast<MeshRenderer*>(mGameObject->getComponent("MeshRenderer"));
+    if (renderer != nullptr)
+    {
+        renderer->mMeshFilter = nullptr;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void MeshFilter::setMesh(const TpString& meshName)
+{
+    mMeshName = meshName;
+    //bounds depend on the mesh
+    mGameObject->getTransform()->markMoved();
+}
 
 MeshData MeshFilter::getMeshData() const
 {
     return FileManager::sGetLoadedBolbFile<MeshData>(mMeshName);
 }
 
+const BoundingBox& MeshFilter::getLocalBounds() const
+{
+    return FileManager::sGetLoadedMeshBounds(mMeshName);
+}
+
 rapidxml::xml_node<>* MeshFilter::serialize(rapidxml::xml_document<>* doc, rapidxml::xml_node<>* father,
     const TpString& value)
 {
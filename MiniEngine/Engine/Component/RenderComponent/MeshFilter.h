@@ -10,10 +10,12 @@ class MeshFilter:public Component
 public:
     void start() override;
     void update() override;
+    void onDestory() override;
     
-    void setMesh(const TpString& meshName){mMeshName = meshName;}
+    void setMesh(const TpString& meshName);
 
     MeshData getMeshData() const;
+    const BoundingBox& getLocalBounds() const;
     rapidxml::xml_node<>* serialize(rapidxml::xml_document<>* doc, rapidxml::xml_node<>* father,
         const TpString& value) override;
     void deSerialize(const rapidxml::xml_node<>* node) override;
@@ -11,6 +11,7 @@
 #include "Engine/FileManager/FileManager.h"
 #include "Engine/render/Renderer.h"
 #include "Engine/render/DataCPU/RenderData.h"
+#include "Engine/Utility/Telemetry/Telemetry.h"
 
 REGISTER_COMPONENT(MeshRenderer, "MeshRenderer")
 
@@ -20,6 +21,13 @@ void MeshRenderer::awake()
     // mMaterialGpu = nullptr;
     // mMaterialGpu->shader = FileManager::sGetLoadedBolbFile<ShaderData>("debug").shader;
     mMaterialGpu = Renderer::GetInstance().createMaterialInstance(*FileManager::sGetLoadedBolbFile<Material*>(mShaderName));
+    applyDepthPrePass();
+    mObjectSlot = Renderer::GetInstance().allocObjectConstants();
+}
+
+MeshRenderer::~MeshRenderer()
+{
+    Renderer::GetInstance().releaseObjectConstants(mObjectSlot);
 }
 
 
@@ -28,6 +36,7 @@ void MeshRenderer::setShader(const TpString& shaderName)
 {
     // mMaterialGpu->setBlend(). = FileManager::sGetLoadedBolbFile<ShaderData>(shaderName).shader; // TODO: get material instance by shader name
     mMaterialGpu = Renderer::GetInstance().createMaterialInstance(*FileManager::sGetLoadedBolbFile<Material*>(shaderName));
+    applyDepthPrePass();
     mShaderName = shaderName;
 }
 
@@ -38,23 +47,70 @@ void MeshRenderer::setTexture(const TpString& textureName)
     mTextureName = textureName;
 }
 
+void MeshRenderer::setDepthPrePass(bool enable)
+{
+    mDepthPrePass = enable;
+    applyDepthPrePass();
+}
+
+void MeshRenderer::applyDepthPrePass()
+{
+    //blended objects do not hide what is behind them, occluders are drawn opaque
+    mMaterialGpu->SetEnableDepthPrePass(mDepthPrePass);
+    mMaterialGpu->setBlend(mDepthPrePass ? BlendDesc::Disabled() : BlendDesc::Color());
+}
+
+uint32_t& MeshRenderer::lastLod(const Camera* camera) const
+{
+    //a scene has a handful of cameras. a destroyed camera only leaves a stale level, selectLod corrects it in one frame
+    for (auto& [owner, lod] : mLods)
+    {
+        if (owner == camera) return lod;
+    }
+    return mLods.emplace_back(camera, 0).second;
+}
+
 void MeshRenderer::prepareRenderList() const
 {
     DEBUG_PRINT("Render %s\n", getGameObject()->getName().c_str());
-    MeshFilter* filter = dynamic_cast<MeshFilter*>(mGameObject->getComponent("MeshFilter"));
+    MeshFilter* filter = getMeshFilter();
     ASSERT(filter, TEXT("this object do not have MeshFilter Component!"));
 
     //mesh
-    MeshData meshData = filter->getMeshData();
-    
     RenderItem renderItem;
-    renderItem.mMeshData = meshData;
+    renderItem.mMeshData = filter->getMeshData();
+    MeshData& meshData = renderItem.mMeshData;
 
     //Matrix
     Transform* transform = dynamic_cast<Transform*>(mGameObject->getComponent("Transform"));
     ASSERT(transform, TEXT("transform is null!"))
     renderItem.mModel = transform->getModelMatrix();
 
+    //level of detail from the size on screen, the coarser levels index the same buffers
+    const MeshLodChain* lodChain = meshData.mLodChain.get();
+    if (lodChain != nullptr && meshData.mBounds.IsValid())
+    {
+        const Camera* camera = Camera::sGetCurrentCamera();
+        const float screenSize = camera->getScreenSize(meshData.mBounds.Transform(renderItem.mModel));
+        uint32_t& lod = lastLod(camera);
+        lod = lodChain->selectLod(lod, screenSize);
+        memcpy(meshData.mSubMeshes.get(), lodChain->mSubMeshes.data() + lod * meshData.mSubMeshCount,
+            meshData.mSubMeshCount * sizeof(SubMesh));
+        TELEMETRY_COUNT(TRIANGLES, lodChain->mNumTriangles[lod]);
+        TELEMETRY_COUNT(LOD_TRIANGLES_SAVED, lodChain->mNumTriangles[0] - lodChain->mNumTriangles[lod]);
+    }
+    else
+    {
+        uint32_t numTriangles = 0;
+        for (uint32_t i = 0; i < meshData.mSubMeshCount; ++i)
+        {
+            numTriangles += meshData.mSubMeshes[i].mIndexNum / 3;
+        }
+        TELEMETRY_COUNT(TRIANGLES, numTriangles);
+    }
+
+    renderItem.mObjectSlot = mObjectSlot;
+
     //Material
     renderItem.mMaterial = mMaterialGpu.get();
 
@@ -71,16 +127,31 @@ void MeshRenderer::prepareRenderList() const
     universalCBuffer.mColor[3] = mAlpha;
     universalCBuffer.mBlendFactor[0] = mBlendFactor;
     mMaterialGpu->UpdateConstantBuffer(0, &universalCBuffer, sizeof(universalCBuffer));
-    // renderItem.mColor[0] = mColor.value.v.x;
-    // renderItem.mColor[1] = mColor.value.v.y;
-    // renderItem.mColor[2] = mColor.value.v.z;
-    // renderItem.mColor[3] = mAlpha;
+    renderItem.mColor = {mColor.value.v.x, mColor.value.v.y, mColor.value.v.z, mAlpha};
     // renderItem.mBlendFactor = mBlendFactor;
 
     Camera* currentCamera = Camera::sGetCurrentCamera();
     currentCamera->addRenderItem(renderItem);
 }
 
+MeshFilter* MeshRenderer::getMeshFilter() const
+{
+    if (mMeshFilter == nullptr)
+    {
+        mMeshFilter = dynamic_cast<MeshFilter*>(mGameObject->getComponent("MeshFilter"));
+    }
+    return mMeshFilter;
+}
+
+bool MeshRenderer::getWorldBounds(BoundingBox& bounds) const
+{
+    MeshFilter* filter = getMeshFilter();
+    if (filter == nullptr || !filter->getLocalBounds().IsValid())
+        return false;
+    bounds = filter->getLocalBounds().Transform(mGameObject->getTransform()->getModelMatrix());
+    return true;
+}
+
 rapidxml::xml_node<>* MeshRenderer::serialize(rapidxml::xml_document<>* doc, rapidxml::xml_node<>* father,
     const TpString& value)
 {
@@ -90,6 +161,7 @@ rapidxml::xml_node<>* MeshRenderer::serialize(rapidxml::xml_document<>* doc, rap
     mXmlNode->append_attribute(doc->allocate_attribute("name", doc->allocate_string("MeshRenderer")));
     mXmlNode->append_attribute(doc->allocate_attribute("ShaderName", doc->allocate_string(mShaderName.c_str())));
     mXmlNode->append_attribute(doc->allocate_attribute("TextureName", doc->allocate_string(mTextureName.c_str())));
+    mXmlNode->append_attribute(doc->allocate_attribute("DepthPrePass", mDepthPrePass ? "1" : "0"));
 
     auto colorNode = doc->allocate_node(rapidxml::node_element, "Color");
     mXmlNode->append_node(colorNode);
@@ -109,6 +181,11 @@ void MeshRenderer::deSerialize(const rapidxml::xml_node<>* node)
     {
         setTexture(node->first_attribute("TextureName")->value());
     }
+    //optional, scenes saved before it draw no occluders
+    if (auto depthPrePass = node->first_attribute("DepthPrePass"))
+    {
+        setDepthPrePass(std::stoi(depthPrePass->value()) != 0);
+    }
 
     auto currentNode = node->first_node("Color");
     mColor.value.v.x = std::stof(currentNode->first_attribute("R")->value());
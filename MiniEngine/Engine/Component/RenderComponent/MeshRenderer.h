@@ -6,17 +6,26 @@
 #include "Engine/render/RenderItem.h"
 #include "Engine/Utility/MacroUtility.h"
 
+class Camera;
+class MeshFilter;
 class MeshRenderer:public Component
 {
     friend class ComponentFactory;
+    friend class MeshFilter;
 public:
     virtual void awake() override;
 
     void setShader(const TpString& shaderName);
     void setTexture(const TpString& textureName);
+    //draws the object opaque and, while it is large on screen, into the depth pre-pass. for solid meshes hiding a lot
+    //of the scene, the shader has to compute the position with ObjectToClip
+    void setDepthPrePass(bool enable);
     
     void prepareRenderList() const;
-    ~MeshRenderer() override {}
+    //world space bounds used by frustum culling, returns false when the object can not be culled
+    bool getWorldBounds(BoundingBox& bounds) const;
+    uint32_t getObjectSlot() const {return mObjectSlot;}
+    ~MeshRenderer() override;
     rapidxml::xml_node<>* serialize(rapidxml::xml_document<>* doc, rapidxml::xml_node<>* father,
         const TpString& value) override;
     void deSerialize(const rapidxml::xml_node<>* node) override;
@@ -25,11 +34,23 @@ public:
     void setBlendFactor(const float blendFactor){mBlendFactor = blendFactor;}
 
 private:
+    MeshFilter* getMeshFilter() const;
+    void applyDepthPrePass();
+    //level of detail `camera` drew this object with last time, 0 the first time
+    uint32_t& lastLod(const Camera* camera) const;
+
     std::unique_ptr<MaterialInstance> mMaterialGpu;
+    //looked up on first use, cleared by MeshFilter::onDestory
+    mutable MeshFilter* mMeshFilter = nullptr;
+    uint32_t mObjectSlot = UINT32_MAX;    //persistent object constants, see Renderer::allocObjectConstants
+    //level of detail drawn last frame by every camera rendering this object, the objects of several layers are
+    //rendered by more than one camera and each keeps its own hysteresis. only written by the task extracting this object
+    mutable std::vector<std::pair<const Camera*, uint32_t>> mLods;
     TpString mShaderName = "debug";
     TpString mTextureName;
 
     Color mColor;
     float mAlpha = 1;
     float mBlendFactor = 0;
+    bool mDepthPrePass = false;
 };
\ No newline at end of file
@@ -16,6 +16,7 @@ void ImageTGUI::awake()
     setShader(mShaderName);
     setTexture(mTextureName);
     mGameObject->setLayer(Layer::LAYER_UI);
+    mObjectSlot = Renderer::GetInstance().allocObjectConstants();
 }
 
 void ImageTGUI::setShader(const TpString& shaderName)
@@ -49,6 +50,7 @@ void ImageTGUI::prepareRenderList()
     //Matrix, only position influence collider
     RectTransform* transform = dynamic_cast<RectTransform*>(getGameObject()->getComponent("Transform"));
     renderItem.mModel = transform->getModelMatrix();
+    renderItem.mObjectSlot = mObjectSlot;
 
     //Material
     renderItem.mMaterial = mMaterialGpu.get();
@@ -74,6 +76,7 @@ void ImageTGUI::prepareRenderList()
 
 ImageTGUI::~ImageTGUI()
 {
+    Renderer::GetInstance().releaseObjectConstants(mObjectSlot);
 }
 
 rapidxml::xml_node<>* ImageTGUI::serialize(rapidxml::xml_document<>* doc, rapidxml::xml_node<>* father,
@@ -22,6 +22,7 @@ public:
     float getBlendFactor() const{ return mBlendFactor;}
 
     virtual void prepareRenderList();
+    uint32_t getObjectSlot() const {return mObjectSlot;}
     ~ImageTGUI() override;
     rapidxml::xml_node<>* serialize(rapidxml::xml_document<>* doc, rapidxml::xml_node<>* father,
                                     const TpString& value) override;
@@ -30,6 +31,7 @@ public:
 
 protected:
     std::unique_ptr<MaterialInstance> mMaterialGpu = nullptr;
+    uint32_t mObjectSlot = UINT32_MAX;    //persistent object constants, see Renderer::allocObjectConstants
     TpString mMeshName;
     TpString mShaderName;
     TpString mTextureName;
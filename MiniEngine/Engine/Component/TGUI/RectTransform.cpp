@@ -9,6 +9,7 @@ void RectTransform::setPivot(const Vector2& pivot)
     ASSERT((abs(pivot.v.x) < 1 && abs(pivot.v.y) < 1)
         ,TEXT("pivot range is -1 to 1!"));
     mPivot = pivot;
+    markMoved();
 }
 
 void RectTransform::setPivotType(PivotType type)
@@ -47,6 +48,7 @@ void RectTransform::setPivotType(PivotType type)
         std::cerr << "Unknown pivot type!" << std::endl;
         break;
     }
+    markMoved();
 }
 
 Vector3 RectTransform::getWorldPosition(const Vector2& offset) const
@@ -127,49 +129,55 @@ void RectTransform::showSelf()
     {
         const static int inputWidth = 50;
         const static float step = 1;
+        //the fields are edited in place, mark the transform moved only when one of them changed
+        bool changed = false;
         ImGui::SetNextItemWidth(inputWidth);
-        ImGui::InputFloat("Width", &mWidth);
+        changed |= ImGui::InputFloat("Width", &mWidth);
         if (ImGui::IsItemHovered())
         {
             float wheel = ImGui::GetIO().MouseWheel;
             if (wheel != 0.0f)
             {
                 mWidth += wheel * step;
+                changed = true;
             }
         }
         ImGui::SameLine();
         ImGui::SetNextItemWidth(inputWidth);
-        ImGui::InputFloat("Height", &mHeight);
+        changed |= ImGui::InputFloat("Height", &mHeight);
         if (ImGui::IsItemHovered())
         {
             float wheel = ImGui::GetIO().MouseWheel;
             if (wheel != 0.0f)
             {
                 mHeight += wheel * step;
+                changed = true;
             }
         }
         ImGui::SameLine();
         ImGui::Text("Size");
         
         ImGui::SetNextItemWidth(inputWidth);
-        ImGui::InputFloat("X##xx", &mPivotPos.v.x);
+        changed |= ImGui::InputFloat("X##xx", &mPivotPos.v.x);
         if (ImGui::IsItemHovered())
         {
             float wheel = ImGui::GetIO().MouseWheel;
             if (wheel != 0.0f)
             {
                 mPivotPos.v.x += wheel * step;
+                changed = true;
             }
         }
         ImGui::SameLine();
         ImGui::SetNextItemWidth(inputWidth);
-        ImGui::InputFloat("Y##xx", &mPivotPos.v.y);
+        changed |= ImGui::InputFloat("Y##xx", &mPivotPos.v.y);
         if (ImGui::IsItemHovered())
         {
             float wheel = ImGui::GetIO().MouseWheel;
             if (wheel != 0.0f)
             {
                 mPivotPos.v.y += wheel * step;
+                changed = true;
             }
         }
         ImGui::SameLine();
@@ -179,6 +187,10 @@ void RectTransform::showSelf()
         {
             setPivotType(mPivotType);
         }
+        if (changed)
+        {
+            markMoved();
+        }
     
         ImGui::TreePop();
     }
@@ -23,7 +23,7 @@ public:
     Vector2 getPivot() const {return mPivot;}
     Vector2 getPivotPos() const {return mPivotPos;}
     void setPivot(const Vector2& pivot);
-    void setPivotPos(const Vector2& pivot) {mPivotPos = pivot;}
+    void setPivotPos(const Vector2& pivot) {mPivotPos = pivot; markMoved();}
     void setPivotType(PivotType type);
 
     //debug
@@ -35,9 +35,9 @@ public:
 
     float getWidth()const {return mWidth;}
     float getHeight()const {return mHeight;}
-    void setWidth(float width) {mWidth = width;}
-    void setHeight(float height) {mHeight = height;}
-    void setSize(const Vector2& size){mWidth = size.v.x; mHeight = size.v.y;}
+    void setWidth(float width) {mWidth = width; markMoved();}
+    void setHeight(float height) {mHeight = height; markMoved();}
+    void setSize(const Vector2& size){mWidth = size.v.x; mHeight = size.v.y; markMoved();}
 
     Canvas* getCanvas()const {return mCanvas;}
 
@@ -12,6 +12,14 @@
 
 REGISTER_COMPONENT(TextTGUI, "TextTGUI")
 
+namespace
+{
+    // variables of the font material constants
+    constexpr uint64_t COLOR_ID = MaterialInstance::PropertyId("color");
+    constexpr uint64_t BLEND_FACTOR_ID = MaterialInstance::PropertyId("blendFactor");
+    constexpr uint64_t TEXT_UV_ID = MaterialInstance::PropertyId("TextUV");
+}
+
 void TextTGUI::awake()
 {
     mMeshName = "Image";
@@ -57,29 +65,21 @@ void TextTGUI::prepareRenderList()
         //Material
         renderItem.mMaterial = fontChar->mMaterialGpu.get();
         
-        struct alignas(256) UniversalCBuffer
-        {
-            float mColor[4];
-            float mBlendFactor[4];
-            float mUv[4];
-        };
-        UniversalCBuffer universalCBuffer;
-        universalCBuffer.mColor[0] = mColor.value.v.x;
-        universalCBuffer.mColor[1] = mColor.value.v.y;
-        universalCBuffer.mColor[2] = mColor.value.v.z;
-        universalCBuffer.mColor[3] = mAlpha;
-        universalCBuffer.mBlendFactor[0] = mBlendFactor;
+        const float color[4] = { mColor.value.v.x, mColor.value.v.y, mColor.value.v.z, mAlpha };
 
         //sampler uv
-        //uv: u start
+        //uv: u start, u end
         //magic number: 2.5, the offset of texture sampler
-        universalCBuffer.mUv[0] = (fontChar->x) /
-            static_cast<double>(TankinFont::sGetInstance()->getTextureWidth());
-        //uv: u end
-        universalCBuffer.mUv[1] = static_cast<double>((fontChar->x+fontChar->width)) /
-            static_cast<double>(TankinFont::sGetInstance()->getTextureWidth());
+        const float uv[2] = {
+            static_cast<float>((fontChar->x) /
+                static_cast<double>(TankinFont::sGetInstance()->getTextureWidth())),
+            static_cast<float>(static_cast<double>((fontChar->x+fontChar->width)) /
+                static_cast<double>(TankinFont::sGetInstance()->getTextureWidth()))
+        };
 
-        fontChar->mMaterialGpu->UpdateConstantBuffer(0, &universalCBuffer, sizeof(universalCBuffer));
+        fontChar->mMaterialGpu->SetConstant(COLOR_ID, color);
+        fontChar->mMaterialGpu->SetConstant(BLEND_FACTOR_ID, mBlendFactor);
+        fontChar->mMaterialGpu->SetConstant(TEXT_UV_ID, uv);
 
         Camera* currentCamera = Camera::sGetCurrentCamera();
         currentCamera->addRenderItem(renderItem);
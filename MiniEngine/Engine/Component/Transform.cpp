@@ -1,4 +1,6 @@
-﻿#include <queue>
+﻿#include <algorithm>
+#include <queue>
+#include <stack>
 #include <cmath>
 #include <iostream>
 
@@ -6,7 +8,10 @@
 #include "GameObject.h"
 #include "Engine/common/Exception.h"
 #include "TGUI/RectTransform.h"
+#include "RenderComponent/Camera.h"
 
+//declared before sTree so it outlives the root
+std::vector<Transform*> Transform::sMovedTransforms;
 Transform Transform::sTree;
 
 ///this default constructor is used to create the root of the tree
@@ -24,6 +29,7 @@ Transform::Transform(GameObject* go, Vector3 newLocalPosition, Vector3 newLocalR
 {
     rotateLocalPitchYawRoll(newLocalPosition);
     sTree.addChildren(this);
+    markMoved();
 }
 
 Transform::Transform(GameObject* go, Transform* parent, Vector3 newLocalPosition, Vector3 newLocalRotation, Vector3 newLocalScale)
@@ -31,12 +37,22 @@ Transform::Transform(GameObject* go, Transform* parent, Vector3 newLocalPosition
 {
     rotateLocalPitchYawRoll(newLocalPosition);
     parent->addChildren(this);
+    markMoved();
 }
 
 //Transform do not control any life cycle of its children,but need unbind its father
 Transform::~Transform()
 {
     unbindFather();
+    if (mMoved)
+    {
+        //the order of the moved transforms does not matter, fill the hole with the last one
+        Transform* last = sMovedTransforms.back();
+        sMovedTransforms[mMovedIndex] = last;
+        last->mMovedIndex = mMovedIndex;
+        sMovedTransforms.pop_back();
+    }
+    Camera::sRemoveSceneProxy(this);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -235,6 +251,7 @@ void Transform::addChildren(GameObject* go)
     //set new father
     mChildren.push_back(ts);
     ts->mParent = this;
+    ts->markMoved();
 }
 
 void Transform::addChildren(Transform* ts)
@@ -247,6 +264,7 @@ void Transform::addChildren(Transform* ts)
     //set new father
     mChildren.push_back(ts);
     ts->mParent = this;
+    ts->markMoved();
 }
 
 void Transform::removeChild(const int32_t index, Transform* newParent)
@@ -474,6 +492,7 @@ void Transform::rotateLocalPitchYawRoll(const Vector3& rotation)
     q.setQuaternionRotationRollPitchYaw(rotation);
     //a mesh vertex need rotate in this coordinate firstly
     mLocalRotation = q * mLocalRotation;
+    markMoved();
 }
 
 void Transform::rotateAroundWorldAxis(const Vector3& axis, const float angle)
@@ -483,6 +502,7 @@ void Transform::rotateAroundWorldAxis(const Vector3& axis, const float angle)
     q.setToRotateAboutAxis(localAxis, angle);
     mLocalRotation = q * mLocalRotation;
     mLocalRotation.normalize();
+    markMoved();
 }
 
 void Transform::rotateAroundLocalAxis(const Vector3& axis, const float angle)
@@ -491,6 +511,7 @@ void Transform::rotateAroundLocalAxis(const Vector3& axis, const float angle)
     q.setToRotateAboutAxis(axis, angle);
     mLocalRotation = q * mLocalRotation;
     mLocalRotation.normalize();
+    markMoved();
 }
 
 void Transform::lookAtWorldPosition(const Vector3& destinationPos)
@@ -519,9 +540,57 @@ void Transform::lookAtWorldDirection(const Vector3& direction)
 
     //do not use setRotation, because all of this rotation is in this coordinate
     mLocalRotation *= q;
+    markMoved();
 }
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void Transform::markMoved()
+{
+    if (mMoved)
+        return;
+    mMoved = true;
+    mMovedIndex = static_cast<uint32_t>(sMovedTransforms.size());
+    sMovedTransforms.push_back(this);
+}
+
+void Transform::sFlushMovedTransforms(const std::function<void(Transform* transform)>& func)
+{
+    //func may move transforms again, they are kept for the next flush
+    std::vector<Transform*> movedTransforms;
+    movedTransforms.swap(sMovedTransforms);
+    //transforms below another moved one are visited with its subtree, keep only the topmost ones
+    auto coveredBegin = std::partition(movedTransforms.begin(), movedTransforms.end(), [](const Transform* transform)
+    {
+        for (const Transform* parent = transform->mParent; parent != nullptr; parent = parent->mParent)
+        {
+            if (parent->mMoved)
+                return false;
+        }
+        return true;
+    });
+    for (Transform* transform : movedTransforms)
+    {
+        transform->mMoved = false;
+    }
+    movedTransforms.erase(coveredBegin, movedTransforms.end());
+    std::stack<Transform*> stack;
+    for (Transform* transform : movedTransforms)
+    {
+        stack.push(transform);
+        while (!stack.empty())
+        {
+            Transform* current = stack.top();
+            stack.pop();
+            func(current);
+            for (Transform* child : current->mChildren)
+            {
+                stack.push(child);
+            }
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void Transform::printAll(uint32_t layer) const
 {
@@ -580,6 +649,7 @@ void Transform::deSerialize(const rapidxml::xml_node<>* node)
     mLocalRotation.deSerialize(currentNode);
     currentNode = currentNode->next_sibling("Vector3");
     mLocalScale.deSerialize(currentNode);
+    markMoved();
 }
 
 void Transform::showSelf()
@@ -594,36 +664,41 @@ void Transform::showSelf()
     
     if (ImGui::TreeNode(ComponentRegister::sGetClassName(this).c_str()))
     {
+        //the fields are edited in place, mark the transform moved only when one of them changed
+        bool changed = false;
         ImGui::SetNextItemWidth(inputWidth);
-        ImGui::InputFloat("X", &(mLocalPosition.v.x));
+        changed |= ImGui::InputFloat("X", &(mLocalPosition.v.x));
         if (ImGui::IsItemHovered())
         {
             float wheel = ImGui::GetIO().MouseWheel;
             if (wheel != 0.0f)
             {
                 mLocalPosition.v.x += wheel * step;
+                changed = true;
             }
         }
         ImGui::SameLine();
         ImGui::SetNextItemWidth(inputWidth);
-        ImGui::InputFloat("Y", &(mLocalPosition.v.y));
+        changed |= ImGui::InputFloat("Y", &(mLocalPosition.v.y));
         if (ImGui::IsItemHovered())
         {
             float wheel = ImGui::GetIO().MouseWheel;
             if (wheel != 0.0f)
             {
                 mLocalPosition.v.y += wheel * step;
+                changed = true;
             }
         }
         ImGui::SameLine();
         ImGui::SetNextItemWidth(inputWidth);
-        ImGui::InputFloat("Z", &(mLocalPosition.v.z));
+        changed |= ImGui::InputFloat("Z", &(mLocalPosition.v.z));
         if (ImGui::IsItemHovered())
         {
             float wheel = ImGui::GetIO().MouseWheel;
             if (wheel != 0.0f)
             {
                 mLocalPosition.v.z += wheel * step;
+                changed = true;
             }
         }
         ImGui::SameLine();
@@ -644,39 +719,46 @@ void Transform::showSelf()
             setLocalRotation(newRotation);
         }
         ImGui::SetNextItemWidth(inputWidth);
-        ImGui::InputFloat("X##xx", &(mLocalScale.v.x));
+        changed |= ImGui::InputFloat("X##xx", &(mLocalScale.v.x));
         if (ImGui::IsItemHovered())
         {
             float wheel = ImGui::GetIO().MouseWheel;
             if (wheel != 0.0f)
             {
                 mLocalScale.v.x += wheel * step;
+                changed = true;
             }
         }
         ImGui::SameLine();
         ImGui::SetNextItemWidth(inputWidth);
-        ImGui::InputFloat("Y##xx", &(mLocalScale.v.y));
+        changed |= ImGui::InputFloat("Y##xx", &(mLocalScale.v.y));
         if (ImGui::IsItemHovered())
         {
             float wheel = ImGui::GetIO().MouseWheel;
             if (wheel != 0.0f)
             {
                 mLocalScale.v.y += wheel * step;
+                changed = true;
             }
         }
         ImGui::SameLine();
         ImGui::SetNextItemWidth(inputWidth);
-        ImGui::InputFloat("Z##xx", &(mLocalScale.v.z));
+        changed |= ImGui::InputFloat("Z##xx", &(mLocalScale.v.z));
         if (ImGui::IsItemHovered())
         {
             float wheel = ImGui::GetIO().MouseWheel;
             if (wheel != 0.0f)
             {
                 mLocalScale.v.z += wheel * step;
+                changed = true;
             }
         }
         ImGui::Text("LocalScale");
         ImGui::TreePop();
+        if (changed)
+        {
+            markMoved();
+        }
     }
     
 #endif
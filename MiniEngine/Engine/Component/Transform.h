@@ -17,6 +17,7 @@ class Transform: public Component
     friend class ComponentFactory;
     friend class GameObject;
     friend class GameObjectFactory;
+    friend class Camera;
 public:
     //virtual void awake() override;
     //virtual void onEnable() override;
@@ -85,26 +86,31 @@ public:
     
     ///set
     void setWorldPosition(const Vector3& newPosition);
-    void setLocalPosition(const Vector3& newPosition) {mLocalPosition = newPosition;}
+    void setLocalPosition(const Vector3& newPosition) {mLocalPosition = newPosition; markMoved();}
 
     void setWorldRotation(const Quaternion& newRotation);
-    void setLocalRotation(const Quaternion& newRotation) {mLocalRotation = newRotation;}
+    void setLocalRotation(const Quaternion& newRotation) {mLocalRotation = newRotation; markMoved();}
     
     void rotateLocalPitchYawRoll(const Vector3& rotation);
     void rotateAroundWorldAxis(const Vector3& axis, const float angle);
     void rotateAroundLocalAxis(const Vector3& axis, const float angle);
 
-    void setLocalScale(const Vector3& newScale) {mLocalScale = newScale;};
+    void setLocalScale(const Vector3& newScale) {mLocalScale = newScale; markMoved();};
 
     ///Directly move this transform local position
-    void movePosition(const Vector3& displacement) {mLocalPosition += displacement;}
-    void movePosition(const Vector3& direction, float distance) {mLocalPosition += (direction * distance);}
+    void movePosition(const Vector3& displacement) {mLocalPosition += displacement; markMoved();}
+    void movePosition(const Vector3& direction, float distance) {mLocalPosition += (direction * distance); markMoved();}
 
     //rotate this transform to look at world destination pos (forward direction)
     void lookAtWorldPosition(const Vector3& worldDestinationPos);
     //rotate this transform to look at world direction (forward direction)
     void lookAtWorldDirection(const Vector3& worldDirection);
     
+    ///record that this transform (and so its whole subtree) moved since the last flush
+    void markMoved();
+    ///call func on every moved transform and its descendants, then forget them
+    static void sFlushMovedTransforms(const std::function<void(Transform* transform)>& func);
+
     //debug
     void printAll(uint32_t layer=0) const;
     void printSelf() const;
@@ -139,4 +145,13 @@ protected:
     Vector3 mLocalPosition;
     Quaternion mLocalRotation;
     Vector3 mLocalScale{1.0f,1.0f,1.0f};
+
+    //moved transforms since the last flush
+    static std::vector<Transform*> sMovedTransforms;
+    uint32_t mMovedIndex = 0;   //position inside sMovedTransforms while moved
+    bool mMoved = false;
+
+    //visibility proxy maintained by Camera
+    uint32_t mSceneHandle = ~0u;    //handle inside the scene octree
+    bool mSceneUnbounded = false;   //rendered without culling, like ui
 };
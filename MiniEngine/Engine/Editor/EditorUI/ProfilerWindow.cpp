@@ -0,0 +1,122 @@
+﻿#include "ProfilerWindow.h"
+
+#include "Engine/Editor/ImguiManager.h"
+#include "Engine/Utility/Profiler/Profiler.h"
+#include "Engine/Utility/Telemetry/Telemetry.h"
+#ifdef WIN32
+#include "Engine/Dependencies/imGui/imgui.h"
+ProfilerWindow* ProfilerWindow::sInstance = nullptr;
+REGISTER_EDITOR_UI(ProfilerWindow, "Profiler")
+
+
+void ProfilerWindow::drawSelf()
+{
+    ImGui::Begin("Profiler");
+
+    ImGui::Text("Frame %llu  %.3f ms", static_cast<unsigned long long>(Profiler::sGetFrameIndex()), Profiler::sGetLastFrameMs());
+
+    bool isPaused = Profiler::sGetIsPaused();
+    if (ImGui::Checkbox("Pause", &isPaused))
+    {
+        Profiler::sSetPaused(isPaused);
+    }
+
+    ImGui::SameLine();
+
+    if (ImGui::Button("Export Trace"))
+    {
+        ImGui::OpenPopup(Profiler::sExportChromeTrace("profile_trace.json") ? "Export Success" : "Export Failed");
+    }
+
+    static const ImGuiTableFlags TableFlags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable;
+    if (ImGui::BeginTable("Zones", 5, TableFlags, ImVec2(0, 300)))
+    {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Zone");
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableSetupColumn("Total ms");
+        ImGui::TableSetupColumn("Max ms");
+        ImGui::TableSetupColumn("Avg ms");
+        ImGui::TableHeadersRow();
+
+        for (const auto& zone : Profiler::sGetZoneStats())
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(zone.first.data(), zone.first.data() + zone.first.size());
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", zone.second.mCalls);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", zone.second.mTotalMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", zone.second.mMaxMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", zone.second.mAverageMs);
+        }
+        ImGui::EndTable();
+    }
+
+    if (!Profiler::sGetCounters().empty() && ImGui::CollapsingHeader("Counters"))
+    {
+        for (const auto& counter : Profiler::sGetCounters())
+        {
+            ImGui::Text("%.*s: %lld", static_cast<int>(counter.first.size()), counter.first.data(), static_cast<long long>(counter.second));
+        }
+    }
+
+#ifdef ENABLE_TELEMETRY
+    if (ImGui::CollapsingHeader("Telemetry"))
+    {
+        for (size_t i = 0; i < TELEMETRY_TIMER_COUNT; ++i)
+        {
+            const TelemetryHistogram& histogram = Telemetry::sGetHistogram(static_cast<TelemetryTimer>(i));
+            ImGui::Text("%-10s p50 %7.3f  p95 %7.3f  p99 %7.3f ms", Telemetry::sGetTimerName(static_cast<TelemetryTimer>(i)),
+                histogram.getPercentile(0.5f), histogram.getPercentile(0.95f), histogram.getPercentile(0.99f));
+        }
+        ImGui::Separator();
+        const TelemetryFrame& frame = Telemetry::sGetLastFrame();
+        for (size_t i = 0; i < TELEMETRY_COUNTER_COUNT; ++i)
+        {
+            ImGui::Text("%s: %lld", Telemetry::sGetCounterName(static_cast<TelemetryCounter>(i)), static_cast<long long>(frame.mCounters[i]));
+        }
+        for (size_t i = 0; i < TELEMETRY_GAUGE_COUNT; ++i)
+        {
+            ImGui::Text("%s: %lld", Telemetry::sGetGaugeName(static_cast<TelemetryGauge>(i)), static_cast<long long>(frame.mGauges[i]));
+        }
+    }
+#endif
+
+    if (ImGui::BeginPopupModal("Export Success", NULL, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove)) {
+        ImGui::Text("Trace written to profile_trace.json");
+        ImGui::Separator();
+
+        if (ImGui::Button("OK", ImVec2(120, 0))) {
+            ImGui::CloseCurrentPopup();
+        }
+
+        ImGui::EndPopup();
+    }
+
+    if (ImGui::BeginPopupModal("Export Failed", NULL, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove)) {
+        ImGui::Text("Could not open profile_trace.json");
+        ImGui::Separator();
+
+        if (ImGui::Button("OK", ImVec2(120, 0))) {
+            ImGui::CloseCurrentPopup();
+        }
+
+        ImGui::EndPopup();
+    }
+
+    ImGui::End();
+}
+
+ProfilerWindow* ProfilerWindow::sGetInstance()
+{
+    if (sInstance == nullptr)
+    {
+        sInstance = new ProfilerWindow();
+    }
+    return sInstance;
+}
+#endif
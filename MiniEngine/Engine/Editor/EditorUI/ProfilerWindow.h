@@ -0,0 +1,13 @@
+﻿#pragma once
+#include "Engine/Editor/EditorUi.h"
+
+#ifdef WIN32
+class ProfilerWindow:public EditorUi
+{
+public:
+    void drawSelf() override;
+    static ProfilerWindow* sGetInstance();
+private:
+    static ProfilerWindow* sInstance;
+};
+#endif
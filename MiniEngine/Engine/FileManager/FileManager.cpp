@@ -1,14 +1,20 @@
 ﻿#include "FileManager.h"
 
+#include <chrono>
+#include <filesystem>
+
 #include "Engine/AudioSystem/AudioClip.h"
 #include "Engine/AudioSystem/AudioInterface.h"
 #include "Engine/Component/Audio/AudioSource.h"
 #include "Engine/Dependencies/rapidxml/rapidxml_utils.hpp"
+#include "Engine/render/MeshCache.h"
 #include "Engine/render/MeshData.h"
 #include "Engine/render/DataCPU/DataParser/RenderResources.h"
 #include "Engine/render/Renderer.h"
 
 #include "Engine/Utility/MacroUtility.h"
+#include "Engine/Utility/Profiler/Profiler.h"
+#include "Engine/Utility/Telemetry/Telemetry.h"
 
 TpUnorderedMap<TpString, FileManager::BolbFile<unsigned char*>> FileManager::sLoadedBolbFile;
 TpUnorderedMap<TpString, FileManager::BolbFile<RenderMeshResource*>> FileManager::sLoadedMeshes;
@@ -17,6 +23,23 @@ TpUnorderedMap<TpString, FileManager::BolbFile<std::unique_ptr<Material>>> FileM
 TpUnorderedMap<TpString, FileManager::BolbFile<AudioData*>> FileManager::sLoadedAudioClips;
 bool FileManager::needNessary = false;
 std::atomic<bool> FileManager::sIsGpuLoading(false);
+VertexFormat FileManager::sMeshVertexFormat = VertexFormat::COMPACT;
+
+namespace
+{
+    // the bytes read are counted once, the bytes the asset keeps stay resident until sReportAssetReleased
+    void sReportAssetLoaded(int64_t readBytes, int64_t residentBytes)
+    {
+        TELEMETRY_COUNT(ASSET_BYTES_LOADED, readBytes);
+        TELEMETRY_GAUGE_ADD(ASSET_BYTES_RESIDENT, residentBytes);
+        TELEMETRY_GAUGE_ADD(LOADED_ASSETS, 1);
+    }
+
+    void sReportAssetReleased(int64_t residentBytes)
+    {
+        TELEMETRY_GAUGE_ADD(ASSET_BYTES_RESIDENT, -residentBytes);
+    }
+}
 
 namespace TankinRender
 {
@@ -25,22 +48,113 @@ namespace TankinRender
         //upload mesh data to GPU
         Renderer& renderer = Renderer::GetInstance();
         MeshData& meshDataGpu = meshRes->mMeshDataGpu;
+        const MeshCache& cache = meshRes->mMeshCache;
+        if (cache.IsLoaded())
+        {
+            static_assert(sizeof(SubMesh) == sizeof(MeshCache::SubMeshRange), "sub-meshes are copied from the cache");
+            meshDataGpu.mVertexCount = cache.GetNumVertices();
+            meshDataGpu.mIndexCount = cache.GetNumIndices();
+            meshDataGpu.mSubMeshCount = static_cast<uint8_t>(cache.GetNumSubMeshes());
+            meshDataGpu.mSubMeshes.reset(new SubMesh[meshDataGpu.mSubMeshCount]);
+            memcpy(meshDataGpu.mSubMeshes.get(), cache.GetSubMeshes(), meshDataGpu.mSubMeshCount * sizeof(SubMesh));
+            if (cache.GetNumLods() > 1)
+            {
+                auto lodChain = std::make_shared<MeshLodChain>();
+                lodChain->mNumLods = cache.GetNumLods();
+                for (uint32_t lod = 0; lod < lodChain->mNumLods; ++lod)
+                {
+                    const SubMesh* subMeshes = reinterpret_cast<const SubMesh*>(cache.GetSubMeshes(lod));
+                    lodChain->mErrors[lod] = cache.GetLodError(lod);
+                    for (uint32_t i = 0; i < meshDataGpu.mSubMeshCount; ++i)
+                    {
+                        lodChain->mNumTriangles[lod] += subMeshes[i].mIndexNum / 3;
+                    }
+                    lodChain->mSubMeshes.insert(lodChain->mSubMeshes.end(), subMeshes, subMeshes + meshDataGpu.mSubMeshCount);
+                }
+                meshDataGpu.mLodChain = std::move(lodChain);
+            }
+            const bool compact = cache.GetVertexFormat() == VertexFormat::COMPACT;
+            meshDataGpu.mInputLayout = compact ? InputLayout::COMPACT : InputLayout::FULL;
+            if (compact)
+            {
+                // the unorm positions span the bounds
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    meshDataGpu.mPositionOffset[axis] = cache.GetBoundsMin()[axis];
+                    meshDataGpu.mPositionScale[axis] = cache.GetBoundsMax()[axis] - cache.GetBoundsMin()[axis];
+                }
+                meshDataGpu.mColorBuffer = renderer.allocVertexBuffer(cache.GetNumColors(), sizeof(uint32_t));
+                ASSERT(meshDataGpu.mColorBuffer.IsValid(), TEXT("Upload Mesh Color Failed!"))
+                renderer.updateVertexBuffer(cache.GetColors(), static_cast<uint64_t>(cache.GetNumColors()) * sizeof(uint32_t),
+                    meshDataGpu.mColorBuffer, false);
+            }
+            meshDataGpu.mVertexBuffer = renderer.allocVertexBuffer(cache.GetNumVertices(), cache.GetVertexStride());
+            meshDataGpu.mIndexBuffer = renderer.allocIndexBuffer(cache.GetNumIndices(),
+                cache.GetIndexSize() == sizeof(uint16_t) ? Format::R16_UINT : Format::R32_UINT);
+            ASSERT(meshDataGpu.mVertexBuffer.IsValid(), TEXT("Upload Mesh Vertex Failed!"))
+            ASSERT(meshDataGpu.mIndexBuffer.IsValid(), TEXT("Upload Mesh Index Failed!"))
+
+            // the uploads copy the data, the mapping is released right after
+            renderer.updateVertexBuffer(cache.GetVertices(), static_cast<uint64_t>(cache.GetNumVertices()) * cache.GetVertexStride(),
+                meshDataGpu.mVertexBuffer, false);
+            renderer.updateIndexBuffer(cache.GetIndices(), static_cast<uint64_t>(cache.GetNumIndices()) * cache.GetIndexSize(),
+                meshDataGpu.mIndexBuffer, false);
+            meshDataGpu.mPositionBuffer = renderer.allocPositionBuffer(cache.GetVertices(), cache.GetNumVertices(),
+                cache.GetVertexStride(), compact ? sizeof(uint16_t[4]) : sizeof(float[3]), false);
+            sReportAssetReleased(meshRes->GetMeshCacheBytes());
+            meshRes->ReleaseMeshCache();
+            return;
+        }
         meshDataGpu.mVertexCount = meshRes->VerticesCPU.NumElements;
         meshDataGpu.mIndexCount = meshRes->IndicesCPU.NumElements;
         meshDataGpu.mSubMeshes.reset(new SubMesh[1]{ {meshDataGpu.mIndexCount , 0, 0}});
+        // the vertices of the loader
+        meshDataGpu.mInputLayout = InputLayout::FULL;
         meshDataGpu.mVertexBuffer = renderer.allocVertexBuffer(meshRes->VerticesCPU.GetNumElements(), meshRes->VerticesCPU.GetStride());
         meshDataGpu.mIndexBuffer = renderer.allocIndexBuffer(meshRes->IndicesCPU.GetNumElements(), Format::R32_UINT);
         ASSERT(meshDataGpu.mVertexBuffer.IsValid(), TEXT("Upload Mesh Vertex Failed!"))
         ASSERT(meshDataGpu.mIndexBuffer.IsValid(), TEXT("Upload Mesh Index Failed!"))
 
-        renderer.updateVertexBuffer(meshRes->VerticesCPU.Data, meshRes->VerticesCPU.GetDataBytes(), meshDataGpu.mVertexBuffer);
-        renderer.updateIndexBuffer(meshRes->IndicesCPU.Data, meshRes->IndicesCPU.GetDataBytes(), meshDataGpu.mIndexBuffer);
+        // the renderer skips the items drawing the mesh until both uploads completed
+        renderer.updateVertexBuffer(meshRes->VerticesCPU.Data, meshRes->VerticesCPU.GetDataBytes(), meshDataGpu.mVertexBuffer, false);
+        renderer.updateIndexBuffer(meshRes->IndicesCPU.Data, meshRes->IndicesCPU.GetDataBytes(), meshDataGpu.mIndexBuffer, false);
+        // positions come first in every vertex
+        meshDataGpu.mPositionBuffer = renderer.allocPositionBuffer(meshRes->VerticesCPU.Data, meshRes->VerticesCPU.GetNumElements(),
+            meshRes->VerticesCPU.GetStride(), sizeof(float[3]), false);
     }
     void uploadTexture(RenderTextureResource* texRes)
     {
         auto& renderer = Renderer::GetInstance();
         texRes->mDataGpuHandle = renderer.allocTexture2D(Format::R8G8B8A8_UNORM_SRGB, texRes->Width, texRes->Height, 1);
-        renderer.updateTexture(texRes->RGBATextureDataCPU, texRes->mDataGpuHandle, 0, true);    // 暂时统一设置为阻塞渲染循环，之后提供主动检查任务是否完成的接口
+        renderer.updateTexture(texRes->RGBATextureDataCPU, texRes->mDataGpuHandle, 0, false);
+    }
+}
+
+namespace
+{
+    int64_t sGetStreamSize(std::ifstream& stream)
+    {
+        const std::streampos current = stream.tellg();
+        stream.seekg(0, std::ios::end);
+        const std::streampos size = stream.tellg();
+        stream.seekg(current);
+        return size < 0 ? 0 : static_cast<int64_t>(size);
+    }
+
+    // empty when the file does not exist
+    std::vector<char> sReadBinaryFile(const TpString& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return {};
+        std::vector<char> content(sGetStreamSize(file));
+        if (!file.read(content.data(), content.size())) return {};
+        return content;
+    }
+
+    bool sWriteBinaryFile(const TpString& path, const std::vector<uint8_t>& content)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        return file.is_open() && file.write(reinterpret_cast<const char*>(content.data()), content.size());
     }
 }
 
@@ -48,6 +162,7 @@ template<>
 void FileManager::sLoadBolbFile<unsigned char*>(const TpString& fileName, const TpString& filePath,
     bool isAsync)
 {
+    PROFILE_SCOPE("FileManager::sLoadBolbFile<Blob>");
     if (sLoadedBolbFile.find(fileName) != sLoadedBolbFile.end())
         return;
         
@@ -62,6 +177,7 @@ void FileManager::sLoadBolbFile<unsigned char*>(const TpString& fileName, const
         delete[] data;
         ASSERT(false, TEXT("Failed to read file\n"));
     }
+    sReportAssetLoaded(size, size);
     
     sLoadedBolbFile[fileName] = {data, filePath};
 }
@@ -69,18 +185,61 @@ void FileManager::sLoadBolbFile<unsigned char*>(const TpString& fileName, const
 template<>
 void FileManager::sLoadBolbFile<MeshData>(const TpString& fileName, const TpString& filePath,bool isAsync)
 {
+    PROFILE_SCOPE("FileManager::sLoadBolbFile<Mesh>");
     //check whether mesh resource has already been loaded
     auto itor = sLoadedMeshes.find(fileName);
     if (itor != sLoadedMeshes.end())
         return;
     
-    std::ifstream ifs(Application::sGetDataPath() + filePath, std::ios::binary);
-    ASSERT(!ifs.fail(), TEXT("Mesh file is not found"))
-    DEBUG_PRINT("Load mesh <%s> from <%s>\n", fileName.c_str(), filePath.c_str());
-
+    const TpString sourcePath = Application::sGetDataPath() + filePath;
+    const TpString cachePath = sourcePath + ".mesh";
+    std::error_code error;
+    const uint64_t sourceSize = std::filesystem::file_size(sourcePath, error);
+    ASSERT(!error, TEXT("Mesh file is not found"))
+    const uint64_t sourceStamp = std::filesystem::last_write_time(sourcePath, error).time_since_epoch().count();
+
+    const auto start = std::chrono::steady_clock::now();
     RenderMeshResource* meshRes = new RenderMeshResource();
-    bool result = meshRes->LoadMesh(ifs);
-    ASSERT(result, TEXT("Failed to load mesh"))
+    if (meshRes->LoadMeshCache(cachePath, sourceSize, sourceStamp, sMeshVertexFormat))
+    {
+        sReportAssetLoaded(meshRes->GetMeshCacheBytes(), meshRes->GetMeshCacheBytes());
+        DEBUG_PRINT("Load mesh <%s> from <%s.mesh>", fileName.c_str(), filePath.c_str());
+    }
+    else
+    {
+        // first load or changed source: parse it once and write the cache for the next launches
+        std::ifstream ifs(sourcePath, std::ios::binary);
+        ASSERT(!ifs.fail(), TEXT("Mesh file is not found"))
+        DEBUG_PRINT("Import mesh <%s> from <%s>", fileName.c_str(), filePath.c_str());
+
+        bool result = meshRes->LoadMesh(ifs);
+        ASSERT(result, TEXT("Failed to load mesh"))
+        const uint32_t numCorners = meshRes->VerticesCPU.GetNumElements();
+        MeshCache::ImportStats stats;
+        const std::vector<uint8_t>& cache = meshRes->ImportMeshCache(sourceSize, sourceStamp, sMeshVertexFormat, &stats);
+        // the parsed source is released by the import, the welded mesh is kept until the upload
+        sReportAssetLoaded(sourceSize, meshRes->GetMeshCacheBytes());
+        DEBUG_PRINT(", %u corners welded to %u vertices", numCorners, meshRes->mMeshCache.GetNumVertices());
+        for (uint32_t lod = 1; lod < meshRes->mMeshCache.GetNumLods(); ++lod)
+        {
+            const MeshCache::SubMeshRange* subMeshes = meshRes->mMeshCache.GetSubMeshes(lod);
+            uint32_t numIndices = 0;
+            for (uint32_t i = 0; i < meshRes->mMeshCache.GetNumSubMeshes(); ++i) numIndices += subMeshes[i].mIndexCount;
+            DEBUG_PRINT(", lod %u %u triangles (error %.4f)", lod, numIndices / 3, meshRes->mMeshCache.GetLodError(lod));
+        }
+        DEBUG_PRINT(", ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, overfetch %.3f -> %.3f",
+            stats.mSourceCache.mAcmr, stats.mOptimizedCache.mAcmr, stats.mSourceCache.mAtvr, stats.mOptimizedCache.mAtvr,
+            stats.mSourceOverfetch, stats.mOptimizedOverfetch);
+        DEBUG_PRINT(", vertices %u -> %u bytes, fetch %u -> %u bytes per draw", stats.mFullVertexBytes, stats.mVertexBytes,
+            stats.mFullFetchBytes, stats.mFetchBytes);
+        if (!sWriteBinaryFile(cachePath, cache))
+        {
+            DEBUG_PRINT(", <%s> is not writable", cachePath.c_str());
+        }
+    }
+    const MeshCache& cache = meshRes->mMeshCache;
+    meshRes->mMeshDataGpu.mBounds = BoundingBox::FromMinMax(cache.GetBoundsMin(), cache.GetBoundsMax());
+    DEBUG_PRINT(" in %.2f ms\n", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
 
     //--------------------upload resource to GPU--------------------
     if (!isAsync)
@@ -113,6 +272,7 @@ void FileManager::sLoadBolbFile<MeshData>(const TpString& fileName, const TpStri
 template<>
 void FileManager::sLoadBolbFile<TextureRef>(const TpString& fileName, const TpString& filePath,bool isAsync)
 {
+    PROFILE_SCOPE("FileManager::sLoadBolbFile<Texture>");
     //check whether mesh resource has already been loaded
     auto itor = sLoadedTextures.find(fileName);
     if (itor != sLoadedTextures.end())
@@ -122,6 +282,8 @@ void FileManager::sLoadBolbFile<TextureRef>(const TpString& fileName, const TpSt
     ASSERT(!ifs.fail(), TEXT("texture file is not found"))
     DEBUG_PRINT("Load texture <%s> from <%s>\n", name.c_str(), filePath.c_str());
 
+    const int64_t textureBytes = sGetStreamSize(ifs);
+    sReportAssetLoaded(textureBytes, textureBytes);
     RenderTextureResource* texRes = new RenderTextureResource();
     
     bool result = texRes->LoadTGATexture(ifs);
@@ -152,9 +314,63 @@ void FileManager::sLoadBolbFile<TextureRef>(const TpString& fileName, const TpSt
     }
 }
 
+bool FileManager::sLoadShaderCache(const TpString& filePath)
+{
+    PROFILE_SCOPE("FileManager::sLoadShaderCache");
+    const TpString finalPath = Application::sGetDataPath() + "PcShader/" + filePath;
+    std::ifstream file(finalPath, std::ios::binary);
+    if (!file.is_open())
+    {
+        DEBUG_PRINT("No shader cache at <%s>, shaders are compiled at runtime\n", finalPath.c_str());
+        return false;
+    }
+    const int64_t size = sGetStreamSize(file);
+    std::unique_ptr<char[]> data = std::make_unique<char[]>(size);
+    if (!file.read(data.get(), size)) return false;
+    // the archive is released once the renderer registered its shaders
+    TELEMETRY_COUNT(ASSET_BYTES_LOADED, size);
+    if (!Renderer::GetInstance().loadShaderCache(data.get(), size))
+    {
+        DEBUG_PRINT("Shader cache <%s> is outdated, rebuild it with ShaderCacheBuilder\n", finalPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool FileManager::sLoadPipelineStates(const TpString& listPath, const TpString& libraryPath)
+{
+    PROFILE_SCOPE("FileManager::sLoadPipelineStates");
+    const TpString finalListPath = Application::sGetDataPath() + "PcShader/" + listPath;
+    const std::vector<char> list = sReadBinaryFile(finalListPath);
+    const std::vector<char> library = sReadBinaryFile(Application::sGetDataPath() + "PcShader/" + libraryPath);
+    if (list.empty())
+    {
+        DEBUG_PRINT("No pipeline state list at <%s>, pipeline states are created by the first draw using them\n", finalListPath.c_str());
+        return false;
+    }
+    if (!Renderer::GetInstance().loadPipelineStates(list.data(), list.size(), library.data(), library.size()))
+    {
+        DEBUG_PRINT("Pipeline state list <%s> is outdated, it is recorded again\n", finalListPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool FileManager::sSavePipelineStates(const TpString& listPath, const TpString& libraryPath)
+{
+    PROFILE_SCOPE("FileManager::sSavePipelineStates");
+    std::vector<uint8_t> list;
+    std::vector<uint8_t> library;
+    Renderer::GetInstance().savePipelineStates(list, library);
+    // a list without its library still prewarms, the pipelines are compiled instead of loaded
+    return sWriteBinaryFile(Application::sGetDataPath() + "PcShader/" + listPath, list) &&
+        (library.empty() || sWriteBinaryFile(Application::sGetDataPath() + "PcShader/" + libraryPath, library));
+}
+
 template<>
 void FileManager::sLoadBolbFile<ShaderRef>(const TpString& fileName, const TpString& filePath, bool isAsync)
 {
+    PROFILE_SCOPE("FileManager::sLoadBolbFile<Shader>");
     auto itor = sLoadedShaders.find(fileName);
     if (itor != sLoadedShaders.end())
         return;
@@ -186,6 +402,8 @@ void FileManager::sLoadBolbFile<ShaderRef>(const TpString& fileName, const TpStr
         throw Exception(AsciiToUtf8(TpString("Failed to read file: ")+filePath).c_str());
     }
 
+    // the binary is released once the shader is registered
+    sReportAssetLoaded(static_cast<int64_t>(fileSize), 0);
     Blob shaderBinary {std::move(binShader), static_cast<size_t>(fileSize)};
     Renderer& renderer = Renderer::GetInstance();
     ShaderRef shaderRef =  renderer.compileAndRegisterShader(fileName, shaderBinary,
@@ -218,12 +436,15 @@ void FileManager::sLoadBolbFile<ShaderRef>(const TpString& fileName, const TpStr
 template<>
 void FileManager::sLoadBolbFile<AudioClip*>(const TpString& fileName, const TpString& filePath,bool isAsync)
 {
+    PROFILE_SCOPE("FileManager::sLoadBolbFile<AudioClip>");
     auto itor = sLoadedAudioClips.find(fileName);
     if (itor != sLoadedAudioClips.end()) 
         return;
     
     std::ifstream ifs(Application::sGetDataPath() + filePath, std::ios::binary);
     ASSERT(!ifs.fail(), TEXT("Audio file not found!"))
+    const int64_t audioBytes = sGetStreamSize(ifs);
+    sReportAssetLoaded(audioBytes, audioBytes);
     AudioData* audioData = new AudioData();
     audioData->ReadFile(ifs);
     BolbFile<AudioData*> bolbFile;
@@ -253,6 +474,7 @@ void FileManager::sLoadBolbFile<AudioClip*>(const TpString& fileName, const TpSt
 
 void FileManager::uploadAllAssets()
 {
+    PROFILE_SCOPE("FileManager::uploadAllAssets");
     for (auto& file : sLoadedMeshes)
     {
         if (!file.second.isUploadGpu)
@@ -291,6 +513,13 @@ MeshData FileManager::sGetLoadedBolbFile<MeshData>(const TpString& fileName)
     return itor->second.data->mMeshDataGpu;
 }
 
+const BoundingBox& FileManager::sGetLoadedMeshBounds(const TpString& fileName)
+{
+    auto itor = sLoadedMeshes.find(fileName);
+    ASSERT(itor != sLoadedMeshes.end(), TEXT("Mesh not found!"))
+    return itor->second.data->mMeshDataGpu.mBounds;
+}
+
 template<>
 TextureRef FileManager::sGetLoadedBolbFile<TextureRef>(const TpString& fileName)
 {
@@ -7,12 +7,14 @@
 #include "Engine/Memory/TankinMemory.h"
 #include "Engine/Render/Material.h"
 #include "Engine/Render/RenderResource.h"
+#include "Engine/Render/VertexFormat.h"
 #include "Engine/Utility/ThreadPool/ThreadPool.h"
 
 struct AudioData;
 class AudioResourceWave;
 struct MaterialCPU;
 struct MeshData;
+struct BoundingBox;
 class RenderTextureResource;
 class RenderMeshResource;
 
@@ -21,6 +23,8 @@ class FileManager
 public:
     template<class T>
     static T sGetLoadedBolbFile(const TpString& fileName);
+    ///Local space bounds of a loaded mesh, avoids copying the whole MeshData every frame
+    static const BoundingBox& sGetLoadedMeshBounds(const TpString& fileName);
     ///Load Bolb File which user do not want to control its life cycle,
     template<class T>
     static void sLoadBolbFile(const TpString& fileName, const TpString& filePath, bool isAsync = false);
@@ -90,7 +94,15 @@ public:
     static void serializeSelf(rapidxml::xml_document<>* doc, rapidxml::xml_node<>* father);
     static void deserializeSelf(rapidxml::xml_node<>* node, TpList<std::future<void>>& tasks);
     static void sLoadNessaryFile(rapidxml::xml_node<>* node);
+    ///Load the compiled shader archive built by Tools/ShaderCacheBuilder, shaders missing from it are compiled at runtime
+    static bool sLoadShaderCache(const TpString& filePath);
+    ///Load the pipeline states recorded by the last session and the driver's pipeline library, call before loading shaders
+    static bool sLoadPipelineStates(const TpString& listPath, const TpString& libraryPath);
+    ///Save the pipeline states created so far for sLoadPipelineStates of the next session
+    static bool sSavePipelineStates(const TpString& listPath, const TpString& libraryPath);
     static void uploadAllAssets();
+    ///Vertex format meshes are imported into, caches of another format are imported again on their next load
+    static VertexFormat sMeshVertexFormat;
 private:
     //gpu uploading is synchronous
     template<class MapType>
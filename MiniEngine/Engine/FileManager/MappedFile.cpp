@@ -0,0 +1,77 @@
+#include "MappedFile.h"
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+#ifdef WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+    // the view keeps the mapping and the file alive
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) return false;
+    mData = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!mData) return false;
+    mSize = static_cast<size_t>(size.QuadPart);
+#else
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) return false;
+    struct stat status{};
+    if (fstat(file, &status) != 0 || status.st_size == 0)
+    {
+        close(file);
+        return false;
+    }
+    void* pData = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (pData == MAP_FAILED) return false;
+    mData = pData;
+    mSize = static_cast<size_t>(status.st_size);
+#endif
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (!mData) return;
+#ifdef WIN32
+    UnmapViewOfFile(mData);
+#else
+    munmap(const_cast<void*>(mData), mSize);
+#endif
+    mData = nullptr;
+    mSize = 0;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept : mData(other.mData), mSize(other.mSize)
+{
+    other.mData = nullptr;
+    other.mSize = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        mData = other.mData;
+        mSize = other.mSize;
+        other.mData = nullptr;
+        other.mSize = 0;
+    }
+    return *this;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "Engine/pch.h"
+
+// Read-only view of a whole file. The pages are loaded on first access and shared with the os file cache, nothing is
+// copied until the data is read.
+class MappedFile
+{
+public:
+    // false when the file can not be opened or is empty.
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return mData != nullptr; }
+    const void* GetData() const { return mData; }
+    size_t GetSize() const { return mSize; }
+
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    DELETE_COPY_CONSTRUCTOR(MappedFile)
+    DELETE_COPY_OPERATOR(MappedFile)
+
+private:
+    const void* mData = nullptr;
+    size_t mSize = 0;
+};
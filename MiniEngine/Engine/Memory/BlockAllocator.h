@@ -1,25 +1,33 @@
 #pragma once
 #include "Engine/common/helper.h"
 #include "Engine/pch.h"
+#include "MemoryTracker.h"
 
 class BlockAllocator : NonCopyable
 {
 public:
-    void Initialize(uint64_t size = 1024ull)
+    // unitSize: bytes represented by one block, used for memory tracking only.
+    void Initialize(uint64_t size = 1024ull, MemoryTag tag = MemoryTag::RENDER, uint64_t unitSize = 1)
     {
         mTotalSize = size;
+        mUnitSize = unitSize;
+        mTag = tag;
         mFreeBlocks.reset(new uint64_t[size]);
         mBlockStates.reset(new bool[size]);
         for (uint64_t i = 0; i < size; i++)
         {
             mFreeBlocks[i] = size - i - 1;
+            mBlockStates[i] = false;
         }
         mNumFreeBlocks = size;
     }
     uint64_t Allocate()
     {
         if (!mNumFreeBlocks) return MAXUINT64;
-        return mFreeBlocks[--mNumFreeBlocks];
+        uint64_t offset = mFreeBlocks[--mNumFreeBlocks];
+        mBlockStates[offset] = true;
+        MEM_TRACK_ALLOC(mTag, mUnitSize);
+        return offset;
     }
     std::unique_ptr<uint64_t[]> Allocate(uint64_t size)
     {
@@ -28,20 +36,34 @@ public:
         for (uint64_t i = 0; i < size; i++)
         {
             offsets[i] = mFreeBlocks[--mNumFreeBlocks];
+            mBlockStates[offsets[i]] = true;
         }
+        MEM_TRACK_ALLOC(mTag, size * mUnitSize);
         return std::unique_ptr<uint64_t[]>(offsets);
     }
     bool Free(uint64_t offset)
     {
-        if (!mBlockStates[offset]) return false;
+        // out of range or already freed
+        if (offset >= mTotalSize || !mBlockStates[offset]) return false;
         mBlockStates[offset] = false;
         mFreeBlocks[mNumFreeBlocks++] = offset;
+        MEM_TRACK_FREE(mTag, mUnitSize);
         return true;
     }
+    bool IsAllocated(uint64_t offset) const
+    {
+        return offset < mTotalSize && mBlockStates[offset];
+    }
+    uint64_t GetAllocatedCount() const
+    {
+        return mTotalSize - mNumFreeBlocks;
+    }
     BlockAllocator() = default;
 private:
     uint64_t mTotalSize;
     std::unique_ptr<bool[]> mBlockStates;
     std::unique_ptr<uint64_t[]> mFreeBlocks;
     uint64_t mNumFreeBlocks;
+    uint64_t mUnitSize;
+    MemoryTag mTag;
 };
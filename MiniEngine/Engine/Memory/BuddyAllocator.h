@@ -1,6 +1,7 @@
 #pragma once
 #include "Engine/pch.h"
 #include "Engine/common/helper.h"
+#include "MemoryTracker.h"
 
 class BuddyAllocator
 {
@@ -17,7 +18,7 @@ public:
         bool mIsFree;
     };
 
-    void Initialize(uint64_t totalSize = 4ull * 1024 * 1024, uint64_t blockSize = 64);
+    void Initialize(uint64_t totalSize = 4ull * 1024 * 1024, uint64_t blockSize = 64, MemoryTag tag = MemoryTag::RENDER);
     
     uint64_t GetSize() const { return mTotalSize; }
     uint64_t GetBlockSize() const { return mBlockSize; }
@@ -30,13 +31,14 @@ public:
 
 private:
     static Node* AllocateRecursive(Node* node, uint64_t targetSize);
-    static bool ForceFreeRecursive(Node* node, uint64_t offset);
-    static bool FreeRecursive(Node* node, uint64_t offset);
+    static bool ForceFreeRecursive(Node* node, uint64_t offset, uint64_t& freedSize);
+    static bool FreeRecursive(Node* node, uint64_t offset, uint64_t& freedSize);
 
     uint64_t mTotalSize;
     uint64_t mBlockSize;
     std::unique_ptr<Node> mRoot;
     uint8_t mMaxDepth;
+    MemoryTag mTag;
 };
 
 inline BuddyAllocator::Node::Node() = default;
@@ -44,8 +46,9 @@ inline BuddyAllocator::Node::Node() = default;
 inline BuddyAllocator::Node::Node(uint64_t offset, uint64_t size): mOffset(offset), mSize(size), mIsFree(true)
 {}
 
-inline void BuddyAllocator::Initialize(uint64_t totalSize, uint64_t blockSize)
+inline void BuddyAllocator::Initialize(uint64_t totalSize, uint64_t blockSize, MemoryTag tag)
 {
+    mTag = tag;
     mBlockSize = ::AlignUpToMul<uint64_t, sizeof(int)>()(blockSize);  //   align with the length of a word.
     mTotalSize = RoundUpToPowerOfTwo(std::max(::AlignUpToMul<uint64_t, sizeof(int)>()(totalSize), blockSize));
     mMaxDepth = std::_Floor_of_log_2(mTotalSize) - std::_Floor_of_log_2(mBlockSize);
@@ -59,6 +62,7 @@ inline uint64_t BuddyAllocator::Allocate(uint64_t size) const
     if (node)
     {
         node->mIsFree = false;
+        MEM_TRACK_ALLOC(mTag, node->mSize);
         return node->mOffset;
     }
     return MAXUINT64;
@@ -66,12 +70,19 @@ inline uint64_t BuddyAllocator::Allocate(uint64_t size) const
 
 inline void BuddyAllocator::ForceFree(uint64_t offset) const
 {
-    ForceFreeRecursive(mRoot.get(), offset);
+    uint64_t freedSize = 0;
+    if (ForceFreeRecursive(mRoot.get(), offset, freedSize))
+    {
+        MEM_TRACK_FREE(mTag, freedSize);
+    }
 }
 
 inline bool BuddyAllocator::Free(uint64_t offset) const
 {
-    return FreeRecursive(mRoot.get(), offset);
+    uint64_t freedSize = 0;
+    if (!FreeRecursive(mRoot.get(), offset, freedSize)) return false;
+    MEM_TRACK_FREE(mTag, freedSize);
+    return true;
 }
 
 inline BuddyAllocator::BuddyAllocator() = default;
@@ -93,14 +104,14 @@ inline BuddyAllocator::Node* BuddyAllocator::AllocateRecursive(Node* node, uint6
     return alloc ? alloc : AllocateRecursive(node->mRight.get(), targetSize);
 }
 
-inline bool BuddyAllocator::ForceFreeRecursive(Node* node, uint64_t offset)
+inline bool BuddyAllocator::ForceFreeRecursive(Node* node, uint64_t offset, uint64_t& freedSize)
 {
     if (!node || node->mIsFree) return false;
     if (node->mLeft)
     {
         // Try children
-        const bool isFreed = ForceFreeRecursive(node->mLeft.get(), offset) ||
-            ForceFreeRecursive(node->mRight.get(), offset);
+        const bool isFreed = ForceFreeRecursive(node->mLeft.get(), offset, freedSize) ||
+            ForceFreeRecursive(node->mRight.get(), offset, freedSize);
 
         // Try to merge buddies
         if (isFreed && node->mLeft->mIsFree && node->mRight->mIsFree)
@@ -116,18 +127,20 @@ inline bool BuddyAllocator::ForceFreeRecursive(Node* node, uint64_t offset)
     if (node->mOffset == offset)
     {
         node->mIsFree = true;
+        freedSize = node->mSize;
         return true;
     }
     return false;
 }
 
-inline bool BuddyAllocator::FreeRecursive(Node* node, uint64_t offset)
+inline bool BuddyAllocator::FreeRecursive(Node* node, uint64_t offset, uint64_t& freedSize)
 {
     if ((node->mLeft != nullptr) ^ (node->mOffset != offset)) return false;
     if (node->mOffset != offset)
     {
-        return FreeRecursive(node->mLeft.get(), offset) || FreeRecursive(node->mRight.get(), offset);
+        return FreeRecursive(node->mLeft.get(), offset, freedSize) || FreeRecursive(node->mRight.get(), offset, freedSize);
     }
     node->mIsFree = true;
+    freedSize = node->mSize;
     return true;
 }
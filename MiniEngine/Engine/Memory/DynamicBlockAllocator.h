@@ -1,6 +1,7 @@
 #pragma once
 #include "Engine/pch.h"
 #include "Engine/common/helper.h"
+#include "MemoryTracker.h"
 
 template<class T>
 class DynamicBlockAllocator : NonCopyable {
@@ -25,12 +26,13 @@ public:
         DynamicBlockAllocator* mAllocator = nullptr;
     };
     
-    void Initialize(uint64_t capacity = 64, uint64_t growBlockSize = 32);
+    void Initialize(uint64_t capacity = 64, uint64_t growBlockSize = 32, MemoryTag tag = MemoryTag::GAMEPLAY);
     Handle Allocate();
     void Free(Handle& handle);
     T* Resolve(uint64_t offset) const;
     void Reset();
     DynamicBlockAllocator();
+    ~DynamicBlockAllocator();
 
     static constexpr uint32_t BLOCK_SIZE = sizeof(T);
 
@@ -40,8 +42,9 @@ private:
     uint64_t mCapacity;
     uint64_t mGrowBlockSize;
     std::unique_ptr<T[]> mPool;
-    uint64_t* mFreeBlocks;
-    uint64_t mFreeBlocksSize;
+    uint64_t* mFreeBlocks = nullptr;
+    uint64_t mFreeBlocksSize = 0;
+    MemoryTag mTag = MemoryTag::GAMEPLAY;
 };
 
 template <typename T>
@@ -102,6 +105,16 @@ DynamicBlockAllocator<T>::Handle::operator uint64_t() const
 template <typename T>
 DynamicBlockAllocator<T>::DynamicBlockAllocator() = default;
 
+template <typename T>
+DynamicBlockAllocator<T>::~DynamicBlockAllocator()
+{
+    if (mPool)
+    {
+        MEM_TRACK_FREE(mTag, mCapacity * (sizeof(T) + sizeof(uint64_t)));
+    }
+    delete[] mFreeBlocks;
+}
+
 template <typename T>
 void DynamicBlockAllocator<T>::Grow()
 {
@@ -115,7 +128,7 @@ void DynamicBlockAllocator<T>::Grow()
     
     for (uint64_t i = 0; i < mGrowBlockSize; ++i)
     {
-        newFreeBlocks[mFreeBlocksSize + i] = mCapacity + mGrowBlockSize - i;
+        newFreeBlocks[mFreeBlocksSize + i] = newCapacity - i - 1;
     }
     
     if (mFreeBlocks)
@@ -126,19 +139,22 @@ void DynamicBlockAllocator<T>::Grow()
     mPool.swap(newPool);
     std::swap(mFreeBlocks, newFreeBlocks);
     mFreeBlocksSize += mGrowBlockSize;
+    MEM_TRACK_ALLOC(mTag, mGrowBlockSize * (sizeof(T) + sizeof(uint64_t)));
     mCapacity = newCapacity;
     
     delete[] newFreeBlocks;
 }
 
 template <typename T>
-void DynamicBlockAllocator<T>::Initialize(uint64_t capacity, uint64_t growBlockSize)
+void DynamicBlockAllocator<T>::Initialize(uint64_t capacity, uint64_t growBlockSize, MemoryTag tag)
 {
+    mTag = tag;
     mCapacity = capacity;
     mGrowBlockSize = growBlockSize;
     mPool = std::make_unique<T[]>(mCapacity);
     mFreeBlocks = new uint64_t[mCapacity];
     mFreeBlocksSize = mCapacity;
+    MEM_TRACK_ALLOC(mTag, mCapacity * (sizeof(T) + sizeof(uint64_t)));
         
     // Initialize Reset blocks stack
     for (uint64_t i = 0; i < mCapacity; ++i)
@@ -148,7 +164,7 @@ void DynamicBlockAllocator<T>::Initialize(uint64_t capacity, uint64_t growBlockS
 }
 
 template <typename T>
-typename DynamicBlockAllocator<T>::template Handle<T> DynamicBlockAllocator<T>::Allocate()
+typename DynamicBlockAllocator<T>::Handle DynamicBlockAllocator<T>::Allocate()
 {
     // For simplicity, this implementation only supports single element allocation
     // Could be extended to support contiguous blocks
@@ -169,11 +185,11 @@ template <class T>
 void DynamicBlockAllocator<T>::Free(Handle& handle)
 {
     uint64_t blockIndex = handle.GetVirtualAddress();
-    if (blockIndex > mCapacity) {
+    if (blockIndex >= mCapacity) {
         return;
     }
     T* ptr = (mPool.get() + blockIndex); 
-    *ptr.~T();
+    ptr->~T();
     memset(ptr, 0, sizeof(T));
     mFreeBlocks[mFreeBlocksSize++] = blockIndex;
 }
@@ -181,10 +197,10 @@ void DynamicBlockAllocator<T>::Free(Handle& handle)
 template <typename T>
 T* DynamicBlockAllocator<T>::Resolve(uint64_t offset) const
 {
-    if (offset > mCapacity) {
+    if (offset >= mCapacity) {
         return nullptr;
     }
-    return &mPool[offset]; // Blocks are 1-based
+    return &mPool[offset];
 }
 
 template <typename T>
@@ -192,6 +208,6 @@ void DynamicBlockAllocator<T>::Reset()
 {
     mFreeBlocksSize = mCapacity;
     for (uint64_t i = 0; i < mCapacity; ++i) {
-        mFreeBlocks[i] = mCapacity - i;
+        mFreeBlocks[i] = mCapacity - i - 1;
     }
 }
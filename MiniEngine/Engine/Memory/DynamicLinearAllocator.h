@@ -2,7 +2,12 @@
 #include "Engine/pch.h"
 #include "Engine/common/Exception.h"
 #include "Engine/common/helper.h"
+#include "MemoryTracker.h"
+#include "VirtualLinearAllocator.h"
 
+// Growable linear allocator addressed by offsets.
+// Backed by a VirtualLinearAllocator: growing commits more pages of the reserved range
+// instead of reallocating, so resolved pointers stay valid until Reset.
 class DynamicLinearAllocator : NonCopyable
 {
 public:
@@ -34,7 +39,8 @@ public:
     template<typename T>
     T* Resolve(uint64_t offset) const;
 
-    void Initialize(uint64_t initialSize = 1048576ul, uint32_t alignment = 8, uint32_t blockSize = 64 * 1024);
+    void Initialize(uint64_t initialSize = 1048576ul, uint32_t alignment = 8, uint32_t blockSize = 64 * 1024, MemoryTag tag = MemoryTag::RENDER,
+                    uint64_t reserveSize = 256ull * 1024 * 1024);
     void Reset();
     DynamicLinearAllocator();
     DynamicLinearAllocator(DynamicLinearAllocator&& other) noexcept;
@@ -43,14 +49,8 @@ public:
     DynamicLinearAllocator& operator=(DynamicLinearAllocator&& other) noexcept;
 
 private:
-    void Grow();
-
-    uint8_t* mMemoryPool = nullptr;
-    uint64_t mMemoryPoolSize = 0;
-    uint64_t mOccupiedSize = 0;
-    
+    VirtualLinearAllocator mBackend;
     uint32_t mAlignment = 0;
-    uint32_t mBlockSize = 0;
 };
 
 template <typename T>
@@ -117,83 +117,45 @@ DynamicLinearAllocator::Handle<TPtr> DynamicLinearAllocator::Allocate(uint64_t n
     constexpr uint64_t alignment = alignof(TValue);
         
     uint64_t alignedSize = ((size + alignment - 1) & ~(alignment - 1)) * numElements;
-    if (mOccupiedSize + alignedSize > mMemoryPoolSize) Grow();
-    
-    uint64_t offset = mOccupiedSize;
-    mOccupiedSize += alignedSize;
+    uint64_t offset = mBackend.Allocate(alignedSize, std::max<uint64_t>(alignment, mAlignment));
+    if (offset == MAXUINT64) throw std::bad_alloc();
     return Handle<TPtr>(offset, this);
 }
 
 template <typename T>
 T* DynamicLinearAllocator::Resolve(uint64_t offset) const
 {
-    ASSERT(offset < mOccupiedSize, TEXT("violate memory access"));
-    return reinterpret_cast<T*>(mMemoryPool + offset);
+    return mBackend.Resolve<T>(offset);
 }
 
-inline void DynamicLinearAllocator::Initialize(uint64_t initialSize, uint32_t alignment, uint32_t blockSize)
+inline void DynamicLinearAllocator::Initialize(uint64_t initialSize, uint32_t alignment, uint32_t blockSize, MemoryTag tag, uint64_t reserveSize)
 {
-    if (mMemoryPool) return;
+    if (mBackend.GetBase()) return;
         
     mAlignment = alignment;
-    mBlockSize = blockSize;
-    mMemoryPoolSize = initialSize;
-        
-    // 使用VirtualAlloc确保内存对齐
-    mMemoryPool = static_cast<uint8_t*>(MEM_VIRTUAL_ALLOC(initialSize));
-    if (!mMemoryPool) throw std::bad_alloc();
-        
-    mOccupiedSize = 0;
+    mBackend.Initialize(std::max(reserveSize, initialSize), RoundUpToPowerOfTwo(blockSize), initialSize, tag);
 }
 
 inline void DynamicLinearAllocator::Reset()
 {
-    mOccupiedSize = 0;
+    mBackend.Reset();
 }
 
 inline DynamicLinearAllocator::DynamicLinearAllocator() = default;
 
-inline DynamicLinearAllocator::DynamicLinearAllocator(DynamicLinearAllocator&& other)  noexcept
+inline DynamicLinearAllocator::DynamicLinearAllocator(DynamicLinearAllocator&& other)  noexcept :
+    mBackend(std::move(other.mBackend)), mAlignment(other.mAlignment)
 {
-    std::swap(mMemoryPool, other.mMemoryPool);
-    std::swap(mAlignment, other.mAlignment);
-    std::swap(mBlockSize, other.mBlockSize);
-    std::swap(mOccupiedSize, other.mOccupiedSize);
 }
 
 inline DynamicLinearAllocator& DynamicLinearAllocator::operator=(DynamicLinearAllocator&& other) noexcept
 {
     if (&other != this)
     {
-        std::swap(mMemoryPool, other.mMemoryPool);
+        mBackend = std::move(other.mBackend);
         std::swap(mAlignment, other.mAlignment);
-        std::swap(mBlockSize, other.mBlockSize);
-        std::swap(mOccupiedSize, other.mOccupiedSize);
     }
     return *this;
 }
 
-inline DynamicLinearAllocator::~DynamicLinearAllocator()
-{
-    if (mMemoryPool)
-    {
-        MEM_VIRTUAL_FREE(mMemoryPool);
-    }
-}
-
-inline void DynamicLinearAllocator::Grow()
-{
-    const uint64_t newSize = mMemoryPoolSize + mBlockSize;
-        
-    uint8_t* newPool = static_cast<uint8_t*>(MEM_VIRTUAL_ALLOC(newSize));
-    if (!newPool) throw std::bad_alloc();
-        
-    if (mMemoryPool)
-    {
-        memcpy(newPool, mMemoryPool, mOccupiedSize);
-        MEM_VIRTUAL_FREE(mMemoryPool);
-    }
-        
-    mMemoryPool = newPool;
-    mMemoryPoolSize = newSize;
-}
+inline DynamicLinearAllocator::~DynamicLinearAllocator() = default;
@@ -1,11 +1,13 @@
 #pragma once
 #include "Engine/common/helper.h"
 #include "Engine/pch.h"
+#include "MemoryTracker.h"
 
 class LinearAllocator : NonCopyable
 {
 public:
-    void Initialize(uint64_t size = 1024ull);
+    // unitSize: bytes represented by one unit of offset, used for memory tracking only.
+    void Initialize(uint64_t size = 1024ull, MemoryTag tag = MemoryTag::RENDER, uint64_t unitSize = 1);
     uint64_t Allocate(uint64_t size = 1);
     void Reset();
     LinearAllocator();
@@ -13,23 +15,30 @@ public:
 private:
     uint64_t mTotalSize;
     uint64_t mOccupiedSize;
+    uint64_t mUnitSize;
+    MemoryTag mTag;
 };
 
-inline void LinearAllocator::Initialize(uint64_t size)
+inline void LinearAllocator::Initialize(uint64_t size, MemoryTag tag, uint64_t unitSize)
 {
     mTotalSize = size;
-    mOccupiedSize = size;
+    mOccupiedSize = 0;
+    mUnitSize = unitSize;
+    mTag = tag;
 }
 
 inline uint64_t LinearAllocator::Allocate(uint64_t size)
 {
-    if (mOccupiedSize + size >= mTotalSize) return MAXUINT64;
+    if (mOccupiedSize + size > mTotalSize) return MAXUINT64;
+    uint64_t offset = mOccupiedSize;
     mOccupiedSize += size;
-    return mOccupiedSize;
+    MEM_TRACK_ALLOC(mTag, size * mUnitSize);
+    return offset;
 }
 
 inline void LinearAllocator::Reset()
 {
+    MEM_TRACK_FREE(mTag, mOccupiedSize * mUnitSize);
     mOccupiedSize = 0;
 }
 
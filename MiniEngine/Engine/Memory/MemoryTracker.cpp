@@ -0,0 +1,110 @@
+#include "MemoryTracker.h"
+
+#include "Engine/Utility/MacroUtility.h"
+
+std::array<MemoryTracker::TagCounters, static_cast<size_t>(MemoryTag::COUNT)> MemoryTracker::sCounters{};
+
+MemorySnapshot MemorySnapshot::Diff(const MemorySnapshot& current, const MemorySnapshot& base)
+{
+    MemorySnapshot diff;
+    for (size_t i = 0; i < diff.mTags.size(); ++i)
+    {
+        diff.mTags[i].mLiveBytes = current.mTags[i].mLiveBytes - base.mTags[i].mLiveBytes;
+        diff.mTags[i].mPeakBytes = current.mTags[i].mPeakBytes;
+        diff.mTags[i].mNumAllocations = current.mTags[i].mNumAllocations - base.mTags[i].mNumAllocations;
+        diff.mTags[i].mNumFrees = current.mTags[i].mNumFrees - base.mTags[i].mNumFrees;
+    }
+    return diff;
+}
+
+void MemoryTracker::SetBudget(MemoryTag tag, uint64_t bytes)
+{
+    TagCounters& counters = sCounters[static_cast<size_t>(tag)];
+    counters.mBudget.store(bytes, std::memory_order_relaxed);
+    counters.mOverBudget.store(false, std::memory_order_relaxed);
+}
+
+uint64_t MemoryTracker::GetBudget(MemoryTag tag)
+{
+    return sCounters[static_cast<size_t>(tag)].mBudget.load(std::memory_order_relaxed);
+}
+
+MemoryTagStats MemoryTracker::GetStats(MemoryTag tag)
+{
+    const TagCounters& counters = sCounters[static_cast<size_t>(tag)];
+    MemoryTagStats stats;
+    stats.mLiveBytes = counters.mLiveBytes.load(std::memory_order_relaxed);
+    // without MEMORY_TRACKING the peak is only followed when the stats are read
+    stats.mPeakBytes = std::max(counters.mPeakBytes.load(std::memory_order_relaxed), stats.mLiveBytes);
+    stats.mNumAllocations = counters.mNumAllocations.load(std::memory_order_relaxed);
+    stats.mNumFrees = counters.mNumFrees.load(std::memory_order_relaxed);
+    return stats;
+}
+
+MemorySnapshot MemoryTracker::TakeSnapshot()
+{
+    MemorySnapshot snapshot;
+    for (size_t i = 0; i < snapshot.mTags.size(); ++i)
+    {
+        snapshot.mTags[i] = GetStats(static_cast<MemoryTag>(i));
+    }
+    return snapshot;
+}
+
+void MemoryTracker::ResetPeaks()
+{
+    for (auto& counters : sCounters)
+    {
+        counters.mPeakBytes.store(counters.mLiveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+void MemoryTracker::PrintSnapshot(const MemorySnapshot& snapshot, const char* title)
+{
+    DEBUG_PRINT("[ %s ]\n", title);
+    DEBUG_PRINT("    %-10s %14s %14s %10s %10s %14s\n", "tag", "live", "peak", "allocs", "frees", "budget");
+    for (size_t i = 0; i < snapshot.mTags.size(); ++i)
+    {
+        const MemoryTagStats& stats = snapshot.mTags[i];
+        DEBUG_PRINT("    %-10s %14lld %14lld %10llu %10llu %14llu\n", GetTagName(static_cast<MemoryTag>(i)),
+            static_cast<long long>(stats.mLiveBytes), static_cast<long long>(stats.mPeakBytes),
+            static_cast<unsigned long long>(stats.mNumAllocations), static_cast<unsigned long long>(stats.mNumFrees),
+            static_cast<unsigned long long>(GetBudget(static_cast<MemoryTag>(i))));
+    }
+}
+
+int64_t MemoryTracker::ReportLeaks()
+{
+    int64_t totalLive = 0;
+    for (size_t i = 0; i < sCounters.size(); ++i)
+    {
+        const MemoryTagStats stats = GetStats(static_cast<MemoryTag>(i));
+        if (!stats.mLiveBytes) continue;
+        DEBUG_PRINT("[ LEAK | %s ] %lld bytes still alive (%llu allocations, %llu frees)\n",
+            GetTagName(static_cast<MemoryTag>(i)), static_cast<long long>(stats.mLiveBytes),
+            static_cast<unsigned long long>(stats.mNumAllocations), static_cast<unsigned long long>(stats.mNumFrees));
+        totalLive += stats.mLiveBytes;
+    }
+    return totalLive;
+}
+
+const char* MemoryTracker::GetTagName(MemoryTag tag)
+{
+    switch (tag)
+    {
+    case MemoryTag::UNTAGGED: return "Untagged";
+    case MemoryTag::PHYSICS: return "Physics";
+    case MemoryTag::RENDER: return "Render";
+    case MemoryTag::ASSETS: return "Assets";
+    case MemoryTag::AUDIO: return "Audio";
+    case MemoryTag::GAMEPLAY: return "Gameplay";
+    case MemoryTag::UI: return "UI";
+    default: return "Unknown";
+    }
+}
+
+void MemoryTracker::OnBudgetExceeded(MemoryTag tag, int64_t liveBytes)
+{
+    DEBUG_PRINT("[ WARN | MemoryTracker ] tag %s exceeds its budget: %lld / %llu bytes\n", GetTagName(tag),
+        static_cast<long long>(liveBytes), static_cast<unsigned long long>(GetBudget(tag)));
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <array>
+#include <atomic>
+
+#include "Engine/pch.h"
+
+// Live bytes and budgets are tracked in every build, one relaxed atomic per allocation and free.
+// The allocation and free counts and the peaks are compiled in for debug builds, define ENABLE_MEMORY_TRACKING to
+// force them in release.
+#if defined(DEBUG) or defined(_DEBUG) or defined(ENABLE_MEMORY_TRACKING)
+#define MEMORY_TRACKING
+#endif
+
+enum class MemoryTag : uint8_t
+{
+    UNTAGGED = 0,
+    PHYSICS,
+    RENDER,
+    ASSETS,
+    AUDIO,
+    GAMEPLAY,
+    UI,
+    COUNT
+};
+
+struct MemoryTagStats
+{
+    int64_t mLiveBytes = 0;
+    int64_t mPeakBytes = 0;
+    uint64_t mNumAllocations = 0;
+    uint64_t mNumFrees = 0;
+};
+
+struct MemorySnapshot
+{
+    // per-tag difference of `current - base`, peak is taken from `current`.
+    static MemorySnapshot Diff(const MemorySnapshot& current, const MemorySnapshot& base);
+
+    std::array<MemoryTagStats, static_cast<size_t>(MemoryTag::COUNT)> mTags{};
+};
+
+// Global per-tag live/peak counters. All counters are relaxed atomics so every thread may report.
+// Use the MEM_TRACK_ALLOC/MEM_TRACK_FREE macros at call sites, without MEMORY_TRACKING they only keep the live bytes,
+// the counts stay 0 and the peaks are only sampled by GetStats.
+class MemoryTracker
+{
+public:
+    static void TrackAlloc(MemoryTag tag, uint64_t size);
+    static void TrackFree(MemoryTag tag, uint64_t size);
+    static void TrackLiveAlloc(MemoryTag tag, uint64_t size);
+    static void TrackLiveFree(MemoryTag tag, uint64_t size);
+
+    // 0 means no budget.
+    static void SetBudget(MemoryTag tag, uint64_t bytes);
+    static uint64_t GetBudget(MemoryTag tag);
+    static MemoryTagStats GetStats(MemoryTag tag);
+    static MemorySnapshot TakeSnapshot();
+    static void ResetPeaks();
+
+    static void PrintSnapshot(const MemorySnapshot& snapshot, const char* title = "Memory");
+    // print every tag which still holds memory, returns the total live bytes.
+    static int64_t ReportLeaks();
+    static const char* GetTagName(MemoryTag tag);
+
+private:
+    struct alignas(64) TagCounters
+    {
+        std::atomic<int64_t> mLiveBytes{0};
+        std::atomic<int64_t> mPeakBytes{0};
+        std::atomic<uint64_t> mNumAllocations{0};
+        std::atomic<uint64_t> mNumFrees{0};
+        std::atomic<uint64_t> mBudget{0};
+        std::atomic<bool> mOverBudget{false};
+    };
+
+    static void CheckBudget(MemoryTag tag, TagCounters& counters, int64_t live);
+    static void OnBudgetExceeded(MemoryTag tag, int64_t liveBytes);
+
+    static std::array<TagCounters, static_cast<size_t>(MemoryTag::COUNT)> sCounters;
+};
+
+inline void MemoryTracker::TrackAlloc(MemoryTag tag, uint64_t size)
+{
+    TagCounters& counters = sCounters[static_cast<size_t>(tag)];
+    const int64_t live = counters.mLiveBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) + static_cast<int64_t>(size);
+    counters.mNumAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    int64_t peak = counters.mPeakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !counters.mPeakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    CheckBudget(tag, counters, live);
+}
+
+inline void MemoryTracker::TrackFree(MemoryTag tag, uint64_t size)
+{
+    TrackLiveFree(tag, size);
+    sCounters[static_cast<size_t>(tag)].mNumFrees.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void MemoryTracker::TrackLiveAlloc(MemoryTag tag, uint64_t size)
+{
+    TagCounters& counters = sCounters[static_cast<size_t>(tag)];
+    const int64_t live = counters.mLiveBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) + static_cast<int64_t>(size);
+    CheckBudget(tag, counters, live);
+}
+
+inline void MemoryTracker::TrackLiveFree(MemoryTag tag, uint64_t size)
+{
+    TagCounters& counters = sCounters[static_cast<size_t>(tag)];
+    const int64_t live = counters.mLiveBytes.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed) - static_cast<int64_t>(size);
+    // re-arm the warning once the tag is back under budget, only written when it fired
+    if (counters.mOverBudget.load(std::memory_order_relaxed) && static_cast<uint64_t>(live) <= counters.mBudget.load(std::memory_order_relaxed))
+    {
+        counters.mOverBudget.store(false, std::memory_order_relaxed);
+    }
+}
+
+inline void MemoryTracker::CheckBudget(MemoryTag tag, TagCounters& counters, int64_t live)
+{
+    const uint64_t budget = counters.mBudget.load(std::memory_order_relaxed);
+    if (budget && static_cast<uint64_t>(live) > budget && !counters.mOverBudget.exchange(true, std::memory_order_relaxed))
+    {
+        OnBudgetExceeded(tag, live);
+    }
+}
+
+#ifdef MEMORY_TRACKING
+#define MEM_TRACK_ALLOC(tag, size) MemoryTracker::TrackAlloc((tag), static_cast<uint64_t>(size))
+#define MEM_TRACK_FREE(tag, size) MemoryTracker::TrackFree((tag), static_cast<uint64_t>(size))
+#else
+#define MEM_TRACK_ALLOC(tag, size) MemoryTracker::TrackLiveAlloc((tag), static_cast<uint64_t>(size))
+#define MEM_TRACK_FREE(tag, size) MemoryTracker::TrackLiveFree((tag), static_cast<uint64_t>(size))
+#endif
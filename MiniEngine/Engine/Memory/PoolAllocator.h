@@ -0,0 +1,321 @@
+#pragma once
+#include "Engine/common/Exception.h"
+#include "Engine/common/helper.h"
+#include "Engine/pch.h"
+#include "Engine/Utility/MacroUtility.h"
+#include "MemoryTracker.h"
+
+#include <new>
+
+#if defined(DEBUG) or defined(_DEBUG)
+#define POOL_ALLOCATOR_CANARY
+#endif
+
+// Fixed-size object pool.
+// Memory is organized as pages sorted by address, every page holds `BlocksPerPage` slots.
+// Growing appends a new page and never relocates the existing ones, so raw pointers
+// handed out by Allocate/New stay valid until they are freed.
+// Free slots are linked through their own storage (intrusive free list), and each page
+// keeps an occupancy bitmap used for iteration, double-free detection and leak reports.
+// When POOL_ALLOCATOR_CANARY is defined (debug builds) every slot is guarded by two canaries
+// which are validated on free, a block with an overwritten canary is reported and never reused.
+template<class T, uint32_t BlocksPerPage = 64>
+class PoolAllocator : NonCopyable
+{
+    static_assert(BlocksPerPage > 0, "a page must hold at least one block.");
+public:
+    void Initialize(uint32_t numInitialPages = 1, MemoryTag tag = MemoryTag::GAMEPLAY);
+    void* Allocate();
+    // false for pointers the pool did not hand out, blocks freed already and blocks whose canaries were overwritten.
+    bool Free(void* ptr);
+    template<typename... Args>
+    T* New(Args&&... args);
+    void Delete(T* ptr);
+    template<typename Fn>
+    void ForEach(Fn&& fn) const;
+    bool Owns(const void* ptr) const;
+    uint64_t ReportLeaks(const char* poolName = "PoolAllocator") const;
+    void Release();
+    uint64_t GetAllocatedCount() const;
+    uint64_t GetCapacity() const;
+    uint32_t GetPageCount() const;
+    PoolAllocator() = default;
+    ~PoolAllocator();
+
+    static constexpr uint32_t BLOCKS_PER_PAGE = BlocksPerPage;
+
+private:
+    static constexpr uint32_t NUM_BITMAP_WORDS = (BlocksPerPage + 63) / 64;
+    static constexpr uint32_t SLOT_ALIGNMENT = alignof(T) > alignof(void*) ? alignof(T) : alignof(void*);
+#ifdef POOL_ALLOCATOR_CANARY
+    static constexpr uint32_t CANARY_VALUE = 0xC0FFEE11u;
+    // free slots hold a FreeNode in the payload, it has to stay aligned for the pointer as well as for T
+    static constexpr uint32_t CANARY_SIZE = SLOT_ALIGNMENT;
+#else
+    static constexpr uint32_t CANARY_SIZE = 0;
+#endif
+    static constexpr uint32_t PAYLOAD_SIZE = sizeof(T) > sizeof(void*) ? sizeof(T) : sizeof(void*);
+    // [canary][payload][canary], padded so every payload stays aligned to T
+    static constexpr uint32_t SLOT_SIZE = (CANARY_SIZE * 2 + PAYLOAD_SIZE + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+
+    struct FreeNode
+    {
+        FreeNode* mNext;
+    };
+
+    struct Page
+    {
+        uint32_t mNumAllocated;
+        uint64_t mOccupancy[NUM_BITMAP_WORDS];
+        alignas(SLOT_ALIGNMENT) uint8_t mSlots[SLOT_SIZE * BlocksPerPage];
+    };
+
+    void AppendPage();
+    // binary search over the pages sorted by address
+    Page* FindPage(const void* payload) const;
+    static uint8_t* SlotToPayload(uint8_t* slot);
+    static uint8_t* PayloadToSlot(uint8_t* payload);
+    static bool IsOccupied(const Page* page, uint32_t index);
+    static void SetOccupied(Page* page, uint32_t index, bool occupied);
+
+    std::vector<Page*> mPages;
+    FreeNode* mFreeList = nullptr;
+    uint64_t mNumAllocated = 0;
+    MemoryTag mTag = MemoryTag::GAMEPLAY;
+};
+
+template <class T, uint32_t BlocksPerPage>
+void PoolAllocator<T, BlocksPerPage>::Initialize(uint32_t numInitialPages, MemoryTag tag)
+{
+    mTag = tag;
+    for (uint32_t i = 0; i < numInitialPages; ++i)
+    {
+        AppendPage();
+    }
+}
+
+template <class T, uint32_t BlocksPerPage>
+void* PoolAllocator<T, BlocksPerPage>::Allocate()
+{
+    if (!mFreeList) AppendPage();
+    FreeNode* node = mFreeList;
+    mFreeList = node->mNext;
+
+    uint8_t* payload = reinterpret_cast<uint8_t*>(node);
+    Page* page = FindPage(payload);
+    uint32_t index = static_cast<uint32_t>((PayloadToSlot(payload) - page->mSlots) / SLOT_SIZE);
+    SetOccupied(page, index, true);
+    ++page->mNumAllocated;
+    ++mNumAllocated;
+    return payload;
+}
+
+template <class T, uint32_t BlocksPerPage>
+bool PoolAllocator<T, BlocksPerPage>::Free(void* ptr)
+{
+    if (!ptr) return false;
+    uint8_t* payload = static_cast<uint8_t*>(ptr);
+    Page* page = FindPage(payload);
+    if (!page)
+    {
+        WARN("pointer is not owned by this pool.\n");
+        return false;
+    }
+    uint8_t* slot = PayloadToSlot(payload);
+    uint32_t index = static_cast<uint32_t>((slot - page->mSlots) / SLOT_SIZE);
+    if (slot != page->mSlots + index * SLOT_SIZE || !IsOccupied(page, index))
+    {
+        WARN("double free or misaligned pointer detected in pool.\n");
+        return false;
+    }
+#ifdef POOL_ALLOCATOR_CANARY
+    uint32_t head, tail;
+    memcpy(&head, payload - sizeof(uint32_t), sizeof(uint32_t));
+    memcpy(&tail, slot + CANARY_SIZE + PAYLOAD_SIZE, sizeof(uint32_t));
+    const bool intact = head == CANARY_VALUE && tail == CANARY_VALUE;
+    ASSERT(intact, TEXT("pool block canary corrupted, memory overrun detected.\n"));
+    if (!intact) return false;
+    memset(payload, 0xDD, PAYLOAD_SIZE);
+#endif
+    SetOccupied(page, index, false);
+    --page->mNumAllocated;
+    --mNumAllocated;
+
+    FreeNode* node = reinterpret_cast<FreeNode*>(payload);
+    node->mNext = mFreeList;
+    mFreeList = node;
+    return true;
+}
+
+template <class T, uint32_t BlocksPerPage>
+template <typename... Args>
+T* PoolAllocator<T, BlocksPerPage>::New(Args&&... args)
+{
+    return new (Allocate()) T(std::forward<Args>(args)...);
+}
+
+template <class T, uint32_t BlocksPerPage>
+void PoolAllocator<T, BlocksPerPage>::Delete(T* ptr)
+{
+    if (!ptr) return;
+    ptr->~T();
+    Free(ptr);
+}
+
+// visit every live block, page by page, in address order.
+template <class T, uint32_t BlocksPerPage>
+template <typename Fn>
+void PoolAllocator<T, BlocksPerPage>::ForEach(Fn&& fn) const
+{
+    for (Page* page : mPages)
+    {
+        if (!page->mNumAllocated) continue;
+        for (uint32_t word = 0; word < NUM_BITMAP_WORDS; ++word)
+        {
+            uint64_t bits = page->mOccupancy[word];
+            while (bits)
+            {
+                uint32_t bit = 0;
+                while (!(bits >> bit & 1ull)) ++bit;
+                bits &= bits - 1;
+                uint32_t index = word * 64 + bit;
+                fn(*reinterpret_cast<T*>(SlotToPayload(page->mSlots + index * SLOT_SIZE)));
+            }
+        }
+    }
+}
+
+template <class T, uint32_t BlocksPerPage>
+bool PoolAllocator<T, BlocksPerPage>::Owns(const void* ptr) const
+{
+    return FindPage(ptr) != nullptr;
+}
+
+// print every block still alive, returns the number of leaked blocks.
+template <class T, uint32_t BlocksPerPage>
+uint64_t PoolAllocator<T, BlocksPerPage>::ReportLeaks(const char* poolName) const
+{
+    if (!mNumAllocated) return 0;
+    WARN("blocks of the pool are still alive.\n");
+    DEBUG_PRINT("[ LEAK | %s ] %llu block(s) of %llu bytes still alive:\n", poolName,
+        static_cast<unsigned long long>(mNumAllocated), static_cast<unsigned long long>(sizeof(T)));
+    for (uint32_t pageIndex = 0; pageIndex < mPages.size(); ++pageIndex)
+    {
+        Page* page = mPages[pageIndex];
+        for (uint32_t i = 0; i < BlocksPerPage; ++i)
+        {
+            if (!IsOccupied(page, i)) continue;
+            DEBUG_PRINT("    page %u, block %u at %p\n", pageIndex, i, SlotToPayload(page->mSlots + i * SLOT_SIZE));
+        }
+    }
+    return mNumAllocated;
+}
+
+// destroy all live objects and give every page back to the system.
+template <class T, uint32_t BlocksPerPage>
+void PoolAllocator<T, BlocksPerPage>::Release()
+{
+    if constexpr (!std::is_trivially_destructible_v<T>)
+    {
+        ForEach([](T& object) { object.~T(); });
+    }
+    for (Page* page : mPages)
+    {
+        ::operator delete(page, std::align_val_t(alignof(Page)));
+        MEM_TRACK_FREE(mTag, sizeof(Page));
+    }
+    mPages.clear();
+    mFreeList = nullptr;
+    mNumAllocated = 0;
+}
+
+template <class T, uint32_t BlocksPerPage>
+uint64_t PoolAllocator<T, BlocksPerPage>::GetAllocatedCount() const
+{
+    return mNumAllocated;
+}
+
+template <class T, uint32_t BlocksPerPage>
+uint64_t PoolAllocator<T, BlocksPerPage>::GetCapacity() const
+{
+    return static_cast<uint64_t>(mPages.size()) * BlocksPerPage;
+}
+
+template <class T, uint32_t BlocksPerPage>
+uint32_t PoolAllocator<T, BlocksPerPage>::GetPageCount() const
+{
+    return static_cast<uint32_t>(mPages.size());
+}
+
+template <class T, uint32_t BlocksPerPage>
+PoolAllocator<T, BlocksPerPage>::~PoolAllocator()
+{
+#ifdef POOL_ALLOCATOR_CANARY
+    ReportLeaks(typeid(T).name());
+#endif
+    Release();
+}
+
+template <class T, uint32_t BlocksPerPage>
+void PoolAllocator<T, BlocksPerPage>::AppendPage()
+{
+    // pages are small, the 64KB granularity of the virtual allocations would waste most of it
+    Page* page = static_cast<Page*>(::operator new(sizeof(Page), std::align_val_t(alignof(Page)), std::nothrow));
+    ASSERT(page, TEXT("failed to allocate pool page.\n"));
+    MEM_TRACK_ALLOC(mTag, sizeof(Page));
+    page->mNumAllocated = 0;
+    memset(page->mOccupancy, 0, sizeof(page->mOccupancy));
+
+    // link slots in address order so consecutive allocations are contiguous
+    for (uint32_t i = BlocksPerPage; i-- > 0;)
+    {
+        uint8_t* slot = page->mSlots + i * SLOT_SIZE;
+#ifdef POOL_ALLOCATOR_CANARY
+        uint32_t canary = CANARY_VALUE;
+        // right before and after the payload, the first byte written out of bounds lands on one
+        memcpy(slot + CANARY_SIZE - sizeof(uint32_t), &canary, sizeof(uint32_t));
+        memcpy(slot + CANARY_SIZE + PAYLOAD_SIZE, &canary, sizeof(uint32_t));
+#endif
+        FreeNode* node = reinterpret_cast<FreeNode*>(SlotToPayload(slot));
+        node->mNext = mFreeList;
+        mFreeList = node;
+    }
+    mPages.insert(std::upper_bound(mPages.begin(), mPages.end(), page, std::less<Page*>()), page);
+}
+
+template <class T, uint32_t BlocksPerPage>
+typename PoolAllocator<T, BlocksPerPage>::Page* PoolAllocator<T, BlocksPerPage>::FindPage(const void* payload) const
+{
+    const uint8_t* address = static_cast<const uint8_t*>(payload);
+    // the last page starting at or before the address is the only one that can contain it
+    auto next = std::upper_bound(mPages.begin(), mPages.end(), address,
+        [](const uint8_t* value, const Page* page) { return std::less<const void*>()(value, page); });
+    if (next == mPages.begin()) return nullptr;
+    Page* page = *(next - 1);
+    return address >= page->mSlots && address < page->mSlots + sizeof(page->mSlots) ? page : nullptr;
+}
+
+template <class T, uint32_t BlocksPerPage>
+uint8_t* PoolAllocator<T, BlocksPerPage>::SlotToPayload(uint8_t* slot)
+{
+    return slot + CANARY_SIZE;
+}
+
+template <class T, uint32_t BlocksPerPage>
+uint8_t* PoolAllocator<T, BlocksPerPage>::PayloadToSlot(uint8_t* payload)
+{
+    return payload - CANARY_SIZE;
+}
+
+template <class T, uint32_t BlocksPerPage>
+bool PoolAllocator<T, BlocksPerPage>::IsOccupied(const Page* page, uint32_t index)
+{
+    return page->mOccupancy[index >> 6] >> (index & 63) & 1ull;
+}
+
+template <class T, uint32_t BlocksPerPage>
+void PoolAllocator<T, BlocksPerPage>::SetOccupied(Page* page, uint32_t index, bool occupied)
+{
+    if (occupied) page->mOccupancy[index >> 6] |= 1ull << (index & 63);
+    else page->mOccupancy[index >> 6] &= ~(1ull << (index & 63));
+}
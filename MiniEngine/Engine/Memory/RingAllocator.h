@@ -2,14 +2,19 @@
 
 #include "Engine/pch.h"
 #include "Engine/common/helper.h"
+#include "Engine/common/Exception.h"
+#include "MemoryTracker.h"
 
 class UnsafeRingAllocator : NonCopyable
 {
 public:
-    void Initialize(uint64_t size = 1024ull)
+    // unitSize: bytes represented by one unit of offset, used for memory tracking only.
+    void Initialize(uint64_t size = 1024ull, MemoryTag tag = MemoryTag::RENDER, uint64_t unitSize = 1)
     {
         mTotalSize = size;
         mTail = 0;
+        mUnitSize = unitSize;
+        mTag = tag;
     }
 
     uint64_t Allocate(uint64_t size)
@@ -20,11 +25,11 @@ public:
 
         if (mTail + size <= mTotalSize) {
             uint64_t offset = mTail;
-            mTail += size;
+            SetTail(mTail + size);
             return offset;
         }
         uint64_t offset = 0;
-        mTail = size;
+        SetTail(size);
         return offset;
     }
 
@@ -41,18 +46,18 @@ public:
         // 如果对齐后 + size 超出总大小，则从头开始
         if (alignedOffset + size > mTotalSize) {
             alignedOffset = 0;
-            mTail = alignedOffset + size;
+            SetTail(alignedOffset + size);
             return alignedOffset;
         }
 
         // 正常分配
-        mTail = alignedOffset + size;
+        SetTail(alignedOffset + size);
         return alignedOffset;
     }
 
     void Reset()
     {
-        mTail = 0;
+        SetTail(0);
     }
 
     uint64_t GetTotalSize() const { return mTotalSize; }
@@ -61,19 +66,32 @@ public:
     UnsafeRingAllocator() = default;
 
 private:
+    // the ring never frees explicitly, the tracked size is the distance from the start to the tail.
+    void SetTail(uint64_t tail)
+    {
+        if (tail > mTail) MEM_TRACK_ALLOC(mTag, (tail - mTail) * mUnitSize);
+        else if (tail < mTail) MEM_TRACK_FREE(mTag, (mTail - tail) * mUnitSize);
+        mTail = tail;
+    }
+
     uint64_t mTotalSize; // 环形缓冲区总大小
     uint64_t mTail;      // 下一个分配位置
+    uint64_t mUnitSize;
+    MemoryTag mTag;
 };
 
 class RingAllocator : NonCopyable
 {
 public:
-    void Initialize(uint64_t size = 1024ull)
+    // unitSize: bytes represented by one unit of offset, used for memory tracking only.
+    void Initialize(uint64_t size = 1024ull, MemoryTag tag = MemoryTag::RENDER, uint64_t unitSize = 1)
     {
         mTotalSize = size;
         mHead = 0;
         mTail = 0;
         mOccupiedSize = 0;
+        mUnitSize = unitSize;
+        mTag = tag;
     }
 
     // AllocateAligned from tail
@@ -88,6 +106,7 @@ public:
         uint64_t offset = mTail;
         mTail = (mTail + size) % mTotalSize;
         mOccupiedSize += size;
+        MEM_TRACK_ALLOC(mTag, size * mUnitSize);
         return offset; // return the offset
     }
 
@@ -112,6 +131,7 @@ public:
             uint64_t offset = alignedTail;
             mTail = (mTail + totalRequired) % mTotalSize;
             mOccupiedSize += totalRequired;
+            MEM_TRACK_ALLOC(mTag, totalRequired * mUnitSize);
             return offset;
         }
 
@@ -126,6 +146,7 @@ public:
         uint64_t offset = alignedTail;
         mTail = totalRequired; // after wrap
         mOccupiedSize += totalRequired;
+        MEM_TRACK_ALLOC(mTag, totalRequired * mUnitSize);
         return offset;
     }
 
@@ -136,10 +157,12 @@ public:
 
         mHead = (mHead + size) % mTotalSize;
         mOccupiedSize -= size;
+        MEM_TRACK_FREE(mTag, size * mUnitSize);
     }
 
     void Reset()
     {
+        MEM_TRACK_FREE(mTag, mOccupiedSize * mUnitSize);
         mHead = 0;
         mTail = 0;
         mOccupiedSize = 0;
@@ -157,4 +180,6 @@ private:
     uint64_t mOccupiedSize = 0;
     uint64_t mHead = 0;
     uint64_t mTail = 0;
+    uint64_t mUnitSize = 1;
+    MemoryTag mTag = MemoryTag::RENDER;
 };
\ No newline at end of file
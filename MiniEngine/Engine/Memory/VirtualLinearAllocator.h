@@ -0,0 +1,144 @@
+#pragma once
+#include "Engine/common/Exception.h"
+#include "Engine/common/helper.h"
+#include "Engine/pch.h"
+#include "MemoryTracker.h"
+
+// Linear allocator over a reserved virtual address range.
+// Initialize only reserves address space, physical pages are committed on demand in
+// `commitGranularity` steps while the allocator grows, at least a page of the system at a time. Data never moves, so the base
+// address and every pointer returned by Resolve stay valid until Release.
+class VirtualLinearAllocator : NonCopyable
+{
+public:
+    void Initialize(uint64_t reserveSize = 256ull * 1024 * 1024, uint64_t commitGranularity = 64ull * 1024,
+                    uint64_t initialCommitSize = 0, MemoryTag tag = MemoryTag::UNTAGGED);
+    // returns the offset from the base address, MAXUINT64 if the reserved range is exhausted.
+    uint64_t Allocate(uint64_t size, uint64_t alignment = 8);
+    void* AllocatePtr(uint64_t size, uint64_t alignment = 8);
+    template<typename T>
+    T* Resolve(uint64_t offset) const;
+    // rewind to the beginning, committed pages are kept unless `decommit` is set.
+    void Reset(bool decommit = false);
+    void Release();
+
+    uint8_t* GetBase() const { return mBase; }
+    uint64_t GetUsedSize() const { return mOccupiedSize; }
+    uint64_t GetCommittedSize() const { return mCommittedSize; }
+    uint64_t GetReservedSize() const { return mReservedSize; }
+
+    VirtualLinearAllocator();
+    VirtualLinearAllocator(VirtualLinearAllocator&& other) noexcept;
+    ~VirtualLinearAllocator();
+
+    VirtualLinearAllocator& operator=(VirtualLinearAllocator&& other) noexcept;
+
+private:
+    bool Commit(uint64_t requiredSize);
+
+    uint8_t* mBase = nullptr;
+    uint64_t mReservedSize = 0;
+    uint64_t mCommittedSize = 0;
+    uint64_t mOccupiedSize = 0;
+    uint64_t mCommitGranularity = 0;
+    MemoryTag mTag = MemoryTag::UNTAGGED;
+};
+
+inline void VirtualLinearAllocator::Initialize(uint64_t reserveSize, uint64_t commitGranularity, uint64_t initialCommitSize, MemoryTag tag)
+{
+    if (mBase) return;
+    ASSERT(commitGranularity && (commitGranularity & (commitGranularity - 1)) == 0, TEXT("commit granularity must be power of two"));
+
+    // commits below a page would change the protection of unaligned addresses
+    mCommitGranularity = std::max(commitGranularity, MEM_VIRTUAL_PAGE_SIZE());
+    mReservedSize = (reserveSize + mCommitGranularity - 1) & ~(mCommitGranularity - 1);
+    mTag = tag;
+    mBase = static_cast<uint8_t*>(MEM_VIRTUAL_RESERVE(mReservedSize));
+    if (!mBase) throw std::bad_alloc();
+
+    mCommittedSize = 0;
+    mOccupiedSize = 0;
+    if (initialCommitSize && !Commit(initialCommitSize)) throw std::bad_alloc();
+}
+
+inline uint64_t VirtualLinearAllocator::Allocate(uint64_t size, uint64_t alignment)
+{
+    ASSERT((alignment & (alignment - 1)) == 0, TEXT("alignment must be power of two"));
+    const uint64_t offset = (mOccupiedSize + alignment - 1) & ~(alignment - 1);
+    const uint64_t end = offset + size;
+    if (end > mCommittedSize && !Commit(end)) return MAXUINT64;
+    mOccupiedSize = end;
+    return offset;
+}
+
+inline void* VirtualLinearAllocator::AllocatePtr(uint64_t size, uint64_t alignment)
+{
+    const uint64_t offset = Allocate(size, alignment);
+    return offset == MAXUINT64 ? nullptr : mBase + offset;
+}
+
+template <typename T>
+T* VirtualLinearAllocator::Resolve(uint64_t offset) const
+{
+    ASSERT(offset < mOccupiedSize, TEXT("violate memory access"));
+    return reinterpret_cast<T*>(mBase + offset);
+}
+
+inline void VirtualLinearAllocator::Reset(bool decommit)
+{
+    mOccupiedSize = 0;
+    if (decommit && mCommittedSize)
+    {
+        MEM_VIRTUAL_DECOMMIT(mBase, mCommittedSize);
+        MEM_TRACK_FREE(mTag, mCommittedSize);
+        mCommittedSize = 0;
+    }
+}
+
+inline void VirtualLinearAllocator::Release()
+{
+    if (!mBase) return;
+    MEM_VIRTUAL_RELEASE(mBase, mReservedSize);
+    MEM_TRACK_FREE(mTag, mCommittedSize);
+    mBase = nullptr;
+    mReservedSize = 0;
+    mCommittedSize = 0;
+    mOccupiedSize = 0;
+}
+
+inline VirtualLinearAllocator::VirtualLinearAllocator() = default;
+
+inline VirtualLinearAllocator::VirtualLinearAllocator(VirtualLinearAllocator&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+inline VirtualLinearAllocator::~VirtualLinearAllocator()
+{
+    Release();
+}
+
+inline VirtualLinearAllocator& VirtualLinearAllocator::operator=(VirtualLinearAllocator&& other) noexcept
+{
+    if (&other != this)
+    {
+        std::swap(mBase, other.mBase);
+        std::swap(mReservedSize, other.mReservedSize);
+        std::swap(mCommittedSize, other.mCommittedSize);
+        std::swap(mOccupiedSize, other.mOccupiedSize);
+        std::swap(mCommitGranularity, other.mCommitGranularity);
+        std::swap(mTag, other.mTag);
+    }
+    return *this;
+}
+
+// commit pages so that at least `requiredSize` bytes from the base are accessible.
+inline bool VirtualLinearAllocator::Commit(uint64_t requiredSize)
+{
+    if (requiredSize > mReservedSize) return false;
+    const uint64_t newCommittedSize = std::min(mReservedSize, (requiredSize + mCommitGranularity - 1) & ~(mCommitGranularity - 1));
+    if (!MEM_VIRTUAL_COMMIT(mBase + mCommittedSize, newCommittedSize - mCommittedSize)) return false;
+    MEM_TRACK_ALLOC(mTag, newCommittedSize - mCommittedSize);
+    mCommittedSize = newCommittedSize;
+    return true;
+}
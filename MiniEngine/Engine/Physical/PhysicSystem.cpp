@@ -4,6 +4,8 @@
 #include <algorithm>
 
 #include "Engine/Component/GameObject.h"
+#include "Engine/Utility/Profiler/Profiler.h"
+#include "Engine/Utility/Telemetry/Telemetry.h"
 #include "Shape/SphereShape.h"
 
 PhysicSystem& PhysicSystem::getInstance()
@@ -14,9 +16,18 @@ PhysicSystem& PhysicSystem::getInstance()
 
 void PhysicSystem::update(float fixedDeltaTime)
 {
-    updateRigidBodies(fixedDeltaTime);
-    collisionUpdate();
-    triggerCollisionCallbacks();
+    {
+        PROFILE_SCOPE("PhysicSystem::updateRigidBodies");
+        updateRigidBodies(fixedDeltaTime);
+    }
+    {
+        PROFILE_SCOPE("PhysicSystem::collisionUpdate");
+        collisionUpdate();
+    }
+    {
+        PROFILE_SCOPE("PhysicSystem::triggerCollisionCallbacks");
+        triggerCollisionCallbacks();
+    }
 }
 
 void PhysicSystem::updateRigidBodies(float fixedDeltaTime) const
@@ -94,6 +105,7 @@ void PhysicSystem::updateRigidBodies(float fixedDeltaTime) const
 void PhysicSystem::collisionUpdate()
 {
     collisionPairs.clear();
+    int64_t pairsTested = 0;
     for (size_t i = 0; i < rigidBodies.size(); ++i) {
         RigidBody* a = rigidBodies[i];
         if (!a->getGameObject()->isActive())
@@ -107,6 +119,7 @@ void PhysicSystem::collisionUpdate()
             if (a->getInvMass() <= 0.0f && b->getInvMass() <= 0.0f) continue;
 
             if (a->getShape<BaseShape>() && b->getShape<BaseShape>()) {
+                ++pairsTested;
                 // 使用AABB进行宽相位碰撞检测
                 Vector3 aMin, aMax, bMin, bMax;
                 a->getShape<BaseShape>()->getAABB(a->getTransform()->getWorldPosition(), aMin, aMax);
@@ -126,6 +139,8 @@ void PhysicSystem::collisionUpdate()
             }
         }
     }
+    TELEMETRY_COUNT(RIGID_BODIES_TESTED, pairsTested);
+    TELEMETRY_COUNT(COLLISION_PAIRS, collisionPairs.size());
 }
 
 void PhysicSystem::addRigidBody(RigidBody* body)
@@ -1,17 +1,20 @@
 #pragma once
 #include "Engine/pch.h"
+#include "Engine/Memory/MemoryTracker.h"
+
 class Blob
 {
 public:
     void Reserve(uint64_t size);
     void CopyFrom(const void* pData, uint64_t size) const;
+    void CopyFrom(const void* pData, uint64_t offset, uint64_t size) const;
     const byte* Binary() const;
     uint64_t Size() const;
     void Release();
     Blob();
-    Blob(const void* binary, size_t size);
-    Blob(size_t size);
-    Blob(std::unique_ptr<char[]> binary, size_t size);
+    Blob(const void* binary, size_t size, MemoryTag tag = MemoryTag::ASSETS);
+    Blob(size_t size, MemoryTag tag = MemoryTag::ASSETS);
+    Blob(std::unique_ptr<char[]> binary, size_t size, MemoryTag tag = MemoryTag::ASSETS);
     Blob(Blob&& other) noexcept;
     ~Blob();
 
@@ -22,6 +25,7 @@ public:
 private:
     byte* mBinary;
     uint64_t mSize;
+    MemoryTag mTag;
 };
 
 inline void Blob::Reserve(uint64_t size)
@@ -31,6 +35,8 @@ inline void Blob::Reserve(uint64_t size)
         byte* newBinary = new byte[size];
         memcpy(newBinary, mBinary, mSize);
         delete[] mBinary;
+        MEM_TRACK_ALLOC(mTag, size);
+        if (mBinary) MEM_TRACK_FREE(mTag, mSize);
         mBinary = newBinary;
         mSize = size;
     }
@@ -41,6 +47,11 @@ inline void Blob::CopyFrom(const void* pData, uint64_t size) const
     memcpy(mBinary, pData, std::min(mSize, size));
 }
 
+inline void Blob::CopyFrom(const void* pData, uint64_t offset, uint64_t size) const
+{
+    if (offset < mSize) memcpy(mBinary + offset, pData, std::min(mSize - offset, size));
+}
+
 inline const byte* Blob::Binary() const
 {
     return mBinary;
@@ -53,22 +64,27 @@ inline uint64_t Blob::Size() const
 
 inline void Blob::Release()
 {
+    if (mBinary) MEM_TRACK_FREE(mTag, mSize);
     mSize = 0;
     delete[] mBinary;
     mBinary = nullptr;
 }
 
-inline Blob::Blob(): mBinary(nullptr), mSize(0)
+inline Blob::Blob(): mBinary(nullptr), mSize(0), mTag(MemoryTag::ASSETS)
 {}
 
-inline Blob::Blob(const void* binary, size_t size): mBinary(size ? new byte[size] : nullptr), mSize(size)
+inline Blob::Blob(const void* binary, size_t size, MemoryTag tag): mBinary(size ? new byte[size] : nullptr), mSize(size), mTag(tag)
 {
     memcpy(mBinary, binary, size);
+    if (mBinary) MEM_TRACK_ALLOC(mTag, mSize);
 }
 
-inline Blob::Blob(size_t size) : mBinary(new byte[size]), mSize(size) { }
+inline Blob::Blob(size_t size, MemoryTag tag) : mBinary(new byte[size]), mSize(size), mTag(tag)
+{
+    MEM_TRACK_ALLOC(mTag, mSize);
+}
 
-inline Blob::Blob(std::unique_ptr<char[]> binary, size_t size)
+inline Blob::Blob(std::unique_ptr<char[]> binary, size_t size, MemoryTag tag) : mTag(tag)
 {
     if (!binary || size == 0)
     {
@@ -78,9 +94,10 @@ inline Blob::Blob(std::unique_ptr<char[]> binary, size_t size)
     }
     mBinary = reinterpret_cast<byte*>(binary.release());
     mSize = size * sizeof(char);
+    MEM_TRACK_ALLOC(mTag, mSize);
 }
 
-inline Blob::Blob(Blob&& other) noexcept : mBinary(other.mBinary), mSize(other.mSize)
+inline Blob::Blob(Blob&& other) noexcept : mBinary(other.mBinary), mSize(other.mSize), mTag(other.mTag)
 {
     other.mBinary = nullptr;
     other.mSize = 0;
@@ -90,8 +107,10 @@ inline Blob& Blob::operator=(Blob&& other) noexcept
 {
     if (this != &other)
     {
+        Release();
         mBinary = other.mBinary;
         mSize = other.mSize;
+        mTag = other.mTag;
     
         other.mBinary = nullptr;
         other.mSize = 0;
@@ -0,0 +1,86 @@
+#pragma once
+#include <cfloat>
+#include <cmath>
+
+#include "Engine/pch.h"
+#include "Engine/math/math.h"
+
+// Axis aligned bounding box stored as center and half extents, negative extents mark an empty box.
+struct BoundingBox
+{
+    float mCenter[3] = {0, 0, 0};
+    float mExtents[3] = {-1, -1, -1};
+
+    bool IsValid() const { return mExtents[0] >= 0; }
+    void Merge(const BoundingBox& other);
+    // bounds of the box after `model`, matrices follow the column vector convention of the renderer.
+    BoundingBox Transform(const Matrix4x4& model) const;
+
+    // `pPositions` points at the first position, consecutive positions are `stride` bytes apart.
+    static BoundingBox FromPoints(const void* pPositions, uint32_t numPoints, uint32_t stride);
+    static BoundingBox FromMinMax(const float min[3], const float max[3]);
+};
+
+inline void BoundingBox::Merge(const BoundingBox& other)
+{
+    if (!other.IsValid()) return;
+    if (!IsValid())
+    {
+        *this = other;
+        return;
+    }
+    float min[3], max[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        min[i] = std::min(mCenter[i] - mExtents[i], other.mCenter[i] - other.mExtents[i]);
+        max[i] = std::max(mCenter[i] + mExtents[i], other.mCenter[i] + other.mExtents[i]);
+    }
+    *this = FromMinMax(min, max);
+}
+
+inline BoundingBox BoundingBox::Transform(const Matrix4x4& model) const
+{
+    if (!IsValid()) return *this;
+    BoundingBox result;
+    for (int row = 0; row < 3; ++row)
+    {
+        result.mCenter[row] = model.m.m[row][3];
+        result.mExtents[row] = 0;
+        for (int column = 0; column < 3; ++column)
+        {
+            result.mCenter[row] += model.m.m[row][column] * mCenter[column];
+            result.mExtents[row] += std::abs(model.m.m[row][column]) * mExtents[column];
+        }
+    }
+    return result;
+}
+
+inline BoundingBox BoundingBox::FromPoints(const void* pPositions, uint32_t numPoints, uint32_t stride)
+{
+    if (!pPositions || !numPoints) return {};
+    const uint8_t* pBytes = static_cast<const uint8_t*>(pPositions);
+    float min[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (uint32_t i = 0; i < numPoints; ++i, pBytes += stride)
+    {
+        float position[3];
+        memcpy(position, pBytes, sizeof(position));
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            min[axis] = std::min(min[axis], position[axis]);
+            max[axis] = std::max(max[axis], position[axis]);
+        }
+    }
+    return FromMinMax(min, max);
+}
+
+inline BoundingBox BoundingBox::FromMinMax(const float min[3], const float max[3])
+{
+    BoundingBox result;
+    for (int i = 0; i < 3; ++i)
+    {
+        result.mCenter[i] = (min[i] + max[i]) * 0.5f;
+        result.mExtents[i] = (max[i] - min[i]) * 0.5f;
+    }
+    return result;
+}
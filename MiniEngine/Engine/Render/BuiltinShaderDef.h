@@ -25,15 +25,21 @@ struct CameraConstants
     Matrix4x4 mProjectionInverse;
 };
 
+// element of the `InstanceBuffer` declared by BEGIN_INSTANCE_DATA in Common.hlsl
 struct InstanceData
 {
     Matrix4x4 mModel;
     Matrix4x4 mModelInverse;
+    Vector4 mColor;
 };
 
-struct alignas(256) TransformConstants
+// `ObjectConstants`(b1) of Common.hlsl, the camera matrices are bound once per pass as `CameraConstants`(b0).
+struct alignas(256) ObjectConstants
 {
     Matrix4x4 mModel;
     Matrix4x4 mModelInverse;
-    CameraConstants mCameraTransforms;
+    // the object space position of a vertex is mPositionOffset + position * mPositionScale, see MeshData::vertexModel.
+    // 0 and 1 for FULL vertices.
+    Vector4 mPositionOffset;
+    Vector4 mPositionScale;
 };
\ No newline at end of file
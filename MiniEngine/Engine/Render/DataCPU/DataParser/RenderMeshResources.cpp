@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <cassert>
+#include <cstddef>
 #include <cmath>
 #include "RenderResources.h"
 #include "../../../Dependencies/tiny_obj/tiny_obj_loader.h"
@@ -179,6 +180,50 @@ bool RenderMeshResource::LoadMesh(std::istream& inputStream)
 	return ret;
 }
 
+bool RenderMeshResource::LoadMeshCache(const std::string& path, uint64_t sourceSize, uint64_t sourceStamp, VertexFormat format)
+{
+	ReleaseMeshCache();
+	if (!mMeshCacheFile.Open(path)) return false;
+	// the mapping is backed by the file, its pages are not tracked as asset memory
+	if (!mMeshCache.Load(mMeshCacheFile.GetData(), mMeshCacheFile.GetSize()) || !mMeshCache.IsUpToDate(sourceSize, sourceStamp, format))
+	{
+		ReleaseMeshCache();
+		return false;
+	}
+	return true;
+}
+
+const std::vector<uint8_t>& RenderMeshResource::ImportMeshCache(uint64_t sourceSize, uint64_t sourceStamp, VertexFormat format,
+	MeshCache::ImportStats* pStats)
+{
+	// the loader emits a vertex per corner, they are welded here
+	MeshCache::ImportedMesh mesh = MeshCache::Import(VerticesCPU.Data, VerticesCPU.GetNumElements(), VerticesCPU.GetStride(),
+		IndicesCPU.Data, IndicesCPU.GetNumElements());
+	const VertexPacking::FullVertexAttributes attributes = { sizeof(MeshVertex), offsetof(MeshVertex, vtxcolor),
+		offsetof(MeshVertex, noraml), offsetof(MeshVertex, uv) };
+	MeshCache::ConvertVertices(mesh, format, attributes);
+	VerticesCPU.Reset();
+	IndicesCPU.Reset();
+	if (pStats) *pStats = mesh.mStats;
+
+	ReleaseMeshCache();
+	mMeshCacheData = MeshCache::Serialize(mesh, sourceSize, sourceStamp);
+	MEM_TRACK_ALLOC(MemoryTag::ASSETS, mMeshCacheData.size());
+	mMeshCache.Load(mMeshCacheData.data(), mMeshCacheData.size());
+	return mMeshCacheData;
+}
+
+void RenderMeshResource::ReleaseMeshCache()
+{
+	mMeshCache.Reset();
+	mMeshCacheFile.Close();
+	if (!mMeshCacheData.empty())
+	{
+		MEM_TRACK_FREE(MemoryTag::ASSETS, mMeshCacheData.size());
+		mMeshCacheData = {};
+	}
+}
+
 bool RenderMeshResource::LoadMesh_Plane(float quadWidth)
 {
 	static const RenderMeshResource::MeshVertex kVertexData[] =
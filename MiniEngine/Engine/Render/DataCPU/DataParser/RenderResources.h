@@ -4,6 +4,9 @@
 #include "../ResourceHandle.h"
 #include "Engine/render/MeshData.h"
 #include "Engine/render/RenderResource.h"
+#include "Engine/render/MeshCache.h"
+#include "Engine/FileManager/MappedFile.h"
+#include "Engine/Memory/MemoryTracker.h"
 
 class MeshCPU;
 class RenderMeshResource
@@ -13,6 +16,16 @@ public:
     bool LoadMesh(std::istream& inputStream);
     bool LoadMesh_Plane(float quadWidth = 1.0f);
     bool LoadMesh_Sphere(float radius, int xdiv, int ydiv, float tx = 0, float ty = 0, float tz = 0);
+    // maps the binary cache of the mesh, false when it is missing, malformed, older than the source or in another format.
+    bool LoadMeshCache(const std::string& path, uint64_t sourceSize, uint64_t sourceStamp, VertexFormat format);
+    // welds and optimizes the vertices read by LoadMesh, converts them into `format` and returns the content of the cache file.
+    // the mesh is served from the imported data afterwards, the loaded vertices are released.
+    const std::vector<uint8_t>& ImportMeshCache(uint64_t sourceSize, uint64_t sourceStamp, VertexFormat format,
+        MeshCache::ImportStats* pStats = nullptr);
+    // drops the cached data once the mesh was uploaded
+    void ReleaseMeshCache();
+    // bytes of the mapped or imported cache, 0 once released
+    size_t GetMeshCacheBytes() const { return mMeshCacheFile.IsOpen() ? mMeshCacheFile.GetSize() : mMeshCacheData.size(); }
 
     struct MeshVertex
     {
@@ -36,6 +49,7 @@ public:
         {
             if (Data)
             {
+                MEM_TRACK_FREE(MemoryTag::ASSETS, AllocBytes);
                 free(Data);
                 Data = nullptr;
                 NumElements = 0;
@@ -46,7 +60,10 @@ public:
         {
             if ((NumElements + 1) * sizeof(ELEMENT_TYPE) >= AllocBytes)
             {
-                AllocBytes += numMoreElements * sizeof(ELEMENT_TYPE);
+                // doubles the buffer, fixed steps copied it once per step on large meshes
+                const size_t growBytes = AllocBytes > numMoreElements * sizeof(ELEMENT_TYPE) ? AllocBytes : numMoreElements * sizeof(ELEMENT_TYPE);
+                MEM_TRACK_ALLOC(MemoryTag::ASSETS, growBytes);
+                AllocBytes += growBytes;
                 Data = (ELEMENT_TYPE*)realloc(Data, AllocBytes);
             }
         }
@@ -55,6 +72,7 @@ public:
         {
             if (numElements * sizeof(ELEMENT_TYPE) > AllocBytes)
             {
+                MEM_TRACK_ALLOC(MemoryTag::ASSETS, numElements * sizeof(ELEMENT_TYPE) - AllocBytes);
                 AllocBytes = numElements * sizeof(ELEMENT_TYPE);
                 Data = (ELEMENT_TYPE*)realloc(Data, AllocBytes);
             }
@@ -66,6 +84,10 @@ public:
 
     MeshBufferCPU<MeshVertex> VerticesCPU;
     MeshBufferCPU<uint32_t> IndicesCPU;
+    // welded mesh, points into mMeshCacheFile or into mMeshCacheData when the import could not be read back from disk
+    MeshCache mMeshCache;
+    MappedFile mMeshCacheFile;
+    std::vector<uint8_t> mMeshCacheData;
     MeshData mMeshDataGpu;
     bool IsDynamicMesh = false;
 };
@@ -22,6 +22,7 @@ class RHIVertexBuffer;
 class RHINativeTexture;
 class RHINativeBuffer;
 class RHISubShader;
+class ShaderCache;
 
 class RHI : NonCopyable
 {
@@ -29,6 +30,9 @@ class RHI : NonCopyable
     friend PlatformRHI& GetRHI();
     
 public:
+    // capacity of the bindless texture table, textures allocated beyond it have no bindless index.
+    static constexpr uint32_t MAX_BINDLESS_TEXTURES = 4096;
+
     using RenderPass = std::function<void(RHICommandList&)>;
     virtual void Initialize();
     virtual std::unique_ptr<RHIShader>      RHICompileShader(const Blob& binary, ShaderType activeShaders, const std::string* path = nullptr) = 0;
@@ -36,7 +40,14 @@ public:
     //virtual std::unique_ptr<RHINativeBuffer>      RHIAllocBuffer(uint64_t size) = 0;
     virtual std::unique_ptr<RHIStagingBuffer> RHIAllocStagingBuffer(uint64_t size) = 0;
     virtual std::unique_ptr<RHIStagingBuffer> RHIAllocStagingTexture(const RHITextureDesc& desc, uint8_t mipmap) = 0;
+    // staging memory read by copy contexts, taken from a ring of its own which is reclaimed by the fences of
+    // RHISyncCopyContext. nullptr while the copies in flight hold the rest of the ring or the upload is larger than it.
+    virtual std::unique_ptr<RHIStagingBuffer> RHIAllocUploadBuffer(uint64_t size) = 0;
+    virtual std::unique_ptr<RHIStagingBuffer> RHIAllocUploadTexture(const RHITextureDesc& desc, uint8_t mipmap) = 0;
     virtual std::unique_ptr<RHIConstantBuffer> RHIAllocConstantBuffer(uint64_t size) = 0;
+    // gpu local constant buffer, it is not cpu visible and has to be updated by copies of a context.
+    virtual std::unique_ptr<RHIStaticConstantBuffer> RHIAllocStaticConstantBuffer(uint64_t size) = 0;
+    // the texture is added to the bindless texture table, see RHINativeTexture::GetBindlessIndex.
     virtual std::unique_ptr<RHINativeTexture>     RHIAllocTexture(RHITextureDesc desc) = 0;
     virtual std::unique_ptr<RHIDepthStencil> RHIAllocDepthStencil(RHITextureDesc desc) = 0;
     virtual std::unique_ptr<RHIRenderTarget> RHIAllocRenderTarget(RHITextureDesc desc) = 0;
@@ -59,10 +70,22 @@ public:
     virtual void RHISubmitRenderCommands(RHIGraphicsContext* pContext) = 0;
     virtual void RHISyncGraphicContext(RHIFence* pFence, uint64_t semaphore) = 0;
     virtual void RHISubmitCopyCommands(RHICopyContext* pContext) = 0;
-    virtual void RHISyncCopyContext(RHIFence* pFence, uint64_t semaphore) const = 0;
+    // the upload buffers allocated so far are in use until `pFence` reaches `semaphore`.
+    virtual void RHISyncCopyContext(RHIFence* pFence, uint64_t semaphore) = 0;
     virtual void RHIBatchCopyCommands(RHICopyContext** pContexts, uint32_t numContexts) = 0;
     virtual void RHIReleaseGraphicsContext(RHIGraphicsContext* pContext) = 0;
     virtual void RHIReleaseCopyContext(RHICopyContext* pContext) = 0;
+
+    // pipeline states recorded by an earlier session and the compiled pipelines of the driver, either may be empty.
+    // false when the list is malformed or outdated, a library the driver rejects is replaced by an empty one.
+    virtual bool RHILoadPipelineStates(const void* pList, uint64_t listSize, const void* pLibrary, uint64_t librarySize) = 0;
+    // creates the recorded pipeline states using `pShader` before a draw needs them, returns how many were created.
+    virtual uint32_t RHIPrewarmPipelineStates(const RHIShader* pShader) = 0;
+    // the pipeline states created so far and the compiled pipelines, for RHILoadPipelineStates of the next session.
+    virtual void RHISavePipelineStates(std::vector<uint8_t>& list, std::vector<uint8_t>& library) = 0;
+    // persistent views of the buffers bindless shaders index with RHIGraphicsContext::SetDrawIndices, elements of
+    // `stride` bytes. Called once, the buffers have to outlive the rhi's use of them.
+    virtual void RHISetBindlessConstantTables(RHIStaticConstantBuffer* pObjects, RHIStaticConstantBuffer* pMaterials, uint32_t stride) = 0;
     
     // virtual void BeginFrame(RHIFrameResource* pFrameResource) = 0;
     // virtual void EndFrame() = 0;
@@ -71,8 +94,12 @@ public:
     virtual void Release() = 0;
     virtual ~RHI();
 
+    // compiled stages found in the cache skip the runtime compiler, the cache has to outlive the RHI.
+    void RHISetShaderCache(const ShaderCache* pCache) { mShaderCache = pCache; }
+
 protected:
     bool mIsInitialized = false;
+    const ShaderCache* mShaderCache = nullptr;
 };
 
 inline void RHI::Initialize()
@@ -0,0 +1,282 @@
+#include "ForwardRecorder.h"
+
+#include "Engine/common/helper.h"
+#include "Engine/Utility/Telemetry/Telemetry.h"
+
+void ForwardRecorder::Initialize(RHI* pRHI, const ObjectConstantPool* pObjectConstants, const MaterialConstantPool* pMaterialConstants)
+{
+    mRHI = pRHI;
+    mObjectConstantPool = pObjectConstants;
+    mMaterialConstantPool = pMaterialConstants;
+}
+
+uint64_t ForwardRecorder::SortKey(const RenderItem& renderItem, uint32_t index, const CameraConstants& cameraConstants,
+    PipelineInitializer& scratchPSO)
+{
+    const MaterialInstance& material = *renderItem.mMaterial;
+    if (!material.DepthTest().mEnableDepthTest) return RenderSortKey::Overlay(index);
+
+    ConfigureForwardPipeline(scratchPSO, material, renderItem.mDepthPrePassed, renderItem.mMeshData.mInputLayout);
+    // view space depth of the object origin
+    const float* viewDepthRow = cameraConstants.mView.m.m[2];
+    const auto& model = renderItem.mModel.m.m;
+    const float viewDepth = viewDepthRow[0] * model[0][3] + viewDepthRow[1] * model[1][3] + viewDepthRow[2] * model[2][3] + viewDepthRow[3];
+    const void* pMesh = renderItem.mMeshData.mVertexBuffer.Get();
+    return material.BlendMode().mEnableBlend ?
+        RenderSortKey::Transparent(scratchPSO.Hash(), MaterialSortId(material), pMesh, viewDepth) :
+        RenderSortKey::Opaque(scratchPSO.Hash(), MaterialSortId(material), pMesh, viewDepth);
+}
+
+void ForwardRecorder::Record(RHIGraphicsContext* pRenderContext, VirtualLinearAllocator& arena, const PipelineInitializer& opaquePSO,
+    const std::vector<RenderItem>& renderItems, const SortedRenderItem* pBegin, const SortedRenderItem* pEnd,
+    const CameraConstants& cameraConstants) const
+{
+    // every recording thread configures its own copy of the pipeline state
+    PipelineInitializer itemPSO = opaquePSO;
+    PipelineInitializer scratchPSO = opaquePSO;
+    BindCameraConstants(pRenderContext, cameraConstants);
+    // the tables of bindless materials stay bound for the whole context, their draws only set two root constants.
+    pRenderContext->SetBindlessTables();
+
+    // the items arrive grouped by pipeline, material and mesh, only the state that differs from the previous item is bound.
+    // a material reuses the descriptor table of the previous item, which keeps its constants and textures.
+    bool hasPipelineState = false;
+    uint64_t lastPipelineState = 0;
+    const MaterialInstance* pLastMaterial = nullptr;
+    const RHIVertexBuffer* pLastVertexBuffer = nullptr;
+    const RHIIndexBuffer* pLastIndexBuffer = nullptr;
+    uint32_t numPipelineChanges = 0;
+    uint32_t numMaterialChanges = 0;
+    const size_t numItems = pEnd - pBegin;
+    for (size_t begin = 0; begin < numItems;)
+    {
+        const RenderItem& renderItem = renderItems[pBegin[begin].mIndex];
+        const MaterialInstance& materialInstance = *renderItem.mMaterial;
+
+        // set pipeline states
+        ConfigureForwardPipeline(itemPSO, materialInstance, renderItem.mDepthPrePassed, renderItem.mMeshData.mInputLayout);
+        const uint64_t pipelineState = itemPSO.Hash();
+        if (!hasPipelineState || pipelineState != lastPipelineState)
+        {
+            pRenderContext->SetPipelineState(itemPSO);
+            hasPipelineState = true;
+            lastPipelineState = pipelineState;
+            ++numPipelineChanges;
+        }
+
+        // neighbours sharing pipeline, mesh and textures with an instanced material join its draw.
+        size_t end = begin + 1;
+        if (materialInstance.InstancingEnabled())
+        {
+            while (end < numItems && end - begin < MAX_INSTANCES_PER_DRAW &&
+                CanShareInstancedDraw(renderItem, renderItems[pBegin[end].mIndex], pipelineState, scratchPSO))
+            {
+                ++end;
+            }
+        }
+        const uint32_t numInstances = static_cast<uint32_t>(end - begin);
+
+        // bind constants(uniforms), the object and material constants were uploaded by beginFrame.
+        if (materialInstance.InstancingEnabled())
+        {
+            // the instance buffer lives in the descriptor table, every instanced draw needs its own table.
+            // material constants and textures come from the first item, instanced shaders read per object values
+            // from the instances and need no object constants.
+            InstanceData* instances = static_cast<InstanceData*>(arena.AllocatePtr(sizeof(InstanceData) * numInstances, alignof(InstanceData)));
+            for (uint32_t i = 0; i < numInstances; ++i)
+            {
+                const RenderItem& instance = renderItems[pBegin[begin + i].mIndex];
+                instances[i] = { instance.mMeshData.vertexModel(instance.mModel), instance.mModelInverse, instance.mColor };
+            }
+            if (materialInstance.BindlessEnabled())
+            {
+                if (materialInstance.BindlessIndex() == MaterialInstance::INVALID_OFFSET)
+                {
+                    begin = end;
+                    continue;
+                }
+                pRenderContext->SetDrawIndices(ObjectConstantPool::INVALID_SLOT, materialInstance.BindlessIndex());
+            }
+            pRenderContext->BeginBinding();
+            BindMaterial(pRenderContext, materialInstance);
+            pRenderContext->SetStructuredBuffer(materialInstance.InstanceBufferSlot(), instances, sizeof(InstanceData), numInstances);
+            pRenderContext->EndBindings();
+            pLastMaterial = nullptr;
+            ++numMaterialChanges;
+        }
+        else if (materialInstance.BindlessEnabled())
+        {
+            // a full pool leaves the item without a table element, it cannot be drawn.
+            if (renderItem.mObjectSlot == ObjectConstantPool::INVALID_SLOT || materialInstance.BindlessIndex() == MaterialInstance::INVALID_OFFSET)
+            {
+                begin = end;
+                continue;
+            }
+            pRenderContext->SetDrawIndices(renderItem.mObjectSlot, materialInstance.BindlessIndex());
+            if (&materialInstance != pLastMaterial)
+            {
+                pLastMaterial = &materialInstance;
+                ++numMaterialChanges;
+            }
+        }
+        else
+        {
+            BindObjectConstants(pRenderContext, renderItem);
+            if (&materialInstance != pLastMaterial)
+            {
+                pRenderContext->BeginBinding();
+                BindMaterial(pRenderContext, materialInstance);
+                pRenderContext->EndBindings();
+                pLastMaterial = &materialInstance;
+                ++numMaterialChanges;
+            }
+        }
+
+        // bind vertex buffers and index buffer.
+        // the colors of a mesh belong to its vertices, they change together.
+        RHIVertexBuffer* vertexBuffers[] = { renderItem.mMeshData.mVertexBuffer.Get(), renderItem.mMeshData.mColorBuffer.Get() };
+        if (vertexBuffers[0] != pLastVertexBuffer)
+        {
+            pRenderContext->SetVertexBuffers(vertexBuffers, vertexBuffers[1] ? 2 : 1);
+            pLastVertexBuffer = vertexBuffers[0];
+        }
+        if (renderItem.mMeshData.mIndexBuffer.Get() != pLastIndexBuffer)
+        {
+            pRenderContext->SetIndexBuffer(renderItem.mMeshData.mIndexBuffer.Get());
+            pLastIndexBuffer = renderItem.mMeshData.mIndexBuffer.Get();
+        }
+
+        // append draw call
+        const SubMesh* subMeshes = renderItem.mMeshData.mSubMeshes.get();
+        uint32_t numSubMeshes = renderItem.mMeshData.mSubMeshCount;
+        for (uint32_t i = 0; i < numSubMeshes; ++i)
+        {
+            pRenderContext->DrawIndexedInstanced(subMeshes[i].mIndexNum, subMeshes[i].mStartIndex, subMeshes[i].mBaseVertex, numInstances, 0);
+        }
+        TELEMETRY_COUNT(DRAW_CALLS, numSubMeshes);
+        begin = end;
+    }
+    TELEMETRY_COUNT(PIPELINE_STATE_CHANGES, numPipelineChanges);
+    TELEMETRY_COUNT(MATERIAL_CHANGES, numMaterialChanges);
+}
+
+void ForwardRecorder::BindCameraConstants(RHIGraphicsContext* pRenderContext, const CameraConstants& cameraConstants) const
+{
+    std::unique_ptr<RHIConstantBuffer> cbuffer = pRenderContext->AllocConstantBuffer(sizeof(CameraConstants));
+    mRHI->RHIUpdateConstantBuffer(cbuffer.get(), &cameraConstants, 0, sizeof(CameraConstants));
+    pRenderContext->SetConstantBuffer(0, cbuffer.get());
+    TELEMETRY_COUNT(CONSTANT_BUFFER_ALLOCATIONS, 1);
+    TELEMETRY_COUNT(CONSTANT_BYTES_UPLOADED, sizeof(CameraConstants));
+}
+
+void ForwardRecorder::BindObjectConstants(RHIGraphicsContext* pRenderContext, const RenderItem& renderItem) const
+{
+    if (renderItem.mObjectSlot != ObjectConstantPool::INVALID_SLOT)
+    {
+        // uploaded in beginFrame
+        pRenderContext->SetStaticConstantBuffer(1, mObjectConstantPool->GetBuffer(), ObjectConstantPool::GetOffset(renderItem.mObjectSlot),
+            sizeof(ObjectConstants));
+        return;
+    }
+    ObjectConstants objectConstants{ renderItem.mMeshData.vertexModel(renderItem.mModel), renderItem.mModelInverse,
+        renderItem.mMeshData.positionOffset(), renderItem.mMeshData.positionScale() };
+    std::unique_ptr<RHIConstantBuffer> cbuffer = pRenderContext->AllocConstantBuffer(sizeof(ObjectConstants));
+    mRHI->RHIUpdateConstantBuffer(cbuffer.get(), &objectConstants, 0, sizeof(ObjectConstants));
+    pRenderContext->SetConstantBuffer(1, cbuffer.get());
+    TELEMETRY_COUNT(CONSTANT_BUFFER_ALLOCATIONS, 1);
+    TELEMETRY_COUNT(CONSTANT_BYTES_UPLOADED, sizeof(ObjectConstants));
+}
+
+void ForwardRecorder::BindMaterial(RHIGraphicsContext* pRenderContext, const MaterialInstance& materialInstance) const
+{
+    uint8_t numConstants = materialInstance.NumConstantBuffers();
+    for (uint8_t i = 0; i < numConstants; ++i)
+    {
+        // read through the material table
+        if (i == materialInstance.mMaterial->mMaterialTableIndex) continue;
+        const Blob& constants = materialInstance.GetConstantBuffer(i);
+        const uint32_t offset = materialInstance.GetConstantOffset(i);
+        if (offset != MaterialInstance::INVALID_OFFSET)
+        {
+            // uploaded in beginFrame
+            pRenderContext->SetStaticConstantBuffer(2 + i, mMaterialConstantPool->GetBuffer(), offset, constants.Size());
+            continue;
+        }
+        std::unique_ptr<RHIConstantBuffer> cbuffer = pRenderContext->AllocConstantBuffer(constants.Size());
+        mRHI->RHIUpdateConstantBuffer(cbuffer.get(), constants.Binary(), 0, constants.Size());
+        pRenderContext->SetConstantBuffer(2 + i, cbuffer.get());
+        TELEMETRY_COUNT(CONSTANT_BUFFER_ALLOCATIONS, 1);
+        TELEMETRY_COUNT(CONSTANT_BYTES_UPLOADED, constants.Size());
+    }
+
+    // bind textures.
+    uint8_t numTextures = materialInstance.NumTextures();
+    for (uint8_t i = 0; i < numTextures; ++i)
+    {
+        RHINativeTexture* pTexture = materialInstance.GetTexture(i).Get();
+        if (!pTexture) continue;
+        pRenderContext->SetTexture(materialInstance.GetTextureSlot(i), pTexture);
+    }
+}
+
+void ForwardRecorder::ConfigureForwardPipeline(PipelineInitializer& initializer, const MaterialInstance& material, bool depthPrePassed,
+    InputLayout inputLayout)
+{
+    initializer.SetInputLayout(inputLayout);
+    initializer.SetCullMode(material.GetCullMode());
+    initializer.SetDrawMode(material.GetDrawMode());
+    if (depthPrePassed)
+    {
+        // only the nearest surface is shaded, the depth buffer already holds it. less equal rather than equal keeps the
+        // surface when the two shaders round its depth differently.
+        DepthTestDesc depthTest = material.DepthTest();
+        depthTest.mCompareFunction = CompareFunction::LESS_EQUAL;
+        depthTest.mDepthOperation = DepthOperation::READ_ONLY;
+        initializer.SetDepthTest(depthTest);
+    }
+    else
+    {
+        initializer.SetDepthTest(material.DepthTest());
+    }
+    initializer.SetStencilTest(material.StencilTest());
+    initializer.SetBlend(false, false, material.BlendMode());
+    initializer.SetShader(material.GetShader());
+}
+
+uint64_t ForwardRecorder::MaterialSortId(const MaterialInstance& material)
+{
+    // bindless materials need no binding of their own, they are only kept apart by their pipeline.
+    if (material.BindlessEnabled() && !material.InstancingEnabled()) return reinterpret_cast<uint64_t>(material.GetShader());
+    if (!material.InstancingEnabled()) return material.GetMaterialInstanceId();
+    // instanced materials are grouped by what an instanced draw shares, the instance id would keep them apart.
+    uint64_t id = reinterpret_cast<uint64_t>(material.GetShader());
+    for (uint8_t i = 0; i < material.NumTextures(); ++i)
+    {
+        id = MurmurHash(id, reinterpret_cast<uint64_t>(material.GetTexture(i).Get()));
+    }
+    return MurmurHash(id, 0);
+}
+
+bool ForwardRecorder::CanShareInstancedDraw(const RenderItem& first, const RenderItem& other, uint64_t pipelineState,
+    PipelineInitializer& scratchPSO)
+{
+    const MaterialInstance& material = *first.mMaterial;
+    const MaterialInstance& otherMaterial = *other.mMaterial;
+    if (!otherMaterial.InstancingEnabled() || first.mDepthPrePassed != other.mDepthPrePassed) return false;
+    if (first.mMeshData.mVertexBuffer.Get() != other.mMeshData.mVertexBuffer.Get() ||
+        first.mMeshData.mIndexBuffer.Get() != other.mMeshData.mIndexBuffer.Get() ||
+        first.mMeshData.mSubMeshCount != other.mMeshData.mSubMeshCount) return false;
+    // every render item owns a copy of the sub meshes
+    if (memcmp(first.mMeshData.mSubMeshes.get(), other.mMeshData.mSubMeshes.get(), sizeof(SubMesh) * first.mMeshData.mSubMeshCount) != 0) return false;
+    if (&material != &otherMaterial)
+    {
+        if (material.GetShader() != otherMaterial.GetShader()) return false;
+        for (uint8_t i = 0; i < material.NumTextures(); ++i)
+        {
+            if (material.GetTexture(i).Get() != otherMaterial.GetTexture(i).Get()) return false;
+        }
+        ConfigureForwardPipeline(scratchPSO, otherMaterial, other.mDepthPrePassed, other.mMeshData.mInputLayout);
+        if (scratchPSO.Hash() != pipelineState) return false;
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "DynamicRHI.h"
+#include "Material.h"
+#include "MaterialConstantPool.h"
+#include "ObjectConstantPool.h"
+#include "RenderItem.h"
+#include "RenderSort.h"
+#include "RHIPipelineStateInializer.h"
+#include "Engine/Memory/VirtualLinearAllocator.h"
+
+// Records the sorted render items of the forward opaque pass into a graphics context. Only the state which differs
+// from the previous item is bound, and neighbours sharing an instanced material are merged into one draw.
+// The renderer owns one, it only needs the rhi and the constant pools and records on the null rhi as well.
+class ForwardRecorder
+{
+public:
+    // bounded by the 64KB frame allocations backing the instance buffer
+    static constexpr uint32_t MAX_INSTANCES_PER_DRAW = 256;
+
+    void Initialize(RHI* pRHI, const ObjectConstantPool* pObjectConstants, const MaterialConstantPool* pMaterialConstants);
+
+    // sort key of the `index`-th item of the list, `scratchPSO` is configured for the item.
+    static uint64_t SortKey(const RenderItem& renderItem, uint32_t index, const CameraConstants& cameraConstants,
+        PipelineInitializer& scratchPSO);
+    // records [pBegin, pEnd) of the sorted items with pipelines derived from `opaquePSO`. safe to run on several threads
+    // with distinct contexts and arenas, the instance buffers are allocated from `arena`.
+    void Record(RHIGraphicsContext* pRenderContext, VirtualLinearAllocator& arena, const PipelineInitializer& opaquePSO,
+        const std::vector<RenderItem>& renderItems, const SortedRenderItem* pBegin, const SortedRenderItem* pEnd,
+        const CameraConstants& cameraConstants) const;
+
+    void BindCameraConstants(RHIGraphicsContext* pRenderContext, const CameraConstants& cameraConstants) const;
+    void BindObjectConstants(RHIGraphicsContext* pRenderContext, const RenderItem& renderItem) const;
+    // binds the material constants and the material textures into the current descriptor table.
+    void BindMaterial(RHIGraphicsContext* pRenderContext, const MaterialInstance& materialInstance) const;
+
+    // items drawn into the depth pre-pass only pass the depth test where they wrote it and skip the depth writes.
+    static void ConfigureForwardPipeline(PipelineInitializer& initializer, const MaterialInstance& material, bool depthPrePassed,
+        InputLayout inputLayout);
+    // instance id of the material, or the shader and textures for materials that are drawn instanced.
+    static uint64_t MaterialSortId(const MaterialInstance& material);
+    static bool CanShareInstancedDraw(const RenderItem& first, const RenderItem& other, uint64_t pipelineState,
+        PipelineInitializer& scratchPSO);
+
+private:
+    RHI* mRHI = nullptr;
+    const ObjectConstantPool* mObjectConstantPool = nullptr;
+    const MaterialConstantPool* mMaterialConstantPool = nullptr;
+};
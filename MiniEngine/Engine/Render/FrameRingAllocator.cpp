@@ -0,0 +1,125 @@
+#include "FrameRingAllocator.h"
+#include "RHIObject.h"
+
+#include "Engine/common/Exception.h"
+
+void FrameRingAllocator::Initialize(uint64_t size, MemoryTag tag, uint64_t unitSize)
+{
+    ASSERT(size > 0, TEXT("ring must not be empty."));
+    mSize = size;
+    mUnitSize = unitSize;
+    mTag = tag;
+    mHead = 0;
+    mTail = 0;
+    mTrackedHead = 0;
+    mFrames.clear();
+}
+
+FrameRingAllocator::~FrameRingAllocator()
+{
+    Release(mHead.load());
+}
+
+uint64_t FrameRingAllocator::Allocate(uint64_t size)
+{
+    ASSERT(size > 0 && size <= mSize, TEXT("invalid allocation size."));
+    uint64_t position = mHead.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        // ranges do not wrap, the rest of the ring is skipped and reclaimed with the frame
+        const uint64_t offset = position % mSize;
+        const uint64_t start = offset + size > mSize ? position + (mSize - offset) : position;
+        const uint64_t end = start + size;
+        // the skipped rest holds nothing once the ring is empty, a large range would never fit otherwise
+        const uint64_t tail = mTail.load(std::memory_order_acquire);
+        if (end - tail > mSize && tail != position) return INVALID_OFFSET;
+        if (mHead.compare_exchange_weak(position, end, std::memory_order_relaxed)) return start % mSize;
+    }
+}
+
+uint64_t FrameRingAllocator::AllocateOrWait(uint64_t size)
+{
+    for (;;)
+    {
+        const uint64_t offset = Allocate(size);
+        if (offset != INVALID_OFFSET) return offset;
+
+        std::lock_guard<std::mutex> lock(mFrameMutex);
+        // another thread may have released a frame meanwhile
+        if (ReleaseCompletedFrames()) continue;
+        if (mFrames.empty()) return INVALID_OFFSET;
+        ++mNumStalls;
+        const Frame& oldest = mFrames.front();
+        oldest.mFence->Wait(oldest.mSemaphore);
+        Release(oldest.mHead);
+        mFrames.pop_front();
+    }
+}
+
+void FrameRingAllocator::EndFrame(const RHIFence* pFence, uint64_t semaphore)
+{
+    std::lock_guard<std::mutex> lock(mFrameMutex);
+    const uint64_t head = mHead.load(std::memory_order_relaxed);
+    if (head != mTrackedHead)
+    {
+        MEM_TRACK_ALLOC(mTag, (head - mTrackedHead) * mUnitSize);
+        mTrackedHead = head;
+    }
+    // frames without allocations release nothing
+    if (!mFrames.empty() && mFrames.back().mHead == head) mFrames.pop_back();
+    mFrames.push_back({ pFence, semaphore, head });
+}
+
+uint64_t FrameRingAllocator::Reclaim()
+{
+    std::lock_guard<std::mutex> lock(mFrameMutex);
+    return ReleaseCompletedFrames();
+}
+
+uint64_t FrameRingAllocator::ReleaseCompletedFrames()
+{
+    // the queue finishes the frames in submission order
+    const uint64_t tail = mTail.load(std::memory_order_relaxed);
+    while (!mFrames.empty() && mFrames.front().mFence->GetValue() >= mFrames.front().mSemaphore)
+    {
+        Release(mFrames.front().mHead);
+        mFrames.pop_front();
+    }
+    return mTail.load(std::memory_order_relaxed) - tail;
+}
+
+void FrameRingAllocator::Release(uint64_t head)
+{
+    const uint64_t tail = mTail.load(std::memory_order_relaxed);
+    if (head <= tail) return;
+    // only the allocations tagged by EndFrame were tracked
+    const uint64_t tracked = std::min(head, mTrackedHead);
+    if (tracked > tail) MEM_TRACK_FREE(mTag, (tracked - tail) * mUnitSize);
+    mTail.store(head, std::memory_order_release);
+}
+
+void FrameRingCache::Initialize(FrameRingAllocator* pRing, uint32_t batchSize)
+{
+    ASSERT(pRing && batchSize > 0 && batchSize <= pRing->GetTotalSize(), TEXT("invalid descriptor cache."));
+    mRing = pRing;
+    mBatchSize = batchSize;
+    mBegin = mEnd = 0;
+    mNumRefills = 0;
+}
+
+uint64_t FrameRingCache::Allocate(uint32_t size)
+{
+    if (mEnd - mBegin < size)
+    {
+        if (size >= mBatchSize) return mRing->AllocateOrWait(size);
+        // the rest of the batch is left unused
+        const uint64_t offset = mRing->AllocateOrWait(mBatchSize);
+        if (offset == FrameRingAllocator::INVALID_OFFSET) return offset;
+        mBegin = offset;
+        mEnd = offset + mBatchSize;
+        ++mNumRefills;
+    }
+    const uint64_t offset = mBegin;
+    mBegin += size;
+    return offset;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include "Engine/common/helper.h"
+#include "Engine/Memory/MemoryTracker.h"
+
+#include <deque>
+
+class RHIFence;
+
+// Ring of transient allocations shared by all recording threads, reclaimed a frame at a time.
+// Allocations bump an atomic head and never wrap inside a range, so they take no lock. EndFrame tags everything
+// allocated so far with the fence of the frame, Reclaim moves the tail past the frames the gpu has finished.
+// Offsets are in units of the owner, e.g. descriptors of a heap.
+class FrameRingAllocator : NonCopyable
+{
+public:
+    static constexpr uint64_t INVALID_OFFSET = ~0ull;
+
+    // unitSize: bytes represented by one unit of offset, used for memory tracking only.
+    void Initialize(uint64_t size, MemoryTag tag = MemoryTag::RENDER, uint64_t unitSize = 1);
+    // contiguous range of `size` units, INVALID_OFFSET when the frames in flight hold the rest of the ring.
+    uint64_t Allocate(uint64_t size);
+    // like Allocate, but waits for the oldest frame in flight while the ring is full.
+    // INVALID_OFFSET when the current frame alone fills the ring.
+    uint64_t AllocateOrWait(uint64_t size);
+    // the allocations made so far are in use until `pFence` reaches `semaphore`. called once the frame is submitted,
+    // after all threads recording it are done.
+    void EndFrame(const RHIFence* pFence, uint64_t semaphore);
+    // releases the frames whose fence was reached, returns the number of released units.
+    uint64_t Reclaim();
+
+    uint64_t GetTotalSize() const { return mSize; }
+    uint64_t GetUsedSize() const { return mHead.load(std::memory_order_relaxed) - mTail.load(std::memory_order_relaxed); }
+    // allocations which had to wait for the gpu, the ring is too small for the frames in flight when this grows.
+    uint32_t GetNumStalls() const { return mNumStalls.load(std::memory_order_relaxed); }
+
+    FrameRingAllocator() = default;
+    ~FrameRingAllocator();
+
+private:
+    struct Frame
+    {
+        const RHIFence* mFence;
+        uint64_t mSemaphore;
+        uint64_t mHead;
+    };
+
+    // expects mFrameMutex to be held.
+    uint64_t ReleaseCompletedFrames();
+    void Release(uint64_t head);
+
+    uint64_t mSize = 0;
+    uint64_t mUnitSize = 1;
+    MemoryTag mTag = MemoryTag::RENDER;
+    // positions grow monotonically, the offset of a position is position % mSize.
+    std::atomic<uint64_t> mHead{ 0 };
+    std::atomic<uint64_t> mTail{ 0 };
+    std::atomic<uint32_t> mNumStalls{ 0 };
+    // guards the frames, taken once per frame and by full rings rather than per allocation.
+    std::mutex mFrameMutex;
+    std::deque<Frame> mFrames;
+    uint64_t mTrackedHead = 0;
+};
+
+// Front of a FrameRingAllocator owned by one recording thread. Takes batches of the ring with a single atomic operation
+// and hands out ranges of the batch without touching shared state.
+class FrameRingCache
+{
+public:
+    void Initialize(FrameRingAllocator* pRing, uint32_t batchSize);
+    // contiguous range of the ring, ranges of a batch size and above are allocated from the ring directly.
+    uint64_t Allocate(uint32_t size);
+    // drops the rest of the batch, which is reclaimed with the frame it was taken in. call before recording a new frame.
+    void Reset() { mBegin = mEnd = 0; }
+    uint32_t GetNumRefills() const { return mNumRefills; }
+
+private:
+    FrameRingAllocator* mRing = nullptr;
+    uint64_t mBegin = 0;
+    uint64_t mEnd = 0;
+    uint32_t mBatchSize = 0;
+    uint32_t mNumRefills = 0;
+};
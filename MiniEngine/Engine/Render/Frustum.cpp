@@ -0,0 +1,142 @@
+#include "Frustum.h"
+
+#include "Engine/common/helper.h"
+
+#ifdef FRUSTUM_CULLING_SSE
+#include <emmintrin.h>
+#endif
+
+uint32_t CullingBatch::Add(const BoundingBox& box)
+{
+    uint32_t index = mSize++;
+    uint32_t capacity = AlignUpToMul<uint32_t, 4>()(mSize);
+    if (mCenterX.size() < capacity)
+    {
+        // padding boxes have an infinite negative extent and never pass a plane test
+        for (auto* pArray : {&mCenterX, &mCenterY, &mCenterZ}) pArray->resize(capacity, 0);
+        for (auto* pArray : {&mExtentX, &mExtentY, &mExtentZ}) pArray->resize(capacity, -FLT_MAX);
+    }
+    mCenterX[index] = box.mCenter[0];
+    mCenterY[index] = box.mCenter[1];
+    mCenterZ[index] = box.mCenter[2];
+    mExtentX[index] = box.mExtents[0];
+    mExtentY[index] = box.mExtents[1];
+    mExtentZ[index] = box.mExtents[2];
+    return index;
+}
+
+void CullingBatch::Clear()
+{
+    // keep the capacity, only restore the padding values of the slots that were used
+    uint32_t used = AlignUpToMul<uint32_t, 4>()(mSize);
+    for (auto* pArray : {&mCenterX, &mCenterY, &mCenterZ}) std::fill_n(pArray->begin(), used, 0.0f);
+    for (auto* pArray : {&mExtentX, &mExtentY, &mExtentZ}) std::fill_n(pArray->begin(), used, -FLT_MAX);
+    mSize = 0;
+}
+
+Frustum Frustum::FromViewProjection(const Matrix4x4& viewProjection)
+{
+    const auto& m = viewProjection.m.m;
+    Frustum frustum;
+    for (int i = 0; i < 4; ++i)
+    {
+        frustum.mPlanes[0][i] = m[3][i] + m[0][i];
+        frustum.mPlanes[1][i] = m[3][i] - m[0][i];
+        frustum.mPlanes[2][i] = m[3][i] + m[1][i];
+        frustum.mPlanes[3][i] = m[3][i] - m[1][i];
+        frustum.mPlanes[4][i] = m[2][i];
+        frustum.mPlanes[5][i] = m[3][i] - m[2][i];
+    }
+    for (auto& plane : frustum.mPlanes)
+    {
+        float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (length <= 0) continue;
+        for (float& value : plane) value /= length;
+    }
+    return frustum;
+}
+
+bool Frustum::Intersects(const BoundingBox& box) const
+{
+    if (!box.IsValid()) return false;
+    for (const auto& plane : mPlanes)
+    {
+        float distance = plane[0] * box.mCenter[0] + plane[1] * box.mCenter[1] + plane[2] * box.mCenter[2] + plane[3];
+        float radius = std::abs(plane[0]) * box.mExtents[0] + std::abs(plane[1]) * box.mExtents[1] + std::abs(plane[2]) * box.mExtents[2];
+        if (distance + radius < 0) return false;
+    }
+    return true;
+}
+
+FrustumTest Frustum::Classify(const BoundingBox& box) const
+{
+    if (!box.IsValid()) return FrustumTest::OUTSIDE;
+    FrustumTest result = FrustumTest::INSIDE;
+    for (const auto& plane : mPlanes)
+    {
+        float distance = plane[0] * box.mCenter[0] + plane[1] * box.mCenter[1] + plane[2] * box.mCenter[2] + plane[3];
+        float radius = std::abs(plane[0]) * box.mExtents[0] + std::abs(plane[1]) * box.mExtents[1] + std::abs(plane[2]) * box.mExtents[2];
+        if (distance + radius < 0) return FrustumTest::OUTSIDE;
+        if (distance - radius < 0) result = FrustumTest::INTERSECTS;
+    }
+    return result;
+}
+
+uint32_t Frustum::Cull(const CullingBatch& batch, uint8_t* pVisible) const
+{
+    uint32_t numVisible = 0;
+#ifdef FRUSTUM_CULLING_SSE
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 planes[6][4];
+    for (int i = 0; i < 6; ++i)
+        for (int j = 0; j < 4; ++j)
+            planes[i][j] = _mm_set1_ps(mPlanes[i][j]);
+    __m128 absNormals[6][3];
+    for (int i = 0; i < 6; ++i)
+        for (int j = 0; j < 3; ++j)
+            absNormals[i][j] = _mm_and_ps(planes[i][j], absMask);
+
+    for (uint32_t base = 0; base < batch.mSize; base += 4)
+    {
+        __m128 centerX = _mm_loadu_ps(&batch.mCenterX[base]);
+        __m128 centerY = _mm_loadu_ps(&batch.mCenterY[base]);
+        __m128 centerZ = _mm_loadu_ps(&batch.mCenterZ[base]);
+        __m128 extentX = _mm_loadu_ps(&batch.mExtentX[base]);
+        __m128 extentY = _mm_loadu_ps(&batch.mExtentY[base]);
+        __m128 extentZ = _mm_loadu_ps(&batch.mExtentZ[base]);
+        // a box is outside as soon as (distance + projected radius) is negative for one plane
+        __m128 outside = _mm_setzero_ps();
+        for (int i = 0; i < 6; ++i)
+        {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planes[i][0], centerX), _mm_mul_ps(planes[i][1], centerY)),
+                                         _mm_add_ps(_mm_mul_ps(planes[i][2], centerZ), planes[i][3]));
+            __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absNormals[i][0], extentX), _mm_mul_ps(absNormals[i][1], extentY)),
+                                       _mm_mul_ps(absNormals[i][2], extentZ));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+        }
+        int outsideMask = _mm_movemask_ps(outside);
+        uint32_t count = std::min(4u, batch.mSize - base);
+        for (uint32_t lane = 0; lane < count; ++lane)
+        {
+            // invalid boxes have negative extents and are caught by the extent test
+            bool visible = !(outsideMask & (1 << lane)) && batch.mExtentX[base + lane] >= 0;
+            pVisible[base + lane] = visible;
+            numVisible += visible;
+        }
+    }
+#else
+    for (uint32_t i = 0; i < batch.mSize; ++i)
+    {
+        BoundingBox box;
+        box.mCenter[0] = batch.mCenterX[i];
+        box.mCenter[1] = batch.mCenterY[i];
+        box.mCenter[2] = batch.mCenterZ[i];
+        box.mExtents[0] = batch.mExtentX[i];
+        box.mExtents[1] = batch.mExtentY[i];
+        box.mExtents[2] = batch.mExtentZ[i];
+        pVisible[i] = Intersects(box);
+        numVisible += pVisible[i];
+    }
+#endif
+    return numVisible;
+}
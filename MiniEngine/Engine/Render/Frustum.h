@@ -0,0 +1,47 @@
+#pragma once
+#include "BoundingBox.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define FRUSTUM_CULLING_SSE
+#endif
+
+// Bounding boxes in structure of arrays layout, padded so the culling loop can always consume four boxes at once.
+class CullingBatch
+{
+public:
+    // returns the index of the box inside the batch.
+    uint32_t Add(const BoundingBox& box);
+    void Clear();
+    uint32_t Size() const { return mSize; }
+
+private:
+    friend class Frustum;
+
+    std::vector<float> mCenterX, mCenterY, mCenterZ;
+    std::vector<float> mExtentX, mExtentY, mExtentZ;
+    uint32_t mSize = 0;
+};
+
+enum class FrustumTest : uint8_t
+{
+    OUTSIDE,
+    INTERSECTS,
+    INSIDE
+};
+
+class Frustum
+{
+public:
+    // Gribb-Hartmann plane extraction from a column vector view-projection matrix with a [0, 1] clip depth.
+    static Frustum FromViewProjection(const Matrix4x4& viewProjection);
+
+    bool Intersects(const BoundingBox& box) const;
+    // like Intersects, but also reports boxes that are completely inside so their contents can skip further tests.
+    FrustumTest Classify(const BoundingBox& box) const;
+    // writes 1 to `pVisible[i]` for every box intersecting the frustum and 0 otherwise, returns the visible count.
+    uint32_t Cull(const CullingBatch& batch, uint8_t* pVisible) const;
+
+private:
+    // normalized planes (a, b, c, d) pointing inwards: left, right, bottom, top, near, far
+    float mPlanes[6][4];
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include "RHIDescriptors.h"
+
+#include <iterator>
+
+// Vertex layouts a pipeline state reads its vertex buffers with.
+// INFERRED builds the layout from the inputs of the vertex shader, every input packed after the previous one in slot 0,
+// the other layouts describe the vertex formats of imported meshes, see VertexFormat.
+enum class InputLayout : uint8_t
+{
+    INFERRED,
+    // float3 position, float3 color, float3 normal, float2 uv
+    FULL,
+    // unorm16x4 position, snorm16x2 octahedral normal, half2 uv, unorm8x4 color in slot 1
+    COMPACT,
+    // the positions of COMPACT copied to their own buffer for the depth pre-pass
+    COMPACT_POSITION,
+    COUNT
+};
+
+struct InputElement
+{
+    const char* mSemanticName;
+    uint8_t mSemanticIndex;
+    uint8_t mInputSlot;
+    uint16_t mOffset;
+    Format mFormat;
+};
+
+struct InputLayoutDesc
+{
+    const InputElement* mElements;
+    uint32_t mNumElements;
+};
+
+// empty for INFERRED. inputs of the shader missing from the layout are not supported by the rhis.
+inline InputLayoutDesc GetInputLayoutDesc(InputLayout layout)
+{
+    static const InputElement fullElements[] = {
+        { "POSITION", 0, 0, 0, Format::R32G32B32_FLOAT },
+        { "COLOR", 0, 0, 12, Format::R32G32B32_FLOAT },
+        { "NORMAL", 0, 0, 24, Format::R32G32B32_FLOAT },
+        { "TEXCOORD", 0, 0, 36, Format::R32G32_FLOAT },
+    };
+    static const InputElement compactElements[] = {
+        { "POSITION", 0, 0, 0, Format::R16G16B16A16_UNORM },
+        { "NORMAL", 0, 0, 8, Format::R16G16_SNORM },
+        { "TEXCOORD", 0, 0, 12, Format::R16G16_FLOAT },
+        { "COLOR", 0, 1, 0, Format::R8G8B8A8_UNORM },
+    };
+    static const InputElement compactPositionElements[] = {
+        { "POSITION", 0, 0, 0, Format::R16G16B16A16_UNORM },
+    };
+
+    switch (layout)
+    {
+    case InputLayout::FULL: return { fullElements, static_cast<uint32_t>(std::size(fullElements)) };
+    case InputLayout::COMPACT: return { compactElements, static_cast<uint32_t>(std::size(compactElements)) };
+    case InputLayout::COMPACT_POSITION: return { compactPositionElements, static_cast<uint32_t>(std::size(compactPositionElements)) };
+    default: return { nullptr, 0 };
+    }
+}
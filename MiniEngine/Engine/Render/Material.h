@@ -1,7 +1,9 @@
 #pragma once
+#include "MaterialConstantPool.h"
 #include "RHIDescriptors.h"
 #include "RenderResource.h"
 #include "Shader.h"
+#include "Engine/common/Exception.h"
 
 
 struct ConstantProperty
@@ -30,6 +32,14 @@ struct TextureProperty
     TextureDimension mDimension;
 };
 
+// a variable of one of the material constant buffers, looked up by MaterialInstance::PropertyId of its name.
+struct ConstantVariable
+{
+    uint8_t mConstantBuffer;    // index into Material::mConstants
+    uint32_t mOffset;
+    uint32_t mSize;
+};
+
 struct SamplerProperty  // TODO: complete SamplerProperty
 {
 	
@@ -42,9 +52,16 @@ struct Material
     std::unique_ptr<ConstantProperty[]> mConstants = nullptr;
     std::unique_ptr<TextureProperty[]> mTextures = nullptr;
     std::unique_ptr<SamplerProperty[]> mSamplers = nullptr;
+    // offsets of the constant buffer variables, computed once from the shader reflection.
+    std::unordered_map<uint64_t, ConstantVariable> mVariables;
     uint8_t mNumConstants = 0;
     uint8_t mNumTextures = 0;
     uint8_t mNumSamplers = 0;
+    // texture slot of the `InstanceBuffer` structured buffer, shaders declaring it are drawn instanced.
+    uint8_t mInstanceBufferSlot = UINT8_MAX;
+    // constant buffer holding the element of the `MaterialTable` structured buffer, shaders declaring it are bindless.
+    // they read their constants and textures from the tables and are drawn without descriptor tables.
+    uint8_t mMaterialTableIndex = UINT8_MAX;
 
     // bool mEnableAlphaClip = false;
     // CullMode mCullMode = CullMode::BACK;
@@ -57,7 +74,12 @@ struct Material
 class MaterialInstance
 {
     friend class Renderer;
+    friend class ForwardRecorder;
 public:
+    static constexpr uint32_t INVALID_OFFSET = ~0u;
+
+    // id of the constant variable `name`, a compile time constant for literals.
+    static constexpr uint64_t PropertyId(const char* name);
     void InstantiateFrom(const Material* pMaterial);
     void SetMaterialInstanceId(uint64_t id);
     uint64_t GetMaterialInstanceId() const;
@@ -69,12 +91,33 @@ public:
     void SetTexture(uint32_t index, TextureDimension dimension, TextureRef texture);
     void SetTexture(uint32_t index, TextureRef texture);
     TextureRef GetTexture(uint32_t index) const;
+    uint8_t GetTextureSlot(uint32_t index) const;
     const Blob& GetConstantBuffer(uint32_t index) const;
     void UpdateConstantBuffer(uint32_t index, void* pData, uint32_t size);
+    // writes one variable of the material constants, only its bytes are uploaded when they changed.
+    // false when the shader has no such variable.
+    bool SetConstant(uint64_t id, const void* pData, uint32_t size);
+    template <typename T>
+    bool SetConstant(uint64_t id, const T& value) { return SetConstant(id, &value, sizeof(T)); }
+    // writes the bindless index of the texture into the uint variable `id` of the material table and keeps the texture alive.
+    // false when the shader has no such variable or the texture is not in the bindless table.
+    bool SetBindlessTexture(uint64_t id, TextureRef texture);
     uint8_t NumTextures() const;
     uint8_t NumConstantBuffers() const;
+    bool InstancingEnabled() const;
+    uint8_t InstanceBufferSlot() const;
+    bool BindlessEnabled() const;
+    // element of the material table, INVALID_OFFSET until the constants are uploaded to the pool.
+    uint32_t BindlessIndex() const;
+    // queues the bytes of the constants written since the last upload into `pool`, their ranges are allocated by the
+    // first call and freed with the instance. buffers which do not fit stay at INVALID_OFFSET and are bound from frame memory.
+    void UploadConstants(MaterialConstantPool& pool);
+    uint32_t GetConstantOffset(uint32_t index) const;
 
     bool AlphaClipEnabled() const;
+    // large opaque occluders of the material are drawn into the depth pre-pass and shaded without writing depth again,
+    // the vertex shader has to compute the position with ObjectToClip like the pre-depth shader. see Renderer::depthPrePass.
+    bool DepthPrePassEnabled() const;
     DrawMode GetDrawMode() const;
     CullMode GetCullMode() const;
     const DepthTestDesc& DepthTest() const;
@@ -86,6 +129,11 @@ public:
         mEnableAlphaClip = m_enable_alpha_clip;
     }
 
+    void SetEnableDepthPrePass(bool enableDepthPrePass)
+    {
+        mEnableDepthPrePass = enableDepthPrePass;
+    }
+
     void SetDrawMode(DrawMode m_draw_mode)
     {
         mDrawMode = m_draw_mode;
@@ -112,18 +160,34 @@ public:
     }
 
     MaterialInstance() = default;
+    ~MaterialInstance();
     
 private:
+    // bytes of a constant buffer written since its last upload, empty when mBegin >= mEnd.
+    struct DirtyRange
+    {
+        uint32_t mBegin;
+        uint32_t mEnd;
+    };
+
+    // copies the bytes of [offset, offset + size) which differ from `pData` and extends the dirty range over them.
+    void WriteConstants(uint32_t index, uint32_t offset, const void* pData, uint32_t size);
+
     const Material* mMaterial = nullptr;
     uint64_t mInstanceId = 0;
     
     std::unique_ptr<Blob[]> mConstants{};
-    std::unique_ptr<ConstantBufferRef[]> mConstantsGPU{};
+    std::unique_ptr<DirtyRange[]> mDirtyRanges{};
+    // offsets of the constant buffers in mConstantPool, INVALID_OFFSET until the first upload.
+    std::unique_ptr<uint32_t[]> mConstantOffsets{};
+    MaterialConstantPool* mConstantPool = nullptr;
     std::unique_ptr<TextureRef[]> mTexGPU{};   // since the CPU rarely changes texture content, we don't cache texture content.
+    std::vector<TextureRef> mBindlessTextures;
     bool mIsDirty = true;
 	// std::unique_ptr<RHISamplerRef[]> mSamplers;   // TODO: implement samplers
 
     bool mEnableAlphaClip = false;
+    bool mEnableDepthPrePass = false;
     DrawMode mDrawMode = DrawMode::SOLID;
     CullMode mCullMode = CullMode::BACK;
     DepthTestDesc mDepthTest = DepthTestDesc::Default();
@@ -135,11 +199,16 @@ inline void MaterialInstance::InstantiateFrom(const Material* pMaterial)
 {
     mMaterial = pMaterial;
     mConstants.reset(new Blob[pMaterial->mNumConstants]);
-    mConstantsGPU.reset(new ConstantBufferRef[pMaterial->mNumConstants]);
+    mDirtyRanges.reset(new DirtyRange[pMaterial->mNumConstants]);
+    mConstantOffsets.reset(new uint32_t[pMaterial->mNumConstants]);
     mTexGPU.reset(new TextureRef[pMaterial->mNumTextures]);
+    mBindlessTextures.clear();
     for (size_t i = 0; i < pMaterial->mNumConstants; ++i)
     {
         mConstants[i].Reserve(pMaterial->mConstants[i].mConstantSize);
+        // the first upload writes the whole buffer
+        mDirtyRanges[i] = { 0, static_cast<uint32_t>(mConstants[i].Size()) };
+        mConstantOffsets[i] = INVALID_OFFSET;
     }
     mIsDirty = true;
 
@@ -151,6 +220,17 @@ inline void MaterialInstance::InstantiateFrom(const Material* pMaterial)
     mBlend = BlendDesc::Disabled(); // pMaterial->mBlend;
 }
 
+constexpr uint64_t MaterialInstance::PropertyId(const char* name)
+{
+    // 64 bit fnv-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (; *name; ++name)
+    {
+        hash = (hash ^ static_cast<uint8_t>(*name)) * 1099511628211ull;
+    }
+    return hash;
+}
+
 inline void MaterialInstance::SetMaterialInstanceId(uint64_t id) { mInstanceId = id; }
 
 inline uint64_t MaterialInstance::GetMaterialInstanceId() const { return mInstanceId; }
@@ -216,6 +296,11 @@ inline TextureRef MaterialInstance::GetTexture(uint32_t index) const
     return mTexGPU[index];
 }
 
+inline uint8_t MaterialInstance::GetTextureSlot(uint32_t index) const
+{
+    return static_cast<uint8_t>(mMaterial->mTextures[index].mRegisterSlot);
+}
+
 inline const Blob& MaterialInstance::GetConstantBuffer(uint32_t index) const
 {
     if (index >= mMaterial->mNumConstants)
@@ -228,8 +313,57 @@ inline const Blob& MaterialInstance::GetConstantBuffer(uint32_t index) const
 inline void MaterialInstance::UpdateConstantBuffer(uint32_t index, void* pData, uint32_t size)
 {
     //  MASSERT(index < mMaterial->mNumConstants, TEXT("index out of range."));
-    Blob& blob = mConstants[index];
-    blob.CopyFrom(pData, size);
+    WriteConstants(index, 0, pData, static_cast<uint32_t>(std::min<uint64_t>(mConstants[index].Size(), size)));
+}
+
+inline bool MaterialInstance::SetConstant(uint64_t id, const void* pData, uint32_t size)
+{
+    const auto itor = mMaterial->mVariables.find(id);
+    if (itor == mMaterial->mVariables.end()) return false;
+    const ConstantVariable& variable = itor->second;
+    WriteConstants(variable.mConstantBuffer, variable.mOffset, pData, std::min(variable.mSize, size));
+    return true;
+}
+
+inline bool MaterialInstance::SetBindlessTexture(uint64_t id, TextureRef texture)
+{
+    const uint32_t index = texture.Get() ? texture->GetBindlessIndex() : RHINativeTexture::INVALID_BINDLESS_INDEX;
+    if (index == RHINativeTexture::INVALID_BINDLESS_INDEX)
+    {
+        WARN("texture is not in the bindless table!");
+        return false;
+    }
+    if (!SetConstant(id, index)) return false;
+    if (std::find(mBindlessTextures.begin(), mBindlessTextures.end(), texture) == mBindlessTextures.end())
+    {
+        mBindlessTextures.push_back(texture);
+    }
+    return true;
+}
+
+inline void MaterialInstance::WriteConstants(uint32_t index, uint32_t offset, const void* pData, uint32_t size)
+{
+    // callers write their constants every frame, only the bytes which changed are uploaded.
+    const Blob& blob = mConstants[index];
+    const byte* pOld = blob.Binary() + offset;
+    const byte* pNew = static_cast<const byte*>(pData);
+    uint32_t begin = 0;
+    while (begin < size && pOld[begin] == pNew[begin]) ++begin;
+    if (begin == size) return;
+    uint32_t end = size;
+    while (pOld[end - 1] == pNew[end - 1]) --end;
+    blob.CopyFrom(pNew + begin, offset + begin, end - begin);
+
+    DirtyRange& range = mDirtyRanges[index];
+    if (range.mBegin >= range.mEnd)
+    {
+        range = { offset + begin, offset + end };
+    }
+    else
+    {
+        range.mBegin = std::min(range.mBegin, offset + begin);
+        range.mEnd = std::max(range.mEnd, offset + end);
+    }
     mIsDirty = true;
 }
 
@@ -243,11 +377,78 @@ inline uint8_t MaterialInstance::NumConstantBuffers() const
     return mMaterial->mNumConstants;
 }
 
+inline bool MaterialInstance::InstancingEnabled() const
+{
+    return mMaterial->mInstanceBufferSlot != UINT8_MAX;
+}
+
+inline uint8_t MaterialInstance::InstanceBufferSlot() const
+{
+    return mMaterial->mInstanceBufferSlot;
+}
+
+inline bool MaterialInstance::BindlessEnabled() const
+{
+    return mMaterial->mMaterialTableIndex != UINT8_MAX;
+}
+
+inline uint32_t MaterialInstance::BindlessIndex() const
+{
+    const uint32_t offset = mConstantOffsets[mMaterial->mMaterialTableIndex];
+    return offset == INVALID_OFFSET ? INVALID_OFFSET : offset / MaterialConstantPool::BLOCK_SIZE;
+}
+
+inline void MaterialInstance::UploadConstants(MaterialConstantPool& pool)
+{
+    if (!mIsDirty) return;
+    ASSERT(!mConstantPool || mConstantPool == &pool, TEXT("material constants belong to another pool"));
+    mConstantPool = &pool;
+    // the copies are ordered after the draws of the frames in flight on the same queue, the ranges are overwritten in place.
+    for (uint8_t i = 0; i < mMaterial->mNumConstants; ++i)
+    {
+        const Blob& constants = mConstants[i];
+        uint32_t& offset = mConstantOffsets[i];
+        DirtyRange& range = mDirtyRanges[i];
+        if (offset == INVALID_OFFSET)
+        {
+            offset = pool.Allocate(static_cast<uint32_t>(constants.Size()));
+            if (offset == MaterialConstantPool::INVALID_OFFSET) continue;
+            range = { 0, static_cast<uint32_t>(constants.Size()) };
+        }
+        if (range.mBegin < range.mEnd)
+        {
+            pool.Update(offset + range.mBegin, constants.Binary() + range.mBegin, range.mEnd - range.mBegin);
+        }
+        range = { 0, 0 };
+    }
+    mIsDirty = false;
+}
+
+inline uint32_t MaterialInstance::GetConstantOffset(uint32_t index) const
+{
+    return mConstantOffsets[index];
+}
+
+inline MaterialInstance::~MaterialInstance()
+{
+    if (!mConstantPool) return;
+    for (uint8_t i = 0; i < mMaterial->mNumConstants; ++i)
+    {
+        if (mConstantOffsets[i] == INVALID_OFFSET) continue;
+        mConstantPool->Free(mConstantOffsets[i], static_cast<uint32_t>(mConstants[i].Size()));
+    }
+}
+
 inline bool MaterialInstance::AlphaClipEnabled() const
 {
     return mEnableAlphaClip;
 }
 
+inline bool MaterialInstance::DepthPrePassEnabled() const
+{
+    return mEnableDepthPrePass;
+}
+
 inline DrawMode MaterialInstance::GetDrawMode() const
 {
     return mDrawMode;
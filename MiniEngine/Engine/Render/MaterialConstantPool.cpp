@@ -0,0 +1,80 @@
+#include "MaterialConstantPool.h"
+
+#include "Engine/common/Exception.h"
+
+void MaterialConstantPool::Initialize(RHI* pRHI, uint32_t numBlocks)
+{
+    mRHI = pRHI;
+    mNumBlocks = numBlocks;
+    mNextBlock = 0;
+    mBuffer = pRHI->RHIAllocStaticConstantBuffer(static_cast<uint64_t>(numBlocks) * BLOCK_SIZE);
+    mShadow.reset(new uint8_t[static_cast<size_t>(numBlocks) * BLOCK_SIZE]{});
+    mDirtyRegions.clear();
+    mFreeRanges.clear();
+}
+
+uint32_t MaterialConstantPool::Allocate(uint32_t size)
+{
+    const uint32_t numBlocks = GetNumBlocks(size);
+    const auto itor = mFreeRanges.find(numBlocks);
+    if (itor != mFreeRanges.end() && !itor->second.empty())
+    {
+        const uint32_t offset = itor->second.back();
+        itor->second.pop_back();
+        return offset;
+    }
+    if (mNextBlock + numBlocks > mNumBlocks) return INVALID_OFFSET;
+    const uint32_t offset = mNextBlock * BLOCK_SIZE;
+    mNextBlock += numBlocks;
+    return offset;
+}
+
+void MaterialConstantPool::Free(uint32_t offset, uint32_t size)
+{
+    ASSERT(offset % BLOCK_SIZE == 0 && offset < mNextBlock * BLOCK_SIZE, TEXT("material constants out of range"));
+    mFreeRanges[GetNumBlocks(size)].push_back(offset);
+}
+
+void MaterialConstantPool::Update(uint32_t offset, const void* pData, uint32_t size)
+{
+    ASSERT(static_cast<uint64_t>(offset) + size <= static_cast<uint64_t>(mNumBlocks) * BLOCK_SIZE, TEXT("material constants out of range"));
+    if (!size) return;
+    memcpy(mShadow.get() + offset, pData, size);
+    mDirtyRegions.push_back({ offset, offset + size });
+}
+
+uint64_t MaterialConstantPool::Flush(RHIGraphicsContext* pContext)
+{
+    if (mDirtyRegions.empty()) return 0;
+    std::sort(mDirtyRegions.begin(), mDirtyRegions.end(), [](const Region& a, const Region& b) { return a.mBegin < b.mBegin; });
+
+    // overlapping and touching regions become one copy
+    size_t numRuns = 0;
+    uint64_t uploadSize = 0;
+    for (size_t i = 1; i < mDirtyRegions.size(); ++i)
+    {
+        Region& run = mDirtyRegions[numRuns];
+        if (mDirtyRegions[i].mBegin <= run.mEnd)
+        {
+            run.mEnd = std::max(run.mEnd, mDirtyRegions[i].mEnd);
+            continue;
+        }
+        uploadSize += run.mEnd - run.mBegin;
+        mDirtyRegions[++numRuns] = mDirtyRegions[i];
+    }
+    uploadSize += mDirtyRegions[numRuns].mEnd - mDirtyRegions[numRuns].mBegin;
+    ++numRuns;
+
+    std::unique_ptr<RHIStagingBuffer> stagingBuffer = mRHI->RHIAllocStagingBuffer(uploadSize);
+    uint64_t stagingOffset = 0;
+    for (size_t i = 0; i < numRuns; ++i)
+    {
+        const Region& run = mDirtyRegions[i];
+        const uint64_t runSize = run.mEnd - run.mBegin;
+        mRHI->RHIUpdateStagingBuffer(stagingBuffer.get(), mShadow.get() + run.mBegin, stagingOffset, runSize);
+        pContext->UpdateBuffer(mBuffer.get(), stagingBuffer.get(), runSize, run.mBegin, stagingOffset);
+        stagingOffset += runSize;
+    }
+    mDirtyRegions.clear();
+    return uploadSize;
+}
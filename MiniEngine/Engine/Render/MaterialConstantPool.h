@@ -0,0 +1,42 @@
+#pragma once
+#include "DynamicRHI.h"
+
+// Persistent material constants. Every constant buffer of a material instance owns a range of one gpu local constant
+// buffer for its lifetime. Instances report the bytes they changed, the changed regions of a frame are coalesced and
+// copied to the gpu through one staging allocation.
+class MaterialConstantPool
+{
+public:
+    static constexpr uint32_t INVALID_OFFSET = ~0u;
+    // placement alignment of constant buffer views
+    static constexpr uint32_t BLOCK_SIZE = 256;
+
+    void Initialize(RHI* pRHI, uint32_t numBlocks);
+    // returns INVALID_OFFSET when the pool is exhausted.
+    uint32_t Allocate(uint32_t size);
+    void Free(uint32_t offset, uint32_t size);
+    // writes the cpu copy of [offset, offset + size) and uploads it in the next Flush.
+    void Update(uint32_t offset, const void* pData, uint32_t size);
+    // records the copies of the changed regions into `pContext`, has to happen before the draws reading them.
+    // returns the number of uploaded bytes.
+    uint64_t Flush(RHIGraphicsContext* pContext);
+
+    RHIStaticConstantBuffer* GetBuffer() const { return mBuffer.get(); }
+    static uint32_t GetNumBlocks(uint32_t size) { return (size + BLOCK_SIZE - 1) / BLOCK_SIZE; }
+
+private:
+    struct Region
+    {
+        uint32_t mBegin;
+        uint32_t mEnd;
+    };
+
+    RHI* mRHI = nullptr;
+    std::unique_ptr<RHIStaticConstantBuffer> mBuffer;
+    std::unique_ptr<uint8_t[]> mShadow;
+    std::vector<Region> mDirtyRegions;
+    // freed ranges by their number of blocks, material constant buffers come in few sizes.
+    std::unordered_map<uint32_t, std::vector<uint32_t>> mFreeRanges;
+    uint32_t mNumBlocks = 0;
+    uint32_t mNextBlock = 0;
+};
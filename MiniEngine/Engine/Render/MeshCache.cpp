@@ -0,0 +1,315 @@
+#include "MeshCache.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr uint32_t ALIGNMENT = 16;
+    constexpr uint32_t INVALID_INDEX = 0xffffffff;
+    // 0xffff is left to the strip cut value
+    constexpr uint32_t MAX_SHORT_VERTICES = 0xffff;
+    // every level of detail aims at this fraction of the triangles of the previous one
+    constexpr float LOD_TRIANGLE_RATIO = 0.5f;
+    // relative to the radius of the bounds, coarser levels would change the silhouette too much
+    constexpr float LOD_MAX_ERROR = 0.05f;
+    // a level keeping more of the indices of the previous one is not worth its memory
+    constexpr float LOD_MIN_REDUCTION = 0.8f;
+
+    uint32_t AlignUp(uint32_t value)
+    {
+        return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    uint64_t HashVertex(const uint8_t* pVertex, uint32_t stride)
+    {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (uint32_t i = 0; i < stride; ++i)
+        {
+            hash = (hash ^ pVertex[i]) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    // the indices of the mesh itself, the coarser levels follow them
+    uint32_t CountMeshIndices(const MeshCache::ImportedMesh& mesh)
+    {
+        uint32_t numIndices = 0;
+        const size_t numRanges = mesh.mSubMeshes.size() / mesh.mNumLods;
+        for (size_t i = 0; i < numRanges; ++i) numIndices += mesh.mSubMeshes[i].mIndexCount;
+        return numIndices;
+    }
+
+    // bytes of a stream with `stride` bytes per vertex a draw of the indices reads, see AnalyzeVertexFetch
+    uint32_t CountFetchBytes(const uint32_t* pIndices, uint32_t numIndices, uint32_t numVertices, uint32_t stride)
+    {
+        std::vector<bool> referenced(numVertices, false);
+        uint32_t numReferenced = 0;
+        for (uint32_t i = 0; i < numIndices; ++i)
+        {
+            if (referenced[pIndices[i]]) continue;
+            referenced[pIndices[i]] = true;
+            ++numReferenced;
+        }
+        const float overfetch = MeshOptimizer::AnalyzeVertexFetch(pIndices, numIndices, numVertices, stride);
+        return static_cast<uint32_t>(std::lround(overfetch * numReferenced * stride));
+    }
+
+    // whether every index of the range addresses one of the vertices once its base vertex is added
+    template<typename Index>
+    bool IsRangeInBounds(const Index* pIndices, const MeshCache::SubMeshRange& range, uint32_t numVertices)
+    {
+        if (range.mIndexCount == 0) return true;
+        const Index* pBegin = pIndices + range.mStartIndex;
+        const auto bounds = std::minmax_element(pBegin, pBegin + range.mIndexCount);
+        return static_cast<int64_t>(*bounds.first) + range.mBaseVertex >= 0 &&
+            static_cast<int64_t>(*bounds.second) + range.mBaseVertex < numVertices;
+    }
+}
+
+MeshCache::ImportedMesh MeshCache::Import(const void* pVertices, uint32_t numVertices, uint32_t stride,
+    const uint32_t* pIndices, uint32_t numIndices, const SubMeshRange* pSubMeshes, uint32_t numSubMeshes)
+{
+    ImportedMesh mesh;
+    mesh.mVertexStride = stride;
+    if (!pIndices) numIndices = numVertices;
+    const uint8_t* pSource = static_cast<const uint8_t*>(pVertices);
+
+    // open addressing over the welded vertices, at most half full
+    uint32_t tableSize = 1;
+    while (tableSize < numVertices * 2) tableSize <<= 1;
+    std::vector<uint32_t> table(tableSize, INVALID_INDEX);
+    // welded index of every source vertex, shared by the indices referencing it
+    std::vector<uint32_t> remap(numVertices, INVALID_INDEX);
+    mesh.mVertices.reserve(static_cast<size_t>(numVertices) * stride);
+    mesh.mIndices.resize(numIndices);
+    for (uint32_t i = 0; i < numIndices; ++i)
+    {
+        const uint32_t source = pIndices ? pIndices[i] : i;
+        uint32_t& welded = remap[source];
+        if (welded == INVALID_INDEX)
+        {
+            const uint8_t* pVertex = pSource + static_cast<size_t>(source) * stride;
+            uint32_t slot = static_cast<uint32_t>(HashVertex(pVertex, stride)) & (tableSize - 1);
+            while (table[slot] != INVALID_INDEX &&
+                memcmp(mesh.mVertices.data() + static_cast<size_t>(table[slot]) * stride, pVertex, stride) != 0)
+            {
+                slot = (slot + 1) & (tableSize - 1);
+            }
+            if (table[slot] == INVALID_INDEX)
+            {
+                table[slot] = mesh.mNumVertices++;
+                mesh.mVertices.insert(mesh.mVertices.end(), pVertex, pVertex + stride);
+            }
+            welded = table[slot];
+        }
+        mesh.mIndices[i] = welded;
+    }
+    mesh.mVertices.shrink_to_fit();
+
+    if (numSubMeshes) mesh.mSubMeshes.assign(pSubMeshes, pSubMeshes + numSubMeshes);
+    else mesh.mSubMeshes.push_back({ numIndices, 0, 0 });
+
+    ImportStats& stats = mesh.mStats;
+    stats.mSourceCache = MeshOptimizer::AnalyzeVertexCache(mesh.mIndices.data(), numIndices, mesh.mNumVertices);
+    stats.mSourceOverfetch = MeshOptimizer::AnalyzeVertexFetch(mesh.mIndices.data(), numIndices, mesh.mNumVertices, stride);
+
+    // the levels of detail are simplified from the mesh itself and appended to its indices
+    const uint32_t numRanges = static_cast<uint32_t>(mesh.mSubMeshes.size());
+    std::vector<uint32_t> simplified;
+    uint32_t previousIndices = numIndices;
+    for (uint32_t lod = 1; lod < MAX_LODS; ++lod)
+    {
+        const float ratio = std::pow(LOD_TRIANGLE_RATIO, static_cast<float>(lod));
+        const uint32_t lodStart = static_cast<uint32_t>(mesh.mIndices.size());
+        float lodError = 0.0f;
+        for (uint32_t i = 0; i < numRanges; ++i)
+        {
+            const SubMeshRange subMesh = mesh.mSubMeshes[i];
+            simplified.resize(subMesh.mIndexCount);
+            float error = 0.0f;
+            const uint32_t count = MeshOptimizer::Simplify(simplified.data(), mesh.mIndices.data() + subMesh.mStartIndex,
+                subMesh.mIndexCount, mesh.mVertices.data(), mesh.mNumVertices, stride,
+                static_cast<uint32_t>(subMesh.mIndexCount * ratio) / 3 * 3, LOD_MAX_ERROR, &error);
+            mesh.mSubMeshes.push_back({ count, static_cast<uint32_t>(mesh.mIndices.size()), subMesh.mBaseVertex });
+            mesh.mIndices.insert(mesh.mIndices.end(), simplified.begin(), simplified.begin() + count);
+            lodError = std::max(lodError, error);
+        }
+        const uint32_t lodIndices = static_cast<uint32_t>(mesh.mIndices.size()) - lodStart;
+        if (lodIndices > previousIndices * LOD_MIN_REDUCTION)
+        {
+            mesh.mSubMeshes.resize(mesh.mNumLods * numRanges);
+            mesh.mIndices.resize(lodStart);
+            break;
+        }
+        mesh.mLodErrors[mesh.mNumLods++] = lodError;
+        previousIndices = lodIndices;
+    }
+
+    for (const SubMeshRange& subMesh : mesh.mSubMeshes)
+    {
+        uint32_t* pRange = mesh.mIndices.data() + subMesh.mStartIndex;
+        MeshOptimizer::OptimizeVertexCache(pRange, subMesh.mIndexCount, mesh.mNumVertices);
+        MeshOptimizer::OptimizeOverdraw(pRange, subMesh.mIndexCount, mesh.mVertices.data(), mesh.mNumVertices, stride);
+    }
+    // the mesh comes first, its vertices stay in front of the ones only the coarser levels still use
+    MeshOptimizer::OptimizeVertexFetch(mesh.mVertices.data(), mesh.mIndices.data(), static_cast<uint32_t>(mesh.mIndices.size()),
+        mesh.mNumVertices, stride);
+    stats.mOptimizedCache = MeshOptimizer::AnalyzeVertexCache(mesh.mIndices.data(), numIndices, mesh.mNumVertices);
+    stats.mOptimizedOverfetch = MeshOptimizer::AnalyzeVertexFetch(mesh.mIndices.data(), numIndices, mesh.mNumVertices, stride);
+    stats.mFullVertexBytes = static_cast<uint32_t>(mesh.mVertices.size());
+    stats.mVertexBytes = stats.mFullVertexBytes;
+    stats.mFullFetchBytes = CountFetchBytes(mesh.mIndices.data(), numIndices, mesh.mNumVertices, stride);
+    stats.mFetchBytes = stats.mFullFetchBytes;
+
+    std::fill_n(mesh.mBoundsMin, 3, FLT_MAX);
+    std::fill_n(mesh.mBoundsMax, 3, -FLT_MAX);
+    for (uint32_t i = 0; i < mesh.mNumVertices; ++i)
+    {
+        float position[3];
+        memcpy(position, mesh.mVertices.data() + static_cast<size_t>(i) * stride, sizeof(position));
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            mesh.mBoundsMin[axis] = std::min(mesh.mBoundsMin[axis], position[axis]);
+            mesh.mBoundsMax[axis] = std::max(mesh.mBoundsMax[axis], position[axis]);
+        }
+    }
+    return mesh;
+}
+
+void MeshCache::ConvertVertices(ImportedMesh& mesh, VertexFormat format, const VertexPacking::FullVertexAttributes& attributes)
+{
+    if (mesh.mVertexFormat != VertexFormat::FULL || format == VertexFormat::FULL) return;
+    std::vector<uint8_t> vertices(static_cast<size_t>(mesh.mNumVertices) * sizeof(VertexPacking::CompactVertex));
+    VertexPacking::PackCompact(reinterpret_cast<VertexPacking::CompactVertex*>(vertices.data()), mesh.mColors, mesh.mVertices.data(),
+        mesh.mNumVertices, attributes, mesh.mBoundsMin, mesh.mBoundsMax);
+    mesh.mVertices = std::move(vertices);
+    mesh.mVertexStride = sizeof(VertexPacking::CompactVertex);
+    mesh.mVertexFormat = format;
+
+    // a single color is read once by the whole draw
+    const uint32_t numIndices = CountMeshIndices(mesh);
+    ImportStats& stats = mesh.mStats;
+    stats.mVertexBytes = static_cast<uint32_t>(mesh.mVertices.size() + mesh.mColors.size() * sizeof(uint32_t));
+    stats.mFetchBytes = CountFetchBytes(mesh.mIndices.data(), numIndices, mesh.mNumVertices, mesh.mVertexStride) +
+        (mesh.mColors.size() > 1 ? CountFetchBytes(mesh.mIndices.data(), numIndices, mesh.mNumVertices, sizeof(uint32_t)) : sizeof(uint32_t));
+}
+
+std::vector<uint8_t> MeshCache::Serialize(const ImportedMesh& mesh, uint64_t sourceSize, uint64_t sourceStamp)
+{
+    Header header{};
+    header.mMagic = MAGIC;
+    header.mVersion = VERSION;
+    header.mSourceSize = sourceSize;
+    header.mSourceStamp = sourceStamp;
+    header.mVertexStride = mesh.mVertexStride;
+    header.mNumVertices = mesh.mNumVertices;
+    header.mVertexFormat = static_cast<uint32_t>(mesh.mVertexFormat);
+    header.mNumColors = static_cast<uint32_t>(mesh.mColors.size());
+    header.mNumIndices = static_cast<uint32_t>(mesh.mIndices.size());
+    header.mIndexSize = mesh.mNumVertices <= MAX_SHORT_VERTICES ? sizeof(uint16_t) : sizeof(uint32_t);
+    header.mNumSubMeshes = static_cast<uint32_t>(mesh.mSubMeshes.size()) / mesh.mNumLods;
+    header.mNumLods = mesh.mNumLods;
+    memcpy(header.mLodErrors, mesh.mLodErrors, sizeof(header.mLodErrors));
+    memcpy(header.mBoundsMin, mesh.mBoundsMin, sizeof(header.mBoundsMin));
+    memcpy(header.mBoundsMax, mesh.mBoundsMax, sizeof(header.mBoundsMax));
+    const uint32_t numRanges = static_cast<uint32_t>(mesh.mSubMeshes.size());
+    header.mVertexOffset = AlignUp(sizeof(Header) + numRanges * sizeof(SubMeshRange));
+    header.mColorOffset = AlignUp(header.mVertexOffset + static_cast<uint32_t>(mesh.mVertices.size()));
+    header.mIndexOffset = AlignUp(header.mColorOffset + header.mNumColors * static_cast<uint32_t>(sizeof(uint32_t)));
+    header.mFileSize = AlignUp(header.mIndexOffset + header.mNumIndices * header.mIndexSize);
+
+    std::vector<uint8_t> file(header.mFileSize, 0);
+    memcpy(file.data(), &header, sizeof(Header));
+    if (numRanges) memcpy(file.data() + sizeof(Header), mesh.mSubMeshes.data(), numRanges * sizeof(SubMeshRange));
+    if (!mesh.mVertices.empty()) memcpy(file.data() + header.mVertexOffset, mesh.mVertices.data(), mesh.mVertices.size());
+    if (!mesh.mColors.empty()) memcpy(file.data() + header.mColorOffset, mesh.mColors.data(), mesh.mColors.size() * sizeof(uint32_t));
+    if (header.mIndexSize == sizeof(uint32_t))
+    {
+        if (header.mNumIndices) memcpy(file.data() + header.mIndexOffset, mesh.mIndices.data(), header.mNumIndices * sizeof(uint32_t));
+    }
+    else
+    {
+        uint16_t* pIndices = reinterpret_cast<uint16_t*>(file.data() + header.mIndexOffset);
+        for (uint32_t i = 0; i < header.mNumIndices; ++i)
+        {
+            pIndices[i] = static_cast<uint16_t>(mesh.mIndices[i]);
+        }
+    }
+    return file;
+}
+
+bool MeshCache::Load(const void* pData, size_t size)
+{
+    mHeader = nullptr;
+    if (size < sizeof(Header) || reinterpret_cast<uintptr_t>(pData) % ALIGNMENT) return false;
+    const Header* pHeader = static_cast<const Header*>(pData);
+    if (pHeader->mMagic != MAGIC || pHeader->mVersion != VERSION || pHeader->mFileSize != size) return false;
+    if (pHeader->mIndexSize != sizeof(uint16_t) && pHeader->mIndexSize != sizeof(uint32_t)) return false;
+    if (pHeader->mNumLods == 0 || pHeader->mNumLods > MAX_LODS) return false;
+    // full vertices have no colors, compact ones have one or one per vertex
+    if (pHeader->mVertexFormat == static_cast<uint32_t>(VertexFormat::FULL))
+    {
+        if (pHeader->mNumColors != 0) return false;
+    }
+    else if (pHeader->mVertexFormat == static_cast<uint32_t>(VertexFormat::COMPACT))
+    {
+        if (pHeader->mVertexStride != sizeof(VertexPacking::CompactVertex)) return false;
+        if (pHeader->mNumColors != 1 && pHeader->mNumColors != pHeader->mNumVertices) return false;
+    }
+    else
+    {
+        return false;
+    }
+    const uint64_t numRanges = static_cast<uint64_t>(pHeader->mNumSubMeshes) * pHeader->mNumLods;
+    const uint64_t tableEnd = sizeof(Header) + numRanges * sizeof(SubMeshRange);
+    const uint64_t vertexEnd = pHeader->mVertexOffset + static_cast<uint64_t>(pHeader->mNumVertices) * pHeader->mVertexStride;
+    const uint64_t colorEnd = pHeader->mColorOffset + static_cast<uint64_t>(pHeader->mNumColors) * sizeof(uint32_t);
+    const uint64_t indexEnd = pHeader->mIndexOffset + static_cast<uint64_t>(pHeader->mNumIndices) * pHeader->mIndexSize;
+    if (pHeader->mVertexOffset < tableEnd || pHeader->mColorOffset < vertexEnd || pHeader->mIndexOffset < colorEnd ||
+        indexEnd > size) return false;
+    if (pHeader->mVertexOffset % ALIGNMENT || pHeader->mColorOffset % ALIGNMENT || pHeader->mIndexOffset % ALIGNMENT) return false;
+
+    // the indices are uploaded as they are, a corrupt file must not make the gpu read past the vertices
+    const SubMeshRange* pSubMeshes = reinterpret_cast<const SubMeshRange*>(pHeader + 1);
+    const uint8_t* pIndices = static_cast<const uint8_t*>(pData) + pHeader->mIndexOffset;
+    for (uint64_t i = 0; i < numRanges; ++i)
+    {
+        const SubMeshRange& range = pSubMeshes[i];
+        if (static_cast<uint64_t>(range.mStartIndex) + range.mIndexCount > pHeader->mNumIndices) return false;
+        const bool isInBounds = pHeader->mIndexSize == sizeof(uint16_t) ?
+            IsRangeInBounds(reinterpret_cast<const uint16_t*>(pIndices), range, pHeader->mNumVertices) :
+            IsRangeInBounds(reinterpret_cast<const uint32_t*>(pIndices), range, pHeader->mNumVertices);
+        if (!isInBounds) return false;
+    }
+    mHeader = pHeader;
+    return true;
+}
+
+bool MeshCache::IsUpToDate(uint64_t sourceSize, uint64_t sourceStamp, VertexFormat format) const
+{
+    return mHeader && mHeader->mSourceSize == sourceSize && mHeader->mSourceStamp == sourceStamp &&
+        mHeader->mVertexFormat == static_cast<uint32_t>(format);
+}
+
+const void* MeshCache::GetVertices() const
+{
+    return reinterpret_cast<const uint8_t*>(mHeader) + mHeader->mVertexOffset;
+}
+
+const uint32_t* MeshCache::GetColors() const
+{
+    return reinterpret_cast<const uint32_t*>(reinterpret_cast<const uint8_t*>(mHeader) + mHeader->mColorOffset);
+}
+
+const void* MeshCache::GetIndices() const
+{
+    return reinterpret_cast<const uint8_t*>(mHeader) + mHeader->mIndexOffset;
+}
+
+const MeshCache::SubMeshRange* MeshCache::GetSubMeshes(uint32_t lod) const
+{
+    return reinterpret_cast<const SubMeshRange*>(mHeader + 1) + lod * mHeader->mNumSubMeshes;
+}
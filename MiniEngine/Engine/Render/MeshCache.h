@@ -0,0 +1,131 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MeshOptimizer.h"
+#include "VertexFormat.h"
+
+// Binary mesh file written when a mesh is imported and mapped at runtime instead of parsing the source again.
+// Layout: Header | SubMeshRange[mNumLods][mNumSubMeshes] | vertices | colors | indices, the arrays start on 16 byte
+// boundaries so they can be uploaded straight from the mapping. Indices are 16 bit when every vertex can be addressed
+// with them. Only the COMPACT vertex format has colors, see VertexFormat.
+// The coarser levels of detail share the vertices, their indices follow the ones of the mesh.
+// Only depends on the standard library, like the shader cache.
+class MeshCache
+{
+public:
+    // bump when the import or the layout changes, outdated files are imported again.
+    static constexpr uint32_t VERSION = 4;
+    static constexpr uint32_t MAGIC = 0x4853454D;    // "MESH"
+    // levels of detail including the mesh itself
+    static constexpr uint32_t MAX_LODS = 4;
+
+    // same layout as SubMesh
+    struct SubMeshRange
+    {
+        uint32_t mIndexCount;
+        uint32_t mStartIndex;
+        int32_t mBaseVertex;
+    };
+
+    // efficiency of the welded vertices and indices before and after the reordering of Import
+    struct ImportStats
+    {
+        MeshOptimizer::VertexCacheStats mSourceCache;
+        MeshOptimizer::VertexCacheStats mOptimizedCache;
+        float mSourceOverfetch;
+        float mOptimizedOverfetch;
+        // bytes of the vertex streams, and bytes a draw of the mesh reads through the cache of AnalyzeVertexFetch,
+        // for the full vertices and for the format of the import
+        uint32_t mFullVertexBytes;
+        uint32_t mVertexBytes;
+        uint32_t mFullFetchBytes;
+        uint32_t mFetchBytes;
+    };
+
+    // mesh produced by Import, written by Serialize
+    struct ImportedMesh
+    {
+        std::vector<uint8_t> mVertices;
+        uint32_t mVertexStride = 0;
+        uint32_t mNumVertices = 0;
+        VertexFormat mVertexFormat = VertexFormat::FULL;
+        // second stream of COMPACT, a single color when every vertex has the same
+        std::vector<uint32_t> mColors;
+        std::vector<uint32_t> mIndices;
+        // the sub-meshes of every level of detail, level after level
+        std::vector<SubMeshRange> mSubMeshes;
+        uint32_t mNumLods = 1;
+        // surface deviation of every level relative to the radius of the bounds, 0 for the mesh itself
+        float mLodErrors[MAX_LODS] = {};
+        float mBoundsMin[3] = {};
+        float mBoundsMax[3] = {};
+        ImportStats mStats = {};
+    };
+
+    // welds bitwise identical vertices. `pIndices` may be null for a stream of unindexed triangles.
+    // the position is the first float3 of every vertex. a mesh without sub-meshes gets one covering all indices.
+    // coarser levels of detail are simplified from the sub-meshes while they stay close enough to the surface.
+    // the triangles of every level are then ordered for the post-transform cache and overdraw, and the vertices in
+    // the order the triangles fetch them. indices address the vertices directly, base vertices are kept as they are.
+    static ImportedMesh Import(const void* pVertices, uint32_t numVertices, uint32_t stride, const uint32_t* pIndices,
+        uint32_t numIndices, const SubMeshRange* pSubMeshes = nullptr, uint32_t numSubMeshes = 0);
+    // converts the full vertices produced by Import into `format`, the positions are quantized to the bounds.
+    static void ConvertVertices(ImportedMesh& mesh, VertexFormat format, const VertexPacking::FullVertexAttributes& attributes);
+    // `sourceSize` and `sourceStamp` identify the imported file, see IsUpToDate.
+    static std::vector<uint8_t> Serialize(const ImportedMesh& mesh, uint64_t sourceSize, uint64_t sourceStamp);
+
+    // points the view into `pData`, which must outlive it. false and empty when it is malformed or of another version,
+    // including indices addressing vertices past the end once the base vertex of their sub-mesh is added.
+    bool Load(const void* pData, size_t size);
+    void Reset() { mHeader = nullptr; }
+    bool IsLoaded() const { return mHeader != nullptr; }
+    // false as well when the vertices are in another format than `format`
+    bool IsUpToDate(uint64_t sourceSize, uint64_t sourceStamp, VertexFormat format) const;
+
+    const void* GetVertices() const;
+    uint32_t GetVertexStride() const { return mHeader->mVertexStride; }
+    uint32_t GetNumVertices() const { return mHeader->mNumVertices; }
+    VertexFormat GetVertexFormat() const { return static_cast<VertexFormat>(mHeader->mVertexFormat); }
+    // rgba8, 0 colors for FULL and 1 when every vertex has the same
+    const uint32_t* GetColors() const;
+    uint32_t GetNumColors() const { return mHeader->mNumColors; }
+    const void* GetIndices() const;
+    // 2 or 4
+    uint32_t GetIndexSize() const { return mHeader->mIndexSize; }
+    uint32_t GetNumIndices() const { return mHeader->mNumIndices; }
+    // GetNumSubMeshes ranges per level
+    const SubMeshRange* GetSubMeshes(uint32_t lod = 0) const;
+    uint32_t GetNumSubMeshes() const { return mHeader->mNumSubMeshes; }
+    uint32_t GetNumLods() const { return mHeader->mNumLods; }
+    float GetLodError(uint32_t lod) const { return mHeader->mLodErrors[lod]; }
+    const float* GetBoundsMin() const { return mHeader->mBoundsMin; }
+    const float* GetBoundsMax() const { return mHeader->mBoundsMax; }
+
+private:
+    struct Header
+    {
+        uint32_t mMagic;
+        uint32_t mVersion;
+        uint64_t mSourceSize;
+        uint64_t mSourceStamp;
+        uint32_t mVertexStride;
+        uint32_t mNumVertices;
+        uint32_t mVertexFormat;
+        uint32_t mNumColors;
+        uint32_t mNumIndices;
+        uint32_t mIndexSize;
+        uint32_t mNumSubMeshes;
+        uint32_t mNumLods;
+        float mLodErrors[MAX_LODS];
+        float mBoundsMin[3];
+        float mBoundsMax[3];
+        // bytes from the start of the file
+        uint32_t mVertexOffset;
+        uint32_t mColorOffset;
+        uint32_t mIndexOffset;
+        uint32_t mFileSize;
+    };
+
+    const Header* mHeader = nullptr;
+};
@@ -1,9 +1,42 @@
 #pragma once
+#include <memory>
 #include "SubMesh.h"
+#include "BoundingBox.h"
+#include "InputLayout.h"
+#include "MeshCache.h"
 #include "Engine/pch.h"
 #include "Engine/common/Exception.h"
 #include "Engine/Render/RenderResource.h"
 
+// Coarser levels of detail of a mesh, drawn from the same buffers with other sub-mesh ranges.
+struct MeshLodChain
+{
+	// the level to draw at `screenSize`, see Camera::getScreenSize. a coarser level is only taken once its error is
+	// comfortably below the limit, so objects close to a threshold do not switch back and forth every frame.
+	uint32_t selectLod(uint32_t currentLod, float screenSize) const;
+
+	// projected error allowed as a fraction of the viewport height, about a pixel at 1080p
+	static constexpr float MAX_SCREEN_ERROR = 0.001f;
+	static constexpr float HYSTERESIS = 0.25f;
+
+	uint32_t mNumLods = 1;
+	// surface deviation relative to the radius of the bounds, 0 for the mesh itself
+	float mErrors[MeshCache::MAX_LODS] = {};
+	uint32_t mNumTriangles[MeshCache::MAX_LODS] = {};
+	// mNumLods * mSubMeshCount ranges, level after level
+	std::vector<SubMesh> mSubMeshes;
+};
+
+inline uint32_t MeshLodChain::selectLod(uint32_t currentLod, float screenSize) const
+{
+	// the error covers error * radius of the object, screen size its diameter
+	const auto screenError = [&](uint32_t lod) { return mErrors[lod] * screenSize * 0.5f; };
+	uint32_t lod = std::min(currentLod, mNumLods - 1);
+	while (lod > 0 && screenError(lod) > MAX_SCREEN_ERROR) --lod;
+	while (lod + 1 < mNumLods && screenError(lod + 1) <= MAX_SCREEN_ERROR * (1.0f - HYSTERESIS)) ++lod;
+	return lod;
+}
+
 struct MeshData
 {
 	MeshData() = default;
@@ -27,11 +60,18 @@ struct MeshData
 	{
 		mVertexBuffer = other.mVertexBuffer;
 		mIndexBuffer = other.mIndexBuffer;
+		mPositionBuffer = other.mPositionBuffer;
+		mColorBuffer = other.mColorBuffer;
+		mInputLayout = other.mInputLayout;
+		memcpy(mPositionOffset, other.mPositionOffset, sizeof(mPositionOffset));
+		memcpy(mPositionScale, other.mPositionScale, sizeof(mPositionScale));
 		mVertexCount = other.mVertexCount;
 		mIndexCount = other.mIndexCount;
 		mSubMeshes = std::make_unique<SubMesh[]>(other.mSubMeshCount);
 		mSubMeshCount = other.mSubMeshCount;
 		memcpy(mSubMeshes.get(), other.mSubMeshes.get(), mSubMeshCount * sizeof(SubMesh));
+		mBounds = other.mBounds;
+		mLodChain = other.mLodChain;
 	}
 
 	MeshData& operator=(const MeshData& other)
@@ -40,24 +80,68 @@ struct MeshData
 		{
 			mVertexBuffer = other.mVertexBuffer;
 			mIndexBuffer = other.mIndexBuffer;
+			mPositionBuffer = other.mPositionBuffer;
+			mColorBuffer = other.mColorBuffer;
+			mInputLayout = other.mInputLayout;
+			memcpy(mPositionOffset, other.mPositionOffset, sizeof(mPositionOffset));
+			memcpy(mPositionScale, other.mPositionScale, sizeof(mPositionScale));
 			mVertexCount = other.mVertexCount;
 			mIndexCount = other.mIndexCount;
 			mSubMeshes = std::make_unique<SubMesh[]>(other.mSubMeshCount);
 			mSubMeshCount = other.mSubMeshCount;
 			memcpy(mSubMeshes.get(), other.mSubMeshes.get(), mSubMeshCount * sizeof(SubMesh));
+			mBounds = other.mBounds;
+			mLodChain = other.mLodChain;
 		}
 		return *this;
 	}
+	MeshData(MeshData&& other) noexcept = default;
+	MeshData& operator=(MeshData&& other) noexcept = default;
 	~MeshData() = default;
 
+	// the model matrix the vertex shaders get, it dequantizes the positions of COMPACT vertices before `model`.
+	// normals are not quantized, the inverse model stays the one of the object.
+	Matrix4x4 vertexModel(const Matrix4x4& model) const;
+	// for shaders reading the object space position, `vertexModel` already folds them into the model matrix
+	Vector4 positionOffset() const { return Vector4(mPositionOffset[0], mPositionOffset[1], mPositionOffset[2], 0); }
+	Vector4 positionScale() const { return Vector4(mPositionScale[0], mPositionScale[1], mPositionScale[2], 1); }
+
 	VertexBufferRef mVertexBuffer;
 	IndexBufferRef mIndexBuffer;
+	// positions only, read by the depth pre-pass. meshes without it are never drawn into the pre-pass.
+	VertexBufferRef mPositionBuffer;
+	// rgba8 colors of COMPACT vertices in slot 1, a single vertex read by every vertex when the mesh has one color
+	VertexBufferRef mColorBuffer;
+	InputLayout mInputLayout = InputLayout::INFERRED;
+	// COMPACT positions are unorm, the position in object space is mPositionOffset + unorm * mPositionScale
+	float mPositionOffset[3] = { 0, 0, 0 };
+	float mPositionScale[3] = { 1, 1, 1 };
 	uint32_t mVertexCount;
 	uint32_t mIndexCount;
 	std::unique_ptr<SubMesh[]> mSubMeshes;
 	uint8_t mSubMeshCount = 1;
+	// local space bounds computed once when the mesh is loaded
+	BoundingBox mBounds;
+	// null for meshes without coarser levels, shared by the copies
+	std::shared_ptr<const MeshLodChain> mLodChain;
 };
 
+inline Matrix4x4 MeshData::vertexModel(const Matrix4x4& model) const
+{
+	if (mInputLayout != InputLayout::COMPACT) return model;
+	// model * translate(offset) * scale(scale), with column vectors
+	Matrix4x4 result = model;
+	for (int row = 0; row < 4; ++row)
+	{
+		for (int column = 0; column < 3; ++column)
+		{
+			result.m.m[row][3] += model.m.m[row][column] * mPositionOffset[column];
+			result.m.m[row][column] = model.m.m[row][column] * mPositionScale[column];
+		}
+	}
+	return result;
+}
+
 #ifdef WIN32
 
 struct Mesh
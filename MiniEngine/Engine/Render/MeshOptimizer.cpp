@@ -0,0 +1,610 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t INVALID_INDEX = 0xffffffff;
+    constexpr uint32_t FETCH_LINE_SIZE = 64;
+    constexpr uint32_t FETCH_CACHE_LINES = 16 * 1024 / FETCH_LINE_SIZE;
+    // borders weigh more than faces so open edges keep their outline
+    constexpr double BORDER_WEIGHT = 10.0;
+    // a collapse is rejected when a triangle around it turns further than this cosine
+    constexpr double MIN_FLIP_COSINE = 0.25;
+
+    // fifo cache stamped with the time a vertex entered it, resident while time - stamp < size
+    class FifoCache
+    {
+    public:
+        FifoCache(uint32_t numEntries, uint32_t size) : mStamps(numEntries, 0), mTime(size + 1), mSize(size) {}
+
+        // returns whether the entry missed
+        bool Access(uint32_t entry)
+        {
+            if (mTime - mStamps[entry] <= mSize) return false;
+            mStamps[entry] = mTime++;
+            return true;
+        }
+
+        void Flush() { mTime += mSize + 1; }
+
+    private:
+        std::vector<uint32_t> mStamps;
+        uint32_t mTime;
+        uint32_t mSize;
+    };
+
+    // triangles using every vertex: the triangles of vertex v are mTriangles[mOffsets[v], mOffsets[v + 1])
+    struct Adjacency
+    {
+        Adjacency(const uint32_t* pIndices, uint32_t numIndices, uint32_t numVertices)
+            : mOffsets(numVertices + 1, 0), mTriangles(numIndices)
+        {
+            for (uint32_t i = 0; i < numIndices; ++i) ++mOffsets[pIndices[i] + 1];
+            for (uint32_t v = 0; v < numVertices; ++v) mOffsets[v + 1] += mOffsets[v];
+            std::vector<uint32_t> cursors(mOffsets.begin(), mOffsets.end() - 1);
+            for (uint32_t i = 0; i < numIndices; ++i) mTriangles[cursors[pIndices[i]]++] = i / 3;
+        }
+
+        std::vector<uint32_t> mOffsets;
+        std::vector<uint32_t> mTriangles;
+    };
+
+    void LoadPosition(const uint8_t* pVertices, uint32_t stride, uint32_t vertex, float position[3])
+    {
+        memcpy(position, pVertices + static_cast<size_t>(vertex) * stride, 3 * sizeof(float));
+    }
+
+    void Cross(const double a[3], const double b[3], double result[3])
+    {
+        result[0] = a[1] * b[2] - a[2] * b[1];
+        result[1] = a[2] * b[0] - a[0] * b[2];
+        result[2] = a[0] * b[1] - a[1] * b[0];
+    }
+
+    double Dot(const double a[3], const double b[3])
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    // weighted sum of squared distances to planes: p^T A p + 2 b^T p + c, divided by the summed weight
+    struct Quadric
+    {
+        double mA00, mA11, mA22, mA01, mA02, mA12;
+        double mB0, mB1, mB2;
+        double mC;
+        double mWeight;
+
+        void AddPlane(const double normal[3], double distance, double weight)
+        {
+            mA00 += weight * normal[0] * normal[0];
+            mA11 += weight * normal[1] * normal[1];
+            mA22 += weight * normal[2] * normal[2];
+            mA01 += weight * normal[0] * normal[1];
+            mA02 += weight * normal[0] * normal[2];
+            mA12 += weight * normal[1] * normal[2];
+            mB0 += weight * normal[0] * distance;
+            mB1 += weight * normal[1] * distance;
+            mB2 += weight * normal[2] * distance;
+            mC += weight * distance * distance;
+            mWeight += weight;
+        }
+
+        Quadric& operator+=(const Quadric& other)
+        {
+            mA00 += other.mA00; mA11 += other.mA11; mA22 += other.mA22;
+            mA01 += other.mA01; mA02 += other.mA02; mA12 += other.mA12;
+            mB0 += other.mB0; mB1 += other.mB1; mB2 += other.mB2;
+            mC += other.mC;
+            mWeight += other.mWeight;
+            return *this;
+        }
+
+        // mean squared distance of `p` to the planes
+        double Evaluate(const double p[3]) const
+        {
+            const double value = mA00 * p[0] * p[0] + mA11 * p[1] * p[1] + mA22 * p[2] * p[2]
+                + 2.0 * (mA01 * p[0] * p[1] + mA02 * p[0] * p[2] + mA12 * p[1] * p[2])
+                + 2.0 * (mB0 * p[0] + mB1 * p[1] + mB2 * p[2]) + mC;
+            return mWeight > 0.0 ? std::max(value, 0.0) / mWeight : 0.0;
+        }
+    };
+
+    struct Collapse
+    {
+        uint32_t mFrom;
+        uint32_t mTo;
+        double mError;    // squared
+    };
+}
+
+MeshOptimizer::VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const uint32_t* pIndices, uint32_t numIndices,
+    uint32_t numVertices, uint32_t cacheSize)
+{
+    FifoCache cache(numVertices, cacheSize);
+    std::vector<bool> referenced(numVertices, false);
+    uint32_t numMisses = 0;
+    uint32_t numReferenced = 0;
+    for (uint32_t i = 0; i < numIndices; ++i)
+    {
+        numMisses += cache.Access(pIndices[i]);
+        if (!referenced[pIndices[i]])
+        {
+            referenced[pIndices[i]] = true;
+            ++numReferenced;
+        }
+    }
+    VertexCacheStats stats{};
+    if (numIndices) stats.mAcmr = static_cast<float>(numMisses) / (numIndices / 3);
+    if (numReferenced) stats.mAtvr = static_cast<float>(numMisses) / numReferenced;
+    return stats;
+}
+
+float MeshOptimizer::AnalyzeVertexFetch(const uint32_t* pIndices, uint32_t numIndices, uint32_t numVertices, uint32_t stride)
+{
+    const uint32_t numLines = static_cast<uint32_t>((static_cast<uint64_t>(numVertices) * stride + FETCH_LINE_SIZE - 1) / FETCH_LINE_SIZE);
+    FifoCache cache(numLines, FETCH_CACHE_LINES);
+    std::vector<bool> referenced(numVertices, false);
+    uint64_t fetchedBytes = 0;
+    uint64_t referencedBytes = 0;
+    for (uint32_t i = 0; i < numIndices; ++i)
+    {
+        const uint32_t vertex = pIndices[i];
+        if (referenced[vertex]) continue;
+        // only the first use is fetched, the following ones hit the post-transform cache or are counted by ACMR
+        referenced[vertex] = true;
+        referencedBytes += stride;
+        const uint64_t begin = static_cast<uint64_t>(vertex) * stride;
+        for (uint64_t line = begin / FETCH_LINE_SIZE; line <= (begin + stride - 1) / FETCH_LINE_SIZE; ++line)
+        {
+            if (cache.Access(static_cast<uint32_t>(line))) fetchedBytes += FETCH_LINE_SIZE;
+        }
+    }
+    return referencedBytes ? static_cast<float>(fetchedBytes) / referencedBytes : 0.0f;
+}
+
+void MeshOptimizer::OptimizeVertexCache(uint32_t* pIndices, uint32_t numIndices, uint32_t numVertices, uint32_t cacheSize)
+{
+    const uint32_t numTriangles = numIndices / 3;
+    if (numTriangles == 0) return;
+    const Adjacency adjacency(pIndices, numTriangles * 3, numVertices);
+
+    std::vector<uint32_t> liveTriangles(numVertices);
+    for (uint32_t v = 0; v < numVertices; ++v) liveTriangles[v] = adjacency.mOffsets[v + 1] - adjacency.mOffsets[v];
+    std::vector<uint32_t> stamps(numVertices, 0);
+    std::vector<bool> emitted(numTriangles, false);
+    // recently used vertices to continue from once the fanning vertex has no triangles left
+    std::vector<uint32_t> deadEnds;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> output;
+    output.reserve(numTriangles * 3);
+
+    uint32_t time = cacheSize + 1;
+    uint32_t cursor = 0;
+    uint32_t fanning = pIndices[0];
+    while (fanning != INVALID_INDEX)
+    {
+        candidates.clear();
+        for (uint32_t t = adjacency.mOffsets[fanning]; t < adjacency.mOffsets[fanning + 1]; ++t)
+        {
+            const uint32_t triangle = adjacency.mTriangles[t];
+            if (emitted[triangle]) continue;
+            emitted[triangle] = true;
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                const uint32_t v = pIndices[triangle * 3 + corner];
+                output.push_back(v);
+                deadEnds.push_back(v);
+                candidates.push_back(v);
+                --liveTriangles[v];
+                if (time - stamps[v] > cacheSize) stamps[v] = time++;
+            }
+        }
+
+        // the candidate staying in the cache while all its triangles are emitted and entered the longest time ago
+        fanning = INVALID_INDEX;
+        int bestPriority = -1;
+        for (uint32_t v : candidates)
+        {
+            if (liveTriangles[v] == 0) continue;
+            int priority = 0;
+            if (time - stamps[v] + 2 * liveTriangles[v] <= cacheSize) priority = static_cast<int>(time - stamps[v]);
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                fanning = v;
+            }
+        }
+        if (fanning != INVALID_INDEX) continue;
+
+        while (!deadEnds.empty() && fanning == INVALID_INDEX)
+        {
+            const uint32_t v = deadEnds.back();
+            deadEnds.pop_back();
+            if (liveTriangles[v]) fanning = v;
+        }
+        while (cursor < numVertices && fanning == INVALID_INDEX)
+        {
+            if (liveTriangles[cursor]) fanning = cursor;
+            ++cursor;
+        }
+    }
+    std::copy(output.begin(), output.end(), pIndices);
+}
+
+void MeshOptimizer::OptimizeOverdraw(uint32_t* pIndices, uint32_t numIndices, const void* pVertices, uint32_t numVertices,
+    uint32_t stride, float threshold, uint32_t cacheSize)
+{
+    const uint32_t numTriangles = numIndices / 3;
+    if (numTriangles == 0) return;
+    const uint8_t* pPositions = static_cast<const uint8_t*>(pVertices);
+
+    // a cluster ends once its misses, counted from a cold cache as it may be drawn after any other, come close enough
+    // to the misses of the whole range. clusters of a range without reuse are single triangles.
+    const float acmr = AnalyzeVertexCache(pIndices, numTriangles * 3, numVertices, cacheSize).mAcmr;
+    std::vector<uint32_t> clusterStarts;
+    FifoCache cache(numVertices, cacheSize);
+    uint32_t clusterMisses = 0;
+    uint32_t clusterStart = 0;
+    for (uint32_t triangle = 0; triangle < numTriangles; ++triangle)
+    {
+        if (triangle == clusterStart)
+        {
+            clusterStarts.push_back(clusterStart);
+            cache.Flush();
+            clusterMisses = 0;
+        }
+        for (uint32_t corner = 0; corner < 3; ++corner) clusterMisses += cache.Access(pIndices[triangle * 3 + corner]);
+        if (clusterMisses <= threshold * acmr * (triangle + 1 - clusterStart)) clusterStart = triangle + 1;
+    }
+    clusterStarts.push_back(numTriangles);
+    const uint32_t numClusters = static_cast<uint32_t>(clusterStarts.size()) - 1;
+    if (numClusters < 2) return;
+
+    // area weighted centroids and normals
+    std::vector<float> clusterData(numClusters * 6, 0.0f);
+    double meshCentroid[3] = {};
+    double meshArea = 0.0;
+    for (uint32_t cluster = 0; cluster < numClusters; ++cluster)
+    {
+        float* pCentroid = &clusterData[cluster * 6];
+        float* pNormal = pCentroid + 3;
+        float clusterArea = 0.0f;
+        for (uint32_t triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; ++triangle)
+        {
+            float p0[3], p1[3], p2[3];
+            LoadPosition(pPositions, stride, pIndices[triangle * 3 + 0], p0);
+            LoadPosition(pPositions, stride, pIndices[triangle * 3 + 1], p1);
+            LoadPosition(pPositions, stride, pIndices[triangle * 3 + 2], p2);
+            const float e0[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+            const float e1[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+            // twice the area along the normal
+            const float normal[3] = { e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0] };
+            const float area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                pCentroid[axis] += (p0[axis] + p1[axis] + p2[axis]) * area / 3.0f;
+                pNormal[axis] += normal[axis];
+            }
+            clusterArea += area;
+        }
+        for (int axis = 0; axis < 3; ++axis) meshCentroid[axis] += pCentroid[axis];
+        meshArea += clusterArea;
+        if (clusterArea > 0.0f) for (int axis = 0; axis < 3; ++axis) pCentroid[axis] /= clusterArea;
+    }
+    if (meshArea > 0.0) for (int axis = 0; axis < 3; ++axis) meshCentroid[axis] /= meshArea;
+
+    // clusters in front of the centroid and facing away from it come first
+    std::vector<float> sortKeys(numClusters);
+    for (uint32_t cluster = 0; cluster < numClusters; ++cluster)
+    {
+        const float* pCentroid = &clusterData[cluster * 6];
+        const float* pNormal = pCentroid + 3;
+        const float length = std::sqrt(pNormal[0] * pNormal[0] + pNormal[1] * pNormal[1] + pNormal[2] * pNormal[2]);
+        float key = 0.0f;
+        for (int axis = 0; axis < 3; ++axis) key += (pCentroid[axis] - static_cast<float>(meshCentroid[axis])) * pNormal[axis];
+        sortKeys[cluster] = length > 0.0f ? key / length : 0.0f;
+    }
+    std::vector<uint32_t> order(numClusters);
+    for (uint32_t cluster = 0; cluster < numClusters; ++cluster) order[cluster] = cluster;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    std::vector<uint32_t> output;
+    output.reserve(numTriangles * 3);
+    for (uint32_t cluster : order)
+    {
+        output.insert(output.end(), pIndices + clusterStarts[cluster] * 3, pIndices + clusterStarts[cluster + 1] * 3);
+    }
+    std::copy(output.begin(), output.end(), pIndices);
+}
+
+uint32_t MeshOptimizer::Simplify(uint32_t* pDestination, const uint32_t* pIndices, uint32_t numIndices, const void* pVertices,
+    uint32_t numVertices, uint32_t stride, uint32_t targetIndexCount, float maxError, float* pResultError)
+{
+    const uint8_t* pData = static_cast<const uint8_t*>(pVertices);
+    numIndices = numIndices / 3 * 3;
+    if (pResultError) *pResultError = 0.0f;
+
+    // vertices sharing a position move together, the collapses work on the positions
+    std::vector<uint32_t> positionVertices(numVertices);
+    std::iota(positionVertices.begin(), positionVertices.end(), 0);
+    std::sort(positionVertices.begin(), positionVertices.end(), [&](uint32_t a, uint32_t b)
+    {
+        const int order = memcmp(pData + static_cast<size_t>(a) * stride, pData + static_cast<size_t>(b) * stride, 3 * sizeof(float));
+        return order != 0 ? order < 0 : a < b;
+    });
+    std::vector<uint32_t> positionOf(numVertices);
+    // the vertices at position p are positionVertices[positionOffsets[p], positionOffsets[p + 1])
+    std::vector<uint32_t> positionOffsets;
+    for (uint32_t i = 0; i < numVertices; ++i)
+    {
+        const uint32_t vertex = positionVertices[i];
+        if (i == 0 || memcmp(pData + static_cast<size_t>(vertex) * stride,
+            pData + static_cast<size_t>(positionVertices[i - 1]) * stride, 3 * sizeof(float)) != 0)
+        {
+            positionOffsets.push_back(i);
+        }
+        positionOf[vertex] = static_cast<uint32_t>(positionOffsets.size()) - 1;
+    }
+    const uint32_t numPositions = static_cast<uint32_t>(positionOffsets.size());
+    positionOffsets.push_back(numVertices);
+
+    // positions relative to the bounding sphere of the box, errors are measured in its radius
+    float boundsMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float boundsMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    std::vector<double> positions(static_cast<size_t>(numPositions) * 3);
+    for (uint32_t p = 0; p < numPositions; ++p)
+    {
+        float position[3];
+        LoadPosition(pData, stride, positionVertices[positionOffsets[p]], position);
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            positions[p * 3 + axis] = position[axis];
+            boundsMin[axis] = std::min(boundsMin[axis], position[axis]);
+            boundsMax[axis] = std::max(boundsMax[axis], position[axis]);
+        }
+    }
+    double radius = 0.0;
+    for (int axis = 0; axis < 3 && numPositions; ++axis) radius += (boundsMax[axis] - boundsMin[axis]) * (boundsMax[axis] - boundsMin[axis]);
+    radius = 0.5 * std::sqrt(radius);
+    const double scale = radius > 0.0 ? 1.0 / radius : 1.0;
+    for (double& value : positions) value *= scale;
+    const auto position = [&](uint32_t p) { return &positions[static_cast<size_t>(p) * 3]; };
+
+    std::vector<uint32_t> corners(pIndices, pIndices + numIndices);
+    const auto positionOfCorner = [&](uint32_t corner) { return positionOf[corners[corner]]; };
+
+    // area weighted planes of the triangles
+    std::vector<Quadric> quadrics(numPositions, Quadric{});
+    for (uint32_t corner = 0; corner < numIndices; corner += 3)
+    {
+        const double* p0 = position(positionOfCorner(corner));
+        const double* p1 = position(positionOfCorner(corner + 1));
+        const double* p2 = position(positionOfCorner(corner + 2));
+        const double e0[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+        const double e1[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+        double normal[3];
+        Cross(e0, e1, normal);
+        const double length = std::sqrt(Dot(normal, normal));
+        if (length == 0.0) continue;
+        for (double& value : normal) value /= length;
+        for (uint32_t i = 0; i < 3; ++i) quadrics[positionOfCorner(corner + i)].AddPlane(normal, -Dot(normal, p0), 0.5 * length);
+    }
+
+    // edges as (min position << 32 | max position, corner of the edge start), an edge used once is a border
+    std::vector<std::pair<uint64_t, uint32_t>> edges;
+    const auto edgeKey = [](uint32_t a, uint32_t b)
+    {
+        return static_cast<uint64_t>(std::min(a, b)) << 32 | std::max(a, b);
+    };
+    const auto findBorders = [&]()
+    {
+        edges.clear();
+        for (uint32_t corner = 0; corner < corners.size(); ++corner)
+        {
+            const uint32_t next = corner % 3 == 2 ? corner - 2 : corner + 1;
+            edges.push_back({ edgeKey(positionOfCorner(corner), positionOfCorner(next)), corner });
+        }
+        std::sort(edges.begin(), edges.end());
+    };
+
+    // planes through the borders, perpendicular to their triangles
+    findBorders();
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        if ((i > 0 && edges[i - 1].first == edges[i].first) || (i + 1 < edges.size() && edges[i + 1].first == edges[i].first)) continue;
+        const uint32_t corner = edges[i].second;
+        const uint32_t triangle = corner - corner % 3;
+        const double* p0 = position(positionOfCorner(triangle));
+        const double* p1 = position(positionOfCorner(triangle + 1));
+        const double* p2 = position(positionOfCorner(triangle + 2));
+        const double e0[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+        const double e1[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+        double faceNormal[3];
+        Cross(e0, e1, faceNormal);
+        const uint32_t a = positionOfCorner(corner);
+        const uint32_t b = positionOfCorner(corner % 3 == 2 ? corner - 2 : corner + 1);
+        const double edge[3] = { position(b)[0] - position(a)[0], position(b)[1] - position(a)[1], position(b)[2] - position(a)[2] };
+        double normal[3];
+        Cross(edge, faceNormal, normal);
+        const double length = std::sqrt(Dot(normal, normal));
+        if (length == 0.0) continue;
+        for (double& value : normal) value /= length;
+        const double weight = Dot(edge, edge) * BORDER_WEIGHT;
+        quadrics[a].AddPlane(normal, -Dot(normal, position(a)), weight);
+        quadrics[b].AddPlane(normal, -Dot(normal, position(a)), weight);
+    }
+
+    const double maxSquaredError = static_cast<double>(maxError) * maxError;
+    double resultError = 0.0;
+    std::vector<bool> isBorder(numPositions);
+    std::vector<uint32_t> triangleOffsets(numPositions + 1);
+    std::vector<uint32_t> positionTriangles;
+    std::vector<Collapse> collapses;
+    std::vector<bool> locked(numPositions);
+    std::vector<uint32_t> remap(numPositions);
+    std::iota(remap.begin(), remap.end(), 0);
+    std::vector<uint32_t> replacements(numVertices, INVALID_INDEX);
+    const uint32_t numAttributes = stride > 3 * sizeof(float) ? (stride - 3 * sizeof(float)) / sizeof(float) : 0;
+    // triangles turning over or collapsing when `from` moves to `to`
+    const auto flips = [&](uint32_t from, uint32_t to)
+    {
+        for (uint32_t t = triangleOffsets[from]; t < triangleOffsets[from + 1]; ++t)
+        {
+            const uint32_t triangle = positionTriangles[t];
+            uint32_t p[3] = { positionOfCorner(triangle), positionOfCorner(triangle + 1), positionOfCorner(triangle + 2) };
+            if (p[0] == to || p[1] == to || p[2] == to) continue;
+            double before[3], after[3];
+            for (int moved = 0; moved < 2; ++moved)
+            {
+                const double* p0 = position(p[0]);
+                const double* p1 = position(p[1]);
+                const double* p2 = position(p[2]);
+                const double e0[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+                const double e1[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+                Cross(e0, e1, moved ? after : before);
+                for (uint32_t& corner : p) if (corner == from) corner = to;
+            }
+            if (Dot(before, after) <= MIN_FLIP_COSINE * std::sqrt(Dot(before, before) * Dot(after, after))) return true;
+        }
+        return false;
+    };
+
+    while (corners.size() > targetIndexCount)
+    {
+        findBorders();
+        std::fill(isBorder.begin(), isBorder.end(), false);
+        for (size_t i = 0; i < edges.size(); ++i)
+        {
+            if ((i > 0 && edges[i - 1].first == edges[i].first) || (i + 1 < edges.size() && edges[i + 1].first == edges[i].first)) continue;
+            isBorder[edges[i].first >> 32] = true;
+            isBorder[edges[i].first & 0xffffffff] = true;
+        }
+
+        std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+        for (uint32_t corner = 0; corner < corners.size(); ++corner) ++triangleOffsets[positionOfCorner(corner) + 1];
+        for (uint32_t p = 0; p < numPositions; ++p) triangleOffsets[p + 1] += triangleOffsets[p];
+        positionTriangles.resize(corners.size());
+        {
+            std::vector<uint32_t> cursors(triangleOffsets.begin(), triangleOffsets.end() - 1);
+            for (uint32_t corner = 0; corner < corners.size(); ++corner) positionTriangles[cursors[positionOfCorner(corner)]++] = corner - corner % 3;
+        }
+
+        // the cheaper direction of every edge. border positions only move along their border.
+        collapses.clear();
+        for (size_t i = 0; i < edges.size(); ++i)
+        {
+            if (i > 0 && edges[i - 1].first == edges[i].first) continue;
+            const bool borderEdge = i + 1 == edges.size() || edges[i + 1].first != edges[i].first;
+            const uint32_t a = static_cast<uint32_t>(edges[i].first >> 32);
+            const uint32_t b = static_cast<uint32_t>(edges[i].first & 0xffffffff);
+            Quadric quadric = quadrics[a];
+            quadric += quadrics[b];
+            const double errorToB = !isBorder[a] || borderEdge ? quadric.Evaluate(position(b)) : DBL_MAX;
+            const double errorToA = !isBorder[b] || borderEdge ? quadric.Evaluate(position(a)) : DBL_MAX;
+            if (errorToB == DBL_MAX && errorToA == DBL_MAX) continue;
+            collapses.push_back(errorToB <= errorToA ? Collapse{ a, b, errorToB } : Collapse{ b, a, errorToA });
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.mError < b.mError; });
+
+        // a collapse removes two triangles in a closed mesh. the positions around a collapse stay put for the rest of
+        // the pass, so the adjacency remains valid.
+        const size_t goal = (corners.size() - targetIndexCount) / 6 + 1;
+        std::fill(locked.begin(), locked.end(), false);
+        size_t numCollapsed = 0;
+        for (const Collapse& collapse : collapses)
+        {
+            if (numCollapsed >= goal || collapse.mError > maxSquaredError) break;
+            if (locked[collapse.mFrom] || locked[collapse.mTo] || flips(collapse.mFrom, collapse.mTo)) continue;
+            remap[collapse.mFrom] = collapse.mTo;
+            quadrics[collapse.mTo] += quadrics[collapse.mFrom];
+            for (uint32_t t = triangleOffsets[collapse.mFrom]; t < triangleOffsets[collapse.mFrom + 1]; ++t)
+            {
+                const uint32_t triangle = positionTriangles[t];
+                for (uint32_t i = 0; i < 3; ++i) locked[positionOfCorner(triangle + i)] = true;
+            }
+            resultError = std::max(resultError, collapse.mError);
+            ++numCollapsed;
+        }
+        if (numCollapsed == 0) break;
+
+        // moved corners take the vertex with the closest attributes at their new position, degenerate triangles are dropped
+        size_t numCorners = 0;
+        for (size_t triangle = 0; triangle < corners.size(); triangle += 3)
+        {
+            uint32_t vertices[3];
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                uint32_t vertex = corners[triangle + i];
+                const uint32_t target = remap[positionOf[vertex]];
+                if (target != positionOf[vertex])
+                {
+                    if (replacements[vertex] == INVALID_INDEX)
+                    {
+                        float bestDistance = FLT_MAX;
+                        for (uint32_t j = positionOffsets[target]; j < positionOffsets[target + 1]; ++j)
+                        {
+                            const uint32_t candidate = positionVertices[j];
+                            float distance = 0.0f;
+                            for (uint32_t attribute = 0; attribute < numAttributes; ++attribute)
+                            {
+                                float a, b;
+                                const size_t offset = (3 + attribute) * sizeof(float);
+                                memcpy(&a, pData + static_cast<size_t>(vertex) * stride + offset, sizeof(float));
+                                memcpy(&b, pData + static_cast<size_t>(candidate) * stride + offset, sizeof(float));
+                                distance += (a - b) * (a - b);
+                            }
+                            if (distance < bestDistance)
+                            {
+                                bestDistance = distance;
+                                replacements[vertex] = candidate;
+                            }
+                        }
+                    }
+                    vertex = replacements[vertex];
+                }
+                vertices[i] = vertex;
+            }
+            const uint32_t p0 = positionOf[vertices[0]], p1 = positionOf[vertices[1]], p2 = positionOf[vertices[2]];
+            if (p0 == p1 || p1 == p2 || p0 == p2) continue;
+            for (uint32_t i = 0; i < 3; ++i) corners[numCorners++] = vertices[i];
+        }
+        corners.resize(numCorners);
+        for (const Collapse& collapse : collapses) remap[collapse.mFrom] = collapse.mFrom;
+    }
+
+    std::copy(corners.begin(), corners.end(), pDestination);
+    if (pResultError) *pResultError = static_cast<float>(std::sqrt(resultError));
+    return static_cast<uint32_t>(corners.size());
+}
+
+uint32_t MeshOptimizer::OptimizeVertexFetch(void* pVertices, uint32_t* pIndices, uint32_t numIndices, uint32_t numVertices,
+    uint32_t stride)
+{
+    std::vector<uint32_t> remap(numVertices, INVALID_INDEX);
+    uint32_t numReferenced = 0;
+    for (uint32_t i = 0; i < numIndices; ++i)
+    {
+        uint32_t& target = remap[pIndices[i]];
+        if (target == INVALID_INDEX) target = numReferenced++;
+        pIndices[i] = target;
+    }
+    uint32_t next = numReferenced;
+    for (uint32_t& target : remap)
+    {
+        if (target == INVALID_INDEX) target = next++;
+    }
+
+    uint8_t* pData = static_cast<uint8_t*>(pVertices);
+    std::vector<uint8_t> vertices(pData, pData + static_cast<size_t>(numVertices) * stride);
+    for (uint32_t v = 0; v < numVertices; ++v)
+    {
+        memcpy(pData + static_cast<size_t>(remap[v]) * stride, vertices.data() + static_cast<size_t>(v) * stride, stride);
+    }
+    return numReferenced;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+
+// Reordering passes run when a mesh is imported, and the cpu side analyzers measuring them.
+// Indices address the whole vertex array, positions are the first float3 of every vertex.
+// Only depends on the standard library, like the mesh cache importing with it.
+namespace MeshOptimizer
+{
+    // entries of the simulated post-transform cache. a fifo of 16 is close to the reuse of current gpus, orders optimized
+    // for it also do well on larger caches.
+    constexpr uint32_t CACHE_SIZE = 16;
+    // the clusters of OptimizeOverdraw may have this much worse cache efficiency than the whole range
+    constexpr float OVERDRAW_THRESHOLD = 1.05f;
+
+    struct VertexCacheStats
+    {
+        float mAcmr;    // transformed vertices per triangle, 0.5 at best on large regular meshes, 3 at worst
+        float mAtvr;    // transformed vertices per referenced vertex, 1 at best
+    };
+    VertexCacheStats AnalyzeVertexCache(const uint32_t* pIndices, uint32_t numIndices, uint32_t numVertices,
+        uint32_t cacheSize = CACHE_SIZE);
+    // bytes read through a 16KB cache of 64 byte lines per byte of referenced vertices, 1 at best.
+    float AnalyzeVertexFetch(const uint32_t* pIndices, uint32_t numIndices, uint32_t numVertices, uint32_t stride);
+
+    // Tipsify (Sander et al. 2007): reorders the triangles in place so consecutive triangles share vertices in the cache.
+    void OptimizeVertexCache(uint32_t* pIndices, uint32_t numIndices, uint32_t numVertices, uint32_t cacheSize = CACHE_SIZE);
+    // splits cache optimized triangles into clusters keeping their cache efficiency and draws the clusters facing away from
+    // the center of the mesh first, they tend to occlude the inner ones from most directions.
+    void OptimizeOverdraw(uint32_t* pIndices, uint32_t numIndices, const void* pVertices, uint32_t numVertices, uint32_t stride,
+        float threshold = OVERDRAW_THRESHOLD, uint32_t cacheSize = CACHE_SIZE);
+    // quadric error metric edge collapses (Garland and Heckbert 1997) onto existing positions, the result indexes the same
+    // vertices. collapses stop at `targetIndexCount` or before the surface moves more than `maxError`, relative to the
+    // radius of the bounds of the vertices. corners moved to another position take the vertex there with the closest
+    // attributes, which are read as floats. writes at most `numIndices` indices to `pDestination` and returns their
+    // number, `pResultError` receives the relative error reached.
+    uint32_t Simplify(uint32_t* pDestination, const uint32_t* pIndices, uint32_t numIndices, const void* pVertices,
+        uint32_t numVertices, uint32_t stride, uint32_t targetIndexCount, float maxError, float* pResultError = nullptr);
+    // moves the vertices into the order the indices first use them and remaps the indices.
+    // returns the number of referenced vertices, the unreferenced ones are moved to the end.
+    uint32_t OptimizeVertexFetch(void* pVertices, uint32_t* pIndices, uint32_t numIndices, uint32_t numVertices, uint32_t stride);
+}
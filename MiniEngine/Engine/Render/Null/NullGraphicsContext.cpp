@@ -0,0 +1,268 @@
+#include "NullGraphicsContext.h"
+#include "NullRHI.h"
+
+NullFrameStats& NullFrameStats::operator+=(const NullFrameStats& other)
+{
+    mDrawCalls += other.mDrawCalls;
+    mPrimitives += other.mPrimitives;
+    mPipelineStateBinds += other.mPipelineStateBinds;
+    mPipelineStateChanges += other.mPipelineStateChanges;
+    mPipelineStateCreations += other.mPipelineStateCreations;
+    mDescriptorUpdates += other.mDescriptorUpdates;
+    mDescriptorTables += other.mDescriptorTables;
+    mDescriptorRefills += other.mDescriptorRefills;
+    mDrawIndexUpdates += other.mDrawIndexUpdates;
+    mVertexIndexBinds += other.mVertexIndexBinds;
+    mCommands += other.mCommands;
+    mCommandLists += other.mCommandLists;
+    mBarrierBatches += other.mBarrierBatches;
+    mBarriers += other.mBarriers;
+    mBytesUploaded += other.mBytesUploaded;
+    return *this;
+}
+
+void NullCopyBuffer(RHIBufferWrapper* pDst, RHIStagingBuffer* pStagingBuffer, uint64_t size, uint64_t dstStart, uint64_t srcStart)
+{
+    NullBuffer* pDstBuffer = static_cast<NullBuffer*>(pDst->GetBuffer());
+    const NullBuffer* pSrcBuffer = static_cast<const NullBuffer*>(pStagingBuffer->GetBuffer());
+    ASSERT(dstStart + size <= pDstBuffer->BufferSize() && srcStart + size <= pSrcBuffer->BufferSize(), TEXT("buffer copy out of range"));
+    memcpy(pDstBuffer->Data() + dstStart, pSrcBuffer->Data() + srcStart, size);
+}
+
+void NullCopyTextureMip(RHINativeTexture* pDst, RHIStagingBuffer* pStagingBuffer, uint8_t mipmap)
+{
+    NullTexture* pTexture = static_cast<NullTexture*>(pDst);
+    const NullBuffer* pSrcBuffer = static_cast<const NullBuffer*>(pStagingBuffer->GetBuffer());
+    const uint64_t size = std::min<uint64_t>(pTexture->MipSize(mipmap), pSrcBuffer->BufferSize());
+    memcpy(pTexture->Data() + pTexture->MipOffset(mipmap), pSrcBuffer->Data(), size);
+}
+
+NullGraphicsContext::NullGraphicsContext(NullRHI* pRHI, bool recordCommands) : mRHI(pRHI), mLastPipelineState(0), mRecordCommands(recordCommands)
+{
+    mTransientMemory.Initialize(64ull * 1024 * 1024, 64ull * 1024, 0, MemoryTag::RENDER);
+    mDescriptorCache.Initialize(pRHI->GetDescriptorRing(), DESCRIPTOR_BATCH_SIZE);
+}
+
+void NullGraphicsContext::Reset()
+{
+    mCommands.clear();
+    mStats = {};
+    mTransientMemory.Reset();
+    mDescriptorCache.Reset();
+    mLastPipelineState = 0;
+}
+
+void NullGraphicsContext::Record(NullCommandType type, uint8_t slot, uint16_t count, uint64_t object, uint64_t size,
+                                 uint32_t arg0, uint32_t arg1, uint32_t arg2)
+{
+    ++mStats.mCommands;
+    if (!mRecordCommands) return;
+    mCommands.push_back({type, slot, count, {arg0, arg1, arg2}, object, size});
+}
+
+std::unique_ptr<RHIConstantBuffer> NullGraphicsContext::AllocConstantBuffer(uint16_t size)
+{
+    uint8_t* pData = static_cast<uint8_t*>(mTransientMemory.AllocatePtr(size, 256));
+    ASSERT(pData, TEXT("transient constant buffer memory exhausted"));
+    return std::make_unique<RHIConstantBuffer>(std::make_unique<NullBuffer>(pData, size, ResourceType::DYNAMIC));
+}
+
+void NullGraphicsContext::UpdateBuffer(RHIBufferWrapper* pDst, RHIStagingBuffer* pStagingBuffer, uint64_t size, uint64_t dstStart, uint64_t srcStart)
+{
+    NullCopyBuffer(pDst, pStagingBuffer, size, dstStart, srcStart);
+    mStats.mBytesUploaded += size;
+    Record(NullCommandType::UPDATE_BUFFER, 0, 1, reinterpret_cast<uint64_t>(pDst->GetBuffer()), size);
+}
+
+void NullGraphicsContext::UpdateTexture(RHITextureWrapper* pDst, RHIStagingBuffer* pStagingBuffer, uint8_t mipmap)
+{
+    NullCopyTextureMip(pDst->GetTexture(), pStagingBuffer, mipmap);
+    mStats.mBytesUploaded += pStagingBuffer->GetBuffer()->BufferSize();
+    Record(NullCommandType::UPDATE_TEXTURE, mipmap, 1, reinterpret_cast<uint64_t>(pDst->GetTexture()), pStagingBuffer->GetBuffer()->BufferSize());
+}
+
+void NullGraphicsContext::CopyTexture(RHITextureWrapper* pDst, RHITextureWrapper* pSrc, const TextureCopyLocation& dstLocation,
+                                      const TextureCopyLocation& srcLocation, uint32_t width, uint32_t height, uint32_t depth)
+{
+    Record(NullCommandType::COPY_TEXTURE, 0, 1, reinterpret_cast<uint64_t>(pDst->GetTexture()), 0, width, height, depth);
+}
+
+void NullGraphicsContext::ClearRenderTarget(const RHIRenderTarget* pRenderTarget, const Vector4& clearColor, const Rect* clearRects, uint32_t numRects)
+{
+    Record(NullCommandType::CLEAR_RENDER_TARGET, 0, static_cast<uint16_t>(numRects), reinterpret_cast<uint64_t>(pRenderTarget));
+}
+
+void NullGraphicsContext::ClearDepthStencil(const RHIDepthStencil* pDepthStencil, bool clearDepth, bool clearStencil, float depth,
+                                            uint32_t stencil, const Rect* clearRects, uint32_t numRects)
+{
+    Record(NullCommandType::CLEAR_DEPTH_STENCIL, clearDepth | clearStencil << 1, static_cast<uint16_t>(numRects), reinterpret_cast<uint64_t>(pDepthStencil));
+}
+
+void NullGraphicsContext::SetPipelineState(const PipelineInitializer& initializer)
+{
+    const uint64_t hash = initializer.Hash();
+    ++mStats.mPipelineStateBinds;
+    if (hash != mLastPipelineState)
+    {
+        ++mStats.mPipelineStateChanges;
+        mStats.mPipelineStateCreations += mRHI->GetOrCreatePipelineState(initializer);
+    }
+    mLastPipelineState = hash;
+    Record(NullCommandType::SET_PIPELINE_STATE, 0, 1, hash);
+}
+
+void NullGraphicsContext::SetConstantBuffers(uint8_t baseSlot, uint8_t numSlots, RHIConstantBuffer* pConstants[])
+{
+    for (uint8_t i = 0; i < numSlots; ++i)
+    {
+        SetConstantBuffer(baseSlot + i, pConstants[i]);
+    }
+}
+
+void NullGraphicsContext::SetConstantBuffer(uint8_t slot, RHIConstantBuffer* pConstants)
+{
+    ++mStats.mDescriptorUpdates;
+    Record(NullCommandType::SET_CONSTANT_BUFFER, slot, 1, reinterpret_cast<uint64_t>(pConstants->GetBuffer()), pConstants->GetBuffer()->BufferSize());
+}
+
+void NullGraphicsContext::SetStaticConstantBuffer(uint8_t slot, RHIStaticConstantBuffer* pConstants, uint64_t offset, uint64_t size)
+{
+    ASSERT(offset % 256 == 0 && offset + size <= pConstants->GetBuffer()->BufferSize(), TEXT("invalid constant buffer view offset"));
+    ++mStats.mDescriptorUpdates;
+    Record(NullCommandType::SET_CONSTANT_BUFFER, slot, 1, reinterpret_cast<uint64_t>(pConstants->GetBuffer()), size,
+           static_cast<uint32_t>(offset));
+}
+
+void NullGraphicsContext::SetTextures(uint8_t baseSlot, uint8_t numSlots, RHINativeTexture* textures[])
+{
+    for (uint8_t i = 0; i < numSlots; ++i)
+    {
+        SetTexture(baseSlot + i, textures[i]);
+    }
+}
+
+void NullGraphicsContext::SetTexture(uint8_t slot, RHINativeTexture* pTexture)
+{
+    ++mStats.mDescriptorUpdates;
+    Record(NullCommandType::SET_TEXTURE, slot, 1, reinterpret_cast<uint64_t>(pTexture));
+}
+
+void NullGraphicsContext::SetStructuredBuffer(uint8_t slot, const void* pData, uint32_t stride, uint32_t numElements)
+{
+    const uint64_t size = static_cast<uint64_t>(stride) * numElements;
+    void* pCopy = mTransientMemory.AllocatePtr(size, 16);
+    ASSERT(pCopy, TEXT("transient constant buffer memory exhausted"));
+    memcpy(pCopy, pData, size);
+    ++mStats.mDescriptorUpdates;
+    mStats.mBytesUploaded += size;
+    Record(NullCommandType::SET_STRUCTURED_BUFFER, slot, static_cast<uint16_t>(std::min<uint32_t>(numElements, UINT16_MAX)),
+           reinterpret_cast<uint64_t>(pCopy), size, stride);
+}
+
+void NullGraphicsContext::SetViewPorts(Viewport* viewports, uint32_t numViewports)
+{
+    Record(NullCommandType::SET_VIEWPORTS, 0, static_cast<uint16_t>(numViewports), 0);
+}
+
+void NullGraphicsContext::SetScissorRect(Rect* scissorRects, uint32_t numScissorRects)
+{
+    Record(NullCommandType::SET_SCISSOR_RECTS, 0, static_cast<uint16_t>(numScissorRects), 0);
+}
+
+void NullGraphicsContext::SetRenderTargetsAndDepthStencil(RHIRenderTarget** renderTargets, uint32_t numRenderTargets, RHIDepthStencil* depthStencilTarget)
+{
+    Record(NullCommandType::SET_RENDER_TARGETS, 0, static_cast<uint16_t>(numRenderTargets), reinterpret_cast<uint64_t>(depthStencilTarget));
+}
+
+void NullGraphicsContext::SetVertexBuffers(RHIVertexBuffer** vertexBuffers, uint8_t numVertexBuffers)
+{
+    ++mStats.mVertexIndexBinds;
+    Record(NullCommandType::SET_VERTEX_BUFFERS, 0, numVertexBuffers, numVertexBuffers ? reinterpret_cast<uint64_t>(vertexBuffers[0]) : 0);
+}
+
+void NullGraphicsContext::SetIndexBuffer(const RHIIndexBuffer* pIndexBuffer)
+{
+    ++mStats.mVertexIndexBinds;
+    Record(NullCommandType::SET_INDEX_BUFFER, 0, 1, reinterpret_cast<uint64_t>(pIndexBuffer));
+}
+
+void NullGraphicsContext::DrawInstanced(uint32_t verticesPerInstance, uint32_t baseVertex, uint32_t instanceCount, uint32_t baseInstance)
+{
+    ++mStats.mDrawCalls;
+    mStats.mPrimitives += static_cast<uint64_t>(verticesPerInstance / 3) * instanceCount;
+    Record(NullCommandType::DRAW, 0, static_cast<uint16_t>(std::min<uint32_t>(instanceCount, UINT16_MAX)), baseInstance, 0,
+           verticesPerInstance, baseVertex);
+}
+
+void NullGraphicsContext::DrawIndexedInstanced(uint32_t indicesPerInstance, uint32_t baseIndex, uint32_t baseVertex, uint32_t instanceCount, uint32_t baseInstance)
+{
+    ++mStats.mDrawCalls;
+    mStats.mPrimitives += static_cast<uint64_t>(indicesPerInstance / 3) * instanceCount;
+    Record(NullCommandType::DRAW_INDEXED, 0, static_cast<uint16_t>(std::min<uint32_t>(instanceCount, UINT16_MAX)), baseInstance, 0,
+           indicesPerInstance, baseIndex, baseVertex);
+}
+
+void NullGraphicsContext::InsertFence(RHIFence* pFence, uint64_t semaphore)
+{
+    Record(NullCommandType::INSERT_FENCE, 0, 1, reinterpret_cast<uint64_t>(pFence), semaphore);
+}
+
+void NullGraphicsContext::TransitionResources(const RHIResourceTransition* pTransitions, uint32_t numTransitions)
+{
+    if (numTransitions == 0) return;
+    ++mStats.mBarrierBatches;
+    mStats.mBarriers += numTransitions;
+    Record(NullCommandType::TRANSITION_RESOURCES, 0, static_cast<uint16_t>(std::min<uint32_t>(numTransitions, UINT16_MAX)),
+           reinterpret_cast<uint64_t>(pTransitions[0].mResource));
+}
+
+void NullGraphicsContext::BeginBinding()
+{
+    ++mStats.mDescriptorTables;
+    const uint32_t numRefills = mDescriptorCache.GetNumRefills();
+    const uint64_t offset = mDescriptorCache.Allocate(DESCRIPTOR_TABLE_SIZE);
+    ASSERT(offset != FrameRingAllocator::INVALID_OFFSET, TEXT("a single frame exhausted the descriptor ring."));
+    mStats.mDescriptorRefills += mDescriptorCache.GetNumRefills() - numRefills;
+    Record(NullCommandType::BEGIN_BINDING, 0, 0, offset);
+}
+
+void NullGraphicsContext::EndBindings()
+{
+    Record(NullCommandType::END_BINDINGS, 0, 0, 0);
+}
+
+void NullGraphicsContext::SetBindlessTables()
+{
+    Record(NullCommandType::SET_BINDLESS_TABLES, 0, 0, 0);
+}
+
+void NullGraphicsContext::SetDrawIndices(uint32_t objectIndex, uint32_t materialIndex)
+{
+    ++mStats.mDrawIndexUpdates;
+    Record(NullCommandType::SET_DRAW_INDICES, 0, 2, 0, 0, objectIndex, materialIndex);
+}
+
+void NullCopyContext::UpdateBuffer(RHIBufferWrapper* pDst, RHIStagingBuffer* pStagingBuffer, uint64_t size, uint64_t dstStart, uint64_t srcStart)
+{
+    NullCopyBuffer(pDst, pStagingBuffer, size, dstStart, srcStart);
+    mStats.mBytesUploaded += size;
+    ++mStats.mCommands;
+}
+
+void NullCopyContext::UpdateTexture(RHINativeTexture* pDst, RHIStagingBuffer* pStagingBuffer, uint8_t mipmap)
+{
+    NullCopyTextureMip(pDst, pStagingBuffer, mipmap);
+    mStats.mBytesUploaded += pStagingBuffer->GetBuffer()->BufferSize();
+    ++mStats.mCommands;
+}
+
+void NullCopyContext::CopyTexture(RHITextureWrapper* pDst, RHITextureWrapper* pSrc, const TextureCopyLocation& dstLocation,
+                                  const TextureCopyLocation& srcLocation, uint32_t width, uint32_t height, uint32_t depth)
+{
+    ++mStats.mCommands;
+}
+
+void NullCopyContext::InsertFence(RHIFence* pFence, uint64_t semaphore)
+{
+    ++mStats.mCommands;
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include "NullResources.h"
+#include "Engine/Memory/VirtualLinearAllocator.h"
+#include "Engine/Render/FrameRingAllocator.h"
+#include "Engine/Render/RHIPipelineStateInializer.h"
+
+class NullRHI;
+
+enum class NullCommandType : uint8_t
+{
+    SET_PIPELINE_STATE,
+    SET_CONSTANT_BUFFER,
+    SET_TEXTURE,
+    SET_STRUCTURED_BUFFER,
+    SET_VIEWPORTS,
+    SET_SCISSOR_RECTS,
+    SET_RENDER_TARGETS,
+    SET_VERTEX_BUFFERS,
+    SET_INDEX_BUFFER,
+    BEGIN_BINDING,
+    END_BINDINGS,
+    CLEAR_RENDER_TARGET,
+    CLEAR_DEPTH_STENCIL,
+    DRAW,
+    DRAW_INDEXED,
+    UPDATE_BUFFER,
+    UPDATE_TEXTURE,
+    COPY_TEXTURE,
+    INSERT_FENCE,
+    TRANSITION_RESOURCES,
+    SET_BINDLESS_TABLES,
+    SET_DRAW_INDICES,
+};
+
+// 32 bytes per command. `mObject` is the bound resource, the pipeline state hash or the base instance of a draw.
+// Draws store the instance count in mCount and (count per instance, base index/vertex, base vertex) in mArgs.
+// Static constant buffers store the byte offset of the view in mArgs[0].
+// Transitions store the number of resources in mCount and the first resource in mObject.
+// Draw indices store the object index in mArgs[0] and the material index in mArgs[1].
+// Bindings store the offset of their descriptor table in the descriptor ring in mObject.
+struct NullCommand
+{
+    NullCommandType mType;
+    uint8_t mSlot;
+    uint16_t mCount;
+    uint32_t mArgs[3];
+    uint64_t mObject;
+    uint64_t mSize;
+};
+
+struct NullFrameStats
+{
+    uint32_t mDrawCalls = 0;
+    uint64_t mPrimitives = 0;
+    uint32_t mPipelineStateBinds = 0;
+    uint32_t mPipelineStateChanges = 0;     // binds whose state differs from the previous one
+    uint32_t mPipelineStateCreations = 0;   // binds whose state was neither prewarmed nor used before, a hitch on a driver
+    uint32_t mDescriptorUpdates = 0;        // constant buffer and texture bindings
+    uint32_t mDescriptorTables = 0;         // BeginBinding calls, every call allocates and writes a descriptor table
+    uint32_t mDescriptorRefills = 0;        // batches of descriptor tables taken from the shared descriptor ring
+    uint32_t mDrawIndexUpdates = 0;         // root constants of bindless draws
+    uint32_t mVertexIndexBinds = 0;
+    uint32_t mCommands = 0;
+    uint32_t mCommandLists = 0;             // submitted graphics contexts
+    uint32_t mBarrierBatches = 0;           // TransitionResources calls
+    uint32_t mBarriers = 0;                 // transitioned resources
+    uint64_t mBytesUploaded = 0;            // constant buffer, staging and copy traffic
+
+    NullFrameStats& operator+=(const NullFrameStats& other);
+};
+
+class NullGraphicsContext final : public RHIGraphicsContext
+{
+    friend class NullRHI;
+public:
+    // like the d3d12 contexts: descriptor tables of the global root signature, allocated in batches.
+    static constexpr uint32_t DESCRIPTOR_TABLE_SIZE = 7;
+    static constexpr uint32_t DESCRIPTOR_BATCH_SIZE = 128;
+
+    std::unique_ptr<RHIConstantBuffer> AllocConstantBuffer(uint16_t size) override;
+    void UpdateBuffer(RHIBufferWrapper* pDst, RHIStagingBuffer* pStagingBuffer, uint64_t size, uint64_t dstStart, uint64_t srcStart) override;
+    void UpdateTexture(RHITextureWrapper* pDst, RHIStagingBuffer* pStagingBuffer, uint8_t mipmap) override;
+    void CopyTexture(RHITextureWrapper* pDst, RHITextureWrapper* pSrc, const TextureCopyLocation& dstLocation, const TextureCopyLocation& srcLocation, uint32_t width, uint32_t height, uint32_t depth) override;
+    void ClearRenderTarget(const RHIRenderTarget* pRenderTarget, const Vector4& clearColor, const Rect* clearRects, uint32_t numRects) override;
+    void ClearDepthStencil(const RHIDepthStencil* pDepthStencil, bool clearDepth, bool clearStencil, float depth, uint32_t stencil, const Rect* clearRects, uint32_t numRects) override;
+    void SetPipelineState(const PipelineInitializer& initializer) override;
+    void SetConstantBuffers(uint8_t baseSlot, uint8_t numSlots, RHIConstantBuffer* pConstants[]) override;
+    void SetConstantBuffer(uint8_t slot, RHIConstantBuffer* pConstants) override;
+    void SetStaticConstantBuffer(uint8_t slot, RHIStaticConstantBuffer* pConstants, uint64_t offset, uint64_t size) override;
+    void SetTextures(uint8_t baseSlot, uint8_t numSlots, RHINativeTexture* textures[]) override;
+    void SetTexture(uint8_t slot, RHINativeTexture* pTexture) override;
+    void SetStructuredBuffer(uint8_t slot, const void* pData, uint32_t stride, uint32_t numElements) override;
+    void SetViewPorts(Viewport* viewports, uint32_t numViewports) override;
+    void SetScissorRect(Rect* scissorRects, uint32_t numScissorRects) override;
+    void SetRenderTargetsAndDepthStencil(RHIRenderTarget** renderTargets, uint32_t numRenderTargets, RHIDepthStencil* depthStencilTarget) override;
+    void SetVertexBuffers(RHIVertexBuffer** vertexBuffers, uint8_t numVertexBuffers) override;
+    void SetIndexBuffer(const RHIIndexBuffer* pIndexBuffer) override;
+    void DrawInstanced(uint32_t verticesPerInstance, uint32_t baseVertex, uint32_t instanceCount, uint32_t baseInstance) override;
+    void DrawIndexedInstanced(uint32_t indicesPerInstance, uint32_t baseIndex, uint32_t baseVertex, uint32_t instanceCount, uint32_t baseInstance) override;
+    void InsertFence(RHIFence* pFence, uint64_t semaphore) override;
+    void TransitionResources(const RHIResourceTransition* pTransitions, uint32_t numTransitions) override;
+    void BeginBinding() override;
+    void EndBindings() override;
+    void SetBindlessTables() override;
+    void SetDrawIndices(uint32_t objectIndex, uint32_t materialIndex) override;
+
+    const std::vector<NullCommand>& GetCommands() const { return mCommands; }
+    const NullFrameStats& GetStats() const { return mStats; }
+    void Reset();
+
+    NullGraphicsContext(NullRHI* pRHI, bool recordCommands);
+
+private:
+    void Record(NullCommandType type, uint8_t slot, uint16_t count, uint64_t object, uint64_t size = 0,
+                uint32_t arg0 = 0, uint32_t arg1 = 0, uint32_t arg2 = 0);
+
+    NullRHI* mRHI;
+    std::vector<NullCommand> mCommands;
+    NullFrameStats mStats;
+    // backing memory for the per-frame constant buffers, rewound on Reset
+    VirtualLinearAllocator mTransientMemory;
+    FrameRingCache mDescriptorCache;
+    uint64_t mLastPipelineState;
+    bool mRecordCommands;
+};
+
+class NullCopyContext final : public RHICopyContext
+{
+    friend class NullRHI;
+public:
+    void UpdateBuffer(RHIBufferWrapper* pDst, RHIStagingBuffer* pStagingBuffer, uint64_t size, uint64_t dstStart, uint64_t srcStart) override;
+    void UpdateTexture(RHINativeTexture* pDst, RHIStagingBuffer* pStagingBuffer, uint8_t mipmap) override;
+    void CopyTexture(RHITextureWrapper* pDst, RHITextureWrapper* pSrc, const TextureCopyLocation& dstLocation,
+                     const TextureCopyLocation& srcLocation, uint32_t width, uint32_t height, uint32_t depth) override;
+    void InsertFence(RHIFence* pFence, uint64_t semaphore) override;
+
+    const NullFrameStats& GetStats() const { return mStats; }
+    void Reset() { mStats = {}; }
+
+    NullCopyContext() = default;
+
+private:
+    NullFrameStats mStats;
+};
+
+class NullComputeContext final : public RHIComputeContext
+{
+};
+
+// shared by graphics and copy contexts, copies are executed immediately on the cpu.
+void NullCopyBuffer(RHIBufferWrapper* pDst, RHIStagingBuffer* pStagingBuffer, uint64_t size, uint64_t dstStart, uint64_t srcStart);
+void NullCopyTextureMip(RHINativeTexture* pDst, RHIStagingBuffer* pStagingBuffer, uint8_t mipmap);
@@ -0,0 +1,656 @@
+#include "NullRHI.h"
+
+#include <cctype>
+
+#include "Engine/Render/Blob.h"
+#include "Engine/Render/Shader.h"
+
+namespace
+{
+    std::string sStripComments(const char* pSource, size_t size)
+    {
+        std::string result;
+        result.reserve(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (pSource[i] == '/' && i + 1 < size && pSource[i + 1] == '/')
+            {
+                while (i < size && pSource[i] != '\n') ++i;
+            }
+            else if (pSource[i] == '/' && i + 1 < size && pSource[i + 1] == '*')
+            {
+                i += 2;
+                while (i + 1 < size && !(pSource[i] == '*' && pSource[i + 1] == '/')) ++i;
+                ++i;
+                result.push_back(' ');
+                continue;
+            }
+            if (i < size) result.push_back(pSource[i]);
+        }
+        return result;
+    }
+
+    bool sIsIdentifierChar(char c)
+    {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    size_t sSkipSpaces(const std::string& source, size_t pos)
+    {
+        while (pos < source.size() && std::isspace(static_cast<unsigned char>(source[pos]))) ++pos;
+        return pos;
+    }
+
+    std::string sReadIdentifier(const std::string& source, size_t& pos)
+    {
+        pos = sSkipSpaces(source, pos);
+        const size_t start = pos;
+        while (pos < source.size() && sIsIdentifierChar(source[pos])) ++pos;
+        return source.substr(start, pos - start);
+    }
+
+    // finds `keyword` as a whole word starting at `pos`.
+    size_t sFindKeyword(const std::string& source, const char* keyword, size_t pos)
+    {
+        const size_t length = strlen(keyword);
+        while ((pos = source.find(keyword, pos)) != std::string::npos)
+        {
+            const bool boundaryBefore = pos == 0 || !sIsIdentifierChar(source[pos - 1]);
+            const bool boundaryAfter = pos + length >= source.size() || !sIsIdentifierChar(source[pos + length]);
+            if (boundaryBefore && boundaryAfter) return pos;
+            pos += length;
+        }
+        return std::string::npos;
+    }
+
+    // a global resource declaration continues with a register binding, an array size or ends right away,
+    // while a function parameter continues with `,` or `)`.
+    bool sIsDeclaration(const std::string& source, size_t pos)
+    {
+        pos = sSkipSpaces(source, pos);
+        return pos < source.size() && (source[pos] == ':' || source[pos] == ';' || source[pos] == '[');
+    }
+
+    // parses an optional `: register(xN)` between `pos` and `end`, returns false if the binding is implicit.
+    bool sParseRegister(const std::string& source, size_t pos, size_t end, char registerClass, uint8_t& slot)
+    {
+        const size_t registerPos = sFindKeyword(source, "register", pos);
+        if (registerPos == std::string::npos || registerPos >= end) return false;
+        size_t i = source.find('(', registerPos);
+        if (i == std::string::npos || i >= end) return false;
+        i = sSkipSpaces(source, i + 1);
+        if (i >= end || std::tolower(static_cast<unsigned char>(source[i])) != registerClass) return false;
+        slot = static_cast<uint8_t>(std::strtoul(source.c_str() + i + 1, nullptr, 10));
+        return true;
+    }
+
+    // size of one register row and number of rows occupied by a hlsl type, matrices are column major by default.
+    void sGetTypeLayout(const std::string& type, bool rowMajor, uint32_t& rowSize, uint32_t& numRows)
+    {
+        static const std::pair<const char*, uint32_t> scalarTypes[] = {
+            {"float", 4}, {"int", 4}, {"uint", 4}, {"bool", 4}, {"dword", 4}, {"half", 4}, {"double", 8},
+            {"min16float", 4}, {"min16int", 4}, {"min16uint", 4},
+        };
+        rowSize = 16;
+        numRows = 1;
+        if (type == "matrix")
+        {
+            numRows = 4;
+            return;
+        }
+        if (type == "vector") return;
+
+        for (const auto& scalarType : scalarTypes)
+        {
+            const size_t length = strlen(scalarType.first);
+            if (type.compare(0, length, scalarType.first) != 0) continue;
+            const std::string suffix = type.substr(length);
+            if (suffix.empty())
+            {
+                rowSize = scalarType.second;
+                return;
+            }
+            if (suffix.size() == 1 && std::isdigit(static_cast<unsigned char>(suffix[0])))
+            {
+                rowSize = scalarType.second * (suffix[0] - '0');
+                return;
+            }
+            if (suffix.size() == 3 && suffix[1] == 'x')
+            {
+                const uint32_t rows = suffix[0] - '0';
+                const uint32_t columns = suffix[2] - '0';
+                rowSize = scalarType.second * (rowMajor ? columns : rows);
+                numRows = rowMajor ? rows : columns;
+                return;
+            }
+        }
+        // user defined structs are treated as a single register.
+    }
+
+    // estimates the size of a constant buffer body with hlsl packing rules, rounded to 16 bytes like the d3d reflection.
+    // `structured` evaluates the body as the element of a structured buffer instead, which is packed without padding.
+    // the offsets of the variables are appended to `variables`.
+    uint64_t sCalculateCBufferSize(const std::string& body, uint8_t slot, std::vector<ShaderVariable>& variables, bool structured = false)
+    {
+        uint64_t offset = 0;
+        size_t statementStart = 0;
+        while (statementStart < body.size())
+        {
+            size_t statementEnd = body.find(';', statementStart);
+            if (statementEnd == std::string::npos) statementEnd = body.size();
+            const std::string statement = body.substr(statementStart, statementEnd - statementStart);
+            statementStart = statementEnd + 1;
+
+            size_t pos = 0;
+            bool rowMajor = false;
+            std::string type = sReadIdentifier(statement, pos);
+            while (type == "row_major" || type == "column_major" || type == "precise" || type == "uniform" || type == "const")
+            {
+                rowMajor |= type == "row_major";
+                type = sReadIdentifier(statement, pos);
+            }
+            if (type.empty()) continue;
+            uint32_t rowSize, numRows;
+            sGetTypeLayout(type, rowMajor, rowSize, numRows);
+
+            // one statement may declare several variables: `float a, b[2];`
+            while (pos < statement.size())
+            {
+                const std::string name = sReadIdentifier(statement, pos);
+                if (name.empty()) break;
+                uint32_t arraySize = 1;
+                pos = sSkipSpaces(statement, pos);
+                if (pos < statement.size() && statement[pos] == '[')
+                {
+                    arraySize = std::max(1ul, std::strtoul(statement.c_str() + pos + 1, nullptr, 10));
+                }
+                const uint32_t totalRows = numRows * arraySize;
+                uint32_t size = rowSize;
+                if (structured)
+                {
+                    size *= totalRows;
+                }
+                else if (totalRows > 1 || rowSize > 16)
+                {
+                    // arrays and matrices start on a new register, every row but the last is padded to 16 bytes
+                    offset = ::AlignUpToMul<uint64_t, 16>()(offset);
+                    size += (totalRows - 1) * 16;
+                }
+                else
+                {
+                    // a vector never straddles a 16 byte boundary
+                    if ((offset & 15) + rowSize > 16) offset = ::AlignUpToMul<uint64_t, 16>()(offset);
+                }
+                variables.push_back({ name, slot, static_cast<uint32_t>(offset), size });
+                offset += size;
+                pos = statement.find(',', pos);
+                if (pos == std::string::npos) break;
+                ++pos;
+            }
+        }
+        return structured ? offset : ::AlignUpToMul<uint64_t, 16>()(offset);
+    }
+
+    // the body of `struct name { ... }`, empty when the source does not define it.
+    std::string sFindStructBody(const std::string& source, const std::string& name)
+    {
+        for (size_t pos = sFindKeyword(source, "struct", 0); pos != std::string::npos; pos = sFindKeyword(source, "struct", pos))
+        {
+            pos += 6;
+            if (sReadIdentifier(source, pos) != name) continue;
+            const size_t bodyStart = source.find('{', pos);
+            const size_t bodyEnd = bodyStart == std::string::npos ? std::string::npos : source.find('}', bodyStart);
+            if (bodyEnd == std::string::npos) break;
+            return source.substr(bodyStart + 1, bodyEnd - bodyStart - 1);
+        }
+        return {};
+    }
+}
+
+void NullSwapChain::Present()
+{
+    mRHI->EndFrame();
+    RHISwapChain::Present();
+}
+
+NullSwapChain::NullSwapChain(NullRHI* pRHI, const RHITextureDesc& backBufferDesc, uint8_t numBackBuffers) :
+    RHISwapChain(numBackBuffers), mRHI(pRHI), mColorBuffers(new std::unique_ptr<NullRenderTarget>[numBackBuffers])
+{
+    for (uint8_t i = 0; i < numBackBuffers; ++i)
+    {
+        mColorBuffers[i] = std::make_unique<NullRenderTarget>(backBufferDesc);
+    }
+}
+
+NullRHI::NullRHI() : mConstantBytesUploaded(0), mNumBindlessTextures(0), mRecordCommands(false)
+{
+    mDescriptorRing.Initialize(ONLINE_DESCRIPTORS);
+    mUploadRing.Initialize(UPLOAD_RING_SIZE);
+}
+
+NullRHI::~NullRHI()
+{
+    Release();
+}
+
+void NullRHI::Initialize()
+{
+    RHI::Initialize();
+}
+
+std::unique_ptr<RHIShader> NullRHI::RHICompileShader(const Blob& binary, ShaderType activeTypes, const std::string* path)
+{
+    std::vector<ShaderProp> props;
+    std::vector<ShaderVariable> variables;
+    GetShaderProperties(binary, activeTypes, props, variables);
+    const Blob empty{nullptr, 0};
+    RHIShader* pShader = new RHIShader();
+    pShader->SetShaders(
+        activeTypes & ShaderType::VERTEX ? binary : empty,
+        activeTypes & ShaderType::HULL ? binary : empty,
+        activeTypes & ShaderType::DOMAIN ? binary : empty,
+        activeTypes & ShaderType::GEOMETRY ? binary : empty,
+        activeTypes & ShaderType::PIXEL ? binary : empty);
+    pShader->SetShaderProperties(props);
+    pShader->SetShaderVariables(variables);
+    return std::unique_ptr<RHIShader>(pShader);
+}
+
+void NullRHI::GetShaderProperties(const Blob& source, ShaderType visibility, std::vector<ShaderProp>& properties,
+    std::vector<ShaderVariable>& variables)
+{
+    if (!source.Binary() || source.Size() < 4) return;
+    // compiled dxbc/dxil containers
+    if (memcmp(source.Binary(), "DXBC", 4) == 0 || memcmp(source.Binary(), "DXIL", 4) == 0) return;
+
+    const std::string hlsl = sStripComments(reinterpret_cast<const char*>(source.Binary()), source.Size());
+    uint8_t nextSlot[3] = {0, 0, 0};   // implicit bindings for b, t and s registers
+    auto bindSlot = [&](ShaderProp& prop, size_t pos, size_t end, char registerClass, uint8_t& next)
+    {
+        if (!sParseRegister(hlsl, pos, end, registerClass, prop.mRegister)) prop.mRegister = next;
+        next = std::max<uint8_t>(next, prop.mRegister + 1);
+        prop.mVisibility = visibility;
+    };
+
+    for (size_t pos = sFindKeyword(hlsl, "cbuffer", 0); pos != std::string::npos; pos = sFindKeyword(hlsl, "cbuffer", pos))
+    {
+        pos += 7;
+        const size_t bodyStart = hlsl.find('{', pos);
+        const size_t bodyEnd = bodyStart == std::string::npos ? std::string::npos : hlsl.find('}', bodyStart);
+        if (bodyEnd == std::string::npos) break;
+        ShaderProp prop{};
+        prop.mType = ShaderPropType::CBUFFER;
+        prop.mName = sReadIdentifier(hlsl, pos);
+        bindSlot(prop, pos, bodyStart, 'b', nextSlot[0]);
+        prop.mInfo.mCBufferSize = sCalculateCBufferSize(hlsl.substr(bodyStart + 1, bodyEnd - bodyStart - 1), prop.mRegister, variables);
+        properties.push_back(prop);
+        pos = bodyEnd;
+    }
+
+    // element strides are left at 0 when the element is not a struct of this file.
+    for (size_t pos = sFindKeyword(hlsl, "StructuredBuffer", 0); pos != std::string::npos; pos = sFindKeyword(hlsl, "StructuredBuffer", pos))
+    {
+        size_t elementPos = hlsl.find('<', pos);
+        pos = hlsl.find('>', pos);
+        if (pos == std::string::npos || elementPos == std::string::npos) break;
+        ++pos;
+        const std::string element = sReadIdentifier(hlsl, ++elementPos);
+        ShaderProp prop{};
+        prop.mType = ShaderPropType::STRUCTURED_BUFFER;
+        prop.mName = sReadIdentifier(hlsl, pos);
+        if (prop.mName.empty() || !sIsDeclaration(hlsl, pos)) continue;
+        bindSlot(prop, pos, hlsl.find(';', pos), 't', nextSlot[1]);
+        const std::string body = sFindStructBody(hlsl, element);
+        if (!body.empty())
+        {
+            // only the members of the material table are written by the engine
+            std::vector<ShaderVariable> members;
+            prop.mInfo.mCBufferSize = sCalculateCBufferSize(body, ShaderVariable::MATERIAL_TABLE, members, true);
+            if (prop.mName == "MaterialTable") variables.insert(variables.end(), members.begin(), members.end());
+        }
+        properties.push_back(prop);
+    }
+    // Common.hlsl declares the instance buffer inside END_INSTANCE_DATA, includes are not resolved here.
+    if (sFindKeyword(hlsl, "END_INSTANCE_DATA", 0) != std::string::npos)
+    {
+        ShaderProp prop{};
+        prop.mType = ShaderPropType::STRUCTURED_BUFFER;
+        prop.mName = "InstanceBuffer";
+        prop.mRegister = 0;
+        prop.mVisibility = visibility;
+        nextSlot[1] = std::max<uint8_t>(nextSlot[1], 1);
+        properties.push_back(prop);
+    }
+    // and the material table of bindless shaders inside END_BINDLESS_MATERIAL_DATA.
+    const size_t bindlessStart = sFindKeyword(hlsl, "BEGIN_BINDLESS_MATERIAL_DATA", 0);
+    const size_t bindlessEnd = sFindKeyword(hlsl, "END_BINDLESS_MATERIAL_DATA", 0);
+    if (bindlessStart != std::string::npos && bindlessEnd != std::string::npos && bindlessStart < bindlessEnd)
+    {
+        const size_t bodyStart = bindlessStart + strlen("BEGIN_BINDLESS_MATERIAL_DATA");
+        ShaderProp prop{};
+        prop.mType = ShaderPropType::STRUCTURED_BUFFER;
+        prop.mName = "MaterialTable";
+        prop.mRegister = 1;
+        prop.mVisibility = visibility;
+        prop.mInfo.mCBufferSize = sCalculateCBufferSize(hlsl.substr(bodyStart, bindlessEnd - bodyStart), ShaderVariable::MATERIAL_TABLE, variables, true);
+        properties.push_back(prop);
+    }
+
+    static const std::pair<const char*, TextureDimension> textureTypes[] = {
+        {"Texture1D", TextureDimension::TEXTURE1D}, {"Texture1DArray", TextureDimension::TEXTURE1D_ARRAY},
+        {"Texture2D", TextureDimension::TEXTURE2D}, {"Texture2DArray", TextureDimension::TEXTURE2D_ARRAY},
+        {"Texture3D", TextureDimension::TEXTURE3D}, {"TextureCube", TextureDimension::TEXTURE_CUBE},
+    };
+    for (const auto& textureType : textureTypes)
+    {
+        for (size_t pos = sFindKeyword(hlsl, textureType.first, 0); pos != std::string::npos; pos = sFindKeyword(hlsl, textureType.first, pos))
+        {
+            pos = sSkipSpaces(hlsl, pos + strlen(textureType.first));
+            if (pos < hlsl.size() && hlsl[pos] == '<')
+            {
+                pos = hlsl.find('>', pos);
+                if (pos == std::string::npos) break;
+                ++pos;
+            }
+            ShaderProp prop{};
+            prop.mType = ShaderPropType::TEXTURE;
+            prop.mName = sReadIdentifier(hlsl, pos);
+            // a texture type used as a function parameter is not a binding
+            if (prop.mName.empty() || !sIsDeclaration(hlsl, pos)) continue;
+            bindSlot(prop, pos, hlsl.find(';', pos), 't', nextSlot[1]);
+            prop.mInfo.mTextureDimension = textureType.second;
+            properties.push_back(prop);
+        }
+    }
+
+    for (size_t pos = sFindKeyword(hlsl, "SamplerState", 0); pos != std::string::npos; pos = sFindKeyword(hlsl, "SamplerState", pos))
+    {
+        pos += strlen("SamplerState");
+        ShaderProp prop{};
+        prop.mType = ShaderPropType::SAMPLER;
+        prop.mName = sReadIdentifier(hlsl, pos);
+        if (prop.mName.empty() || !sIsDeclaration(hlsl, pos)) continue;
+        bindSlot(prop, pos, hlsl.find(';', pos), 's', nextSlot[2]);
+        // registers below 4 are static samplers, same as the d3d12 reflection path.
+        if (prop.mRegister < 4) continue;
+        properties.push_back(prop);
+    }
+}
+
+std::unique_ptr<RHIStagingBuffer> NullRHI::RHIAllocStagingBuffer(uint64_t size)
+{
+    return std::make_unique<RHIStagingBuffer>(std::make_unique<NullBuffer>(size, ResourceType::DYNAMIC));
+}
+
+std::unique_ptr<RHIStagingBuffer> NullRHI::RHIAllocStagingTexture(const RHITextureDesc& desc, uint8_t mipmap)
+{
+    // tightly packed, there is no row pitch alignment to honor in system memory.
+    return RHIAllocStagingBuffer(NullTexture::CalculateMipSize(desc, mipmap));
+}
+
+std::unique_ptr<RHIStagingBuffer> NullRHI::RHIAllocUploadBuffer(uint64_t size)
+{
+    if (size > mUploadRing.GetTotalSize()) return nullptr;
+    uint64_t offset = mUploadRing.Allocate(size);
+    if (offset == FrameRingAllocator::INVALID_OFFSET && mUploadRing.Reclaim() > 0) offset = mUploadRing.Allocate(size);
+    if (offset == FrameRingAllocator::INVALID_OFFSET) return nullptr;
+    return RHIAllocStagingBuffer(size);
+}
+
+std::unique_ptr<RHIStagingBuffer> NullRHI::RHIAllocUploadTexture(const RHITextureDesc& desc, uint8_t mipmap)
+{
+    return RHIAllocUploadBuffer(NullTexture::CalculateMipSize(desc, mipmap));
+}
+
+std::unique_ptr<RHIConstantBuffer> NullRHI::RHIAllocConstantBuffer(uint64_t size)
+{
+    return std::make_unique<RHIConstantBuffer>(std::make_unique<NullBuffer>(::AlignUpToMul<uint64_t, 256>()(size), ResourceType::DYNAMIC));
+}
+
+std::unique_ptr<RHIStaticConstantBuffer> NullRHI::RHIAllocStaticConstantBuffer(uint64_t size)
+{
+    return std::make_unique<RHIStaticConstantBuffer>(std::make_unique<NullBuffer>(::AlignUpToMul<uint64_t, 256>()(size), ResourceType::STATIC));
+}
+
+std::unique_ptr<RHINativeTexture> NullRHI::RHIAllocTexture(RHITextureDesc desc)
+{
+    desc.mMipLevels = desc.mMipLevels ? desc.mMipLevels : GetMipLevelCount(desc.mWidth, desc.mHeight, desc.mDepth);
+    std::unique_ptr<NullTexture> pTexture = std::make_unique<NullTexture>(desc);
+    // slots are not recycled, like the d3d12 table
+    const uint32_t index = mNumBindlessTextures.fetch_add(1);
+    if (index < MAX_BINDLESS_TEXTURES)
+    {
+        pTexture->SetBindlessIndex(index);
+    }
+    else
+    {
+        mNumBindlessTextures = MAX_BINDLESS_TEXTURES;
+        WARN("bindless texture table is full, the texture can only be bound through descriptor tables!");
+    }
+    return pTexture;
+}
+
+std::unique_ptr<RHIDepthStencil> NullRHI::RHIAllocDepthStencil(RHITextureDesc desc)
+{
+    ASSERT(desc.mDimension == TextureDimension::TEXTURE2D, TEXT("depth stencil buffer should be 2-dimension texture."));
+    desc.mMipLevels = desc.mMipLevels ? desc.mMipLevels : GetMipLevelCount(desc.mWidth, desc.mHeight, desc.mDepth);
+    return std::make_unique<NullDepthStencil>(desc);
+}
+
+std::unique_ptr<RHIRenderTarget> NullRHI::RHIAllocRenderTarget(RHITextureDesc desc)
+{
+    desc.mMipLevels = desc.mMipLevels ? desc.mMipLevels : GetMipLevelCount(desc.mWidth, desc.mHeight, desc.mDepth);
+    return std::make_unique<NullRenderTarget>(desc);
+}
+
+std::unique_ptr<RHIVertexBuffer> NullRHI::RHIAllocVertexBuffer(uint64_t vertexSize, uint64_t numVertices)
+{
+    return std::make_unique<RHIVertexBuffer>(std::make_unique<NullBuffer>(vertexSize * numVertices, ResourceType::STATIC));
+}
+
+std::unique_ptr<RHIIndexBuffer> NullRHI::RHIAllocIndexBuffer(uint64_t numIndices, Format indexFormat)
+{
+    uint64_t size;
+    if (indexFormat == Format::R32_UINT)
+    {
+        size = sizeof(uint32_t) * numIndices;
+    }
+    else if (indexFormat == Format::R16_UINT)
+    {
+        size = sizeof(uint16_t) * numIndices;
+    }
+    else
+    {
+        THROW_EXCEPTION(TEXT("invalid index format!"));
+    }
+    return std::make_unique<RHIIndexBuffer>(std::make_unique<NullBuffer>(size, ResourceType::STATIC));
+}
+
+std::unique_ptr<RHIFence> NullRHI::RHICreateFence()
+{
+    return std::make_unique<NullFence>();
+}
+
+std::unique_ptr<RHISwapChain> NullRHI::RHICreateSwapChain(const RHISwapChainDesc& desc)
+{
+    // zero means the window size on other platforms, there is no window here.
+    RHITextureDesc backBufferDesc = {desc.mFormat, TextureDimension::TEXTURE2D,
+        desc.mWidth ? desc.mWidth : DEFAULT_BACK_BUFFER_WIDTH, desc.mHeight ? desc.mHeight : DEFAULT_BACK_BUFFER_HEIGHT,
+        1, 1, desc.mMSAA, static_cast<uint8_t>(desc.mMSAA > 1 ? 1 : 0)};
+    return std::make_unique<NullSwapChain>(this, backBufferDesc, desc.mNumBackBuffers);
+}
+
+void NullRHI::RHIReleaseConstantBuffers(RHIConstantBuffer** pCBuffers, uint32_t numCBuffers)
+{
+    for (uint32_t i = 0; i < numCBuffers; ++i)
+    {
+        delete pCBuffers[i];
+        pCBuffers[i] = nullptr;
+    }
+}
+
+void NullRHI::RHIUpdateStagingBuffer(RHIStagingBuffer* pBuffer, const void* pData, uint64_t offset, uint64_t size)
+{
+    NullBuffer* pNativeBuffer = static_cast<NullBuffer*>(pBuffer->GetBuffer());
+    ASSERT(offset + size <= pNativeBuffer->BufferSize(), TEXT("staging buffer update out of range"));
+    memcpy(pNativeBuffer->Data() + offset, pData, size);
+}
+
+void NullRHI::RHIUpdateStagingTexture(RHIStagingBuffer* pStagingBuffer, const RHITextureDesc& desc, const void* pData, uint8_t mipmap)
+{
+    NullBuffer* pNativeBuffer = static_cast<NullBuffer*>(pStagingBuffer->GetBuffer());
+    memcpy(pNativeBuffer->Data(), pData, std::min<uint64_t>(NullTexture::CalculateMipSize(desc, mipmap), pNativeBuffer->BufferSize()));
+}
+
+void NullRHI::RHIUpdateConstantBuffer(RHIConstantBuffer* pBuffer, const void* pData, uint64_t offset, uint64_t size)
+{
+    NullBuffer* pNativeBuffer = static_cast<NullBuffer*>(pBuffer->GetBuffer());
+    ASSERT(offset + size <= pNativeBuffer->BufferSize(), TEXT("constant buffer update out of range"));
+    memcpy(pNativeBuffer->Data() + offset, pData, size);
+    mConstantBytesUploaded.fetch_add(size, std::memory_order_relaxed);
+}
+
+void NullRHI::RHICreateGraphicsContext(RHIGraphicsContext** ppContext)
+{
+    *ppContext = new NullGraphicsContext(this, mRecordCommands);
+}
+
+void NullRHI::RHICreateCopyContext(RHICopyContext** ppContext)
+{
+    *ppContext = new NullCopyContext();
+}
+
+void NullRHI::RHICreateComputeContext(RHIComputeContext** ppContext)
+{
+    *ppContext = new NullComputeContext();
+}
+
+void NullRHI::RHIResetGraphicsContext(RHIGraphicsContext* pContext)
+{
+    NullGraphicsContext* pNullContext = static_cast<NullGraphicsContext*>(pContext);
+    pNullContext->Reset();
+    pNullContext->mRecordCommands = mRecordCommands;
+}
+
+void NullRHI::RHIResetCopyContext(RHICopyContext* pContext) const
+{
+    static_cast<NullCopyContext*>(pContext)->Reset();
+}
+
+void NullRHI::RHISubmitRenderCommands(RHIGraphicsContext* pContext)
+{
+    NullGraphicsContext* pNullContext = static_cast<NullGraphicsContext*>(pContext);
+    mFrameStats += pNullContext->mStats;
+    ++mFrameStats.mCommandLists;
+    pNullContext->mStats = {};
+    if (mRecordCommands) mFrameCommandStream.insert(mFrameCommandStream.end(), pNullContext->mCommands.begin(), pNullContext->mCommands.end());
+}
+
+void NullRHI::RHISubmitCopyCommands(RHICopyContext* pContext)
+{
+    NullCopyContext* pNullContext = static_cast<NullCopyContext*>(pContext);
+    mFrameStats += pNullContext->mStats;
+    pNullContext->mStats = {};
+}
+
+void NullRHI::RHISyncGraphicContext(RHIFence* pFence, uint64_t semaphore)
+{
+    // submitted work has already been executed.
+    static_cast<NullFence*>(pFence)->Signal(semaphore);
+    mDescriptorRing.EndFrame(pFence, semaphore);
+    mDescriptorRing.Reclaim();
+}
+
+void NullRHI::RHISyncCopyContext(RHIFence* pFence, uint64_t semaphore)
+{
+    static_cast<NullFence*>(pFence)->Signal(semaphore);
+    mUploadRing.EndFrame(pFence, semaphore);
+}
+
+void NullRHI::RHIBatchCopyCommands(RHICopyContext** pContexts, uint32_t numContexts)
+{
+    for (uint32_t i = 0; i < numContexts; ++i)
+    {
+        RHISubmitCopyCommands(pContexts[i]);
+    }
+}
+
+void NullRHI::RHIReleaseGraphicsContext(RHIGraphicsContext* pContext)
+{
+    delete pContext;
+}
+
+void NullRHI::RHIReleaseCopyContext(RHICopyContext* pContext)
+{
+    delete pContext;
+}
+
+bool NullRHI::RHILoadPipelineStates(const void* pList, uint64_t listSize, const void* pLibrary, uint64_t librarySize)
+{
+    std::lock_guard<std::mutex> lock(mPipelineStateMutex);
+    return mPipelineStateList.Load(pList, listSize);
+}
+
+uint32_t NullRHI::RHIPrewarmPipelineStates(const RHIShader* pShader)
+{
+    std::vector<PipelineStateRecord> records;
+    std::lock_guard<std::mutex> lock(mPipelineStateMutex);
+    mPipelineStateList.GetRecords(pShader->GetHash(), records);
+    uint32_t numCreated = 0;
+    for (const PipelineStateRecord& record : records)
+    {
+        const uint64_t key = record.Key();
+        if (mPipelineStates.Find(key)) continue;
+        mPipelineStates.Insert(key, uint64_t{key});
+        ++numCreated;
+    }
+    return numCreated;
+}
+
+void NullRHI::RHISavePipelineStates(std::vector<uint8_t>& list, std::vector<uint8_t>& library)
+{
+    std::lock_guard<std::mutex> lock(mPipelineStateMutex);
+    list = mPipelineStateList.Serialize();
+    library.clear();
+}
+
+void NullRHI::RHISetBindlessConstantTables(RHIStaticConstantBuffer* pObjects, RHIStaticConstantBuffer* pMaterials, uint32_t stride)
+{
+    ASSERT(stride % 16 == 0 && pObjects->GetBuffer()->BufferSize() % stride == 0 && pMaterials->GetBuffer()->BufferSize() % stride == 0,
+           TEXT("bindless tables must hold whole elements"));
+    mBindlessObjects = pObjects;
+    mBindlessMaterials = pMaterials;
+    mBindlessStride = stride;
+}
+
+bool NullRHI::GetOrCreatePipelineState(const PipelineInitializer& initializer)
+{
+    const PipelineStateRecord record = PipelineStateRecord::FromInitializer(initializer);
+    const uint64_t key = record.Key();
+    std::lock_guard<std::mutex> lock(mPipelineStateMutex);
+    if (mPipelineStates.Find(key)) return false;
+    mPipelineStates.Insert(key, uint64_t{key});
+    mPipelineStateList.Add(record);
+    return true;
+}
+
+void NullRHI::EndFrame()
+{
+    {
+        std::lock_guard<std::mutex> lock(mPipelineStateMutex);
+        mPipelineStates.NextFrame();
+    }
+    mFrameStats.mBytesUploaded += mConstantBytesUploaded.exchange(0, std::memory_order_relaxed);
+    mLastFrameStats = mFrameStats;
+    mFrameStats = {};
+    mLastCommandStream.swap(mFrameCommandStream);
+    mFrameCommandStream.clear();
+}
+
+void NullRHI::Release()
+{
+    mLastCommandStream.clear();
+    mLastCommandStream.shrink_to_fit();
+    mFrameCommandStream.clear();
+    mFrameCommandStream.shrink_to_fit();
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include "NullGraphicsContext.h"
+#include "Engine/Render/DynamicRHI.h"
+#include "Engine/Render/PipelineStateCache.h"
+
+class NullRHI;
+
+// Back buffers are plain descriptors, Present only closes the frame statistics of the owning rhi.
+class NullSwapChain final : public RHISwapChain
+{
+public:
+    RHIRenderTarget* GetCurrentColorTexture() override { return mColorBuffers[mBackBufferIndex].get(); }
+    RHIRenderTarget* GetColorTexture(uint8_t backBufferIndex) override { return mColorBuffers[backBufferIndex].get(); }
+    RHITextureDesc GetBackBufferDesc() const override { return mColorBuffers[0]->GetTextureDesc(); }
+    void BeginFrame(RHIGraphicsContext* pContext) override { }
+    void EndFrame(RHIGraphicsContext* pContext) override { }
+    void Present() override;
+
+    NullSwapChain(NullRHI* pRHI, const RHITextureDesc& backBufferDesc, uint8_t numBackBuffers);
+
+private:
+    NullRHI* mRHI;
+    std::unique_ptr<std::unique_ptr<NullRenderTarget>[]> mColorBuffers;
+};
+
+// Headless rhi executing every resource operation in system memory.
+// Graphics contexts record a compact command stream and per-frame counters instead of talking to a driver,
+// which makes it possible to benchmark and regression test the cpu side of the renderer without a gpu.
+class NullRHI : public RHI
+{
+public:
+    static constexpr uint32_t DEFAULT_BACK_BUFFER_WIDTH = 1920;
+    static constexpr uint32_t DEFAULT_BACK_BUFFER_HEIGHT = 1080;
+    // transient descriptors of the online heap of the d3d12 rhi
+    static constexpr uint32_t ONLINE_DESCRIPTORS = 8192;
+    // bytes of the upload ring of the d3d12 rhi
+    static constexpr uint64_t UPLOAD_RING_SIZE = 64ull * 1024 * 1024;
+
+    void Initialize() override;
+    std::unique_ptr<RHIShader>          RHICompileShader(const Blob& binary, ShaderType activeTypes, const std::string* path = nullptr) override;
+    std::unique_ptr<RHIStagingBuffer>   RHIAllocStagingBuffer(uint64_t size) override;
+    std::unique_ptr<RHIStagingBuffer>   RHIAllocStagingTexture(const RHITextureDesc& desc, uint8_t mipmap) override;
+    std::unique_ptr<RHIStagingBuffer>   RHIAllocUploadBuffer(uint64_t size) override;
+    std::unique_ptr<RHIStagingBuffer>   RHIAllocUploadTexture(const RHITextureDesc& desc, uint8_t mipmap) override;
+    std::unique_ptr<RHIConstantBuffer>  RHIAllocConstantBuffer(uint64_t size) override;
+    std::unique_ptr<RHIStaticConstantBuffer> RHIAllocStaticConstantBuffer(uint64_t size) override;
+    std::unique_ptr<RHINativeTexture>   RHIAllocTexture(RHITextureDesc desc) override;
+    std::unique_ptr<RHIDepthStencil>    RHIAllocDepthStencil(RHITextureDesc desc) override;
+    std::unique_ptr<RHIRenderTarget>    RHIAllocRenderTarget(RHITextureDesc desc) override;
+    std::unique_ptr<RHIVertexBuffer>    RHIAllocVertexBuffer(uint64_t vertexSize, uint64_t numVertices) override;
+    std::unique_ptr<RHIIndexBuffer>     RHIAllocIndexBuffer(uint64_t numIndices, Format indexFormat) override;
+    std::unique_ptr<RHIFence>           RHICreateFence() override;
+    std::unique_ptr<RHISwapChain>       RHICreateSwapChain(const RHISwapChainDesc& desc) override;
+
+    void RHIReleaseConstantBuffers(RHIConstantBuffer** pCBuffers, uint32_t numCBuffers) override;
+    void RHIUpdateStagingBuffer(RHIStagingBuffer* pBuffer, const void* pData, uint64_t offset, uint64_t size) override;
+    void RHIUpdateStagingTexture(RHIStagingBuffer* pStagingBuffer, const RHITextureDesc& desc, const void* pData, uint8_t mipmap) override;
+    void RHIUpdateConstantBuffer(RHIConstantBuffer* pBuffer, const void* pData, uint64_t offset, uint64_t size) override;
+    void RHICreateGraphicsContext(RHIGraphicsContext** ppContext) override;
+    void RHICreateCopyContext(RHICopyContext** ppContext) override;
+    void RHICreateComputeContext(RHIComputeContext** ppContext) override;
+    void RHIResetGraphicsContext(RHIGraphicsContext* pContext) override;
+    void RHIResetCopyContext(RHICopyContext* pContext) const override;
+    void RHISubmitRenderCommands(RHIGraphicsContext* pContext) override;
+    void RHISubmitCopyCommands(RHICopyContext* pContext) override;
+    void RHISyncGraphicContext(RHIFence* pFence, uint64_t semaphore) override;
+    void RHISyncCopyContext(RHIFence* pFence, uint64_t semaphore) override;
+    void RHIBatchCopyCommands(RHICopyContext** pContexts, uint32_t numContexts) override;
+    void RHIReleaseGraphicsContext(RHIGraphicsContext* pContext) override;
+    void RHIReleaseCopyContext(RHICopyContext* pContext) override;
+    // there is no driver, the library is always empty.
+    bool RHILoadPipelineStates(const void* pList, uint64_t listSize, const void* pLibrary, uint64_t librarySize) override;
+    uint32_t RHIPrewarmPipelineStates(const RHIShader* pShader) override;
+    void RHISavePipelineStates(std::vector<uint8_t>& list, std::vector<uint8_t>& library) override;
+    void RHISetBindlessConstantTables(RHIStaticConstantBuffer* pObjects, RHIStaticConstantBuffer* pMaterials, uint32_t stride) override;
+    void Release() override;
+
+    // statistics of the last presented frame.
+    const NullFrameStats& GetLastFrameStats() const { return mLastFrameStats; }
+    // commands of all graphics contexts submitted in the last presented frame, in submission order.
+    // empty unless command recording is enabled.
+    const std::vector<NullCommand>& GetLastCommandStream() const { return mLastCommandStream; }
+    // counters are always collected, recording the command stream itself is opt-in as it costs a copy per submit.
+    void SetRecordCommands(bool recordCommands) { mRecordCommands = recordCommands; }
+    // called by the swap chain, folds the submitted work into the last frame statistics.
+    void EndFrame();
+    // called by the graphics contexts, true when the pipeline state was not cached and had to be created.
+    bool GetOrCreatePipelineState(const PipelineInitializer& initializer);
+    uint32_t GetNumCachedPipelineStates() const { return mPipelineStates.GetNumEntries(); }
+    // persistent descriptors written for the bindless tables, once per texture and table instead of per draw.
+    uint32_t GetNumBindlessDescriptors() const { return mNumBindlessTextures + (mBindlessObjects ? 2 : 0); }
+    uint32_t GetBindlessStride() const { return mBindlessStride; }
+    // stands in for the online descriptor heap, reclaimed by the fences of RHISyncGraphicContext.
+    FrameRingAllocator* GetDescriptorRing() { return &mDescriptorRing; }
+    // the upload ring only accounts for the staging memory, which lives in system memory. tests shrink it before
+    // the first upload to run out of it.
+    FrameRingAllocator* GetUploadRing() { return &mUploadRing; }
+
+    NullRHI();
+    ~NullRHI() override;
+
+private:
+    // builds shader properties from hlsl source, precompiled blobs carry no reflection data and yield none.
+    static void GetShaderProperties(const Blob& source, ShaderType visibility, std::vector<ShaderProp>& properties,
+        std::vector<ShaderVariable>& variables);
+
+    NullFrameStats mFrameStats;
+    NullFrameStats mLastFrameStats;
+    // constant buffers are written by every recording thread, folded into the frame statistics on EndFrame.
+    std::atomic<uint64_t> mConstantBytesUploaded;
+    FrameRingAllocator mDescriptorRing;
+    FrameRingAllocator mUploadRing;
+    std::vector<NullCommand> mFrameCommandStream;
+    std::vector<NullCommand> mLastCommandStream;
+    // the key stands in for the pipeline state object of a driver.
+    PipelineStateCache<uint64_t> mPipelineStates;
+    PipelineStateList mPipelineStateList;
+    // pipeline states are created by every recording thread.
+    std::mutex mPipelineStateMutex;
+    std::atomic<uint32_t> mNumBindlessTextures;
+    RHIStaticConstantBuffer* mBindlessObjects = nullptr;
+    RHIStaticConstantBuffer* mBindlessMaterials = nullptr;
+    uint32_t mBindlessStride = 0;
+    bool mRecordCommands;
+};
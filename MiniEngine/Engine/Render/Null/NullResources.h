@@ -0,0 +1,127 @@
+#pragma once
+#include <atomic>
+
+#include "Engine/Render/RHIDefination.h"
+#include "Engine/common/Exception.h"
+
+// System memory backed buffer. Transient buffers point into a context owned arena and do not own their storage.
+class NullBuffer final : public RHINativeBuffer
+{
+public:
+    uint32_t BufferSize() const override { return static_cast<uint32_t>(mDesc.mSize); }
+    void Release() override;
+    uint8_t* Data() const { return mData; }
+    NullBuffer(uint64_t size, ResourceType type);
+    NullBuffer(uint8_t* pTransient, uint64_t size, ResourceType type);
+    ~NullBuffer() override;
+
+private:
+    uint8_t* mData;
+    bool mOwnsData;
+};
+
+class NullTexture final : public RHINativeTexture
+{
+public:
+    void Release() override;
+    uint8_t* Data() const { return mData.get(); }
+    uint64_t DataSize() const { return mDataSize; }
+    // byte offset and size of the sub resource `mipmap`, array slices/depth are packed after each other per mip.
+    uint64_t MipOffset(uint8_t mipmap) const;
+    uint64_t MipSize(uint8_t mipmap) const;
+    explicit NullTexture(const RHITextureDesc& desc);
+
+    static uint64_t CalculateMipSize(const RHITextureDesc& desc, uint8_t mipmap);
+
+private:
+    std::unique_ptr<uint8_t[]> mData;
+    uint64_t mDataSize;
+};
+
+class NullRenderTarget final : public RHIRenderTarget
+{
+public:
+    void Release() override { }
+    explicit NullRenderTarget(const RHITextureDesc& desc) : RHIRenderTarget(desc) { }
+};
+
+class NullDepthStencil final : public RHIDepthStencil
+{
+public:
+    void Release() override { }
+    explicit NullDepthStencil(const RHITextureDesc& desc) : RHIDepthStencil(desc) { }
+};
+
+// Work is complete as soon as it is submitted, so the fence value simply follows the signals.
+class NullFence final : public RHIFence
+{
+public:
+    uint64_t GetValue() const override { return mValue.load(std::memory_order_acquire); }
+    void Wait(uint64_t value) const override { ASSERT(GetValue() >= value, TEXT("waiting on a fence value that was never signaled")); }
+    void Signal(uint64_t value) { mValue.store(value, std::memory_order_release); }
+    NullFence() = default;
+
+private:
+    std::atomic<uint64_t> mValue{0};
+};
+
+inline NullBuffer::NullBuffer(uint64_t size, ResourceType type) : RHINativeBuffer(RHIBufferDesc{size, type}),
+    mData(new uint8_t[size]), mOwnsData(true)
+{
+}
+
+inline NullBuffer::NullBuffer(uint8_t* pTransient, uint64_t size, ResourceType type) : RHINativeBuffer(RHIBufferDesc{size, type}),
+    mData(pTransient), mOwnsData(false)
+{
+}
+
+inline NullBuffer::~NullBuffer()
+{
+    Release();
+}
+
+inline void NullBuffer::Release()
+{
+    if (mOwnsData) delete[] mData;
+    mData = nullptr;
+    mOwnsData = false;
+}
+
+inline NullTexture::NullTexture(const RHITextureDesc& desc) : RHINativeTexture(desc), mDataSize(0)
+{
+    const uint8_t numMips = std::max<uint8_t>(desc.mMipLevels, 1);
+    for (uint8_t i = 0; i < numMips; ++i)
+    {
+        mDataSize += CalculateMipSize(desc, i);
+    }
+    mData.reset(new uint8_t[mDataSize]);
+}
+
+inline void NullTexture::Release()
+{
+    mData.reset();
+    mDataSize = 0;
+}
+
+inline uint64_t NullTexture::MipOffset(uint8_t mipmap) const
+{
+    uint64_t offset = 0;
+    for (uint8_t i = 0; i < mipmap; ++i)
+    {
+        offset += CalculateMipSize(mDesc, i);
+    }
+    return offset;
+}
+
+inline uint64_t NullTexture::MipSize(uint8_t mipmap) const
+{
+    return CalculateMipSize(mDesc, mipmap);
+}
+
+inline uint64_t NullTexture::CalculateMipSize(const RHITextureDesc& desc, uint8_t mipmap)
+{
+    const uint64_t width = std::max(1u, desc.mWidth >> mipmap);
+    const uint64_t height = std::max(1u, desc.mHeight >> mipmap);
+    const uint64_t depth = desc.mDimension == TextureDimension::TEXTURE3D ? std::max(1u, desc.mDepth >> mipmap) : std::max(1u, desc.mDepth);
+    return width * height * depth * std::max<uint16_t>(::GetFormatStride(desc.mFormat), 1);
+}
@@ -0,0 +1,83 @@
+#include "ObjectConstantPool.h"
+
+#include "Engine/common/Exception.h"
+
+void ObjectConstantPool::Initialize(RHI* pRHI, uint32_t numSlots)
+{
+    mRHI = pRHI;
+    mNumSlots = numSlots;
+    mBuffer = pRHI->RHIAllocStaticConstantBuffer(static_cast<uint64_t>(numSlots) * SLOT_SIZE);
+    mShadow.reset(new uint8_t[static_cast<size_t>(numSlots) * SLOT_SIZE]{});
+    mIsStale.assign(numSlots, 0);
+    mIsDirty.assign(numSlots, 0);
+    mDirtySlots.clear();
+    mFreeSlots.resize(numSlots);
+    // hand out the low slots first, they end up in longer runs
+    for (uint32_t i = 0; i < numSlots; ++i)
+    {
+        mFreeSlots[i] = numSlots - 1 - i;
+    }
+}
+
+uint32_t ObjectConstantPool::Allocate()
+{
+    if (mFreeSlots.empty()) return INVALID_SLOT;
+    uint32_t slot = mFreeSlots.back();
+    mFreeSlots.pop_back();
+    // the content is undefined until the owner writes it
+    mIsStale[slot] = 1;
+    return slot;
+}
+
+void ObjectConstantPool::Free(uint32_t slot)
+{
+    ASSERT(slot < mNumSlots, TEXT("object constant slot out of range"));
+    mFreeSlots.push_back(slot);
+}
+
+void ObjectConstantPool::Invalidate(uint32_t slot)
+{
+    ASSERT(slot < mNumSlots, TEXT("object constant slot out of range"));
+    mIsStale[slot] = 1;
+}
+
+void ObjectConstantPool::Update(uint32_t slot, const void* pData, uint32_t size)
+{
+    ASSERT(slot < mNumSlots && size <= SLOT_SIZE, TEXT("object constant slot out of range"));
+    memcpy(mShadow.get() + GetOffset(slot), pData, size);
+    mIsStale[slot] = 0;
+    if (!mIsDirty[slot])
+    {
+        mIsDirty[slot] = 1;
+        mDirtySlots.push_back(slot);
+    }
+}
+
+uint64_t ObjectConstantPool::Flush(RHIGraphicsContext* pContext)
+{
+    if (mDirtySlots.empty()) return 0;
+    std::sort(mDirtySlots.begin(), mDirtySlots.end());
+
+    const uint64_t uploadSize = static_cast<uint64_t>(mDirtySlots.size()) * SLOT_SIZE;
+    std::unique_ptr<RHIStagingBuffer> stagingBuffer = mRHI->RHIAllocStagingBuffer(uploadSize);
+    uint64_t stagingOffset = 0;
+    for (size_t begin = 0; begin < mDirtySlots.size();)
+    {
+        size_t end = begin + 1;
+        while (end < mDirtySlots.size() && mDirtySlots[end] == mDirtySlots[end - 1] + 1) ++end;
+
+        const uint64_t runSize = static_cast<uint64_t>(end - begin) * SLOT_SIZE;
+        const uint64_t dstOffset = GetOffset(mDirtySlots[begin]);
+        mRHI->RHIUpdateStagingBuffer(stagingBuffer.get(), mShadow.get() + dstOffset, stagingOffset, runSize);
+        pContext->UpdateBuffer(mBuffer.get(), stagingBuffer.get(), runSize, dstOffset, stagingOffset);
+        stagingOffset += runSize;
+        begin = end;
+    }
+
+    for (uint32_t slot : mDirtySlots)
+    {
+        mIsDirty[slot] = 0;
+    }
+    mDirtySlots.clear();
+    return uploadSize;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "DynamicRHI.h"
+
+// Persistent per object constants. Every object owns a fixed slot of one gpu local constant buffer for its lifetime.
+// Slots are only rewritten after their object invalidated them, which the renderer does for the transforms that moved,
+// and the rewritten slots are copied to the gpu coalesced into runs of neighbouring slots sharing one staging allocation.
+class ObjectConstantPool
+{
+public:
+    static constexpr uint32_t INVALID_SLOT = ~0u;
+    // placement alignment of constant buffer views
+    static constexpr uint32_t SLOT_SIZE = 256;
+
+    void Initialize(RHI* pRHI, uint32_t numSlots);
+    // returns INVALID_SLOT when the pool is exhausted.
+    uint32_t Allocate();
+    void Free(uint32_t slot);
+    // the content of the slot is out of date, new slots start out stale.
+    void Invalidate(uint32_t slot);
+    bool IsStale(uint32_t slot) const { return mIsStale[slot] != 0; }
+    // writes the cpu copy of a stale slot and schedules its upload.
+    void Update(uint32_t slot, const void* pData, uint32_t size);
+    // records the copies of the changed slots into `pContext`, has to happen before the draws reading them.
+    // returns the number of uploaded bytes.
+    uint64_t Flush(RHIGraphicsContext* pContext);
+
+    RHIStaticConstantBuffer* GetBuffer() const { return mBuffer.get(); }
+    static uint64_t GetOffset(uint32_t slot) { return static_cast<uint64_t>(slot) * SLOT_SIZE; }
+
+private:
+    RHI* mRHI = nullptr;
+    std::unique_ptr<RHIStaticConstantBuffer> mBuffer;
+    std::unique_ptr<uint8_t[]> mShadow;
+    std::vector<uint8_t> mIsStale;
+    std::vector<uint8_t> mIsDirty;
+    std::vector<uint32_t> mDirtySlots;
+    std::vector<uint32_t> mFreeSlots;
+    uint32_t mNumSlots = 0;
+};
@@ -8,11 +8,42 @@
 #include "Resource/D3D12Fence.h"
 #include "Resource/D3D12Resources.h"
 #include "Private/D3D12SwapChain.h"
+#include "Engine/Render/ShaderCache.h"
+#include "Engine/Utility/Telemetry/Telemetry.h"
+
+namespace
+{
+    // pitch and placement aligned size of the staging copy of a mip
+    uint64_t StagingTextureSize(const RHITextureDesc& desc, uint8_t mipmap)
+    {
+        uint16_t stride = ::GetFormatStride(desc.mFormat);
+        uint32_t width = std::max(1u, desc.mWidth >> mipmap);
+
+        uint32_t size;
+        switch (desc.mDimension)
+        {
+        case TextureDimension::TEXTURE1D:
+            size = ::AlignUpToMul<uint32_t, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT>()(stride * width);
+            break;
+        case TextureDimension::TEXTURE2D:
+            size = ::AlignUpToMul<uint32_t, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT>()(stride * width) * std::max(desc.mHeight >> mipmap, 1u);
+            size = ::AlignUpToMul<uint32_t, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT>()(size);
+            break;
+        case TextureDimension::TEXTURE3D:
+            size = ::AlignUpToMul<uint32_t, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT>()(stride * width) * std::max(desc.mHeight >> mipmap, 1u);
+            size = ::AlignUpToMul<uint32_t, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT>()(size) * std::max(desc.mDepth >> mipmap, 1u);
+            break;
+        default:
+            THROW_EXCEPTION(TEXT("texture not supported yet."));
+        }
+        return size;
+    }
+}
 
 void D3D12RHI::Initialize()
 {
     static constexpr uint8_t COMMAND_LIST_CAPACITY = 32;
-    static constexpr uint8_t COMMAND_ALLOCATOR_CAPACITY = 8;
+    static constexpr uint8_t COMMAND_ALLOCATOR_CAPACITY = 16;
     static constexpr uint8_t MAX_RENDER_TARGETS = 16;
     static constexpr uint8_t MAX_DEPTH_STENCIL = 16;
     static RootSignatureLayout GLOBAL_ROOT_SIG_LAYOUT = { 4, 3};
@@ -25,6 +56,7 @@ void D3D12RHI::Initialize()
     mRootSignatureManager.reset(new D3D12RootSignatureManager{});
     mCommandObjectPool.reset(new D3D12CommandObjectPool{});
     mStagingBufferAllocator.reset(new D3D12RingBufferAllocator{});
+    mUploadRingAllocator.reset(new D3D12UploadRingAllocator{});
     mRingCBufferAllocator.reset(new D3D12RingBufferAllocator{});
     mBuddyCBufferAllocator.reset(new D3D12BuddyBufferAllocator{});
 
@@ -43,6 +75,7 @@ void D3D12RHI::Initialize()
     mRingCBufferAllocator->Initialize(mDevice.get(), 64ull * 1024 * 1024); // TODO:
     mBuddyCBufferAllocator->Initialize(mDevice.get(), 2ull * 1024 * 1024); // TODO:
     mStagingBufferAllocator->Initialize(mDevice.get(), 64ull * 1024 * 1024);   // 64MB
+    mUploadRingAllocator->Initialize(mDevice.get(), 64ull * 1024 * 1024);   // 64MB
 
     mOnlineCBVSRVUAVAllocator.reset(new RingDescriptorAllocator{});
     mRTVAllocator.reset(new BlockDescriptorAllocator{});
@@ -62,7 +95,9 @@ void D3D12RHI::Initialize()
     // ------------------------------------------------------------------------
     
     // ------------------------D3D12DescriptorManager--------------------------
-    mOnlineCBVSRVUAVAllocator->Initialize(mDevice.get(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 8192, true);
+    mOnlineCBVSRVUAVAllocator->Initialize(mDevice.get(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+                                          8192 + BINDLESS_TABLE_DESCRIPTORS + MAX_BINDLESS_TEXTURES, true,
+                                          BINDLESS_TABLE_DESCRIPTORS + MAX_BINDLESS_TEXTURES);
     mRTVAllocator->Initialize(mDevice.get(), D3D12_DESCRIPTOR_HEAP_TYPE_RTV, MAX_RENDER_TARGETS, false);
     mDSVAllocator->Initialize(mDevice.get(), D3D12_DESCRIPTOR_HEAP_TYPE_DSV, MAX_DEPTH_STENCIL, false);
     // ------------------------------------------------------------------------
@@ -78,6 +113,7 @@ std::unique_ptr<RHIShader> D3D12RHI::RHICompileShader(const Blob& binary, Shader
 {
     std::vector<ShaderInput> inputs;
     std::unordered_set<ShaderProp> props;
+    std::vector<ShaderVariable> variables;
     RHIShader* pShader = new RHIShader();
     // pShader->BindShaderResources(Singleton<D3D12RootSignatureManager>::GetInstance().GetByIndex(0));   // TODO:
     UComPtr<ID3DBlob> vs;
@@ -85,42 +121,46 @@ std::unique_ptr<RHIShader> D3D12RHI::RHICompileShader(const Blob& binary, Shader
     UComPtr<ID3DBlob> ds;
     UComPtr<ID3DBlob> gs;
     UComPtr<ID3DBlob> ps;
-    const char* pathCStr = path ? path->c_str() : nullptr;
     if (activeTypes & ShaderType::VERTEX)
     {
-        vs = ::D3D12Compile(binary, "VsMain", "vs_5_0", pathCStr);
+        vs = CompileShaderStage(binary, 0, path);
         UComPtr<ID3D12ShaderReflection> pReflection;
         ThrowIfFailed(D3DReflect(vs->GetBufferPointer(), vs->GetBufferSize(), IID_PPV_ARGS(pReflection.GetAddressOf())));
         GetShaderProperties(ShaderType::VERTEX, pReflection.Get(), props);
+        GetShaderVariables(pReflection.Get(), variables);
         GetShaderInputElements(pReflection.Get(), inputs);
     }
     if (activeTypes & ShaderType::HULL)
     {
-        hs = ::D3D12Compile(binary, "HsMain", "hs_5_0", pathCStr);
+        hs = CompileShaderStage(binary, 1, path);
         UComPtr<ID3D12ShaderReflection> pReflection;
         ThrowIfFailed(D3DReflect(hs->GetBufferPointer(), hs->GetBufferSize(), IID_PPV_ARGS(pReflection.GetAddressOf())));
         GetShaderProperties(ShaderType::HULL, pReflection.Get(), props);
+        GetShaderVariables(pReflection.Get(), variables);
     }
     if (activeTypes & ShaderType::DOMAIN)
     {
-        ds = ::D3D12Compile(binary, "DsMain", "ds_5_0", pathCStr);
+        ds = CompileShaderStage(binary, 2, path);
         UComPtr<ID3D12ShaderReflection> pReflection;
         ThrowIfFailed(D3DReflect(ds->GetBufferPointer(), ds->GetBufferSize(), IID_PPV_ARGS(pReflection.GetAddressOf())));
         GetShaderProperties(ShaderType::DOMAIN, pReflection.Get(), props);
+        GetShaderVariables(pReflection.Get(), variables);
     }
     if (activeTypes & ShaderType::GEOMETRY)
     {
-        gs = ::D3D12Compile(binary, "GsMain", "gs_5_0", pathCStr);
+        gs = CompileShaderStage(binary, 3, path);
         UComPtr<ID3D12ShaderReflection> pReflection;
         ThrowIfFailed(D3DReflect(gs->GetBufferPointer(), gs->GetBufferSize(), IID_PPV_ARGS(pReflection.GetAddressOf())));
         GetShaderProperties(ShaderType::GEOMETRY, pReflection.Get(), props);
+        GetShaderVariables(pReflection.Get(), variables);
     }
     if (activeTypes & ShaderType::PIXEL)
     {
-        ps = ::D3D12Compile(binary, "PsMain", "ps_5_0", pathCStr);
+        ps = CompileShaderStage(binary, 4, path);
         UComPtr<ID3D12ShaderReflection> pReflection;
         ThrowIfFailed(D3DReflect(ps->GetBufferPointer(), ps->GetBufferSize(), IID_PPV_ARGS(pReflection.GetAddressOf())));
         GetShaderProperties(ShaderType::PIXEL, pReflection.Get(), props);
+        GetShaderVariables(pReflection.Get(), variables);
     }
     pShader->SetShaders(
         vs ? Blob{ vs->GetBufferPointer(), vs->GetBufferSize() } : Blob{ nullptr, 0 },
@@ -130,9 +170,34 @@ std::unique_ptr<RHIShader> D3D12RHI::RHICompileShader(const Blob& binary, Shader
         ps ? Blob{ ps->GetBufferPointer(), ps->GetBufferSize() } : Blob{ nullptr, 0 });
     pShader->SetShaderInputs(inputs);
     pShader->SetShaderProperties({props.begin(), props.end()});
+    pShader->SetShaderVariables(variables);
     return std::unique_ptr<RHIShader>(pShader);
 }
 
+UComPtr<ID3DBlob> D3D12RHI::CompileShaderStage(const Blob& binary, uint8_t stage, const std::string* path) const
+{
+    const ShaderCache::EntryPoint& entryPoint = ShaderCache::ENTRY_POINTS[stage];
+    uint64_t key = 0;
+    if (mShaderCache)
+    {
+        key = ShaderCache::ComputeKey(binary.Binary(), binary.Size(), path ? *path : std::string{}, entryPoint.mName,
+            entryPoint.mProfile, {}, ShaderCache::COMPILE_FLAGS, ShaderCache::ReadFile);
+        const void* pBytecode;
+        size_t size;
+        if (mShaderCache->Find(key, &pBytecode, &size))
+        {
+            ID3DBlob* pBlob;
+            ThrowIfFailed(D3DCreateBlob(size, &pBlob));
+            memcpy(pBlob->GetBufferPointer(), pBytecode, size);
+            TELEMETRY_COUNT(SHADER_CACHE_HITS, 1);
+            return { pBlob };
+        }
+    }
+    TELEMETRY_COUNT(SHADER_CACHE_MISSES, 1);
+    static_assert(ShaderCache::COMPILE_FLAGS == D3DCOMPILE_PACK_MATRIX_COLUMN_MAJOR, "the cached flags differ from the compiled ones");
+    return ::D3D12Compile(binary, entryPoint.mName, entryPoint.mProfile, path ? path->c_str() : nullptr, ShaderCache::COMPILE_FLAGS);
+}
+
 std::unique_ptr<RHIStagingBuffer> D3D12RHI::RHIAllocStagingBuffer(uint64_t size)
 {
     RHINativeBuffer* pCBuffer = new D3D12StagingBuffer(mStagingBufferAllocator->Allocate(size));
@@ -141,31 +206,24 @@ std::unique_ptr<RHIStagingBuffer> D3D12RHI::RHIAllocStagingBuffer(uint64_t size)
 
 std::unique_ptr<RHIStagingBuffer> D3D12RHI::RHIAllocStagingTexture(const RHITextureDesc& desc, uint8_t mipmap)
 {
-    TextureDimension dimension = desc.mDimension;
-    uint16_t stride = ::GetFormatStride(desc.mFormat);
-    uint32_t width = std::max(1u, desc.mWidth >> mipmap);
-
-    uint32_t size;
-    switch (dimension)
-    {
-    case TextureDimension::TEXTURE1D:
-        size = ::AlignUpToMul<uint32_t, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT>()(stride * width);
-        break;
-    case TextureDimension::TEXTURE2D:
-        size = ::AlignUpToMul<uint32_t, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT>()(stride * width) * std::max(desc.mHeight >> mipmap, 1u);
-        size = ::AlignUpToMul<uint32_t, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT>()(size);
-        break;
-    case TextureDimension::TEXTURE3D:
-        size = ::AlignUpToMul<uint32_t, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT>()(stride * width) * std::max(desc.mHeight >> mipmap, 1u);
-        size = ::AlignUpToMul<uint32_t, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT>()(size) * std::max(desc.mDepth >> mipmap, 1u);
-        break;
-    default:
-        THROW_EXCEPTION(TEXT("texture not supported yet."));
-    }
+    const uint64_t size = StagingTextureSize(desc, mipmap);
     RHINativeBuffer* pCBuffer = new D3D12StagingBuffer(mStagingBufferAllocator->AllocateAligned(size, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT));
     return std::make_unique<RHIStagingBuffer>(std::unique_ptr<RHINativeBuffer>(pCBuffer));
 }
 
+std::unique_ptr<RHIStagingBuffer> D3D12RHI::RHIAllocUploadBuffer(uint64_t size)
+{
+    Allocation allocation;
+    if (!mUploadRingAllocator->Allocate(size, allocation)) return nullptr;
+    RHINativeBuffer* pCBuffer = new D3D12StagingBuffer(allocation);
+    return std::make_unique<RHIStagingBuffer>(std::unique_ptr<RHINativeBuffer>(pCBuffer));
+}
+
+std::unique_ptr<RHIStagingBuffer> D3D12RHI::RHIAllocUploadTexture(const RHITextureDesc& desc, uint8_t mipmap)
+{
+    return RHIAllocUploadBuffer(StagingTextureSize(desc, mipmap));
+}
+
 std::unique_ptr<RHIConstantBuffer> D3D12RHI::RHIAllocConstantBuffer(uint64_t size)
  {
      RHINativeBuffer* pCBuffer = new D3D12ConstantBuffer(
@@ -174,6 +232,18 @@ std::unique_ptr<RHIConstantBuffer> D3D12RHI::RHIAllocConstantBuffer(uint64_t siz
      return std::make_unique<RHIConstantBuffer>(std::unique_ptr<RHINativeBuffer>(pCBuffer));
  }
 
+std::unique_ptr<RHIStaticConstantBuffer> D3D12RHI::RHIAllocStaticConstantBuffer(uint64_t size)
+{
+    size = ::AlignUpToMul<uint64_t, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT>()(size);
+    D3D12_HEAP_PROPERTIES prop = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+    D3D12_RESOURCE_DESC d3d12Desc = CD3DX12_RESOURCE_DESC::Buffer(size);
+    UComPtr<ID3D12Resource> pResource = mDevice->CreateCommitedResource(prop, D3D12_HEAP_FLAG_NONE, d3d12Desc, nullptr,
+        D3D12_RESOURCE_STATE_COMMON);
+    D3D12Buffer* pBuffer = new D3D12Buffer(std::move(pResource), RHIBufferDesc{ size, ResourceType::STATIC });
+    ResourceStateTracker::AppendResource(pBuffer->GetD3D12Resource(), ResourceState::COMMON);
+    return std::make_unique<RHIStaticConstantBuffer>(std::unique_ptr<RHINativeBuffer>(pBuffer));
+}
+
 std::unique_ptr<RHINativeTexture> D3D12RHI::RHIAllocTexture(RHITextureDesc desc)
 {
     D3D12_HEAP_PROPERTIES prop = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
@@ -196,6 +266,19 @@ std::unique_ptr<RHINativeTexture> D3D12RHI::RHIAllocTexture(RHITextureDesc desc)
                                                                         D3D12_RESOURCE_STATE_COMMON);
     D3D12Texture* pTexture = new D3D12Texture(std::move(pResource), desc);
     ResourceStateTracker::AppendResource(pTexture->GetD3D12Resource(), ResourceState::COMMON);
+    // slots are never recycled, the renderer never destroys its textures
+    const uint32_t index = mNumBindlessTextures.fetch_add(1);
+    if (index < MAX_BINDLESS_TEXTURES)
+    {
+        const D3D12DescriptorHandle handle = mOnlineCBVSRVUAVAllocator->GetPersistent(BINDLESS_TABLE_DESCRIPTORS + index);
+        mDevice->CreateShaderResourceView(pTexture->GetD3D12Resource()->D3D12ResourcePtr(), pTexture->GetSRVDesc(), handle.mCPUHandle);
+        pTexture->SetBindlessIndex(index);
+    }
+    else
+    {
+        mNumBindlessTextures = MAX_BINDLESS_TEXTURES;
+        WARN("bindless texture table is full, the texture can only be bound through descriptor tables!");
+    }
     return std::unique_ptr<D3D12Texture>(pTexture);
 }
 
@@ -389,7 +472,7 @@ void D3D12RHI::RHICreateCopyContext(RHICopyContext** ppContext)
     D3D12CopyContext* pD3D12CopyContext = new D3D12CopyContext{};
     //D3D12CopyCommandContext* pCommandContext = new D3D12CopyCommandContext();
     //pCommandContext->Initialize();
-    pD3D12CopyContext->Initialize(mStagingBufferAllocator->GetD3D12Resource(),
+    pD3D12CopyContext->Initialize(mUploadRingAllocator->GetD3D12Resource(),
                                   mCommandObjectPool->ObtainCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY));
     *ppContext = pD3D12CopyContext;
 }
@@ -408,10 +491,9 @@ void D3D12RHI::RHISubmitRenderCommands(RHIGraphicsContext* pContext)
 {
     D3D12GraphicsContext* pNativeContext = static_cast<D3D12GraphicsContext*>(pContext);
     ID3D12GraphicsCommandList* pCommandList = pNativeContext->mCommandList;
-    ResourceStateTracker& stateTracker = *pNativeContext->mResourceStateTracker;
     pCommandList->Close();
-    std::vector<D3D12_RESOURCE_BARRIER>&& barriers = stateTracker.BuildPreTransitions();
-    stateTracker.StopTracking(false);
+    // single pass over the resources of the list, submissions are serialized on this thread
+    std::vector<D3D12_RESOURCE_BARRIER>&& barriers = pNativeContext->mResourceStateTracker->Resolve(false);
     const auto& synchronizations = pNativeContext->mSynchronizes;
     for (const auto& synchronization : synchronizations)
     {
@@ -441,6 +523,43 @@ void D3D12RHI::RHISubmitRenderCommands(RHIGraphicsContext* pContext)
 void D3D12RHI::RHISyncGraphicContext(RHIFence* pFence, uint64_t semaphore)
 {
     mDirectQueue->Signal(static_cast<D3D12Fence*>(pFence)->GetD3D12Fence(), semaphore);
+    mPipelineStateManager->NextFrame();
+    mOnlineCBVSRVUAVAllocator->EndFrame(pFence, semaphore);
+}
+
+bool D3D12RHI::RHILoadPipelineStates(const void* pList, uint64_t listSize, const void* pLibrary, uint64_t librarySize)
+{
+    return mPipelineStateManager->LoadPipelineStates(pList, listSize, pLibrary, librarySize);
+}
+
+uint32_t D3D12RHI::RHIPrewarmPipelineStates(const RHIShader* pShader)
+{
+    // every graphics context binds the universal root signature
+    const D3D12RootSignature* pRootSignature = mRootSignatureManager->GetByIndex(0);
+    return mPipelineStateManager->PrewarmGraphicsPSOs(pRootSignature->mRootSignature.Get(), pShader);
+}
+
+void D3D12RHI::RHISavePipelineStates(std::vector<uint8_t>& list, std::vector<uint8_t>& library)
+{
+    mPipelineStateManager->SavePipelineStates(list, library);
+}
+
+void D3D12RHI::RHISetBindlessConstantTables(RHIStaticConstantBuffer* pObjects, RHIStaticConstantBuffer* pMaterials, uint32_t stride)
+{
+    RHIStaticConstantBuffer* tables[BINDLESS_TABLE_DESCRIPTORS] = { pObjects, pMaterials };
+    for (uint32_t i = 0; i < BINDLESS_TABLE_DESCRIPTORS; ++i)
+    {
+        const D3D12Resource* pResource = static_cast<D3D12Buffer*>(tables[i]->GetBuffer())->GetD3D12Resource();
+        const uint64_t size = tables[i]->GetBuffer()->BufferSize();
+        ASSERT(stride % 16 == 0 && size % stride == 0, TEXT("bindless tables must hold whole elements"));
+        D3D12_SHADER_RESOURCE_VIEW_DESC desc{};
+        desc.Format = DXGI_FORMAT_UNKNOWN;
+        desc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+        desc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        desc.Buffer = { 0, static_cast<UINT>(size / stride), stride, D3D12_BUFFER_SRV_FLAG_NONE };
+        mDevice->CreateShaderResourceView(pResource->D3D12ResourcePtr(), desc, mOnlineCBVSRVUAVAllocator->GetPersistent(i).mCPUHandle);
+        mCommandContext.mBindlessTables[i] = pResource;
+    }
 }
 
 void D3D12RHI::RHIResetCopyContext(RHICopyContext* pContext) const
@@ -454,8 +573,7 @@ void D3D12RHI::RHISubmitCopyCommands(RHICopyContext* pContext)
     D3D12CopyContext* pNativeContext = static_cast<D3D12CopyContext*>(pContext);
     ID3D12GraphicsCommandList* pCommandList = pNativeContext->mCommandList;
     pCommandList->Close();
-    std::vector<D3D12_RESOURCE_BARRIER>&& barriers = pNativeContext->mResourceStateTracker->BuildPreTransitions();
-    pNativeContext->mResourceStateTracker->StopTracking(true);
+    std::vector<D3D12_RESOURCE_BARRIER>&& barriers = pNativeContext->mResourceStateTracker->Resolve(true);
     const auto& synchronizations = pNativeContext->mSynchronizes;
     for (const auto& synchronization : synchronizations)
     {
@@ -482,62 +600,55 @@ void D3D12RHI::RHISubmitCopyCommands(RHICopyContext* pContext)
     mCommandObjectPool->ReleaseCommandList(D3D12_COMMAND_LIST_TYPE_COPY, pCommandList);
 }
 
-void D3D12RHI::RHISyncCopyContext(RHIFence* pFence, uint64_t semaphore) const
+void D3D12RHI::RHISyncCopyContext(RHIFence* pFence, uint64_t semaphore)
 {
     mCopyQueue->Signal(static_cast<D3D12Fence*>(pFence)->GetD3D12Fence(), semaphore);
+    mUploadRingAllocator->EndBatch(pFence, semaphore);
 }
 
 void D3D12RHI::RHIBatchCopyCommands(RHICopyContext** pContexts, uint32_t numContexts)
 {
-    D3D12CopyContext* pNativeContext = static_cast<D3D12CopyContext*>(pContexts[0]);
-    ID3D12CommandAllocator* pAllocator = pNativeContext->mCommandAllocator;
+    // a list of barriers may precede every list, the first slot is left for the pre-transitions of the batch
     ID3D12GraphicsCommandList** pCommandLists = new ID3D12GraphicsCommandList * [numContexts << 1];
-    uint32_t numCommandLists;
+    uint32_t numCommandLists = 1;
+    D3D12CopyContext* pNativeContext = nullptr;
+    for (uint32_t i = 0; i < numContexts; ++i)
+    {
+        D3D12CopyContext* pPrevious = pNativeContext;
+        pNativeContext = static_cast<D3D12CopyContext*>(pContexts[i]);
+        // the allocator records the barriers next, only one of its lists may be open at a time.
+        pNativeContext->mCommandList->Close();
+        if (pPrevious)
+        {
+            // the states the previous lists leave their resources in are known, the last tracker collects the first uses of the batch
+            std::vector<D3D12_RESOURCE_BARRIER>&& barriers = pNativeContext->mResourceStateTracker->Join(*pPrevious->mResourceStateTracker);
+            if (!barriers.empty())
+            {
+                ID3D12GraphicsCommandList* pBarriers = mCommandObjectPool->ObtainCommandList(D3D12_COMMAND_LIST_TYPE_COPY);
+                pBarriers->Reset(pNativeContext->mCommandAllocator, nullptr);
+                pBarriers->ResourceBarrier(barriers.size(), barriers.data());
+                pBarriers->Close();
+                pCommandLists[numCommandLists++] = pBarriers;
+            }
+        }
+        pCommandLists[numCommandLists++] = pNativeContext->mCommandList;
+        pNativeContext->mCommandList = nullptr;
+    }
 
-    std::vector<D3D12_RESOURCE_BARRIER>&& barriers = pNativeContext->mResourceStateTracker->BuildPreTransitions();
-    
-    // TODO: batch support
+    uint32_t firstCommandList = 1;
+    std::vector<D3D12_RESOURCE_BARRIER>&& barriers = pNativeContext->mResourceStateTracker->Resolve(true);
 	if (!barriers.empty())
 	{
 	    pCommandLists[0] = mCommandObjectPool->ObtainCommandList(D3D12_COMMAND_LIST_TYPE_COPY);
-	    pCommandLists[0]->Reset(pAllocator, nullptr);
+	    pCommandLists[0]->Reset(pNativeContext->mCommandAllocator, nullptr);
 	    pCommandLists[0]->ResourceBarrier(barriers.size(), barriers.data());
 	    pCommandLists[0]->Close();
-	    pCommandLists[1] = pNativeContext->mCommandList;
-        numCommandLists = 2;
+        firstCommandList = 0;
 	}
-	else
-	{
-	    pCommandLists[0] = pNativeContext->mCommandList;
-        numCommandLists = 1;
-	}
-    pNativeContext->mCommandList = nullptr;
-
-	for (int i = 1; i < numContexts; ++i)
-	{
-	    ResourceStateTracker& prev = *pNativeContext->mResourceStateTracker;
-        pNativeContext = static_cast<D3D12CopyContext*>(pContexts[i]);
-	    ResourceStateTracker& next = *pNativeContext->mResourceStateTracker;
-	    barriers = prev.Join(next);
-	    ID3D12GraphicsCommandList* pCommandList = pNativeContext->mCommandList;
-	    pAllocator = pNativeContext->mCommandAllocator;
-	    pCommandList->Close();
-	    if (!barriers.empty())
-	    {
-	        pCommandLists[numCommandLists++] = pCommandList;
-	        pCommandList = mCommandObjectPool->ObtainCommandList(D3D12_COMMAND_LIST_TYPE_COPY);
-	        pCommandList->Reset(pAllocator, nullptr);
-	        pCommandList->ResourceBarrier(barriers.size(), barriers.data());
-	        pCommandList->Close();
-	    }
-	    pCommandLists[numCommandLists++] = pCommandList;
-        pNativeContext->mCommandList = nullptr;
-	}
-    pNativeContext->mResourceStateTracker->StopTracking(true);
 
-	mCopyQueue->ExecuteCommandLists(numCommandLists, CommandListCast(pCommandLists));
+	mCopyQueue->ExecuteCommandLists(numCommandLists - firstCommandList, CommandListCast(pCommandLists + firstCommandList));
 
-	for (uint8_t i = 0; i < numCommandLists; ++i)
+	for (uint32_t i = firstCommandList; i < numCommandLists; ++i)
 	{
 	    mCommandObjectPool->ReleaseCommandList(D3D12_COMMAND_LIST_TYPE_COPY, pCommandLists[i]);
 	}
@@ -595,6 +706,51 @@ D3D12RHI::~D3D12RHI()
     D3D12RHI::Release();
 }
 
+void D3D12RHI::GetShaderVariables(ID3D12ShaderReflection* pReflector, std::vector<ShaderVariable>& variables)
+{
+    D3D12_SHADER_DESC shaderDesc;
+    pReflector->GetDesc(&shaderDesc);
+    for (uint32_t i = 0; i < shaderDesc.ConstantBuffers; ++i)
+    {
+        ID3D12ShaderReflectionConstantBuffer* pCBuffer = pReflector->GetConstantBufferByIndex(i);
+        D3D12_SHADER_BUFFER_DESC bufferDesc;
+        pCBuffer->GetDesc(&bufferDesc);
+        D3D12_SHADER_INPUT_BIND_DESC bindingDesc;
+        if (FAILED(pReflector->GetResourceBindingDescByName(bufferDesc.Name, &bindingDesc))) continue;
+        if (bufferDesc.Type == D3D_CT_RESOURCE_BIND_INFO && strcmp(bufferDesc.Name, "MaterialTable") == 0)
+        {
+            // the single variable of a structured buffer is its element, the members are the material variables
+            ID3D12ShaderReflectionType* pElement = pCBuffer->GetVariableByIndex(0)->GetType();
+            D3D12_SHADER_TYPE_DESC elementDesc;
+            pElement->GetDesc(&elementDesc);
+            for (uint32_t j = 0; j < elementDesc.Members; ++j)
+            {
+                D3D12_SHADER_TYPE_DESC memberDesc;
+                pElement->GetMemberTypeByIndex(j)->GetDesc(&memberDesc);
+                const char* name = pElement->GetMemberTypeName(j);
+                const bool isKnown = std::any_of(variables.begin(), variables.end(), [&](const ShaderVariable& variable)
+                    { return variable.mRegister == ShaderVariable::MATERIAL_TABLE && variable.mName == name; });
+                if (isKnown) continue;
+                const uint32_t size = memberDesc.Rows * memberDesc.Columns * 4 * std::max<uint32_t>(memberDesc.Elements, 1);
+                variables.push_back({ name, ShaderVariable::MATERIAL_TABLE, memberDesc.Offset, size });
+            }
+            continue;
+        }
+        // the bindless tables of register spaces above 0 are not material constants
+        if (bufferDesc.Type != D3D_CT_CBUFFER || bindingDesc.Space != 0) continue;
+        for (uint32_t j = 0; j < bufferDesc.Variables; ++j)
+        {
+            D3D12_SHADER_VARIABLE_DESC variableDesc;
+            pCBuffer->GetVariableByIndex(j)->GetDesc(&variableDesc);
+            // stages sharing a constant buffer report its variables again
+            const bool isKnown = std::any_of(variables.begin(), variables.end(), [&](const ShaderVariable& variable)
+                { return variable.mRegister == bindingDesc.BindPoint && variable.mName == variableDesc.Name; });
+            if (isKnown) continue;
+            variables.push_back({ variableDesc.Name, static_cast<uint8_t>(bindingDesc.BindPoint), variableDesc.StartOffset, variableDesc.Size });
+        }
+    }
+}
+
 void D3D12RHI::GetShaderProperties(ShaderType type, ID3D12ShaderReflection* pReflector, std::unordered_set<ShaderProp>& properties)
 {
     D3D12_SHADER_DESC shaderDesc;
@@ -604,6 +760,8 @@ void D3D12RHI::GetShaderProperties(ShaderType type, ID3D12ShaderReflection* pRef
     for (uint32_t i = 0; i < shaderDesc.BoundResources; ++i)
     {
         pReflector->GetResourceBindingDesc(i, &bindingDesc);
+        // the bindless tables are bound by the renderer, only the material table describes the material
+        if (bindingDesc.Space != 0 && strcmp(bindingDesc.Name, "MaterialTable") != 0) continue;
         ShaderProp property{};
         property.mRegister = bindingDesc.BindPoint;
         property.mName = bindingDesc.Name;
@@ -623,6 +781,11 @@ void D3D12RHI::GetShaderProperties(ShaderType type, ID3D12ShaderReflection* pRef
             property.mType = ShaderPropType::TEXTURE;
             property.mInfo.mTextureDimension = ::ConvertFromD3DSRVFormat(bindingDesc.Dimension);
             break;
+        case D3D_SIT_STRUCTURED:
+            property.mType = ShaderPropType::STRUCTURED_BUFFER;
+            // the reflection reports the element stride of structured buffers in NumSamples
+            property.mInfo.mCBufferSize = bindingDesc.NumSamples;
+            break;
         case D3D_SIT_SAMPLER:
             property.mType = ShaderPropType::SAMPLER;
             // TODO:
@@ -773,8 +936,8 @@ void D3D12RHI::BuildGlobalRootSignature(const RootSignatureLayout& layout, std::
                                             D3D12_STATIC_SAMPLER_DESC>& samplers) const
 {
     // CreateGlobalRootSignature
-    ranges.reset(new CD3DX12_DESCRIPTOR_RANGE1[2]);
-    params.resize(3);
+    ranges.reset(new CD3DX12_DESCRIPTOR_RANGE1[4]);
+    params.resize(5);
 
     // pass constants
     params[0].InitAsConstantBufferView(0, 0, D3D12_ROOT_DESCRIPTOR_FLAG_NONE);
@@ -784,6 +947,14 @@ void D3D12RHI::BuildGlobalRootSignature(const RootSignatureLayout& layout, std::
     ranges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, layout.mNumMaterialConstants, 2);
     ranges[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, layout.mNumTextures, 0);
     params[2].InitAsDescriptorTable(2, ranges.get());
+    // bindless draws: the object and material element, b0 space1
+    params[3].InitAsConstants(2, 0, 1);
+    // | object table, material table (t0 space1) | all textures (t0 space2) |, the persistent head of the online heap.
+    // textures are appended while the table is bound, so the descriptors are volatile.
+    ranges[2].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, BINDLESS_TABLE_DESCRIPTORS, 0, 1, D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE, 0);
+    ranges[3].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, MAX_BINDLESS_TEXTURES, 0, 2, D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE,
+                   BINDLESS_TABLE_DESCRIPTORS);
+    params[4].InitAsDescriptorTable(2, ranges.get() + 2);
     
     samplers = GetStaticSamplers();
 }
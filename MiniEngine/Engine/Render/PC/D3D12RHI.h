@@ -6,6 +6,7 @@
 
 class D3D12Fence;
 class D3D12RingBufferAllocator;
+class D3D12UploadRingAllocator;
 class D3D12PipelineStateManager;
 class D3D12BuddyBufferAllocator;
 class RingDescriptorAllocator;
@@ -19,7 +20,10 @@ public:
     std::unique_ptr<RHIShader>          RHICompileShader(const Blob& binary, ShaderType activeTypes, const std::string* path = nullptr) override;
     std::unique_ptr<RHIStagingBuffer>   RHIAllocStagingBuffer(uint64_t size) override;
     std::unique_ptr<RHIStagingBuffer>   RHIAllocStagingTexture(const RHITextureDesc& desc, uint8_t mipmap) override;
+    std::unique_ptr<RHIStagingBuffer>   RHIAllocUploadBuffer(uint64_t size) override;
+    std::unique_ptr<RHIStagingBuffer>   RHIAllocUploadTexture(const RHITextureDesc& desc, uint8_t mipmap) override;
     std::unique_ptr<RHIConstantBuffer>  RHIAllocConstantBuffer(uint64_t size) override;
+    std::unique_ptr<RHIStaticConstantBuffer> RHIAllocStaticConstantBuffer(uint64_t size) override;
     std::unique_ptr<RHINativeTexture>   RHIAllocTexture(RHITextureDesc desc) override;
     std::unique_ptr<RHIDepthStencil>    RHIAllocDepthStencil(RHITextureDesc desc) override;
     std::unique_ptr<RHIRenderTarget>    RHIAllocRenderTarget(RHITextureDesc desc) override;
@@ -42,10 +46,14 @@ public:
     void RHISubmitRenderCommands(RHIGraphicsContext* pContext) override;
     void RHISubmitCopyCommands(RHICopyContext* pContext) override;
     void RHISyncGraphicContext(RHIFence* pFence, uint64_t semaphore) override;
-    void RHISyncCopyContext(RHIFence* pFence, uint64_t semaphore) const override;
+    void RHISyncCopyContext(RHIFence* pFence, uint64_t semaphore) override;
     void RHIBatchCopyCommands(RHICopyContext** pContexts, uint32_t numContexts) override;
     void RHIReleaseGraphicsContext(RHIGraphicsContext* pContext) override;
     void RHIReleaseCopyContext(RHICopyContext* pContext) override;
+    bool RHILoadPipelineStates(const void* pList, uint64_t listSize, const void* pLibrary, uint64_t librarySize) override;
+    uint32_t RHIPrewarmPipelineStates(const RHIShader* pShader) override;
+    void RHISavePipelineStates(std::vector<uint8_t>& list, std::vector<uint8_t>& library) override;
+    void RHISetBindlessConstantTables(RHIStaticConstantBuffer* pObjects, RHIStaticConstantBuffer* pMaterials, uint32_t stride) override;
     //void Present(RHISwapChain* pSwapChain) override;
     void Release() override;
 	ID3D12CommandQueue* D3D12RHI::GetCommandQueue() const;
@@ -56,6 +64,9 @@ public:
     ~D3D12RHI() override;
 
 private:
+    // object and material table at the head of the online heap, followed by the textures
+    static constexpr uint32_t BINDLESS_TABLE_DESCRIPTORS = 2;
+
     //struct BatchTask
     //{
 	   // BatchTask() = default;
@@ -75,7 +86,10 @@ private:
     //    uint64_t mSemaphore;
     //};
 
+    // bytecode of the stage from the shader cache, compiled when it misses. `stage` indexes ShaderCache::ENTRY_POINTS.
+    UComPtr<ID3DBlob> CompileShaderStage(const Blob& binary, uint8_t stage, const std::string* path) const;
     static void GetShaderProperties(ShaderType type, ID3D12ShaderReflection* pReflector, std::unordered_set<ShaderProp>& properties);
+    static void GetShaderVariables(ID3D12ShaderReflection* pReflector, std::vector<ShaderVariable>& variables);
     static void GetShaderInputElements(ID3D12ShaderReflection* pReflector, std::vector<ShaderInput>& inputElements);
     static Format GetFormatFromSignature(const D3D12_SIGNATURE_PARAMETER_DESC& paramDesc);
     void BuildGlobalRootSignature(const RootSignatureLayout& layout, std::unique_ptr<CD3DX12_DESCRIPTOR_RANGE1[]>& ranges, std::vector<CD3DX12_ROOT_PARAMETER1>& params, std::vector<
@@ -92,6 +106,8 @@ private:
     std::unique_ptr<D3D12RingBufferAllocator>       mRingCBufferAllocator;
     std::unique_ptr<D3D12BuddyBufferAllocator>      mBuddyCBufferAllocator;
     std::unique_ptr<D3D12RingBufferAllocator>       mStagingBufferAllocator;
+    // staging memory of the copy contexts, fenced by the copy queue instead of overwritten by the frame uploads
+    std::unique_ptr<D3D12UploadRingAllocator>       mUploadRingAllocator;
     std::unique_ptr<D3D12CommandObjectPool>         mCommandObjectPool;
     std::unique_ptr<D3D12RootSignatureManager>      mRootSignatureManager;
     std::unique_ptr<D3D12PipelineStateManager>      mPipelineStateManager;
@@ -100,6 +116,7 @@ private:
     UComPtr<ID3D12CommandQueue> mCopyQueue;
     UComPtr<ID3D12CommandQueue> mComputeQueue;
     D3D12CommandContext mCommandContext;
+    std::atomic<uint32_t> mNumBindlessTextures{ 0 };
 
     //std::unordered_map<uint64_t, std::vector<ID3D12CommandAllocator*>> mActiveAllocators;
 };
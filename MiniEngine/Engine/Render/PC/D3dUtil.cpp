@@ -110,13 +110,13 @@ bool ImplicitTransition(const uint32_t stateBefore, uint32_t& stateAfter,
 
 }
 
-UComPtr<ID3DBlob> D3D12Compile(const Blob& blob, const char* entry, const char* pTarget, const char* file)
+UComPtr<ID3DBlob> D3D12Compile(const Blob& blob, const char* entry, const char* pTarget, const char* file, uint32_t flags)
 {
     ID3DBlob* bin;
     ID3DBlob* error;
     if (FAILED(D3DCompile(blob.Binary(), blob.Size(), file, nullptr,
         D3D_COMPILE_STANDARD_FILE_INCLUDE, entry, pTarget,
-        D3DCOMPILE_PACK_MATRIX_COLUMN_MAJOR, 0, &bin, &error)))
+        flags, 0, &bin, &error)))
     {
         OutputDebugStringA(static_cast<char*>(error->GetBufferPointer()));
         error->Release();
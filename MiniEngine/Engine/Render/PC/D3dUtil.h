@@ -227,7 +227,8 @@ D3D12_GRAPHICS_PIPELINE_STATE_DESC DefaultPipelineStateDesc();
 uint64_t GetConstantsBufferSize(ID3D12ShaderReflection* pReflector, const std::string& name);
 uint64_t GetConstantsBufferSize(ID3D12ShaderReflection* pReflector, const std::wstring& name);
 bool ImplicitTransition(uint32_t stateBefore, uint32_t& stateAfter, bool isBufferOrSimultaneous);
-UComPtr<ID3DBlob> D3D12Compile(const Blob& blob, const char* entry, const char* pTarget, const char* file);
+// `flags` are D3DCOMPILE_* flags, they are part of the shader cache key.
+UComPtr<ID3DBlob> D3D12Compile(const Blob& blob, const char* entry, const char* pTarget, const char* file, uint32_t flags);
 void CopyTextureDataWithPitchAlignment(
 	void* pDest,
 	// 上传堆中映射的内存地址（起始指针）
@@ -7,6 +7,7 @@
 #include "Engine/memory/BuddyAllocator.h"
 #include "Engine/memory/LinearAllocator.h"
 #include "Engine/memory/RingAllocator.h"
+#include "Engine/Render/FrameRingAllocator.h"
 
 struct Allocation
 {
@@ -62,6 +63,30 @@ private:
     void* mCPUVirtualAddress;
     D3D12_GPU_VIRTUAL_ADDRESS mBaseGPUVirtualAddress;
     UnsafeRingAllocator mRingAllocator;
+    // graphics contexts recorded by worker threads allocate frame constants concurrently.
+    std::mutex mMutex;
+};
+
+// Staging memory of the copy queue. Allocations are placement aligned and stay in use until the fence of the batch
+// reading them passed, see EndBatch.
+class D3D12UploadRingAllocator : NonCopyable
+{
+public:
+    void Initialize(D3D12Device* pDevice, uint64_t poolSize);
+    const D3D12Resource* GetD3D12Resource() const;
+    // false while the batches in flight hold the rest of the ring or `size` exceeds the whole ring.
+    bool Allocate(uint64_t size, Allocation& allocation);
+    void EndBatch(const RHIFence* pFence, uint64_t semaphore);
+    D3D12UploadRingAllocator();
+    ~D3D12UploadRingAllocator();
+
+private:
+    D3D12Device* mDevice;
+    std::unique_ptr<D3D12Resource> mResource;
+    void* mCPUVirtualAddress;
+    D3D12_GPU_VIRTUAL_ADDRESS mBaseGPUVirtualAddress;
+    // in units of D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT
+    FrameRingAllocator mRingAllocator;
 };
 
 class D3D12BuddyBufferAllocator : NonCopyable
@@ -234,7 +259,11 @@ inline const D3D12Resource* D3D12RingBufferAllocator::GetD3D12Resource() const
 inline Allocation D3D12RingBufferAllocator::Allocate(uint64_t size)
 {
     // Constant buffers must be 256-byte aligned
-    uint64_t offset = mRingAllocator.Allocate(size);
+    uint64_t offset;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        offset = mRingAllocator.Allocate(size);
+    }
     if (offset == MAXUINT64) WARN("failed to allocate constant buffer");
     Allocation allocation;
     allocation.mGPUAddress = mBaseGPUVirtualAddress + offset;
@@ -248,7 +277,11 @@ inline Allocation D3D12RingBufferAllocator::Allocate(uint64_t size)
 inline Allocation D3D12RingBufferAllocator::AllocateAligned(uint64_t size, uint64_t alignment)
 {
     // Constant buffers must be 256-byte aligned
-    uint64_t offset = mRingAllocator.AllocateAligned(size, alignment);
+    uint64_t offset;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        offset = mRingAllocator.AllocateAligned(size, alignment);
+    }
     if (offset == MAXUINT64) WARN("failed to allocate constant buffer");
     Allocation allocation;
     allocation.mGPUAddress = mBaseGPUVirtualAddress + offset;
@@ -266,6 +299,7 @@ inline uint64_t D3D12RingBufferAllocator::GetTotalSize() const
 
 inline void D3D12RingBufferAllocator::Reset()
 {
+    std::lock_guard<std::mutex> lock(mMutex);
     mRingAllocator.Reset();
 }
 
@@ -280,6 +314,79 @@ inline D3D12RingBufferAllocator::~D3D12RingBufferAllocator()
     }
 }
 
+inline void D3D12UploadRingAllocator::Initialize(D3D12Device* pDevice, uint64_t poolSize)
+{
+    mDevice = pDevice;
+    poolSize = AlignUpToMul<uint64_t, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT>()(poolSize);
+    mRingAllocator.Initialize(poolSize / D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, MemoryTag::RENDER, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+
+    D3D12_RESOURCE_DESC desc;
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Alignment = 0;
+    desc.Width = poolSize;
+    desc.Height = 1;
+    desc.DepthOrArraySize = 1;
+    desc.MipLevels = 1;
+    desc.Format = DXGI_FORMAT_UNKNOWN;
+    desc.SampleDesc.Count = 1;
+    desc.SampleDesc.Quality = 0;
+    desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+    D3D12_HEAP_PROPERTIES heapProps;
+    heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+    heapProps.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+    heapProps.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+    heapProps.CreationNodeMask = 1;
+    heapProps.VisibleNodeMask = 1;
+
+    mResource = std::make_unique<D3D12Resource>(mDevice->CreateCommitedResource(heapProps, D3D12_HEAP_FLAG_NONE, desc, nullptr, D3D12_RESOURCE_STATE_GENERIC_READ));
+
+    if (FAILED(mResource->D3D12ResourcePtr()->Map(0, nullptr, &mCPUVirtualAddress)))
+    {
+        mResource->D3D12ResourcePtr()->Release();
+        THROW_EXCEPTION(TEXT("Failed to map upload buffer resource"));
+    }
+
+    mBaseGPUVirtualAddress = mResource->GetGPUVirtualAddress();
+}
+
+inline const D3D12Resource* D3D12UploadRingAllocator::GetD3D12Resource() const
+{ return mResource.get(); }
+
+inline bool D3D12UploadRingAllocator::Allocate(uint64_t size, Allocation& allocation)
+{
+    const uint64_t units = ::AlignUpToMul<uint64_t, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT>()(size) / D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+    if (units == 0 || units > mRingAllocator.GetTotalSize()) return false;
+    uint64_t offset = mRingAllocator.Allocate(units);
+    if (offset == FrameRingAllocator::INVALID_OFFSET && mRingAllocator.Reclaim() > 0) offset = mRingAllocator.Allocate(units);
+    if (offset == FrameRingAllocator::INVALID_OFFSET) return false;
+
+    offset *= D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+    allocation.mGPUAddress = mBaseGPUVirtualAddress + offset;
+    allocation.mCPUAddress = static_cast<uint8_t*>(mCPUVirtualAddress) + offset;
+    allocation.mOffset = offset;
+    allocation.mSize = size;
+    return true;
+}
+
+inline void D3D12UploadRingAllocator::EndBatch(const RHIFence* pFence, uint64_t semaphore)
+{
+    mRingAllocator.EndFrame(pFence, semaphore);
+}
+
+inline D3D12UploadRingAllocator::D3D12UploadRingAllocator() : mDevice(nullptr), mCPUVirtualAddress(nullptr), mBaseGPUVirtualAddress(0)
+{ }
+
+inline D3D12UploadRingAllocator::~D3D12UploadRingAllocator()
+{
+    if (mResource)
+    {
+        mResource->D3D12ResourcePtr()->Unmap(0, nullptr);
+        mResource.reset();
+    }
+}
+
 inline void D3D12BuddyBufferAllocator::Initialize(D3D12Device* pDevice, uint64_t poolSize)
 {
     mDevice = pDevice;
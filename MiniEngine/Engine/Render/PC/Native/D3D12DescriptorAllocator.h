@@ -5,6 +5,7 @@
 #include "Engine/memory/LinearAllocator.h"
 #include "Engine/memory/BlockAllocator.h"
 #include "Engine/memory/RingAllocator.h"
+#include "Engine/Render/FrameRingAllocator.h"
 
 struct D3D12DescriptorHandle
 {
@@ -35,27 +36,35 @@ private:
     std::mutex mMutex;
 };
 
+// the first numPersistent descriptors of the heap are reserved for tables living as long as the allocator,
+// the ring cycles through the rest. transient descriptors are lock-free and reclaimed by EndFrame once the gpu is
+// done with them, recording threads allocate through a FrameRingCache of the ring.
 class RingDescriptorAllocator
 {
 public:
-    void Initialize(D3D12Device* pDevice, D3D12_DESCRIPTOR_HEAP_TYPE heapType, uint32_t descriptorCount, bool shaderVisible = false);
+    void Initialize(D3D12Device* pDevice, D3D12_DESCRIPTOR_HEAP_TYPE heapType, uint32_t descriptorCount, bool shaderVisible = false,
+                    uint32_t numPersistent = 0);
+    D3D12DescriptorHandle GetPersistent(uint32_t index) const;
     // 分配单个描述符
     D3D12DescriptorHandle Allocate();
     // 分配连续多个描述符
     std::unique_ptr<D3D12DescriptorHandle[]> Allocate(uint32_t count);
-    void Reset();
+    // handles of `count` descriptors from `offset` of the ring.
+    std::unique_ptr<D3D12DescriptorHandle[]> GetHandles(uint64_t offset, uint32_t count) const;
+    // the descriptors allocated so far are in use until `pFence` reaches `semaphore`.
+    void EndFrame(const RHIFence* pFence, uint64_t semaphore);
+    FrameRingAllocator* GetRing();
     D3D12DescriptorHeap* GetHeap() const;
     RingDescriptorAllocator();
 
 private:
     D3D12Device* mDevice;
     std::unique_ptr<D3D12DescriptorHeap> mHeap;
-    UnsafeRingAllocator mAllocator;
+    FrameRingAllocator mAllocator;
+    uint32_t mNumPersistent = 0;
     
     D3D12_CPU_DESCRIPTOR_HANDLE mCPUStart;
     D3D12_GPU_DESCRIPTOR_HANDLE mGPUStart;
-    
-    std::mutex mMutex;
 };
 
 class BlockDescriptorAllocator
@@ -92,7 +101,7 @@ inline void LinearDescriptorAllocator::Initialize(D3D12Device* pDevice, D3D12_DE
                       ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE
                       : D3D12_DESCRIPTOR_HEAP_FLAG_NONE, descriptorCount),
         pDevice->GetD3D12Device()->GetDescriptorHandleIncrementSize(heapType)));
-    mAllocator.Initialize(descriptorCount);
+    mAllocator.Initialize(descriptorCount, MemoryTag::RENDER, mHeap->DescriptorSize());
 
     mCPUStart = mHeap->CPUHandle(0);
     mGPUStart = shaderVisible ? mHeap->GPUHandle(0) : D3D12_GPU_DESCRIPTOR_HANDLE{0};
@@ -136,59 +145,66 @@ inline D3D12DescriptorHeap* LinearDescriptorAllocator::GetHeap() const
 inline LinearDescriptorAllocator::LinearDescriptorAllocator() = default;
 
 inline void RingDescriptorAllocator::Initialize(D3D12Device* pDevice, D3D12_DESCRIPTOR_HEAP_TYPE heapType,
-    uint32_t descriptorCount, bool shaderVisible)
+    uint32_t descriptorCount, bool shaderVisible, uint32_t numPersistent)
 {
+    ASSERT(numPersistent < descriptorCount, TEXT("persistent descriptors must leave room for the ring."));
     mDevice = pDevice;
+    mNumPersistent = numPersistent;
     mHeap.reset(new D3D12DescriptorHeap(pDevice->CreateDescriptorHeap(
         heapType, shaderVisible
                       ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE
                       : D3D12_DESCRIPTOR_HEAP_FLAG_NONE, descriptorCount),
         pDevice->GetD3D12Device()->GetDescriptorHandleIncrementSize(heapType)));
-    mAllocator.Initialize(descriptorCount);
+    mAllocator.Initialize(descriptorCount - numPersistent, MemoryTag::RENDER, mHeap->DescriptorSize());
 
     mCPUStart = mHeap->CPUHandle(0);
     mGPUStart = shaderVisible ? mHeap->GPUHandle(0) : D3D12_GPU_DESCRIPTOR_HANDLE{0};
 }
 
+inline D3D12DescriptorHandle RingDescriptorAllocator::GetPersistent(uint32_t index) const
+{
+    ASSERT(index < mNumPersistent, TEXT("persistent descriptor out of range."));
+    return {mHeap->CPUHandle(index), mHeap->GPUHandle(index)};
+}
+
 inline D3D12DescriptorHandle RingDescriptorAllocator::Allocate()
 {
-    std::lock_guard<std::mutex> lock(mMutex);
-    const uint64_t offset = mAllocator.Allocate(1);
-    if (offset == MAXUINT64) return {MAXUINT64, MAXUINT64};
-    return {mHeap->CPUHandle(offset), mHeap->GPUHandle(offset)};
+    const uint64_t offset = mAllocator.AllocateOrWait(1);
+    if (offset == FrameRingAllocator::INVALID_OFFSET) return {MAXUINT64, MAXUINT64};
+    return {mHeap->CPUHandle(mNumPersistent + offset), mHeap->GPUHandle(mNumPersistent + offset)};
 }
 
 inline std::unique_ptr<D3D12DescriptorHandle[]> RingDescriptorAllocator::Allocate(uint32_t count)
 {
-    std::lock_guard<std::mutex> lock(mMutex);
-    uint64_t offset = mAllocator.Allocate(count);
-        
+    const uint64_t offset = mAllocator.AllocateOrWait(count);
+    ASSERT(offset != FrameRingAllocator::INVALID_OFFSET, TEXT("a single frame exhausted the online descriptor heap."));
+    return GetHandles(offset, count);
+}
+
+inline std::unique_ptr<D3D12DescriptorHandle[]> RingDescriptorAllocator::GetHandles(uint64_t offset, uint32_t count) const
+{
+    // ranges of the ring never wrap
     std::unique_ptr<D3D12DescriptorHandle[]> descriptors{new D3D12DescriptorHandle[count]};
-    uint64_t increment = mHeap->DescriptorSize();
-    D3D12DescriptorHandle base = {mHeap->CPUHandle(offset), mHeap->GPUHandle(offset)};
+    const uint64_t increment = mHeap->DescriptorSize();
+    D3D12DescriptorHandle base = {mHeap->CPUHandle(mNumPersistent + offset), mHeap->GPUHandle(mNumPersistent + offset)};
     for (uint64_t i = 0; i < count; ++i)
     {
         descriptors[i] = base;
-        
-        if (offset >= mAllocator.GetTotalSize())
-        {
-            base = {mHeap->CPUHandle(0), mHeap->GPUHandle(0)};
-            offset = 0;
-        }
-        else
-        {
-            base.mCPUHandle.ptr += increment;
-            base.mGPUHandle.ptr += increment;
-            offset++;
-        }
+        base.mCPUHandle.ptr += increment;
+        base.mGPUHandle.ptr += increment;
     }
     return descriptors;
 }
 
-inline void RingDescriptorAllocator::Reset()
+inline void RingDescriptorAllocator::EndFrame(const RHIFence* pFence, uint64_t semaphore)
 {
-    std::lock_guard<std::mutex> lock(mMutex);
-    mAllocator.Reset();
+    mAllocator.EndFrame(pFence, semaphore);
+    mAllocator.Reclaim();
+}
+
+inline FrameRingAllocator* RingDescriptorAllocator::GetRing()
+{
+    return &mAllocator;
 }
 
 inline D3D12DescriptorHeap* RingDescriptorAllocator::GetHeap() const
@@ -207,7 +223,7 @@ inline void BlockDescriptorAllocator::Initialize(D3D12Device* pDevice, D3D12_DES
                                                           ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE
                                                           : D3D12_DESCRIPTOR_HEAP_FLAG_NONE, descriptorCount),
                                         pDevice->GetD3D12Device()->GetDescriptorHandleIncrementSize(heapType)));
-    mAllocator.Initialize(descriptorCount);
+    mAllocator.Initialize(descriptorCount, MemoryTag::RENDER, mHeap->DescriptorSize());
 
     mCPUStart = mHeap->CPUHandle(0);
     mGPUStart = shaderVisible ? mHeap->GPUHandle(0) : D3D12_GPU_DESCRIPTOR_HANDLE{0};
@@ -59,6 +59,7 @@ Format ConvertFromDXGIFormat(DXGI_FORMAT format)
         case DXGI_FORMAT_R16_SINT:          return Format::R16_SINT;
         case DXGI_FORMAT_R16G16_SINT:       return Format::R16G16_SINT;
         case DXGI_FORMAT_R16G16B16A16_SINT: return Format::R16G16B16A16_SINT;
+        case DXGI_FORMAT_R16G16_FLOAT:      return Format::R16G16_FLOAT;
         case DXGI_FORMAT_R32_UINT:          return Format::R32_UINT;
         case DXGI_FORMAT_R32G32_UINT:       return Format::R32G32_UINT;
         case DXGI_FORMAT_R32G32B32_UINT:    return Format::R32G32B32_UINT;
@@ -110,6 +111,7 @@ DXGI_FORMAT ConvertToDXGIFormat(Format format)
         case Format::R16_SINT:          return DXGI_FORMAT_R16_SINT;
         case Format::R16G16_SINT:       return DXGI_FORMAT_R16G16_SINT;
         case Format::R16G16B16A16_SINT: return DXGI_FORMAT_R16G16B16A16_SINT;
+        case Format::R16G16_FLOAT:      return DXGI_FORMAT_R16G16_FLOAT;
         case Format::R32_TYPELESS:      return DXGI_FORMAT_R32_TYPELESS;
         case Format::R32G32_TYPELESS:   return DXGI_FORMAT_R32G32_TYPELESS;
         case Format::R32G32B32A32_TYPELESS: return DXGI_FORMAT_R32G32B32A32_TYPELESS;
@@ -7,6 +7,8 @@
 #include "D3D12EnumConversions.h"
 #include "Engine/render/Blob.h"
 #include "Engine/render/Shader.h"
+#include "Engine/render/PipelineStateCache.h"
+#include "Engine/Utility/Telemetry/Telemetry.h"
 
 enum class D3D12PipelineStateType : uint8_t
 {
@@ -22,6 +24,12 @@ public:
     void Initialize(D3D12Device* pDevice);
     ID3D12PipelineState* GetOrCreateGraphicsPSO(ID3D12RootSignature* pRootSignature,
                                                 const PipelineInitializer& desc);
+    // see RHI::RHILoadPipelineStates, `pLibrary` is copied, the driver reads it as long as the library lives.
+    bool LoadPipelineStates(const void* pList, uint64_t listSize, const void* pLibrary, uint64_t librarySize);
+    uint32_t PrewarmGraphicsPSOs(ID3D12RootSignature* pRootSignature, const RHIShader* pShader);
+    void SavePipelineStates(std::vector<uint8_t>& list, std::vector<uint8_t>& library);
+    // called once per frame after submitting it, pipeline states unused for a few frames become evictable.
+    void NextFrame();
 
     // UComPtr<ID3D12PipelineState> GetOrCreateComputePSO(ID3D12RootSignature* pRootSignature,
     //                                                     const PipelineInitializer& desc);
@@ -29,40 +37,118 @@ public:
     ~D3D12PipelineStateManager() = default;
 
 private:
+    // creates the pipeline state of `desc`, loaded from the pipeline library when the driver compiled it before.
+    ID3D12PipelineState* CreateGraphicsPSO(ID3D12RootSignature* pRootSignature, const PipelineInitializer& desc, uint64_t key);
+    void CreatePipelineLibrary(const void* pLibrary, uint64_t librarySize);
+
     D3D12Device* mDevice;
-    std::vector<PipelineInitializer> mPSOInitializers;      // TODO: monitor PSOs, Release unused PSOs when necessary.
-    std::unordered_map<const PipelineInitializer*, UComPtr<ID3D12PipelineState>, HashPtrAsTyped<const PipelineInitializer*>, ComparePtrAsTyped<const PipelineInitializer*>> mPipelineStateTable;
+    PipelineStateCache<UComPtr<ID3D12PipelineState>> mPipelineStates;
+    PipelineStateList mPipelineStateList;
+    // null when the driver does not support pipeline libraries
+    UComPtr<ID3D12PipelineLibrary> mPipelineLibrary;
+    std::vector<uint8_t> mPipelineLibraryData;
+    // pipeline states are looked up by every recording thread.
+    std::mutex mMutex;
 };
 
 inline void D3D12PipelineStateManager::Initialize(D3D12Device* pDevice)
 {
     mDevice = pDevice;
+    CreatePipelineLibrary(nullptr, 0);
 }
 
 inline ID3D12PipelineState* D3D12PipelineStateManager::GetOrCreateGraphicsPSO(
     ID3D12RootSignature* pRootSignature, const PipelineInitializer& desc)
 {
-    const auto it = mPipelineStateTable.find(&desc);
-    if (it != mPipelineStateTable.end()) return it->second.Get();
-    uint64_t index = mPSOInitializers.size();
-    mPSOInitializers.push_back(desc);
-    // if (mReleasedPSOs.empty())
-    // {
-    //     index = mReleasedPSOs.top();
-    //     mReleasedPSOs.pop();
-    //     mPSOInitializers[index] = desc;
-    // }
-    // else
-    // {
-    //     index = mPSOInitializers.mSize();
-    //     mPSOInitializers.push_back(desc);
-    // }
+    const PipelineStateRecord record = PipelineStateRecord::FromInitializer(desc);
+    const uint64_t key = record.Key();
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (UComPtr<ID3D12PipelineState>* pPSO = mPipelineStates.Find(key)) return pPSO->Get();
+    TELEMETRY_COUNT(PIPELINE_STATE_CREATIONS, 1);
+    mPipelineStateList.Add(record);
+    return CreateGraphicsPSO(pRootSignature, desc, key);
+}
+
+inline bool D3D12PipelineStateManager::LoadPipelineStates(const void* pList, uint64_t listSize, const void* pLibrary, uint64_t librarySize)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    CreatePipelineLibrary(pLibrary, librarySize);
+    return mPipelineStateList.Load(pList, listSize);
+}
+
+inline uint32_t D3D12PipelineStateManager::PrewarmGraphicsPSOs(ID3D12RootSignature* pRootSignature, const RHIShader* pShader)
+{
+    std::vector<PipelineStateRecord> records;
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPipelineStateList.GetRecords(pShader->GetHash(), records);
+    uint32_t numCreated = 0;
+    for (const PipelineStateRecord& record : records)
+    {
+        const uint64_t key = record.Key();
+        if (mPipelineStates.Find(key)) continue;
+        CreateGraphicsPSO(pRootSignature, record.ToInitializer(pShader), key);
+        ++numCreated;
+    }
+    return numCreated;
+}
+
+inline void D3D12PipelineStateManager::SavePipelineStates(std::vector<uint8_t>& list, std::vector<uint8_t>& library)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    list = mPipelineStateList.Serialize();
+    library.clear();
+    if (!mPipelineLibrary) return;
+    library.resize(mPipelineLibrary->GetSerializedSize());
+    if (FAILED(mPipelineLibrary->Serialize(library.data(), library.size()))) library.clear();
+}
+
+inline void D3D12PipelineStateManager::NextFrame()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPipelineStates.NextFrame();
+}
+
+inline ID3D12PipelineState* D3D12PipelineStateManager::CreateGraphicsPSO(ID3D12RootSignature* pRootSignature,
+    const PipelineInitializer& desc, uint64_t key)
+{
     D3D12_GRAPHICS_PIPELINE_STATE_DESC d3d12Desc = {};
     InitD3D12PipelineStateDesc(pRootSignature, desc, d3d12Desc);
-    ID3D12PipelineState* pPSO = mDevice->CreateGraphicsPipelineStateObject(d3d12Desc).Detach();
-    mPipelineStateTable.emplace(mPSOInitializers.data() + index, pPSO);
+    wchar_t name[17];
+    swprintf(name, 17, L"%016llx", static_cast<unsigned long long>(key));
+    UComPtr<ID3D12PipelineState> pPSO;
+    // fails when the library does not contain the pipeline, or when it was compiled from a different description
+    if (mPipelineLibrary && SUCCEEDED(mPipelineLibrary->LoadGraphicsPipeline(name, &d3d12Desc, IID_PPV_ARGS(pPSO.GetAddressOf()))))
+    {
+        TELEMETRY_COUNT(PIPELINE_LIBRARY_HITS, 1);
+    }
+    else
+    {
+        pPSO = mDevice->CreateGraphicsPipelineStateObject(d3d12Desc);
+        // a pipeline evicted from the cache is still in the library, it loads next time
+        if (mPipelineLibrary) mPipelineLibrary->StorePipeline(name, pPSO.Get());
+    }
     delete[] d3d12Desc.InputLayout.pInputElementDescs;
-    return pPSO;
+    return mPipelineStates.Insert(key, std::move(pPSO)).Get();
+}
+
+inline void D3D12PipelineStateManager::CreatePipelineLibrary(const void* pLibrary, uint64_t librarySize)
+{
+    mPipelineLibrary.Release();
+    UComPtr<ID3D12Device1> pDevice1;
+    if (FAILED(mDevice->GetD3D12Device()->QueryInterface(IID_PPV_ARGS(pDevice1.GetAddressOf())))) return;
+    // the driver keeps reading the serialized library, the copy has to outlive it
+    mPipelineLibraryData.assign(static_cast<const uint8_t*>(pLibrary), static_cast<const uint8_t*>(pLibrary) + librarySize);
+    if (!mPipelineLibraryData.empty() &&
+        SUCCEEDED(pDevice1->CreatePipelineLibrary(mPipelineLibraryData.data(), mPipelineLibraryData.size(), IID_PPV_ARGS(mPipelineLibrary.GetAddressOf()))))
+    {
+        return;
+    }
+    // a library of another driver or adapter is rejected, it is rebuilt from scratch
+    mPipelineLibraryData.clear();
+    if (FAILED(pDevice1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(mPipelineLibrary.GetAddressOf()))))
+    {
+        mPipelineLibrary.Release();
+    }
 }
 
 inline void D3D12PipelineStateManager::InitD3D12PipelineStateDesc(ID3D12RootSignature* pRootSignature, const PipelineInitializer& psoDesc,
@@ -80,19 +166,42 @@ inline void D3D12PipelineStateManager::InitD3D12PipelineStateDesc(ID3D12RootSign
     d3d12Desc.DS = { dsBinary.Binary(), dsBinary.Size() };
     d3d12Desc.GS = { gsBinary.Binary(), gsBinary.Size() };
     d3d12Desc.PS = { psBinary.Binary(), psBinary.Size() };
-    const std::vector<ShaderInput>& inputElems = shader.GetInputElements();
-    D3D12_INPUT_ELEMENT_DESC* d3dInputElems = new D3D12_INPUT_ELEMENT_DESC[inputElems.size()];
-    for (int i = 0; i < inputElems.size(); ++i)
+    const InputLayoutDesc layout = GetInputLayoutDesc(psoDesc.mInputLayout);
+    D3D12_INPUT_ELEMENT_DESC* d3dInputElems;
+    uint32_t numInputElems;
+    if (layout.mNumElements > 0)
     {
-        d3dInputElems[i].Format = ::ConvertToDXGIFormat(inputElems[i].mFormat);
-        d3dInputElems[i].SemanticName = inputElems[i].mSemanticName.c_str();
-        d3dInputElems[i].SemanticIndex = inputElems[i].mSemanticIndex;
-        d3dInputElems[i].InputSlot = inputElems[i].mInputSlot;
-        d3dInputElems[i].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
-        d3dInputElems[i].InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
-        d3dInputElems[i].InstanceDataStepRate = 0;
+        // the layout of the vertex format, the shader may read a part of it
+        numInputElems = layout.mNumElements;
+        d3dInputElems = new D3D12_INPUT_ELEMENT_DESC[numInputElems];
+        for (uint32_t i = 0; i < numInputElems; ++i)
+        {
+            d3dInputElems[i].Format = ::ConvertToDXGIFormat(layout.mElements[i].mFormat);
+            d3dInputElems[i].SemanticName = layout.mElements[i].mSemanticName;
+            d3dInputElems[i].SemanticIndex = layout.mElements[i].mSemanticIndex;
+            d3dInputElems[i].InputSlot = layout.mElements[i].mInputSlot;
+            d3dInputElems[i].AlignedByteOffset = layout.mElements[i].mOffset;
+            d3dInputElems[i].InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
+            d3dInputElems[i].InstanceDataStepRate = 0;
+        }
+    }
+    else
+    {
+        const std::vector<ShaderInput>& inputElems = shader.GetInputElements();
+        numInputElems = static_cast<uint32_t>(inputElems.size());
+        d3dInputElems = new D3D12_INPUT_ELEMENT_DESC[numInputElems];
+        for (int i = 0; i < inputElems.size(); ++i)
+        {
+            d3dInputElems[i].Format = ::ConvertToDXGIFormat(inputElems[i].mFormat);
+            d3dInputElems[i].SemanticName = inputElems[i].mSemanticName.c_str();
+            d3dInputElems[i].SemanticIndex = inputElems[i].mSemanticIndex;
+            d3dInputElems[i].InputSlot = inputElems[i].mInputSlot;
+            d3dInputElems[i].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+            d3dInputElems[i].InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
+            d3dInputElems[i].InstanceDataStepRate = 0;
+        }
     }
-    d3d12Desc.InputLayout = { d3dInputElems, static_cast<uint32_t>(inputElems.size()) };
+    d3d12Desc.InputLayout = { d3dInputElems, numInputElems };
     d3d12Desc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
     d3d12Desc.SampleDesc = DXGI_SAMPLE_DESC{
 	    static_cast<uint32_t>(psoDesc.mMSAA) >> 4, static_cast<uint32_t>(psoDesc.mMSAA & 0xf)
@@ -156,7 +265,7 @@ inline void D3D12PipelineStateManager::InitD3D12PipelineStateDesc(ID3D12RootSign
     depthTest = CD3DX12_DEPTH_STENCIL_DESC{ D3D12_DEFAULT };
     depthTest.DepthEnable = psoDesc.mOptions >> 5;
     depthTest.StencilEnable = (psoDesc.mOptions & 0b010000) >> 4;
-    depthTest.DepthWriteMask = psoDesc.mRenderTargetWriteMask == ColorMask::ALL ? D3D12_DEPTH_WRITE_MASK_ALL : D3D12_DEPTH_WRITE_MASK_ALL;
+    depthTest.DepthWriteMask = psoDesc.mDepthOperation == DepthOperation::WRITE ? D3D12_DEPTH_WRITE_MASK_ALL : D3D12_DEPTH_WRITE_MASK_ZERO;
 
     if (depthTest.StencilEnable)
     {
@@ -13,6 +13,11 @@ public:
     D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress() const;
     uint32_t GetSubResourceCount() const;
     ID3D12Resource* D3D12ResourcePtr() const;
+    // state of the resource once the submitted lists have executed. const because the command contexts only hold const
+    // resources: it is not part of what the resource describes, it is written by ResourceStateTracker::AppendResource
+    // before the resource is used and by ResourceStateTracker::Resolve on the submitting thread, and only read by the
+    // local trackers for the subresource count. do not call it anywhere else, nothing guards it.
+    D3D12TrackedResourceState& GetTrackedState() const;
     
     D3D12Resource();
     D3D12Resource(UComPtr<ID3D12Resource> pResource);
@@ -24,6 +29,7 @@ public:
 
 protected:
     UComPtr<ID3D12Resource> mResource;
+    mutable D3D12TrackedResourceState mTrackedState;
 };
 
 template<>
@@ -55,13 +61,17 @@ inline ID3D12Resource* D3D12Resource::D3D12ResourcePtr() const
     return mResource.Get();
 }
 
+inline D3D12TrackedResourceState& D3D12Resource::GetTrackedState() const
+{
+    return mTrackedState;
+}
+
 inline D3D12Resource::D3D12Resource() = default;
 
 inline D3D12Resource::D3D12Resource(UComPtr<ID3D12Resource> pResource) : mResource(std::move(pResource)) { }
 
 inline D3D12Resource::~D3D12Resource()
 {
-    ResourceStateTracker::RemoveResource(this);
     mResource.Release();
 }
 
@@ -177,13 +177,16 @@ std::unique_ptr<D3D12ConstantBuffer> D3D12CommandContext::AllocFrameConstantBuff
 //    mComputeQueue = computeQueue;
 //}
 
-void D3D12CommandContext::AllocDescriptors(std::unique_ptr<D3D12DescriptorHandle[]>& pDescriptors,
+void D3D12CommandContext::AllocDescriptors(FrameRingCache& cache, std::unique_ptr<D3D12DescriptorHandle[]>& pDescriptors,
                                            D3D12DescriptorHandle*& pTextures, const D3D12RootSignature* pRootSignature) const
 {
     ASSERT(pRootSignature, TEXT("invalid root signature."));
 
     const RootSignatureLayout& layout = pRootSignature->mLayout;
-    pDescriptors = mOnlineDescriptorAllocator->Allocate(layout.mNumTextures + layout.mNumMaterialConstants);
+    const uint32_t numDescriptors = layout.mNumTextures + layout.mNumMaterialConstants;
+    const uint64_t offset = cache.Allocate(numDescriptors);
+    ASSERT(offset != FrameRingAllocator::INVALID_OFFSET, TEXT("a single frame exhausted the online descriptor heap."));
+    pDescriptors = mOnlineDescriptorAllocator->GetHandles(offset, numDescriptors);
     pTextures = pDescriptors.get() + layout.mNumMaterialConstants;
     for (int i = 0; i < layout.mNumMaterialConstants; ++i)
     {
@@ -217,6 +220,11 @@ D3D12Device* D3D12CommandContext::GetDevice() const
     return mDevice;
 }
 
+const D3D12Resource* D3D12CommandContext::GetFrameConstantBufferPool() const
+{
+    return mRingFrameCBufferAllocator->GetD3D12Resource();
+}
+
 const D3D12RootSignature* D3D12CommandContext::GetRootSignature() const
 {
     // TODO: query root signature by name or index.
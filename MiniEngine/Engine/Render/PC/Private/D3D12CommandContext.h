@@ -27,12 +27,19 @@ public:
                     pRingCBufferAllocator, D3D12PipelineStateManager* pPSOManager, D3D12RootSignatureManager* pRootSigManager);
     //void Initialize2(ID3D12CommandQueue* directQueue, ID3D12CommandQueue* copyQueue, ID3D12CommandQueue* computeQueue);
     std::unique_ptr<D3D12ConstantBuffer> AllocFrameConstantBuffer(uint16_t size) const;
-    void AllocDescriptors(std::unique_ptr<D3D12DescriptorHandle[]>& pDescriptors, D3D12DescriptorHandle*& pTextures, const D3D12RootSignature* pRootSignature) const;
+    // the upload heap behind the frame constant buffers
+    const D3D12Resource* GetFrameConstantBufferPool() const;
+    // a descriptor table of the root signature from the cache of the recording context.
+    void AllocDescriptors(FrameRingCache& cache, std::unique_ptr<D3D12DescriptorHandle[]>& pDescriptors, D3D12DescriptorHandle*& pTextures,
+                          const D3D12RootSignature* pRootSignature) const;
+    FrameRingAllocator* GetDescriptorRing() const { return mOnlineDescriptorAllocator->GetRing(); }
     ID3D12PipelineState* GetPipelineStateObject(
 	    const D3D12RootSignature* pRootSignature,
 	    const PipelineInitializer& pPipelineInitializer) const;
     void GetOnlineDescriptorHeaps(std::unique_ptr<ID3D12DescriptorHeap*[]>& ppOnlineDescriptorHeaps, uint16_t& numHeaps) const;
     const D3D12RootSignature* GetRootSignature(/*const std::string& name*/) const;
+    const D3D12Resource* GetBindlessTable(uint32_t index) const { return mBindlessTables[index]; }
+    D3D12DescriptorHandle GetBindlessDescriptors() const { return mOnlineDescriptorAllocator->GetPersistent(0); }
     //ID3D12CommandQueue* GetDirectQueue() const;
     //ID3D12CommandQueue* GetCopyQueue() const;
     //ID3D12CommandQueue* GetComputeQueue() const;
@@ -52,6 +59,9 @@ private:
     RingDescriptorAllocator* mOnlineDescriptorAllocator;
     D3D12RingBufferAllocator* mRingFrameCBufferAllocator;
 
+    // object and material table of RHISetBindlessConstantTables, transitioned by the contexts binding them
+    const D3D12Resource* mBindlessTables[2] = {};
+
     UComPtr<ID3D12Resource> mDummyCBuffer;
     UComPtr<ID3D12Resource> mDummyTexture;
 
@@ -15,6 +15,7 @@ void D3D12GraphicsContext::Initialize(D3D12CommandContext* pGraphicCommandContex
     mStagingBufferPool = pStagingBufferPool;
     mCommandAllocator = pCommandAllocator;
     mResourceStateTracker.reset(new ResourceStateTracker());
+    mDescriptorCache.Initialize(pGraphicCommandContext->GetDescriptorRing(), DESCRIPTOR_BATCH_SIZE);
 }
 
 std::unique_ptr<RHIConstantBuffer> D3D12GraphicsContext::AllocConstantBuffer(uint16_t size)
@@ -128,6 +129,22 @@ void D3D12GraphicsContext::SetConstantBuffer(uint8_t slot, RHIConstantBuffer* pC
     }
 }
 
+void D3D12GraphicsContext::SetStaticConstantBuffer(uint8_t slot, RHIStaticConstantBuffer* pConstants, uint64_t offset, uint64_t size)
+{
+    const D3D12Resource* pResource = static_cast<D3D12Buffer*>(pConstants->GetBuffer())->GetD3D12Resource();
+    // the buffer is left in COPY_DEST by the updates of this frame. READ also covers the bindless table views of the
+    // pools, a constant buffer state would make the two bindings of one frame fight over the state.
+    TransitionResource(pResource, ResourceState::READ);
+    if (slot < 2)
+    {
+        mCommandList->SetGraphicsRootConstantBufferView(slot, pResource->GetGPUVirtualAddress() + offset);
+        return;
+    }
+    ASSERT(slot - 2 < mRootSignature->mLayout.mNumMaterialConstants, TEXT("slot out of bound."));
+    const D3D12_CONSTANT_BUFFER_VIEW_DESC desc{ pResource->GetGPUVirtualAddress() + offset, static_cast<UINT>(::AlignUpToMul<uint64_t, 256>()(size)) };
+    mCommandContext->GetDevice()->CreateConstantBufferView(desc, mDescriptorHandles[slot - 2].mCPUHandle);
+}
+
 void D3D12GraphicsContext::SetTextures(uint8_t baseSlot, uint8_t numSlots, RHINativeTexture* textures[])
 {
     ASSERT(textures, TEXT("invalid textures"));
@@ -148,6 +165,25 @@ void D3D12GraphicsContext::SetTexture(uint8_t slot, RHINativeTexture* textures)
     pDevice->CreateShaderResourceView(texture.GetD3D12Resource()->D3D12ResourcePtr(), texture.GetSRVDesc(), mTextureHandles[slot].mCPUHandle);
 }
 
+void D3D12GraphicsContext::SetStructuredBuffer(uint8_t slot, const void* pData, uint32_t stride, uint32_t numElements)
+{
+    // the view addresses whole elements from the start of the pool, one extra element leaves room to align the
+    // 256 byte aligned frame allocation up to a multiple of the stride.
+    const uint64_t size = static_cast<uint64_t>(stride) * numElements;
+    ASSERT(size + stride <= UINT16_MAX, TEXT("structured buffer exceeds the frame constant buffer limit."));
+    std::unique_ptr<D3D12ConstantBuffer> pBuffer = mCommandContext->AllocFrameConstantBuffer(static_cast<uint16_t>(size + stride));
+    const uint64_t firstElement = (pBuffer->Offset() + stride - 1) / stride;
+    memcpy(static_cast<uint8_t*>(pBuffer->CpuAddress()) + (firstElement * stride - pBuffer->Offset()), pData, size);
+
+    D3D12_SHADER_RESOURCE_VIEW_DESC desc{};
+    desc.Format = DXGI_FORMAT_UNKNOWN;
+    desc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+    desc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    desc.Buffer = { firstElement, numElements, stride, D3D12_BUFFER_SRV_FLAG_NONE };
+    ID3D12Resource* pPool = mCommandContext->GetFrameConstantBufferPool()->D3D12ResourcePtr();
+    mCommandContext->GetDevice()->CreateShaderResourceView(pPool, desc, mTextureHandles[slot].mCPUHandle);
+}
+
 void D3D12GraphicsContext::SetViewPorts(Viewport* viewports, uint32_t numViewports)
 {
     std::unique_ptr<D3D12_VIEWPORT[]> d3d12Viewports{ new D3D12_VIEWPORT[numViewports] };
@@ -220,7 +256,7 @@ void D3D12GraphicsContext::SetVertexBuffers(RHIVertexBuffer** vertexBuffers, uin
 	    D3D12_VERTEX_BUFFER_VIEW* vbvs = new D3D12_VERTEX_BUFFER_VIEW[numVertexBuffers];
     	for (int i = 0; i < numVertexBuffers; ++i)
     	{
-    		D3D12VertexBuffer* buffer = static_cast<D3D12VertexBuffer*>(vertexBuffers[0]->GetBuffer());
+    		D3D12VertexBuffer* buffer = static_cast<D3D12VertexBuffer*>(vertexBuffers[i]->GetBuffer());
     		vbvs[i] = buffer->GetVertexBufferView();
     	}
 
@@ -257,9 +293,44 @@ void D3D12GraphicsContext::InsertFence(RHIFence* pFence, uint64_t semaphore)
     mSynchronizes.emplace_back(static_cast<D3D12Fence*>(pFence), semaphore);
 }
 
+void D3D12GraphicsContext::TransitionResources(const RHIResourceTransition* pTransitions, uint32_t numTransitions)
+{
+    std::vector<D3D12_RESOURCE_BARRIER> barriers;
+    for (uint32_t i = 0; i < numTransitions; ++i)
+    {
+        const RHIResourceTransition& transition = pTransitions[i];
+        const D3D12Resource* pResource;
+        ResourceState state;
+        switch (transition.mAccess)
+        {
+        case ResourceAccess::RENDER_TARGET:
+            pResource = static_cast<D3D12RenderTarget*>(transition.mResource)->GetD3D12Resource();
+            state = ResourceState::RENDER_TARGET;
+            break;
+        case ResourceAccess::DEPTH_WRITE:
+            pResource = static_cast<D3D12DepthStencil*>(transition.mResource)->GetD3D12Resource();
+            state = ResourceState::DEPTH_WRITE;
+            break;
+        case ResourceAccess::DEPTH_READ:
+            pResource = static_cast<D3D12DepthStencil*>(transition.mResource)->GetD3D12Resource();
+            state = ResourceState::DEPTH_READ;
+            break;
+        default:
+            continue;
+        }
+        // the first use of a resource in the list is resolved at submission and yields no barrier here.
+        auto&& resourceBarriers = mResourceStateTracker->ConvertResourceState(pResource, state);
+        barriers.insert(barriers.end(), resourceBarriers.begin(), resourceBarriers.end());
+    }
+    if (!barriers.empty())
+    {
+        mCommandList->ResourceBarrier(barriers.size(), barriers.data());
+    }
+}
+
 void D3D12GraphicsContext::BeginBinding()
 {
-    mCommandContext->AllocDescriptors(mDescriptorHandles, mTextureHandles, mRootSignature);
+    mCommandContext->AllocDescriptors(mDescriptorCache, mDescriptorHandles, mTextureHandles, mRootSignature);
     //mDrawCalls.clear();
 }
 
@@ -268,6 +339,8 @@ void D3D12GraphicsContext::Reset(ID3D12GraphicsCommandList* pCommandList)
     mRootSignature = mCommandContext->GetRootSignature(/*"UniversalRootSignature"*/);
     //mDrawCalls.clear();
     mResourceStateTracker->Cancel();
+    // the rest of the batch belongs to the previous frame
+    mDescriptorCache.Reset();
     mDescriptorHandles.reset();
     mTextureHandles = nullptr;
     mCommandList = pCommandList;
@@ -313,6 +386,23 @@ void D3D12GraphicsContext::EndBindings()
 	//}
 }
 
+void D3D12GraphicsContext::SetBindlessTables()
+{
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        const D3D12Resource* pTable = mCommandContext->GetBindlessTable(i);
+        ASSERT(pTable, TEXT("bindless tables are not set."));
+        TransitionResource(pTable, ResourceState::READ);
+    }
+    mCommandList->SetGraphicsRootDescriptorTable(4, mCommandContext->GetBindlessDescriptors().mGPUHandle);
+}
+
+void D3D12GraphicsContext::SetDrawIndices(uint32_t objectIndex, uint32_t materialIndex)
+{
+    const uint32_t indices[2] = { objectIndex, materialIndex };
+    mCommandList->SetGraphicsRoot32BitConstants(3, 2, indices, 0);
+}
+
 //void D3D12GraphicsContext::Execute()
 //{
 //    ID3D12CommandQueue* pQueue = mCommandContext->GetDirectQueue();
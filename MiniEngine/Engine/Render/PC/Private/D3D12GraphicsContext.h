@@ -15,6 +15,9 @@ class D3D12GraphicsContext : public RHIGraphicsContext
 {
     friend class D3D12RHI;
 public:
+    // descriptors taken from the online heap at once, about 18 descriptor tables of the global root signature.
+    static constexpr uint32_t DESCRIPTOR_BATCH_SIZE = 128;
+
     void Initialize(D3D12CommandContext* pGraphicCommandContext, ID3D12CommandAllocator* pCommandAllocator, const D3D12Resource* pStagingBufferPool);
     std::unique_ptr<RHIConstantBuffer> AllocConstantBuffer(uint16_t size) override;
     void UpdateBuffer(RHIBufferWrapper* pDst, RHIStagingBuffer* pStagingBuffer, uint64_t size, uint64_t dstStart, uint64_t srcStart) override;
@@ -25,8 +28,10 @@ public:
     void SetPipelineState(const PipelineInitializer& initializer) override;
     void SetConstantBuffers(uint8_t baseSlot, uint8_t numSlots, RHIConstantBuffer* pConstants[]) override;
     void SetConstantBuffer(uint8_t slot, RHIConstantBuffer* pConstants) override;
+    void SetStaticConstantBuffer(uint8_t slot, RHIStaticConstantBuffer* pConstants, uint64_t offset, uint64_t size) override;
     void SetTextures(uint8_t baseSlot, uint8_t numSlots, RHINativeTexture* textures[]) override;
     void SetTexture(uint8_t slot, RHINativeTexture* textures) override;
+    void SetStructuredBuffer(uint8_t slot, const void* pData, uint32_t stride, uint32_t numElements) override;
     void SetViewPorts(Viewport* viewports, uint32_t numViewports) override;
     void SetScissorRect(Rect* scissorRects, uint32_t numScissorRects) override;
     void SetRenderTargetsAndDepthStencil(RHIRenderTarget** renderTargets, uint32_t numRenderTargets, RHIDepthStencil* depthStencilTarget) override;
@@ -35,11 +40,14 @@ public:
     void DrawInstanced(uint32_t verticesPerInstance, uint32_t baseVertex, uint32_t instanceCount, uint32_t baseInstance) override;
     void DrawIndexedInstanced(uint32_t indicesPerInstance, uint32_t baseIndex, uint32_t baseVertex, uint32_t instanceCount, uint32_t baseInstance) override;
     void InsertFence(RHIFence* pFence, uint64_t semaphore) override;
+    void TransitionResources(const RHIResourceTransition* pTransitions, uint32_t numTransitions) override;
 
     void BeginBinding() override;
 	// push the dcs submitted since last call to EndBindings to command list,
     // call this function before changing any states of graphic pipeline.
     void EndBindings() override;
+    void SetBindlessTables() override;
+    void SetDrawIndices(uint32_t objectIndex, uint32_t materialIndex) override;
     //void Execute() override;
     //void ExecuteWithSync(RHIFence* pFence, uint64_t semaphore) override;
 
@@ -84,6 +92,8 @@ private:
     //uint64_t mSemaphore;
 
     std::unique_ptr<ResourceStateTracker> mResourceStateTracker;    //TODO: Pooling
+    // descriptor tables of this context, refilled in batches from the online heap without locking it.
+    FrameRingCache mDescriptorCache;
     std::unique_ptr<D3D12DescriptorHandle[]> mDescriptorHandles;
     D3D12DescriptorHandle* mTextureHandles;
     std::vector<std::pair<D3D12Fence*, uint64_t>> mSynchronizes;    // TODO:
@@ -2,6 +2,7 @@
 #ifdef WIN32
 #include "Engine/pch.h"
 #include "Engine/common/helper.h"
+#include "Engine/Render/ResourceStateTracking.h"
 
 class D3D12Buffer;
 class D3D12Texture;
@@ -36,69 +37,40 @@ enum class ResourceState : uint32_t
     UNKNOWN = 0xffffffff,
 };
 
-struct StateConversion
+struct D3D12ResourceStateTraits
 {
-    StateConversion();
-    explicit StateConversion(uint32_t idx, ResourceState srcState = ResourceState::UNKNOWN, ResourceState dstState = ResourceState::UNKNOWN);
+    using Resource = D3D12Resource;
+    using State = ResourceState;
 
-    bool isGeneralConversion() const;
+    // resources used on the copy queue decay to the common state when its lists complete
+    static constexpr ResourceState DECAYED_STATE = ResourceState::COMMON;
 
-    uint32_t mIdx;
-    ResourceState mSrcState;
-    ResourceState mDstState;
+    static bool ImplicitTransition(ResourceState before, ResourceState& after, bool isBufferOrSimultaneous);
 };
 
-struct StateConverter
-{
-    std::vector<StateConversion> ConvertState(ResourceState dstState);
-    bool ConvertSubResource(StateConversion& conversion);
-    std::vector<StateConversion> PreConvert(const ResourceState* srcStates) const;
-    std::vector<StateConversion> Join(const StateConverter& stateConverter);
-    const ResourceState* GetDesiredInitialState() const;
-    const ResourceState* GetDestinationStates() const;
-    uint32_t GetSubResourceCount() const;
-    void Reset();
-    StateConverter();
-    StateConverter(uint32_t numSubResources, bool isBufferOrSimultaneous);
-    StateConverter(StateConverter&& other) noexcept;
-    ~StateConverter();
-
-    StateConverter& operator=(StateConverter&& other) noexcept;
-    
-    DELETE_COPY_OPERATOR(StateConverter);
-    DELETE_COPY_CONSTRUCTOR(StateConverter);
-
-private:
-    bool ConvertSubResourceImpl(StateConversion& conversion) const;
-    void TryFold();
-
-    uint32_t mNumSubResources;
-    ResourceState* mFirstDstStates;
-    ResourceState* mLastStates;
-    uint8_t mConverterState;    // Dirty | All initial states are same | All destination states are same 
-    bool mIsBufferOrSimultaneous;
-};
+using D3D12TrackedResourceState = TrackedResourceState<ResourceState>;
 
+// Resource states of one command list. Recording touches only this tracker, the first use of every resource is resolved
+// against the global state stored in the D3D12Resource when the list is submitted.
 class ResourceStateTracker : NonCopyable
 {
 public:
     static void AppendResource(const D3D12Resource* pResource, ResourceState initialState);
-    static void RemoveResource(const D3D12Resource* pResource);
-    //void Track(const D3D12Resource& pResource);
-    std::vector<D3D12_RESOURCE_BARRIER> Join(ResourceStateTracker& other);
     std::pair<bool, D3D12_RESOURCE_BARRIER> ConvertSubResourceState(const D3D12Resource* pResource, uint32_t subResourceIndex,
                                                                     ResourceState dstState);
     std::vector<D3D12_RESOURCE_BARRIER> ConvertResourceState(const D3D12Resource* pResource, ResourceState dstState);
-    std::vector<D3D12_RESOURCE_BARRIER> BuildPreTransitions() const;
-    void StopTracking(bool isCopyQueue);
+    // barriers between `previous` and this list when they are executed back to back. this tracker takes over the
+    // pending first uses of `previous`.
+    std::vector<D3D12_RESOURCE_BARRIER> Join(ResourceStateTracker& previous);
+    // barriers to run before the list and stores the states the list leaves its resources in.
+    // call once when the list is submitted, from the submitting thread.
+    std::vector<D3D12_RESOURCE_BARRIER> Resolve(bool isCopyQueue);
     void Cancel();
-    
+
 private:
-    StateConverter* GetStateConverter(const D3D12Resource* pResource);
+    std::vector<D3D12_RESOURCE_BARRIER> BuildBarriers();
 
-    static std::unordered_map<const D3D12Resource*, std::vector<ResourceState>> sGlobalResourceStates;
-    static std::shared_mutex sGlobalResourceStateMutex;
-    
-    std::unordered_map<const D3D12Resource*, StateConverter> mStateConverters;
+    LocalResourceStateTracker<D3D12ResourceStateTraits> mLocalStates;
+    std::vector<LocalResourceStateTracker<D3D12ResourceStateTraits>::Transition> mTransitions;
 };
 #endif
\ No newline at end of file
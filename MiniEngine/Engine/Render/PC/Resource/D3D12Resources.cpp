@@ -25,7 +25,9 @@ uint32_t D3D12VertexBuffer::VertexCount() const
 
 D3D12_VERTEX_BUFFER_VIEW D3D12VertexBuffer::GetVertexBufferView() const
 {
-	return {D3D12Buffer::GetD3D12Resource()->GetGPUVirtualAddress(), mVertexCount * mVertexSize, mVertexSize };
+	// a single vertex is read by every vertex of the draw, e.g. the constant color of a mesh
+	const uint32_t stride = mVertexCount == 1 ? 0 : mVertexSize;
+	return {D3D12Buffer::GetD3D12Resource()->GetGPUVirtualAddress(), mVertexCount * mVertexSize, stride };
 }
 
 D3D12VertexBuffer::D3D12VertexBuffer() = default;
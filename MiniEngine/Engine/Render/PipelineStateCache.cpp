@@ -0,0 +1,66 @@
+#include "PipelineStateCache.h"
+#include "Shader.h"
+
+PipelineStateRecord PipelineStateRecord::FromInitializer(const PipelineInitializer& initializer)
+{
+    PipelineStateRecord record{};
+    record.mShaderHash = initializer.mShader ? initializer.mShader->GetHash() : 0;
+    record.mOptions = initializer.mOptions;
+    record.mMSAA = initializer.mMSAA;
+    record.mDepthStencil = initializer.mDepthStencil;
+    record.mRenderTarget = initializer.mRenderTarget;
+    record.mBlendOptions = initializer.mBlendOptions;
+    record.mBlendType = initializer.mBlendType;
+    record.mRenderTargetWriteMask = initializer.mRenderTargetWriteMask;
+    record.mInputLayout = initializer.mInputLayout;
+    record.mRasterizerInitializer = initializer.mRasterizerInitializer;
+    // the write mask, the blend type and alpha to coverage are used even if blending is disabled
+    if (initializer.mOptions & 0b000001)
+    {
+        if (initializer.mBlendType == BlendType::LOGIC)
+        {
+            // the logic op shares its bytes with the blend modes, the rest of the union is not used
+            PipelineInitializer logic;
+            logic.mRenderTargetsBlend.mBlendInitializer = 0;
+            logic.mRenderTargetsBlend.mLogicOp = initializer.mRenderTargetsBlend.mLogicOp;
+            record.mBlendInitializer = logic.mRenderTargetsBlend.mBlendInitializer;
+        }
+        else
+        {
+            // six blend modes and operations, the two bytes above them are padding
+            record.mBlendInitializer = initializer.mRenderTargetsBlend.mBlendInitializer & 0xffffffffffffull;
+        }
+    }
+    if (initializer.mOptions & 0b010000)
+    {
+        // the read and write masks, followed by padding
+        record.mStencilInitializers[0] = initializer.mStencilInitializers[0] & 0xffffull;
+        record.mStencilInitializers[1] = initializer.mStencilInitializers[1];
+    }
+    if (initializer.mOptions & 0b100000)
+    {
+        record.mDepthInitializer = initializer.mDepthInitializer & 0xffffffu;
+    }
+    return record;
+}
+
+PipelineInitializer PipelineStateRecord::ToInitializer(const RHIShader* pShader) const
+{
+    ASSERT(pShader && pShader->GetHash() == mShaderHash, TEXT("the record belongs to another shader"));
+    PipelineInitializer initializer = PipelineInitializer::Default();
+    initializer.mOptions = mOptions;
+    initializer.mMSAA = mMSAA;
+    initializer.mDepthStencil = mDepthStencil;
+    initializer.mRenderTarget = mRenderTarget;
+    initializer.mBlendOptions = mBlendOptions;
+    initializer.mBlendType = mBlendType;
+    initializer.mRenderTargetWriteMask = mRenderTargetWriteMask;
+    initializer.mInputLayout = mInputLayout;
+    initializer.mRenderTargetsBlend.mBlendInitializer = mBlendInitializer;
+    initializer.mStencilInitializers[0] = mStencilInitializers[0];
+    initializer.mStencilInitializers[1] = mStencilInitializers[1];
+    initializer.mDepthInitializer = mDepthInitializer;
+    initializer.mRasterizerInitializer = mRasterizerInitializer;
+    initializer.mShader = pShader;
+    return initializer;
+}
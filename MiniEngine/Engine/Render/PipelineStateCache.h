@@ -0,0 +1,67 @@
+#pragma once
+#include "PipelineStateRecord.h"
+#include "RHIPipelineStateInializer.h"
+#include "Engine/common/Exception.h"
+
+#include <list>
+
+// Least recently used cache of pipeline states keyed by PipelineStateRecord::Key.
+// A pipeline state may still be referenced by the frames in flight, entries are only evicted once they were not used
+// for more than `frameLatency` frames. The capacity is exceeded while every entry is that recent.
+// Not thread safe.
+template <typename TState>
+class PipelineStateCache
+{
+public:
+    // null when the key is missing, marks the entry as used in the current frame.
+    TState* Find(uint64_t key);
+    // the key must not be in the cache, evicts the least recently used entries above the capacity.
+    TState& Insert(uint64_t key, TState&& state);
+    // called once per frame, after the frame has been submitted.
+    void NextFrame() { ++mFrameIndex; }
+    uint32_t GetNumEntries() const { return static_cast<uint32_t>(mEntries.size()); }
+    uint32_t GetNumEvictions() const { return mNumEvictions; }
+
+    explicit PipelineStateCache(uint32_t capacity = 4096, uint32_t frameLatency = 4) : mCapacity(capacity), mFrameLatency(frameLatency) { }
+
+private:
+    struct Entry
+    {
+        uint64_t mKey;
+        uint64_t mLastUsedFrame;
+        TState mState;
+    };
+    using EntryList = std::list<Entry>;
+
+    EntryList mEntries;     // most recently used first
+    std::unordered_map<uint64_t, typename EntryList::iterator> mLookup;
+    uint64_t mFrameIndex = 0;
+    uint32_t mCapacity;
+    uint32_t mFrameLatency;
+    uint32_t mNumEvictions = 0;
+};
+
+template <typename TState>
+TState* PipelineStateCache<TState>::Find(uint64_t key)
+{
+    const auto itor = mLookup.find(key);
+    if (itor == mLookup.end()) return nullptr;
+    itor->second->mLastUsedFrame = mFrameIndex;
+    mEntries.splice(mEntries.begin(), mEntries, itor->second);
+    return &itor->second->mState;
+}
+
+template <typename TState>
+TState& PipelineStateCache<TState>::Insert(uint64_t key, TState&& state)
+{
+    ASSERT(mLookup.find(key) == mLookup.end(), TEXT("pipeline state is already cached"));
+    mEntries.push_front({ key, mFrameIndex, std::move(state) });
+    mLookup.emplace(key, mEntries.begin());
+    while (mEntries.size() > mCapacity && mEntries.back().mLastUsedFrame + mFrameLatency < mFrameIndex)
+    {
+        mLookup.erase(mEntries.back().mKey);
+        mEntries.pop_back();
+        ++mNumEvictions;
+    }
+    return mEntries.front().mState;
+}
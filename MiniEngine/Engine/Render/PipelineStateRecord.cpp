@@ -0,0 +1,70 @@
+#include "PipelineStateRecord.h"
+#include "Engine/common/helper.h"
+
+static_assert(sizeof(PipelineStateRecord) == 48, "PipelineStateRecord must not have implicit padding, its bytes are written to disk");
+
+namespace
+{
+    // MurmurHash only mixes the low 32 bits of its second argument
+    uint64_t HashCombine(uint64_t hash, uint64_t value)
+    {
+        return MurmurHash(MurmurHash(hash, value & 0xffffffffull), value >> 32);
+    }
+}
+
+uint64_t PipelineStateRecord::Key() const
+{
+    const uint64_t formats = mOptions | mMSAA << 8 | static_cast<uint64_t>(mDepthStencil) << 16 |
+        static_cast<uint64_t>(mRenderTarget) << 24 | static_cast<uint64_t>(mBlendOptions) << 32 |
+        static_cast<uint64_t>(mBlendType) << 40 | static_cast<uint64_t>(mRenderTargetWriteMask) << 48 |
+        static_cast<uint64_t>(mInputLayout) << 56;
+    uint64_t hash = HashCombine(mShaderHash, formats);
+    hash = HashCombine(hash, mBlendInitializer);
+    hash = HashCombine(hash, mStencilInitializers[0]);
+    hash = HashCombine(hash, mStencilInitializers[1]);
+    return HashCombine(hash, static_cast<uint64_t>(mDepthInitializer) << 32 | mRasterizerInitializer);
+}
+
+bool PipelineStateList::Add(const PipelineStateRecord& record)
+{
+    if (!mKeys.insert(record.Key()).second) return false;
+    mRecords.push_back(record);
+    return true;
+}
+
+void PipelineStateList::GetRecords(uint64_t shaderHash, std::vector<PipelineStateRecord>& records) const
+{
+    for (const PipelineStateRecord& record : mRecords)
+    {
+        if (record.mShaderHash == shaderHash) records.push_back(record);
+    }
+}
+
+bool PipelineStateList::Load(const void* pData, size_t size)
+{
+    mRecords.clear();
+    mKeys.clear();
+    Header header;
+    if (size < sizeof(Header)) return false;
+    memcpy(&header, pData, sizeof(Header));
+    if (header.mMagic != MAGIC || header.mVersion != VERSION || header.mRecordSize != sizeof(PipelineStateRecord) ||
+        size != sizeof(Header) + static_cast<uint64_t>(header.mNumRecords) * sizeof(PipelineStateRecord)) return false;
+
+    std::vector<PipelineStateRecord> records(header.mNumRecords);
+    memcpy(records.data(), static_cast<const uint8_t*>(pData) + sizeof(Header), records.size() * sizeof(PipelineStateRecord));
+    for (const PipelineStateRecord& record : records)
+    {
+        Add(record);
+    }
+    return true;
+}
+
+std::vector<uint8_t> PipelineStateList::Serialize() const
+{
+    const Header header{ MAGIC, VERSION, static_cast<uint32_t>(mRecords.size()), sizeof(PipelineStateRecord) };
+    const size_t recordsSize = mRecords.size() * sizeof(PipelineStateRecord);
+    std::vector<uint8_t> list(sizeof(Header) + recordsSize);
+    memcpy(list.data(), &header, sizeof(Header));
+    if (recordsSize) memcpy(list.data() + sizeof(Header), mRecords.data(), recordsSize);
+    return list;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "InputLayout.h"
+
+struct PipelineInitializer;
+class RHIShader;
+
+// Everything a graphics pipeline state depends on, taken field by field from a PipelineInitializer. Fields the options
+// disable are zeroed and the shader is named by RHIShader::GetHash instead of its address, so equal pipelines have equal
+// records in every run and the records can be written to disk.
+struct PipelineStateRecord
+{
+    // the conversions are defined in PipelineStateCache.cpp, the rest of the record does not depend on the initializer.
+    static PipelineStateRecord FromInitializer(const PipelineInitializer& initializer);
+    // the initializer of the record, `pShader` has to be a shader whose hash is mShaderHash.
+    PipelineInitializer ToInitializer(const RHIShader* pShader) const;
+    // 64 bit key of the pipeline state, used by the caches of the rhis and by the pipeline library on disk.
+    uint64_t Key() const;
+
+    uint64_t mShaderHash;
+    uint64_t mBlendInitializer;
+    uint64_t mStencilInitializers[2];
+    uint32_t mDepthInitializer;
+    uint32_t mRasterizerInitializer;
+    uint8_t mOptions;
+    uint8_t mMSAA;
+    Format mDepthStencil;
+    Format mRenderTarget;
+    uint8_t mBlendOptions;
+    BlendType mBlendType;
+    ColorMask mRenderTargetWriteMask;
+    InputLayout mInputLayout;
+};
+
+// Pipeline states created during a play session, saved on exit and loaded by the next session to create the same
+// pipeline states when their shader is registered, before the first draw needs them.
+// Not thread safe, the rhis guard it with the lock of their pipeline state cache.
+class PipelineStateList
+{
+public:
+    static constexpr uint32_t VERSION = 2;
+    static constexpr uint32_t MAGIC = 0x4C53504D;   // "MPSL"
+
+    // false when the pipeline state is already in the list.
+    bool Add(const PipelineStateRecord& record);
+    // appends the records using the shader with hash `shaderHash`.
+    void GetRecords(uint64_t shaderHash, std::vector<PipelineStateRecord>& records) const;
+    // replaces the content with a list written by Serialize, false and empty when it is malformed.
+    bool Load(const void* pData, size_t size);
+    std::vector<uint8_t> Serialize() const;
+    uint32_t GetNumRecords() const { return static_cast<uint32_t>(mRecords.size()); }
+
+private:
+    struct Header
+    {
+        uint32_t mMagic;
+        uint32_t mVersion;
+        uint32_t mNumRecords;
+        uint32_t mRecordSize;
+    };
+
+    std::vector<PipelineStateRecord> mRecords;  // in the order they were added
+    std::unordered_set<uint64_t> mKeys;
+};
@@ -1,27 +1,23 @@
 #pragma once
 #include "RHIDescriptors.h"
+#include "RHIObject.h"
 #include "Engine/pch.h"
 #include "Engine/math/math.h"
 
-union Float4;
 struct PipelineInitializer;
 
-class RHIObject
-{
-public:
-    RHIObject() = default;
-    virtual ~RHIObject() = default;
-    
-    NON_COPYABLE(RHIObject)
-    DEFAULT_MOVE_CONSTRUCTOR(RHIObject)
-    DEFAULT_MOVE_OPERATOR(RHIObject)
-};
-
 class RHINativeResource: public RHIObject
 {
 public:
     virtual void Release() = 0;
+    // value of the upload fence after which the last upload into the resource is visible, see UploadManager.
+    uint64_t GetUploadToken() const { return mUploadToken.load(std::memory_order_acquire); }
+    void SetUploadToken(uint64_t token) { mUploadToken.store(token, std::memory_order_release); }
     RHINativeResource() = default;
+
+private:
+    // written by the loading threads, read by the renderer.
+    std::atomic<uint64_t> mUploadToken{0};
 };
 
 class RHINativeBuffer : public RHINativeResource
@@ -39,12 +35,18 @@ protected:
 class RHINativeTexture : public RHINativeResource
 {
 public:
+    static constexpr uint32_t INVALID_BINDLESS_INDEX = ~0u;
+
     const RHITextureDesc& GetDesc() const { return mDesc; }
+    // element of the bindless texture table, assigned by RHI::RHIAllocTexture.
+    uint32_t GetBindlessIndex() const { return mBindlessIndex; }
+    void SetBindlessIndex(uint32_t index) { mBindlessIndex = index; }
     RHINativeTexture() = default;
     RHINativeTexture(const RHITextureDesc& desc) : RHINativeResource(), mDesc(desc) { }
 
 protected:
     RHITextureDesc mDesc;
+    uint32_t mBindlessIndex = INVALID_BINDLESS_INDEX;
 };
 
 class RHIBufferWrapper
@@ -89,6 +91,7 @@ DERIVE_BUFFER_WRAPPER(RHIConstantBuffer);
 DERIVE_BUFFER_WRAPPER(RHIStagingBuffer);
 DERIVE_BUFFER_WRAPPER(RHIVertexBuffer);
 DERIVE_BUFFER_WRAPPER(RHIIndexBuffer);
+DERIVE_BUFFER_WRAPPER(RHIStaticConstantBuffer);
 
 class RHIRenderTarget : public RHINativeResource
 {
@@ -121,14 +124,6 @@ private:
     RHITextureDesc mDesc;
 };
 
-class RHIFence : public RHIObject
-{
-public:
-    virtual uint64_t GetValue() const = 0;
-    virtual void Wait(uint64_t value) const = 0;
-    RHIFence() = default;
-};
-
 // class RHICommandQueue : public RHIObject
 // {
 // public:
@@ -151,6 +146,13 @@ public:
     virtual void InsertFence(RHIFence* pFence, uint64_t semaphore) = 0;
 };
 
+// `mResource` is a RHIRenderTarget for ResourceAccess::RENDER_TARGET and a RHIDepthStencil otherwise.
+struct RHIResourceTransition
+{
+    RHINativeResource* mResource;
+    ResourceAccess mAccess;
+};
+
 class RHIGraphicsContext : public RHIObject
 {
 public:
@@ -165,8 +167,15 @@ public:
     virtual void SetPipelineState(const PipelineInitializer& initializer) = 0;
     virtual void SetConstantBuffers(uint8_t baseSlot, uint8_t numSots, RHIConstantBuffer* pConstants[]) = 0;
     virtual void SetConstantBuffer(uint8_t slot, RHIConstantBuffer* pConstants) = 0;
+    // binds `size` bytes of constants at `offset` of a gpu local constant buffer to `slot`, `offset` must be a multiple
+    // of 256. Slots above 1 are written into the descriptor table, between BeginBinding and EndBindings.
+    // The buffer is written through UpdateBuffer.
+    virtual void SetStaticConstantBuffer(uint8_t slot, RHIStaticConstantBuffer* pConstants, uint64_t offset, uint64_t size) = 0;
     virtual void SetTextures(uint8_t baseSlot, uint8_t numSots, RHINativeTexture* textures[]) = 0;
     virtual void SetTexture(uint8_t slot, RHINativeTexture* textures) = 0;
+    // copies `numElements` elements of `stride` bytes into transient memory of this frame and binds them as a structured
+    // buffer to the texture slot `slot`, must be called between BeginBinding and EndBindings.
+    virtual void SetStructuredBuffer(uint8_t slot, const void* pData, uint32_t stride, uint32_t numElements) = 0;
     virtual void SetViewPorts(Viewport* viewports, uint32_t numViewports) = 0;
     virtual void SetScissorRect(Rect* scissorRects, uint32_t numScissorRects) = 0;
     virtual void SetRenderTargetsAndDepthStencil(RHIRenderTarget** renderTargets, uint32_t numRenderTargets, RHIDepthStencil* depthStencilTarget) = 0;
@@ -176,7 +185,15 @@ public:
     virtual void DrawIndexedInstanced(uint32_t indicesPerInstance, uint32_t baseIndex, uint32_t baseVertex, uint32_t instanceCount, uint32_t baseInstance) = 0;
     virtual void EndBindings() = 0;
     virtual void InsertFence(RHIFence* pFence, uint64_t semaphore) = 0;
+    // moves the resources into the states of their accesses with a single batch of barriers.
+    virtual void TransitionResources(const RHIResourceTransition* pTransitions, uint32_t numTransitions) = 0;
     virtual void BeginBinding() = 0;
+    // binds the bindless texture table and the object and material tables of RHI::RHISetBindlessConstantTables for the
+    // following draws, once per context and frame after the tables were updated.
+    virtual void SetBindlessTables() = 0;
+    // root constants read by bindless shaders: the elements of the object and the material table of the next draws.
+    // replaces the per draw descriptor tables of materials.
+    virtual void SetDrawIndices(uint32_t objectIndex, uint32_t materialIndex) = 0;
 
     RHIGraphicsContext() = default;
 };
@@ -28,6 +28,7 @@ enum class Format : uint8_t
     R16_SINT,
     R16G16_SINT,
     R16G16B16A16_SINT,
+    R16G16_FLOAT,
     R32_TYPELESS,
     R32G32_TYPELESS,
     R32G32B32A32_TYPELESS,
@@ -76,6 +77,15 @@ enum class FrameBufferType : uint8_t
     DEPTH_STENCIL,
 };
 
+// how a render graph pass uses a render target or depth stencil, see RHIGraphicsContext::TransitionResources.
+enum class ResourceAccess : uint8_t
+{
+    RENDER_TARGET,
+    DEPTH_WRITE,
+    DEPTH_READ,
+    UNKNOWN,
+};
+
 enum class CommandQueueType : uint8_t
 {
     GRAPHIC,
@@ -100,6 +110,7 @@ enum class ShaderPropType : uint8_t
     CBUFFER,
     TEXTURE,
     SAMPLER,
+    STRUCTURED_BUFFER,
 };
 
 enum ShaderType : uint8_t
@@ -133,7 +144,7 @@ struct ShaderProp
     ShaderType mVisibility = ShaderType::VERTEX;
     union
     {
-		uint64_t mCBufferSize = 0;
+		uint64_t mCBufferSize = 0;     // element stride for structured buffers
 		TextureDimension mTextureDimension;
     } mInfo{};
     std::string mName{};
@@ -144,6 +155,18 @@ struct ShaderProp
     }
 };
 
+// a variable of a constant buffer, `mOffset` is relative to the start of the buffer bound to register b`mRegister`.
+// members of the element of the bindless MaterialTable use the register MATERIAL_TABLE.
+struct ShaderVariable
+{
+    static constexpr uint8_t MATERIAL_TABLE = UINT8_MAX;
+
+    std::string mName;
+    uint8_t mRegister;
+    uint32_t mOffset;
+    uint32_t mSize;
+};
+
 template <>
 struct std::hash<ShaderProp>
 {
@@ -206,7 +229,7 @@ struct RHITextureDesc final
 
     bool operator==(const RHITextureDesc& other) const noexcept
     {
-        return memcmp(this, &other, sizeof(RHITextureDesc));
+        return memcmp(this, &other, sizeof(RHITextureDesc)) == 0;
     }
 
     uint32_t mWidth;
@@ -615,7 +638,7 @@ static uint16_t GetFormatStride(Format format)
     case Format::R16G16_SNORM:
     case Format::R16G16_UINT:
     case Format::R16G16_SINT:
-    //case Format::R16G16_FLOAT:
+    case Format::R16G16_FLOAT:
     case Format::R32_TYPELESS:
     case Format::R32_UINT:
     case Format::R32_SINT:
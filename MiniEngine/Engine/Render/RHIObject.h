@@ -0,0 +1,23 @@
+#pragma once
+#include "Engine/pch.h"
+
+// Base of the rhi objects and the fences, kept free of the math library so platform independent code like
+// FrameRingAllocator builds on its own.
+class RHIObject
+{
+public:
+    RHIObject() = default;
+    virtual ~RHIObject() = default;
+    
+    NON_COPYABLE(RHIObject)
+    DEFAULT_MOVE_CONSTRUCTOR(RHIObject)
+    DEFAULT_MOVE_OPERATOR(RHIObject)
+};
+
+class RHIFence : public RHIObject
+{
+public:
+    virtual uint64_t GetValue() const = 0;
+    virtual void Wait(uint64_t value) const = 0;
+    RHIFence() = default;
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include "Material.h"
+#include "InputLayout.h"
 #include "RHIDescriptors.h"
 #include "Engine/pch.h"
 #include "Engine/common/helper.h"
@@ -170,7 +171,8 @@ struct PipelineInitializer
             /*mNumRenderTarget != other.mNumRenderTargets ||*/
             mDepthStencil != other.mDepthStencil ||
             mRenderTarget != other.mRenderTarget ||
-            mBlendOptions != other.mBlendOptions)
+            mBlendOptions != other.mBlendOptions ||
+            mInputLayout != other.mInputLayout)
             return false;
         bool sameOptions = mOptions == other.mOptions;
         bool sameBlend = mBlendType == other.mBlendType && mRenderTargetWriteMask == other.mRenderTargetWriteMask;
@@ -186,9 +188,11 @@ struct PipelineInitializer
         uint64_t hash = mOptions | (mMSAA << 8) | (static_cast<uint64_t>(mDepthStencil) << 16) |
             static_cast<uint64_t>(mRenderTarget) << 24 | static_cast<uint64_t>(mBlendOptions) << 32 |
             static_cast<uint64_t>(mBlendType) << 40 |
-            static_cast<uint64_t>(mRenderTargetWriteMask) << 48;
+            static_cast<uint64_t>(mRenderTargetWriteMask) << 48 |
+            static_cast<uint64_t>(mInputLayout) << 56;
 
-        hash = MurmurHash(hash, mDepthInitializer << 32 | mRasterizerInitializer);
+        hash = MurmurHash(hash, static_cast<uint64_t>(mDepthInitializer) << 32 | mRasterizerInitializer);
+        hash = MurmurHash(hash, mRenderTargetsBlend.mBlendInitializer);
         hash = MurmurHash(hash, mStencilInitializers[0]);
         hash = MurmurHash(hash, mStencilInitializers[1]);
         hash = MurmurHash(hash, reinterpret_cast<uint64_t>(mShader));
@@ -205,6 +209,11 @@ struct PipelineInitializer
         mDepthBias = depthBias;
     }
 
+    void SetInputLayout(InputLayout inputLayout)
+    {
+        mInputLayout = inputLayout;
+    }
+
     // enable DepthTest, StencilTest, AntiAliasedLine, Blend
 
     static PipelineInitializer Default()
@@ -217,7 +226,7 @@ struct PipelineInitializer
             true,               // enable AlphaToCoverageEnable
             BlendType::COLOR,
             ColorMask::ALL,
-            0,
+            InputLayout::INFERRED,
             BlendMode::SRC_ALPHA,
         	BlendMode::INV_SRC_ALPHA,
         	BlendOperation::ADD,
@@ -274,7 +283,7 @@ struct PipelineInitializer
 
     BlendType mBlendType;
     ColorMask mRenderTargetWriteMask;
-    uint8_t mPadding[1];
+    InputLayout mInputLayout;
     //BlendType mBlendTypes[8];
     /*ColorMask mRenderTargetWriteMask[8];*/
     union
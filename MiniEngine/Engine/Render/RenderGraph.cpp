@@ -0,0 +1,276 @@
+#include "RenderGraph.h"
+
+#include "Engine/common/Exception.h"
+
+void RenderGraph::Initialize(RHI* pRHI)
+{
+    mRHI = pRHI;
+}
+
+void RenderGraph::Reset()
+{
+    mResources.clear();
+    mAccesses.clear();
+    mPasses.clear();
+}
+
+RenderGraph::ResourceHandle RenderGraph::ImportRenderTarget(RHIRenderTarget* pRenderTarget)
+{
+    return AddResource(pRenderTarget->GetTextureDesc(), pRenderTarget, false);
+}
+
+RenderGraph::ResourceHandle RenderGraph::ImportDepthStencil(RHIDepthStencil* pDepthStencil)
+{
+    return AddResource(pDepthStencil->GetTextureDesc(), pDepthStencil, true);
+}
+
+RenderGraph::ResourceHandle RenderGraph::CreateRenderTarget(const RHITextureDesc& desc)
+{
+    return AddResource(desc, nullptr, false);
+}
+
+RenderGraph::ResourceHandle RenderGraph::CreateDepthStencil(const RHITextureDesc& desc)
+{
+    return AddResource(desc, nullptr, true);
+}
+
+uint16_t RenderGraph::AddPass(const char* name, ExecuteFunc execute, bool hasSideEffects)
+{
+    ASSERT(mPasses.size() < UINT16_MAX, TEXT("too many render graph passes"));
+    mPasses.push_back({ name, std::move(execute), static_cast<uint32_t>(mAccesses.size()), 0, hasSideEffects });
+    return static_cast<uint16_t>(mPasses.size() - 1);
+}
+
+void RenderGraph::Read(uint16_t pass, ResourceHandle resource, ResourceAccess access)
+{
+    AddAccess(pass, resource, access, false);
+}
+
+void RenderGraph::Write(uint16_t pass, ResourceHandle resource, ResourceAccess access)
+{
+    AddAccess(pass, resource, access, true);
+}
+
+void RenderGraph::Compile()
+{
+    BuildTopology(mTopology);
+    if (mIsCompiled && mTopology == mCompiledTopology) return;
+    mCompiledTopology.swap(mTopology);
+    ++mNumCompilations;
+
+    // walk backwards from the outputs of the frame, a pass is live when a live pass reads what it writes.
+    const uint32_t numPasses = static_cast<uint32_t>(mPasses.size());
+    std::vector<uint8_t> isResourceNeeded(mResources.size(), 0);
+    std::vector<uint8_t> isPassLive(numPasses, 0);
+    for (size_t i = 0; i < mResources.size(); ++i)
+    {
+        isResourceNeeded[i] = mResources[i].mImported != nullptr;
+    }
+    for (uint32_t i = numPasses; i-- > 0;)
+    {
+        const Pass& pass = mPasses[i];
+        bool isLive = pass.mHasSideEffects;
+        for (uint32_t j = 0; j < pass.mNumAccesses && !isLive; ++j)
+        {
+            const Access& access = mAccesses[pass.mFirstAccess + j];
+            isLive = access.mIsWrite && isResourceNeeded[access.mResource];
+        }
+        if (!isLive) continue;
+        isPassLive[i] = 1;
+        for (uint32_t j = 0; j < pass.mNumAccesses; ++j)
+        {
+            const Access& access = mAccesses[pass.mFirstAccess + j];
+            if (!access.mIsWrite) isResourceNeeded[access.mResource] = 1;
+        }
+    }
+
+    AllocateTransientTextures(isPassLive);
+
+    // the state of every imported resource and transient texture at the end of the previous live pass. the states
+    // before the frame are unknown, the first use always transitions and the RHI drops the redundant ones.
+    const size_t numResources = mResources.size();
+    std::vector<ResourceAccess> states(numResources + mTextures.size(), ResourceAccess::UNKNOWN);
+    mCompiledPasses.clear();
+    mTransitions.clear();
+    for (uint32_t i = 0; i < numPasses; ++i)
+    {
+        if (!isPassLive[i]) continue;
+        const Pass& pass = mPasses[i];
+        CompiledPass compiledPass{ static_cast<uint16_t>(i), static_cast<uint32_t>(mTransitions.size()), 0 };
+        for (uint32_t j = 0; j < pass.mNumAccesses; ++j)
+        {
+            const Access& access = mAccesses[pass.mFirstAccess + j];
+            const uint16_t texture = mResourceTextures[access.mResource];
+            ResourceAccess& state = states[texture == INVALID_TEXTURE ? access.mResource : numResources + texture];
+            if (state == access.mAccess) continue;
+            // a pass can only use a resource in one state, the later declaration wins.
+            state = access.mAccess;
+            mTransitions.push_back({ access.mResource, access.mAccess });
+        }
+        compiledPass.mNumTransitions = static_cast<uint32_t>(mTransitions.size()) - compiledPass.mFirstTransition;
+        mCompiledPasses.push_back(compiledPass);
+    }
+    mIsCompiled = true;
+}
+
+RHIGraphicsContext* RenderGraph::Execute(RHIGraphicsContext* pContext)
+{
+    ASSERT(mIsCompiled, TEXT("render graph executed before it was compiled"));
+    for (const CompiledPass& compiledPass : mCompiledPasses)
+    {
+        mTransitionScratch.resize(compiledPass.mNumTransitions);
+        for (uint32_t i = 0; i < compiledPass.mNumTransitions; ++i)
+        {
+            const Transition& transition = mTransitions[compiledPass.mFirstTransition + i];
+            mTransitionScratch[i] = { GetNativeResource(transition.mResource), transition.mAccess };
+        }
+        if (!mTransitionScratch.empty())
+        {
+            pContext->TransitionResources(mTransitionScratch.data(), static_cast<uint32_t>(mTransitionScratch.size()));
+        }
+        pContext = mPasses[compiledPass.mPass].mExecute(pContext);
+    }
+    return pContext;
+}
+
+RHIRenderTarget* RenderGraph::GetRenderTarget(ResourceHandle resource) const
+{
+    ASSERT(resource < mResources.size() && !mResources[resource].mIsDepthStencil, TEXT("resource is not a render target"));
+    return static_cast<RHIRenderTarget*>(GetNativeResource(resource));
+}
+
+RHIDepthStencil* RenderGraph::GetDepthStencil(ResourceHandle resource) const
+{
+    ASSERT(resource < mResources.size() && mResources[resource].mIsDepthStencil, TEXT("resource is not a depth stencil"));
+    return static_cast<RHIDepthStencil*>(GetNativeResource(resource));
+}
+
+bool RenderGraph::IsPassCulled(uint16_t pass) const
+{
+    for (const CompiledPass& compiledPass : mCompiledPasses)
+    {
+        if (compiledPass.mPass == pass) return false;
+    }
+    return true;
+}
+
+RenderGraph::ResourceHandle RenderGraph::AddResource(const RHITextureDesc& desc, RHINativeResource* pImported, bool isDepthStencil)
+{
+    ASSERT(mResources.size() < INVALID_RESOURCE, TEXT("too many render graph resources"));
+    mResources.push_back({ desc, pImported, isDepthStencil });
+    return static_cast<ResourceHandle>(mResources.size() - 1);
+}
+
+void RenderGraph::AddAccess(uint16_t pass, ResourceHandle resource, ResourceAccess access, bool isWrite)
+{
+    ASSERT(!mPasses.empty() && pass == mPasses.size() - 1, TEXT("accesses have to be declared right after their pass"));
+    ASSERT(resource < mResources.size(), TEXT("invalid render graph resource"));
+    ASSERT((access == ResourceAccess::RENDER_TARGET) != mResources[resource].mIsDepthStencil, TEXT("access does not match the resource type"));
+    mAccesses.push_back({ resource, access, isWrite });
+    ++mPasses[pass].mNumAccesses;
+}
+
+void RenderGraph::BuildTopology(std::vector<uint64_t>& topology) const
+{
+    topology.clear();
+    topology.push_back(static_cast<uint64_t>(mResources.size()) << 32 | mPasses.size());
+    for (const Resource& resource : mResources)
+    {
+        const RHITextureDesc& desc = resource.mDesc;
+        // imported resources only count by type, they are different textures every frame.
+        topology.push_back(static_cast<uint64_t>(resource.mImported != nullptr) << 1 | resource.mIsDepthStencil);
+        if (resource.mImported) continue;
+        topology.push_back(static_cast<uint64_t>(desc.mWidth) << 32 | desc.mHeight);
+        topology.push_back(static_cast<uint64_t>(desc.mDepth) << 32 | static_cast<uint64_t>(desc.mFormat) << 24 |
+            static_cast<uint64_t>(desc.mDimension) << 16 | static_cast<uint64_t>(desc.mMipLevels) << 8 | desc.mSampleCount);
+    }
+    for (const Pass& pass : mPasses)
+    {
+        topology.push_back(static_cast<uint64_t>(pass.mNumAccesses) << 1 | pass.mHasSideEffects);
+    }
+    for (const Access& access : mAccesses)
+    {
+        topology.push_back(static_cast<uint64_t>(access.mResource) << 16 | static_cast<uint64_t>(access.mAccess) << 1 | access.mIsWrite);
+    }
+}
+
+void RenderGraph::AllocateTransientTextures(const std::vector<uint8_t>& isPassLive)
+{
+    const size_t numResources = mResources.size();
+    std::vector<uint32_t> firstUses(numResources, UINT32_MAX);
+    std::vector<uint32_t> lastUses(numResources, 0);
+    for (uint32_t i = 0; i < mPasses.size(); ++i)
+    {
+        if (!isPassLive[i]) continue;
+        const Pass& pass = mPasses[i];
+        for (uint32_t j = 0; j < pass.mNumAccesses; ++j)
+        {
+            const Access& access = mAccesses[pass.mFirstAccess + j];
+            if (mResources[access.mResource].mImported) continue;
+            if (firstUses[access.mResource] == UINT32_MAX)
+            {
+                firstUses[access.mResource] = i;
+                // the texture may hold the content of another resource, it has to be overwritten first.
+                ASSERT(access.mIsWrite, TEXT("transient resource is read before it was written"));
+            }
+            lastUses[access.mResource] = i;
+        }
+    }
+
+    // resources in the order they come alive, each takes the first texture of its description that is free by then.
+    std::vector<ResourceHandle> order;
+    for (size_t i = 0; i < numResources; ++i)
+    {
+        if (firstUses[i] != UINT32_MAX) order.push_back(static_cast<ResourceHandle>(i));
+    }
+    std::sort(order.begin(), order.end(), [&firstUses](ResourceHandle a, ResourceHandle b) { return firstUses[a] < firstUses[b]; });
+
+    mResourceTextures.assign(numResources, INVALID_TEXTURE);
+    std::vector<uint32_t> textureFreeAfter(mTextures.size(), 0);
+    std::vector<uint8_t> isTextureUsed(mTextures.size(), 0);
+    for (ResourceHandle handle : order)
+    {
+        const Resource& resource = mResources[handle];
+        uint16_t selected = INVALID_TEXTURE;
+        for (uint16_t i = 0; i < mTextures.size(); ++i)
+        {
+            const TransientTexture& texture = mTextures[i];
+            if (texture.mIsDepthStencil != resource.mIsDepthStencil || !(texture.mDesc == resource.mDesc)) continue;
+            if (isTextureUsed[i] && textureFreeAfter[i] >= firstUses[handle]) continue;
+            selected = i;
+            break;
+        }
+        if (selected == INVALID_TEXTURE)
+        {
+            ASSERT(mTextures.size() < INVALID_TEXTURE, TEXT("too many transient textures"));
+            selected = static_cast<uint16_t>(mTextures.size());
+            mTextures.emplace_back();
+            textureFreeAfter.push_back(0);
+            isTextureUsed.push_back(0);
+            TransientTexture& texture = mTextures[selected];
+            texture.mDesc = resource.mDesc;
+            texture.mIsDepthStencil = resource.mIsDepthStencil;
+            if (resource.mIsDepthStencil)
+            {
+                texture.mDepthStencil = mRHI->RHIAllocDepthStencil(resource.mDesc);
+            }
+            else
+            {
+                texture.mRenderTarget = mRHI->RHIAllocRenderTarget(resource.mDesc);
+            }
+        }
+        isTextureUsed[selected] = 1;
+        textureFreeAfter[selected] = lastUses[handle];
+        mResourceTextures[handle] = selected;
+    }
+}
+
+RHINativeResource* RenderGraph::GetNativeResource(ResourceHandle resource) const
+{
+    const Resource& declared = mResources[resource];
+    if (declared.mImported) return declared.mImported;
+    const uint16_t texture = mResourceTextures[resource];
+    ASSERT(texture != INVALID_TEXTURE, TEXT("resource is only used by culled passes"));
+    const TransientTexture& transient = mTextures[texture];
+    return transient.mIsDepthStencil ? static_cast<RHINativeResource*>(transient.mDepthStencil.get()) : transient.mRenderTarget.get();
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include "DynamicRHI.h"
+
+// Graph of the passes of a frame over render targets and depth stencils, declared again every frame.
+// Passes declare the resources they read and write. Compiling culls the passes whose output is never used, computes
+// the transitions between passes as one batch per pass and maps transient textures with disjoint lifetimes onto the
+// same texture. The compiled graph is kept while the passes and their accesses stay the same, so an unchanged frame
+// only pays for the declarations.
+class RenderGraph
+{
+public:
+    using ResourceHandle = uint16_t;
+    // returns the context recording continues with, a pass recorded in parallel may hand over to another context.
+    using ExecuteFunc = std::function<RHIGraphicsContext*(RHIGraphicsContext*)>;
+    static constexpr ResourceHandle INVALID_RESOURCE = UINT16_MAX;
+    static constexpr uint16_t INVALID_TEXTURE = UINT16_MAX;
+
+    void Initialize(RHI* pRHI);
+    // drops the declarations of the last frame, the compiled graph and the transient textures are kept.
+    void Reset();
+    // resources owned outside of the graph, their content is an output of the frame.
+    ResourceHandle ImportRenderTarget(RHIRenderTarget* pRenderTarget);
+    ResourceHandle ImportDepthStencil(RHIDepthStencil* pDepthStencil);
+    // textures that only live during the frame, the first pass using one has to write it.
+    ResourceHandle CreateRenderTarget(const RHITextureDesc& desc);
+    ResourceHandle CreateDepthStencil(const RHITextureDesc& desc);
+    // a pass with side effects is kept even if nothing reads what it writes.
+    uint16_t AddPass(const char* name, ExecuteFunc execute, bool hasSideEffects = false);
+    // accesses are declared right after adding their pass.
+    void Read(uint16_t pass, ResourceHandle resource, ResourceAccess access);
+    void Write(uint16_t pass, ResourceHandle resource, ResourceAccess access);
+    // reuses the last compiled graph when the topology did not change.
+    void Compile();
+    RHIGraphicsContext* Execute(RHIGraphicsContext* pContext);
+
+    // valid between Compile and the next Reset.
+    RHIRenderTarget* GetRenderTarget(ResourceHandle resource) const;
+    RHIDepthStencil* GetDepthStencil(ResourceHandle resource) const;
+    bool IsPassCulled(uint16_t pass) const;
+    uint32_t GetNumTransientTextures() const { return static_cast<uint32_t>(mTextures.size()); }
+    uint32_t GetNumCompilations() const { return mNumCompilations; }
+
+private:
+    struct Resource
+    {
+        RHITextureDesc mDesc;
+        RHINativeResource* mImported;
+        bool mIsDepthStencil;
+    };
+    struct Access
+    {
+        ResourceHandle mResource;
+        ResourceAccess mAccess;
+        bool mIsWrite;
+    };
+    struct Pass
+    {
+        const char* mName;
+        ExecuteFunc mExecute;
+        uint32_t mFirstAccess;
+        uint32_t mNumAccesses;
+        bool mHasSideEffects;
+    };
+    // transitions name resources instead of textures, imported resources change every frame.
+    struct Transition
+    {
+        ResourceHandle mResource;
+        ResourceAccess mAccess;
+    };
+    struct CompiledPass
+    {
+        uint16_t mPass;
+        uint32_t mFirstTransition;
+        uint32_t mNumTransitions;
+    };
+    struct TransientTexture
+    {
+        RHITextureDesc mDesc;
+        std::unique_ptr<RHIRenderTarget> mRenderTarget;
+        std::unique_ptr<RHIDepthStencil> mDepthStencil;
+        bool mIsDepthStencil;
+    };
+
+    ResourceHandle AddResource(const RHITextureDesc& desc, RHINativeResource* pImported, bool isDepthStencil);
+    void AddAccess(uint16_t pass, ResourceHandle resource, ResourceAccess access, bool isWrite);
+    void BuildTopology(std::vector<uint64_t>& topology) const;
+    // assigns a texture to every transient resource used by a live pass, resources whose lifetimes do not overlap
+    // share a texture of the same description.
+    void AllocateTransientTextures(const std::vector<uint8_t>& isPassLive);
+    RHINativeResource* GetNativeResource(ResourceHandle resource) const;
+
+    RHI* mRHI = nullptr;
+    std::vector<Resource> mResources;
+    std::vector<Access> mAccesses;
+    std::vector<Pass> mPasses;
+
+    // the compiled graph, valid while the topology matches mCompiledTopology
+    std::vector<uint64_t> mTopology;
+    std::vector<uint64_t> mCompiledTopology;
+    std::vector<CompiledPass> mCompiledPasses;
+    std::vector<Transition> mTransitions;
+    std::vector<uint16_t> mResourceTextures;   // per resource, INVALID_TEXTURE for imported and culled resources
+    // never released, frames in flight may still render into textures a newer topology stopped using.
+    std::vector<TransientTexture> mTextures;
+    std::vector<RHIResourceTransition> mTransitionScratch;
+    uint32_t mNumCompilations = 0;
+    bool mIsCompiled = false;
+};
@@ -31,6 +31,10 @@ struct RenderItem
     Matrix4x4 mModelInverse = Matrix4x4::Identity;
     MeshData mMeshData{};
     MaterialInstance* mMaterial = nullptr;
+    Vector4 mColor = {1, 1, 1, 1};          // per instance color, only read by instanced shaders
+    uint64_t mSortKey = 0;                  // see RenderSortKey, written by the renderer before drawing
+    uint32_t mObjectSlot = UINT32_MAX;      // persistent object constants, see Renderer::allocObjectConstants
+    bool mDepthPrePassed = false;           // drawn into the depth pre-pass this frame, written by the renderer
 };
 
 struct RenderList final
@@ -0,0 +1,89 @@
+#include "RenderSort.h"
+
+#include "Engine/common/helper.h"
+
+namespace
+{
+    uint64_t Fold16(uint64_t value)
+    {
+        value ^= value >> 32;
+        value ^= value >> 16;
+        return value & 0xffff;
+    }
+
+    // buffers are allocated with a coarse alignment, mix the address so neighbouring meshes spread over the field.
+    uint64_t MeshId(const void* pMesh)
+    {
+        return Fold16(MurmurHash(reinterpret_cast<uint64_t>(pMesh), 0));
+    }
+}
+
+uint32_t RenderSortKey::QuantizeDepth(float viewDepth, uint32_t numBits)
+{
+    // objects behind the camera are only partially visible, treat them as touching the near plane.
+    if (!(viewDepth > 0)) return 0;
+    uint32_t bits;
+    memcpy(&bits, &viewDepth, sizeof(bits));
+    return bits >> (31 - numBits);
+}
+
+uint64_t RenderSortKey::Opaque(uint64_t pipelineHash, uint64_t materialId, const void* pMesh, float viewDepth)
+{
+    return LAYER_OPAQUE << 62 | Fold16(pipelineHash) << 46 | (materialId & 0xffff) << 30 | MeshId(pMesh) << 14 |
+        QuantizeDepth(viewDepth, 14);
+}
+
+uint64_t RenderSortKey::Transparent(uint64_t pipelineHash, uint64_t materialId, const void* pMesh, float viewDepth)
+{
+    const uint64_t invertedDepth = 0xffff - QuantizeDepth(viewDepth, 16);
+    return LAYER_TRANSPARENT << 62 | invertedDepth << 46 | Fold16(pipelineHash) << 30 | (materialId & 0xffff) << 14 |
+        (MeshId(pMesh) & 0x3fff);
+}
+
+uint64_t RenderSortKey::Overlay(uint32_t order)
+{
+    return LAYER_OVERLAY << 62 | order;
+}
+
+void RadixSortRenderItems(std::vector<SortedRenderItem>& items, std::vector<SortedRenderItem>& scratch)
+{
+    constexpr uint32_t NUM_DIGITS = sizeof(uint64_t);
+    const size_t count = items.size();
+    if (count < 2) return;
+    scratch.resize(count);
+
+    // histograms of all digits in a single pass
+    uint32_t histograms[NUM_DIGITS][256] = {};
+    for (const SortedRenderItem& item : items)
+    {
+        for (uint32_t digit = 0; digit < NUM_DIGITS; ++digit)
+        {
+            ++histograms[digit][(item.mKey >> (digit * 8)) & 0xff];
+        }
+    }
+
+    SortedRenderItem* pSource = items.data();
+    SortedRenderItem* pDest = scratch.data();
+    for (uint32_t digit = 0; digit < NUM_DIGITS; ++digit)
+    {
+        uint32_t* histogram = histograms[digit];
+        const uint32_t shift = digit * 8;
+        // every key has the same value in this digit, the pass would only copy.
+        if (histogram[(pSource[0].mKey >> shift) & 0xff] == count) continue;
+
+        uint32_t offset = 0;
+        for (uint32_t bucket = 0; bucket < 256; ++bucket)
+        {
+            uint32_t size = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += size;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            pDest[histogram[(pSource[i].mKey >> shift) & 0xff]++] = pSource[i];
+        }
+        std::swap(pSource, pDest);
+    }
+
+    if (pSource != items.data()) items.swap(scratch);
+}
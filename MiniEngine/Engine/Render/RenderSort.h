@@ -0,0 +1,35 @@
+#pragma once
+#include "Engine/pch.h"
+
+// 64 bit render item keys, sorting them ascending yields the submission order of a pass.
+// opaque:      [63..62] layer | [61..46] pipeline | [45..30] material | [29..14] mesh | [13..0] depth, front to back
+// transparent: [63..62] layer | [61..46] inverted depth, back to front | [45..30] pipeline | [29..14] material | [13..0] mesh
+// overlay:     [63..62] layer | [31..0] submission order, for ui that relies on the order it was added in
+class RenderSortKey
+{
+public:
+    enum Layer : uint64_t
+    {
+        LAYER_OPAQUE = 0,
+        LAYER_TRANSPARENT = 1,
+        LAYER_OVERLAY = 2
+    };
+
+    static uint64_t Opaque(uint64_t pipelineHash, uint64_t materialId, const void* pMesh, float viewDepth);
+    static uint64_t Transparent(uint64_t pipelineHash, uint64_t materialId, const void* pMesh, float viewDepth);
+    static uint64_t Overlay(uint32_t order);
+    static Layer GetLayer(uint64_t key) { return static_cast<Layer>(key >> 62); }
+
+    // keeps the exponent and the leading mantissa bits of a non-negative depth, which preserves the ordering.
+    static uint32_t QuantizeDepth(float viewDepth, uint32_t numBits);
+};
+
+struct SortedRenderItem
+{
+    uint64_t mKey;
+    uint32_t mIndex;
+};
+
+// stable LSD radix sort over 8 bit digits, digits shared by every key are skipped.
+// `scratch` is resized to match `items`, both keep their capacity between frames.
+void RadixSortRenderItems(std::vector<SortedRenderItem>& items, std::vector<SortedRenderItem>& scratch);
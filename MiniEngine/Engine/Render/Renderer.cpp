@@ -1,5 +1,11 @@
 #include "Renderer.h"
 
+#include "Engine/Application.h"
+#include "Engine/Utility/Profiler/Profiler.h"
+#include "Engine/Utility/Telemetry/Telemetry.h"
+#include "Engine/Utility/ThreadPool/ThreadPool.h"
+#include "Null/NullRHI.h"
+
 #ifdef WIN32
 #include "Engine/Dependencies/imGui/imgui.h"
 #include "Engine/Dependencies/imGui/imgui_impl_dx12.h"
@@ -27,6 +33,10 @@ std::unique_ptr<Material> Renderer::createMaterial(RHIShader* pShader)
 		case ShaderPropType::SAMPLER:
 			numSamplers++;
 			break;
+		case ShaderPropType::STRUCTURED_BUFFER:
+			// the element of the material table is a constant buffer in the material pool
+			numCBuffers += shaderProp.mName == "MaterialTable";
+			break;
 		}
 	}
 	Material* material = new Material();
@@ -51,6 +61,12 @@ std::unique_ptr<Material> Renderer::createMaterial(RHIShader* pShader)
 		if (prop.mType == ShaderPropType::CBUFFER && prop.mRegister >= 2)
 		{
 			material->mConstants[numCBuffers] = ConstantProperty{ propName, prop.mRegister, prop.mInfo.mCBufferSize };
+			for (const ShaderVariable& variable : pShader->GetShaderVariables())
+			{
+				if (variable.mRegister != prop.mRegister) continue;
+				const ConstantVariable constant{ static_cast<uint8_t>(numCBuffers), variable.mOffset, variable.mSize };
+				material->mVariables.emplace(MaterialInstance::PropertyId(variable.mName.c_str()), constant);
+			}
 			numCBuffers++;
 		}
 		else if (prop.mType == ShaderPropType::TEXTURE)
@@ -63,6 +79,25 @@ std::unique_ptr<Material> Renderer::createMaterial(RHIShader* pShader)
 			//material->mSamplers[numSamplers] = { propName };
 			numSamplers++;
 		}
+		else if (prop.mType == ShaderPropType::STRUCTURED_BUFFER && prop.mName == "InstanceBuffer")
+		{
+			ASSERT(!prop.mInfo.mCBufferSize || prop.mInfo.mCBufferSize == sizeof(InstanceData), TEXT("InstanceBuffer layout mismatch"));
+			material->mInstanceBufferSlot = prop.mRegister;
+		}
+		else if (prop.mType == ShaderPropType::STRUCTURED_BUFFER && prop.mName == "MaterialTable")
+		{
+			// one pool block per element, the block index is the element index.
+			ASSERT(!prop.mInfo.mCBufferSize || prop.mInfo.mCBufferSize == MaterialConstantPool::BLOCK_SIZE, TEXT("MaterialTable element must be padded to a pool block"));
+			material->mConstants[numCBuffers] = ConstantProperty{ propName, prop.mRegister, MaterialConstantPool::BLOCK_SIZE };
+			for (const ShaderVariable& variable : pShader->GetShaderVariables())
+			{
+				if (variable.mRegister != ShaderVariable::MATERIAL_TABLE) continue;
+				const ConstantVariable constant{ static_cast<uint8_t>(numCBuffers), variable.mOffset, variable.mSize };
+				material->mVariables.emplace(MaterialInstance::PropertyId(variable.mName.c_str()), constant);
+			}
+			material->mMaterialTableIndex = static_cast<uint8_t>(numCBuffers);
+			numCBuffers++;
+		}
 	}
 	return std::unique_ptr<Material>(material);
 
@@ -85,12 +120,21 @@ void Renderer::initialize()
 void Renderer::initialize(const RendererConfiguration& configuration)
 {
 	mPassConstants.reset(new PassConstants{});
+	mFrameArena.Initialize(64ull * 1024 * 1024, 64ull * 1024, 256ull * 1024, MemoryTag::RENDER);
+	for (VirtualLinearAllocator& arena : mWorkerArenas)
+	{
+		arena.Initialize(16ull * 1024 * 1024, 64ull * 1024, 0, MemoryTag::RENDER);
+	}
 
 	// initialize render hardware interface(rhi).
-#ifdef WIN32
+#if defined(USE_NULL_RHI)
+	mRenderHardwareInterface = new NullRHI();
+#elif defined(WIN32)
 	mRenderHardwareInterface = new D3D12RHI();
-#else
+#elif defined(ORBIS)
 	mRenderHardwareInterface = new PlayStationRHI();
+#else
+	mRenderHardwareInterface = new NullRHI();
 #endif
 	RHIConfiguration rhiConfiguration = RHIConfiguration::Default();
 	mRenderHardwareInterface->Initialize();
@@ -120,17 +164,26 @@ void Renderer::initialize(const RendererConfiguration& configuration)
 	{
 		mRenderHardwareInterface->RHICreateGraphicsContext(&pRenderContext);
 		mRenderContexts[i].mGraphicContext = std::unique_ptr<RHIGraphicsContext>(pRenderContext);
+		for (std::unique_ptr<RHIGraphicsContext>& workerContext : mRenderContexts[i].mWorkerContexts)
+		{
+			mRenderHardwareInterface->RHICreateGraphicsContext(&pRenderContext);
+			workerContext.reset(pRenderContext);
+		}
+		mRenderContexts[i].mNumAcquiredWorkerContexts = 0;
 		mRenderContexts[i].mFenceGPU = mRenderHardwareInterface->RHICreateFence();
 		mRenderContexts[i].mFenceCPU = 0;
 	}
 
-	RHICopyContext* pCopyContext;
-	mRenderHardwareInterface->RHICreateCopyContext(&pCopyContext);
-	mCopyContext.reset(pCopyContext);
-	mCopyFenceGPU = mRenderHardwareInterface->RHICreateFence();
-	mCopyFenceCPU = 0;
+	mUploadManager.Initialize(mRenderHardwareInterface);
+	mRenderGraph.Initialize(mRenderHardwareInterface);
 
 	createBuiltinResources();
+	mObjectConstantPool.Initialize(mRenderHardwareInterface, MAX_OBJECT_CONSTANTS);
+	mMaterialConstantPool.Initialize(mRenderHardwareInterface, MAX_MATERIAL_CONSTANT_BLOCKS);
+	mForwardRecorder.Initialize(mRenderHardwareInterface, &mObjectConstantPool, &mMaterialConstantPool);
+	static_assert(ObjectConstantPool::SLOT_SIZE == MaterialConstantPool::BLOCK_SIZE, "bindless tables share the element stride");
+	mRenderHardwareInterface->RHISetBindlessConstantTables(mObjectConstantPool.GetBuffer(), mMaterialConstantPool.GetBuffer(),
+		MaterialConstantPool::BLOCK_SIZE);
 
 	// prepare pipeline states
 	mPipeStateInitializers.resize(NUM_PRESETS);
@@ -139,13 +192,16 @@ void Renderer::initialize(const RendererConfiguration& configuration)
 	ASSERT(sPreDepthShader.mObject, TEXT("missing mShader : PreDepth"));
 	preDepth.SetShader(sPreDepthShader.mObject);
 	preDepth.SetBlend(false, false, BlendDesc::Disabled());
-	preDepth.SetDepthBias(DepthBiasSet::NORMAL);
+	// no depth bias and the depth clipping of the opaque pass, the opaque pass tests for the exact depth written here.
+	// stencil operations run once, in the opaque pass.
+	preDepth.SetStencilTest(StencilTestDesc::Disabled());
 
 	PipelineInitializer& skybox = mPipeStateInitializers[PSO_SKY_BOX];
 	skybox = PipelineInitializer::Default();
 	skybox.SetBlend(false, false, BlendDesc::Disabled());
 	DepthTestDesc&& depthTest = DepthTestDesc::Default();
 	depthTest.mDepthWriteMask = 0;
+	depthTest.mDepthOperation = DepthOperation::READ_ONLY;
 	skybox.SetDepthTest(depthTest);
 	skybox.SetCullMode(CullMode::FRONT);
 	skybox.SetStencilTest(StencilTestDesc::Disabled());
@@ -184,56 +240,68 @@ IndexBufferRef Renderer::allocIndexBuffer(uint32_t numIndices, Format indexForma
 	return { allocGPUResource(pIndexBuffer), pIndexBuffer };
 }
 
+VertexBufferRef Renderer::allocPositionBuffer(const void* pVertices, uint32_t numVertices, uint32_t vertexSize, uint32_t positionSize,
+	bool blockRendering)
+{
+	std::vector<uint8_t> positions(static_cast<size_t>(numVertices) * positionSize);
+	const uint8_t* pVertex = static_cast<const uint8_t*>(pVertices);
+	for (uint32_t i = 0; i < numVertices; ++i, pVertex += vertexSize)
+	{
+		memcpy(&positions[static_cast<size_t>(i) * positionSize], pVertex, positionSize);
+	}
+	VertexBufferRef positionBuffer = allocVertexBuffer(numVertices, positionSize);
+	updateVertexBuffer(positions.data(), positions.size(), positionBuffer, blockRendering);
+	return positionBuffer;
+}
+
 TextureRef Renderer::allocTexture2D(Format format, uint32_t width, uint32_t height, uint8_t mipLevels)
 {
 	RHINativeTexture* pTexture = mRenderHardwareInterface->RHIAllocTexture({ format, TextureDimension::TEXTURE2D, width, height, 1, mipLevels, 1, 0 }).release();
 	return { allocGPUResource(pTexture), pTexture };
 }
 
+uint32_t Renderer::allocObjectConstants()
+{
+	return mObjectConstantPool.Allocate();
+}
+
+void Renderer::releaseObjectConstants(uint32_t slot)
+{
+	if (slot == ObjectConstantPool::INVALID_SLOT) return;
+	mObjectConstantPool.Free(slot);
+}
+
+void Renderer::invalidateObjectConstants(uint32_t slot)
+{
+	if (slot == ObjectConstantPool::INVALID_SLOT) return;
+	mObjectConstantPool.Invalidate(slot);
+}
+
+void Renderer::releaseConstantBuffers(const ConstantBufferRef* cbuffers, uint32_t numCBuffers)
+{
+	std::vector<RHIConstantBuffer*>& releasingCBuffers = mRenderContexts[mCurrentRenderContextIndex].mReleasingCBuffers;
+	for (uint32_t i = 0; i < numCBuffers; ++i)
+	{
+		if (cbuffers[i].Get()) releasingCBuffers.push_back(cbuffers[i].Get());
+	}
+}
+
 void Renderer::updateVertexBuffer(const void* pData, uint64_t bufferSize, VertexBufferRef vertexBufferGPU, bool blockRendering)
 {
 	uint64_t size = std::min<uint64_t>(vertexBufferGPU->GetBuffer()->BufferSize(), bufferSize);
-	auto&& stagingBuffer = mRenderHardwareInterface->RHIAllocStagingBuffer(size);
-	mRenderHardwareInterface->RHIUpdateStagingBuffer(stagingBuffer.get(), pData, 0, size);
-	mCopyFenceGPU->Wait(mCopyFenceCPU);
-	mRenderHardwareInterface->RHIResetCopyContext(mCopyContext.get());
-	mCopyContext->UpdateBuffer(vertexBufferGPU.mObject, stagingBuffer.get(), size, 0, 0);
-	mRenderHardwareInterface->RHISubmitCopyCommands(mCopyContext.get());
-	mRenderHardwareInterface->RHISyncCopyContext(mCopyFenceGPU.get(), ++mCopyFenceCPU);
-
-	if (!blockRendering) return;;
-	mRenderContexts[mCurrentRenderContextIndex].mGraphicContext->InsertFence(mCopyFenceGPU.get(), mCopyFenceCPU);
+	mUploadManager.UploadBuffer(vertexBufferGPU.mObject, pData, size, blockRendering);
 }
 
 void Renderer::updateIndexBuffer(const void* pData, uint64_t bufferSize, IndexBufferRef indexBufferGPU, bool blockRendering)
 {
 	uint64_t size = std::min<uint64_t>(indexBufferGPU->GetBuffer()->BufferSize(), bufferSize);
-	auto&& stagingBuffer = mRenderHardwareInterface->RHIAllocStagingBuffer(size);
-	mRenderHardwareInterface->RHIUpdateStagingBuffer(stagingBuffer.get(), pData, 0, size);
-	mCopyFenceGPU->Wait(mCopyFenceCPU);
-	mRenderHardwareInterface->RHIResetCopyContext(mCopyContext.get());
-	mCopyContext->UpdateBuffer(indexBufferGPU.mObject, stagingBuffer.get(), size, 0, 0);
-	mRenderHardwareInterface->RHISubmitCopyCommands(mCopyContext.get());
-	mRenderHardwareInterface->RHISyncCopyContext(mCopyFenceGPU.get(), ++mCopyFenceCPU);
-
-	if (!blockRendering) return;;
-	mRenderContexts[mCurrentRenderContextIndex].mGraphicContext->InsertFence(mCopyFenceGPU.get(), mCopyFenceCPU);
+	mUploadManager.UploadBuffer(indexBufferGPU.mObject, pData, size, blockRendering);
 }
 
 void Renderer::updateTexture(const void* pData, TextureRef textureGPU, uint8_t mipmap, bool blockRendering)
 {
-	const RHITextureDesc& desc = textureGPU->GetDesc();
 	// TODO: support update multi-mips
-	std::unique_ptr<RHIStagingBuffer> pStagingBuffer = mRenderHardwareInterface->RHIAllocStagingTexture(desc, mipmap);
-	mRenderHardwareInterface->RHIUpdateStagingTexture(pStagingBuffer.get(), desc, pData, mipmap);
-	mCopyFenceGPU->Wait(mCopyFenceCPU);
-	mRenderHardwareInterface->RHIResetCopyContext(mCopyContext.get());
-	mCopyContext->UpdateTexture(textureGPU.mObject, pStagingBuffer.get(), 0);
-	mRenderHardwareInterface->RHISubmitCopyCommands(mCopyContext.get());
-	mRenderHardwareInterface->RHISyncCopyContext(mCopyFenceGPU.get(), ++mCopyFenceCPU);
-
-	if (!blockRendering) return;;
-	mRenderContexts[mCurrentRenderContextIndex].mGraphicContext->InsertFence(mCopyFenceGPU.get(), mCopyFenceCPU);
+	mUploadManager.UploadTexture(textureGPU.mObject, pData, mipmap, blockRendering);
 }
 
 void Renderer::EnqueueRenderPass(RenderPass renderPass)
@@ -258,6 +326,30 @@ std::unique_ptr<RHIShader> Renderer::compileShader(const Blob& blob, ShaderType
 	return mRenderHardwareInterface->RHICompileShader(blob, shaderTypes);
 }
 
+bool Renderer::loadShaderCache(const void* pData, uint64_t size)
+{
+	if (!mShaderCache.Load(pData, size)) return false;
+	mRenderHardwareInterface->RHISetShaderCache(&mShaderCache);
+	return true;
+}
+
+bool Renderer::loadPipelineStates(const void* pList, uint64_t listSize, const void* pLibrary, uint64_t librarySize)
+{
+	if (!mRenderHardwareInterface->RHILoadPipelineStates(pList, listSize, pLibrary, librarySize)) return false;
+	// shaders registered before the list was loaded are prewarmed now
+	std::lock_guard<std::mutex> lock(mShaderRegisterMutex);
+	for (const std::unique_ptr<RHIShader>& shader : mShaders)
+	{
+		if (shader) mRenderHardwareInterface->RHIPrewarmPipelineStates(shader.get());
+	}
+	return true;
+}
+
+void Renderer::savePipelineStates(std::vector<uint8_t>& list, std::vector<uint8_t>& library)
+{
+	mRenderHardwareInterface->RHISavePipelineStates(list, library);
+}
+
 ShaderRef Renderer::compileAndRegisterShader(const std::string& shaderName, const Blob& blob, ShaderType shaderTypes,
 	const std::string* path)
 {
@@ -286,6 +378,7 @@ ShaderRef Renderer::registerShader(std::unique_ptr<RHIShader>&& shader)
 		mShaders.emplace_back(shaderRef.mObject);
 	}
 	mShaderRegisterMutex.unlock();
+	mRenderHardwareInterface->RHIPrewarmPipelineStates(shaderRef.mObject);
 	return shaderRef;
 }
 
@@ -328,74 +421,70 @@ inline void Renderer::setFogConstants(const FogConstant& fogConstants) const
 
 void Renderer::render()
 {
+	PROFILE_SCOPE("Renderer::render");
+	mFrameArena.Reset();
+	for (VirtualLinearAllocator& arena : mWorkerArenas)
+	{
+		arena.Reset();
+	}
 	RenderContext& renderContext = mRenderContexts[mCurrentRenderContextIndex];
+	// commands go to the main context until a parallel pass hands over to its last worker context.
 	RHIGraphicsContext* graphicsContext = renderContext.mGraphicContext.get();
-	renderContext.mFenceGPU->Wait(renderContext.mFenceCPU);
+	{
+		PROFILE_SCOPE("Renderer::WaitForGPU");
+		renderContext.mFenceGPU->Wait(renderContext.mFenceCPU);
+	}
 	mRenderHardwareInterface->RHIResetGraphicsContext(graphicsContext);
+	renderContext.mNumAcquiredWorkerContexts = 0;
+	// uploads requested since the last frame reach the copy queue before any draw of this frame reads them.
+	mUploadManager.Submit(graphicsContext);
+	beginFrame(&renderContext);
 	mSwapChain->BeginFrame(graphicsContext);
 
-	for (auto& renderList : mRenderLists)
+	// TODO: support specify the render target and depth stencil.
+	RHIRenderTarget* pRenderTarget = mSwapChain->GetCurrentColorTexture();
+	RHIDepthStencil* pDepthStencil = mDepthStencilBuffer;
+	RHITextureDesc rtDesc = pRenderTarget->GetTextureDesc();
+	PassTargets targets{ pRenderTarget, pDepthStencil,
+		Viewport{static_cast<float>(rtDesc.mWidth), static_cast<float>(rtDesc.mHeight), 0, 1},
+		Rect{0, 0, static_cast<int32_t>(rtDesc.mWidth), static_cast<int32_t>(rtDesc.mHeight)} };
+	mPipeStateInitializers[PSO_SKY_BOX].SetFrameBuffers(pRenderTarget->GetFormat(), pDepthStencil->GetFormat());
+	mPipeStateInitializers[PSO_PRE_DEPTH].SetFrameBuffers(Format::UNKNOWN, pDepthStencil->GetFormat());
+	mPipeStateInitializers[PSO_OPAQUE].SetFrameBuffers(pRenderTarget->GetFormat(), pDepthStencil->GetFormat());
+	mPassConstants->mScreenParams = { targets.mViewport.mWidth, targets.mViewport.mHeight, 1, 1 };
+
+	mRenderGraph.Reset();
+	const RenderGraph::ResourceHandle colorTarget = mRenderGraph.ImportRenderTarget(pRenderTarget);
+	const RenderGraph::ResourceHandle depthTarget = mRenderGraph.ImportDepthStencil(pDepthStencil);
+	for (RenderList& renderList : mRenderLists)
 	{
-		// TODO: support specify the render target and depth stencil.
-		RHIRenderTarget* pRenderTarget = mSwapChain->GetCurrentColorTexture();
-		RHIDepthStencil* pDepthStencil = mDepthStencilBuffer;
-		RHITextureDesc rtDesc = pRenderTarget->GetTextureDesc();
-		Viewport viewports[] = { Viewport{static_cast<float>(rtDesc.mWidth), static_cast<float>(rtDesc.mHeight), 0, 1} };
-		Rect scissorRects[] = { Rect{0, 0, static_cast<int32_t>(rtDesc.mWidth), static_cast<int32_t>(rtDesc.mHeight)} };
-		// TODO: Calculations like this can move to pre-render phase.
-
-		mPipeStateInitializers[PSO_SKY_BOX].SetFrameBuffers(pRenderTarget->GetFormat(), pDepthStencil->GetFormat());
-		mPipeStateInitializers[PSO_PRE_DEPTH].SetFrameBuffers(Format::UNKNOWN, pDepthStencil->GetFormat());
-		mPipeStateInitializers[PSO_OPAQUE].SetFrameBuffers(pRenderTarget->GetFormat(), pDepthStencil->GetFormat());
-
-		mPassConstants->mScreenParams = { viewports[0].mWidth, viewports[0].mHeight, 1, 1 };
-		graphicsContext->SetViewPorts(viewports, 1);
-		graphicsContext->SetScissorRect(scissorRects, 1);
-
-		// graphicsContext->SetRenderTargetsAndDepthStencil(nullptr, 0, pDepthStencil);
-		graphicsContext->SetRenderTargetsAndDepthStencil(&pRenderTarget, 1, pDepthStencil);
-		if (renderList.mClearRenderTarget)
-		{
-			graphicsContext->ClearDepthStencil(pDepthStencil, true, true, 1, 0, nullptr, 0);
-			graphicsContext->ClearRenderTarget(pRenderTarget, renderList.mBackGroundColor, scissorRects, 1);
-		}
-
-		// depthPrePass(graphicsContext, renderList.mOpaqueList, renderList.mCameraConstants);
-
-		// graphicsContext->SetRenderTargetsAndDepthStencil(&pRenderTarget, 1, pDepthStencil);
-		if (renderList.mSkyboxShader)
-		{
-			skyboxPass(graphicsContext, *renderList.mSkyboxShader, renderList.mSkyBoxType, renderList.mCameraConstants);
-		}
-		opaquePass(graphicsContext, renderList.mOpaqueList, renderList.mCameraConstants);
-
-		// AHCommandList commandList{graphicsContext};
-		// commandList.SetCameraColorTarget(pRenderTarget);
-		// commandList.SetCameraDepthStencil(pDepthStencil);
-		// commandList.SetViewports(viewports, 1);
-		// commandList.SetScissorRects(scissorRects, 1);
-		//for (const RenderPass& pass : mCustomRenderPasses)
-		//{
-		//	pass(commandList);
-		//}
-		//mRenderHardwareInterface->RHISubmitRenderCommands(graphicsContext);
-
-		//mRenderHardwareInterface->RHIResetGraphicsContext(graphicsContext);
-		//graphicsContext->SetViewPorts(viewports, 1);
-		//graphicsContext->SetScissorRect(scissorRects, 1);
-
-
+		addForwardPasses(renderContext, renderList, targets, colorTarget, depthTarget);
 	}
-#ifdef WIN32
+	{
+		PROFILE_SCOPE("Renderer::RenderGraph");
+		mRenderGraph.Compile();
+		graphicsContext = mRenderGraph.Execute(graphicsContext);
+	}
+#if defined(WIN32) && !defined(USE_NULL_RHI)
 	D3D12GraphicsContext* pGConstext = static_cast<D3D12GraphicsContext*>(graphicsContext); // static_cast<D3D12GraphicsContext*>(commandList.GetRHIGraphicsContext());
 	ID3D12GraphicsCommandList* pCommandList = pGConstext->GetD3D12CommandList();
 	ImGui::Render();
 	ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), pCommandList);
 #endif
 	mSwapChain->EndFrame(graphicsContext);
-	mRenderHardwareInterface->RHISubmitRenderCommands(graphicsContext);
-	mRenderHardwareInterface->RHISyncGraphicContext(renderContext.mFenceGPU.get(), ++renderContext.mFenceCPU);
-	mSwapChain->Present();
+	{
+		PROFILE_SCOPE("Renderer::SubmitAndPresent");
+		// the worker contexts continue where the previous context stopped, submitting them in acquisition order
+		// keeps the command order of a serial recording.
+		mRenderHardwareInterface->RHISubmitRenderCommands(renderContext.mGraphicContext.get());
+		for (uint8_t i = 0; i < renderContext.mNumAcquiredWorkerContexts; ++i)
+		{
+			mRenderHardwareInterface->RHISubmitRenderCommands(renderContext.mWorkerContexts[i].get());
+		}
+		TELEMETRY_COUNT(COMMAND_LISTS, 1 + renderContext.mNumAcquiredWorkerContexts);
+		mRenderHardwareInterface->RHISyncGraphicContext(renderContext.mFenceGPU.get(), ++renderContext.mFenceCPU);
+		mSwapChain->Present();
+	}
 	mCurrentRenderContextIndex = (mCurrentRenderContextIndex + 1) % mNumRenderContexts;
 
 	mRenderLists.clear();
@@ -419,40 +508,105 @@ uint32_t Renderer::allocGPUResource(RHIObject* pObject)
 
 void Renderer::createBuiltinResources()
 {
+	// the pre-depth shader reads MeshData::mPositionBuffer, positions are its only input.
+	// builtin sources are compiled without a path to resolve includes from, the position is computed like ObjectToClip
+	// of Common.hlsl, see PreDepth.hlsl.
 	const char* builtinShaderSources[] = {
-		"cbuffer ObjectConstants : register(b1) { float4x4 m_model; float4x4 m_model_i; float4x4 m_view; float4x4 m_view_i; float4x4 m_projection; float4x4 m_projection_i; }; struct SimpleVertexInput{float3 position : POSITION;float3 normal : NORMAL;float2 uv : TEXCOORD;};struct FragInput{float4 position : SV_POSITION;};FragInput VsMain(SimpleVertexInput input){FragInput o;float4 worldPosition = mul(m_model, float4(input.position, 1));o.position = mul(m_projection, mul(m_view, worldPosition));return o;}",
+		"cbuffer CameraConstants : register(b0) { float4x4 m_view; float4x4 m_view_i; float4x4 m_projection; float4x4 m_projection_i; }; cbuffer ObjectConstants : register(b1) { float4x4 m_model; float4x4 m_model_i; }; struct SimpleVertexInput{float3 position : POSITION;};struct FragInput{float4 position : SV_POSITION;};FragInput VsMain(SimpleVertexInput input){FragInput o;o.position = mul(mul(mul(float4(input.position, 1), m_model), m_view), m_projection);return o;}",
 	};
 
 	Blob shaderSource{builtinShaderSources[0], strlen(builtinShaderSources[0])};
 	sPreDepthShader = compileAndRegisterShader(TEXT("PreDepth"), shaderSource, ShaderType::VERTEX);
 }
 
+void Renderer::addForwardPasses(RenderContext& renderContext, RenderList& renderList, const PassTargets& targets,
+	RenderGraph::ResourceHandle colorTarget, RenderGraph::ResourceHandle depthTarget)
+{
+	// the passes run after all lists were declared, everything they read has to live until the end of the frame.
+	if (renderList.mClearRenderTarget)
+	{
+		uint16_t clear = mRenderGraph.AddPass("Clear", [&renderList, targets](RHIGraphicsContext* pContext)
+		{
+			bindPassTargets(pContext, targets);
+			pContext->ClearDepthStencil(targets.mDepthStencil, true, true, 1, 0, nullptr, 0);
+			pContext->ClearRenderTarget(targets.mRenderTarget, renderList.mBackGroundColor, &targets.mScissorRect, 1);
+			return pContext;
+		});
+		mRenderGraph.Write(clear, colorTarget, ResourceAccess::RENDER_TARGET);
+		mRenderGraph.Write(clear, depthTarget, ResourceAccess::DEPTH_WRITE);
+	}
+
+	// declared even without occluders, the topology of the graph stays the same from frame to frame.
+	uint16_t preDepth = mRenderGraph.AddPass("DepthPrePass", [this, &renderList, targets](RHIGraphicsContext* pContext)
+	{
+		PROFILE_SCOPE("Renderer::depthPrePass");
+		bindPassTargets(pContext, targets);
+		depthPrePass(pContext, renderList.mOpaqueList, renderList.mCameraConstants);
+		return pContext;
+	});
+	mRenderGraph.Read(preDepth, depthTarget, ResourceAccess::DEPTH_WRITE);
+	mRenderGraph.Write(preDepth, depthTarget, ResourceAccess::DEPTH_WRITE);
+
+	if (renderList.mSkyboxShader)
+	{
+		uint16_t skybox = mRenderGraph.AddPass("Skybox", [this, &renderList, targets](RHIGraphicsContext* pContext)
+		{
+			bindPassTargets(pContext, targets);
+			skyboxPass(pContext, *renderList.mSkyboxShader, renderList.mSkyBoxType, renderList.mCameraConstants);
+			return pContext;
+		});
+		mRenderGraph.Write(skybox, colorTarget, ResourceAccess::RENDER_TARGET);
+		// depth tested without writes, the depth stencil view is still bound writable
+		mRenderGraph.Read(skybox, depthTarget, ResourceAccess::DEPTH_WRITE);
+	}
+
+	uint16_t opaque = mRenderGraph.AddPass("Opaque", [this, &renderContext, &renderList, targets](RHIGraphicsContext* pContext)
+	{
+		PROFILE_SCOPE("Renderer::opaquePass");
+		bindPassTargets(pContext, targets);
+		sortRenderItems(renderList.mOpaqueList, renderList.mCameraConstants);
+		return opaquePass(renderContext, pContext, targets, renderList.mOpaqueList, mSortedItems, renderList.mCameraConstants);
+	});
+	mRenderGraph.Write(opaque, colorTarget, ResourceAccess::RENDER_TARGET);
+	mRenderGraph.Read(opaque, depthTarget, ResourceAccess::DEPTH_WRITE);
+	mRenderGraph.Write(opaque, depthTarget, ResourceAccess::DEPTH_WRITE);
+}
+
 void Renderer::beginFrame(RenderContext* pRenderContext)
 {
 	auto& renderContext = *pRenderContext;
 	mRenderHardwareInterface->RHIReleaseConstantBuffers(renderContext.mReleasingCBuffers.data(), renderContext.mReleasingCBuffers.size());
 	renderContext.mReleasingCBuffers.clear();
+
+	// items of the same object share its slot, only the slots of objects that moved since their last upload are
+	// rewritten, see invalidateObjectConstants.
+	ObjectConstants objectConstants{};
+	int64_t numObjectsUpdated = 0;
 	for (const RenderList& renderList : mRenderLists)
 	{
-		for (const RenderItem& opaqueItem : renderList.mOpaqueList)
+		for (const RenderItem& renderItem : renderList.mOpaqueList)
 		{
-			MaterialInstance& materialInstance = *opaqueItem.mMaterial;
-			if (!materialInstance.mIsDirty) continue;
-			const Material& material = *materialInstance.mMaterial;
-			// if the constants of material instance is dirty, reallocate constant buffers for this material.
-			for (int i = 0; i < material.mNumConstants; ++i)
-			{
-				ConstantBufferRef& cbufferRef = materialInstance.mConstantsGPU[i];
-				mGPUResources[cbufferRef.mIndex].release();
-				renderContext.mReleasingCBuffers.push_back(cbufferRef.mObject);
-				cbufferRef.mObject = mRenderHardwareInterface->RHIAllocConstantBuffer(material.mConstants[i].mConstantSize).release();
-				mGPUResources[cbufferRef.mIndex].reset(cbufferRef.mObject);
-				const Blob& cbufferCache = materialInstance.GetConstantBuffer(i);
-				mRenderHardwareInterface->RHIUpdateConstantBuffer(cbufferRef.mObject, cbufferCache.Binary(), 0, cbufferCache.Size());
-			}
+			if (renderItem.mObjectSlot == ObjectConstantPool::INVALID_SLOT || !mObjectConstantPool.IsStale(renderItem.mObjectSlot)) continue;
+			objectConstants.mModel = renderItem.mMeshData.vertexModel(renderItem.mModel);
+			objectConstants.mModelInverse = renderItem.mModelInverse;
+			objectConstants.mPositionOffset = renderItem.mMeshData.positionOffset();
+			objectConstants.mPositionScale = renderItem.mMeshData.positionScale();
+			mObjectConstantPool.Update(renderItem.mObjectSlot, &objectConstants, sizeof(ObjectConstants));
+			++numObjectsUpdated;
 		}
 	}
-	mRenderHardwareInterface->RHIResetGraphicsContext(pRenderContext->mGraphicContext.get());
+	TELEMETRY_COUNT(OBJECT_CONSTANTS_UPDATED, numObjectsUpdated);
+	TELEMETRY_COUNT(CONSTANT_BYTES_UPLOADED, mObjectConstantPool.Flush(renderContext.mGraphicContext.get()));
+
+	// materials are shared between items and slices, their constants are uploaded before anything is recorded.
+	for (const RenderList& renderList : mRenderLists)
+	{
+		for (const RenderItem& renderItem : renderList.mOpaqueList)
+		{
+			renderItem.mMaterial->UploadConstants(mMaterialConstantPool);
+		}
+	}
+	TELEMETRY_COUNT(CONSTANT_BYTES_UPLOADED, mMaterialConstantPool.Flush(renderContext.mGraphicContext.get()));
 }
 
 void Renderer::skyboxPass(RHIGraphicsContext* pRenderContext, const RHIShader& skyboxShader,
@@ -487,11 +641,14 @@ void Renderer::skyboxPass(RHIGraphicsContext* pRenderContext, const RHIShader& s
 		cbuffer = pRenderContext->AllocConstantBuffer(sizeof(SkyBoxConstants));
 		mRenderHardwareInterface->RHIUpdateConstantBuffer(cbuffer.get(), &skyboxConstants, 0, sizeof(SkyBoxConstants));
 		pRenderContext->SetConstantBuffer(1, cbuffer.get());
+		TELEMETRY_COUNT(CONSTANT_BUFFER_ALLOCATIONS, 2);
+		TELEMETRY_COUNT(CONSTANT_BYTES_UPLOADED, sizeof(LightConstant) + sizeof(SkyBoxConstants));
 		pRenderContext->SetVertexBuffers(nullptr, 0);
 		pRenderContext->SetIndexBuffer(sQuadMeshIndexBuffer.mObject);
 		pRenderContext->EndBindings();
 
 		pRenderContext->DrawIndexedInstanced(6, 0, 0, 1, 0);
+		TELEMETRY_COUNT(DRAW_CALLS, 1);
 		}
 		break;
 	default:
@@ -500,111 +657,215 @@ void Renderer::skyboxPass(RHIGraphicsContext* pRenderContext, const RHIShader& s
 	}
 }
 
-void Renderer::depthPrePass(RHIGraphicsContext* pRenderContext, const std::vector<RenderItem>& renderItems, const CameraConstants& cameraConstants)
+void Renderer::depthPrePass(RHIGraphicsContext* pRenderContext, std::vector<RenderItem>& renderItems, const CameraConstants& cameraConstants)
 {
+	// front to back, the nearest occluders reject the pixels of the ones behind them.
+	const float* viewDepthRow = cameraConstants.mView.m.m[2];
+	mOccluders.clear();
+	for (uint32_t i = 0; i < renderItems.size(); ++i)
+	{
+		RenderItem& renderItem = renderItems[i];
+		renderItem.mDepthPrePassed = isOccluder(renderItem, cameraConstants);
+		if (!renderItem.mDepthPrePassed) continue;
+		const auto& model = renderItem.mModel.m.m;
+		float viewDepth = viewDepthRow[0] * model[0][3] + viewDepthRow[1] * model[1][3] + viewDepthRow[2] * model[2][3] + viewDepthRow[3];
+		// the bits of a non negative float sort like the float.
+		uint32_t depthBits;
+		viewDepth = std::max(viewDepth, 0.0f);
+		memcpy(&depthBits, &viewDepth, sizeof(depthBits));
+		mOccluders.push_back({ depthBits, i });
+	}
+	if (mOccluders.empty()) return;
+	RadixSortRenderItems(mOccluders, mSortScratch);
+	TELEMETRY_COUNT(DEPTH_PRE_PASS_ITEMS, mOccluders.size());
+
 	PipelineInitializer& preDepthPSO = mPipeStateInitializers[PSO_PRE_DEPTH];
-	TransformConstants transform{Matrix4x4::Identity, Matrix4x4::Identity, cameraConstants };
-	for (const auto& renderItem : renderItems)
+	mForwardRecorder.BindCameraConstants(pRenderContext, cameraConstants);
+	bool hasPipelineState = false;
+	uint64_t lastPipelineState = 0;
+	const RHIVertexBuffer* pLastVertexBuffer = nullptr;
+	const RHIIndexBuffer* pLastIndexBuffer = nullptr;
+	uint32_t numPipelineChanges = 0;
+	for (const SortedRenderItem& occluder : mOccluders)
 	{
+		const RenderItem& renderItem = renderItems[occluder.mIndex];
 		const MaterialInstance& material = *renderItem.mMaterial;
-		const DepthTestDesc& depthTest = renderItem.mMaterial->DepthTest();
-		if (!depthTest.mEnableDepthTest) continue;
-
+		// the depth only variant of the material, its rasterizer state and depth test without the pixel shader.
 		preDepthPSO.SetCullMode(material.GetCullMode());
-		preDepthPSO.SetDrawMode(renderItem.mMaterial->GetDrawMode());
-		preDepthPSO.SetDepthTest(depthTest);
-		preDepthPSO.SetStencilTest(material.StencilTest());
-		pRenderContext->SetPipelineState(preDepthPSO);
-
-		transform.mModel = renderItem.mModel;
-		transform.mModelInverse = renderItem.mModelInverse;
-		std::unique_ptr<RHIConstantBuffer> cbuffer = pRenderContext->AllocConstantBuffer(sizeof(TransformConstants));
-		mRenderHardwareInterface->RHIUpdateConstantBuffer(cbuffer.get(), &transform, 0, sizeof(TransformConstants));
-
-		pRenderContext->BeginBinding();
-		pRenderContext->SetConstantBuffer(1, cbuffer.get());
+		preDepthPSO.SetDrawMode(material.GetDrawMode());
+		preDepthPSO.SetDepthTest(material.DepthTest());
+		preDepthPSO.SetInputLayout(renderItem.mMeshData.mInputLayout == InputLayout::COMPACT ? InputLayout::COMPACT_POSITION : InputLayout::INFERRED);
+		const uint64_t pipelineState = preDepthPSO.Hash();
+		if (!hasPipelineState || pipelineState != lastPipelineState)
+		{
+			pRenderContext->SetPipelineState(preDepthPSO);
+			hasPipelineState = true;
+			lastPipelineState = pipelineState;
+			++numPipelineChanges;
+		}
+		mForwardRecorder.BindObjectConstants(pRenderContext, renderItem);
 
-		RHIVertexBuffer* vertexBuffers[] = { renderItem.mMeshData.mVertexBuffer.mObject };
-		pRenderContext->SetVertexBuffers(vertexBuffers, 1);
-		pRenderContext->SetIndexBuffer(renderItem.mMeshData.mIndexBuffer.mObject);
-		pRenderContext->EndBindings();
+		RHIVertexBuffer* vertexBuffers[] = { renderItem.mMeshData.mPositionBuffer.mObject };
+		if (vertexBuffers[0] != pLastVertexBuffer)
+		{
+			pRenderContext->SetVertexBuffers(vertexBuffers, 1);
+			pLastVertexBuffer = vertexBuffers[0];
+		}
+		if (renderItem.mMeshData.mIndexBuffer.mObject != pLastIndexBuffer)
+		{
+			pRenderContext->SetIndexBuffer(renderItem.mMeshData.mIndexBuffer.mObject);
+			pLastIndexBuffer = renderItem.mMeshData.mIndexBuffer.mObject;
+		}
 
 		const SubMesh* subMeshes = renderItem.mMeshData.mSubMeshes.get();
 		uint32_t numSubMeshes = renderItem.mMeshData.mSubMeshCount;
 		for (uint32_t i = 0; i < numSubMeshes; ++i)
 		{
-			// TODO: support gpu instancing.
 			pRenderContext->DrawIndexedInstanced(subMeshes[i].mIndexNum, subMeshes[i].mStartIndex, subMeshes[i].mBaseVertex, 1, 0);
 		}
+		TELEMETRY_COUNT(DRAW_CALLS, numSubMeshes);
 	}
+	TELEMETRY_COUNT(PIPELINE_STATE_CHANGES, numPipelineChanges);
 }
 
-void Renderer::opaquePass(RHIGraphicsContext* pRenderContext, const std::vector<RenderItem>& renderItems, const CameraConstants& cameraConstants)
+bool Renderer::isOccluder(const RenderItem& renderItem, const CameraConstants& cameraConstants) const
 {
+	const MaterialInstance& material = *renderItem.mMaterial;
+	const MeshData& meshData = renderItem.mMeshData;
+	if (!material.DepthPrePassEnabled() || !meshData.mPositionBuffer.IsValid() || !meshData.mBounds.IsValid()) return false;
+	// the pre-pass only writes depth the opaque pass covers with color, so blended, clipped and stencil masked
+	// items stay out, as well as items the opaque pass skips.
+	const DepthTestDesc& depthTest = material.DepthTest();
+	if (!depthTest.mEnableDepthTest || depthTest.mDepthOperation != DepthOperation::WRITE) return false;
+	if (material.BlendMode().mEnableBlend || material.AlphaClipEnabled()) return false;
+	const StencilTestDesc& stencilTest = material.StencilTest();
+	if (stencilTest.mEnableStencilTest &&
+		(stencilTest.mFrontStencilFunc != CompareFunction::ALWAYS || stencilTest.mBackStencilFunc != CompareFunction::ALWAYS)) return false;
+	if (!isUploaded(renderItem) || !mUploadManager.IsReady(meshData.mPositionBuffer->GetBuffer())) return false;
+
+	// projected radius of the bounding sphere, w of the center is its view depth in perspective and 1 in orthographic projections.
+	const BoundingBox bounds = meshData.mBounds.Transform(renderItem.mModel);
+	const float radius = std::sqrt(bounds.mExtents[0] * bounds.mExtents[0] + bounds.mExtents[1] * bounds.mExtents[1] + bounds.mExtents[2] * bounds.mExtents[2]);
+	const float* viewDepthRow = cameraConstants.mView.m.m[2];
+	const float viewDepth = viewDepthRow[0] * bounds.mCenter[0] + viewDepthRow[1] * bounds.mCenter[1] + viewDepthRow[2] * bounds.mCenter[2] + viewDepthRow[3];
+	const auto& projection = cameraConstants.mProjection.m.m;
+	const float w = projection[3][2] * viewDepth + projection[3][3];
+	if (w <= 0) return false;
+	// the screen is 2 high in clip space, so this is the diameter relative to the screen height.
+	return radius * std::abs(projection[1][1]) / w >= MIN_OCCLUDER_SCREEN_SIZE;
+}
+
+void Renderer::sortRenderItems(std::vector<RenderItem>& renderItems, const CameraConstants& cameraConstants)
+{
+	PROFILE_SCOPE("Renderer::sortRenderItems");
 	PipelineInitializer& opaquePSO = mPipeStateInitializers[PSO_OPAQUE];
-	TransformConstants transform{ Matrix4x4::Identity, Matrix4x4::Identity, cameraConstants };
-	for (const auto& renderItem : renderItems)
+	mSortedItems.clear();
+	mSortedItems.reserve(renderItems.size());
+	for (uint32_t i = 0; i < renderItems.size(); ++i)
 	{
-		// set pipeline states
-		const MaterialInstance& material = *renderItem.mMaterial;
-		opaquePSO.SetCullMode(material.GetCullMode());
-		opaquePSO.SetDrawMode(material.GetDrawMode());
-		opaquePSO.SetDepthTest(material.DepthTest());
-		opaquePSO.SetStencilTest(material.StencilTest());
-		opaquePSO.SetBlend(false, false, material.BlendMode());
-		opaquePSO.SetFrameBuffers(mSwapChain->GetBackBufferDesc().mFormat, mDepthStencilBuffer->GetFormat());	// TODO:
-		opaquePSO.SetShader(renderItem.mMaterial->GetShader());
-		pRenderContext->SetPipelineState(opaquePSO);
+		RenderItem& renderItem = renderItems[i];
+		// still in flight on the copy queue, the item shows up a few frames later.
+		if (!isUploaded(renderItem)) continue;
+		renderItem.mSortKey = ForwardRecorder::SortKey(renderItem, i, cameraConstants, opaquePSO);
+		mSortedItems.push_back({ renderItem.mSortKey, i });
+	}
+	RadixSortRenderItems(mSortedItems, mSortScratch);
+}
 
-		const MaterialInstance& materialInstance = *renderItem.mMaterial;
+bool Renderer::isUploaded(const RenderItem& renderItem) const
+{
+	const MeshData& meshData = renderItem.mMeshData;
+	if (!mUploadManager.IsReady(meshData.mVertexBuffer->GetBuffer()) || !mUploadManager.IsReady(meshData.mIndexBuffer->GetBuffer()) ||
+		(meshData.mColorBuffer.IsValid() && !mUploadManager.IsReady(meshData.mColorBuffer->GetBuffer())))
+	{
+		return false;
+	}
+	const MaterialInstance& material = *renderItem.mMaterial;
+	for (uint8_t i = 0; i < material.NumTextures(); ++i)
+	{
+		const RHINativeTexture* pTexture = material.GetTexture(i).Get();
+		if (pTexture && !mUploadManager.IsReady(pTexture)) return false;
+	}
+	for (const TextureRef& texture : material.mBindlessTextures)
+	{
+		if (!mUploadManager.IsReady(texture.Get())) return false;
+	}
+	return true;
+}
 
-		pRenderContext->BeginBinding();
-		// update and bind constants(uniforms)
-		transform.mModel = renderItem.mModel;
-		transform.mModelInverse = renderItem.mModelInverse;
-		RHIConstantBuffer* pTransformCBuffer = pRenderContext->AllocConstantBuffer(sizeof(TransformConstants)).release();
-		uint8_t numConstants = materialInstance.NumConstantBuffers() + 1;	// material constants + 1 transform constants
-		std::unique_ptr<RHIConstantBuffer*[]> cbuffers = std::make_unique<RHIConstantBuffer*[]>(numConstants);
-		cbuffers[0] = pTransformCBuffer;
-		// TODO: 
-		mRenderHardwareInterface->RHIUpdateConstantBuffer(pTransformCBuffer, &transform, 0, sizeof(TransformConstants));
-		for (uint8_t i = 1; i < numConstants; ++i)
-		{
-			const Blob& constant = materialInstance.GetConstantBuffer(i - 1);
-			cbuffers[i] = pRenderContext->AllocConstantBuffer(constant.Size()).release();
-			mRenderHardwareInterface->RHIUpdateConstantBuffer(cbuffers[i], constant.Binary(), 0, constant.Size());
-		}
-		pRenderContext->SetConstantBuffers(1, numConstants, cbuffers.get());
-		for (uint8_t i = 0; i < numConstants; ++i)
-		{
-			delete cbuffers[i];
-		}
+void Renderer::bindPassTargets(RHIGraphicsContext* pRenderContext, const PassTargets& targets)
+{
+	Viewport viewport = targets.mViewport;
+	Rect scissorRect = targets.mScissorRect;
+	RHIRenderTarget* pRenderTarget = targets.mRenderTarget;
+	pRenderContext->SetViewPorts(&viewport, 1);
+	pRenderContext->SetScissorRect(&scissorRect, 1);
+	pRenderContext->SetRenderTargetsAndDepthStencil(&pRenderTarget, 1, targets.mDepthStencil);
+}
 
-		// bind textures/instance buffer.
-		uint8_t numTextures = materialInstance.NumTextures();
-		for (uint8_t i = 0; i < numTextures; ++i)
-		{
-			RHINativeTexture* pTexture = materialInstance.GetTexture(i).mObject;
-			if (!pTexture) continue;
-			pRenderContext->SetTexture(i, pTexture);
-		}
+RHIGraphicsContext* Renderer::acquireWorkerContext(RenderContext& renderContext, const PassTargets& targets)
+{
+	if (renderContext.mNumAcquiredWorkerContexts == MAX_RECORDING_WORKERS) return nullptr;
+	RHIGraphicsContext* pWorkerContext = renderContext.mWorkerContexts[renderContext.mNumAcquiredWorkerContexts++].get();
+	// the frame fence covers the worker contexts, they are idle once the main context is.
+	mRenderHardwareInterface->RHIResetGraphicsContext(pWorkerContext);
+	bindPassTargets(pWorkerContext, targets);
+	return pWorkerContext;
+}
 
-		// bind vertex buffers and index buffer.
-		RHIVertexBuffer* vertexBuffers[] = { renderItem.mMeshData.mVertexBuffer.mObject };
-		pRenderContext->SetVertexBuffers(vertexBuffers, 1);
-		pRenderContext->SetIndexBuffer(renderItem.mMeshData.mIndexBuffer.mObject);
-		pRenderContext->EndBindings();
+RHIGraphicsContext* Renderer::opaquePass(RenderContext& renderContext, RHIGraphicsContext* pRenderContext, const PassTargets& targets,
+	const std::vector<RenderItem>& renderItems, const std::vector<SortedRenderItem>& sortedItems, const CameraConstants& cameraConstants)
+{
+	PipelineInitializer& opaquePSO = mPipeStateInitializers[PSO_OPAQUE];
+	opaquePSO.SetFrameBuffers(mSwapChain->GetBackBufferDesc().mFormat, mDepthStencilBuffer->GetFormat());	// TODO:
+	TELEMETRY_COUNT(RENDER_ITEMS, renderItems.size());
 
-		// append draw call
-		const SubMesh* subMeshes = renderItem.mMeshData.mSubMeshes.get();
-		uint32_t numSubMeshes = renderItem.mMeshData.mSubMeshCount;
-		auto temp = renderItem;
-		for (uint32_t i = 0; i < numSubMeshes; ++i)
-		{
-			// TODO: support gpu instancing.
-			pRenderContext->DrawIndexedInstanced(subMeshes[i].mIndexNum, subMeshes[i].mStartIndex, subMeshes[i].mBaseVertex, 1, 0);
-		}
+	ThreadPool* pThreadPool = Application::sGetThreadPool();
+	const uint32_t numItems = static_cast<uint32_t>(sortedItems.size());
+	uint32_t numSlices = 1;
+	if (pThreadPool)
+	{
+		const uint32_t numFreeWorkers = MAX_RECORDING_WORKERS - renderContext.mNumAcquiredWorkerContexts;
+		numSlices = std::max(1u, std::min(1 + numFreeWorkers, numItems / MIN_ITEMS_PER_RECORDING_SLICE));
+	}
+	const SortedRenderItem* pItems = sortedItems.data();
+	if (numSlices == 1)
+	{
+		mForwardRecorder.Record(pRenderContext, mFrameArena, opaquePSO, renderItems, pItems, pItems + numItems, cameraConstants);
+		return pRenderContext;
+	}
+
+	// contiguous slices keep the sort order inside every context, an instanced run crossing a slice boundary
+	// is split into two draws.
+	PROFILE_SCOPE("Renderer::recordInParallel");
+	std::future<void> recordings[MAX_RECORDING_WORKERS];
+	RHIGraphicsContext* pLastContext = pRenderContext;
+	for (uint32_t slice = 1; slice < numSlices; ++slice)
+	{
+		const uint32_t begin = numItems * slice / numSlices;
+		const uint32_t end = numItems * (slice + 1) / numSlices;
+		RHIGraphicsContext* pWorkerContext = acquireWorkerContext(renderContext, targets);
+		VirtualLinearAllocator* pArena = &mWorkerArenas[slice - 1];
+		recordings[slice - 1] = pThreadPool->enqueue(Application::FRAME_TASK_PRIORITY,
+			[this, pWorkerContext, pArena, &opaquePSO, &renderItems, pItems, begin, end, &cameraConstants]()
+			{
+				PROFILE_SCOPE("Renderer::recordOpaqueSlice");
+				mForwardRecorder.Record(pWorkerContext, *pArena, opaquePSO, renderItems, pItems + begin, pItems + end, cameraConstants);
+			});
+		pLastContext = pWorkerContext;
+	}
+	// the main thread records the first slice instead of idling.
+	mForwardRecorder.Record(pRenderContext, mFrameArena, opaquePSO, renderItems, pItems, pItems + numItems / numSlices, cameraConstants);
+	// every slice has to finish before a failed one is reported, they reference the render list.
+	for (uint32_t slice = 1; slice < numSlices; ++slice)
+	{
+		recordings[slice - 1].wait();
+	}
+	for (uint32_t slice = 1; slice < numSlices; ++slice)
+	{
+		recordings[slice - 1].get();
 	}
+	return pLastContext;
 }
 
 void Renderer::postRender()
@@ -627,4 +888,10 @@ PlayStationRHI* Renderer::getRHI<PlayStationRHI>() const
 {
 	return static_cast<PlayStationRHI*>(mRenderHardwareInterface);
 }
-#endif
\ No newline at end of file
+#endif
+
+template<>
+NullRHI* Renderer::getRHI<NullRHI>() const
+{
+	return static_cast<NullRHI*>(mRenderHardwareInterface);
+}
\ No newline at end of file
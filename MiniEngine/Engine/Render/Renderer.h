@@ -1,13 +1,21 @@
 ﻿// ReSharper disable CppClangTidyBugproneBranchClone
 #pragma once
 #include "DynamicRHI.h"
+#include "ForwardRecorder.h"
 #include "Material.h"
+#include "MaterialConstantPool.h"
+#include "ObjectConstantPool.h"
+#include "RenderGraph.h"
 #include "RenderItem.h"
+#include "RenderSort.h"
+#include "ShaderCache.h"
+#include "UploadManager.h"
 #include "RHIDefination.h"
 #include "RHIConfiguration.h"
 #include "RHIPipelineStateInializer.h"
 #include "Shader.h"
 #include "Engine/pch.h"
+#include "Engine/Memory/VirtualLinearAllocator.h"
 
 struct PassConstants
 {
@@ -42,6 +50,11 @@ public:
     // support multi-thread
     // this func won't check repeated compiling, it may cause redundant memory usage.
     std::unique_ptr<RHIShader> compileShader(const Blob& blob, ShaderType shaderTypes, const std::wstring* path = nullptr) const;
+    // main thread only, before the shaders using it are compiled. shaders missing from the cache are compiled at runtime.
+    bool loadShaderCache(const void* pData, uint64_t size);
+    // pipeline states of an earlier session, they are created when their shader is registered. either may be empty.
+    bool loadPipelineStates(const void* pList, uint64_t listSize, const void* pLibrary, uint64_t librarySize);
+    void savePipelineStates(std::vector<uint8_t>& list, std::vector<uint8_t>& library);
     // support multi-thread
     ShaderRef compileAndRegisterShader(const std::string& shaderName, const Blob& blob, ShaderType shaderTypes, const std::string* path = nullptr);
     ShaderRef compileAndRegisterShader(const std::wstring& shaderName, const Blob& blob, ShaderType shaderTypes, const std::wstring* path = nullptr);
@@ -64,7 +77,21 @@ public:
 
     VertexBufferRef allocVertexBuffer(uint32_t numVertices, uint32_t vertexSize);
     IndexBufferRef allocIndexBuffer(uint32_t numIndices, Format indexFormat);
+    // copies the `positionSize` bytes of the position at the start of every vertex into a position only stream for the
+    // depth pre-pass, see MeshData::mPositionBuffer.
+    VertexBufferRef allocPositionBuffer(const void* pVertices, uint32_t numVertices, uint32_t vertexSize, uint32_t positionSize,
+        bool blockRendering = true);
     TextureRef allocTexture2D(Format format, uint32_t width, uint32_t height, uint8_t mipLevels);
+    // persistent slot for the object constants of a render item, see RenderItem::mObjectSlot.
+    // returns ObjectConstantPool::INVALID_SLOT when all slots are taken, those items fall back to frame memory.
+    uint32_t allocObjectConstants();
+    void releaseObjectConstants(uint32_t slot);
+    // the object of the slot moved, its constants are rewritten the next time it is drawn.
+    void invalidateObjectConstants(uint32_t slot);
+    // the constant buffers may still be read by frames in flight, they are released once the current frame retired.
+    void releaseConstantBuffers(const ConstantBufferRef* cbuffers, uint32_t numCBuffers);
+    // multi-thread supported, the copies are submitted with the next frame and never waited for on the cpu.
+    // items reading the resource are skipped until the copy completed, unless `blockRendering` lets the frame wait on the gpu.
     void updateVertexBuffer(const void* pData, uint64_t bufferSize, VertexBufferRef vertexBufferGPU, bool blockRendering = true);
     void updateIndexBuffer(const void* pData, uint64_t bufferSize, IndexBufferRef indexBufferGPU, bool blockRendering = true);
     void updateTexture(const void* pData, TextureRef textureGPU, uint8_t mipmap, bool blockRendering = true);
@@ -80,22 +107,63 @@ public:
     NON_MOVEABLE(Renderer);
 
 private:
+    // extra graphics contexts per frame, passes with enough items are recorded by this many threads besides the main thread.
+    static constexpr uint8_t MAX_RECORDING_WORKERS = 3;
+    // below this a slice costs more to set up than it saves
+    static constexpr uint32_t MIN_ITEMS_PER_RECORDING_SLICE = 128;
+
     struct RenderContext
     {
         std::unique_ptr<RHIGraphicsContext> mGraphicContext;
+        // recorded by worker threads, submitted after mGraphicContext in the order they were acquired.
+        std::unique_ptr<RHIGraphicsContext> mWorkerContexts[MAX_RECORDING_WORKERS];
+        uint8_t mNumAcquiredWorkerContexts;
         std::unique_ptr<RHIFence> mFenceGPU;
         std::vector<RHIConstantBuffer*> mReleasingCBuffers;
         uint64_t mFenceCPU;
     };
+    // the output every context recording into the frame has to bind before drawing.
+    struct PassTargets
+    {
+        RHIRenderTarget* mRenderTarget;
+        RHIDepthStencil* mDepthStencil;
+        Viewport mViewport;
+        Rect mScissorRect;
+    };
+
     uint32_t allocGPUResource(RHIObject* pObject);
     void createBuiltinResources();
+    // declares the clear, depth pre-pass, skybox and opaque passes of a render list in mRenderGraph.
+    void addForwardPasses(RenderContext& renderContext, RenderList& renderList, const PassTargets& targets,
+        RenderGraph::ResourceHandle colorTarget, RenderGraph::ResourceHandle depthTarget);
+    // releases the constant buffers retired by the last frame of the context and uploads the changed object constants.
     void beginFrame(RenderContext* pRenderContext);
     // sphere mode only now
     void skyboxPass(RHIGraphicsContext* pRenderContext, const RHIShader& skyboxShader, SkyboxType type, const CameraConstants& cameraConstants);
-    void depthPrePass(RHIGraphicsContext* pRenderContext, const std::vector<RenderItem>& renderItems, const CameraConstants& cameraConstants);
-    void opaquePass(RHIGraphicsContext* pRenderContext, const std::vector<RenderItem>& renderItems, const CameraConstants& cameraConstants);
+    // marks the large occluders of the list with RenderItem::mDepthPrePassed and draws their positions front to back.
+    void depthPrePass(RHIGraphicsContext* pRenderContext, std::vector<RenderItem>& renderItems, const CameraConstants& cameraConstants);
+    // whether the item opted into the pre-pass covers enough of the screen to pay for drawing it twice.
+    bool isOccluder(const RenderItem& renderItem, const CameraConstants& cameraConstants) const;
+    // writes the sort key of every item and fills mSortedItems with the submission order.
+    void sortRenderItems(std::vector<RenderItem>& renderItems, const CameraConstants& cameraConstants);
+    // whether the mesh and the textures of the item finished uploading.
+    bool isUploaded(const RenderItem& renderItem) const;
+    // slices of the sorted items are recorded in parallel, the first one into `pRenderContext` and the others into
+    // worker contexts of `renderContext`. returns the context that continues the frame after the pass.
+    RHIGraphicsContext* opaquePass(RenderContext& renderContext, RHIGraphicsContext* pRenderContext, const PassTargets& targets,
+        const std::vector<RenderItem>& renderItems, const std::vector<SortedRenderItem>& sortedItems, const CameraConstants& cameraConstants);
+    // resets the next unused worker context of the frame and binds the pass targets, nullptr when all are taken.
+    RHIGraphicsContext* acquireWorkerContext(RenderContext& renderContext, const PassTargets& targets);
+    static void bindPassTargets(RHIGraphicsContext* pRenderContext, const PassTargets& targets);
     void postRender();
 
+    // 4MB of object constants
+    static constexpr uint32_t MAX_OBJECT_CONSTANTS = 16384;
+    // 8MB of material constants
+    static constexpr uint32_t MAX_MATERIAL_CONSTANT_BLOCKS = 32768;
+    // projected diameter of the bounding sphere relative to the screen height, smaller items occlude too little.
+    static constexpr float MIN_OCCLUDER_SCREEN_SIZE = 0.1f;
+
     static IndexBufferRef sQuadMeshIndexBuffer;
     static ShaderRef sPreDepthShader;
 
@@ -108,9 +176,9 @@ private:
     uint8_t mNumRenderContexts;
     uint8_t mCurrentRenderContextIndex;
 
-    std::unique_ptr<RHICopyContext> mCopyContext;
-    std::unique_ptr<RHIFence> mCopyFenceGPU;
-    uint64_t mCopyFenceCPU;
+    UploadManager mUploadManager;
+    ShaderCache mShaderCache;
+    RenderGraph mRenderGraph;
 
     enum PsoPresets : uint16_t
     {
@@ -124,12 +192,25 @@ private:
     std::vector<PipelineInitializer> mPipeStateInitializers;
 
     std::vector<RenderList> mRenderLists;
+    std::vector<SortedRenderItem> mSortedItems;
+    std::vector<SortedRenderItem> mSortScratch;
+    std::vector<SortedRenderItem> mOccluders;
     std::vector<RenderPass> mCustomRenderPasses;
 
     // ----------------Pass Constants----------------
     std::unique_ptr<PassConstants> mPassConstants;
     // ----------------------------------------------
 
+    ObjectConstantPool mObjectConstantPool;
+    MaterialConstantPool mMaterialConstantPool;
+    // binds the pools above, see opaquePass.
+    ForwardRecorder mForwardRecorder;
+
+    // transient cpu memory which lives until the end of current frame, rewound in render().
+    VirtualLinearAllocator mFrameArena;
+    // the same for the recording workers, indexed by the slice of the pass they record.
+    VirtualLinearAllocator mWorkerArenas[MAX_RECORDING_WORKERS];
+
     // -------------GPU Resource Manager-------------
     std::deque<std::unique_ptr<RHIObject>> mGPUResources;
     std::stack<uint64_t>    mAvailableGPUResourceIds;
@@ -0,0 +1,232 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Split resource state tracking.
+// A command context records the states of the resources it uses into a LocalResourceStateTracker, without locks.
+// The state a resource is in when the list executes is unknown while recording, so the first use of every subresource
+// is left pending. When the list is submitted, Resolve turns the pending uses into barriers against the global state,
+// which lives inline in the resource (TrackedResourceState) and is only touched by the submitting thread.
+//
+// Traits provides:
+//     using Resource = ...;   // const Resource* p: p->GetTrackedState() returns a TrackedResourceState<State>&
+//     using State = ...;      // with State::UNKNOWN
+//     static constexpr State DECAYED_STATE;   // the state of resources after a queue which does not keep them
+//     static bool ImplicitTransition(State before, State& after, bool isBufferOrSimultaneous);
+//         // whether the transition needs no barrier. may widen `after` to the promoted state.
+
+// global state of a resource. stores a single state while all subresources share it.
+template<typename State>
+class TrackedResourceState
+{
+public:
+    void Initialize(uint32_t numSubResources, bool isBufferOrSimultaneous, State state)
+    {
+        mNumSubResources = numSubResources;
+        mIsBufferOrSimultaneous = isBufferOrSimultaneous;
+        mStates.assign(1, state);
+    }
+
+    State Get(uint32_t subResource) const { return mStates.size() == 1 ? mStates[0] : mStates[subResource]; }
+
+    void Set(uint32_t subResource, State state)
+    {
+        if (mStates.size() == 1)
+        {
+            if (mStates[0] == state) return;
+            mStates.resize(mNumSubResources, mStates[0]);
+        }
+        mStates[subResource] = state;
+    }
+
+    void SetAll(State state) { mStates.assign(1, state); }
+
+    uint32_t GetSubResourceCount() const { return mNumSubResources; }
+    bool IsBufferOrSimultaneous() const { return mIsBufferOrSimultaneous; }
+
+private:
+    std::vector<State> mStates;
+    uint32_t mNumSubResources = 0;
+    bool mIsBufferOrSimultaneous = false;
+};
+
+template<typename Traits>
+class LocalResourceStateTracker
+{
+public:
+    using Resource = typename Traits::Resource;
+    using State = typename Traits::State;
+
+    static constexpr uint32_t ALL_SUBRESOURCES = 0xffffffff;
+
+    struct Transition
+    {
+        const Resource* mResource;
+        uint32_t mSubResource;
+        State mBefore;
+        State mAfter;
+    };
+
+    // appends the barriers needed before the resource is used in `state` by the list.
+    // the first use of a subresource yields no barrier, it is resolved at submission.
+    void Convert(const Resource* pResource, State state, std::vector<Transition>& transitions)
+    {
+        Entry& entry = GetEntry(pResource);
+        State* pFirst = FirstStates(entry);
+        State* pLast = LastStates(entry);
+        const size_t firstTransition = transitions.size();
+        bool sameBefore = true;
+        for (uint32_t i = 0; i < entry.mNumSubResources; ++i)
+        {
+            if (ConvertSubResource(entry, pFirst[i], pLast[i], state, i, transitions))
+            {
+                sameBefore = sameBefore && transitions.back().mBefore == transitions[firstTransition].mBefore;
+            }
+        }
+        // every subresource moves from the same state, one barrier covers them all
+        if (sameBefore && transitions.size() - firstTransition == entry.mNumSubResources && entry.mNumSubResources > 1)
+        {
+            transitions.resize(firstTransition + 1);
+            transitions[firstTransition].mSubResource = ALL_SUBRESOURCES;
+        }
+    }
+
+    void ConvertSubResource(const Resource* pResource, uint32_t subResource, State state, std::vector<Transition>& transitions)
+    {
+        Entry& entry = GetEntry(pResource);
+        ConvertSubResource(entry, FirstStates(entry)[subResource], LastStates(entry)[subResource], state, subResource, transitions);
+    }
+
+    // for lists executed back to back: appends the barriers between the states `previous` leaves the resources in
+    // and the first uses of this list. this tracker takes over the pending first uses of `previous`, which is reset.
+    void Merge(LocalResourceStateTracker& previous, std::vector<Transition>& transitions)
+    {
+        for (const Entry& prevEntry : previous.mEntries)
+        {
+            const State* pPrevFirst = previous.FirstStates(prevEntry);
+            const State* pPrevLast = previous.LastStates(prevEntry);
+            Entry& entry = GetEntry(prevEntry.mResource);
+            State* pFirst = FirstStates(entry);
+            State* pLast = LastStates(entry);
+            for (uint32_t i = 0; i < entry.mNumSubResources; ++i)
+            {
+                if (pPrevLast[i] == State::UNKNOWN) continue;
+                if (pFirst[i] == State::UNKNOWN)
+                {
+                    pLast[i] = pPrevLast[i];
+                }
+                else
+                {
+                    State after = pFirst[i];
+                    if (!Traits::ImplicitTransition(pPrevLast[i], after, entry.mIsBufferOrSimultaneous))
+                    {
+                        transitions.push_back({ entry.mResource, i, pPrevLast[i], pFirst[i] });
+                    }
+                }
+                pFirst[i] = pPrevFirst[i];
+            }
+        }
+        previous.Reset();
+    }
+
+    // the single pass at submission: appends the barriers from the global states to the pending first uses and
+    // stores the states the list leaves the resources in, or DECAYED_STATE for `decay`. submissions must not overlap.
+    void Resolve(std::vector<Transition>& transitions, bool decay = false)
+    {
+        for (const Entry& entry : mEntries)
+        {
+            auto& global = entry.mResource->GetTrackedState();
+            const State* pFirst = FirstStates(entry);
+            const State* pLast = LastStates(entry);
+            const size_t firstTransition = transitions.size();
+            bool sameTransition = true;
+            for (uint32_t i = 0; i < entry.mNumSubResources; ++i)
+            {
+                if (pFirst[i] == State::UNKNOWN) continue;
+                const State before = global.Get(i);
+                State after = pFirst[i];
+                if (Traits::ImplicitTransition(before, after, entry.mIsBufferOrSimultaneous)) continue;
+                transitions.push_back({ entry.mResource, i, before, pFirst[i] });
+                // the first uses of the subresources may differ, unlike in Convert
+                sameTransition = sameTransition && before == transitions[firstTransition].mBefore &&
+                    pFirst[i] == transitions[firstTransition].mAfter;
+            }
+            if (sameTransition && transitions.size() - firstTransition == entry.mNumSubResources && entry.mNumSubResources > 1)
+            {
+                transitions.resize(firstTransition + 1);
+                transitions[firstTransition].mSubResource = ALL_SUBRESOURCES;
+            }
+
+            if (decay)
+            {
+                global.SetAll(Traits::DECAYED_STATE);
+                continue;
+            }
+            for (uint32_t i = 0; i < entry.mNumSubResources; ++i)
+            {
+                if (pLast[i] != State::UNKNOWN) global.Set(i, pLast[i]);
+            }
+        }
+        Reset();
+    }
+
+    // forgets the resources of the list, keeps the memory for the next one.
+    void Reset()
+    {
+        mEntries.clear();
+        mStates.clear();
+        mIndices.clear();
+    }
+
+    uint32_t GetNumTrackedResources() const { return static_cast<uint32_t>(mEntries.size()); }
+
+private:
+    struct Entry
+    {
+        const Resource* mResource;
+        uint32_t mOffset;           // first states at mOffset, last states right after them
+        uint32_t mNumSubResources;
+        bool mIsBufferOrSimultaneous;
+    };
+
+    Entry& GetEntry(const Resource* pResource)
+    {
+        const auto it = mIndices.try_emplace(pResource, static_cast<uint32_t>(mEntries.size()));
+        if (!it.second) return mEntries[it.first->second];
+
+        const auto& global = pResource->GetTrackedState();
+        const uint32_t numSubResources = global.GetSubResourceCount();
+        mEntries.push_back({ pResource, static_cast<uint32_t>(mStates.size()), numSubResources, global.IsBufferOrSimultaneous() });
+        mStates.resize(mStates.size() + 2 * numSubResources, State::UNKNOWN);
+        return mEntries.back();
+    }
+
+    State* FirstStates(const Entry& entry) { return mStates.data() + entry.mOffset; }
+    State* LastStates(const Entry& entry) { return mStates.data() + entry.mOffset + entry.mNumSubResources; }
+    const State* FirstStates(const Entry& entry) const { return mStates.data() + entry.mOffset; }
+    const State* LastStates(const Entry& entry) const { return mStates.data() + entry.mOffset + entry.mNumSubResources; }
+
+    // returns whether a barrier was appended.
+    static bool ConvertSubResource(const Entry& entry, State& first, State& last, State state, uint32_t subResource,
+                                   std::vector<Transition>& transitions)
+    {
+        if (last == State::UNKNOWN)
+        {
+            first = state;
+            last = state;
+            return false;
+        }
+        State after = state;
+        const bool isExplicit = !Traits::ImplicitTransition(last, after, entry.mIsBufferOrSimultaneous);
+        if (isExplicit) transitions.push_back({ entry.mResource, subResource, last, state });
+        last = isExplicit ? state : after;
+        return isExplicit;
+    }
+
+    std::vector<Entry> mEntries;
+    std::vector<State> mStates;
+    // resource -> entry, local to the context
+    std::unordered_map<const Resource*, uint32_t> mIndices;
+};
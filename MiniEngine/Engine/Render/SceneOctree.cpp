@@ -0,0 +1,190 @@
+#include "SceneOctree.h"
+
+#include "Engine/common/Exception.h"
+
+SceneOctree::SceneOctree(float rootHalfSize, uint32_t maxDepth) :
+    mRootHalfSize(rootHalfSize),
+    mMaxDepth(maxDepth)
+{
+    Clear();
+}
+
+void SceneOctree::Clear()
+{
+    mNodes.clear();
+    mEntries.clear();
+    mFreeEntries.clear();
+    Node root{};
+    root.mHalfSize = mRootHalfSize;
+    root.mParent = INVALID_NODE;
+    std::fill(std::begin(root.mChildren), std::end(root.mChildren), INVALID_NODE);
+    mNodes.push_back(std::move(root));
+}
+
+uint32_t SceneOctree::Insert(void* pObject, const BoundingBox& bounds)
+{
+    ASSERT(bounds.IsValid(), TEXT("octree entries require valid bounds"))
+    uint32_t handle;
+    if (!mFreeEntries.empty())
+    {
+        handle = mFreeEntries.back();
+        mFreeEntries.pop_back();
+    }
+    else
+    {
+        handle = static_cast<uint32_t>(mEntries.size());
+        mEntries.emplace_back();
+    }
+    mEntries[handle].mObject = pObject;
+    mEntries[handle].mBounds = bounds;
+    Link(handle, FindNode(bounds));
+    return handle;
+}
+
+void SceneOctree::Update(uint32_t handle, const BoundingBox& bounds)
+{
+    ASSERT(bounds.IsValid(), TEXT("octree entries require valid bounds"))
+    Entry& entry = mEntries[handle];
+    entry.mBounds = bounds;
+    uint32_t node = FindNode(bounds);
+    if (node == entry.mNode) return;
+    Unlink(handle);
+    Link(handle, node);
+}
+
+void SceneOctree::Remove(uint32_t handle)
+{
+    Unlink(handle);
+    mEntries[handle].mObject = nullptr;
+    mFreeEntries.push_back(handle);
+}
+
+uint32_t SceneOctree::FindNode(const BoundingBox& bounds)
+{
+    const float* center = bounds.mCenter;
+    float extent = std::max(bounds.mExtents[0], std::max(bounds.mExtents[1], bounds.mExtents[2]));
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (std::abs(center[axis]) > mRootHalfSize) return 0;
+    }
+
+    uint32_t node = 0;
+    while (mNodes[node].mDepth < mMaxDepth)
+    {
+        // the loose bounds of a child reach half of its cell size beyond the cell
+        float childHalfSize = mNodes[node].mHalfSize * 0.5f;
+        if (extent > childHalfSize) break;
+
+        uint32_t octant = 0;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (center[axis] >= mNodes[node].mCenter[axis]) octant |= 1u << axis;
+        }
+        if (mNodes[node].mChildren[octant] == INVALID_NODE)
+        {
+            Node child{};
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                child.mCenter[axis] = mNodes[node].mCenter[axis] + ((octant >> axis) & 1 ? childHalfSize : -childHalfSize);
+            }
+            child.mHalfSize = childHalfSize;
+            child.mDepth = mNodes[node].mDepth + 1;
+            child.mParent = node;
+            std::fill(std::begin(child.mChildren), std::end(child.mChildren), INVALID_NODE);
+            mNodes[node].mChildren[octant] = static_cast<uint32_t>(mNodes.size());
+            mNodes.push_back(std::move(child));
+        }
+        node = mNodes[node].mChildren[octant];
+    }
+    return node;
+}
+
+void SceneOctree::Link(uint32_t handle, uint32_t node)
+{
+    Entry& entry = mEntries[handle];
+    entry.mNode = node;
+    entry.mSlot = static_cast<uint32_t>(mNodes[node].mEntries.size());
+    mNodes[node].mEntries.push_back(handle);
+    for (uint32_t i = node; i != INVALID_NODE; i = mNodes[i].mParent)
+    {
+        ++mNodes[i].mNumObjects;
+    }
+}
+
+void SceneOctree::Unlink(uint32_t handle)
+{
+    Entry& entry = mEntries[handle];
+    std::vector<uint32_t>& entries = mNodes[entry.mNode].mEntries;
+    uint32_t last = entries.back();
+    entries[entry.mSlot] = last;
+    mEntries[last].mSlot = entry.mSlot;
+    entries.pop_back();
+    for (uint32_t i = entry.mNode; i != INVALID_NODE; i = mNodes[i].mParent)
+    {
+        --mNodes[i].mNumObjects;
+    }
+}
+
+uint32_t SceneOctree::Query(const Frustum& frustum, std::vector<void*>& objects) const
+{
+    size_t numObjects = objects.size();
+    mCandidateBatch.Clear();
+    mCandidates.clear();
+    QueryNode(0, frustum, objects);
+
+    mVisibility.resize(mCandidates.size());
+    frustum.Cull(mCandidateBatch, mVisibility.data());
+    for (size_t i = 0; i < mCandidates.size(); ++i)
+    {
+        if (mVisibility[i]) objects.push_back(mEntries[mCandidates[i]].mObject);
+    }
+    return static_cast<uint32_t>(objects.size() - numObjects);
+}
+
+void SceneOctree::QueryNode(uint32_t node, const Frustum& frustum, std::vector<void*>& objects) const
+{
+    const Node& current = mNodes[node];
+    if (current.mNumObjects == 0) return;
+
+    // the root also holds everything outside of its cell, so it is never rejected as a whole
+    if (node != 0)
+    {
+        BoundingBox looseBounds;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            looseBounds.mCenter[axis] = current.mCenter[axis];
+            looseBounds.mExtents[axis] = current.mHalfSize * 2;
+        }
+        FrustumTest test = frustum.Classify(looseBounds);
+        if (test == FrustumTest::OUTSIDE) return;
+        if (test == FrustumTest::INSIDE)
+        {
+            CollectAll(node, objects);
+            return;
+        }
+    }
+
+    for (uint32_t handle : current.mEntries)
+    {
+        mCandidateBatch.Add(mEntries[handle].mBounds);
+        mCandidates.push_back(handle);
+    }
+    for (uint32_t child : current.mChildren)
+    {
+        if (child != INVALID_NODE) QueryNode(child, frustum, objects);
+    }
+}
+
+void SceneOctree::CollectAll(uint32_t node, std::vector<void*>& objects) const
+{
+    const Node& current = mNodes[node];
+    if (current.mNumObjects == 0) return;
+    for (uint32_t handle : current.mEntries)
+    {
+        objects.push_back(mEntries[handle].mObject);
+    }
+    for (uint32_t child : current.mChildren)
+    {
+        if (child != INVALID_NODE) CollectAll(child, objects);
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "Frustum.h"
+
+// Loose octree over world space bounds. The loose bounds of a node are twice its cell, so an object lives in the
+// deepest cell that contains its center and is at least as large as the object, and never straddles cells.
+// Objects outside the root cell stay in the root. Nodes are created on demand and kept for reuse.
+class SceneOctree
+{
+public:
+    static constexpr uint32_t INVALID_HANDLE = ~0u;
+
+    uint32_t Insert(void* pObject, const BoundingBox& bounds);
+    // only relocates the object when its bounds no longer belong to the same node.
+    void Update(uint32_t handle, const BoundingBox& bounds);
+    void Remove(uint32_t handle);
+    void* GetObject(uint32_t handle) const { return mEntries[handle].mObject; }
+    // appends every object whose bounds intersect the frustum, returns the number of appended objects.
+    // objects of nodes completely inside the frustum are taken without tests, the ones of partially visible nodes
+    // are tested in one batch. Not thread safe, the batch is shared between queries.
+    uint32_t Query(const Frustum& frustum, std::vector<void*>& objects) const;
+    uint32_t Size() const { return mNodes[0].mNumObjects; }
+    void Clear();
+
+    SceneOctree(float rootHalfSize = 1024, uint32_t maxDepth = 6);
+
+private:
+    static constexpr uint32_t INVALID_NODE = ~0u;
+
+    struct Node
+    {
+        float mCenter[3];
+        float mHalfSize;
+        uint32_t mDepth;
+        uint32_t mParent;
+        uint32_t mChildren[8];
+        uint32_t mNumObjects;               // objects in this node and all of its children
+        std::vector<uint32_t> mEntries;
+    };
+
+    struct Entry
+    {
+        void* mObject;
+        BoundingBox mBounds;
+        uint32_t mNode;
+        uint32_t mSlot;                     // position inside mEntries of the node
+    };
+
+    uint32_t FindNode(const BoundingBox& bounds);
+    void Link(uint32_t handle, uint32_t node);
+    void Unlink(uint32_t handle);
+    void CollectAll(uint32_t node, std::vector<void*>& objects) const;
+    void QueryNode(uint32_t node, const Frustum& frustum, std::vector<void*>& objects) const;
+
+    std::vector<Node> mNodes;
+    std::vector<Entry> mEntries;
+    std::vector<uint32_t> mFreeEntries;
+    float mRootHalfSize;
+    uint32_t mMaxDepth;
+
+    // entries of partially visible nodes waiting for the batched test
+    mutable CullingBatch mCandidateBatch;
+    mutable std::vector<uint32_t> mCandidates;
+    mutable std::vector<uint8_t> mVisibility;
+};
@@ -11,21 +11,55 @@ public:
         mDomainShader = {pDomainShader.Binary(), pDomainShader.Size()};
         mGeometryShader = {pGeometryShader.Binary(), pGeometryShader.Size()};
         mPixelShader = {pPixelShader.Binary(), pPixelShader.Size()};
+        mBytecodeHash = FNV_OFFSET;
+        for (const Blob* pStage : { &mVertexShader, &mHullShader, &mDomainShader, &mGeometryShader, &mPixelShader })
+        {
+            const uint64_t size = pStage->Size();
+            HashBytes(mBytecodeHash, &size, sizeof(size));
+            HashBytes(mBytecodeHash, pStage->Binary(), size);
+        }
     }
     void SetName(const std::string& name) { mName = name; }
     void SetShaderProperties(const std::vector<ShaderProp>& props) { mProps = props; }
-    void SetShaderInputs(const std::vector<ShaderInput>& inputs) { mInputs = inputs; }
+    void SetShaderVariables(const std::vector<ShaderVariable>& variables) { mVariables = variables; }
+    void SetShaderInputs(const std::vector<ShaderInput>& inputs)
+    {
+        mInputs = inputs;
+        mInputHash = FNV_OFFSET;
+        for (const ShaderInput& input : mInputs)
+        {
+            HashBytes(mInputHash, &input.mFormat, sizeof(input.mFormat));
+            HashBytes(mInputHash, input.mSemanticName.c_str(), input.mSemanticName.size() + 1);
+            HashBytes(mInputHash, &input.mSemanticIndex, sizeof(input.mSemanticIndex));
+            HashBytes(mInputHash, &input.mInputSlot, sizeof(input.mInputSlot));
+        }
+    }
     const std::vector<ShaderInput>& GetInputElements() const { return mInputs; }
     const std::vector<ShaderProp>& GetShaderProperties() const { return mProps; }
+    const std::vector<ShaderVariable>& GetShaderVariables() const { return mVariables; }
     const std::string& GetName() const { return mName; }
     const Blob& VertexShader() const { return mVertexShader; }
     const Blob& HullShader() const { return mHullShader; }
     const Blob& DomainShader() const { return mDomainShader; }
     const Blob& GeometryShader() const { return mGeometryShader; }
     const Blob& PixelShader() const { return mPixelShader; }
+    // identifies the bytecode and the input layout, unlike the address it is the same in every run.
+    uint64_t GetHash() const { return mBytecodeHash ^ (mInputHash * FNV_PRIME); }
     RHIShader() = default;
     
 private:
+    static constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+    static constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+
+    static void HashBytes(uint64_t& hash, const void* pData, uint64_t size)
+    {
+        const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+        for (uint64_t i = 0; i < size; ++i)
+        {
+            hash = (hash ^ pBytes[i]) * FNV_PRIME;
+        }
+    }
+
     Blob mVertexShader;
     Blob mHullShader;
     Blob mDomainShader;
@@ -35,4 +69,7 @@ private:
     std::string mName;
     std::vector<ShaderInput> mInputs;
     std::vector<ShaderProp> mProps;
+    std::vector<ShaderVariable> mVariables;
+    uint64_t mBytecodeHash = FNV_OFFSET;
+    uint64_t mInputHash = FNV_OFFSET;
 };
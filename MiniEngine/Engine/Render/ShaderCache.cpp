@@ -0,0 +1,209 @@
+#include "ShaderCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_set>
+
+namespace
+{
+    constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+    constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+    // includes nested deeper are treated as cycles
+    constexpr uint32_t MAX_INCLUDE_DEPTH = 32;
+
+    void HashBytes(uint64_t& hash, const void* pData, size_t size)
+    {
+        const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash = (hash ^ pBytes[i]) * FNV_PRIME;
+        }
+    }
+
+    void HashString(uint64_t& hash, const char* pString)
+    {
+        // the terminator keeps "ab" + "c" apart from "a" + "bc"
+        HashBytes(hash, pString, strlen(pString) + 1);
+    }
+
+    void HashSize(uint64_t& hash, uint64_t size)
+    {
+        HashBytes(hash, &size, sizeof(size));
+    }
+
+    std::string DirectoryOf(const std::string& path)
+    {
+        const size_t separator = path.find_last_of("/\\");
+        return separator == std::string::npos ? std::string{} : path.substr(0, separator + 1);
+    }
+
+    // hashes the include directives of `source` in the order they appear, followed by the files they name.
+    // commented out directives count too, a spurious dependency only costs a recompile.
+    void HashIncludes(uint64_t& hash, const char* pSource, size_t size, const std::string& directory,
+        const ShaderCache::FileReader& readFile, std::unordered_set<std::string>& visited, uint32_t depth)
+    {
+        const char* pEnd = pSource + size;
+        for (const char* pLine = pSource; pLine < pEnd;)
+        {
+            const char* pLineEnd = std::find(pLine, pEnd, '\n');
+            const char* pChar = pLine;
+            while (pChar < pLineEnd && (*pChar == ' ' || *pChar == '\t')) ++pChar;
+            static constexpr char DIRECTIVE[] = "#include";
+            constexpr size_t DIRECTIVE_LENGTH = sizeof(DIRECTIVE) - 1;
+            if (pLineEnd - pChar > static_cast<ptrdiff_t>(DIRECTIVE_LENGTH) && memcmp(pChar, DIRECTIVE, DIRECTIVE_LENGTH) == 0)
+            {
+                const char* pOpen = std::find_if(pChar + DIRECTIVE_LENGTH, pLineEnd, [](char c) { return c == '"' || c == '<'; });
+                const char* pClose = pOpen == pLineEnd ? pLineEnd : std::find(pOpen + 1, pLineEnd, *pOpen == '"' ? '"' : '>');
+                if (pClose != pLineEnd)
+                {
+                    const std::string name(pOpen + 1, pClose);
+                    const std::string path = directory + name;
+                    HashString(hash, name.c_str());
+                    std::string content;
+                    if (depth < MAX_INCLUDE_DEPTH && visited.insert(path).second && readFile(path, content))
+                    {
+                        HashSize(hash, content.size());
+                        HashBytes(hash, content.data(), content.size());
+                        HashIncludes(hash, content.data(), content.size(), DirectoryOf(path), readFile, visited, depth + 1);
+                    }
+                }
+            }
+            pLine = pLineEnd + 1;
+        }
+    }
+}
+
+uint64_t ShaderCache::ComputeKey(const void* pSource, size_t size, const std::string& sourcePath, const char* entry,
+    const char* profile, const std::vector<std::string>& defines, uint32_t flags, const FileReader& readFile)
+{
+    uint64_t hash = FNV_OFFSET;
+    HashSize(hash, VERSION);
+    HashString(hash, entry);
+    HashString(hash, profile);
+    HashSize(hash, flags);
+    HashSize(hash, defines.size());
+    for (const std::string& define : defines)
+    {
+        HashString(hash, define.c_str());
+    }
+    HashSize(hash, size);
+    HashBytes(hash, pSource, size);
+    std::unordered_set<std::string> visited;
+    HashIncludes(hash, static_cast<const char*>(pSource), size, DirectoryOf(sourcePath), readFile, visited, 0);
+    return hash;
+}
+
+bool ShaderCache::ReadFile(const std::string& path, std::string& content)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    const std::streampos size = file.tellg();
+    if (size < 0) return false;
+    content.resize(static_cast<size_t>(size));
+    file.seekg(0, std::ios::beg);
+    return static_cast<bool>(file.read(&content[0], size));
+}
+
+ShaderCache::BuildStats ShaderCache::Build(const ShaderCache& previous, const std::vector<CompileJob>& jobs,
+    const CompileFunc& compile, const FileReader& readFile, ShaderCache& result)
+{
+    BuildStats stats;
+    result.mEntries.clear();
+    result.mBytecode.clear();
+    std::string source;
+    std::vector<uint8_t> bytecode;
+    for (const CompileJob& job : jobs)
+    {
+        if (!readFile(job.mPath, source))
+        {
+            ++stats.mNumFailed;
+            continue;
+        }
+        const uint64_t key = ComputeKey(source.data(), source.size(), job.mPath, job.mEntry, job.mProfile, job.mDefines, job.mFlags, readFile);
+        const void* pBytecode;
+        size_t size;
+        // identical sources share an entry
+        if (result.Find(key, &pBytecode, &size)) continue;
+        if (previous.Find(key, &pBytecode, &size))
+        {
+            result.Store(key, pBytecode, size);
+            ++stats.mNumReused;
+            continue;
+        }
+        bytecode.clear();
+        if (!compile(job, source, bytecode))
+        {
+            ++stats.mNumFailed;
+            continue;
+        }
+        result.Store(key, bytecode.data(), bytecode.size());
+        ++stats.mNumCompiled;
+    }
+    for (const Entry& entry : previous.mEntries)
+    {
+        const void* pBytecode;
+        size_t size;
+        if (!result.Find(entry.mKey, &pBytecode, &size)) ++stats.mNumDropped;
+    }
+    return stats;
+}
+
+bool ShaderCache::Load(const void* pData, size_t size)
+{
+    mEntries.clear();
+    mBytecode.clear();
+    Header header;
+    if (size < sizeof(Header)) return false;
+    memcpy(&header, pData, sizeof(Header));
+    const uint64_t tableSize = static_cast<uint64_t>(header.mNumEntries) * sizeof(Entry);
+    if (header.mMagic != MAGIC || header.mVersion != VERSION || size != sizeof(Header) + tableSize + header.mBytecodeSize) return false;
+
+    const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+    std::vector<Entry> entries(header.mNumEntries);
+    memcpy(entries.data(), pBytes + sizeof(Header), tableSize);
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        const Entry& entry = entries[i];
+        if (static_cast<uint64_t>(entry.mOffset) + entry.mSize > header.mBytecodeSize) return false;
+        if (i && entries[i - 1].mKey >= entry.mKey) return false;
+    }
+    mEntries = std::move(entries);
+    mBytecode.assign(pBytes + sizeof(Header) + tableSize, pBytes + size);
+    return true;
+}
+
+std::vector<uint8_t> ShaderCache::Serialize() const
+{
+    const Header header{ MAGIC, VERSION, static_cast<uint32_t>(mEntries.size()), static_cast<uint32_t>(mBytecode.size()) };
+    const size_t tableSize = mEntries.size() * sizeof(Entry);
+    std::vector<uint8_t> archive(sizeof(Header) + tableSize + mBytecode.size());
+    memcpy(archive.data(), &header, sizeof(Header));
+    if (tableSize) memcpy(archive.data() + sizeof(Header), mEntries.data(), tableSize);
+    if (!mBytecode.empty()) memcpy(archive.data() + sizeof(Header) + tableSize, mBytecode.data(), mBytecode.size());
+    return archive;
+}
+
+bool ShaderCache::Find(uint64_t key, const void** ppBytecode, size_t* pSize) const
+{
+    auto itor = std::lower_bound(mEntries.begin(), mEntries.end(), key, [](const Entry& entry, uint64_t k) { return entry.mKey < k; });
+    if (itor == mEntries.end() || itor->mKey != key) return false;
+    *ppBytecode = mBytecode.data() + itor->mOffset;
+    *pSize = itor->mSize;
+    return true;
+}
+
+void ShaderCache::Store(uint64_t key, const void* pBytecode, size_t size)
+{
+    auto itor = std::lower_bound(mEntries.begin(), mEntries.end(), key, [](const Entry& entry, uint64_t k) { return entry.mKey < k; });
+    // a replaced entry leaves its old bytecode behind, only the builder stores and it starts empty.
+    const Entry entry{ key, static_cast<uint32_t>(mBytecode.size()), static_cast<uint32_t>(size) };
+    const uint8_t* pBytes = static_cast<const uint8_t*>(pBytecode);
+    mBytecode.insert(mBytecode.end(), pBytes, pBytes + size);
+    if (itor != mEntries.end() && itor->mKey == key)
+    {
+        *itor = entry;
+        return;
+    }
+    mEntries.insert(itor, entry);
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Archive of compiled shader stages keyed by a content hash of everything the bytecode depends on: the source, the files
+// it includes, the entry point, the target profile, the defines and the compile flags. A changed include, define or flag
+// changes the key, stale entries are never found and are dropped by the next Build.
+// Only depends on the standard library, the offline builder in Tools/ShaderCacheBuilder links it on any platform.
+// Find is safe from several threads once the archive is loaded.
+class ShaderCache
+{
+public:
+    // bump when the key or the archive layout changes, every key changes with it.
+    static constexpr uint32_t VERSION = 3;
+    static constexpr uint32_t MAGIC = 0x4348534D;    // "MSHC"
+
+    struct EntryPoint
+    {
+        const char* mName;
+        const char* mProfile;
+    };
+    // in the order of the ShaderType bits, the runtime compiles the stages with these names and profiles.
+    // 5.1 for the register spaces and unbounded texture arrays of the bindless tables.
+    static constexpr EntryPoint ENTRY_POINTS[] = {
+        { "VsMain", "vs_5_1" }, { "HsMain", "hs_5_1" }, { "DsMain", "ds_5_1" }, { "GsMain", "gs_5_1" }, { "PsMain", "ps_5_1" } };
+    static constexpr uint32_t NUM_ENTRY_POINTS = sizeof(ENTRY_POINTS) / sizeof(EntryPoint);
+    // D3DCOMPILE_* flags the runtime compiles with, D3DCOMPILE_PACK_MATRIX_COLUMN_MAJOR.
+    static constexpr uint32_t COMPILE_FLAGS = 1u << 4;
+
+    // reads a whole file, false when it can not be opened.
+    using FileReader = std::function<bool(const std::string& path, std::string& content)>;
+    struct CompileJob
+    {
+        std::string mPath;
+        const char* mEntry;
+        const char* mProfile;
+        std::vector<std::string> mDefines;  // NAME or NAME=VALUE
+        uint32_t mFlags;                    // D3DCOMPILE_* flags the compiler applies
+    };
+    // compiles `source` of the job into `bytecode`, false on errors.
+    using CompileFunc = std::function<bool(const CompileJob& job, const std::string& source, std::vector<uint8_t>& bytecode)>;
+    struct BuildStats
+    {
+        uint32_t mNumReused = 0;
+        uint32_t mNumCompiled = 0;
+        uint32_t mNumFailed = 0;
+        uint32_t mNumDropped = 0;   // entries of the previous archive no job produces anymore
+    };
+
+    // `sourcePath` locates the includes, they are resolved relative to the including file like the runtime compiler does.
+    // includes that can not be read only contribute their name.
+    static uint64_t ComputeKey(const void* pSource, size_t size, const std::string& sourcePath, const char* entry,
+        const char* profile, const std::vector<std::string>& defines, uint32_t flags, const FileReader& readFile);
+    static bool ReadFile(const std::string& path, std::string& content);
+
+    // fills `result` with the bytecode of every job, entries of `previous` whose key is unchanged are reused without compiling.
+    static BuildStats Build(const ShaderCache& previous, const std::vector<CompileJob>& jobs, const CompileFunc& compile,
+        const FileReader& readFile, ShaderCache& result);
+
+    // replaces the content with an archive written by Serialize, false and empty when it is malformed.
+    bool Load(const void* pData, size_t size);
+    std::vector<uint8_t> Serialize() const;
+    bool Find(uint64_t key, const void** ppBytecode, size_t* pSize) const;
+    void Store(uint64_t key, const void* pBytecode, size_t size);
+    uint32_t GetNumEntries() const { return static_cast<uint32_t>(mEntries.size()); }
+
+private:
+    struct Header
+    {
+        uint32_t mMagic;
+        uint32_t mVersion;
+        uint32_t mNumEntries;
+        uint32_t mBytecodeSize;
+    };
+    struct Entry
+    {
+        uint64_t mKey;
+        uint32_t mOffset;
+        uint32_t mSize;
+    };
+
+    std::vector<Entry> mEntries;    // sorted by key
+    std::vector<uint8_t> mBytecode;
+};
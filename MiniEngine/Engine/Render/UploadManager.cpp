@@ -0,0 +1,176 @@
+#include "UploadManager.h"
+
+#include "Engine/common/Exception.h"
+#include "Engine/Utility/Telemetry/Telemetry.h"
+
+namespace
+{
+    // tightly packed size of the source data of a mip
+    uint64_t MipDataSize(const RHITextureDesc& desc, uint8_t mipmap)
+    {
+        const uint64_t width = std::max(1u, desc.mWidth >> mipmap);
+        const uint64_t height = std::max(1u, desc.mHeight >> mipmap);
+        const uint64_t depth = desc.mDimension == TextureDimension::TEXTURE3D ? std::max(1u, desc.mDepth >> mipmap) : std::max(1u, desc.mDepth);
+        return width * height * depth * std::max<uint16_t>(::GetFormatStride(desc.mFormat), 1);
+    }
+}
+
+void UploadManager::Initialize(RHI* pRHI)
+{
+    mRHI = pRHI;
+    mFence = pRHI->RHICreateFence();
+}
+
+void UploadManager::UploadBuffer(RHIBufferWrapper* pDst, const void* pData, uint64_t size, bool blockRendering)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    // deferred uploads go first, a later upload into the same resource must not be overwritten by an older one.
+    if (mDeferred.empty() && TryRecordBuffer(pDst, pData, size, blockRendering)) return;
+
+    std::unique_ptr<uint8_t[]> data(new uint8_t[size]);
+    memcpy(data.get(), pData, size);
+    pDst->GetBuffer()->SetUploadToken(DEFERRED_TOKEN);
+    mDeferred.push_back({ pDst, nullptr, std::move(data), size, 0, blockRendering });
+}
+
+void UploadManager::UploadTexture(RHINativeTexture* pDst, const void* pData, uint8_t mipmap, bool blockRendering)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mDeferred.empty() && TryRecordTexture(pDst, pData, mipmap, blockRendering)) return;
+
+    const uint64_t size = MipDataSize(pDst->GetDesc(), mipmap);
+    // the RHI may read the source in whole placement aligned blocks
+    const uint64_t alignedSize = ::AlignUpToMul<uint64_t, 512>()(size);
+    std::unique_ptr<uint8_t[]> data(new uint8_t[alignedSize]{});
+    memcpy(data.get(), pData, size);
+    pDst->SetUploadToken(DEFERRED_TOKEN);
+    mDeferred.push_back({ nullptr, pDst, std::move(data), alignedSize, mipmap, blockRendering });
+}
+
+void UploadManager::Submit(RHIGraphicsContext* pContext)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    const uint64_t completedValue = mFence->GetValue();
+    Retire(completedValue);
+
+    while (!mDeferred.empty())
+    {
+        // the upload leaves the queue before it may throw, it would be retried every frame otherwise.
+        DeferredUpload upload = std::move(mDeferred.front());
+        mDeferred.pop_front();
+        const bool isRecorded = upload.mBuffer ?
+            TryRecordBuffer(upload.mBuffer, upload.mData.get(), upload.mSize, upload.mBlockRendering) :
+            TryRecordTexture(upload.mTexture, upload.mData.get(), upload.mMipmap, upload.mBlockRendering);
+        if (!isRecorded)
+        {
+            mDeferred.push_front(std::move(upload));
+            break;
+        }
+    }
+
+    if (!mRecording.mContexts.empty())
+    {
+        std::vector<RHICopyContext*> contexts(mRecording.mContexts.size());
+        for (size_t i = 0; i < contexts.size(); ++i)
+        {
+            contexts[i] = mRecording.mContexts[i].get();
+        }
+        mRHI->RHIBatchCopyCommands(contexts.data(), static_cast<uint32_t>(contexts.size()));
+        mRecording.mFenceValue = ++mSubmittedValue;
+        mRHI->RHISyncCopyContext(mFence.get(), mSubmittedValue);
+        if (mRecording.mBlockRendering)
+        {
+            pContext->InsertFence(mFence.get(), mSubmittedValue);
+            mBlockingValue = mSubmittedValue;
+        }
+        mInFlight.push_back(std::move(mRecording));
+        mRecording = {};
+        mContextBytes = 0;
+    }
+    // the graphics queue executes frames in order, a batch waited on once stays visible to later frames.
+    mVisibleValue = std::max(completedValue, mBlockingValue);
+}
+
+bool UploadManager::TryRecordBuffer(RHIBufferWrapper* pDst, const void* pData, uint64_t size, bool blockRendering)
+{
+    std::unique_ptr<RHIStagingBuffer> stagingBuffer = mRHI->RHIAllocUploadBuffer(size);
+    CheckStagingBuffer(stagingBuffer.get());
+    if (!stagingBuffer) return false;
+
+    mRHI->RHIUpdateStagingBuffer(stagingBuffer.get(), pData, 0, size);
+    AcquireContext(size)->UpdateBuffer(pDst, stagingBuffer.get(), size, 0, 0);
+    pDst->GetBuffer()->SetUploadToken(mSubmittedValue + 1);
+
+    mContextBytes += size;
+    mRecording.mStagingBuffers.push_back(std::move(stagingBuffer));
+    mRecording.mBlockRendering |= blockRendering;
+    TELEMETRY_COUNT(UPLOAD_BYTES, size);
+    return true;
+}
+
+bool UploadManager::TryRecordTexture(RHINativeTexture* pDst, const void* pData, uint8_t mipmap, bool blockRendering)
+{
+    const RHITextureDesc& desc = pDst->GetDesc();
+    std::unique_ptr<RHIStagingBuffer> stagingBuffer = mRHI->RHIAllocUploadTexture(desc, mipmap);
+    CheckStagingBuffer(stagingBuffer.get());
+    if (!stagingBuffer) return false;
+
+    mRHI->RHIUpdateStagingTexture(stagingBuffer.get(), desc, pData, mipmap);
+    const uint64_t size = stagingBuffer->GetBuffer()->BufferSize();
+    AcquireContext(size)->UpdateTexture(pDst, stagingBuffer.get(), mipmap);
+    pDst->SetUploadToken(mSubmittedValue + 1);
+
+    mContextBytes += size;
+    mRecording.mStagingBuffers.push_back(std::move(stagingBuffer));
+    mRecording.mBlockRendering |= blockRendering;
+    TELEMETRY_COUNT(UPLOAD_BYTES, size);
+    return true;
+}
+
+void UploadManager::CheckStagingBuffer(const RHIStagingBuffer* pStagingBuffer) const
+{
+    // Retire only runs on Submit, batches the fence passed since then still hold the ring until the next one.
+    if (!pStagingBuffer && mInFlight.empty() && mRecording.mStagingBuffers.empty())
+    {
+        THROW_EXCEPTION(TEXT("upload larger than the upload ring."));
+    }
+}
+
+RHICopyContext* UploadManager::AcquireContext(uint64_t size)
+{
+    if (!mRecording.mContexts.empty() && (mContextBytes == 0 || mContextBytes + size <= MAX_BYTES_PER_CONTEXT))
+    {
+        return mRecording.mContexts.back().get();
+    }
+
+    std::unique_ptr<RHICopyContext> context;
+    if (mFreeContexts.empty())
+    {
+        RHICopyContext* pContext;
+        mRHI->RHICreateCopyContext(&pContext);
+        context.reset(pContext);
+    }
+    else
+    {
+        context = std::move(mFreeContexts.back());
+        mFreeContexts.pop_back();
+    }
+    // the command memory of the context is reused, only safe after the batch it was submitted with retired.
+    mRHI->RHIResetCopyContext(context.get());
+    mRecording.mContexts.push_back(std::move(context));
+    mContextBytes = 0;
+    return mRecording.mContexts.back().get();
+}
+
+void UploadManager::Retire(uint64_t completedValue)
+{
+    while (!mInFlight.empty() && mInFlight.front().mFenceValue <= completedValue)
+    {
+        Batch& batch = mInFlight.front();
+        for (std::unique_ptr<RHICopyContext>& context : batch.mContexts)
+        {
+            mFreeContexts.push_back(std::move(context));
+        }
+        mInFlight.pop_front();
+    }
+}
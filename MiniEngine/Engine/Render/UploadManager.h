@@ -0,0 +1,71 @@
+#pragma once
+#include "DynamicRHI.h"
+
+// Streams buffer and texture content to the gpu without ever waiting on the copy queue.
+// Uploads are recorded into copy contexts as they arrive and submitted once per frame as a single batch that signals the
+// next value of the upload fence. The staging memory comes from the upload ring of the RHI, which is reclaimed by the same
+// fence, the copy contexts of a batch are recycled once the fence passed its value. Every destination remembers the fence value of its last upload, see RHINativeResource::GetUploadToken, the
+// renderer skips the draws reading a resource until IsReady.
+// multi-thread supported, assets are uploaded by the loading threads.
+class UploadManager
+{
+public:
+    // a copy context is closed after this many bytes, a large batch reaches the copy queue as several command lists.
+    static constexpr uint64_t MAX_BYTES_PER_CONTEXT = 8ull * 1024 * 1024;
+    // upload token of resources whose upload is deferred, never ready.
+    static constexpr uint64_t DEFERRED_TOKEN = UINT64_MAX;
+
+    void Initialize(RHI* pRHI);
+    // copies `size` bytes of `pData` to the start of `pDst`. with `blockRendering` the frame submitting the copy waits
+    // for it on the gpu instead of skipping the draws reading `pDst`. uploads the upload ring has no room for are
+    // deferred until older batches retired, an upload larger than the whole ring throws.
+    void UploadBuffer(RHIBufferWrapper* pDst, const void* pData, uint64_t size, bool blockRendering);
+    void UploadTexture(RHINativeTexture* pDst, const void* pData, uint8_t mipmap, bool blockRendering);
+    // retires the batches the copy queue finished, records the deferred uploads that fit now and submits everything
+    // recorded since the last call. `pContext` waits for the batch on the gpu when it contains blocking uploads.
+    // main thread only, once per frame before the draws are recorded.
+    void Submit(RHIGraphicsContext* pContext);
+    // whether the last upload into the resource is visible to the frame being recorded.
+    bool IsReady(const RHINativeResource* pResource) const { return pResource->GetUploadToken() <= mVisibleValue; }
+
+private:
+    struct Batch
+    {
+        std::vector<std::unique_ptr<RHICopyContext>> mContexts;
+        std::vector<std::unique_ptr<RHIStagingBuffer>> mStagingBuffers;
+        uint64_t mFenceValue = 0;
+        bool mBlockRendering = false;
+    };
+    // an upload that did not fit into the staging budget, the data is copied because the caller may free it.
+    struct DeferredUpload
+    {
+        RHIBufferWrapper* mBuffer;
+        RHINativeTexture* mTexture;
+        std::unique_ptr<uint8_t[]> mData;
+        uint64_t mSize;
+        uint8_t mMipmap;
+        bool mBlockRendering;
+    };
+
+    bool TryRecordBuffer(RHIBufferWrapper* pDst, const void* pData, uint64_t size, bool blockRendering);
+    bool TryRecordTexture(RHINativeTexture* pDst, const void* pData, uint8_t mipmap, bool blockRendering);
+    // throws when `pStagingBuffer` could not be allocated although nothing holds the upload ring.
+    void CheckStagingBuffer(const RHIStagingBuffer* pStagingBuffer) const;
+    // the copy context of the recording batch with room for `size` more bytes.
+    RHICopyContext* AcquireContext(uint64_t size);
+    void Retire(uint64_t completedValue);
+
+    RHI* mRHI = nullptr;
+    std::unique_ptr<RHIFence> mFence;
+    std::mutex mMutex;
+    Batch mRecording;
+    std::deque<Batch> mInFlight;
+    std::vector<std::unique_ptr<RHICopyContext>> mFreeContexts;
+    std::deque<DeferredUpload> mDeferred;
+    uint64_t mContextBytes = 0;
+    uint64_t mSubmittedValue = 0;
+    // newest batch the graphics queue waits on
+    uint64_t mBlockingValue = 0;
+    // only written by Submit on the main thread, read by the renderer on the same thread.
+    uint64_t mVisibleValue = 0;
+};
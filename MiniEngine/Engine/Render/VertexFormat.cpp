@@ -0,0 +1,157 @@
+#include "VertexFormat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr float UNORM16_MAX = 65535.0f;
+    constexpr float SNORM16_MAX = 32767.0f;
+
+    float SignNotZero(float value)
+    {
+        return value >= 0 ? 1.0f : -1.0f;
+    }
+
+    float DecodedCosine(const int16_t encoded[2], const float normal[3])
+    {
+        float decoded[3];
+        VertexPacking::DecodeOctahedron(encoded, decoded);
+        return decoded[0] * normal[0] + decoded[1] * normal[1] + decoded[2] * normal[2];
+    }
+}
+
+uint16_t VertexPacking::FloatToHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = static_cast<uint16_t>(bits >> 16 & 0x8000);
+    const uint32_t magnitude = bits & 0x7fffffff;
+    // nan keeps a mantissa bit, infinities and everything from 65520 on round to infinity
+    if (magnitude > 0x7f800000) return sign | 0x7e00;
+    if (magnitude >= 0x477ff000) return sign | 0x7c00;
+    // below the smallest normal half the value is a multiple of 2^-24
+    if (magnitude < 0x38800000) return sign | static_cast<uint16_t>(std::nearbyint(std::fabs(value) * 16777216.0f));
+    // rebias the exponent from 127 to 15 and round the mantissa to 10 bits, ties to even
+    const uint32_t rounded = magnitude + 0xfff + (magnitude >> 13 & 1);
+    return sign | static_cast<uint16_t>((rounded - 0x38000000) >> 13);
+}
+
+float VertexPacking::HalfToFloat(uint16_t value)
+{
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+    const uint32_t exponent = value >> 10 & 0x1f;
+    const uint32_t mantissa = value & 0x3ff;
+    if (exponent == 0)
+    {
+        const float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -magnitude : magnitude;
+    }
+    const uint32_t bits = sign | (exponent == 31 ? 0x7f800000 | mantissa << 13 : (exponent + 112) << 23 | mantissa << 13);
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+void VertexPacking::EncodeOctahedron(const float normal[3], int16_t encoded[2])
+{
+    // projects the normal on the octahedron |x| + |y| + |z| = 1 and folds the lower half over the diagonals
+    const float length = std::fabs(normal[0]) + std::fabs(normal[1]) + std::fabs(normal[2]);
+    float u = 0;
+    float v = 0;
+    if (length > 0)
+    {
+        u = normal[0] / length;
+        v = normal[1] / length;
+        if (normal[2] < 0)
+        {
+            const float foldedU = (1 - std::fabs(v)) * SignNotZero(u);
+            v = (1 - std::fabs(u)) * SignNotZero(v);
+            u = foldedU;
+        }
+    }
+    // of the four roundings around the exact point, keeps the one decoding closest to the normal
+    const float scaledU = std::clamp(u, -1.0f, 1.0f) * SNORM16_MAX;
+    const float scaledV = std::clamp(v, -1.0f, 1.0f) * SNORM16_MAX;
+    const float magnitude = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+    const float unit[3] = { 0, 0, 1 };
+    float target[3];
+    for (int i = 0; i < 3; ++i) target[i] = magnitude > 0 ? normal[i] / magnitude : unit[i];
+    float bestCosine = -2;
+    for (int i = 0; i < 4; ++i)
+    {
+        const int16_t candidate[2] = {
+            static_cast<int16_t>(i & 1 ? std::ceil(scaledU) : std::floor(scaledU)),
+            static_cast<int16_t>(i & 2 ? std::ceil(scaledV) : std::floor(scaledV)) };
+        const float cosine = DecodedCosine(candidate, target);
+        if (cosine > bestCosine)
+        {
+            bestCosine = cosine;
+            encoded[0] = candidate[0];
+            encoded[1] = candidate[1];
+        }
+    }
+}
+
+void VertexPacking::DecodeOctahedron(const int16_t encoded[2], float normal[3])
+{
+    // snorm16 maps both -32768 and -32767 to -1
+    normal[0] = std::max(encoded[0] / SNORM16_MAX, -1.0f);
+    normal[1] = std::max(encoded[1] / SNORM16_MAX, -1.0f);
+    normal[2] = 1 - std::fabs(normal[0]) - std::fabs(normal[1]);
+    const float fold = std::max(-normal[2], 0.0f);
+    normal[0] += normal[0] >= 0 ? -fold : fold;
+    normal[1] += normal[1] >= 0 ? -fold : fold;
+    const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+    for (int i = 0; i < 3; ++i) normal[i] /= length;
+}
+
+uint32_t VertexPacking::PackColor(const float color[3])
+{
+    uint32_t packed = 0xff000000;
+    for (int i = 0; i < 3; ++i)
+    {
+        packed |= static_cast<uint32_t>(std::lround(std::clamp(color[i], 0.0f, 1.0f) * 255.0f)) << i * 8;
+    }
+    return packed;
+}
+
+void VertexPacking::PackCompact(CompactVertex* pDestination, std::vector<uint32_t>& colors, const void* pVertices,
+    uint32_t numVertices, const FullVertexAttributes& attributes, const float boundsMin[3], const float boundsMax[3])
+{
+    // flat axes quantize to 0, the dequantization scales them by 0
+    float scale[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        const float extent = boundsMax[axis] - boundsMin[axis];
+        scale[axis] = extent > 0 ? UNORM16_MAX / extent : 0;
+    }
+
+    colors.resize(numVertices);
+    bool sameColors = true;
+    const uint8_t* pVertex = static_cast<const uint8_t*>(pVertices);
+    for (uint32_t i = 0; i < numVertices; ++i, pVertex += attributes.mStride)
+    {
+        float position[3], color[3], normal[3], uv[2];
+        memcpy(position, pVertex, sizeof(position));
+        memcpy(color, pVertex + attributes.mColorOffset, sizeof(color));
+        memcpy(normal, pVertex + attributes.mNormalOffset, sizeof(normal));
+        memcpy(uv, pVertex + attributes.mUvOffset, sizeof(uv));
+
+        CompactVertex& vertex = pDestination[i];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float quantized = std::round((position[axis] - boundsMin[axis]) * scale[axis]);
+            vertex.mPosition[axis] = static_cast<uint16_t>(std::clamp(quantized, 0.0f, UNORM16_MAX));
+        }
+        vertex.mPosition[3] = 0;
+        EncodeOctahedron(normal, vertex.mNormal);
+        vertex.mUv[0] = FloatToHalf(uv[0]);
+        vertex.mUv[1] = FloatToHalf(uv[1]);
+
+        colors[i] = PackColor(color);
+        sameColors = sameColors && colors[i] == colors[0];
+    }
+    if (sameColors && numVertices > 0) colors.resize(1);
+}
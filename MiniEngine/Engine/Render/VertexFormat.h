@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Layouts of the vertices of imported meshes, chosen when the mesh is imported, see MeshCache.
+// FULL keeps the float vertices of the loaders, float3 position, float3 color, float3 normal and float2 uv in 44 bytes.
+// COMPACT packs them into a stream of 16 bytes and a stream of colors:
+//     unorm16x4 position relative to the bounds of the mesh, w is 0 while the float positions of FULL read as 1
+//     snorm16x2 octahedral normal
+//     half2 uv
+//     unorm8x4 color in the second stream, a single color read by every vertex when they all have the same
+// the bounds dequantize the positions, the renderer folds them into the model matrix.
+// Only depends on the standard library, like the mesh cache storing the vertices.
+enum class VertexFormat : uint8_t
+{
+    FULL,
+    COMPACT,
+};
+
+namespace VertexPacking
+{
+    struct CompactVertex
+    {
+        uint16_t mPosition[4];
+        int16_t mNormal[2];
+        uint16_t mUv[2];
+    };
+    static_assert(sizeof(CompactVertex) == 16, "CompactVertex is read by the input layout of COMPACT");
+
+    // where the attributes are in the full vertices, the position is the first float3.
+    struct FullVertexAttributes
+    {
+        uint32_t mStride;
+        uint32_t mColorOffset;
+        uint32_t mNormalOffset;
+        uint32_t mUvOffset;
+    };
+
+    // rounds to the nearest half, values beyond its range become infinities.
+    uint16_t FloatToHalf(float value);
+    float HalfToFloat(uint16_t value);
+    // `normal` does not need to be normalized, a zero normal encodes +z.
+    void EncodeOctahedron(const float normal[3], int16_t encoded[2]);
+    // the normalized normal, as the shaders decode it.
+    void DecodeOctahedron(const int16_t encoded[2], float normal[3]);
+    // rgb in [0, 1] to rgba8 with an opaque alpha, red in the lowest byte.
+    uint32_t PackColor(const float color[3]);
+
+    // converts `numVertices` full vertices, the positions are quantized to the box from `boundsMin` to `boundsMax`.
+    // `colors` receives a color per vertex, or a single one when every vertex has the same.
+    void PackCompact(CompactVertex* pDestination, std::vector<uint32_t>& colors, const void* pVertices, uint32_t numVertices,
+        const FullVertexAttributes& attributes, const float boundsMin[3], const float boundsMax[3]);
+}
@@ -0,0 +1,238 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PROFILER_TIMER_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_TIMER_RDTSC
+#endif
+
+std::mutex Profiler::sRegistryMutex;
+TpVector<std::unique_ptr<ProfileThreadBuffer>> Profiler::sThreadBuffers;
+std::atomic<bool> Profiler::sIsPaused{false};
+
+// steady_clock ticks in nanoseconds, rdtsc is calibrated in sInit
+double Profiler::sTicksPerMs = 1000000.0;
+uint64_t Profiler::sFrameStart = 0;
+uint64_t Profiler::sFrameIndex = 0;
+double Profiler::sLastFrameMs = 0;
+TpVector<uint64_t> Profiler::sReadIndices;
+TpUnorderedMap<std::string_view, ProfileZoneStats> Profiler::sZoneStats;
+TpVector<std::pair<std::string_view, ProfileZoneStats>> Profiler::sSortedZoneStats;
+TpUnorderedMap<std::string_view, int64_t> Profiler::sCounters;
+
+namespace
+{
+    constexpr double AVERAGE_FACTOR = 0.05;
+
+    uint64_t sSteadyNow()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void sWriteJsonString(std::ofstream& out, const char* str)
+    {
+        out << '"';
+        for (const char* c = str; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\') out << '\\';
+            if (static_cast<unsigned char>(*c) < 0x20) continue;
+            out << *c;
+        }
+        out << '"';
+    }
+}
+
+void Profiler::sInit()
+{
+#ifdef PROFILER_TIMER_RDTSC
+    // measure the tsc frequency against steady_clock over a short busy wait
+    const uint64_t clockStart = sSteadyNow();
+    const uint64_t tscStart = __rdtsc();
+    while (sSteadyNow() - clockStart < 20000000) {}
+    const uint64_t tscEnd = __rdtsc();
+    const uint64_t clockEnd = sSteadyNow();
+    sTicksPerMs = static_cast<double>(tscEnd - tscStart) * 1000000.0 / static_cast<double>(clockEnd - clockStart);
+#endif
+    sSetThreadName("Main");
+    sFrameStart = sNow();
+}
+
+uint64_t Profiler::sNow()
+{
+#ifdef PROFILER_TIMER_RDTSC
+    return __rdtsc();
+#else
+    return sSteadyNow();
+#endif
+}
+
+double Profiler::sTicksToMs(uint64_t ticks)
+{
+    return static_cast<double>(ticks) / sTicksPerMs;
+}
+
+ProfileThreadBuffer& Profiler::sGetThreadBuffer()
+{
+    thread_local ProfileThreadBuffer* buffer = sRegisterThread();
+    return *buffer;
+}
+
+ProfileThreadBuffer* Profiler::sRegisterThread()
+{
+    std::lock_guard<std::mutex> lock(sRegistryMutex);
+    auto buffer = std::make_unique<ProfileThreadBuffer>();
+    buffer->mThreadId = static_cast<uint32_t>(sThreadBuffers.size());
+    buffer->mThreadName = "Thread " + std::to_string(buffer->mThreadId);
+    sThreadBuffers.push_back(std::move(buffer));
+    return sThreadBuffers.back().get();
+}
+
+void Profiler::sSetThreadName(const char* name)
+{
+    ProfileThreadBuffer& buffer = sGetThreadBuffer();
+    std::lock_guard<std::mutex> lock(sRegistryMutex);
+    buffer.mThreadName = name;
+}
+
+void Profiler::sPushZone(const char* name, uint64_t start, uint64_t end, uint8_t depth)
+{
+    if (sIsPaused.load(std::memory_order_relaxed)) return;
+    sGetThreadBuffer().push({name, start, end, 0, ProfileEventType::ZONE, depth});
+}
+
+void Profiler::sPushCounter(const char* name, int64_t value)
+{
+    if (sIsPaused.load(std::memory_order_relaxed)) return;
+    const uint64_t now = sNow();
+    sGetThreadBuffer().push({name, now, now, value, ProfileEventType::COUNTER, 0});
+}
+
+void Profiler::sBeginFrame()
+{
+    const uint64_t now = sNow();
+    sLastFrameMs = sTicksToMs(now - sFrameStart);
+    sFrameStart = now;
+    ++sFrameIndex;
+    if (sIsPaused.load(std::memory_order_relaxed)) return;
+
+    sGetThreadBuffer().push({"Frame", now, now, static_cast<int64_t>(sFrameIndex), ProfileEventType::FRAME, 0});
+
+    for (auto& zone : sZoneStats)
+    {
+        zone.second.mCalls = 0;
+        zone.second.mTotalMs = 0;
+        zone.second.mMaxMs = 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sRegistryMutex);
+        sReadIndices.resize(sThreadBuffers.size(), 0);
+        for (size_t i = 0; i < sThreadBuffers.size(); ++i)
+        {
+            const ProfileThreadBuffer& buffer = *sThreadBuffers[i];
+            const uint64_t writeIndex = buffer.mWriteIndex.load(std::memory_order_acquire);
+            uint64_t readIndex = std::max(sReadIndices[i], writeIndex > ProfileThreadBuffer::CAPACITY ? writeIndex - ProfileThreadBuffer::CAPACITY : 0);
+            for (; readIndex < writeIndex; ++readIndex)
+            {
+                ProfileEvent event;
+                if (!buffer.read(readIndex, event)) continue;
+                if (event.mType == ProfileEventType::ZONE)
+                {
+                    ProfileZoneStats& stats = sZoneStats[event.mName];
+                    const double ms = sTicksToMs(event.mEnd - event.mStart);
+                    ++stats.mCalls;
+                    stats.mTotalMs += ms;
+                    stats.mMaxMs = std::max(stats.mMaxMs, ms);
+                }
+                else if (event.mType == ProfileEventType::COUNTER)
+                {
+                    sCounters[event.mName] = event.mValue;
+                }
+            }
+            sReadIndices[i] = writeIndex;
+        }
+    }
+
+    sSortedZoneStats.clear();
+    for (auto& zone : sZoneStats)
+    {
+        zone.second.mAverageMs += (zone.second.mTotalMs - zone.second.mAverageMs) * AVERAGE_FACTOR;
+        sSortedZoneStats.emplace_back(zone.first, zone.second);
+    }
+    std::sort(sSortedZoneStats.begin(), sSortedZoneStats.end(), [](const auto& lhs, const auto& rhs)
+    {
+        return lhs.second.mAverageMs > rhs.second.mAverageMs;
+    });
+}
+
+bool Profiler::sExportChromeTrace(const TpString& path)
+{
+    std::ofstream out(path);
+    if (!out.is_open()) return false;
+
+    std::lock_guard<std::mutex> lock(sRegistryMutex);
+
+    // timestamps are written relative to the oldest event still held
+    uint64_t origin = UINT64_MAX;
+    for (const auto& buffer : sThreadBuffers)
+    {
+        const uint64_t writeIndex = buffer->mWriteIndex.load(std::memory_order_acquire);
+        if (!writeIndex) continue;
+        // the oldest slots may be overwritten meanwhile, the first readable one is the oldest event
+        ProfileEvent event;
+        for (uint64_t i = writeIndex > ProfileThreadBuffer::CAPACITY ? writeIndex - ProfileThreadBuffer::CAPACITY : 0; i < writeIndex; ++i)
+        {
+            if (!buffer->read(i, event)) continue;
+            origin = std::min(origin, event.mStart);
+            break;
+        }
+    }
+    if (origin == UINT64_MAX) origin = 0;
+
+    const double ticksPerUs = sTicksPerMs / 1000.0;
+    out << std::fixed << std::setprecision(3);
+    bool first = true;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (const auto& buffer : sThreadBuffers)
+    {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->mThreadId << ",\"args\":{\"name\":";
+        sWriteJsonString(out, buffer->mThreadName.c_str());
+        out << "}}";
+
+        const uint64_t writeIndex = buffer->mWriteIndex.load(std::memory_order_acquire);
+        for (uint64_t i = writeIndex > ProfileThreadBuffer::CAPACITY ? writeIndex - ProfileThreadBuffer::CAPACITY : 0; i < writeIndex; ++i)
+        {
+            ProfileEvent event;
+            if (!buffer->read(i, event)) continue;
+            const double ts = event.mStart >= origin ? static_cast<double>(event.mStart - origin) / ticksPerUs : 0.0;
+            out << ",\n{\"name\":";
+            sWriteJsonString(out, event.mName);
+            out << ",\"pid\":0,\"tid\":" << buffer->mThreadId << ",\"ts\":" << ts;
+            switch (event.mType)
+            {
+            case ProfileEventType::ZONE:
+                out << ",\"ph\":\"X\",\"dur\":" << static_cast<double>(event.mEnd - event.mStart) / ticksPerUs;
+                break;
+            case ProfileEventType::COUNTER:
+                out << ",\"ph\":\"C\",\"args\":{\"value\":" << event.mValue << "}";
+                break;
+            case ProfileEventType::FRAME:
+                out << ",\"ph\":\"i\",\"s\":\"g\",\"args\":{\"frame\":" << event.mValue << "}";
+                break;
+            }
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+    return out.good();
+}
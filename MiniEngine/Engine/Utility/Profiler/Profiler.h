@@ -0,0 +1,183 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "Engine/Memory/TankinMemory.h"
+
+// The profiler is compiled in unless DISABLE_PROFILER is defined,
+// in which case every PROFILE_* macro expands to nothing.
+#ifndef DISABLE_PROFILER
+#define ENABLE_PROFILER
+#endif
+
+enum class ProfileEventType : uint8_t
+{
+    ZONE,
+    COUNTER,
+    FRAME
+};
+
+struct ProfileEvent
+{
+    const char* mName;      // must have static lifetime, string literals are expected
+    uint64_t mStart;        // ticks
+    uint64_t mEnd;          // ticks, equals mStart for counters and frame markers
+    int64_t mValue;         // counter value or frame index
+    ProfileEventType mType;
+    uint8_t mDepth;
+};
+
+struct ProfileZoneStats
+{
+    uint32_t mCalls = 0;
+    double mTotalMs = 0;    // inclusive time in the last frame
+    double mMaxMs = 0;
+    double mAverageMs = 0;  // exponential moving average over frames
+};
+
+// Single-producer ring buffer owned by one thread.
+// Only the owning thread writes; readers take a window through the atomic write index and read every slot through
+// its sequence number, events overwritten while they were read are skipped instead of torn.
+class ProfileThreadBuffer
+{
+public:
+    static constexpr uint32_t CAPACITY = 8192;
+
+    void push(const ProfileEvent& event)
+    {
+        const uint64_t index = mWriteIndex.load(std::memory_order_relaxed);
+        Slot& slot = mSlots[index & (CAPACITY - 1)];
+        // odd while the slot is written, 2 * (index + 1) once the event of `index` is complete
+        slot.mSequence.store(index * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        uint64_t words[EVENT_WORDS] = {};
+        memcpy(words, &event, sizeof(ProfileEvent));
+        for (uint32_t i = 0; i < EVENT_WORDS; ++i) slot.mWords[i].store(words[i], std::memory_order_relaxed);
+        slot.mSequence.store(index * 2 + 2, std::memory_order_release);
+        mWriteIndex.store(index + 1, std::memory_order_release);
+    }
+
+    // false when the event of `index` was not written yet or has been overwritten.
+    bool read(uint64_t index, ProfileEvent& event) const
+    {
+        const Slot& slot = mSlots[index & (CAPACITY - 1)];
+        const uint64_t sequence = index * 2 + 2;
+        if (slot.mSequence.load(std::memory_order_acquire) != sequence) return false;
+        uint64_t words[EVENT_WORDS];
+        for (uint32_t i = 0; i < EVENT_WORDS; ++i) words[i] = slot.mWords[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.mSequence.load(std::memory_order_relaxed) != sequence) return false;
+        memcpy(&event, words, sizeof(ProfileEvent));
+        return true;
+    }
+
+    std::atomic<uint64_t> mWriteIndex{0};
+    uint32_t mThreadId = 0;
+    uint8_t mDepth = 0;
+    TpString mThreadName;
+
+private:
+    static constexpr uint32_t EVENT_WORDS = (sizeof(ProfileEvent) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct Slot
+    {
+        std::atomic<uint64_t> mSequence{0};
+        std::atomic<uint64_t> mWords[EVENT_WORDS];
+    };
+
+    std::array<Slot, CAPACITY> mSlots;
+};
+
+class Profiler
+{
+public:
+    static void sInit();
+    // marks the frame boundary and aggregates the zones of the frame that just finished.
+    static void sBeginFrame();
+    static void sSetThreadName(const char* name);
+
+    static uint64_t sNow();
+    static double sTicksToMs(uint64_t ticks);
+
+    static void sPushZone(const char* name, uint64_t start, uint64_t end, uint8_t depth);
+    static void sPushCounter(const char* name, int64_t value);
+    static ProfileThreadBuffer& sGetThreadBuffer();
+
+    // write everything still held by the ring buffers as Chrome trace_event JSON (chrome://tracing, Perfetto).
+    static bool sExportChromeTrace(const TpString& path);
+
+    static const TpVector<std::pair<std::string_view, ProfileZoneStats>>& sGetZoneStats() { return sSortedZoneStats; }
+    static const TpUnorderedMap<std::string_view, int64_t>& sGetCounters() { return sCounters; }
+    static double sGetLastFrameMs() { return sLastFrameMs; }
+    static uint64_t sGetFrameIndex() { return sFrameIndex; }
+
+    static void sSetPaused(bool paused) { sIsPaused.store(paused, std::memory_order_relaxed); }
+    static bool sGetIsPaused() { return sIsPaused.load(std::memory_order_relaxed); }
+
+private:
+    Profiler() = default;
+
+    static ProfileThreadBuffer* sRegisterThread();
+
+    static std::mutex sRegistryMutex;
+    static TpVector<std::unique_ptr<ProfileThreadBuffer>> sThreadBuffers;
+    static std::atomic<bool> sIsPaused;
+
+    static double sTicksPerMs;
+    static uint64_t sFrameStart;
+    static uint64_t sFrameIndex;
+    static double sLastFrameMs;
+    static TpVector<uint64_t> sReadIndices;
+    static TpUnorderedMap<std::string_view, ProfileZoneStats> sZoneStats;
+    static TpVector<std::pair<std::string_view, ProfileZoneStats>> sSortedZoneStats;
+    static TpUnorderedMap<std::string_view, int64_t> sCounters;
+};
+
+// RAII zone, records [construction, destruction) into the calling thread's buffer.
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char* name) : mName(name), mStart(Profiler::sNow())
+    {
+        mDepth = Profiler::sGetThreadBuffer().mDepth++;
+    }
+
+    ~ProfileScope()
+    {
+        ProfileThreadBuffer& buffer = Profiler::sGetThreadBuffer();
+        --buffer.mDepth;
+        Profiler::sPushZone(mName, mStart, Profiler::sNow(), mDepth);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* mName;
+    uint64_t mStart;
+    uint8_t mDepth;
+};
+
+#ifdef ENABLE_PROFILER
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#define PROFILE_COUNTER(name, value) Profiler::sPushCounter((name), static_cast<int64_t>(value))
+#define PROFILE_FRAME() Profiler::sBeginFrame()
+#define PROFILE_THREAD_NAME(name) Profiler::sSetThreadName(name)
+#else
+#define PROFILE_SCOPE(name) (void)0
+#define PROFILE_FUNCTION() (void)0
+#define PROFILE_COUNTER(name, value) (void)0
+#define PROFILE_FRAME() (void)0
+#define PROFILE_THREAD_NAME(name) (void)0
+#endif
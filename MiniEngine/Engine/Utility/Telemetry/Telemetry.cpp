@@ -0,0 +1,286 @@
+#include "Telemetry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include "Engine/Utility/Profiler/Profiler.h"
+#include "Engine/Utility/ThreadPool/ThreadPool.h"
+
+std::mutex Telemetry::sRegistryMutex;
+TpVector<std::unique_ptr<Telemetry::ThreadSlot>> Telemetry::sThreadSlots;
+
+TpString Telemetry::sOutputPrefix;
+float Telemetry::sDumpInterval = 0;
+double Telemetry::sLastDumpTime = 0;
+uint64_t Telemetry::sStartTime = 0;
+uint64_t Telemetry::sFrameStart = 0;
+uint64_t Telemetry::sFrameIndex = 0;
+bool Telemetry::sCsvHeaderWritten = false;
+ThreadPool* Telemetry::sThreadPool = nullptr;
+std::future<void> Telemetry::sDumpTask;
+
+std::array<int64_t, TELEMETRY_COUNTER_COUNT> Telemetry::sCounterTotals{};
+std::array<uint64_t, TELEMETRY_TIMER_COUNT> Telemetry::sTimerTotals{};
+std::array<TelemetryHistogram, TELEMETRY_TIMER_COUNT> Telemetry::sHistograms;
+TelemetryFrame Telemetry::sLastFrame;
+TpVector<TelemetryFrame> Telemetry::sPendingFrames;
+
+namespace
+{
+    uint64_t sNowNs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
+
+void TelemetryHistogram::addSample(float value)
+{
+    mSamples[mNext] = value;
+    mNext = (mNext + 1) % WINDOW;
+    mCount = std::min(mCount + 1, WINDOW);
+}
+
+float TelemetryHistogram::getPercentile(float p) const
+{
+    if (!mCount) return 0;
+    mScratch.assign(mSamples.begin(), mSamples.begin() + mCount);
+    const size_t rank = std::min(static_cast<size_t>(std::ceil(p * mCount)), static_cast<size_t>(mCount)) - (p > 0 ? 1 : 0);
+    std::nth_element(mScratch.begin(), mScratch.begin() + rank, mScratch.end());
+    return mScratch[rank];
+}
+
+void Telemetry::sInit(const TpString& outputPrefix, float dumpIntervalSeconds, ThreadPool* ioThreads)
+{
+    sOutputPrefix = outputPrefix;
+    sDumpInterval = dumpIntervalSeconds;
+    sThreadPool = ioThreads;
+    sStartTime = sNowNs();
+    sFrameStart = sStartTime;
+    sLastDumpTime = 0;
+    sCsvHeaderWritten = false;
+    sPendingFrames.reserve(1024);
+}
+
+Telemetry::ThreadSlot& Telemetry::sGetThreadSlot()
+{
+    thread_local ThreadSlot* slot = sRegisterThread();
+    return *slot;
+}
+
+Telemetry::ThreadSlot* Telemetry::sRegisterThread()
+{
+    std::lock_guard<std::mutex> lock(sRegistryMutex);
+    sThreadSlots.push_back(std::make_unique<ThreadSlot>());
+    return sThreadSlots.back().get();
+}
+
+void Telemetry::sEndFrame()
+{
+    const uint64_t now = sNowNs();
+    TelemetryFrame frame;
+    frame.mFrameIndex = sFrameIndex++;
+    frame.mTimeSeconds = static_cast<double>(now - sStartTime) * 1e-9;
+
+    std::array<int64_t, TELEMETRY_COUNTER_COUNT> counterTotals{};
+    std::array<uint64_t, TELEMETRY_TIMER_COUNT> timerTotals{};
+    {
+        std::lock_guard<std::mutex> lock(sRegistryMutex);
+        for (const auto& slot : sThreadSlots)
+        {
+            for (size_t i = 0; i < TELEMETRY_COUNTER_COUNT; ++i) counterTotals[i] += slot->mCounters[i].load(std::memory_order_relaxed);
+            for (size_t i = 0; i < TELEMETRY_GAUGE_COUNT; ++i) frame.mGauges[i] += slot->mGauges[i].load(std::memory_order_relaxed);
+            for (size_t i = 0; i < TELEMETRY_TIMER_COUNT; ++i) timerTotals[i] += slot->mTimerNs[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    for (size_t i = 0; i < TELEMETRY_COUNTER_COUNT; ++i)
+    {
+        frame.mCounters[i] = counterTotals[i] - sCounterTotals[i];
+    }
+    for (size_t i = 0; i < TELEMETRY_TIMER_COUNT; ++i)
+    {
+        frame.mTimerMs[i] = static_cast<double>(timerTotals[i] - sTimerTotals[i]) * 1e-6;
+    }
+    // the frame timer is the distance between two aggregations
+    frame.mTimerMs[static_cast<size_t>(TelemetryTimer::FRAME)] = static_cast<double>(now - sFrameStart) * 1e-6;
+    sCounterTotals = counterTotals;
+    sTimerTotals = timerTotals;
+    sFrameStart = now;
+
+    for (size_t i = 0; i < TELEMETRY_TAG_COUNT; ++i)
+    {
+        frame.mAllocatorBytes[i] = MemoryTracker::GetStats(static_cast<MemoryTag>(i)).mLiveBytes;
+    }
+
+    for (size_t i = 0; i < TELEMETRY_TIMER_COUNT; ++i)
+    {
+        sHistograms[i].addSample(static_cast<float>(frame.mTimerMs[i]));
+    }
+    for (size_t i = 0; i < TELEMETRY_COUNTER_COUNT; ++i)
+    {
+        PROFILE_COUNTER(sGetCounterName(static_cast<TelemetryCounter>(i)), frame.mCounters[i]);
+    }
+
+    sLastFrame = frame;
+    if (sDumpInterval <= 0) return;
+    sPendingFrames.push_back(frame);
+    if (frame.mTimeSeconds - sLastDumpTime < sDumpInterval) return;
+    // a dump still being written keeps the frames pending until the next one
+    if (sDumpTask.valid() && sDumpTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+    sLastDumpTime = frame.mTimeSeconds;
+    if (!sThreadPool)
+    {
+        sDump();
+        return;
+    }
+    std::shared_ptr<DumpData> data = std::make_shared<DumpData>(sTakeDumpData());
+    try
+    {
+        sDumpTask = sThreadPool->enqueue(1, [data]() { sWriteDump(*data); });
+    }
+    catch (const std::exception&)
+    {
+        // the pool is stopped or its queue is full
+        sWriteDump(*data);
+    }
+}
+
+void Telemetry::sShutdown()
+{
+    if (sDumpInterval > 0) sDump();
+}
+
+void Telemetry::sDump()
+{
+    if (sDumpTask.valid()) sDumpTask.get();
+    sWriteDump(sTakeDumpData());
+}
+
+Telemetry::DumpData Telemetry::sTakeDumpData()
+{
+    DumpData data;
+    data.mOutputPrefix = sOutputPrefix;
+    data.mWriteCsvHeader = !sCsvHeaderWritten;
+    sCsvHeaderWritten = true;
+    data.mFrames.swap(sPendingFrames);
+    sPendingFrames.reserve(data.mFrames.capacity());
+    data.mLastFrame = sLastFrame;
+    for (size_t i = 0; i < TELEMETRY_TIMER_COUNT; ++i)
+    {
+        const TelemetryHistogram& histogram = sHistograms[i];
+        data.mPercentiles[i] = { histogram.getPercentile(0.5f), histogram.getPercentile(0.95f), histogram.getPercentile(0.99f) };
+        data.mSampleCounts[i] = histogram.getSampleCount();
+    }
+    return data;
+}
+
+void Telemetry::sWriteDump(const DumpData& data)
+{
+    // csv: one row per frame since the last dump
+    std::ofstream csv(data.mOutputPrefix + "telemetry.csv", data.mWriteCsvHeader ? std::ios::trunc : std::ios::app);
+    if (csv.is_open())
+    {
+        if (data.mWriteCsvHeader)
+        {
+            csv << "frame,time";
+            for (size_t i = 0; i < TELEMETRY_TIMER_COUNT; ++i) csv << ',' << sGetTimerName(static_cast<TelemetryTimer>(i)) << "Ms";
+            for (size_t i = 0; i < TELEMETRY_COUNTER_COUNT; ++i) csv << ',' << sGetCounterName(static_cast<TelemetryCounter>(i));
+            for (size_t i = 0; i < TELEMETRY_GAUGE_COUNT; ++i) csv << ',' << sGetGaugeName(static_cast<TelemetryGauge>(i));
+            for (size_t i = 0; i < TELEMETRY_TAG_COUNT; ++i) csv << ",Memory" << MemoryTracker::GetTagName(static_cast<MemoryTag>(i));
+            csv << '\n';
+        }
+        for (const TelemetryFrame& frame : data.mFrames)
+        {
+            csv << frame.mFrameIndex << ',' << frame.mTimeSeconds;
+            for (double ms : frame.mTimerMs) csv << ',' << ms;
+            for (int64_t value : frame.mCounters) csv << ',' << value;
+            for (int64_t value : frame.mGauges) csv << ',' << value;
+            for (int64_t value : frame.mAllocatorBytes) csv << ',' << value;
+            csv << '\n';
+        }
+    }
+
+    // json: rolling percentiles and the latest frame
+    const TelemetryFrame& lastFrame = data.mLastFrame;
+    std::ofstream json(data.mOutputPrefix + "telemetry.json", std::ios::trunc);
+    if (!json.is_open()) return;
+    json << "{\n  \"frame\": " << lastFrame.mFrameIndex << ",\n  \"time\": " << lastFrame.mTimeSeconds << ",\n  \"timers\": {";
+    for (size_t i = 0; i < TELEMETRY_TIMER_COUNT; ++i)
+    {
+        const std::array<float, 3>& percentiles = data.mPercentiles[i];
+        json << (i ? ",\n" : "\n") << "    \"" << sGetTimerName(static_cast<TelemetryTimer>(i)) << "\": { \"p50\": " << percentiles[0]
+            << ", \"p95\": " << percentiles[1] << ", \"p99\": " << percentiles[2]
+            << ", \"samples\": " << data.mSampleCounts[i] << " }";
+    }
+    json << "\n  },\n  \"counters\": {";
+    for (size_t i = 0; i < TELEMETRY_COUNTER_COUNT; ++i)
+    {
+        json << (i ? ",\n" : "\n") << "    \"" << sGetCounterName(static_cast<TelemetryCounter>(i)) << "\": " << lastFrame.mCounters[i];
+    }
+    json << "\n  },\n  \"gauges\": {";
+    for (size_t i = 0; i < TELEMETRY_GAUGE_COUNT; ++i)
+    {
+        json << (i ? ",\n" : "\n") << "    \"" << sGetGaugeName(static_cast<TelemetryGauge>(i)) << "\": " << lastFrame.mGauges[i];
+    }
+    json << "\n  },\n  \"memory\": {";
+    for (size_t i = 0; i < TELEMETRY_TAG_COUNT; ++i)
+    {
+        json << (i ? ",\n" : "\n") << "    \"" << MemoryTracker::GetTagName(static_cast<MemoryTag>(i)) << "\": " << lastFrame.mAllocatorBytes[i];
+    }
+    json << "\n  }\n}\n";
+}
+
+const char* Telemetry::sGetCounterName(TelemetryCounter counter)
+{
+    switch (counter)
+    {
+    case TelemetryCounter::DRAW_CALLS: return "DrawCalls";
+    case TelemetryCounter::RENDER_ITEMS: return "RenderItems";
+    case TelemetryCounter::RIGID_BODIES_TESTED: return "RigidBodiesTested";
+    case TelemetryCounter::COLLISION_PAIRS: return "CollisionPairs";
+    case TelemetryCounter::PATH_QUERIES: return "PathQueries";
+    case TelemetryCounter::PARTICLES_ALIVE: return "ParticlesAlive";
+    case TelemetryCounter::ASSET_BYTES_LOADED: return "AssetBytesLoaded";
+    case TelemetryCounter::VISIBLE_OBJECTS: return "VisibleObjects";
+    case TelemetryCounter::CULLED_OBJECTS: return "CulledObjects";
+    case TelemetryCounter::PIPELINE_STATE_CHANGES: return "PipelineStateChanges";
+    case TelemetryCounter::MATERIAL_CHANGES: return "MaterialChanges";
+    case TelemetryCounter::CONSTANT_BUFFER_ALLOCATIONS: return "ConstantBufferAllocations";
+    case TelemetryCounter::CONSTANT_BYTES_UPLOADED: return "ConstantBytesUploaded";
+    case TelemetryCounter::COMMAND_LISTS: return "CommandLists";
+    case TelemetryCounter::UPLOAD_BYTES: return "UploadBytes";
+    case TelemetryCounter::DEPTH_PRE_PASS_ITEMS: return "DepthPrePassItems";
+    case TelemetryCounter::SHADER_CACHE_HITS: return "ShaderCacheHits";
+    case TelemetryCounter::SHADER_CACHE_MISSES: return "ShaderCacheMisses";
+    case TelemetryCounter::PIPELINE_STATE_CREATIONS: return "PipelineStateCreations";
+    case TelemetryCounter::PIPELINE_LIBRARY_HITS: return "PipelineLibraryHits";
+    case TelemetryCounter::TRIANGLES: return "Triangles";
+    case TelemetryCounter::LOD_TRIANGLES_SAVED: return "LodTrianglesSaved";
+    case TelemetryCounter::OBJECT_CONSTANTS_UPDATED: return "ObjectConstantsUpdated";
+    default: return "Unknown";
+    }
+}
+
+const char* Telemetry::sGetGaugeName(TelemetryGauge gauge)
+{
+    switch (gauge)
+    {
+    case TelemetryGauge::ASSET_BYTES_RESIDENT: return "AssetBytesResident";
+    case TelemetryGauge::LOADED_ASSETS: return "LoadedAssets";
+    default: return "Unknown";
+    }
+}
+
+const char* Telemetry::sGetTimerName(TelemetryTimer timer)
+{
+    switch (timer)
+    {
+    case TelemetryTimer::FRAME: return "Frame";
+    case TelemetryTimer::GAMEPLAY: return "Gameplay";
+    case TelemetryTimer::PHYSICS: return "Physics";
+    case TelemetryTimer::RENDER: return "Render";
+    default: return "Unknown";
+    }
+}
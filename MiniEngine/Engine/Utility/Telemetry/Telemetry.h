@@ -0,0 +1,220 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+
+#include "Engine/Memory/MemoryTracker.h"
+#include "Engine/Memory/TankinMemory.h"
+
+// Telemetry is meant to stay on in shipping builds, define DISABLE_TELEMETRY to compile it out.
+#ifndef DISABLE_TELEMETRY
+#define ENABLE_TELEMETRY
+#endif
+
+class ThreadPool;
+
+// per-frame totals, reset after every aggregation
+enum class TelemetryCounter : uint8_t
+{
+    DRAW_CALLS = 0,
+    RENDER_ITEMS,
+    RIGID_BODIES_TESTED,    // broad phase pair tests
+    COLLISION_PAIRS,
+    PATH_QUERIES,
+    PARTICLES_ALIVE,
+    ASSET_BYTES_LOADED,
+    VISIBLE_OBJECTS,        // frustum culling results, summed over cameras
+    CULLED_OBJECTS,
+    PIPELINE_STATE_CHANGES, // binds left after sorting and redundant state skipping
+    MATERIAL_CHANGES,
+    CONSTANT_BUFFER_ALLOCATIONS,    // constant buffers allocated for a single frame
+    CONSTANT_BYTES_UPLOADED,        // per frame, persistent object and material constants
+    COMMAND_LISTS,                  // graphics contexts submitted, more than one when passes are recorded in parallel
+    UPLOAD_BYTES,                   // staging bytes recorded for the copy queue, see UploadManager
+    DEPTH_PRE_PASS_ITEMS,           // occluders drawn into the depth pre-pass
+    SHADER_CACHE_HITS,              // shader stages loaded from the shader cache
+    SHADER_CACHE_MISSES,            // shader stages compiled at runtime
+    PIPELINE_STATE_CREATIONS,       // pipeline states created by a draw because they were neither prewarmed nor cached
+    PIPELINE_LIBRARY_HITS,          // pipeline states loaded from the pipeline library instead of being compiled
+    TRIANGLES,                      // triangles of the extracted mesh render items, at their level of detail
+    LOD_TRIANGLES_SAVED,            // triangles the selected levels of detail removed from those items
+    OBJECT_CONSTANTS_UPDATED,       // persistent object constant slots rewritten because their object moved
+    COUNT
+};
+
+// levels that persist across frames, reported as signed deltas
+enum class TelemetryGauge : uint8_t
+{
+    ASSET_BYTES_RESIDENT = 0,   // cpu bytes kept by loaded assets, data released after the gpu upload is subtracted
+    LOADED_ASSETS,
+    COUNT
+};
+
+// accumulated wall time per frame, kept in rolling histograms
+enum class TelemetryTimer : uint8_t
+{
+    FRAME = 0,
+    GAMEPLAY,
+    PHYSICS,
+    RENDER,
+    COUNT
+};
+
+constexpr size_t TELEMETRY_COUNTER_COUNT = static_cast<size_t>(TelemetryCounter::COUNT);
+constexpr size_t TELEMETRY_GAUGE_COUNT = static_cast<size_t>(TelemetryGauge::COUNT);
+constexpr size_t TELEMETRY_TIMER_COUNT = static_cast<size_t>(TelemetryTimer::COUNT);
+constexpr size_t TELEMETRY_TAG_COUNT = static_cast<size_t>(MemoryTag::COUNT);
+
+struct TelemetryFrame
+{
+    uint64_t mFrameIndex = 0;
+    double mTimeSeconds = 0;
+    std::array<double, TELEMETRY_TIMER_COUNT> mTimerMs{};
+    std::array<int64_t, TELEMETRY_COUNTER_COUNT> mCounters{};
+    std::array<int64_t, TELEMETRY_GAUGE_COUNT> mGauges{};
+    std::array<int64_t, TELEMETRY_TAG_COUNT> mAllocatorBytes{};
+};
+
+// Fixed window of the most recent samples, percentiles are computed on demand.
+class TelemetryHistogram
+{
+public:
+    static constexpr uint32_t WINDOW = 1024;
+
+    void addSample(float value);
+    // p in [0, 1]
+    float getPercentile(float p) const;
+    uint32_t getSampleCount() const { return mCount; }
+
+private:
+    std::array<float, WINDOW> mSamples{};
+    uint32_t mNext = 0;
+    uint32_t mCount = 0;
+    mutable TpVector<float> mScratch;
+};
+
+class Telemetry
+{
+public:
+    // dumps are appended to `<outputPrefix>telemetry.csv` and `<outputPrefix>telemetry.json` every `dumpIntervalSeconds`, 0 disables dumping.
+    // the files are written by `ioThreads` when given, by the thread ending the frame otherwise.
+    static void sInit(const TpString& outputPrefix = "", float dumpIntervalSeconds = 5.0f, ThreadPool* ioThreads = nullptr);
+    // aggregate every thread's slots, must be called once per frame from the main thread.
+    static void sEndFrame();
+    static void sShutdown();
+
+    static void sCount(TelemetryCounter counter, int64_t value);
+    static void sAddGauge(TelemetryGauge gauge, int64_t delta);
+    static void sAddTime(TelemetryTimer timer, uint64_t nanoseconds);
+
+    static const TelemetryFrame& sGetLastFrame() { return sLastFrame; }
+    static const TelemetryHistogram& sGetHistogram(TelemetryTimer timer) { return sHistograms[static_cast<size_t>(timer)]; }
+    static const char* sGetCounterName(TelemetryCounter counter);
+    static const char* sGetGaugeName(TelemetryGauge gauge);
+    static const char* sGetTimerName(TelemetryTimer timer);
+
+    // writes the frames aggregated so far on the calling thread, after the dump in flight completed
+    static void sDump();
+
+private:
+    Telemetry() = default;
+
+    // copied when the dump starts, the next frames are aggregated while it is written
+    struct DumpData
+    {
+        TpString mOutputPrefix;
+        bool mWriteCsvHeader = false;
+        TpVector<TelemetryFrame> mFrames;
+        TelemetryFrame mLastFrame;
+        std::array<std::array<float, 3>, TELEMETRY_TIMER_COUNT> mPercentiles{};   // p50, p95, p99
+        std::array<uint32_t, TELEMETRY_TIMER_COUNT> mSampleCounts{};
+    };
+
+    static DumpData sTakeDumpData();
+    static void sWriteDump(const DumpData& data);
+
+    // Written by the owning thread only, read by the aggregator.
+    // Values only ever grow by the owner's deltas so the aggregator diffs against its previous totals.
+    struct alignas(64) ThreadSlot
+    {
+        std::array<std::atomic<int64_t>, TELEMETRY_COUNTER_COUNT> mCounters{};
+        std::array<std::atomic<int64_t>, TELEMETRY_GAUGE_COUNT> mGauges{};
+        std::array<std::atomic<uint64_t>, TELEMETRY_TIMER_COUNT> mTimerNs{};
+    };
+
+    static ThreadSlot& sGetThreadSlot();
+    static ThreadSlot* sRegisterThread();
+
+    static std::mutex sRegistryMutex;
+    static TpVector<std::unique_ptr<ThreadSlot>> sThreadSlots;
+
+    static TpString sOutputPrefix;
+    static float sDumpInterval;
+    static double sLastDumpTime;
+    static uint64_t sStartTime;
+    static uint64_t sFrameStart;
+    static uint64_t sFrameIndex;
+    static bool sCsvHeaderWritten;
+    static ThreadPool* sThreadPool;
+    static std::future<void> sDumpTask;
+
+    static std::array<int64_t, TELEMETRY_COUNTER_COUNT> sCounterTotals;
+    static std::array<uint64_t, TELEMETRY_TIMER_COUNT> sTimerTotals;
+    static std::array<TelemetryHistogram, TELEMETRY_TIMER_COUNT> sHistograms;
+    static TelemetryFrame sLastFrame;
+    static TpVector<TelemetryFrame> sPendingFrames;
+};
+
+inline void Telemetry::sCount(TelemetryCounter counter, int64_t value)
+{
+    std::atomic<int64_t>& slot = sGetThreadSlot().mCounters[static_cast<size_t>(counter)];
+    slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+inline void Telemetry::sAddGauge(TelemetryGauge gauge, int64_t delta)
+{
+    std::atomic<int64_t>& slot = sGetThreadSlot().mGauges[static_cast<size_t>(gauge)];
+    slot.store(slot.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+inline void Telemetry::sAddTime(TelemetryTimer timer, uint64_t nanoseconds)
+{
+    std::atomic<uint64_t>& slot = sGetThreadSlot().mTimerNs[static_cast<size_t>(timer)];
+    slot.store(slot.load(std::memory_order_relaxed) + nanoseconds, std::memory_order_relaxed);
+}
+
+// RAII helper adding the scope duration to a timer.
+class TelemetryScope
+{
+public:
+    explicit TelemetryScope(TelemetryTimer timer) : mTimer(timer), mStart(std::chrono::steady_clock::now()) {}
+    ~TelemetryScope()
+    {
+        Telemetry::sAddTime(mTimer, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - mStart).count()));
+    }
+
+    TelemetryScope(const TelemetryScope&) = delete;
+    TelemetryScope& operator=(const TelemetryScope&) = delete;
+
+private:
+    TelemetryTimer mTimer;
+    std::chrono::steady_clock::time_point mStart;
+};
+
+#ifdef ENABLE_TELEMETRY
+#define TELEMETRY_CONCAT_IMPL(a, b) a##b
+#define TELEMETRY_CONCAT(a, b) TELEMETRY_CONCAT_IMPL(a, b)
+#define TELEMETRY_COUNT(counter, value) Telemetry::sCount(TelemetryCounter::counter, static_cast<int64_t>(value))
+#define TELEMETRY_GAUGE_ADD(gauge, delta) Telemetry::sAddGauge(TelemetryGauge::gauge, static_cast<int64_t>(delta))
+#define TELEMETRY_TIMER(timer) TelemetryScope TELEMETRY_CONCAT(telemetryScope, __LINE__)(TelemetryTimer::timer)
+#else
+#define TELEMETRY_COUNT(counter, value) (void)0
+#define TELEMETRY_GAUGE_ADD(gauge, delta) (void)0
+#define TELEMETRY_TIMER(timer) (void)0
+#endif
@@ -2,6 +2,8 @@
 #include <iostream>
 #include <limits>
 
+#include "Engine/Utility/Profiler/Profiler.h"
+
 // 非模板成员函数的实现必须放在.cpp文件
 ThreadPool::ThreadPool(size_t coreThreads, size_t maxThreads,
     size_t maxQueueSize, RejectionPolicy policy)
@@ -21,6 +23,7 @@ ThreadPool::~ThreadPool() {
 }
 
 void ThreadPool::workerThread() {
+    PROFILE_THREAD_NAME("ThreadPool Worker");
     while (running) {
         Task task;
         {
@@ -38,6 +41,7 @@ void ThreadPool::workerThread() {
         }
         activeCount++;
         try {
+            PROFILE_SCOPE("ThreadPool::task");
             if (task.function) task.function();
         }
         catch (...) {}
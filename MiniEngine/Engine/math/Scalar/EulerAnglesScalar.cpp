@@ -0,0 +1,110 @@
+#if !defined(WIN32) && !defined(ORBIS)
+#include "EulerAnglesScalar.h"
+#include "Engine/math/MathUtils.h"
+#include "QuaternionScalar.h"
+#include "Matrix3x4Scalar.h"
+#include "RotationMatrixScalar.h"
+
+void EulerAngles::canonize()
+{
+    pitch = MathUtils::wrapPi(pitch);
+    yaw = MathUtils::wrapPi(yaw);
+    roll = MathUtils::wrapPi(roll);
+
+    // keep pitch in [-pi/2, pi/2]
+    if (pitch < -MathUtils::kPiOver2) {
+        pitch = -MathUtils::kPi - pitch;
+        yaw += MathUtils::kPi;
+        roll += MathUtils::kPi;
+    } else if (pitch > MathUtils::kPiOver2) {
+        pitch = MathUtils::kPi - pitch;
+        yaw += MathUtils::kPi;
+        roll += MathUtils::kPi;
+    }
+
+    // gimbal lock
+    if (fabs(pitch) > MathUtils::kPiOver2 - 1e-4) {
+        yaw += roll;
+        roll = 0.0f;
+    }
+}
+
+void EulerAngles::fromObjectToInertialQuaternion(const Quaternion& quaternion) {
+    float qw = quaternion.q.w;
+    float qx = quaternion.q.x;
+    float qy = quaternion.q.y;
+    float qz = quaternion.q.z;
+
+    float sp = -2.0f * (qy * qz - qw * qx);
+    if (fabs(sp) >= 1.0f) {
+        pitch = copysign(MathUtils::kPiOver2, sp);
+    } else {
+        pitch = asin(sp);
+    }
+
+    yaw = atan2(qx * qz + qw * qy, 0.5f - qx * qx - qy * qy);
+
+    roll = atan2(qx * qy + qw * qz, 0.5f - qx * qx - qz * qz);
+}
+
+void EulerAngles::fromInertialToObjectQuaternion(const Quaternion& quaternion) {
+    float qw = quaternion.q.w;
+    float qx = quaternion.q.x;
+    float qy = quaternion.q.y;
+    float qz = quaternion.q.z;
+
+    float sp = -2.0f * (qy * qz + qw * qx);
+    if (fabs(sp) >= 1.0f) {
+        pitch = copysign(MathUtils::kPiOver2, sp);
+    } else {
+        pitch = asin(sp);
+    }
+
+    yaw = atan2(-qx * qz + qw * qy, 0.5f - qx * qx - qy * qy);
+
+    roll = atan2(-qx * qy + qw * qz, 0.5f - qx * qx - qz * qz);
+}
+
+void EulerAngles::fromWorldToObjectMatrix(const Matrix3x4& matrix3_x4) {
+    float sp = -matrix3_x4.m._23;
+
+    // gimbal lock
+    if (fabs(sp) > 0.9999f) {
+        pitch = MathUtils::kPiOver2 * sp;
+
+        yaw = atan2(-matrix3_x4.m._31, matrix3_x4.m._11);
+        roll = 0.0f;
+    } else {
+        yaw = atan2(matrix3_x4.m._13, matrix3_x4.m._33);
+        pitch = asin(sp);
+        roll = atan2(matrix3_x4.m._21, matrix3_x4.m._22);
+    }
+}
+
+void EulerAngles::fromObjectToWorldMatrix(const Matrix3x4& matrix3_x4) {
+    fromWorldToObjectMatrix(matrix3_x4);
+}
+
+void EulerAngles::fromRotationMatrix(const RotationMatrix& matrix)
+{
+    float sp = -matrix.m._23;
+
+    // gimbal lock, never taken like the PC implementation
+    if (fabs(sp) > 9.99999f)
+    {
+        pitch = MathUtils::kPiOver2 * sp;
+        yaw = atan2(-matrix.m._31, matrix.m._11);
+        roll = 0.0f;
+    }
+    else
+    {
+        yaw = atan2(matrix.m._13, matrix.m._33);
+        pitch = asin(sp);
+        roll = atan2(matrix.m._21, matrix.m._22);
+    }
+}
+
+
+const EulerAngles kEulerAnglesIdentity(0.0f, 0.0f, 0.0f);
+
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+#if !defined(WIN32) && !defined(ORBIS)
+#include "ScalarTypes.h"
+
+struct Quaternion;
+struct Matrix3x4;
+struct RotationMatrix;
+
+struct EulerAngles {
+    float pitch; // about x
+    float yaw;   // about y
+    float roll;  // about z
+
+    EulerAngles() : pitch(0.0f), yaw(0.0f), roll(0.0f) {}
+    EulerAngles(float p, float y, float r) : pitch(p), yaw(y), roll(r) {};
+
+    void identity() {pitch = yaw = roll = 0.0f;}
+
+    void canonize();
+
+    void fromObjectToInertialQuaternion(const Quaternion& quaternion);
+    void fromInertialToObjectQuaternion(const Quaternion& quaternion);
+
+    void fromObjectToWorldMatrix(const Matrix3x4& matrix3_x4);
+    void fromWorldToObjectMatrix(const Matrix3x4& matrix3_x4);
+
+    void fromRotationMatrix(const RotationMatrix& matrix);
+};
+extern const EulerAngles kEulerAnglesIdentity;
+
+#endif
@@ -0,0 +1,278 @@
+#if !defined(WIN32) && !defined(ORBIS)
+#include "Matrix3x4Scalar.h"
+#include "EulerAnglesScalar.h"
+#include "QuaternionScalar.h"
+#include "RotationMatrixScalar.h"
+#include "Vector3Scalar.h"
+
+#include <stdexcept>
+
+// Stored like the PC implementation, the first three rows of the transposed DirectXMath matrix.
+
+namespace
+{
+    void SetRotation(Float3x4& m, const float rotation[3][3])
+    {
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int column = 0; column < 3; ++column) m.m[row][column] = rotation[row][column];
+            m.m[row][3] = 0.0f;
+        }
+    }
+
+    // the reflection of XMMatrixReflect about the plane a * x + b * y + c * z + d = 0
+    void SetReflection(Float3x4& m, float a, float b, float c, float d)
+    {
+        const float length = std::sqrt(a * a + b * b + c * c);
+        const float plane[4] = { a / length, b / length, c / length, d / length };
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int column = 0; column < 3; ++column) m.m[row][column] = (row == column ? 1.0f : 0.0f) - 2.0f * plane[row] * plane[column];
+            m.m[row][3] = -2.0f * plane[3] * plane[row];
+        }
+    }
+}
+
+void Matrix3x4::identity() {
+    m = Float3x4(1.0f, 0.0f, 0.0f, 0.0f,
+                 0.0f, 1.0f, 0.0f, 0.0f,
+                 0.0f, 0.0f, 1.0f, 0.0f);
+}
+
+void Matrix3x4::zeroTranslation() {
+    m._14 = m._24 = m._34 = 0.0f;
+}
+
+void Matrix3x4::setTranslation(const Vector3& d) {
+    m._14 = d.v.x;
+    m._24 = d.v.y;
+    m._34 = d.v.z;
+}
+
+void Matrix3x4::setupTranslation(const Vector3& d) {
+    identity();
+    setTranslation(d);
+}
+
+// translated first, then rotated, like the PC implementation
+void Matrix3x4::setupLocalToParent(const Vector3& pos, const EulerAngles& orient) {
+    float rotation[3][3];
+    ScalarMath::QuaternionToMatrix(ScalarMath::QuaternionFromRollPitchYaw(orient.pitch, orient.yaw, orient.roll), rotation);
+    SetRotation(m, rotation);
+    for (int row = 0; row < 3; ++row)
+    {
+        m.m[row][3] = rotation[row][0] * pos.v.x + rotation[row][1] * pos.v.y + rotation[row][2] * pos.v.z;
+    }
+}
+
+void Matrix3x4::setupLocalToParent(const Vector3& pos, const RotationMatrix& orient) {
+    m._11 = orient.m._11; m._12 = orient.m._12;
+    m._21 = orient.m._22; m._23 = orient.m._23;
+    m._31 = orient.m._31; m._32 = orient.m._32;
+
+    m._14 = pos.v.x; m._24 = pos.v.y; m._34 = pos.v.z;
+}
+
+void Matrix3x4::setupParentToLocal(const Vector3& pos, const EulerAngles& orient)
+{
+    float rotation[3][3];
+    ScalarMath::QuaternionToMatrix(ScalarMath::QuaternionFromRollPitchYaw(-orient.pitch, -orient.yaw, -orient.roll), rotation);
+    SetRotation(m, rotation);
+    setTranslation(pos * -1.0f);
+}
+
+void Matrix3x4::setupParentToLocal(const Vector3& pos, const RotationMatrix& orient)
+{
+    m._11 = orient.m._11; m._12 = orient.m._12;
+    m._21 = orient.m._22; m._23 = orient.m._23;
+    m._31 = orient.m._31; m._32 = orient.m._32;
+
+    m._14 = -(pos.v.x * m._11 + pos.v.y * m._21 + pos.v.z * m._31);
+    m._24 = -(pos.v.x * m._12 + pos.v.y * m._22 + pos.v.z * m._32);
+    m._34 = -(pos.v.x * m._13 + pos.v.y * m._23 + pos.v.z * m._33);
+}
+
+void Matrix3x4::setupRotate(int axis, float theta)
+{
+    const float s = std::sin(theta), c = std::cos(theta);
+    switch (axis) {
+    case 1: // X-axis
+        m = Float3x4(1, 0, 0, 0,
+                     0, c, -s, 0,
+                     0, s, c, 0);
+        break;
+    case 2: // Y-axis
+        m = Float3x4(c, 0, s, 0,
+                     0, 1, 0, 0,
+                     -s, 0, c, 0);
+        break;
+    case 3: // Z-axis
+        m = Float3x4(c, -s, 0, 0,
+                     s, c, 0, 0,
+                     0, 0, 1, 0);
+        break;
+    default:
+        identity();
+        break;
+    }
+}
+
+void Matrix3x4::setupRotation(const Vector3& rotation)
+{
+    float matrix[3][3];
+    ScalarMath::QuaternionToMatrix(ScalarMath::QuaternionFromRollPitchYaw(rotation.v.x, rotation.v.y, rotation.v.z), matrix);
+    SetRotation(m, matrix);
+}
+
+void Matrix3x4::setupRotate(const Vector3& axis, float theta)
+{
+    float matrix[3][3];
+    ScalarMath::QuaternionToMatrix(ScalarMath::QuaternionFromAxisAngle(axis.v, theta), matrix);
+    SetRotation(m, matrix);
+}
+
+void Matrix3x4::fromQuaternion(const Quaternion& q) {
+    float matrix[3][3];
+    ScalarMath::QuaternionToMatrix(q.q, matrix);
+    SetRotation(m, matrix);
+}
+
+void Matrix3x4::setupScale(const Vector3& s) {
+    m = Float3x4(s.v.x, 0, 0, 0,
+                 0, s.v.y, 0, 0,
+                 0, 0, s.v.z, 0);
+}
+
+// scales along the coordinate axes by `axis * k` like the PC implementation
+void Matrix3x4::setupScaleAlongAxis(const Vector3& axis, float k) {
+    setupScale(axis * k);
+}
+
+void Matrix3x4::setupShear(int axis, float s, float t)
+{
+    identity();
+    switch (axis) {
+    case 1: // y += s * x, z += t * x
+        m.m[0][1] = s;
+        m.m[0][2] = t;
+        break;
+    case 2: // x += s * y, z += t * y
+        m.m[1][0] = s;
+        m.m[1][2] = t;
+        break;
+    case 3: // x += s * z, y += t * z
+        m.m[2][0] = s;
+        m.m[2][1] = t;
+        break;
+    default:
+        throw std::invalid_argument("Invalid axis for shearing. Must be 1, 2, or 3.");
+    }
+}
+
+void Matrix3x4::setupProject(const Vector3& n)
+{
+    const float a = n.v.x;
+    const float b = n.v.y;
+    const float c = n.v.z;
+    m = Float3x4(1 - a * a, -a * b, -a * c, 0,
+                 -a * b, 1 - b * b, -b * c, 0,
+                 -a * c, -b * c, 1 - c * c, 0);
+}
+
+void Matrix3x4::setupReflect(int axis, float k) {
+    switch (axis) {
+    case 1: // x = k
+        SetReflection(m, 1.0f, 0.0f, 0.0f, -k);
+        break;
+    case 2: // y = k
+        SetReflection(m, 0.0f, 1.0f, 0.0f, -k);
+        break;
+    case 3: // z = k
+        SetReflection(m, 0.0f, 0.0f, 1.0f, -k);
+        break;
+    default:
+        identity();
+        break;
+    }
+}
+
+void Matrix3x4::setupReflect(const Vector3& n) {
+    SetReflection(m, n.v.x, n.v.y, n.v.z, 0.0f);
+}
+
+
+Float4x4 Matrix3x4::ToFloat4x4() const {
+    return Float4x4(
+        m._11, m._12, m._13, m._14,
+        m._21, m._22, m._23, m._24,
+        m._31, m._32, m._33, m._34,
+        0.0f,  0.0f,  0.0f,  1.0f
+    );
+}
+
+Matrix3x4 Matrix3x4::FromFloat4x4(const Float4x4& mat)
+{
+    return Matrix3x4(
+        mat.m[0][0], mat.m[0][1], mat.m[0][2], mat.m[0][3],
+        mat.m[1][0], mat.m[1][1], mat.m[1][2], mat.m[1][3],
+        mat.m[2][0], mat.m[2][1], mat.m[2][2], mat.m[2][3]
+        );
+}
+
+
+// the vector as a row vector, like the PC implementation
+Vector3 operator*(const Matrix3x4& m, const Vector3& v) {
+    Vector3 result;
+    for (int column = 0; column < 3; ++column)
+    {
+        (&result.v.x)[column] = v.v.x * m.m.m[0][column] + v.v.y * m.m.m[1][column] + v.v.z * m.m.m[2][column];
+    }
+    return result;
+}
+
+// the transposed product of the rows, like the PC implementation
+Matrix3x4 operator*(const Matrix3x4& m1, const Matrix3x4& m2) {
+    const Float4x4 a = m1.ToFloat4x4();
+    const Float4x4 b = m2.ToFloat4x4();
+    Float4x4 product;
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int column = 0; column < 4; ++column)
+        {
+            product.m[column][row] = a.m[row][0] * b.m[0][column] + a.m[row][1] * b.m[1][column] +
+                a.m[row][2] * b.m[2][column] + a.m[row][3] * b.m[3][column];
+        }
+    }
+    return Matrix3x4::FromFloat4x4(product);
+}
+
+
+
+float determinant(const Matrix3x4& m) {
+    float result;
+    ScalarMath::Inverse(m.ToFloat4x4(), &result);
+    return result;
+}
+
+Matrix3x4 inverse(const Matrix3x4& m) {
+    return Matrix3x4::FromFloat4x4(ScalarMath::Inverse(m.ToFloat4x4()));
+}
+
+Vector3 getTranslation(const Matrix3x4& m) {
+    return Vector3(m.m._14, m.m._24, m.m._34);
+}
+
+Vector3 getPositionFromParentToLocalMatrix(const Matrix3x4& m) {
+    return getTranslation(m);
+}
+
+Vector3 getPositionFromLocalToParentMatrix(const Matrix3x4& m) {
+    return getTranslation(m);
+}
+
+const Matrix3x4 kMatrixIdentity(
+    1.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f);
+
+#endif
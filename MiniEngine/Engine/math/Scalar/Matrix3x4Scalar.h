@@ -0,0 +1,77 @@
+#pragma once
+#if !defined(WIN32) && !defined(ORBIS)
+#include "ScalarTypes.h"
+
+struct Vector3;
+struct EulerAngles;
+struct Quaternion;
+struct RotationMatrix;
+
+struct Matrix3x4 {
+    Float3x4 m;
+
+    Matrix3x4() : m(1.0f, 0.0f, 0.0f, 0.0f,
+                   0.0f, 1.0f, 0.0f, 0.0f,
+                   0.0f, 0.0f, 1.0f, 0.0f) {}
+    
+    Matrix3x4(float m11, float m12, float m13, float m14,
+              float m21, float m22, float m23, float m24,
+              float m31, float m32, float m33, float m34) 
+        : m(m11, m12, m13, m14,
+            m21, m22, m23, m24,
+            m31, m32, m33, m34) {}
+
+    void identity();
+
+    void zeroTranslation();
+    void setTranslation(const Vector3& d);
+    void setupTranslation(const Vector3& d);
+
+    void setupLocalToParent(const Vector3& pos, const EulerAngles& orient);
+    void setupLocalToParent(const Vector3& pos, const RotationMatrix& orient);
+    void setupParentToLocal(const Vector3& pos, const EulerAngles& orient);
+    void setupParentToLocal(const Vector3& pos, const RotationMatrix& orient);
+
+    // 1, 2 and 3 rotate about x, y and z
+    void setupRotate(int axis, float theta);
+
+    void setupRotation(const Vector3& rotation);
+
+    void setupRotate(const Vector3& axis, float theta);
+
+    void fromQuaternion(const Quaternion& q);
+
+    void setupScale(const Vector3& s);
+
+    void setupScaleAlongAxis(const Vector3& axis, float k);
+    void setupShear(int axis, float s, float t);
+
+    // projection on the plane through the origin with the normal `n`
+    void setupProject(const Vector3& n);
+    
+    // 1, 2 and 3 reflect about the planes x = k, y = k and z = k
+    void setupReflect(int axis, float k = 0.0f);
+
+    void setupReflect(const Vector3& n);
+
+    // the rows of the matrix with a fourth row of 0, 0, 0, 1
+    Float4x4 ToFloat4x4() const;
+    static Matrix3x4 FromFloat4x4(const Float4x4& mat);
+};
+
+Vector3 operator*(const Matrix3x4& m, const Vector3& v);
+Matrix3x4 operator*(const Matrix3x4& m, const Matrix3x4& n);
+
+
+// of the 3x3 part
+float determinant(const Matrix3x4& m);
+
+Matrix3x4 inverse(const Matrix3x4& m);
+
+Vector3 getTranslation(const Matrix3x4& m);
+
+Vector3 getPositionFromParentToLocalMatrix(const Matrix3x4& m);
+Vector3 getPositionFromLocalToParentMatrix(const Matrix3x4& m);
+
+extern const Matrix3x4 kMatrixIdentity; 
+#endif
@@ -0,0 +1,158 @@
+#if !defined(WIN32) && !defined(ORBIS)
+#include "Matrix4x4Scalar.h"
+
+#include "QuaternionScalar.h"
+#include "Vector3Scalar.h"
+
+// The setters build the same matrices as the PC implementation, the transpose of the DirectXMath ones.
+
+const Matrix4x4 Matrix4x4::Identity = { 1, 0, 0, 0,
+                                        0, 1, 0, 0,
+                                        0, 0, 1, 0,
+                                        0, 0, 0, 1};
+
+const Matrix4x4 Matrix4x4::Zero =     { 0, 0, 0, 0,
+                                        0, 0, 0, 0,
+                                        0, 0, 0, 0,
+                                        0, 0, 0, 0};
+
+namespace
+{
+    // rotation in the upper left, `scale` applied first, `translation` in the last column
+    Matrix4x4 Affine(const float rotation[3][3], const Vector3& scale, const Vector3& translation)
+    {
+        Matrix4x4 result;
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int column = 0; column < 3; ++column) result.m.m[row][column] = rotation[row][column] * scale[column];
+            result.m.m[row][3] = translation[row];
+        }
+        return result;
+    }
+
+    // the view of XMMatrixLookToLH
+    Matrix4x4 LookTo(const Vector3& position, const Vector3& direction, const Vector3& up)
+    {
+        const Vector3 axisZ = direction.Normalize();
+        const Vector3 axisX = Vector3::CrossProduct(up, axisZ).Normalize();
+        const Vector3 axisY = Vector3::CrossProduct(axisZ, axisX);
+        return Matrix4x4(axisX.v.x, axisX.v.y, axisX.v.z, -axisX.Dot(position),
+                         axisY.v.x, axisY.v.y, axisY.v.z, -axisY.Dot(position),
+                         axisZ.v.x, axisZ.v.y, axisZ.v.z, -axisZ.Dot(position),
+                         0, 0, 0, 1);
+    }
+}
+
+
+void Matrix4x4::setTranslation(float tx, float ty, float tz) {
+    *this = Matrix4x4(1, 0, 0, tx,
+                      0, 1, 0, ty,
+                      0, 0, 1, tz,
+                      0, 0, 0, 1);
+}
+
+void Matrix4x4::setRotationX(float theta) {
+    const float s = std::sin(theta), c = std::cos(theta);
+    *this = Matrix4x4(1, 0, 0, 0,
+                      0, c, -s, 0,
+                      0, s, c, 0,
+                      0, 0, 0, 1);
+}
+
+void Matrix4x4::setRotationY(float theta) {
+    const float s = std::sin(theta), c = std::cos(theta);
+    *this = Matrix4x4(c, 0, s, 0,
+                      0, 1, 0, 0,
+                      -s, 0, c, 0,
+                      0, 0, 0, 1);
+}
+
+void Matrix4x4::setRotationZ(float theta) {
+    const float s = std::sin(theta), c = std::cos(theta);
+    *this = Matrix4x4(c, -s, 0, 0,
+                      s, c, 0, 0,
+                      0, 0, 1, 0,
+                      0, 0, 0, 1);
+}
+
+void Matrix4x4::setScale(float sx, float sy, float sz) {
+    *this = Matrix4x4(sx, 0, 0, 0,
+                      0, sy, 0, 0,
+                      0, 0, sz, 0,
+                      0, 0, 0, 1);
+}
+
+
+void Matrix4x4::setPerspectiveProjection(float fov, float aspect, float zn, float zf) {
+    const float height = 1.0f / std::tan(fov * 0.5f);
+    const float width = height / aspect;
+    const float range = zf / (zf - zn);
+    *this = Matrix4x4(width, 0, 0, 0,
+                      0, height, 0, 0,
+                      0, 0, range, -range * zn,
+                      0, 0, 1, 0);
+}
+
+void Matrix4x4::setOrthographicProjection(float width, float height, float zn, float zf)
+{
+    const float range = 1.0f / (zf - zn);
+    *this = Matrix4x4(2.0f / width, 0, 0, 0,
+                      0, 2.0f / height, 0, 0,
+                      0, 0, range, -range * zn,
+                      0, 0, 0, 1);
+}
+
+void Matrix4x4::setView(const Vector3& position, const Vector3& forward, const Vector3& up, const Vector3& right)
+{
+    const Vector3 direction = forward.Normalize();
+    *this = LookTo(position, direction, Vector3::CrossProduct(direction, right).Normalize());
+}
+
+void Matrix4x4::lookAt(const Vector3& positon, const Vector3& target, const Vector3& up)
+{
+    *this = LookTo(positon, target - positon, up);
+}
+
+void Matrix4x4::setModelMatrix(const Vector3& position,const Vector3& rotation,const Vector3& scale)
+{
+    float matrix[3][3];
+    ScalarMath::QuaternionToMatrix(ScalarMath::QuaternionFromRollPitchYaw(rotation.v.x, rotation.v.y, rotation.v.z), matrix);
+    *this = Affine(matrix, scale, position);
+}
+
+void Matrix4x4::setModelMatrixQuaternion(const Vector3& position, const Quaternion& quaternion, const Vector3& scale)
+{
+    float matrix[3][3];
+    ScalarMath::QuaternionToMatrix(quaternion.q, matrix);
+    *this = Affine(matrix, scale, position);
+}
+
+void Matrix4x4::inverseSelf()
+{
+    m = ScalarMath::Inverse(m);
+}
+
+Matrix4x4 Matrix4x4::transpose() const
+{
+    Matrix4x4 ret;
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int column = 0; column < 4; ++column) ret.m.m[row][column] = m.m[column][row];
+    }
+    return ret;
+}
+
+Matrix4x4 Matrix4x4::operator*(const Matrix4x4& other) const
+{
+    Matrix4x4 ret;
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int column = 0; column < 4; ++column)
+        {
+            ret.m.m[row][column] = m.m[row][0] * other.m.m[0][column] + m.m[row][1] * other.m.m[1][column] +
+                m.m[row][2] * other.m.m[2][column] + m.m[row][3] * other.m.m[3][column];
+        }
+    }
+    return ret;
+}
+#endif
@@ -0,0 +1,194 @@
+#if !defined(WIN32) && !defined(ORBIS)
+#include "QuaternionScalar.h"
+#include "Vector3Scalar.h"
+#include "Engine/math/MathUtils.h"
+
+#include <cfloat>
+
+
+// Empty Quaternion
+const Quaternion kQuaternionEmpty(0.0f, 0.0f, 0.0f, 1.0f);
+
+void Quaternion::setToRotateAboutX(float theta)
+{
+	q = ScalarMath::QuaternionFromRollPitchYaw(theta, 0.0f, 0.0f);
+}
+
+void Quaternion::setToTotateAboutY(float theta)
+{
+	q = ScalarMath::QuaternionFromRollPitchYaw(0.0f, theta, 0.0f);
+}
+
+void Quaternion::setToTotateAboutZ(float theta)
+{
+	q = ScalarMath::QuaternionFromRollPitchYaw(0.0f, 0.0f, theta);
+}
+
+void Quaternion::setToRotateAboutAxis(const Vector3& axis, float theta)
+{
+	q = ScalarMath::QuaternionFromAxisAngle(axis.v, theta);
+}
+
+void Quaternion::setQuaternionRotationRollPitchYaw(const Vector3& eularAngle)
+{
+	q = ScalarMath::QuaternionFromRollPitchYaw(eularAngle.v.x, eularAngle.v.y, eularAngle.v.z);
+}
+
+Quaternion Quaternion::operator *(const Quaternion& a) const
+{
+	Quaternion result;
+	result.q = ScalarMath::QuaternionMultiply(q, a.q);
+	return result;
+}
+
+Quaternion Quaternion::operator *=(const Quaternion& a)
+{
+	q = ScalarMath::QuaternionMultiply(q, a.q);
+	return *this;
+}
+
+void Quaternion::QuaternionRotateVector(Vector3& vec) const
+{
+	float matrix[3][3];
+	ScalarMath::QuaternionToMatrix(q, matrix);
+	const Vector3 source = vec;
+	for (int row = 0; row < 3; ++row)
+	{
+		(&vec.v.x)[row] = matrix[row][0] * source.v.x + matrix[row][1] * source.v.y + matrix[row][2] * source.v.z;
+	}
+}
+
+Quaternion Quaternion::getInverse() const
+{
+	const float lengthSquared = dotProduct(*this, *this);
+	if (lengthSquared <= FLT_EPSILON) return Quaternion(0.0f, 0.0f, 0.0f, 0.0f);
+	const Quaternion conjugate = conjugater(*this);
+	return Quaternion(conjugate.q.x / lengthSquared, conjugate.q.y / lengthSquared, conjugate.q.z / lengthSquared,
+		conjugate.q.w / lengthSquared);
+}
+
+
+void Quaternion::normalize()
+{
+	const float length = std::sqrt(dotProduct(*this, *this));
+	const float scale = length > 0 ? 1.0f / length : 0.0f;
+	q = Float4(q.x * scale, q.y * scale, q.z * scale, q.w * scale);
+}
+
+// like XMQuaternionToAxisAngle, the axis is not normalized
+float Quaternion::getRotationAngle() const
+{
+	return 2.0f * std::acos(q.w);
+}
+
+Vector3 Quaternion::getRotationAxis() const
+{
+	return Vector3(q.x, q.y, q.z);
+}
+
+Vector3 Quaternion::getEulerAnglesDegree() const
+{
+	Vector3 eulerAngles;
+	Quaternion normalized = *this;
+	normalized.normalize();
+
+	// indexed like the rows of the DirectXMath rotation matrix, the transpose of ours
+	float matrix[3][3];
+	ScalarMath::QuaternionToMatrix(normalized.q, matrix);
+	auto r = [&matrix](int row, int column) { return matrix[column][row]; };
+
+	if (r(2, 1) < 0.999f)
+	{
+		if (r(2, 1) > -0.999f)
+		{
+			eulerAngles.v.x = asin(r(2, 1));
+			eulerAngles.v.y = atan2(r(2, 0), r(2, 2));
+			eulerAngles.v.z = atan2(r(0, 1), r(1, 1));
+		}
+		else
+		{
+			eulerAngles.v.x = MathUtils::PI * 0.5F;
+			eulerAngles.v.y = atan2(r(1, 0), r(0, 0));
+			eulerAngles.v.z = 0.0F;
+		}
+	}
+	else
+	{
+		eulerAngles.v.x = -MathUtils::PI * 0.5F;
+		eulerAngles.v.y = atan2(-r(1, 0), r(0, 0));
+		eulerAngles.v.z = 0.0F;
+	}
+
+	return eulerAngles* MathUtils::RAD_TO_DEG;
+}
+
+rapidxml::xml_node<>* Quaternion::serialize(rapidxml::xml_document<>* doc, rapidxml::xml_node<>* father, const TpString& value)
+{
+	auto mXmlNode = doc->allocate_node(rapidxml::node_element, "Quaternion");
+	father->append_node(mXmlNode);
+
+	mXmlNode->value(doc->allocate_string(value.c_str()));
+	
+	mXmlNode->append_attribute(doc->allocate_attribute("x", doc->allocate_string(std::to_string(q.x).c_str())));
+	mXmlNode->append_attribute(doc->allocate_attribute("y", doc->allocate_string(std::to_string(q.y).c_str())));
+	mXmlNode->append_attribute(doc->allocate_attribute("z", doc->allocate_string(std::to_string(q.z).c_str())));
+	mXmlNode->append_attribute(doc->allocate_attribute("w", doc->allocate_string(std::to_string(q.w).c_str())));
+	return mXmlNode;
+}
+
+void Quaternion::deSerialize(const rapidxml::xml_node<>* node)
+{
+	q.x = std::stof(node->first_attribute("x")->value());
+	q.y = std::stof(node->first_attribute("y")->value());
+	q.z = std::stof(node->first_attribute("z")->value());
+	q.w = std::stof(node->first_attribute("w")->value());
+}
+
+
+float dotProduct(const Quaternion& quaternion_a, const Quaternion& quaternion_b)
+{
+	const Float4& a = quaternion_a.q;
+	const Float4& b = quaternion_b.q;
+	return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+// XMQuaternionSlerp
+Quaternion slerp(const Quaternion& quaternion0, const Quaternion& quaternion1, float t)
+{
+	float cosOmega = dotProduct(quaternion0, quaternion1);
+	float sign = 1.0f;
+	if (cosOmega < 0)
+	{
+		cosOmega = -cosOmega;
+		sign = -1.0f;
+	}
+	float scale0 = 1.0f - t;
+	float scale1 = t;
+	if (cosOmega < 1.0f - 0.00001f)
+	{
+		const float sinOmega = std::sqrt(1.0f - cosOmega * cosOmega);
+		const float omega = std::atan2(sinOmega, cosOmega);
+		scale0 = std::sin((1.0f - t) * omega) / sinOmega;
+		scale1 = std::sin(t * omega) / sinOmega;
+	}
+	scale1 *= sign;
+	const Float4& q0 = quaternion0.q;
+	const Float4& q1 = quaternion1.q;
+	return Quaternion(q0.x * scale0 + q1.x * scale1, q0.y * scale0 + q1.y * scale1, q0.z * scale0 + q1.z * scale1,
+		q0.w * scale0 + q1.w * scale1);
+}
+
+Quaternion conjugater(const Quaternion& quaternion)
+{
+	return Quaternion(-quaternion.q.x, -quaternion.q.y, -quaternion.q.z, quaternion.q.w);
+}
+
+
+Quaternion pow(const Quaternion& quaternion, float exponent)
+{
+	Quaternion result;
+	result.setToRotateAboutAxis(quaternion.getRotationAxis(), quaternion.getRotationAngle() * exponent);
+	return result;
+}
+
+#endif
@@ -0,0 +1,61 @@
+#pragma once
+#include "Engine/Memory/TankinMemory.h"
+#include "Engine/Scene/ISerializable.h"
+
+#if !defined(WIN32) && !defined(ORBIS)
+#include "ScalarTypes.h"
+
+struct Vector3;
+struct Quaternion;
+struct EulerAngles;
+struct Matrix4x4;
+
+
+struct Quaternion
+{
+    Float4 q;
+
+    Quaternion() : q(0.0f, 0.0f, 0.0f, 1.0f) {}
+    Quaternion(float x, float y, float z, float w) : q(x, y, z, w) {}
+
+    void setToRotateAboutX(float theta);
+    void setToTotateAboutY(float theta);
+    void setToTotateAboutZ(float theta);
+    void setToRotateAboutAxis(const Vector3& axis, float theta);
+
+    void setQuaternionRotationRollPitchYaw(const Vector3& eularAngle);
+
+    Quaternion operator *(const Quaternion& a) const;
+
+    Quaternion operator *=(const Quaternion& a);
+
+    // rotate a direction
+    void QuaternionRotateVector(Vector3& vec) const;
+
+    Quaternion getInverse() const;
+
+    void normalize();
+
+    float getRotationAngle() const;
+    Vector3 getRotationAxis() const;
+
+    //transform to euler angles
+    Vector3 getEulerAnglesDegree() const;
+    
+    //serialization
+    rapidxml::xml_node<>* serialize(rapidxml::xml_document<>* doc, rapidxml::xml_node<>* father, const TpString& value = "");
+    void deSerialize(const rapidxml::xml_node<>* node);
+};
+
+// empty Quaternion
+extern const Quaternion kQuaternionEmpty;
+
+extern float dotProduct(const Quaternion& a, const Quaternion& b);
+
+extern Quaternion slerp(const Quaternion& p, const Quaternion& q, float t);
+
+extern Quaternion conjugater(const Quaternion& q);
+
+extern Quaternion pow(const Quaternion& q, float exponent);
+
+#endif
@@ -0,0 +1,59 @@
+#if !defined(WIN32) && !defined(ORBIS)
+#include "RotationMatrixScalar.h"
+#include "EulerAnglesScalar.h"
+#include "QuaternionScalar.h"
+#include "Vector3Scalar.h"
+
+// Stored like the PC implementation, the DirectXMath rotation matrix that transforms row vectors.
+
+namespace
+{
+    void SetTransposed(Float3x3& m, const float rotation[3][3])
+    {
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int column = 0; column < 3; ++column) m.m[row][column] = rotation[column][row];
+        }
+    }
+}
+
+const RotationMatrix kRoationMatrixIdentity(1.0f, 0.0f, 0.0f,
+                                            0.0f, 1.0f, 0.0f,
+                                            0.0f, 0.0f, 1.0f);
+
+void RotationMatrix::identity() {
+    m = Float3x3(1.0f, 0.0f, 0.0f,
+                 0.0f, 1.0f, 0.0f,
+                 0.0f, 0.0f, 1.0f);
+}
+
+void RotationMatrix::setup(const EulerAngles& orientation) {
+    float rotation[3][3];
+    ScalarMath::QuaternionToMatrix(ScalarMath::QuaternionFromRollPitchYaw(orientation.pitch, orientation.yaw, orientation.roll), rotation);
+    SetTransposed(m, rotation);
+}
+
+void RotationMatrix::fromInertialToObjectQuaternion(const Quaternion& q) {
+    float rotation[3][3];
+    ScalarMath::QuaternionToMatrix(q.q, rotation);
+    SetTransposed(m, rotation);
+}
+
+void RotationMatrix::fromObjectToInertialQuaternion(const Quaternion& q) {
+    float rotation[3][3];
+    ScalarMath::QuaternionToMatrix(q.getInverse().q, rotation);
+    SetTransposed(m, rotation);
+}
+
+Vector3 RotationMatrix::inertialToObject(const Vector3& v) const {
+    return Vector3(v.v.x * m._11 + v.v.y * m._21 + v.v.z * m._31,
+                   v.v.x * m._12 + v.v.y * m._22 + v.v.z * m._32,
+                   v.v.x * m._13 + v.v.y * m._23 + v.v.z * m._33);
+}
+
+Vector3 RotationMatrix::objectToInertial(const Vector3& v) const {
+    return Vector3(v.v.x * m._11 + v.v.y * m._12 + v.v.z * m._13,
+                   v.v.x * m._21 + v.v.y * m._22 + v.v.z * m._23,
+                   v.v.x * m._31 + v.v.y * m._32 + v.v.z * m._33);
+}
+#endif
@@ -0,0 +1,71 @@
+#if !defined(WIN32) && !defined(ORBIS)
+#include "ScalarTypes.h"
+
+namespace ScalarMath
+{
+    void QuaternionToMatrix(const Float4& q, float out[3][3])
+    {
+        const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        const float xw = q.x * q.w, yw = q.y * q.w, zw = q.z * q.w;
+        out[0][0] = 1 - 2 * (yy + zz); out[0][1] = 2 * (xy - zw);     out[0][2] = 2 * (xz + yw);
+        out[1][0] = 2 * (xy + zw);     out[1][1] = 1 - 2 * (xx + zz); out[1][2] = 2 * (yz - xw);
+        out[2][0] = 2 * (xz - yw);     out[2][1] = 2 * (yz + xw);     out[2][2] = 1 - 2 * (xx + yy);
+    }
+
+    Float4 QuaternionFromRollPitchYaw(float pitch, float yaw, float roll)
+    {
+        const float sp = std::sin(pitch * 0.5f), cp = std::cos(pitch * 0.5f);
+        const float sy = std::sin(yaw * 0.5f), cy = std::cos(yaw * 0.5f);
+        const float sr = std::sin(roll * 0.5f), cr = std::cos(roll * 0.5f);
+        return Float4(sp * cy * cr + cp * sy * sr,
+                      cp * sy * cr - sp * cy * sr,
+                      cp * cy * sr - sp * sy * cr,
+                      cp * cy * cr + sp * sy * sr);
+    }
+
+    Float4 QuaternionFromAxisAngle(const Float3& axis, float angle)
+    {
+        const float length = std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+        const float scale = length > 0 ? std::sin(angle * 0.5f) / length : 0.0f;
+        return Float4(axis.x * scale, axis.y * scale, axis.z * scale, std::cos(angle * 0.5f));
+    }
+
+    Float4 QuaternionMultiply(const Float4& q1, const Float4& q2)
+    {
+        return Float4(q2.w * q1.x + q2.x * q1.w + q2.y * q1.z - q2.z * q1.y,
+                      q2.w * q1.y - q2.x * q1.z + q2.y * q1.w + q2.z * q1.x,
+                      q2.w * q1.z + q2.x * q1.y - q2.y * q1.x + q2.z * q1.w,
+                      q2.w * q1.w - q2.x * q1.x - q2.y * q1.y - q2.z * q1.z);
+    }
+
+    Float4x4 Inverse(const Float4x4& matrix, float* pDeterminant)
+    {
+        const float* m = &matrix.m[0][0];
+        float inv[16];
+        inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+        inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+        inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+        inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+        inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+        inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+        inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+        inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+        inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+        inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+        inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+        inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+        inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+        inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+        inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+        inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+        const float determinant = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+        if (pDeterminant) *pDeterminant = determinant;
+        const float scale = 1.0f / determinant;
+        Float4x4 result;
+        for (int i = 0; i < 16; ++i) (&result.m[0][0])[i] = inv[i] * scale;
+        return result;
+    }
+}
+#endif
@@ -0,0 +1,114 @@
+#pragma once
+#if !defined(WIN32) && !defined(ORBIS)
+#include "Engine/pch.h"
+
+// Storage of the scalar math types, laid out and named like the DirectXMath ones so code reading `.v.x` or `.m.m[r][c]`
+// compiles on every platform.
+struct Float2
+{
+    float x, y;
+
+    Float2() = default;
+    constexpr Float2(float x, float y) : x(x), y(y) {}
+};
+
+struct Float3
+{
+    float x, y, z;
+
+    Float3() = default;
+    constexpr Float3(float x, float y, float z) : x(x), y(y), z(z) {}
+};
+
+struct Float4
+{
+    float x, y, z, w;
+
+    Float4() = default;
+    constexpr Float4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+};
+
+struct Float3x3
+{
+    union
+    {
+        struct
+        {
+            float _11, _12, _13;
+            float _21, _22, _23;
+            float _31, _32, _33;
+        };
+        float m[3][3];
+    };
+
+    Float3x3() = default;
+    constexpr Float3x3(float m11, float m12, float m13,
+                       float m21, float m22, float m23,
+                       float m31, float m32, float m33)
+        : _11(m11), _12(m12), _13(m13),
+          _21(m21), _22(m22), _23(m23),
+          _31(m31), _32(m32), _33(m33) {}
+};
+
+struct Float3x4
+{
+    union
+    {
+        struct
+        {
+            float _11, _12, _13, _14;
+            float _21, _22, _23, _24;
+            float _31, _32, _33, _34;
+        };
+        float m[3][4];
+    };
+
+    Float3x4() = default;
+    constexpr Float3x4(float m11, float m12, float m13, float m14,
+                       float m21, float m22, float m23, float m24,
+                       float m31, float m32, float m33, float m34)
+        : _11(m11), _12(m12), _13(m13), _14(m14),
+          _21(m21), _22(m22), _23(m23), _24(m24),
+          _31(m31), _32(m32), _33(m33), _34(m34) {}
+};
+
+struct Float4x4
+{
+    union
+    {
+        struct
+        {
+            float _11, _12, _13, _14;
+            float _21, _22, _23, _24;
+            float _31, _32, _33, _34;
+            float _41, _42, _43, _44;
+        };
+        float m[4][4];
+    };
+
+    Float4x4() = default;
+    constexpr Float4x4(float m11, float m12, float m13, float m14,
+                       float m21, float m22, float m23, float m24,
+                       float m31, float m32, float m33, float m34,
+                       float m41, float m42, float m43, float m44)
+        : _11(m11), _12(m12), _13(m13), _14(m14),
+          _21(m21), _22(m22), _23(m23), _24(m24),
+          _31(m31), _32(m32), _33(m33), _34(m34),
+          _41(m41), _42(m42), _43(m43), _44(m44) {}
+};
+
+// Helpers shared by the scalar implementations. Matrices are stored like the PC ones: transformed points are column
+// vectors and the translation is the last column.
+namespace ScalarMath
+{
+    // rotation of the unit quaternion `q` as the rows of a column vector matrix
+    void QuaternionToMatrix(const Float4& q, float out[3][3]);
+    // pitch about x, yaw about y, roll about z, applied roll first like XMQuaternionRotationRollPitchYaw
+    Float4 QuaternionFromRollPitchYaw(float pitch, float yaw, float roll);
+    Float4 QuaternionFromAxisAngle(const Float3& axis, float angle);
+    // rotation by q1 followed by q2, like XMQuaternionMultiply
+    Float4 QuaternionMultiply(const Float4& q1, const Float4& q2);
+    // general inverse, not finite when the matrix is singular
+    Float4x4 Inverse(const Float4x4& matrix, float* pDeterminant = nullptr);
+}
+#endif
@@ -0,0 +1,146 @@
+#if !defined(WIN32) && !defined(ORBIS)
+#include "Vector2Scalar.h"
+
+const Vector2 kZeroVector2( 0.0f, 0.0f );
+
+float Vector2::Length(const Vector2& v)
+{
+    return std::sqrt(LengthSquared(v));
+}
+
+float Vector2::LengthSquared(const Vector2& v)
+{
+    return Dot(v, v);
+}
+
+float Vector2::Dot(const Vector2& v1, const Vector2& v2)
+{
+    return v1.v.x * v2.v.x + v1.v.y * v2.v.y;
+}
+
+float Vector2::Distance(const Vector2& v1, const Vector2& v2)
+{
+    return Length(v1 - v2);
+}
+
+void Vector2::Normalize(Vector2& v)
+{
+    const float length = Length(v);
+    v *= length > 0 ? 1.0f / length : 0.0f;
+}
+
+float Vector2::CrossProduct(const Vector2& v1, const Vector2& v2)
+{
+    return v1.v.x * v2.v.y - v1.v.y * v2.v.x;
+}
+
+
+float Vector2::Length() const
+{
+    return Length(*this);
+}
+
+float Vector2::LengthSquared() const
+{
+    return LengthSquared(*this);
+}
+
+float Vector2::Dot(const Vector2& rhs) const
+{
+    return Dot(*this, rhs);
+}
+
+Vector2 Vector2::Normalize() const
+{
+    Vector2 result = *this;
+    Normalize(result);
+    return result;
+}
+
+float Vector2::CrossProduct(const Vector2& rhs) const
+{
+    return CrossProduct(*this, rhs);
+}
+
+
+float Vector2::operator[](int index) const
+{
+    return index == 0 ? v.x : v.y;
+}
+
+Vector2 Vector2::operator*(float scalar) const
+{
+    return Vector2(v.x * scalar, v.y * scalar);
+}
+
+Vector2 Vector2::operator/(float scalar) const
+{
+    return *this * (1.0f / scalar);
+}
+
+Vector2 Vector2::operator+(const Vector2& rhs) const
+{
+    return Vector2(v.x + rhs.v.x, v.y + rhs.v.y);
+}
+
+Vector2 Vector2::operator-(const Vector2& rhs) const
+{
+    return Vector2(v.x - rhs.v.x, v.y - rhs.v.y);
+}
+
+
+Vector2& Vector2::operator+=(const Vector2& rhs)
+{
+    return *this = *this + rhs;
+}
+
+Vector2& Vector2::operator-=(const Vector2& rhs)
+{
+    return *this = *this - rhs;
+}
+
+
+Vector2& Vector2::operator*=(float scalar)
+{
+    return *this = *this * scalar;
+}
+
+Vector2& Vector2::operator/=(float scalar)
+{
+    return *this = *this / scalar;
+}
+
+bool Vector2::operator==(const Vector2& rhs) const
+{
+    return v.x == rhs.v.x && v.y == rhs.v.y;
+}
+
+bool Vector2::operator!=(const Vector2& rhs) const
+{
+    return !(*this == rhs);
+}
+
+rapidxml::xml_node<>* Vector2::serialize(rapidxml::xml_document<>* doc, rapidxml::xml_node<>* father, const TpString& value)
+{
+    auto mXmlNode = doc->allocate_node(rapidxml::node_element,"Vector2");
+    father->append_node(mXmlNode);
+
+    mXmlNode->value(doc->allocate_string(value.c_str()));
+    
+    mXmlNode->append_attribute(doc->allocate_attribute("x", doc->allocate_string(std::to_string(v.x).c_str())));
+    mXmlNode->append_attribute(doc->allocate_attribute("y", doc->allocate_string(std::to_string(v.y).c_str())));
+    return mXmlNode;
+}
+
+void Vector2::deSerialize(const rapidxml::xml_node<>* node)
+{
+    v.x = std::stof(node->first_attribute("x")->value());
+    v.y = std::stof(node->first_attribute("y")->value());
+}
+
+Vector2 Vector2::Abs(const Vector2& input)
+{
+    return Vector2{ std::abs(input.v.x), std::abs(input.v.y) };
+}
+
+#endif
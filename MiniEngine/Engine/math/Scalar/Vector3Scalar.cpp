@@ -0,0 +1,214 @@
+#if !defined(WIN32) && !defined(ORBIS)
+#include "Vector3Scalar.h"
+#include "Matrix4x4Scalar.h"
+#include "Engine/math/MathUtils.h"
+
+#include <cassert>
+#include <cfloat>
+
+
+const Vector3 kZeroVector3(0, 0, 0);
+
+float Vector3::Length(const Vector3& v)
+{
+    return std::sqrt(LengthSquared(v));
+}
+
+float Vector3::LengthSquared(const Vector3& v)
+{
+    return Dot(v, v);
+}
+
+float Vector3::Dot(const Vector3& v1, const Vector3& v2)
+{
+    return v1.v.x * v2.v.x + v1.v.y * v2.v.y + v1.v.z * v2.v.z;
+}
+
+float Vector3::Distance(const Vector3& v1, const Vector3& v2)
+{
+    return Length(v1 - v2);
+}
+
+float Vector3::Angle(const Vector3& v1, const Vector3& v2)
+{
+    float dot = Dot(v1.Normalize(), v2.Normalize());
+    //avoid zero direction
+    dot = std::max(-1.0f, std::min(1.0f, dot));
+    return acosf(dot);
+}
+
+Vector3 Vector3::InverseSafe(const Vector3& v)
+{
+    return Vector3{MathUtils::inverseSafe(v.v.x), MathUtils::inverseSafe(v.v.y), MathUtils::inverseSafe(v.v.z)};
+}
+
+Vector3 Vector3::Lerp(const Vector3& start, const Vector3& end, float t)
+{
+    if (t >= 1)
+    {
+        return end;
+    }
+    else if(t < 0)
+    {
+        return start;
+    }
+    return Vector3{
+        (1 - t) * start.v.x + t * end.v.x,
+        (1 - t) * start.v.y + t * end.v.y,
+        (1 - t) * start.v.z + t * end.v.z
+    };
+}
+
+Vector3 Vector3::Abs(const Vector3& input)
+{
+    return Vector3{ std::abs(input.v.x), std::abs(input.v.y), std::abs(input.v.z) };
+}
+
+void Vector3::Normalize(Vector3& v)
+{
+    const float length = Length(v);
+    v *= length > 0 ? 1.0f / length : 0.0f;
+}
+
+Vector3 Vector3::CrossProduct(const Vector3& v1, const Vector3& v2) {
+    return Vector3(v1.v.y * v2.v.z - v1.v.z * v2.v.y,
+                   v1.v.z * v2.v.x - v1.v.x * v2.v.z,
+                   v1.v.x * v2.v.y - v1.v.y * v2.v.x);
+}
+
+Vector3 Vector3::CrossProduct(const Vector3& rhs) const {
+    return CrossProduct(*this, rhs);
+}
+
+void Vector3::TransformSelfToScreen(const Matrix4x4& mat)
+{
+    // the point as a row vector, like XMVector4Transform on the stored matrix
+    const float vec[4] = { v.x, v.y, v.z, 1.0f };
+    float result[4];
+    for (int column = 0; column < 4; ++column)
+    {
+        result[column] = vec[0] * mat.m.m[0][column] + vec[1] * mat.m.m[1][column] + vec[2] * mat.m.m[2][column] + vec[3] * mat.m.m[3][column];
+    }
+    //perform perspective divide
+    if (result[3] < 0.001f)
+    {
+        // this point is behind the camera, return null
+        v.x = FLT_MAX;
+        v.y = FLT_MAX;
+        v.z = FLT_MAX;
+        return;
+    }
+    v = Float3(result[0] / result[3], result[1] / result[3], result[2] / result[3]);
+}
+
+float Vector3::Length() const
+{
+    return Length(*this);
+}
+
+float Vector3::LengthSquared() const
+{
+    return LengthSquared(*this);
+}
+
+float Vector3::Dot(const Vector3& rhs) const
+{
+    return Dot(*this, rhs);
+}
+
+void Vector3::Scale(const Vector3& rhs)
+{
+    v.x *= rhs.v.x;
+    v.y *= rhs.v.y;
+    v.z *= rhs.v.z;
+}
+
+Vector3 Vector3::Normalize() const
+{
+    Vector3 result = *this;
+    Normalize(result);
+    return result;
+}
+
+float Vector3::operator[](int index) const
+{
+    assert(index >= 0 && index < 3);
+    if (index == 0) return v.x;
+    if (index == 1) return v.y;
+    return v.z;
+}
+
+
+Vector3 Vector3::operator*(float scalar) const
+{
+    return Vector3(v.x * scalar, v.y * scalar, v.z * scalar);
+}
+
+Vector3 Vector3::operator/(float scalar) const
+{
+    return *this * (1.0f / scalar);
+}
+
+Vector3 Vector3::operator+(const Vector3& rhs) const
+{
+    return Vector3(v.x + rhs.v.x, v.y + rhs.v.y, v.z + rhs.v.z);
+}
+
+Vector3 Vector3::operator-(const Vector3& rhs) const
+{
+    return Vector3(v.x - rhs.v.x, v.y - rhs.v.y, v.z - rhs.v.z);
+}
+
+Vector3& Vector3::operator+=(const Vector3& rhs)
+{
+    return *this = *this + rhs;
+}
+
+Vector3& Vector3::operator-=(const Vector3& rhs)
+{
+    return *this = *this - rhs;
+}
+
+
+
+Vector3& Vector3::operator*=(float scalar)
+{
+    return *this = *this * scalar;
+}
+
+Vector3& Vector3::operator/=(float scalar)
+{
+    return *this = *this / scalar;
+}
+
+bool Vector3::operator==(const Vector3& rhs) const
+{
+    return v.x == rhs.v.x && v.y == rhs.v.y && v.z == rhs.v.z;
+}
+
+bool Vector3::operator!=(const Vector3& rhs) const
+{
+    return !(*this == rhs);
+}
+
+rapidxml::xml_node<>* Vector3::serialize(rapidxml::xml_document<>* doc, rapidxml::xml_node<>* father, const TpString& value)
+{
+    auto mXmlNode = doc->allocate_node(rapidxml::node_element, "Vector3");
+    father->append_node(mXmlNode);
+
+    mXmlNode->value(doc->allocate_string(value.c_str()));
+    
+    mXmlNode->append_attribute(doc->allocate_attribute("x", doc->allocate_string(std::to_string(v.x).c_str())));
+    mXmlNode->append_attribute(doc->allocate_attribute("y", doc->allocate_string(std::to_string(v.y).c_str())));
+    mXmlNode->append_attribute(doc->allocate_attribute("z", doc->allocate_string(std::to_string(v.z).c_str())));
+    return mXmlNode;
+}
+
+void Vector3::deSerialize(const rapidxml::xml_node<>* node)
+{
+    v.x = std::stof(node->first_attribute("x")->value());
+    v.y = std::stof(node->first_attribute("y")->value());
+    v.z = std::stof(node->first_attribute("z")->value());
+}
+
+#endif
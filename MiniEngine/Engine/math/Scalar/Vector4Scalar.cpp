@@ -0,0 +1,206 @@
+#if !defined(WIN32) && !defined(ORBIS)
+#include "Vector4Scalar.h"
+#include "Matrix4x4Scalar.h"
+#include "Engine/math/MathUtils.h"
+
+#include <cassert>
+#include <cfloat>
+
+float Vector4::Length(const Vector4& v)
+{
+    return std::sqrt(Dot(v, v));
+}
+
+// of x, y and z like the PC implementation
+float Vector4::LengthSquared(const Vector4& v)
+{
+    return v.v.x * v.v.x + v.v.y * v.v.y + v.v.z * v.v.z;
+}
+
+float Vector4::Dot(const Vector4& v1, const Vector4& v2)
+{
+    return v1.v.x * v2.v.x + v1.v.y * v2.v.y + v1.v.z * v2.v.z + v1.v.w * v2.v.w;
+}
+
+float Vector4::Distance(const Vector4& v1, const Vector4& v2)
+{
+    return Length(v1 - v2);
+}
+
+float Vector4::Angle(const Vector4& v1, const Vector4& v2)
+{
+    float dot = Dot(v1.Normalize(), v2.Normalize());
+    //avoid zero direction
+    dot = std::max(-1.0f, std::min(1.0f, dot));
+    return acosf(dot);
+}
+
+void Vector4::Normalize(Vector4& v)
+{
+    const float length = Length(v);
+    v *= length > 0 ? 1.0f / length : 0.0f;
+}
+
+Vector4 Vector4::CrossProduct(const Vector4& v1, const Vector4& v2, const Vector4& v3)
+{
+    const Float4& a = v1.v;
+    const Float4& b = v2.v;
+    const Float4& c = v3.v;
+    return Vector4(
+        (b.z * c.w - b.w * c.z) * a.y - (b.y * c.w - b.w * c.y) * a.z + (b.y * c.z - b.z * c.y) * a.w,
+        (b.w * c.z - b.z * c.w) * a.x - (b.w * c.x - b.x * c.w) * a.z + (b.z * c.x - b.x * c.z) * a.w,
+        (b.y * c.w - b.w * c.y) * a.x - (b.x * c.w - b.w * c.x) * a.y + (b.x * c.y - b.y * c.x) * a.w,
+        (b.z * c.y - b.y * c.z) * a.x - (b.z * c.x - b.x * c.z) * a.y + (b.y * c.x - b.x * c.y) * a.z);
+}
+
+Vector4 Vector4::InverseSafe(const Vector4& v)
+{
+    return Vector4{MathUtils::inverseSafe(v.v.x), MathUtils::inverseSafe(v.v.y), MathUtils::inverseSafe(v.v.z), MathUtils::inverseSafe(v.v.w)};
+}
+
+Vector4 Vector4::Lerp(const Vector4& start, const Vector4& end, float t)
+{
+    return start + (end - start) * t;
+}
+
+Vector4 Vector4::Abs(const Vector4& input)
+{
+    return Vector4{ std::abs(input.v.x), std::abs(input.v.y), std::abs(input.v.z), std::abs(input.v.w)};
+}
+
+float Vector4::Length() const
+{
+    return Length(*this);
+}
+
+float Vector4::LengthSquared() const
+{
+    return LengthSquared(*this);
+}
+
+float Vector4::Dot(const Vector4& rhs) const
+{
+    return Dot(*this, rhs);
+}
+
+void Vector4::Scale(const Vector4& rhs)
+{
+    v.x *= rhs.v.x;
+    v.y *= rhs.v.y;
+    v.z *= rhs.v.z;
+    v.w *= rhs.v.w;
+}
+
+Vector4 Vector4::Normalize() const
+{
+    Vector4 result = *this;
+    Normalize(result);
+    return result;
+}
+
+Vector4 Vector4::CrossProduct(const Vector4& rhs, const Vector4 rlhs) const
+{
+    return CrossProduct(*this, rhs, rlhs);
+}
+
+void Vector4::TransformSelfToScreen(const Matrix4x4& mat)
+{
+    // the point as a row vector, like XMVector4Transform on the stored matrix
+    const float vec[4] = { v.x, v.y, v.z, v.w };
+    float result[4];
+    for (int column = 0; column < 4; ++column)
+    {
+        result[column] = vec[0] * mat.m.m[0][column] + vec[1] * mat.m.m[1][column] + vec[2] * mat.m.m[2][column] + vec[3] * mat.m.m[3][column];
+    }
+    if (result[3] < 0.001f)
+    {
+        v.x = FLT_MAX;
+        v.y = FLT_MAX;
+        v.z = FLT_MAX;
+        v.w = FLT_MAX;
+        return;
+    }
+    v = Float4(result[0] / result[3], result[1] / result[3], result[2] / result[3], 1.0f);
+}
+
+float Vector4::operator[](int index) const
+{
+    assert(index >= 0 && index < 4);
+    if (index == 0) return v.x;
+    if (index == 1) return v.y;
+    if (index == 2) return v.z;
+    return v.w;
+}
+
+Vector4 Vector4::operator*(float scalar) const
+{
+    return Vector4(v.x * scalar, v.y * scalar, v.z * scalar, v.w * scalar);
+}
+
+Vector4 Vector4::operator/(float scalar) const
+{
+    return *this * (1.0f / scalar);
+}
+
+Vector4 Vector4::operator+(const Vector4& rhs) const
+{
+    return Vector4(v.x + rhs.v.x, v.y + rhs.v.y, v.z + rhs.v.z, v.w + rhs.v.w);
+}
+
+Vector4 Vector4::operator-(const Vector4& rhs) const
+{
+    return Vector4(v.x - rhs.v.x, v.y - rhs.v.y, v.z - rhs.v.z, v.w - rhs.v.w);
+}
+
+Vector4& Vector4::operator+=(const Vector4& rhs)
+{
+    return *this = *this + rhs;
+}
+
+Vector4& Vector4::operator-=(const Vector4& rhs)
+{
+    return *this = *this - rhs;
+}
+
+Vector4& Vector4::operator*=(float scalar)
+{
+    return *this = *this * scalar;
+}
+
+Vector4& Vector4::operator/=(float scalar)
+{
+    return *this = *this / scalar;
+}
+
+// of x, y and z like the PC implementation
+bool Vector4::operator==(const Vector4& rhs) const
+{
+    return v.x == rhs.v.x && v.y == rhs.v.y && v.z == rhs.v.z;
+}
+
+bool Vector4::operator!=(const Vector4& rhs) const
+{
+    return !(*this == rhs);
+}
+
+rapidxml::xml_node<>* Vector4::serialize(rapidxml::xml_document<>* doc, rapidxml::xml_node<>* father,
+    const TpString& value)
+{
+    auto mXmlNode = doc->allocate_node(rapidxml::node_element, "Vector4");
+    father->append_node(mXmlNode);
+    mXmlNode->value(doc->allocate_string(value.c_str()));
+    mXmlNode->append_attribute(doc->allocate_attribute("x", doc->allocate_string(std::to_string(v.x).c_str())));
+    mXmlNode->append_attribute(doc->allocate_attribute("y", doc->allocate_string(std::to_string(v.y).c_str())));
+    mXmlNode->append_attribute(doc->allocate_attribute("z", doc->allocate_string(std::to_string(v.z).c_str())));
+    mXmlNode->append_attribute(doc->allocate_attribute("w", doc->allocate_string(std::to_string(v.w).c_str())));
+    return mXmlNode;
+}
+
+void Vector4::deSerialize(const rapidxml::xml_node<>* node)
+{
+    v.x = std::stof(node->first_attribute("x")->value());
+    v.y = std::stof(node->first_attribute("y")->value());
+    v.z = std::stof(node->first_attribute("z")->value());
+    v.w = std::stof(node->first_attribute("w")->value());
+}
+#endif
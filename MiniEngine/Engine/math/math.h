@@ -10,7 +10,7 @@
 #include "PC/QuaternionPC.h"
 #include "PC/EulerAnglesPC.h"
 #include "PC/RotationMatrixPC.h"
-#else
+#elif defined(ORBIS)
 #include "PS/Vector2PS.h"
 #include "PS/Vector3PS.h"
 #include "PS/Vector4PS.h"
@@ -19,6 +19,15 @@
 #include "PS/QuaternionPS.h"
 #include "PS/EulerAnglesPS.h"
 #include "PS/RotationMatrixPS.h"
+#else
+#include "Scalar/Vector2Scalar.h"
+#include "Scalar/Vector3Scalar.h"
+#include "Scalar/Vector4Scalar.h"
+#include "Scalar/Matrix4x4Scalar.h"
+#include "Scalar/Matrix3x4Scalar.h"
+#include "Scalar/QuaternionScalar.h"
+#include "Scalar/EulerAnglesScalar.h"
+#include "Scalar/RotationMatrixScalar.h"
 #endif
 
 // union Float2 final
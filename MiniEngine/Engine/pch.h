@@ -15,11 +15,16 @@
 #include <string>
 #include <array>
 #include <mutex>
+#include <atomic>
 #include <vector>
 #include <shared_mutex>
 #include <iostream>
 #include <thread>
 #include <exception>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <cstdio>
 
 #ifdef WIN32
 #ifndef _WIN32_WINNT
@@ -67,22 +72,40 @@ using namespace Microsoft::WRL;
 
 #define MEM_VIRTUAL_ALLOC(size) VirtualAlloc(nullptr, (size), MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE)
 #define MEM_VIRTUAL_FREE(mem) VirtualFree((mem), 0, MEM_RELEASE)
+// reserve address space only, pages must be committed before access.
+#define MEM_VIRTUAL_RESERVE(size) VirtualAlloc(nullptr, (size), MEM_RESERVE, PAGE_NOACCESS)
+#define MEM_VIRTUAL_COMMIT(mem, size) (VirtualAlloc((mem), (size), MEM_COMMIT, PAGE_READWRITE) != nullptr)
+#define MEM_VIRTUAL_DECOMMIT(mem, size) VirtualFree((mem), (size), MEM_DECOMMIT)
+#define MEM_VIRTUAL_RELEASE(mem, size) VirtualFree((mem), 0, MEM_RELEASE)
+// granularity of commits and protection changes.
+#define MEM_VIRTUAL_PAGE_SIZE() []() -> uint64_t { SYSTEM_INFO info; GetSystemInfo(&info); return info.dwPageSize; }()
 
 #if __cplusplus >= 202002L  // check cpp20
 template<typename T>
 concept Numeric = std::is_arithmetic_v<T>;
 #endif
 #else
+#include <sys/mman.h>
+#include <unistd.h>
 #define MEM_VIRTUAL_ALLOC(mSize) malloc((mSize))
 #define MEM_VIRTUAL_FREE(mem) free((mem))
+// reserve address space only, pages must be committed before access.
+#define MEM_VIRTUAL_RESERVE(size) [](size_t reserveSize) -> void* { void* p = mmap(nullptr, reserveSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0); return p == MAP_FAILED ? nullptr : p; }((size))
+#define MEM_VIRTUAL_COMMIT(mem, size) (mprotect((mem), (size), PROT_READ | PROT_WRITE) == 0)
+#define MEM_VIRTUAL_DECOMMIT(mem, size) (madvise((mem), (size), MADV_DONTNEED), mprotect((mem), (size), PROT_NONE))
+#define MEM_VIRTUAL_RELEASE(mem, size) munmap((mem), (size))
+// granularity of commits and protection changes.
+#define MEM_VIRTUAL_PAGE_SIZE() static_cast<uint64_t>(sysconf(_SC_PAGESIZE))
 #endif
 #ifdef ORBIS
 #include <vectormath.h>
+#endif 
+#ifndef WIN32
 using byte = uint8_t;
 #define  MAXUINT64 0xffffffffffffffff
 #define  MAXUINT32 0xffffffff
 #define  MAXUINT16 0xffff
-#endif 
+#endif
 
 
 // -----------------------------------Definition----------------------------------------- //
@@ -93,7 +116,12 @@ using byte = uint8_t;
 #define __FILEW__ WIDEN(__FILE__)
 #endif
 #ifndef __FUNCTIONW__
+#ifdef _MSC_VER
 #define __FUNCTIONW__ WIDEN(__FUNCTION__)
+#else
+// __FUNCTION__ is not a macro on gcc and clang, it can not be widened
+#define __FUNCTIONW__ L""
+#endif
 #endif
 
 #define DELETE_MOVE_CONSTRUCTOR(name) name(name&& other) noexcept = delete;
@@ -124,8 +152,7 @@ using String = std::wstring;
 using Char = wchar_t;
 #ifdef WIN32
 #define WARN(message) std::wcout << TEXT("[ WARN | ") << __REFLECTION_FILE_NAME__ << " | " << __REFLECTION_FUNC_NAME__ << " ]" << TEXT(##message);
-#endif
-#ifdef ORBIS
+#else
 #define WARN(message) void(0);
 #endif
 #else
@@ -82,6 +82,7 @@ void EnemyController::update()
         mEnemyState = EnemyState::ES_DEAD;
         mBodyMeshFilter->setMesh("TankBodyDestroy");
         mBodyMeshRenderer->setTexture("TankTexDestroy");
+        mBodyMeshRenderer->setDepthPrePass(true);
         mBatteryMeshFilter->setMesh("TankBatteryDestroy");
         mBatteryMeshRenderer->setTexture("TankTexDestroy");
         DelayDestruction* delay = dynamic_cast<DelayDestruction*>(mGameObject->addComponent("DelayDestruction"));
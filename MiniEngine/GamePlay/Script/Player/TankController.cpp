@@ -99,6 +99,8 @@ void TankController::setAndChangeTankModel()
             {
                 mBodyMeshFilter->setMesh("AMBT_BODY");
                 mBodyMeshRenderer->setTexture("AMBT_BODY");
+                //the heavy hull hides most of what is behind it
+                mBodyMeshRenderer->setDepthPrePass(true);
                 mBodyMeshRenderer->setBlendFactor(0);
 
                 mBatteryMeshFilter->setMesh("AMBT_TURRET");
@@ -0,0 +1,125 @@
+// The frame ring over a fake descriptor heap: ranges never wrap, frames are reclaimed behind a fake fence, full rings
+// wait for the oldest frame and the per thread caches hand out disjoint ranges.
+#include "Engine/Render/FrameRingAllocator.h"
+#include "Engine/Render/RHIObject.h"
+#include "TestCommon.h"
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // the gpu finishes a frame when the fence is signaled, or when the cpu waits for it
+    class FakeFence : public RHIFence
+    {
+    public:
+        uint64_t GetValue() const override { return mValue; }
+        void Wait(uint64_t value) const override
+        {
+            ++mNumWaits;
+            mValue = std::max(mValue, value);
+        }
+        void Signal(uint64_t value) { mValue = value; }
+        uint32_t GetNumWaits() const { return mNumWaits; }
+
+    private:
+        mutable uint64_t mValue = 0;
+        mutable uint32_t mNumWaits = 0;
+    };
+
+    void TestFrames()
+    {
+        constexpr uint64_t RING = 64;
+        FrameRingAllocator ring;
+        ring.Initialize(RING);
+        FakeFence fence;
+
+        CHECK(ring.Allocate(40) == 0);
+        // does not fit before the end of the ring and the start is in use
+        CHECK(ring.Allocate(30) == FrameRingAllocator::INVALID_OFFSET);
+        ring.EndFrame(&fence, 1);
+        CHECK(ring.Reclaim() == 0);
+
+        fence.Signal(1);
+        CHECK(ring.Reclaim() == 40);
+        // the rest of the ring is skipped, it is reclaimed with the current frame
+        CHECK(ring.Allocate(30) == 0);
+        CHECK(ring.Allocate(10) == 30);
+        CHECK(ring.GetUsedSize() == RING);
+        CHECK(ring.Allocate(1) == FrameRingAllocator::INVALID_OFFSET);
+
+        // a full ring waits for the oldest frame in flight
+        ring.EndFrame(&fence, 2);
+        CHECK(ring.AllocateOrWait(8) == 40);
+        CHECK(ring.GetNumStalls() == 1 && fence.GetNumWaits() == 1 && fence.GetValue() == 2);
+        // unless the current frame alone fills it
+        CHECK(ring.AllocateOrWait(RING) == FrameRingAllocator::INVALID_OFFSET);
+
+        // a range of the whole ring fits once it is empty, wherever the head is
+        ring.EndFrame(&fence, 3);
+        fence.Signal(3);
+        CHECK(ring.Reclaim() == 8 && ring.GetUsedSize() == 0);
+        CHECK(ring.Allocate(RING) == 0);
+    }
+
+    void TestCaches()
+    {
+        constexpr uint32_t THREADS = 4;
+        constexpr uint32_t TABLES = 1000;
+        constexpr uint32_t TABLE_SIZE = 7;
+        constexpr uint32_t BATCH_SIZE = 128;
+        constexpr uint64_t RING = 32768;
+        FrameRingAllocator ring;
+        ring.Initialize(RING);
+        FakeFence fence;
+
+        // the owner of every descriptor of the heap
+        std::vector<std::atomic<uint32_t>> heap(RING);
+        std::vector<FrameRingCache> caches(THREADS);
+        std::atomic<uint32_t> numOverlaps{ 0 };
+        std::atomic<uint32_t> numFailures{ 0 };
+        for (uint32_t frame = 0; frame < 2; ++frame)
+        {
+            for (std::atomic<uint32_t>& owner : heap) owner = 0;
+            std::vector<std::thread> threads;
+            for (uint32_t t = 0; t < THREADS; ++t)
+            {
+                threads.emplace_back([&, t]()
+                {
+                    FrameRingCache& cache = caches[t];
+                    if (frame == 0) cache.Initialize(&ring, BATCH_SIZE);
+                    cache.Reset();
+                    for (uint32_t i = 0; i < TABLES; ++i)
+                    {
+                        const uint64_t offset = cache.Allocate(TABLE_SIZE);
+                        if (offset == FrameRingAllocator::INVALID_OFFSET || offset + TABLE_SIZE > RING)
+                        {
+                            ++numFailures;
+                            continue;
+                        }
+                        for (uint64_t d = offset; d < offset + TABLE_SIZE; ++d)
+                        {
+                            if (heap[d].exchange(t + 1) != 0) ++numOverlaps;
+                        }
+                    }
+                });
+            }
+            for (std::thread& thread : threads) thread.join();
+            ring.EndFrame(&fence, frame + 1);
+            fence.Signal(frame + 1);
+            CHECK(ring.Reclaim() > 0);
+        }
+        CHECK(numFailures == 0);
+        CHECK(numOverlaps == 0);
+        // a batch holds 18 tables, every thread refills 56 times per frame
+        for (const FrameRingCache& cache : caches) CHECK(cache.GetNumRefills() == 2 * ((TABLES + 17) / 18));
+        CHECK(ring.GetNumStalls() == 0 && ring.GetUsedSize() == 0);
+    }
+}
+
+int main()
+{
+    TestFrames();
+    TestCaches();
+    return TEST_RESULT();
+}
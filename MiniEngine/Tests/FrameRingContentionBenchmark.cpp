@@ -0,0 +1,85 @@
+// Contention of transient descriptor allocation: every thread allocates descriptor tables from one shared ring through
+// a mutex guarded UnsafeRingAllocator, the atomic head of FrameRingAllocator, or a FrameRingCache of its own.
+// FrameRingContentionBenchmark [max threads] [tables per thread]
+#include "Engine/Memory/RingAllocator.h"
+#include "Engine/Render/FrameRingAllocator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t TABLE_SIZE = 7;
+    constexpr uint32_t BATCH_SIZE = 128;
+    constexpr uint32_t RUNS = 5;
+
+    // best of RUNS, every run starts all threads on an empty ring
+    template <typename TSetup, typename TAllocate>
+    double Measure(uint32_t numThreads, uint32_t numTables, TSetup&& setup, TAllocate&& allocate)
+    {
+        double best = 1e30;
+        for (uint32_t run = 0; run < RUNS; ++run)
+        {
+            setup();
+            std::vector<std::thread> threads;
+            const auto start = std::chrono::steady_clock::now();
+            for (uint32_t t = 0; t < numThreads; ++t)
+            {
+                threads.emplace_back([&, t]()
+                {
+                    uint64_t checksum = 0;
+                    for (uint32_t i = 0; i < numTables; ++i) checksum += allocate(t);
+                    if (checksum == ~0ull) std::printf("unreachable\n");
+                });
+            }
+            for (std::thread& thread : threads) thread.join();
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t maxThreads = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 8;
+    const uint32_t numTables = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 200000;
+    // large enough for every run, offsets only, the ring owns no memory
+    const uint64_t ringSize = static_cast<uint64_t>(maxThreads) * numTables * TABLE_SIZE * 2;
+
+    std::printf("%u descriptor tables of %u per thread, %u hardware threads, best of %u runs\n", numTables, TABLE_SIZE,
+                std::thread::hardware_concurrency(), RUNS);
+    for (uint32_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+    {
+        std::mutex mutex;
+        UnsafeRingAllocator lockedRing;
+        const double locked = Measure(numThreads, numTables, [&]() { lockedRing.Initialize(ringSize); }, [&](uint32_t)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return lockedRing.Allocate(TABLE_SIZE);
+        });
+
+        FrameRingAllocator ring;
+        const double atomic = Measure(numThreads, numTables, [&]() { ring.Initialize(ringSize); }, [&](uint32_t)
+        {
+            return ring.Allocate(TABLE_SIZE);
+        });
+
+        std::vector<FrameRingCache> caches(numThreads);
+        const double cached = Measure(numThreads, numTables, [&]()
+        {
+            ring.Initialize(ringSize);
+            for (FrameRingCache& cache : caches) cache.Initialize(&ring, BATCH_SIZE);
+        }, [&](uint32_t t)
+        {
+            return caches[t].Allocate(TABLE_SIZE);
+        });
+
+        std::printf("%u threads: mutex %.1f ms, atomic ring %.1f ms, cache %.1f ms\n", numThreads, locked, atomic, cached);
+    }
+    return 0;
+}
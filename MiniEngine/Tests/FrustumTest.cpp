@@ -0,0 +1,102 @@
+// Frustum planes from a camera built with the engine math, the single box tests and the batched culling loop.
+#include "Engine/Render/Frustum.h"
+#include "TestCommon.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    BoundingBox MakeBox(float x, float y, float z, float extent)
+    {
+        BoundingBox box;
+        box.mCenter[0] = x;
+        box.mCenter[1] = y;
+        box.mCenter[2] = z;
+        box.mExtents[0] = box.mExtents[1] = box.mExtents[2] = extent;
+        return box;
+    }
+
+    // camera at the origin looking down +z, 90 degrees vertical field of view, depth from 1 to 100
+    Frustum MakeFrustum()
+    {
+        Matrix4x4 view;
+        view.lookAt(Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 0.0f, 1.0f), Vector3(0.0f, 1.0f, 0.0f));
+        Matrix4x4 projection;
+        projection.setPerspectiveProjection(MathUtils::kPiOver2, 1.0f, 1.0f, 100.0f);
+        return Frustum::FromViewProjection(projection * view);
+    }
+
+    void TestBoxes()
+    {
+        Frustum frustum = MakeFrustum();
+        CHECK(frustum.Classify(MakeBox(0.0f, 0.0f, 10.0f, 1.0f)) == FrustumTest::INSIDE);
+        // straddling the near and the right plane
+        CHECK(frustum.Classify(MakeBox(0.0f, 0.0f, 1.0f, 0.5f)) == FrustumTest::INTERSECTS);
+        CHECK(frustum.Classify(MakeBox(10.0f, 0.0f, 10.0f, 0.5f)) == FrustumTest::INTERSECTS);
+        // behind the camera, beyond the far plane and left of the left plane
+        CHECK(frustum.Classify(MakeBox(0.0f, 0.0f, -5.0f, 1.0f)) == FrustumTest::OUTSIDE);
+        CHECK(frustum.Classify(MakeBox(0.0f, 0.0f, 110.0f, 1.0f)) == FrustumTest::OUTSIDE);
+        CHECK(frustum.Classify(MakeBox(-20.0f, 0.0f, 10.0f, 1.0f)) == FrustumTest::OUTSIDE);
+        CHECK(!frustum.Intersects(BoundingBox()));
+    }
+
+    void TestBoundingBox()
+    {
+        // a unit box rotated 90 degrees about y and moved keeps its size
+        Matrix4x4 model;
+        model.setModelMatrix(Vector3(5.0f, 0.0f, 0.0f), Vector3(0.0f, MathUtils::kPiOver2, 0.0f), Vector3(1.0f, 2.0f, 1.0f));
+        BoundingBox box = MakeBox(1.0f, 0.0f, 0.0f, 1.0f).Transform(model);
+        CHECK_NEAR(box.mCenter[0], 5.0f, 1e-5f);
+        CHECK_NEAR(box.mCenter[2], -1.0f, 1e-5f);
+        CHECK_NEAR(box.mExtents[1], 2.0f, 1e-5f);
+
+        BoundingBox merged;
+        merged.Merge(MakeBox(0.0f, 0.0f, 0.0f, 1.0f));
+        merged.Merge(MakeBox(4.0f, 0.0f, 0.0f, 1.0f));
+        CHECK_NEAR(merged.mCenter[0], 2.0f, 1e-6f);
+        CHECK_NEAR(merged.mExtents[0], 3.0f, 1e-6f);
+    }
+
+    // the batched loop agrees with Intersects, also after a Clear shrinks the batch
+    void TestBatch()
+    {
+        Frustum frustum = MakeFrustum();
+        std::mt19937 random(7);
+        std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+        std::uniform_real_distribution<float> extent(0.1f, 5.0f);
+
+        CullingBatch batch;
+        for (uint32_t numBoxes : {1027u, 13u, 0u, 6u})
+        {
+            batch.Clear();
+            std::vector<BoundingBox> boxes;
+            for (uint32_t i = 0; i < numBoxes; ++i)
+            {
+                boxes.push_back(MakeBox(position(random), position(random), position(random) + 40.0f, extent(random)));
+                CHECK(batch.Add(boxes.back()) == i);
+            }
+            CHECK(batch.Size() == numBoxes);
+
+            std::vector<uint8_t> visible(numBoxes + 4, 2);
+            uint32_t numVisible = frustum.Cull(batch, visible.data());
+            uint32_t expected = 0;
+            for (uint32_t i = 0; i < numBoxes; ++i)
+            {
+                CHECK(visible[i] == frustum.Intersects(boxes[i]));
+                expected += frustum.Intersects(boxes[i]);
+            }
+            CHECK(numVisible == expected);
+            // nothing is written past the batch
+            CHECK(visible[numBoxes] == 2);
+        }
+    }
+}
+
+int main()
+{
+    TestBoxes();
+    TestBoundingBox();
+    TestBatch();
+    return TEST_RESULT();
+}
@@ -0,0 +1,82 @@
+// Cpu cost of recording frames through the null rhi, one constant buffer upload and draw per object.
+// HeadlessBenchmark [draws per frame] [frames]
+#include "Engine/Render/Null/NullRHI.h"
+#include "Engine/Render/Shader.h"
+#include "Engine/Render/Blob.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    const uint32_t drawsPerFrame = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 5000;
+    const uint32_t frames = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 100;
+    // a few materials so the pipeline state changes between batches
+    constexpr uint32_t MATERIALS = 8;
+
+    NullRHI rhi;
+    rhi.Initialize();
+
+    const char* source = "cbuffer ObjectConstants : register(b1) { float4x4 m_model; float4x4 m_model_i; float4x4 m_view; float4x4 m_view_i; float4x4 m_projection; float4x4 m_projection_i; };\n";
+    Blob blob{source, strlen(source)};
+    auto shader = rhi.RHICompileShader(blob, static_cast<ShaderType>(ShaderType::VERTEX | ShaderType::PIXEL));
+    PipelineInitializer pipelines[MATERIALS];
+    for (uint32_t i = 0; i < MATERIALS; ++i)
+    {
+        pipelines[i] = PipelineInitializer::Default();
+        pipelines[i].SetShader(shader.get());
+        pipelines[i].SetCullMode(static_cast<CullMode>(i % 3));
+        pipelines[i].SetDepthBias(static_cast<DepthBiasSet>(i / 3));
+    }
+
+    RHISwapChainDesc swapChainDesc{0, 0, 0, 1, 2, Format::R8G8B8A8_UNORM, false};
+    auto swapChain = rhi.RHICreateSwapChain(swapChainDesc);
+    auto vertexBuffer = rhi.RHIAllocVertexBuffer(32, 24);
+    auto indexBuffer = rhi.RHIAllocIndexBuffer(36, Format::R16_UINT);
+    RHIGraphicsContext* context;
+    rhi.RHICreateGraphicsContext(&context);
+    auto fence = rhi.RHICreateFence();
+    std::vector<uint8_t> objectConstants(384, 0);
+
+    std::vector<double> frameMilliseconds;
+    frameMilliseconds.reserve(frames);
+    for (uint32_t frame = 0; frame < frames; ++frame)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fence->Wait(frame);
+        rhi.RHIResetGraphicsContext(context);
+        swapChain->BeginFrame(context);
+        RHIVertexBuffer* vertexBuffers[] = {vertexBuffer.get()};
+        context->SetVertexBuffers(vertexBuffers, 1);
+        context->SetIndexBuffer(indexBuffer.get());
+        for (uint32_t draw = 0; draw < drawsPerFrame; ++draw)
+        {
+            context->SetPipelineState(pipelines[draw * MATERIALS / drawsPerFrame]);
+            auto constants = context->AllocConstantBuffer(objectConstants.size());
+            rhi.RHIUpdateConstantBuffer(constants.get(), objectConstants.data(), 0, objectConstants.size());
+            context->SetConstantBuffer(1, constants.get());
+            context->DrawIndexedInstanced(36, 0, 0, 1, 0);
+        }
+        swapChain->EndFrame(context);
+        rhi.RHISubmitRenderCommands(context);
+        rhi.RHISyncGraphicContext(fence.get(), frame + 1);
+        swapChain->Present();
+        frameMilliseconds.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::sort(frameMilliseconds.begin(), frameMilliseconds.end());
+    const NullFrameStats& stats = rhi.GetLastFrameStats();
+    std::printf("%u draws x %u frames: median %.3f ms, p95 %.3f ms\n", drawsPerFrame, frames,
+                frameMilliseconds[frames / 2], frameMilliseconds[frames * 95 / 100]);
+    std::printf("draws %u, pso binds %u, pso changes %u, descriptor updates %u, commands %u, bytes uploaded %llu\n",
+                stats.mDrawCalls, stats.mPipelineStateBinds, stats.mPipelineStateChanges, stats.mDescriptorUpdates,
+                stats.mCommands, static_cast<unsigned long long>(stats.mBytesUploaded));
+
+    rhi.RHIReleaseGraphicsContext(context);
+    rhi.Release();
+    return 0;
+}
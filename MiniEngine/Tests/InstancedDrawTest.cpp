@@ -0,0 +1,188 @@
+// Instanced draws of the forward recorder on the null rhi: identical items share one draw per sub-mesh for every
+// 256 instances, the instance buffer holds their transforms and colors in order, and a different mesh or texture
+// starts a new draw while another instance of the same material joins it.
+#include "Engine/Render/ForwardRecorder.h"
+#include "Engine/Render/Null/NullRHI.h"
+#include "Engine/Render/Blob.h"
+#include "TestCommon.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    constexpr uint8_t INSTANCE_BUFFER_SLOT = 3;
+
+    struct Fixture
+    {
+        NullRHI mRHI;
+        std::unique_ptr<RHIShader> mShader;
+        Material mInstanced;
+        Material mSingle;
+        std::unique_ptr<RHINativeTexture> mTextures[2];
+        std::unique_ptr<RHIVertexBuffer> mVertexBuffers[2];
+        std::unique_ptr<RHIIndexBuffer> mIndexBuffer;
+        ObjectConstantPool mObjectConstants;
+        MaterialConstantPool mMaterialConstants;
+        ForwardRecorder mRecorder;
+        VirtualLinearAllocator mArena;
+
+        Fixture()
+        {
+            mRHI.Initialize();
+            mRHI.SetRecordCommands(true);
+            const char* source = "Texture2D<float4> gAlbedo : register(t0);\n";
+            mShader = mRHI.RHICompileShader(Blob{ source, strlen(source) }, static_cast<ShaderType>(ShaderType::VERTEX | ShaderType::PIXEL));
+            for (Material* pMaterial : { &mInstanced, &mSingle })
+            {
+                pMaterial->mShader = mShader.get();
+                pMaterial->mNumTextures = 1;
+                pMaterial->mTextures.reset(new TextureProperty[1]{ TextureProperty(TEXT("gAlbedo"), 0, TextureDimension::TEXTURE2D) });
+            }
+            mInstanced.mInstanceBufferSlot = INSTANCE_BUFFER_SLOT;
+            for (auto& texture : mTextures) texture = mRHI.RHIAllocTexture({ Format::R8G8B8A8_UNORM, TextureDimension::TEXTURE2D, 4, 4, 1, 1, 1, 0 });
+            for (auto& vertexBuffer : mVertexBuffers) vertexBuffer = mRHI.RHIAllocVertexBuffer(32, 24);
+            mIndexBuffer = mRHI.RHIAllocIndexBuffer(36, Format::R16_UINT);
+            mObjectConstants.Initialize(&mRHI, 16);
+            mMaterialConstants.Initialize(&mRHI, 16);
+            mRecorder.Initialize(&mRHI, &mObjectConstants, &mMaterialConstants);
+            mArena.Initialize(16ull * 1024 * 1024, 64ull * 1024);
+        }
+
+        ~Fixture()
+        {
+            mArena.Release();
+            mRHI.Release();
+        }
+
+        std::unique_ptr<MaterialInstance> CreateInstance(const Material& material, uint32_t texture)
+        {
+            std::unique_ptr<MaterialInstance> instance(new MaterialInstance());
+            instance->InstantiateFrom(&material);
+            instance->SetTexture(0, TextureRef(texture, mTextures[texture].get()));
+            return instance;
+        }
+
+        // two sub-meshes of the cube, the item is at x = `position`
+        RenderItem CreateItem(MaterialInstance* pMaterial, uint32_t mesh, float position)
+        {
+            const SubMesh subMeshes[] = { { 18, 0, 0 }, { 18, 18, 0 } };
+            RenderItem item;
+            item.mMeshData = MeshData(VertexBufferRef(mesh, mVertexBuffers[mesh].get()), IndexBufferRef(0, mIndexBuffer.get()), 24, 36, subMeshes, 2);
+            item.mMaterial = pMaterial;
+            item.mModel.m.m[0][3] = position;
+            item.mColor = { position, 0, 0, 1 };
+            return item;
+        }
+
+        // records the items in list order, the commands stay readable until the next frame
+        void RecordFrame(const std::vector<RenderItem>& items)
+        {
+            std::vector<SortedRenderItem> order;
+            for (uint32_t i = 0; i < items.size(); ++i) order.push_back({ 0, i });
+            CameraConstants cameraConstants{ Matrix4x4::Identity, Matrix4x4::Identity, Matrix4x4::Identity, Matrix4x4::Identity };
+            if (!mContext) mRHI.RHICreateGraphicsContext(&mContext);
+            mRHI.RHIResetGraphicsContext(mContext);
+            mArena.Reset();
+            mRecorder.Record(mContext, mArena, PipelineInitializer::Default(), items, order.data(), order.data() + order.size(), cameraConstants);
+            mRHI.RHISubmitRenderCommands(mContext);
+            mRHI.EndFrame();
+        }
+
+        std::vector<NullCommand> Commands(NullCommandType type) const
+        {
+            std::vector<NullCommand> commands;
+            for (const NullCommand& command : mRHI.GetLastCommandStream())
+            {
+                if (command.mType == type) commands.push_back(command);
+            }
+            return commands;
+        }
+
+        RHIGraphicsContext* mContext = nullptr;
+    };
+
+    void TestGroups()
+    {
+        constexpr uint32_t ITEMS = 600;
+        Fixture fixture;
+        auto instanced = fixture.CreateInstance(fixture.mInstanced, 0);
+        auto single = fixture.CreateInstance(fixture.mSingle, 0);
+        std::vector<RenderItem> items;
+        for (uint32_t i = 0; i < ITEMS; ++i) items.push_back(fixture.CreateItem(instanced.get(), 0, static_cast<float>(i)));
+
+        // ceil(600 / 256) draws per sub-mesh
+        fixture.RecordFrame(items);
+        const uint32_t numGroups = (ITEMS + ForwardRecorder::MAX_INSTANCES_PER_DRAW - 1) / ForwardRecorder::MAX_INSTANCES_PER_DRAW;
+        CHECK(fixture.mRHI.GetLastFrameStats().mDrawCalls == numGroups * 2);
+        const std::vector<NullCommand> draws = fixture.Commands(NullCommandType::DRAW_INDEXED);
+        const std::vector<NullCommand> buffers = fixture.Commands(NullCommandType::SET_STRUCTURED_BUFFER);
+        CHECK(draws.size() == numGroups * 2 && buffers.size() == numGroups);
+        uint32_t first = 0;
+        for (uint32_t group = 0; group < buffers.size(); ++group)
+        {
+            const NullCommand& buffer = buffers[group];
+            const uint32_t numInstances = std::min(ITEMS - first, ForwardRecorder::MAX_INSTANCES_PER_DRAW);
+            CHECK(buffer.mSlot == INSTANCE_BUFFER_SLOT && buffer.mCount == numInstances);
+            CHECK(buffer.mArgs[0] == sizeof(InstanceData) && buffer.mSize == sizeof(InstanceData) * numInstances);
+            // both sub-meshes draw every instance of the group
+            CHECK(draws[group * 2].mCount == numInstances && draws[group * 2 + 1].mCount == numInstances);
+            CHECK(draws[group * 2].mArgs[1] == 0 && draws[group * 2 + 1].mArgs[1] == 18);
+            // the transforms and colors of the items, in the order they were recorded
+            const InstanceData* instances = reinterpret_cast<const InstanceData*>(buffer.mObject);
+            bool sameInstances = true;
+            for (uint32_t i = 0; i < numInstances; ++i)
+            {
+                sameInstances = sameInstances && instances[i].mModel.m.m[0][3] == static_cast<float>(first + i) &&
+                    instances[i].mColor.v.x == static_cast<float>(first + i);
+            }
+            CHECK(sameInstances);
+            first += numInstances;
+        }
+        CHECK(first == ITEMS);
+
+        // the same items without instancing draw one by one
+        for (RenderItem& item : items) item.mMaterial = single.get();
+        fixture.RecordFrame(items);
+        CHECK(fixture.mRHI.GetLastFrameStats().mDrawCalls == ITEMS * 2);
+        CHECK(fixture.Commands(NullCommandType::SET_STRUCTURED_BUFFER).empty());
+        fixture.mRHI.RHIReleaseGraphicsContext(fixture.mContext);
+    }
+
+    void TestBreaks()
+    {
+        Fixture fixture;
+        auto first = fixture.CreateInstance(fixture.mInstanced, 0);
+        // another instance of the material with the same texture shares the draw
+        auto sameTexture = fixture.CreateInstance(fixture.mInstanced, 0);
+        auto otherTexture = fixture.CreateInstance(fixture.mInstanced, 1);
+        auto single = fixture.CreateInstance(fixture.mSingle, 0);
+        std::vector<RenderItem> items;
+        items.push_back(fixture.CreateItem(first.get(), 0, 0));
+        items.push_back(fixture.CreateItem(sameTexture.get(), 0, 1));
+        items.push_back(fixture.CreateItem(first.get(), 0, 2));
+        items.push_back(fixture.CreateItem(otherTexture.get(), 0, 3));
+        items.push_back(fixture.CreateItem(otherTexture.get(), 0, 4));
+        items.push_back(fixture.CreateItem(otherTexture.get(), 1, 5));
+        items.push_back(fixture.CreateItem(single.get(), 1, 6));
+        items.push_back(fixture.CreateItem(first.get(), 1, 7));
+
+        fixture.RecordFrame(items);
+        const std::vector<NullCommand> buffers = fixture.Commands(NullCommandType::SET_STRUCTURED_BUFFER);
+        // groups of 3, 2 after the texture changed, 1 after the mesh changed, 1 after the non instanced item
+        const uint16_t expected[] = { 3, 2, 1, 1 };
+        CHECK(buffers.size() == 4);
+        for (uint32_t i = 0; i < buffers.size() && i < 4; ++i) CHECK(buffers[i].mCount == expected[i]);
+        CHECK(fixture.mRHI.GetLastFrameStats().mDrawCalls == 5 * 2);
+        fixture.mRHI.RHIReleaseGraphicsContext(fixture.mContext);
+    }
+}
+
+int main()
+{
+    TestGroups();
+    TestBreaks();
+    return TEST_RESULT();
+}
@@ -0,0 +1,119 @@
+// Bytes uploaded per frame for material instances animating one float each, written with SetConstant into the
+// material constant pool or uploaded as whole constant buffers from frame memory like before the pool.
+// MaterialConstantBenchmark [instances] [frames]
+#include "Engine/Render/Material.h"
+#include "Engine/Render/Null/NullRHI.h"
+#include "TestCommon.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    // the material constants of font.hlsl and particle.hlsl
+    constexpr uint32_t CONSTANTS_SIZE = 48;
+    constexpr uint64_t COLOR_ID = MaterialInstance::PropertyId("color");
+    constexpr uint64_t BLEND_FACTOR_ID = MaterialInstance::PropertyId("blendFactor");
+    constexpr uint64_t TEXT_UV_ID = MaterialInstance::PropertyId("TextUV");
+
+    struct FrameResult
+    {
+        double mMilliseconds;
+        uint64_t mBytesUploaded;
+    };
+
+    template <typename TRecord>
+    std::vector<FrameResult> RunFrames(NullRHI& rhi, uint32_t frames, TRecord&& record)
+    {
+        RHIGraphicsContext* context;
+        rhi.RHICreateGraphicsContext(&context);
+        auto fence = rhi.RHICreateFence();
+        std::vector<FrameResult> results;
+        for (uint32_t frame = 0; frame < frames; ++frame)
+        {
+            auto start = std::chrono::steady_clock::now();
+            fence->Wait(frame);
+            rhi.RHIResetGraphicsContext(context);
+            record(context, frame);
+            rhi.RHISubmitRenderCommands(context);
+            rhi.RHISyncGraphicContext(fence.get(), frame + 1);
+            rhi.EndFrame();
+            const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            results.push_back({ milliseconds, rhi.GetLastFrameStats().mBytesUploaded });
+        }
+        rhi.RHIReleaseGraphicsContext(context);
+        return results;
+    }
+
+    void Print(const char* name, std::vector<FrameResult>& results)
+    {
+        // the first frame uploads every buffer
+        const uint64_t bytesUploaded = results.back().mBytesUploaded;
+        std::sort(results.begin(), results.end(), [](const FrameResult& a, const FrameResult& b) { return a.mMilliseconds < b.mMilliseconds; });
+        std::printf("%-16s %8.1f KB per frame, median %.3f ms\n", name, bytesUploaded / 1000.0, results[results.size() / 2].mMilliseconds);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t numInstances = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 5000;
+    const uint32_t frames = std::max(argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 100, 2u);
+
+    NullRHI rhi;
+    rhi.Initialize();
+
+    Material material;
+    material.mNumConstants = 1;
+    material.mConstants.reset(new ConstantProperty[1]{ ConstantProperty(TEXT("MaterialConstants"), 2, CONSTANTS_SIZE) });
+    material.mVariables.emplace(COLOR_ID, ConstantVariable{ 0, 0, 16 });
+    material.mVariables.emplace(BLEND_FACTOR_ID, ConstantVariable{ 0, 16, 16 });
+    material.mVariables.emplace(TEXT_UV_ID, ConstantVariable{ 0, 32, 16 });
+
+    MaterialConstantPool pool;
+    pool.Initialize(&rhi, numInstances);
+    std::vector<std::unique_ptr<MaterialInstance>> instances(numInstances);
+    for (std::unique_ptr<MaterialInstance>& instance : instances)
+    {
+        instance.reset(new MaterialInstance());
+        instance->InstantiateFrom(&material);
+        const float color[4] = { 1, 1, 1, 1 };
+        instance->SetConstant(COLOR_ID, color);
+    }
+
+    std::vector<FrameResult> pooled = RunFrames(rhi, frames, [&](RHIGraphicsContext* pContext, uint32_t frame)
+    {
+        for (uint32_t i = 0; i < numInstances; ++i)
+        {
+            instances[i]->SetConstant(BLEND_FACTOR_ID, static_cast<float>(frame + i));
+            instances[i]->UploadConstants(pool);
+        }
+        pool.Flush(pContext);
+    });
+
+    std::vector<FrameResult> whole = RunFrames(rhi, frames, [&](RHIGraphicsContext* pContext, uint32_t frame)
+    {
+        for (uint32_t i = 0; i < numInstances; ++i)
+        {
+            instances[i]->SetConstant(BLEND_FACTOR_ID, static_cast<float>(frame + i));
+            const Blob& constants = instances[i]->GetConstantBuffer(0);
+            std::unique_ptr<RHIConstantBuffer> cbuffer = pContext->AllocConstantBuffer(constants.Size());
+            rhi.RHIUpdateConstantBuffer(cbuffer.get(), constants.Binary(), 0, constants.Size());
+            pContext->SetConstantBuffer(2, cbuffer.get());
+        }
+    });
+
+    // at most the animated float of every instance is copied once the pool holds the constants, bytes which did not
+    // change are skipped
+    CHECK(pooled.back().mBytesUploaded > 0 && pooled.back().mBytesUploaded <= numInstances * sizeof(float));
+    CHECK(whole.back().mBytesUploaded == static_cast<uint64_t>(numInstances) * CONSTANTS_SIZE);
+    std::printf("%u instances x %u frames\n", numInstances, frames);
+    Print("SetConstant", pooled);
+    Print("whole buffers", whole);
+
+    instances.clear();
+    rhi.Release();
+    return TEST_RESULT();
+}
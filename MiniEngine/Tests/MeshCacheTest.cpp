@@ -0,0 +1,168 @@
+// Mesh cache files: an imported mesh and its levels of detail load back as they were written, and files with indices
+// or base vertices addressing past the vertices are rejected so they are imported again instead of being uploaded.
+#include "Engine/Render/MeshCache.h"
+#include "TestCommon.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    // a quad of two triangles, positions only
+    MeshCache::ImportedMesh ImportQuad()
+    {
+        const float positions[] = {
+            0.0f, 0.0f, 0.0f,
+            1.0f, 0.0f, 0.0f,
+            1.0f, 1.0f, 0.0f,
+            0.0f, 1.0f, 0.0f,
+        };
+        const uint32_t indices[] = { 0, 1, 2, 0, 2, 3 };
+        return MeshCache::Import(positions, 4, 3 * sizeof(float), indices, 6);
+    }
+
+    // closed unit sphere, positions only, as two sub-meshes of half the triangles
+    MeshCache::ImportedMesh ImportSphere(uint32_t rings, uint32_t segments)
+    {
+        std::vector<float> positions = { 0.0f, 1.0f, 0.0f };
+        for (uint32_t ring = 1; ring < rings; ++ring)
+        {
+            const float theta = 3.14159265f * ring / rings;
+            for (uint32_t segment = 0; segment < segments; ++segment)
+            {
+                const float phi = 2.0f * 3.14159265f * segment / segments;
+                positions.insert(positions.end(), { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) });
+            }
+        }
+        positions.insert(positions.end(), { 0.0f, -1.0f, 0.0f });
+        const uint32_t numVertices = static_cast<uint32_t>(positions.size() / 3);
+        const auto ringVertex = [&](uint32_t ring, uint32_t segment) { return 1 + (ring - 1) * segments + segment % segments; };
+        std::vector<uint32_t> indices;
+        for (uint32_t ring = 0; ring < rings; ++ring)
+        {
+            for (uint32_t segment = 0; segment < segments; ++segment)
+            {
+                if (ring == 0) indices.insert(indices.end(), { 0, ringVertex(1, segment + 1), ringVertex(1, segment) });
+                else if (ring + 1 == rings) indices.insert(indices.end(), { numVertices - 1, ringVertex(ring, segment), ringVertex(ring, segment + 1) });
+                else
+                {
+                    const uint32_t a = ringVertex(ring, segment), b = ringVertex(ring, segment + 1);
+                    const uint32_t c = ringVertex(ring + 1, segment), d = ringVertex(ring + 1, segment + 1);
+                    indices.insert(indices.end(), { a, b, d, a, d, c });
+                }
+            }
+        }
+        const uint32_t numIndices = static_cast<uint32_t>(indices.size());
+        const uint32_t half = numIndices / 6 * 3;
+        const MeshCache::SubMeshRange subMeshes[] = { { half, 0, 0 }, { numIndices - half, half, 0 } };
+        return MeshCache::Import(positions.data(), numVertices, 3 * sizeof(float), indices.data(), numIndices, subMeshes, 2);
+    }
+
+    // offset of `p` in `file`
+    size_t OffsetOf(const std::vector<uint8_t>& file, const void* p)
+    {
+        return static_cast<const uint8_t*>(p) - file.data();
+    }
+
+    void TestRoundTrip()
+    {
+        const MeshCache::ImportedMesh mesh = ImportQuad();
+        CHECK(mesh.mNumVertices == 4);
+        const std::vector<uint8_t> file = MeshCache::Serialize(mesh, 100, 200);
+
+        MeshCache cache;
+        CHECK(cache.Load(file.data(), file.size()));
+        CHECK(cache.IsUpToDate(100, 200, VertexFormat::FULL));
+        CHECK(!cache.IsUpToDate(100, 201, VertexFormat::FULL));
+        CHECK(cache.GetNumVertices() == 4 && cache.GetNumIndices() == 6 && cache.GetIndexSize() == sizeof(uint16_t));
+        CHECK(cache.GetSubMeshes()[0].mIndexCount == 6 && cache.GetSubMeshes()[0].mBaseVertex == 0);
+        CHECK(memcmp(cache.GetVertices(), mesh.mVertices.data(), mesh.mVertices.size()) == 0);
+
+        // truncated files are rejected as well
+        CHECK(!cache.Load(file.data(), file.size() - 16));
+        CHECK(!cache.IsLoaded());
+    }
+
+    void TestLevelsOfDetail()
+    {
+        const MeshCache::ImportedMesh mesh = ImportSphere(32, 48);
+        CHECK(mesh.mNumLods > 1 && mesh.mNumLods <= MeshCache::MAX_LODS);
+        CHECK(mesh.mSubMeshes.size() == mesh.mNumLods * 2);
+        CHECK(mesh.mLodErrors[0] == 0.0f);
+        uint32_t previousIndices = 0;
+        for (uint32_t lod = 0; lod < mesh.mNumLods; ++lod)
+        {
+            const MeshCache::SubMeshRange* pRanges = &mesh.mSubMeshes[lod * 2];
+            const uint32_t lodIndices = pRanges[0].mIndexCount + pRanges[1].mIndexCount;
+            std::printf("lod %u: %u indices, error %.4f\n", lod, lodIndices, mesh.mLodErrors[lod]);
+            // every level keeps at most 80% of the previous one, within 5% of the radius of the mesh
+            if (lod > 0)
+            {
+                CHECK(lodIndices <= previousIndices * 0.8f);
+                CHECK(mesh.mLodErrors[lod] >= mesh.mLodErrors[lod - 1] && mesh.mLodErrors[lod] <= 0.05f);
+            }
+            for (uint32_t i = 0; i < 2; ++i)
+            {
+                CHECK(pRanges[i].mIndexCount > 0 && pRanges[i].mStartIndex + pRanges[i].mIndexCount <= mesh.mIndices.size());
+            }
+            previousIndices = lodIndices;
+        }
+        for (uint32_t index : mesh.mIndices) CHECK(index < mesh.mNumVertices);
+
+        // the ranges of every level and the indices they cover survive the file
+        const std::vector<uint8_t> file = MeshCache::Serialize(mesh, 1, 2);
+        MeshCache cache;
+        CHECK(cache.Load(file.data(), file.size()));
+        CHECK(cache.GetNumLods() == mesh.mNumLods && cache.GetNumSubMeshes() == 2);
+        for (uint32_t lod = 0; lod < mesh.mNumLods; ++lod)
+        {
+            CHECK(cache.GetLodError(lod) == mesh.mLodErrors[lod]);
+            CHECK(memcmp(cache.GetSubMeshes(lod), &mesh.mSubMeshes[lod * 2], 2 * sizeof(MeshCache::SubMeshRange)) == 0);
+        }
+        CHECK(cache.GetNumIndices() == mesh.mIndices.size() && cache.GetIndexSize() == sizeof(uint16_t));
+        const uint16_t* pIndices = static_cast<const uint16_t*>(cache.GetIndices());
+        bool sameIndices = true;
+        for (size_t i = 0; i < mesh.mIndices.size(); ++i) sameIndices = sameIndices && pIndices[i] == mesh.mIndices[i];
+        CHECK(sameIndices);
+    }
+
+    void TestOutOfBounds()
+    {
+        const std::vector<uint8_t> source = MeshCache::Serialize(ImportQuad(), 100, 200);
+        MeshCache cache;
+        CHECK(cache.Load(source.data(), source.size()));
+        const size_t indexOffset = OffsetOf(source, cache.GetIndices());
+        const size_t subMeshOffset = OffsetOf(source, cache.GetSubMeshes());
+
+        // an index past the last vertex
+        std::vector<uint8_t> file = source;
+        const uint16_t index = 4;
+        memcpy(file.data() + indexOffset + 2 * sizeof(uint16_t), &index, sizeof(index));
+        CHECK(!cache.Load(file.data(), file.size()));
+
+        // base vertices moving valid indices before the first vertex or past the last one
+        for (const int32_t baseVertex : { 1, -1 })
+        {
+            file = source;
+            memcpy(file.data() + subMeshOffset + offsetof(MeshCache::SubMeshRange, mBaseVertex), &baseVertex, sizeof(baseVertex));
+            CHECK(!cache.Load(file.data(), file.size()));
+        }
+
+        // an empty range does not read any index
+        file = source;
+        const MeshCache::SubMeshRange empty = { 0, 0, 1000 };
+        memcpy(file.data() + subMeshOffset, &empty, sizeof(empty));
+        CHECK(cache.Load(file.data(), file.size()));
+    }
+}
+
+int main()
+{
+    TestRoundTrip();
+    TestLevelsOfDetail();
+    TestOutOfBounds();
+    return TEST_RESULT();
+}
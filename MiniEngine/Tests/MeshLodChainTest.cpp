@@ -0,0 +1,68 @@
+// Level of detail selection: the level follows the size on screen, and the hysteresis band keeps an object sitting at
+// a threshold from switching every frame.
+#include "Engine/Render/MeshData.h"
+#include "TestCommon.h"
+
+namespace
+{
+    // level 1 is allowed below a screen size of 0.2 and taken below 0.15, level 2 below 0.05 and 0.0375
+    MeshLodChain MakeChain()
+    {
+        MeshLodChain chain;
+        chain.mNumLods = 3;
+        chain.mErrors[1] = 0.01f;
+        chain.mErrors[2] = 0.04f;
+        return chain;
+    }
+
+    void TestScreenSize()
+    {
+        const MeshLodChain chain = MakeChain();
+        CHECK(chain.selectLod(0, 1.0f) == 0);
+        CHECK(chain.selectLod(2, 1.0f) == 0);
+        CHECK(chain.selectLod(0, 0.1f) == 1);
+        // far away objects skip the levels in between
+        CHECK(chain.selectLod(0, 0.01f) == 2);
+        // levels past the chain, e.g. after the mesh was imported again
+        CHECK(chain.selectLod(7, 0.01f) == 2);
+        CHECK(chain.selectLod(7, 1.0f) == 0);
+        // a mesh without coarser levels
+        MeshLodChain single;
+        CHECK(single.selectLod(0, 0.0f) == 0);
+    }
+
+    void TestHysteresis()
+    {
+        const MeshLodChain chain = MakeChain();
+        // jittering inside the band keeps the level either way
+        uint32_t fine = 0;
+        uint32_t coarse = 1;
+        uint32_t numSwitches = 0;
+        for (int frame = 0; frame < 100; ++frame)
+        {
+            const float screenSize = frame % 2 ? 0.16f : 0.19f;
+            const uint32_t nextFine = chain.selectLod(fine, screenSize);
+            const uint32_t nextCoarse = chain.selectLod(coarse, screenSize);
+            numSwitches += (nextFine != fine) + (nextCoarse != coarse);
+            fine = nextFine;
+            coarse = nextCoarse;
+        }
+        CHECK(numSwitches == 0);
+        CHECK(fine == 0 && coarse == 1);
+
+        // leaving the band switches once
+        uint32_t lod = chain.selectLod(0, 0.14f);
+        CHECK(lod == 1);
+        CHECK(chain.selectLod(lod, 0.19f) == 1);
+        lod = chain.selectLod(lod, 0.21f);
+        CHECK(lod == 0);
+        CHECK(chain.selectLod(lod, 0.16f) == 0);
+    }
+}
+
+int main()
+{
+    TestScreenSize();
+    TestHysteresis();
+    return TEST_RESULT();
+}
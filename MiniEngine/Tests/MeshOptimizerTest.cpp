@@ -0,0 +1,263 @@
+// The reordering passes of the mesh import: they keep the triangles, Tipsify brings a shuffled grid close to the best
+// ACMR, the overdraw clusters stay within their cache budget, the fetch order follows the first uses and the analyzers
+// give the values counted by hand.
+#include "Engine/Render/MeshOptimizer.h"
+#include "TestCommon.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+    struct Mesh
+    {
+        std::vector<float> mPositions;
+        std::vector<uint32_t> mIndices;
+
+        uint32_t GetNumVertices() const { return static_cast<uint32_t>(mPositions.size() / 3); }
+        uint32_t GetNumIndices() const { return static_cast<uint32_t>(mIndices.size()); }
+    };
+
+    // n x n quads in the xy plane
+    Mesh MakeGrid(uint32_t n)
+    {
+        Mesh mesh;
+        for (uint32_t y = 0; y <= n; ++y)
+        {
+            for (uint32_t x = 0; x <= n; ++x) mesh.mPositions.insert(mesh.mPositions.end(), { float(x), float(y), 0.0f });
+        }
+        for (uint32_t y = 0; y < n; ++y)
+        {
+            for (uint32_t x = 0; x < n; ++x)
+            {
+                const uint32_t v = y * (n + 1) + x;
+                mesh.mIndices.insert(mesh.mIndices.end(), { v, v + 1, v + n + 2, v, v + n + 2, v + n + 1 });
+            }
+        }
+        return mesh;
+    }
+
+    // closed unit sphere, `rings` bands of `segments` quads between two pole vertices
+    Mesh MakeSphere(uint32_t rings, uint32_t segments)
+    {
+        Mesh mesh;
+        mesh.mPositions.insert(mesh.mPositions.end(), { 0.0f, 1.0f, 0.0f });
+        for (uint32_t ring = 1; ring < rings; ++ring)
+        {
+            const float theta = 3.14159265f * ring / rings;
+            for (uint32_t segment = 0; segment < segments; ++segment)
+            {
+                const float phi = 2.0f * 3.14159265f * segment / segments;
+                mesh.mPositions.insert(mesh.mPositions.end(),
+                    { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) });
+            }
+        }
+        mesh.mPositions.insert(mesh.mPositions.end(), { 0.0f, -1.0f, 0.0f });
+        const uint32_t south = mesh.GetNumVertices() - 1;
+        const auto ringVertex = [&](uint32_t ring, uint32_t segment) { return 1 + (ring - 1) * segments + segment % segments; };
+        for (uint32_t segment = 0; segment < segments; ++segment)
+        {
+            mesh.mIndices.insert(mesh.mIndices.end(), { 0, ringVertex(1, segment + 1), ringVertex(1, segment) });
+            mesh.mIndices.insert(mesh.mIndices.end(), { south, ringVertex(rings - 1, segment), ringVertex(rings - 1, segment + 1) });
+            for (uint32_t ring = 1; ring + 1 < rings; ++ring)
+            {
+                const uint32_t a = ringVertex(ring, segment), b = ringVertex(ring, segment + 1);
+                const uint32_t c = ringVertex(ring + 1, segment), d = ringVertex(ring + 1, segment + 1);
+                mesh.mIndices.insert(mesh.mIndices.end(), { a, b, d, a, d, c });
+            }
+        }
+        return mesh;
+    }
+
+    void ShuffleTriangles(std::vector<uint32_t>& indices, uint32_t seed)
+    {
+        std::vector<uint32_t> order(indices.size() / 3);
+        for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::shuffle(order.begin(), order.end(), std::mt19937(seed));
+        std::vector<uint32_t> shuffled;
+        for (uint32_t triangle : order) shuffled.insert(shuffled.end(), indices.begin() + triangle * 3, indices.begin() + triangle * 3 + 3);
+        indices = std::move(shuffled);
+    }
+
+    // sorted triangles, each rotated to start with its smallest index so the winding is kept
+    std::vector<uint32_t> TriangleMultiset(const std::vector<uint32_t>& indices)
+    {
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            std::array<uint32_t, 3> triangle = { indices[i], indices[i + 1], indices[i + 2] };
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+            triangles.push_back(triangle);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        std::vector<uint32_t> result;
+        for (const auto& triangle : triangles) result.insert(result.end(), triangle.begin(), triangle.end());
+        return result;
+    }
+
+    float Acmr(const Mesh& mesh)
+    {
+        return MeshOptimizer::AnalyzeVertexCache(mesh.mIndices.data(), mesh.GetNumIndices(), mesh.GetNumVertices()).mAcmr;
+    }
+
+    void TestVertexCache()
+    {
+        Mesh grid = MakeGrid(100);
+        ShuffleTriangles(grid.mIndices, 1);
+        const std::vector<uint32_t> triangles = TriangleMultiset(grid.mIndices);
+        const float shuffledAcmr = Acmr(grid);
+
+        MeshOptimizer::OptimizeVertexCache(grid.mIndices.data(), grid.GetNumIndices(), grid.GetNumVertices());
+        const float optimizedAcmr = Acmr(grid);
+        std::printf("shuffled 100x100 grid: ACMR %.2f -> %.2f\n", shuffledAcmr, optimizedAcmr);
+        CHECK(TriangleMultiset(grid.mIndices) == triangles);
+        // every triangle misses all its corners when shuffled, 0.5 is the limit of an infinite grid
+        CHECK(shuffledAcmr > 2.9f);
+        CHECK(optimizedAcmr < 0.7f);
+    }
+
+    void TestOverdraw()
+    {
+        Mesh sphere = MakeSphere(32, 48);
+        ShuffleTriangles(sphere.mIndices, 2);
+        const std::vector<uint32_t> triangles = TriangleMultiset(sphere.mIndices);
+        MeshOptimizer::OptimizeVertexCache(sphere.mIndices.data(), sphere.GetNumIndices(), sphere.GetNumVertices());
+        const std::vector<uint32_t> cacheOrder = sphere.mIndices;
+        const float cacheAcmr = Acmr(sphere);
+
+        MeshOptimizer::OptimizeOverdraw(sphere.mIndices.data(), sphere.GetNumIndices(), sphere.mPositions.data(),
+            sphere.GetNumVertices(), 3 * sizeof(float));
+        const float overdrawAcmr = Acmr(sphere);
+        std::printf("sphere: ACMR %.3f -> %.3f with the overdraw clusters\n", cacheAcmr, overdrawAcmr);
+        CHECK(sphere.mIndices != cacheOrder);
+        CHECK(TriangleMultiset(sphere.mIndices) == triangles);
+        CHECK(overdrawAcmr <= MeshOptimizer::OVERDRAW_THRESHOLD * cacheAcmr);
+    }
+
+    void TestVertexFetch()
+    {
+        // the position and the original index of every vertex, the last vertex is never referenced
+        constexpr uint32_t STRIDE = 4 * sizeof(float);
+        Mesh grid = MakeGrid(8);
+        ShuffleTriangles(grid.mIndices, 3);
+        const uint32_t numVertices = grid.GetNumVertices() + 1;
+        std::vector<float> vertices;
+        for (uint32_t v = 0; v < numVertices; ++v)
+        {
+            const float* pPosition = v < grid.GetNumVertices() ? &grid.mPositions[v * 3] : nullptr;
+            vertices.insert(vertices.end(), { pPosition ? pPosition[0] : -1.0f, pPosition ? pPosition[1] : -1.0f, 0.0f, float(v) });
+        }
+        std::vector<float> original = vertices;
+        std::vector<uint32_t> indices = grid.mIndices;
+
+        const uint32_t numReferenced = MeshOptimizer::OptimizeVertexFetch(vertices.data(), indices.data(),
+            static_cast<uint32_t>(indices.size()), numVertices, STRIDE);
+        CHECK(numReferenced == grid.GetNumVertices());
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            CHECK(memcmp(&vertices[indices[i] * 4], &original[grid.mIndices[i] * 4], STRIDE) == 0);
+        }
+        // every new vertex is first used right after the previous one
+        uint32_t next = 0;
+        for (uint32_t index : indices)
+        {
+            CHECK(index <= next);
+            if (index == next) ++next;
+        }
+        CHECK(vertices[(numVertices - 1) * 4 + 3] == float(numVertices - 1));
+    }
+
+    // triangles of the simplified mesh, checked to index the vertices and not to be degenerate
+    bool IsValidMesh(const std::vector<uint32_t>& indices, uint32_t numVertices)
+    {
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            if (indices[i] >= numVertices || indices[i + 1] >= numVertices || indices[i + 2] >= numVertices) return false;
+            if (indices[i] == indices[i + 1] || indices[i + 1] == indices[i + 2] || indices[i] == indices[i + 2]) return false;
+        }
+        return true;
+    }
+
+    void TestSimplify()
+    {
+        const Mesh sphere = MakeSphere(32, 48);
+        std::vector<uint32_t> simplified(sphere.mIndices.size());
+        float error = -1.0f;
+
+        // a loose error bound reaches the target
+        const uint32_t target = sphere.GetNumIndices() / 4 / 3 * 3;
+        uint32_t count = MeshOptimizer::Simplify(simplified.data(), sphere.mIndices.data(), sphere.GetNumIndices(),
+            sphere.mPositions.data(), sphere.GetNumVertices(), 3 * sizeof(float), target, 0.2f, &error);
+        std::printf("sphere simplified from %u to %u indices (target %u), error %.4f\n", sphere.GetNumIndices(), count, target, error);
+        simplified.resize(count);
+        CHECK(count <= target && count > target / 2 && count % 3 == 0);
+        CHECK(error > 0.0f && error <= 0.2f);
+        CHECK(IsValidMesh(simplified, sphere.GetNumVertices()));
+
+        // a tight one stops before the target, within the error
+        simplified.resize(sphere.mIndices.size());
+        count = MeshOptimizer::Simplify(simplified.data(), sphere.mIndices.data(), sphere.GetNumIndices(),
+            sphere.mPositions.data(), sphere.GetNumVertices(), 3 * sizeof(float), target, 0.001f, &error);
+        std::printf("sphere simplified to %u indices within an error of 0.001, error %.4f\n", count, error);
+        simplified.resize(count);
+        CHECK(count > target && count < sphere.GetNumIndices());
+        CHECK(error <= 0.001f);
+        CHECK(IsValidMesh(simplified, sphere.GetNumVertices()));
+
+        // a flat grid collapses without error inside, its border keeps the outline
+        const Mesh grid = MakeGrid(16);
+        simplified.resize(grid.mIndices.size());
+        count = MeshOptimizer::Simplify(simplified.data(), grid.mIndices.data(), grid.GetNumIndices(), grid.mPositions.data(),
+            grid.GetNumVertices(), 3 * sizeof(float), 0, 0.0f, &error);
+        simplified.resize(count);
+        CHECK(count > 0 && count < grid.GetNumIndices() / 4);
+        CHECK(error == 0.0f);
+        float area = 0.0f;
+        for (size_t i = 0; i < simplified.size(); i += 3)
+        {
+            const float* p0 = &grid.mPositions[simplified[i] * 3];
+            const float* p1 = &grid.mPositions[simplified[i + 1] * 3];
+            const float* p2 = &grid.mPositions[simplified[i + 2] * 3];
+            area += 0.5f * ((p1[0] - p0[0]) * (p2[1] - p0[1]) - (p1[1] - p0[1]) * (p2[0] - p0[0]));
+        }
+        CHECK_NEAR(area, 16.0f * 16.0f, 1e-3f);
+    }
+
+    void TestAnalyzers()
+    {
+        // two disjoint triangles and the first again: a cache of 3 entries has evicted it by then
+        const uint32_t indices[] = { 0, 1, 2, 3, 4, 5, 0, 1, 2 };
+        MeshOptimizer::VertexCacheStats stats = MeshOptimizer::AnalyzeVertexCache(indices, 9, 6, 3);
+        CHECK_NEAR(stats.mAcmr, 9.0f / 3.0f, 1e-6f);
+        CHECK_NEAR(stats.mAtvr, 9.0f / 6.0f, 1e-6f);
+        // with 16 entries the last triangle hits
+        stats = MeshOptimizer::AnalyzeVertexCache(indices, 9, 6);
+        CHECK_NEAR(stats.mAcmr, 6.0f / 3.0f, 1e-6f);
+        CHECK_NEAR(stats.mAtvr, 1.0f, 1e-6f);
+
+        // 16 byte vertices, 4 per line: vertices 0 and 4 each fetch a whole line for 16 bytes
+        const uint32_t sparse[] = { 0, 4, 0 };
+        CHECK_NEAR(MeshOptimizer::AnalyzeVertexFetch(sparse, 3, 8, 16), 128.0f / 32.0f, 1e-6f);
+        // 48 byte vertices straddle lines: 0 reads line 0, 1 reads line 1 and 2 reads line 2
+        const uint32_t straddling[] = { 0, 1, 2 };
+        CHECK_NEAR(MeshOptimizer::AnalyzeVertexFetch(straddling, 3, 3, 48), 192.0f / 144.0f, 1e-6f);
+        // sequential 16 byte vertices use every byte fetched
+        const uint32_t sequential[] = { 0, 1, 2, 3, 4, 5, 6, 7, 0 };
+        CHECK_NEAR(MeshOptimizer::AnalyzeVertexFetch(sequential, 9, 8, 16), 1.0f, 1e-6f);
+    }
+}
+
+int main()
+{
+    TestVertexCache();
+    TestOverdraw();
+    TestVertexFetch();
+    TestSimplify();
+    TestAnalyzers();
+    return TEST_RESULT();
+}
@@ -0,0 +1,197 @@
+// Exercises the null rhi the way the renderer drives it: shader reflection, uploads through the copy context and
+// frames recorded by a graphics context, checking the counters the headless benchmarks rely on.
+#include "Engine/Render/Null/NullRHI.h"
+#include "Engine/Render/Shader.h"
+#include "Engine/Render/Blob.h"
+#include "TestCommon.h"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    const char* kShaderSource =
+        "// comment cbuffer Fake : register(b9) {}\n"
+        "cbuffer ObjectConstants : register(b1) { float4x4 m_model; float4x4 m_model_i; float4x4 m_view; float4x4 m_view_i; float4x4 m_projection; float4x4 m_projection_i; };\n"
+        "cbuffer Mat : register(b2) { float3 a; float b; float2 c; float3 d; float e[3]; row_major float3x4 m; };\n"
+        "Texture2D<float4> gAlbedo : register(t0); TextureCube gSky : register(t1); SamplerState gLinear : register(s0); SamplerState gAniso : register(s5);\n"
+        "float4 Sample(Texture2D tex, float2 uv) { return 0; }\n";
+
+    void TestShaderReflection(NullRHI& rhi)
+    {
+        Blob blob{kShaderSource, strlen(kShaderSource)};
+        auto shader = rhi.RHICompileShader(blob, static_cast<ShaderType>(ShaderType::VERTEX | ShaderType::PIXEL));
+        // commented out declarations and function parameters are not properties
+        CHECK(shader->GetShaderProperties().size() == 5);
+        for (auto& property : shader->GetShaderProperties())
+        {
+            if (property.mType == ShaderPropType::CBUFFER && property.mRegister == 1) CHECK(property.mInfo.mCBufferSize == 384);
+        }
+    }
+
+    void TestUploadsAndFrames(NullRHI& rhi)
+    {
+        RHISwapChainDesc swapChainDesc{0, 0, 0, 1, 2, Format::R8G8B8A8_UNORM, false};
+        auto swapChain = rhi.RHICreateSwapChain(swapChainDesc);
+        CHECK(swapChain->GetBackBufferDesc().mWidth == NullRHI::DEFAULT_BACK_BUFFER_WIDTH);
+
+        auto vertexBuffer = rhi.RHIAllocVertexBuffer(32, 100);
+        auto indexBuffer = rhi.RHIAllocIndexBuffer(300, Format::R16_UINT);
+        auto staging = rhi.RHIAllocStagingBuffer(3200);
+        std::vector<uint8_t> data(3200, 7);
+        rhi.RHIUpdateStagingBuffer(staging.get(), data.data(), 0, 3200);
+
+        RHICopyContext* copyContext;
+        rhi.RHICreateCopyContext(&copyContext);
+        auto copyFence = rhi.RHICreateFence();
+        copyContext->UpdateBuffer(vertexBuffer.get(), staging.get(), 3200, 0, 0);
+        rhi.RHISubmitCopyCommands(copyContext);
+        rhi.RHISyncCopyContext(copyFence.get(), 1);
+        copyFence->Wait(1);
+        CHECK(static_cast<NullBuffer*>(vertexBuffer->GetBuffer())->Data()[3199] == 7);
+
+        RHITextureDesc textureDesc{Format::R8G8B8A8_UNORM, TextureDimension::TEXTURE2D, 64, 64, 1, 0, 1, 0};
+        auto texture = rhi.RHIAllocTexture(textureDesc);
+        auto stagingTexture = rhi.RHIAllocStagingTexture(texture->GetDesc(), 1);
+        CHECK(stagingTexture->GetBuffer()->BufferSize() == 32 * 32 * 4);
+
+        Blob blob{kShaderSource, strlen(kShaderSource)};
+        auto shader = rhi.RHICompileShader(blob, static_cast<ShaderType>(ShaderType::VERTEX | ShaderType::PIXEL));
+
+        RHIGraphicsContext* context;
+        rhi.RHICreateGraphicsContext(&context);
+        auto fence = rhi.RHICreateFence();
+        PipelineInitializer pipeline = PipelineInitializer::Default();
+        pipeline.SetShader(shader.get());
+        for (int frame = 0; frame < 3; ++frame)
+        {
+            fence->Wait(frame);
+            rhi.RHIResetGraphicsContext(context);
+            swapChain->BeginFrame(context);
+            context->SetPipelineState(pipeline);
+            context->SetPipelineState(pipeline);
+            auto constants = context->AllocConstantBuffer(384);
+            rhi.RHIUpdateConstantBuffer(constants.get(), data.data(), 0, 384);
+            context->SetConstantBuffer(1, constants.get());
+            RHIVertexBuffer* vertexBuffers[] = {vertexBuffer.get()};
+            context->SetVertexBuffers(vertexBuffers, 1);
+            context->SetIndexBuffer(indexBuffer.get());
+            context->DrawIndexedInstanced(300, 0, 0, 2, 0);
+            swapChain->EndFrame(context);
+            rhi.RHISubmitRenderCommands(context);
+            rhi.RHISyncGraphicContext(fence.get(), frame + 1);
+            swapChain->Present();
+        }
+
+        // the second bind of the same state is not a change
+        const NullFrameStats& stats = rhi.GetLastFrameStats();
+        CHECK(stats.mDrawCalls == 1);
+        CHECK(stats.mPrimitives == 200);
+        CHECK(stats.mPipelineStateBinds == 2);
+        CHECK(stats.mPipelineStateChanges == 1);
+        CHECK(stats.mBytesUploaded == 384);
+        CHECK(stats.mCommandLists == 1);
+        CHECK(!rhi.GetLastCommandStream().empty());
+
+        rhi.RHIReleaseGraphicsContext(context);
+        rhi.RHIReleaseCopyContext(copyContext);
+    }
+
+    // the descriptor tables the renderer writes for 3 materials of 4 items each, bound per material change or bindless.
+    void TestBindlessTables(NullRHI& rhi)
+    {
+        constexpr uint32_t MATERIALS = 3;
+        constexpr uint32_t ITEMS_PER_MATERIAL = 4;
+        const char* source =
+            "BEGIN_BINDLESS_MATERIAL_DATA float4 m_tint; uint m_diffuse; uint3 m_padding0; float4 m_padding1[14]; END_BINDLESS_MATERIAL_DATA\n";
+        Blob blob{source, strlen(source)};
+        auto shader = rhi.RHICompileShader(blob, static_cast<ShaderType>(ShaderType::VERTEX | ShaderType::PIXEL));
+        CHECK(shader->GetShaderProperties().size() == 1 && shader->GetShaderProperties()[0].mInfo.mCBufferSize == 256);
+
+        auto objects = rhi.RHIAllocStaticConstantBuffer(256 * MATERIALS * ITEMS_PER_MATERIAL);
+        auto materials = rhi.RHIAllocStaticConstantBuffer(256 * MATERIALS);
+        const uint32_t numDescriptors = rhi.GetNumBindlessDescriptors();
+        rhi.RHISetBindlessConstantTables(objects.get(), materials.get(), 256);
+        CHECK(rhi.GetNumBindlessDescriptors() == numDescriptors + 2);
+        auto texture = rhi.RHIAllocTexture({Format::R8G8B8A8_UNORM, TextureDimension::TEXTURE2D, 4, 4, 1, 1, 1, 0});
+        CHECK(texture->GetBindlessIndex() + 1 == rhi.GetNumBindlessDescriptors() - 2);
+
+        RHIGraphicsContext* context;
+        rhi.RHICreateGraphicsContext(&context);
+        auto fence = rhi.RHICreateFence();
+        auto recordFrame = [&](uint64_t frame, bool bindless)
+        {
+            fence->Wait(frame);
+            rhi.RHIResetGraphicsContext(context);
+            if (bindless) context->SetBindlessTables();
+            for (uint32_t item = 0; item < MATERIALS * ITEMS_PER_MATERIAL; ++item)
+            {
+                const uint32_t material = item / ITEMS_PER_MATERIAL;
+                if (bindless)
+                {
+                    context->SetDrawIndices(item, material);
+                }
+                else if (item % ITEMS_PER_MATERIAL == 0)
+                {
+                    // a descriptor table per material change
+                    context->BeginBinding();
+                    context->SetTexture(0, texture.get());
+                    context->EndBindings();
+                }
+                context->DrawIndexedInstanced(36, 0, 0, 1, 0);
+            }
+            rhi.RHISubmitRenderCommands(context);
+            rhi.RHISyncGraphicContext(fence.get(), frame + 1);
+            rhi.EndFrame();
+        };
+
+        recordFrame(0, false);
+        CHECK(rhi.GetLastFrameStats().mDescriptorTables == MATERIALS);
+        CHECK(rhi.GetLastFrameStats().mDrawIndexUpdates == 0);
+
+        recordFrame(1, true);
+        CHECK(rhi.GetLastFrameStats().mDescriptorTables == 0);
+        CHECK(rhi.GetLastFrameStats().mDrawIndexUpdates == MATERIALS * ITEMS_PER_MATERIAL);
+        CHECK(rhi.GetLastFrameStats().mDrawCalls == MATERIALS * ITEMS_PER_MATERIAL);
+        uint32_t lastObject = 0;
+        for (const NullCommand& command : rhi.GetLastCommandStream())
+        {
+            if (command.mType != NullCommandType::SET_DRAW_INDICES) continue;
+            CHECK(command.mArgs[1] == command.mArgs[0] / ITEMS_PER_MATERIAL);
+            lastObject = command.mArgs[0];
+        }
+        CHECK(lastObject == MATERIALS * ITEMS_PER_MATERIAL - 1);
+        rhi.RHIReleaseGraphicsContext(context);
+    }
+
+    void TestBindlessTextureCapacity()
+    {
+        NullRHI rhi;
+        rhi.Initialize();
+        const RHITextureDesc desc{Format::R8G8B8A8_UNORM, TextureDimension::TEXTURE2D, 1, 1, 1, 1, 1, 0};
+        std::vector<std::unique_ptr<RHINativeTexture>> textures;
+        for (uint32_t i = 0; i < RHI::MAX_BINDLESS_TEXTURES; ++i)
+        {
+            textures.push_back(rhi.RHIAllocTexture(desc));
+        }
+        CHECK(textures.back()->GetBindlessIndex() == RHI::MAX_BINDLESS_TEXTURES - 1);
+        // the table is full, the texture is still allocated and warns that it has no bindless index
+        auto texture = rhi.RHIAllocTexture(desc);
+        CHECK(texture && texture->GetBindlessIndex() == RHINativeTexture::INVALID_BINDLESS_INDEX);
+        CHECK(rhi.GetNumBindlessDescriptors() == RHI::MAX_BINDLESS_TEXTURES);
+        rhi.Release();
+    }
+}
+
+int main()
+{
+    NullRHI rhi;
+    rhi.Initialize();
+    rhi.SetRecordCommands(true);
+    TestShaderReflection(rhi);
+    TestUploadsAndFrames(rhi);
+    TestBindlessTables(rhi);
+    rhi.Release();
+    TestBindlessTextureCapacity();
+    return TEST_RESULT();
+}
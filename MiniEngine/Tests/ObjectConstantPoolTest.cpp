@@ -0,0 +1,66 @@
+// Object constants are only rewritten and uploaded for the slots invalidated by moved objects.
+#include "Engine/Render/Null/NullRHI.h"
+#include "Engine/Render/ObjectConstantPool.h"
+#include "TestCommon.h"
+
+#include <vector>
+
+int main()
+{
+    constexpr uint32_t OBJECTS = 1000;
+    constexpr uint32_t MOVING = 10;
+
+    NullRHI rhi;
+    rhi.Initialize();
+    RHIGraphicsContext* context;
+    rhi.RHICreateGraphicsContext(&context);
+
+    ObjectConstantPool pool;
+    pool.Initialize(&rhi, OBJECTS);
+    std::vector<uint32_t> slots;
+    for (uint32_t i = 0; i < OBJECTS; ++i) slots.push_back(pool.Allocate());
+    CHECK(pool.Allocate() == ObjectConstantPool::INVALID_SLOT);
+
+    float constants[32] = {};
+    for (uint32_t frame = 0; frame < 4; ++frame)
+    {
+        // the renderer invalidates the slots of the transforms flushed as moved
+        if (frame > 0)
+        {
+            for (uint32_t i = 0; i < MOVING; ++i) pool.Invalidate(slots[(frame * 97 + i * 31) % OBJECTS]);
+        }
+
+        rhi.RHIResetGraphicsContext(context);
+        uint32_t numUpdated = 0;
+        for (uint32_t slot : slots)
+        {
+            if (!pool.IsStale(slot)) continue;
+            constants[0] = static_cast<float>(frame);
+            pool.Update(slot, constants, sizeof(constants));
+            ++numUpdated;
+        }
+        uint64_t uploaded = pool.Flush(context);
+        std::printf("frame %u: %u of %u object constants updated, %llu bytes uploaded\n", frame, numUpdated, OBJECTS,
+                    static_cast<unsigned long long>(uploaded));
+
+        // new slots start stale, afterwards only the moved ones
+        const uint32_t expected = frame == 0 ? OBJECTS : MOVING;
+        CHECK(numUpdated == expected);
+        CHECK(uploaded == static_cast<uint64_t>(expected) * ObjectConstantPool::SLOT_SIZE);
+        for (uint32_t slot : slots) CHECK(!pool.IsStale(slot));
+    }
+
+    // nothing moved, nothing is uploaded
+    rhi.RHIResetGraphicsContext(context);
+    CHECK(pool.Flush(context) == 0);
+
+    // a freed slot handed out again has to be written by its new owner
+    pool.Free(slots[5]);
+    uint32_t reused = pool.Allocate();
+    CHECK(reused == slots[5]);
+    CHECK(pool.IsStale(reused));
+
+    rhi.RHIReleaseGraphicsContext(context);
+    rhi.Release();
+    return TEST_RESULT();
+}
@@ -0,0 +1,129 @@
+// Keys of pipeline state records, the prewarm list and its archive, the lru cache of the rhis and a save, load and
+// prewarm cycle between two sessions of the null rhi.
+#include "Engine/Render/PipelineStateCache.h"
+#include "Engine/Render/Null/NullRHI.h"
+#include "Engine/Render/Shader.h"
+#include "Engine/Render/Blob.h"
+#include "TestCommon.h"
+
+#include <cstring>
+
+namespace
+{
+    const char* kShaderSource =
+        "cbuffer ObjectConstants : register(b1) { float4x4 m_model; };\n"
+        "float4 VsMain(float3 position : POSITION) : SV_POSITION { return mul(float4(position, 1), m_model); }\n";
+
+    void TestKeys()
+    {
+        PipelineInitializer a = PipelineInitializer::Default();
+        PipelineInitializer b = a;
+        CHECK(PipelineStateRecord::FromInitializer(a).Key() == PipelineStateRecord::FromInitializer(b).Key());
+
+        // state the options disable and the padding of the stencil masks are not part of the key
+        a.mOptions &= 0b011111;
+        b = a;
+        b.mDepthInitializer ^= 0x00ffffffu;
+        b.mStencilInitializers[0] |= 0xffffffff0000ull;
+        CHECK(PipelineStateRecord::FromInitializer(a).Key() == PipelineStateRecord::FromInitializer(b).Key());
+
+        b.mOptions |= 0b100000;
+        CHECK(PipelineStateRecord::FromInitializer(a).Key() != PipelineStateRecord::FromInitializer(b).Key());
+        b = a;
+        b.SetRenderTarget(Format::R8G8B8A8_UNORM_SRGB);
+        CHECK(PipelineStateRecord::FromInitializer(a).Key() != PipelineStateRecord::FromInitializer(b).Key());
+        b = a;
+        b.mInputLayout = InputLayout::COMPACT;
+        CHECK(PipelineStateRecord::FromInitializer(a).Key() != PipelineStateRecord::FromInitializer(b).Key());
+
+        PipelineStateRecord record = PipelineStateRecord::FromInitializer(a);
+        PipelineStateRecord otherShader = record;
+        otherShader.mShaderHash = 1;
+        CHECK(record.Key() != otherShader.Key());
+    }
+
+    void TestList()
+    {
+        PipelineStateRecord record = PipelineStateRecord::FromInitializer(PipelineInitializer::Default());
+        record.mShaderHash = 7;
+        PipelineStateRecord wireframe = record;
+        wireframe.mRasterizerInitializer ^= 1;
+        PipelineStateRecord otherShader = record;
+        otherShader.mShaderHash = 8;
+
+        PipelineStateList list;
+        CHECK(list.Add(record) && list.Add(wireframe) && list.Add(otherShader));
+        CHECK(!list.Add(record));
+        CHECK(list.GetNumRecords() == 3);
+
+        std::vector<uint8_t> archive = list.Serialize();
+        PipelineStateList loaded;
+        CHECK(loaded.Load(archive.data(), archive.size()) && loaded.GetNumRecords() == 3);
+        std::vector<PipelineStateRecord> records;
+        loaded.GetRecords(7, records);
+        CHECK(records.size() == 2 && records[0].Key() == record.Key() && records[1].Key() == wireframe.Key());
+
+        // truncated archives and archives of another version are rejected
+        archive.pop_back();
+        CHECK(!loaded.Load(archive.data(), archive.size()) && loaded.GetNumRecords() == 0);
+        archive = list.Serialize();
+        archive[4] ^= 0xff;
+        CHECK(!loaded.Load(archive.data(), archive.size()) && loaded.GetNumRecords() == 0);
+    }
+
+    void TestLeastRecentlyUsed()
+    {
+        PipelineStateCache<int> cache(2, 1);
+        cache.Insert(1, 1);
+        cache.Insert(2, 2);
+        cache.Insert(3, 3);
+        // every entry may still be used by the frame in flight
+        CHECK(cache.GetNumEntries() == 3 && cache.GetNumEvictions() == 0);
+
+        cache.NextFrame();
+        cache.NextFrame();
+        CHECK(cache.Find(1) && *cache.Find(1) == 1);
+        cache.Insert(4, 4);
+        CHECK(cache.GetNumEntries() == 2 && cache.GetNumEvictions() == 2);
+        CHECK(cache.Find(1) && cache.Find(4) && !cache.Find(2) && !cache.Find(3));
+    }
+
+    void TestPrewarm()
+    {
+        Blob blob{kShaderSource, strlen(kShaderSource)};
+        PipelineInitializer pipeline = PipelineInitializer::Default();
+        PipelineInitializer wireframe = pipeline;
+        wireframe.SetDrawMode(DrawMode::WIREFRAME);
+
+        std::vector<uint8_t> list, library;
+        {
+            NullRHI rhi;
+            auto shader = rhi.RHICompileShader(blob, ShaderType::VERTEX);
+            pipeline.SetShader(shader.get());
+            wireframe.SetShader(shader.get());
+            CHECK(rhi.GetOrCreatePipelineState(pipeline));
+            CHECK(!rhi.GetOrCreatePipelineState(pipeline));
+            CHECK(rhi.GetOrCreatePipelineState(wireframe));
+            rhi.RHISavePipelineStates(list, library);
+        }
+
+        // the next session creates both states when the shader is registered, before the first draw
+        NullRHI rhi;
+        CHECK(rhi.RHILoadPipelineStates(list.data(), list.size(), library.data(), library.size()));
+        auto shader = rhi.RHICompileShader(blob, ShaderType::VERTEX);
+        CHECK(rhi.RHIPrewarmPipelineStates(shader.get()) == 2);
+        CHECK(rhi.GetNumCachedPipelineStates() == 2);
+        pipeline.SetShader(shader.get());
+        CHECK(!rhi.GetOrCreatePipelineState(pipeline));
+        CHECK(rhi.RHIPrewarmPipelineStates(shader.get()) == 0);
+    }
+}
+
+int main()
+{
+    TestKeys();
+    TestList();
+    TestLeastRecentlyUsed();
+    TestPrewarm();
+    return TEST_RESULT();
+}
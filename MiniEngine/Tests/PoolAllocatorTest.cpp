@@ -0,0 +1,117 @@
+// The paged pool allocator: growing chains pages without moving live blocks, frees of foreign, misaligned or freed
+// pointers are rejected, iteration visits the live blocks in address order and an overrun into a canary is caught.
+// canaries are only on in debug builds, the test checks them in every build.
+#define POOL_ALLOCATOR_CANARY
+#include "Engine/Memory/PoolAllocator.h"
+#include "TestCommon.h"
+
+#include <vector>
+
+namespace
+{
+    struct Body
+    {
+        uint64_t mId;
+        float mMass;
+    };
+
+    using BodyPool = PoolAllocator<Body, 4>;
+
+    void TestPageChaining()
+    {
+        BodyPool pool;
+        pool.Initialize(1);
+        CHECK(pool.GetPageCount() == 1 && pool.GetCapacity() == 4);
+
+        std::vector<Body*> bodies;
+        for (uint64_t i = 0; i < 18; ++i)
+        {
+            bodies.push_back(pool.New(Body{ i, 1.0f }));
+            // every block allocated before the pool grew stays where it was
+            bool unchanged = true;
+            for (uint64_t j = 0; j <= i; ++j) unchanged = unchanged && bodies[j]->mId == j;
+            CHECK(unchanged);
+        }
+        CHECK(pool.GetPageCount() == 5 && pool.GetCapacity() == 20 && pool.GetAllocatedCount() == 18);
+        for (Body* body : bodies) CHECK(pool.Owns(body));
+        // consecutive allocations of a page are contiguous
+        CHECK(bodies[1] - bodies[0] == bodies[2] - bodies[1]);
+    }
+
+    void TestInvalidFrees()
+    {
+        BodyPool pool;
+        pool.Initialize(1);
+        Body* body = pool.New(Body{ 1, 1.0f });
+        Body* other = pool.New(Body{ 2, 1.0f });
+        Body foreign{};
+
+        CHECK(!pool.Free(nullptr));
+        CHECK(!pool.Owns(&foreign) && !pool.Free(&foreign));
+        // inside a block of the pool but not at its start
+        CHECK(!pool.Free(reinterpret_cast<uint8_t*>(other) + 4));
+        CHECK(pool.GetAllocatedCount() == 2);
+
+        CHECK(pool.Free(body));
+        CHECK(!pool.Free(body));
+        CHECK(pool.GetAllocatedCount() == 1 && other->mId == 2);
+        // the freed block is the next one handed out
+        CHECK(pool.Allocate() == body);
+    }
+
+    void TestForEach()
+    {
+        BodyPool pool;
+        pool.Initialize(1);
+        std::vector<Body*> bodies;
+        for (uint64_t i = 0; i < 10; ++i) bodies.push_back(pool.New(Body{ i, 1.0f }));
+        for (uint64_t i = 0; i < 10; i += 3) pool.Delete(bodies[i]);
+
+        std::vector<uint64_t> visited;
+        const Body* previous = nullptr;
+        bool inAddressOrder = true;
+        pool.ForEach([&](const Body& body)
+        {
+            inAddressOrder = inAddressOrder && (!previous || std::less<const Body*>()(previous, &body));
+            previous = &body;
+            visited.push_back(body.mId);
+        });
+        CHECK(inAddressOrder);
+        CHECK(visited.size() == pool.GetAllocatedCount() && visited.size() == 6);
+        std::sort(visited.begin(), visited.end());
+        CHECK(visited == std::vector<uint64_t>({ 1, 2, 4, 5, 7, 8 }));
+        CHECK(pool.ReportLeaks("TestForEach") == 6);
+
+        pool.Release();
+        CHECK(pool.GetPageCount() == 0 && pool.GetAllocatedCount() == 0 && pool.ReportLeaks() == 0);
+    }
+
+    void TestCanaries()
+    {
+        BodyPool pool;
+        pool.Initialize(1);
+        Body* overrun = pool.New(Body{ 1, 1.0f });
+        Body* underrun = pool.New(Body{ 2, 1.0f });
+        Body* intact = pool.New(Body{ 3, 1.0f });
+
+        // one byte past the end of the block and one before its start
+        reinterpret_cast<uint8_t*>(overrun + 1)[0] ^= 0xff;
+        reinterpret_cast<uint8_t*>(underrun)[-1] ^= 0xff;
+        CHECK(!pool.Free(overrun));
+        CHECK(!pool.Free(underrun));
+        CHECK(pool.Free(intact));
+        // corrupted blocks stay allocated and are not handed out again
+        CHECK(pool.GetAllocatedCount() == 2);
+        CHECK(pool.Allocate() == intact);
+        pool.Release();
+    }
+}
+
+int main()
+{
+    TestPageChaining();
+    TestInvalidFrees();
+    TestForEach();
+    TestCanaries();
+    return TEST_RESULT();
+}
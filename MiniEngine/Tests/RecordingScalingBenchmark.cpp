@@ -0,0 +1,128 @@
+// Records the same draws into 1 to 4 graphics contexts on the thread pool, like Renderer::opaquePass slices the sorted
+// items, and reports the recording time per thread count. The combined command stream has to match the serial one.
+// RecordingScalingBenchmark [draws per frame] [frames]
+#include "Engine/Render/Null/NullRHI.h"
+#include "Engine/Render/Shader.h"
+#include "Engine/Render/Blob.h"
+#include "Engine/Utility/ThreadPool/ThreadPool.h"
+#include "TestCommon.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t MAX_CONTEXTS = 4;
+
+    void RecordSlice(NullRHI* pRHI, RHIGraphicsContext* pContext, const PipelineInitializer* pPipeline, RHIVertexBuffer* pVertexBuffer,
+                     RHIIndexBuffer* pIndexBuffer, uint32_t begin, uint32_t end)
+    {
+        uint8_t objectConstants[256] = {};
+        RHIVertexBuffer* vertexBuffers[] = {pVertexBuffer};
+        pContext->SetPipelineState(*pPipeline);
+        pContext->SetVertexBuffers(vertexBuffers, 1);
+        pContext->SetIndexBuffer(pIndexBuffer);
+        for (uint32_t draw = begin; draw < end; ++draw)
+        {
+            memcpy(objectConstants, &draw, sizeof(draw));
+            auto constants = pContext->AllocConstantBuffer(sizeof(objectConstants));
+            pRHI->RHIUpdateConstantBuffer(constants.get(), objectConstants, 0, sizeof(objectConstants));
+            pContext->SetConstantBuffer(1, constants.get());
+            pContext->DrawIndexedInstanced(36, 0, 0, 1, draw);
+        }
+    }
+
+    // constant buffer bindings point at per frame allocations, the rest of the stream is deterministic
+    bool SameStream(const std::vector<NullCommand>& a, const std::vector<NullCommand>& b)
+    {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].mType != b[i].mType || a[i].mCount != b[i].mCount || memcmp(a[i].mArgs, b[i].mArgs, sizeof(a[i].mArgs)) != 0)
+                return false;
+            if (a[i].mType != NullCommandType::SET_CONSTANT_BUFFER && a[i].mType != NullCommandType::BEGIN_BINDING && a[i].mObject != b[i].mObject)
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t drawsPerFrame = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 200000;
+    const uint32_t frames = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 5;
+
+    NullRHI rhi;
+    rhi.Initialize();
+    rhi.SetRecordCommands(true);
+    ThreadPool threadPool(MAX_CONTEXTS, MAX_CONTEXTS, 64);
+
+    const char* source = "cbuffer ObjectConstants : register(b1) { float4x4 m_model; float4x4 m_model_i; };\n";
+    Blob blob{source, strlen(source)};
+    auto shader = rhi.RHICompileShader(blob, static_cast<ShaderType>(ShaderType::VERTEX | ShaderType::PIXEL));
+    PipelineInitializer pipeline = PipelineInitializer::Default();
+    pipeline.SetShader(shader.get());
+
+    RHISwapChainDesc swapChainDesc{0, 0, 0, 1, 2, Format::R8G8B8A8_UNORM, false};
+    auto swapChain = rhi.RHICreateSwapChain(swapChainDesc);
+    auto vertexBuffer = rhi.RHIAllocVertexBuffer(32, 24);
+    auto indexBuffer = rhi.RHIAllocIndexBuffer(36, Format::R16_UINT);
+    RHIGraphicsContext* contexts[MAX_CONTEXTS];
+    for (auto& context : contexts) rhi.RHICreateGraphicsContext(&context);
+    auto fence = rhi.RHICreateFence();
+    uint64_t fenceValue = 0;
+
+    std::printf("%u draws per frame, %u hardware threads, best of %u frames\n", drawsPerFrame, std::thread::hardware_concurrency(), frames);
+    std::vector<NullCommand> serialStream;
+    for (uint32_t numContexts = 1; numContexts <= MAX_CONTEXTS; ++numContexts)
+    {
+        double best = 1e30;
+        for (uint32_t frame = 0; frame < frames; ++frame)
+        {
+            auto start = std::chrono::steady_clock::now();
+            fence->Wait(fenceValue);
+            for (uint32_t i = 0; i < numContexts; ++i) rhi.RHIResetGraphicsContext(contexts[i]);
+            swapChain->BeginFrame(contexts[0]);
+
+            // contiguous slices, the main thread records the first one
+            std::vector<std::future<void>> recordings;
+            for (uint32_t i = 1; i < numContexts; ++i)
+            {
+                recordings.push_back(threadPool.enqueue(0, RecordSlice, &rhi, contexts[i], &pipeline, vertexBuffer.get(), indexBuffer.get(),
+                                                        drawsPerFrame * i / numContexts, drawsPerFrame * (i + 1) / numContexts));
+            }
+            RecordSlice(&rhi, contexts[0], &pipeline, vertexBuffer.get(), indexBuffer.get(), 0, drawsPerFrame / numContexts);
+            for (auto& recording : recordings) recording.get();
+
+            swapChain->EndFrame(contexts[numContexts - 1]);
+            for (uint32_t i = 0; i < numContexts; ++i) rhi.RHISubmitRenderCommands(contexts[i]);
+            rhi.RHISyncGraphicContext(fence.get(), ++fenceValue);
+            swapChain->Present();
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        const NullFrameStats& stats = rhi.GetLastFrameStats();
+        CHECK(stats.mDrawCalls == drawsPerFrame);
+        CHECK(stats.mCommandLists == numContexts);
+        // every context starts with its own bindings, only the draws keep their order
+        std::vector<NullCommand> draws;
+        for (const NullCommand& command : rhi.GetLastCommandStream())
+        {
+            if (command.mType == NullCommandType::DRAW_INDEXED) draws.push_back(command);
+        }
+        if (numContexts == 1)
+            serialStream = draws;
+        else
+            CHECK(SameStream(draws, serialStream));
+        std::printf("%u thread(s): %.2f ms\n", numContexts, best);
+    }
+
+    for (auto& context : contexts) rhi.RHIReleaseGraphicsContext(context);
+    rhi.Release();
+    return TEST_RESULT();
+}
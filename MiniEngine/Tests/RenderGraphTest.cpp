@@ -0,0 +1,110 @@
+// Transient textures with disjoint lifetimes share a texture, every live pass gets its transitions as one batch.
+#include "Engine/Render/Null/NullRHI.h"
+#include "Engine/Render/RenderGraph.h"
+#include "TestCommon.h"
+
+#include <vector>
+
+namespace
+{
+    struct Frame
+    {
+        RenderGraph::ResourceHandle mShadowA, mShadowB, mShadowC, mUnused;
+        uint16_t mUnusedPass;
+    };
+
+    // ShadowA and ShadowB are alive together in pass 1, ShadowC only comes alive after ShadowA was last read.
+    Frame DeclareFrame(RenderGraph& graph, RHIRenderTarget* pBackBuffer, std::vector<uint16_t>& executed)
+    {
+        const RHITextureDesc depthDesc{Format::D24_UNORM_S8_UINT, TextureDimension::TEXTURE2D, 256, 256, 1, 1, 1, 0};
+        const RHITextureDesc colorDesc{Format::R8G8B8A8_UNORM, TextureDimension::TEXTURE2D, 256, 256, 1, 1, 1, 0};
+        Frame frame;
+        graph.Reset();
+        const RenderGraph::ResourceHandle backBuffer = graph.ImportRenderTarget(pBackBuffer);
+        frame.mShadowA = graph.CreateDepthStencil(depthDesc);
+        frame.mShadowB = graph.CreateDepthStencil(depthDesc);
+        frame.mShadowC = graph.CreateDepthStencil(depthDesc);
+        frame.mUnused = graph.CreateRenderTarget(colorDesc);
+
+        auto addPass = [&graph, &executed](const char* name, uint16_t index)
+        {
+            return graph.AddPass(name, [&executed, index](RHIGraphicsContext* pContext)
+            {
+                executed.push_back(index);
+                return pContext;
+            });
+        };
+        uint16_t pass = addPass("ShadowA", 0);
+        graph.Write(pass, frame.mShadowA, ResourceAccess::DEPTH_WRITE);
+        pass = addPass("ShadowB", 1);
+        graph.Write(pass, frame.mShadowB, ResourceAccess::DEPTH_WRITE);
+        graph.Read(pass, frame.mShadowA, ResourceAccess::DEPTH_READ);
+        pass = addPass("LightingA", 2);
+        graph.Read(pass, frame.mShadowB, ResourceAccess::DEPTH_READ);
+        graph.Write(pass, backBuffer, ResourceAccess::RENDER_TARGET);
+        pass = addPass("ShadowC", 3);
+        graph.Write(pass, frame.mShadowC, ResourceAccess::DEPTH_WRITE);
+        pass = addPass("LightingC", 4);
+        graph.Read(pass, frame.mShadowC, ResourceAccess::DEPTH_READ);
+        graph.Write(pass, backBuffer, ResourceAccess::RENDER_TARGET);
+        // nothing reads what it writes
+        frame.mUnusedPass = addPass("Unused", 5);
+        graph.Write(frame.mUnusedPass, frame.mUnused, ResourceAccess::RENDER_TARGET);
+        return frame;
+    }
+}
+
+int main()
+{
+    NullRHI rhi;
+    rhi.Initialize();
+    rhi.SetRecordCommands(true);
+    RHISwapChainDesc swapChainDesc{0, 0, 0, 1, 2, Format::R8G8B8A8_UNORM, false};
+    auto swapChain = rhi.RHICreateSwapChain(swapChainDesc);
+    RHIGraphicsContext* context;
+    rhi.RHICreateGraphicsContext(&context);
+    auto fence = rhi.RHICreateFence();
+
+    RenderGraph graph;
+    graph.Initialize(&rhi);
+    for (uint64_t frameIndex = 1; frameIndex <= 2; ++frameIndex)
+    {
+        std::vector<uint16_t> executed;
+        Frame frame = DeclareFrame(graph, swapChain->GetCurrentColorTexture(), executed);
+        graph.Compile();
+
+        // the second frame declares the same graph and keeps the compiled one
+        CHECK(graph.GetNumCompilations() == 1);
+        CHECK(graph.IsPassCulled(frame.mUnusedPass));
+        CHECK(graph.GetNumTransientTextures() == 2);
+        CHECK(graph.GetDepthStencil(frame.mShadowA) == graph.GetDepthStencil(frame.mShadowC));
+        CHECK(graph.GetDepthStencil(frame.mShadowA) != graph.GetDepthStencil(frame.mShadowB));
+
+        rhi.RHIResetGraphicsContext(context);
+        swapChain->BeginFrame(context);
+        CHECK(graph.Execute(context) == context);
+        swapChain->EndFrame(context);
+        rhi.RHISubmitRenderCommands(context);
+        rhi.RHISyncGraphicContext(fence.get(), frameIndex);
+        swapChain->Present();
+        CHECK((executed == std::vector<uint16_t>{0, 1, 2, 3, 4}));
+
+        // ShadowC starts in the read state ShadowA left the shared texture in and transitions back to depth write
+        std::vector<uint16_t> batches;
+        std::vector<uint64_t> firstResources;
+        for (const NullCommand& command : rhi.GetLastCommandStream())
+        {
+            if (command.mType != NullCommandType::TRANSITION_RESOURCES) continue;
+            batches.push_back(command.mCount);
+            firstResources.push_back(command.mObject);
+        }
+        CHECK((batches == std::vector<uint16_t>{1, 2, 2, 1, 1}));
+        CHECK(batches.size() == 5 && firstResources[3] == reinterpret_cast<uint64_t>(graph.GetDepthStencil(frame.mShadowC)));
+        CHECK(batches.size() == 5 && firstResources[1] == reinterpret_cast<uint64_t>(graph.GetDepthStencil(frame.mShadowB)));
+        CHECK(rhi.GetLastFrameStats().mBarriers == 7);
+    }
+
+    rhi.RHIReleaseGraphicsContext(context);
+    rhi.Release();
+    return TEST_RESULT();
+}
@@ -0,0 +1,236 @@
+// Render item sorting: the radix sort matches a stable comparison sort, the keys order opaque items front to back,
+// transparent ones back to front and overlays in submission order, and the forward recorder binds fewer pipelines
+// and descriptors for a mixed scene once it is sorted.
+#include "Engine/Render/ForwardRecorder.h"
+#include "Engine/Render/Null/NullRHI.h"
+#include "Engine/Render/Blob.h"
+#include "TestCommon.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    bool SameOrder(const std::vector<SortedRenderItem>& a, const std::vector<SortedRenderItem>& b)
+    {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].mKey != b[i].mKey || a[i].mIndex != b[i].mIndex) return false;
+        }
+        return true;
+    }
+
+    void TestRadixSort()
+    {
+        std::mt19937_64 random(7);
+        std::vector<SortedRenderItem> scratch;
+        for (const uint32_t count : { 0u, 1u, 2u, 100u, 5000u })
+        {
+            // full width keys, keys with many duplicates and keys differing only in a few digits
+            for (const uint64_t mask : { ~0ull, 0x7ull, 0xff00000000ff00ull })
+            {
+                std::vector<SortedRenderItem> items(count);
+                for (uint32_t i = 0; i < count; ++i) items[i] = { random() & mask, i };
+                std::vector<SortedRenderItem> expected = items;
+                std::stable_sort(expected.begin(), expected.end(),
+                    [](const SortedRenderItem& a, const SortedRenderItem& b) { return a.mKey < b.mKey; });
+                RadixSortRenderItems(items, scratch);
+                CHECK(SameOrder(items, expected));
+            }
+        }
+    }
+
+    void TestKeyOrder()
+    {
+        const int meshes[2] = {};
+        std::vector<SortedRenderItem> items;
+        std::vector<SortedRenderItem> scratch;
+        // submitted far to near, the overlays in between
+        const float depths[] = { 80.0f, 40.0f, 20.0f, 10.0f, 5.0f, 2.5f, 0.5f, 0.0f };
+        uint32_t index = 0;
+        for (const float depth : depths)
+        {
+            items.push_back({ RenderSortKey::Opaque(1, 2, &meshes[0], depth), index++ });
+            items.push_back({ RenderSortKey::Transparent(1, 2, &meshes[1], depth), index++ });
+            items.push_back({ RenderSortKey::Overlay(index), index++ });
+        }
+        std::shuffle(items.begin(), items.end(), std::mt19937(3));
+        RadixSortRenderItems(items, scratch);
+
+        const size_t numDepths = sizeof(depths) / sizeof(depths[0]);
+        CHECK(items.size() == 3 * numDepths);
+        for (size_t i = 0; i < numDepths; ++i)
+        {
+            const SortedRenderItem& opaque = items[i];
+            const SortedRenderItem& transparent = items[numDepths + i];
+            const SortedRenderItem& overlay = items[2 * numDepths + i];
+            CHECK(RenderSortKey::GetLayer(opaque.mKey) == RenderSortKey::LAYER_OPAQUE);
+            CHECK(RenderSortKey::GetLayer(transparent.mKey) == RenderSortKey::LAYER_TRANSPARENT);
+            CHECK(RenderSortKey::GetLayer(overlay.mKey) == RenderSortKey::LAYER_OVERLAY);
+            // opaque front to back, transparent back to front
+            CHECK(opaque.mIndex / 3 == numDepths - 1 - i);
+            CHECK(transparent.mIndex / 3 == i);
+            CHECK(overlay.mIndex == 3 * i + 2);
+        }
+    }
+
+    // shaders, materials and meshes shared by the items of a scene
+    struct Scene
+    {
+        static constexpr uint32_t SHADERS = 4;
+        static constexpr uint32_t MATERIALS_PER_SHADER = 4;
+        static constexpr uint32_t MESHES = 8;
+
+        std::vector<std::unique_ptr<RHIShader>> mShaders;
+        std::vector<std::unique_ptr<Material>> mMaterials;
+        std::vector<std::unique_ptr<MaterialInstance>> mInstances;
+        std::vector<std::unique_ptr<RHINativeTexture>> mTextures;
+        std::vector<std::unique_ptr<RHIVertexBuffer>> mVertexBuffers;
+        std::vector<std::unique_ptr<RHIIndexBuffer>> mIndexBuffers;
+        std::vector<RenderItem> mItems;
+    };
+
+    void CreateScene(NullRHI& rhi, Scene& scene, uint32_t numItems)
+    {
+        const char* source = "cbuffer MaterialConstants : register(b2) { float4 color; };\nTexture2D<float4> gAlbedo : register(t0);\n";
+        const Blob blob{ source, strlen(source) };
+        for (uint32_t shader = 0; shader < Scene::SHADERS; ++shader)
+        {
+            scene.mShaders.push_back(rhi.RHICompileShader(blob, static_cast<ShaderType>(ShaderType::VERTEX | ShaderType::PIXEL)));
+            Material* pMaterial = new Material();
+            pMaterial->mShader = scene.mShaders.back().get();
+            pMaterial->mNumConstants = 1;
+            pMaterial->mConstants.reset(new ConstantProperty[1]{ ConstantProperty(TEXT("MaterialConstants"), 2, 16) });
+            pMaterial->mNumTextures = 1;
+            pMaterial->mTextures.reset(new TextureProperty[1]{ TextureProperty(TEXT("gAlbedo"), 0, TextureDimension::TEXTURE2D) });
+            scene.mMaterials.emplace_back(pMaterial);
+            for (uint32_t i = 0; i < Scene::MATERIALS_PER_SHADER; ++i)
+            {
+                scene.mTextures.push_back(rhi.RHIAllocTexture({ Format::R8G8B8A8_UNORM, TextureDimension::TEXTURE2D, 4, 4, 1, 1, 1, 0 }));
+                MaterialInstance* pInstance = new MaterialInstance();
+                pInstance->InstantiateFrom(pMaterial);
+                pInstance->SetMaterialInstanceId(scene.mInstances.size() + 1);
+                pInstance->SetTexture(0, TextureRef(scene.mTextures.size(), scene.mTextures.back().get()));
+                scene.mInstances.emplace_back(pInstance);
+            }
+        }
+        for (uint32_t mesh = 0; mesh < Scene::MESHES; ++mesh)
+        {
+            scene.mVertexBuffers.push_back(rhi.RHIAllocVertexBuffer(32, 24));
+            scene.mIndexBuffers.push_back(rhi.RHIAllocIndexBuffer(36, Format::R16_UINT));
+        }
+
+        // opaque items, every eighth one blended and every 64th one an overlay
+        std::mt19937 random(11);
+        std::uniform_real_distribution<float> depth(1.0f, 100.0f);
+        const SubMesh subMesh{ 36, 0, 0 };
+        scene.mItems.resize(numItems);
+        for (uint32_t i = 0; i < numItems; ++i)
+        {
+            RenderItem& item = scene.mItems[i];
+            const uint32_t mesh = random() % Scene::MESHES;
+            item.mMeshData = MeshData(VertexBufferRef(mesh, scene.mVertexBuffers[mesh].get()), IndexBufferRef(mesh, scene.mIndexBuffers[mesh].get()),
+                24, 36, &subMesh, 1);
+            item.mMaterial = scene.mInstances[random() % scene.mInstances.size()].get();
+            item.mModel.m.m[2][3] = depth(random);
+        }
+        for (uint32_t i = 0; i < numItems; i += 8)
+        {
+            // blended copies of the materials, a material instance is either blended or not
+            MaterialInstance* pBlended = new MaterialInstance();
+            pBlended->InstantiateFrom(scene.mMaterials[i / 8 % Scene::SHADERS].get());
+            pBlended->SetMaterialInstanceId(scene.mInstances.size() + 1);
+            pBlended->SetTexture(0, TextureRef(1, scene.mTextures[0].get()));
+            pBlended->setBlend(i % 64 ? BlendDesc::Color() : BlendDesc::Disabled());
+            if (i % 64 == 0)
+            {
+                DepthTestDesc depthTest = DepthTestDesc::Default();
+                depthTest.mEnableDepthTest = false;
+                pBlended->setDepthTest(depthTest);
+            }
+            scene.mInstances.emplace_back(pBlended);
+            scene.mItems[i].mMaterial = pBlended;
+        }
+    }
+
+    NullFrameStats RecordFrame(NullRHI& rhi, const ForwardRecorder& recorder, VirtualLinearAllocator& arena, const Scene& scene,
+        const std::vector<SortedRenderItem>& order, const CameraConstants& cameraConstants)
+    {
+        RHIGraphicsContext* pContext;
+        rhi.RHICreateGraphicsContext(&pContext);
+        rhi.RHIResetGraphicsContext(pContext);
+        recorder.Record(pContext, arena, PipelineInitializer::Default(), scene.mItems, order.data(), order.data() + order.size(), cameraConstants);
+        rhi.RHISubmitRenderCommands(pContext);
+        rhi.EndFrame();
+        rhi.RHIReleaseGraphicsContext(pContext);
+        arena.Reset();
+        return rhi.GetLastFrameStats();
+    }
+
+    void TestStateChanges(NullRHI& rhi)
+    {
+        constexpr uint32_t ITEMS = 2048;
+        Scene scene;
+        CreateScene(rhi, scene, ITEMS);
+        ObjectConstantPool objectConstants;
+        objectConstants.Initialize(&rhi, 16);
+        MaterialConstantPool materialConstants;
+        materialConstants.Initialize(&rhi, 16);
+        ForwardRecorder recorder;
+        recorder.Initialize(&rhi, &objectConstants, &materialConstants);
+        VirtualLinearAllocator arena;
+        arena.Initialize(16ull * 1024 * 1024, 64ull * 1024);
+        CameraConstants cameraConstants{ Matrix4x4::Identity, Matrix4x4::Identity, Matrix4x4::Identity, Matrix4x4::Identity };
+
+        // submission order against the order of the sort keys
+        std::vector<SortedRenderItem> submitted;
+        std::vector<SortedRenderItem> sorted;
+        std::vector<SortedRenderItem> scratch;
+        PipelineInitializer scratchPSO = PipelineInitializer::Default();
+        for (uint32_t i = 0; i < ITEMS; ++i)
+        {
+            RenderItem& item = scene.mItems[i];
+            item.mSortKey = ForwardRecorder::SortKey(item, i, cameraConstants, scratchPSO);
+            submitted.push_back({ item.mSortKey, i });
+        }
+        sorted = submitted;
+        RadixSortRenderItems(sorted, scratch);
+
+        // the transparent items of a pipeline stay apart, they are ordered by depth first
+        uint32_t numTransparent = 0;
+        for (const SortedRenderItem& item : sorted)
+        {
+            numTransparent += RenderSortKey::GetLayer(item.mKey) == RenderSortKey::LAYER_TRANSPARENT;
+        }
+        const NullFrameStats unsortedStats = RecordFrame(rhi, recorder, arena, scene, submitted, cameraConstants);
+        const NullFrameStats sortedStats = RecordFrame(rhi, recorder, arena, scene, sorted, cameraConstants);
+        std::printf("%u items, %u transparent: pipeline changes %u -> %u, descriptor updates %u -> %u, vertex and index binds %u -> %u\n",
+            ITEMS, numTransparent, unsortedStats.mPipelineStateChanges, sortedStats.mPipelineStateChanges,
+            unsortedStats.mDescriptorUpdates, sortedStats.mDescriptorUpdates, unsortedStats.mVertexIndexBinds, sortedStats.mVertexIndexBinds);
+
+        CHECK(sortedStats.mDrawCalls == ITEMS && unsortedStats.mDrawCalls == ITEMS);
+        // one change per opaque pipeline and blend state, at worst one per transparent or overlay item
+        CHECK(sortedStats.mPipelineStateChanges <= 2 * Scene::SHADERS + numTransparent + ITEMS / 64);
+        CHECK(sortedStats.mPipelineStateChanges * 4 < unsortedStats.mPipelineStateChanges);
+        // every item binds its object constants, materials only bind their constants and texture when they change
+        CHECK(sortedStats.mDescriptorUpdates * 2 < unsortedStats.mDescriptorUpdates);
+        CHECK(sortedStats.mVertexIndexBinds < unsortedStats.mVertexIndexBinds);
+    }
+}
+
+int main()
+{
+    TestRadixSort();
+    TestKeyOrder();
+
+    NullRHI rhi;
+    rhi.Initialize();
+    TestStateChanges(rhi);
+    rhi.Release();
+    return TEST_RESULT();
+}
@@ -0,0 +1,256 @@
+// The split state tracking over a mock resource: first uses stay pending until Resolve, promotion needs no barrier,
+// subresources diverge and collapse back into one barrier, back to back lists merge and the copy queue decays.
+#include "Engine/Render/ResourceStateTracking.h"
+#include "TestCommon.h"
+
+namespace
+{
+    // bits like the d3d12 states, COMMON is zero
+    enum class MockState : uint32_t
+    {
+        COMMON = 0,
+        SHADER_RESOURCE = 1 << 0,
+        COPY_SOURCE = 1 << 1,
+        COPY_DEST = 1 << 2,
+        RENDER_TARGET = 1 << 3,
+        UNKNOWN = 0xffffffff,
+    };
+
+    constexpr MockState operator|(MockState a, MockState b)
+    {
+        return static_cast<MockState>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+    }
+
+    class MockResource
+    {
+    public:
+        MockResource(uint32_t numSubResources, bool isBuffer, MockState state)
+        {
+            mTrackedState.Initialize(numSubResources, isBuffer, state);
+        }
+        TrackedResourceState<MockState>& GetTrackedState() const { return mTrackedState; }
+
+    private:
+        mutable TrackedResourceState<MockState> mTrackedState;
+    };
+
+    // a reduced version of the d3d12 rules: textures promote from COMMON to shader and copy states, buffers to any
+    // state, and buffers combine read states without barriers.
+    struct MockTraits
+    {
+        using Resource = MockResource;
+        using State = MockState;
+
+        static constexpr MockState DECAYED_STATE = MockState::COMMON;
+
+        static bool ImplicitTransition(MockState before, MockState& after, bool isBufferOrSimultaneous)
+        {
+            constexpr MockState READ = MockState::SHADER_RESOURCE | MockState::COPY_SOURCE;
+            constexpr MockState PROMOTABLE = READ | MockState::COPY_DEST;
+            const auto isIn = [](MockState state, MockState mask)
+            {
+                return (static_cast<uint32_t>(state) & ~static_cast<uint32_t>(mask)) == 0;
+            };
+
+            if (before == after) return true;
+            if (before == MockState::COMMON) return isBufferOrSimultaneous || isIn(after, PROMOTABLE);
+            if (isBufferOrSimultaneous && isIn(before, READ) && isIn(after, READ))
+            {
+                after = before | after;
+                return true;
+            }
+            return false;
+        }
+    };
+
+    using Tracker = LocalResourceStateTracker<MockTraits>;
+    using Transition = Tracker::Transition;
+
+    bool IsTransition(const Transition& transition, const MockResource& resource, uint32_t subResource,
+                      MockState before, MockState after)
+    {
+        return transition.mResource == &resource && transition.mSubResource == subResource &&
+            transition.mBefore == before && transition.mAfter == after;
+    }
+
+    void TestPendingFirstUse()
+    {
+        MockResource texture(1, false, MockState::RENDER_TARGET);
+        Tracker tracker;
+        std::vector<Transition> transitions;
+
+        // the state before the list is unknown while recording
+        tracker.Convert(&texture, MockState::SHADER_RESOURCE, transitions);
+        CHECK(transitions.empty());
+        CHECK(tracker.GetNumTrackedResources() == 1);
+        // later uses in the same list transition from the previous one
+        tracker.Convert(&texture, MockState::COPY_DEST, transitions);
+        CHECK(transitions.size() == 1);
+        CHECK(IsTransition(transitions[0], texture, 0, MockState::SHADER_RESOURCE, MockState::COPY_DEST));
+        // recording did not touch the global state
+        CHECK(texture.GetTrackedState().Get(0) == MockState::RENDER_TARGET);
+
+        transitions.clear();
+        tracker.Resolve(transitions);
+        CHECK(transitions.size() == 1);
+        CHECK(IsTransition(transitions[0], texture, 0, MockState::RENDER_TARGET, MockState::SHADER_RESOURCE));
+        CHECK(texture.GetTrackedState().Get(0) == MockState::COPY_DEST);
+        CHECK(tracker.GetNumTrackedResources() == 0);
+
+        // a list which does not use the resource leaves it alone
+        transitions.clear();
+        tracker.Resolve(transitions);
+        CHECK(transitions.empty());
+        CHECK(texture.GetTrackedState().Get(0) == MockState::COPY_DEST);
+    }
+
+    void TestPromotion()
+    {
+        MockResource texture(1, false, MockState::COMMON);
+        MockResource target(1, false, MockState::COMMON);
+        MockResource buffer(1, true, MockState::COMMON);
+        Tracker tracker;
+        std::vector<Transition> transitions;
+
+        tracker.Convert(&texture, MockState::SHADER_RESOURCE, transitions);
+        tracker.Convert(&target, MockState::RENDER_TARGET, transitions);
+        tracker.Convert(&buffer, MockState::SHADER_RESOURCE, transitions);
+        // buffers widen read states instead of transitioning
+        tracker.Convert(&buffer, MockState::COPY_SOURCE, transitions);
+        CHECK(transitions.empty());
+
+        tracker.Resolve(transitions);
+        // textures only promote to shader and copy states
+        CHECK(transitions.size() == 1);
+        CHECK(IsTransition(transitions[0], target, 0, MockState::COMMON, MockState::RENDER_TARGET));
+        CHECK(texture.GetTrackedState().Get(0) == MockState::SHADER_RESOURCE);
+        CHECK(target.GetTrackedState().Get(0) == MockState::RENDER_TARGET);
+        CHECK(buffer.GetTrackedState().Get(0) == (MockState::SHADER_RESOURCE | MockState::COPY_SOURCE));
+
+        // a promoted buffer keeps the reads it combined
+        transitions.clear();
+        tracker.Convert(&buffer, MockState::COPY_SOURCE, transitions);
+        tracker.Resolve(transitions);
+        CHECK(transitions.empty());
+    }
+
+    void TestSubResources()
+    {
+        constexpr uint32_t ALL = Tracker::ALL_SUBRESOURCES;
+        MockResource texture(4, false, MockState::SHADER_RESOURCE);
+        Tracker tracker;
+        std::vector<Transition> transitions;
+
+        // a single mip diverges
+        tracker.ConvertSubResource(&texture, 2, MockState::RENDER_TARGET, transitions);
+        CHECK(transitions.empty());
+        tracker.Resolve(transitions);
+        CHECK(transitions.size() == 1);
+        CHECK(IsTransition(transitions[0], texture, 2, MockState::SHADER_RESOURCE, MockState::RENDER_TARGET));
+        CHECK(texture.GetTrackedState().Get(0) == MockState::SHADER_RESOURCE);
+        CHECK(texture.GetTrackedState().Get(2) == MockState::RENDER_TARGET);
+
+        // the whole resource only transitions the mip that differs
+        transitions.clear();
+        tracker.Convert(&texture, MockState::SHADER_RESOURCE, transitions);
+        tracker.Resolve(transitions);
+        CHECK(transitions.size() == 1);
+        CHECK(IsTransition(transitions[0], texture, 2, MockState::RENDER_TARGET, MockState::SHADER_RESOURCE));
+        CHECK(texture.GetTrackedState().Get(2) == MockState::SHADER_RESOURCE);
+
+        // every subresource moving from the same state collapses into one barrier, while resolving and recording
+        transitions.clear();
+        tracker.Convert(&texture, MockState::RENDER_TARGET, transitions);
+        CHECK(transitions.empty());
+        tracker.Convert(&texture, MockState::COPY_SOURCE, transitions);
+        CHECK(transitions.size() == 1);
+        CHECK(IsTransition(transitions[0], texture, ALL, MockState::RENDER_TARGET, MockState::COPY_SOURCE));
+        transitions.clear();
+        tracker.Resolve(transitions);
+        CHECK(transitions.size() == 1);
+        CHECK(IsTransition(transitions[0], texture, ALL, MockState::SHADER_RESOURCE, MockState::RENDER_TARGET));
+        for (uint32_t i = 0; i < 4; ++i) CHECK(texture.GetTrackedState().Get(i) == MockState::COPY_SOURCE);
+
+        // subresources the list did not touch yet stay pending
+        transitions.clear();
+        tracker.ConvertSubResource(&texture, 1, MockState::SHADER_RESOURCE, transitions);
+        tracker.Convert(&texture, MockState::COPY_DEST, transitions);
+        CHECK(transitions.size() == 1);
+        CHECK(IsTransition(transitions[0], texture, 1, MockState::SHADER_RESOURCE, MockState::COPY_DEST));
+        transitions.clear();
+        tracker.Resolve(transitions);
+        // the first uses differ, no single barrier covers them
+        CHECK(transitions.size() == 4);
+        for (const Transition& transition : transitions) CHECK(transition.mBefore == MockState::COPY_SOURCE);
+        CHECK(transitions[1].mAfter == MockState::SHADER_RESOURCE && transitions[2].mAfter == MockState::COPY_DEST);
+        for (uint32_t i = 0; i < 4; ++i) CHECK(texture.GetTrackedState().Get(i) == MockState::COPY_DEST);
+    }
+
+    void TestMerge()
+    {
+        MockResource texture(1, false, MockState::COMMON);
+        MockResource buffer(1, true, MockState::COMMON);
+        MockResource upload(1, true, MockState::COMMON);
+        Tracker first;
+        Tracker second;
+        std::vector<Transition> transitions;
+
+        first.Convert(&texture, MockState::RENDER_TARGET, transitions);
+        first.Convert(&upload, MockState::COPY_DEST, transitions);
+        second.Convert(&texture, MockState::SHADER_RESOURCE, transitions);
+        second.Convert(&buffer, MockState::COPY_DEST, transitions);
+        CHECK(transitions.empty());
+
+        // the barriers between the lists go in between, the pending uses of the first list move to the second
+        second.Merge(first, transitions);
+        CHECK(transitions.size() == 1);
+        CHECK(IsTransition(transitions[0], texture, 0, MockState::RENDER_TARGET, MockState::SHADER_RESOURCE));
+        CHECK(first.GetNumTrackedResources() == 0);
+        CHECK(second.GetNumTrackedResources() == 3);
+
+        transitions.clear();
+        second.Resolve(transitions);
+        CHECK(transitions.size() == 1);
+        CHECK(IsTransition(transitions[0], texture, 0, MockState::COMMON, MockState::RENDER_TARGET));
+        CHECK(texture.GetTrackedState().Get(0) == MockState::SHADER_RESOURCE);
+        CHECK(buffer.GetTrackedState().Get(0) == MockState::COPY_DEST);
+        // used by the first list only
+        CHECK(upload.GetTrackedState().Get(0) == MockState::COPY_DEST);
+    }
+
+    void TestCopyQueueDecay()
+    {
+        MockResource texture(2, false, MockState::COMMON);
+        MockResource buffer(1, true, MockState::COMMON);
+        Tracker tracker;
+        std::vector<Transition> transitions;
+
+        tracker.ConvertSubResource(&texture, 0, MockState::COPY_DEST, transitions);
+        tracker.ConvertSubResource(&texture, 1, MockState::COPY_SOURCE, transitions);
+        tracker.Convert(&buffer, MockState::COPY_SOURCE, transitions);
+        tracker.Resolve(transitions, true);
+        CHECK(transitions.empty());
+        // the states the list leaves are dropped, everything is back to COMMON
+        CHECK(texture.GetTrackedState().Get(0) == MockState::COMMON);
+        CHECK(texture.GetTrackedState().Get(1) == MockState::COMMON);
+        CHECK(buffer.GetTrackedState().Get(0) == MockState::COMMON);
+
+        // without decay the same list leaves its states behind
+        tracker.ConvertSubResource(&texture, 0, MockState::COPY_DEST, transitions);
+        tracker.ConvertSubResource(&texture, 1, MockState::COPY_SOURCE, transitions);
+        tracker.Resolve(transitions);
+        CHECK(transitions.empty());
+        CHECK(texture.GetTrackedState().Get(0) == MockState::COPY_DEST);
+        CHECK(texture.GetTrackedState().Get(1) == MockState::COPY_SOURCE);
+    }
+}
+
+int main()
+{
+    TestPendingFirstUse();
+    TestPromotion();
+    TestSubResources();
+    TestMerge();
+    TestCopyQueueDecay();
+    return TEST_RESULT();
+}
@@ -0,0 +1,126 @@
+// Checks the scalar math backend against the DirectXMath conventions of the PC one: matrices are stored transposed,
+// points are column vectors and the translation is the last column.
+#include "Engine/math/math.h"
+#include "TestCommon.h"
+
+namespace
+{
+    Vector4 Transform(const Matrix4x4& matrix, const Vector4& point)
+    {
+        float result[4];
+        const float p[4] = {point.v.x, point.v.y, point.v.z, point.v.w};
+        for (int row = 0; row < 4; ++row)
+        {
+            result[row] = matrix.m.m[row][0] * p[0] + matrix.m.m[row][1] * p[1] + matrix.m.m[row][2] * p[2] + matrix.m.m[row][3] * p[3];
+        }
+        return Vector4(result[0], result[1], result[2], result[3]);
+    }
+
+    void TestRotation()
+    {
+        // left handed, +x rotates to -z about +y
+        Matrix4x4 rotation;
+        rotation.setRotationY(MathUtils::kPiOver2);
+        Vector4 x = Transform(rotation, Vector4(1.0f, 0.0f, 0.0f, 1.0f));
+        CHECK_NEAR(x.v.x, 0.0f, 1e-5f);
+        CHECK_NEAR(x.v.z, -1.0f, 1e-5f);
+
+        Quaternion quaternion;
+        quaternion.setToTotateAboutY(MathUtils::kPiOver2);
+        Vector3 rotated(1.0f, 0.0f, 0.0f);
+        quaternion.QuaternionRotateVector(rotated);
+        CHECK_NEAR(rotated.v.x, 0.0f, 1e-5f);
+        CHECK_NEAR(rotated.v.z, -1.0f, 1e-5f);
+
+        // roll, pitch and yaw through the quaternion and the matrix setters agree
+        Matrix4x4 euler;
+        euler.setModelMatrix(Vector3(0.0f, 0.0f, 0.0f), Vector3(0.3f, 0.5f, 0.2f), Vector3(1.0f, 1.0f, 1.0f));
+        Quaternion rollPitchYaw;
+        rollPitchYaw.setQuaternionRotationRollPitchYaw(Vector3(0.3f, 0.5f, 0.2f));
+        Matrix4x4 fromQuaternion;
+        fromQuaternion.setModelMatrixQuaternion(Vector3(0.0f, 0.0f, 0.0f), rollPitchYaw, Vector3(1.0f, 1.0f, 1.0f));
+        for (int row = 0; row < 4; ++row)
+        {
+            for (int column = 0; column < 4; ++column) CHECK_NEAR(euler.m.m[row][column], fromQuaternion.m.m[row][column], 1e-5f);
+        }
+    }
+
+    void TestModelMatrix()
+    {
+        Matrix4x4 model;
+        model.setModelMatrix(Vector3(1.0f, 2.0f, 3.0f), Vector3(0.0f, MathUtils::kPiOver2, 0.0f), Vector3(2.0f, 2.0f, 2.0f));
+        CHECK_NEAR(model.m.m[0][3], 1.0f, 1e-6f);
+        CHECK_NEAR(model.m.m[1][3], 2.0f, 1e-6f);
+        CHECK_NEAR(model.m.m[2][3], 3.0f, 1e-6f);
+
+        // scale, then rotate, then translate
+        Vector4 x = Transform(model, Vector4(1.0f, 0.0f, 0.0f, 1.0f));
+        CHECK_NEAR(x.v.x, 1.0f, 1e-5f);
+        CHECK_NEAR(x.v.y, 2.0f, 1e-5f);
+        CHECK_NEAR(x.v.z, 1.0f, 1e-5f);
+
+        Matrix4x4 inverse = model;
+        inverse.inverseSelf();
+        Matrix4x4 identity = model * inverse;
+        for (int row = 0; row < 4; ++row)
+        {
+            for (int column = 0; column < 4; ++column) CHECK_NEAR(identity.m.m[row][column], row == column ? 1.0f : 0.0f, 1e-5f);
+        }
+
+        Matrix4x4 transposed = model.transpose();
+        CHECK(transposed.m.m[3][0] == model.m.m[0][3]);
+    }
+
+    void TestProjection()
+    {
+        // depth 0 on the near plane and 1 on the far one
+        Matrix4x4 projection;
+        projection.setPerspectiveProjection(MathUtils::kPiOver2, 16.0f / 9.0f, 0.1f, 100.0f);
+        Vector4 nearPoint = Transform(projection, Vector4(0.0f, 0.0f, 0.1f, 1.0f));
+        Vector4 farPoint = Transform(projection, Vector4(0.0f, 0.0f, 100.0f, 1.0f));
+        CHECK_NEAR(nearPoint.v.z / nearPoint.v.w, 0.0f, 1e-5f);
+        CHECK_NEAR(farPoint.v.z / farPoint.v.w, 1.0f, 1e-5f);
+
+        Matrix4x4 view;
+        view.lookAt(Vector3(0.0f, 0.0f, -10.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+        Vector4 origin = Transform(view, Vector4(0.0f, 0.0f, 0.0f, 1.0f));
+        CHECK_NEAR(origin.v.z, 10.0f, 1e-5f);
+    }
+
+    void TestQuaternion()
+    {
+        Quaternion a;
+        a.setToRotateAboutAxis(Vector3(0.0f, 0.0f, 1.0f), 0.4f);
+        Quaternion b;
+        b.setToRotateAboutAxis(Vector3(0.0f, 0.0f, 1.0f), 0.6f);
+        Quaternion product = a * b;
+        CHECK_NEAR(product.getRotationAngle(), 1.0f, 1e-5f);
+
+        Quaternion identity = a * a.getInverse();
+        CHECK_NEAR(identity.q.w, 1.0f, 1e-5f);
+
+        Quaternion half = slerp(a, b, 0.5f);
+        CHECK_NEAR(half.getRotationAngle(), 0.5f, 1e-5f);
+    }
+
+    void TestEulerAngles()
+    {
+        EulerAngles angles(0.0f, 3.0f * MathUtils::kPi, 0.0f);
+        angles.canonize();
+        CHECK_NEAR(std::fabs(angles.yaw), MathUtils::kPi, 1e-5f);
+
+        EulerAngles flipped(0.75f * MathUtils::kPi, 0.0f, 0.0f);
+        flipped.canonize();
+        CHECK_NEAR(flipped.pitch, 0.25f * MathUtils::kPi, 1e-5f);
+    }
+}
+
+int main()
+{
+    TestRotation();
+    TestModelMatrix();
+    TestProjection();
+    TestQuaternion();
+    TestEulerAngles();
+    return TEST_RESULT();
+}
@@ -0,0 +1,109 @@
+// Rebuilding the shader cache with a stub compiler reuses the unchanged stages and recompiles the ones whose source,
+// includes, defines or compile flags changed.
+#include "Engine/Render/ShaderCache.h"
+#include "TestCommon.h"
+
+#include <cstring>
+#include <map>
+
+namespace
+{
+    std::map<std::string, std::string> sFiles;
+    uint32_t sNumCompiles = 0;
+
+    bool ReadFile(const std::string& path, std::string& content)
+    {
+        auto itor = sFiles.find(path);
+        if (itor == sFiles.end()) return false;
+        content = itor->second;
+        return true;
+    }
+
+    // the bytecode is the entry point followed by the source, enough to tell the stages apart
+    bool Compile(const ShaderCache::CompileJob& job, const std::string& source, std::vector<uint8_t>& bytecode)
+    {
+        ++sNumCompiles;
+        if (source.find("error") != std::string::npos) return false;
+        bytecode.assign(job.mEntry, job.mEntry + strlen(job.mEntry));
+        bytecode.insert(bytecode.end(), source.begin(), source.end());
+        return true;
+    }
+
+    std::vector<ShaderCache::CompileJob> Jobs(uint32_t flags)
+    {
+        return {
+            { "Shaders/opaque.hlsl", "VsMain", "vs_5_1", {}, flags },
+            { "Shaders/opaque.hlsl", "PsMain", "ps_5_1", {}, flags },
+            { "Shaders/ui.hlsl", "VsMain", "vs_5_1", {}, flags },
+            { "Shaders/ui.hlsl", "PsMain", "ps_5_1", { "ALPHA_CLIP" }, flags },
+        };
+    }
+
+    ShaderCache::BuildStats Rebuild(ShaderCache& cache, const std::vector<ShaderCache::CompileJob>& jobs)
+    {
+        ShaderCache result;
+        sNumCompiles = 0;
+        const ShaderCache::BuildStats stats = ShaderCache::Build(cache, jobs, Compile, ReadFile, result);
+        // every rebuild goes through the archive like the builder and the runtime do
+        const std::vector<uint8_t> archive = result.Serialize();
+        CHECK(cache.Load(archive.data(), archive.size()));
+        return stats;
+    }
+}
+
+int main()
+{
+    sFiles["Shaders/Common/Common.hlsl"] = "float4 ObjectToClip();\n";
+    sFiles["Shaders/opaque.hlsl"] = "#include \"Common/Common.hlsl\"\nvoid VsMain() {}\nvoid PsMain() {}\n";
+    sFiles["Shaders/ui.hlsl"] = "void VsMain() {}\nvoid PsMain() {}\n";
+
+    ShaderCache cache;
+    ShaderCache::BuildStats stats = Rebuild(cache, Jobs(ShaderCache::COMPILE_FLAGS));
+    CHECK(stats.mNumCompiled == 4 && stats.mNumReused == 0 && stats.mNumFailed == 0);
+    CHECK(cache.GetNumEntries() == 4);
+
+    // nothing changed, nothing is compiled
+    stats = Rebuild(cache, Jobs(ShaderCache::COMPILE_FLAGS));
+    CHECK(stats.mNumCompiled == 0 && stats.mNumReused == 4 && sNumCompiles == 0);
+
+    // the runtime finds the stage it would compile
+    const std::string& opaque = sFiles["Shaders/opaque.hlsl"];
+    const void* pBytecode;
+    size_t size;
+    uint64_t key = ShaderCache::ComputeKey(opaque.data(), opaque.size(), "Shaders/opaque.hlsl", "PsMain", "ps_5_1", {},
+        ShaderCache::COMPILE_FLAGS, ReadFile);
+    CHECK(cache.Find(key, &pBytecode, &size) && size == strlen("PsMain") + opaque.size());
+    CHECK(memcmp(pBytecode, "PsMain", strlen("PsMain")) == 0);
+
+    // an edited include recompiles its dependents only
+    sFiles["Shaders/Common/Common.hlsl"] = "float4 ObjectToClip(float3 position);\n";
+    stats = Rebuild(cache, Jobs(ShaderCache::COMPILE_FLAGS));
+    CHECK(stats.mNumCompiled == 2 && stats.mNumReused == 2 && stats.mNumDropped == 2);
+    CHECK(!cache.Find(key, &pBytecode, &size));
+
+    // stages compiled with other flags are never found by the runtime
+    constexpr uint32_t DEBUG_FLAGS = ShaderCache::COMPILE_FLAGS | 1u;
+    stats = Rebuild(cache, Jobs(DEBUG_FLAGS));
+    CHECK(stats.mNumCompiled == 4 && stats.mNumReused == 0 && stats.mNumDropped == 4);
+    key = ShaderCache::ComputeKey(opaque.data(), opaque.size(), "Shaders/opaque.hlsl", "PsMain", "ps_5_1", {},
+        ShaderCache::COMPILE_FLAGS, ReadFile);
+    CHECK(!cache.Find(key, &pBytecode, &size));
+
+    // defines are part of the key
+    const std::string& ui = sFiles["Shaders/ui.hlsl"];
+    CHECK(ShaderCache::ComputeKey(ui.data(), ui.size(), "Shaders/ui.hlsl", "PsMain", "ps_5_1", { "ALPHA_CLIP" }, DEBUG_FLAGS, ReadFile) !=
+        ShaderCache::ComputeKey(ui.data(), ui.size(), "Shaders/ui.hlsl", "PsMain", "ps_5_1", {}, DEBUG_FLAGS, ReadFile));
+
+    // a failing stage and a removed shader
+    sFiles["Shaders/ui.hlsl"] = "error\n";
+    stats = Rebuild(cache, Jobs(DEBUG_FLAGS));
+    CHECK(stats.mNumFailed == 2 && stats.mNumReused == 2 && stats.mNumDropped == 2);
+    CHECK(cache.GetNumEntries() == 2);
+
+    // malformed archives are rejected
+    std::vector<uint8_t> archive = cache.Serialize();
+    archive.pop_back();
+    ShaderCache truncated;
+    CHECK(!truncated.Load(archive.data(), archive.size()) && truncated.GetNumEntries() == 0);
+    return TEST_RESULT();
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdio>
+
+// Minimal checks for the headless tests, failures are printed and counted, main returns TEST_RESULT().
+inline int& TestFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++TestFailures(); \
+        } \
+    } while (false)
+
+#define CHECK_NEAR(a, b, epsilon) CHECK(std::fabs((a) - (b)) <= (epsilon))
+
+#define TEST_RESULT() (TestFailures() == 0 ? (std::printf("passed\n"), 0) : (std::printf("%d failed\n", TestFailures()), 1))
@@ -0,0 +1,75 @@
+// Uploads are staged in the upload ring of the rhi, uploads it has no room for wait for older batches to retire.
+#include "Engine/Render/Null/NullRHI.h"
+#include "Engine/Render/UploadManager.h"
+#include "Engine/common/Exception.h"
+#include "TestCommon.h"
+
+#include <vector>
+
+int main()
+{
+    constexpr uint64_t RING_SIZE = 1024 * 1024;
+    constexpr uint64_t VERTICES = 600 * 1024 / 4;
+
+    NullRHI rhi;
+    rhi.Initialize();
+    rhi.GetUploadRing()->Initialize(RING_SIZE);
+    RHIGraphicsContext* context;
+    rhi.RHICreateGraphicsContext(&context);
+
+    UploadManager uploadManager;
+    uploadManager.Initialize(&rhi);
+    auto first = rhi.RHIAllocVertexBuffer(4, VERTICES);
+    auto second = rhi.RHIAllocVertexBuffer(4, VERTICES);
+    std::vector<uint8_t> data(VERTICES * 4, 7);
+
+    // the second upload does not fit next to the first one and waits for its batch
+    uploadManager.UploadBuffer(first.get(), data.data(), data.size(), false);
+    uploadManager.UploadBuffer(second.get(), data.data(), data.size(), false);
+    CHECK(first->GetBuffer()->GetUploadToken() == 1);
+    CHECK(second->GetBuffer()->GetUploadToken() == UploadManager::DEFERRED_TOKEN);
+    CHECK(rhi.GetUploadRing()->GetUsedSize() == data.size());
+
+    uploadManager.Submit(context);
+    CHECK(second->GetBuffer()->GetUploadToken() == UploadManager::DEFERRED_TOKEN);
+    // the copy queue of the null rhi finishes on submission, the next frame sees the first batch retired
+    uploadManager.Submit(context);
+    CHECK(uploadManager.IsReady(first->GetBuffer()));
+    CHECK(second->GetBuffer()->GetUploadToken() == 2);
+    CHECK(!uploadManager.IsReady(second->GetBuffer()));
+    uploadManager.Submit(context);
+    CHECK(uploadManager.IsReady(second->GetBuffer()));
+
+    // frame staging does not take the upload ring
+    const uint64_t used = rhi.GetUploadRing()->GetUsedSize();
+    auto frameStaging = rhi.RHIAllocStagingBuffer(RING_SIZE);
+    CHECK(rhi.GetUploadRing()->GetUsedSize() == used);
+
+    // a large upload into an empty ring must not fail at the offset the ring stopped at
+    auto large = rhi.RHIAllocVertexBuffer(4, RING_SIZE / 4);
+    std::vector<uint8_t> largeData(RING_SIZE, 3);
+    uploadManager.Submit(context);
+    uploadManager.UploadBuffer(large.get(), largeData.data(), largeData.size(), true);
+    CHECK(large->GetBuffer()->GetUploadToken() != UploadManager::DEFERRED_TOKEN);
+    uploadManager.Submit(context);
+    CHECK(uploadManager.IsReady(large->GetBuffer()));
+
+    // an upload larger than the whole ring can never be staged
+    uploadManager.Submit(context);
+    auto tooLarge = rhi.RHIAllocVertexBuffer(4, RING_SIZE / 2);
+    std::vector<uint8_t> tooLargeData(RING_SIZE * 2, 1);
+    bool thrown = false;
+    try
+    {
+        uploadManager.UploadBuffer(tooLarge.get(), tooLargeData.data(), tooLargeData.size(), false);
+    }
+    catch (const Exception&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    rhi.RHIReleaseGraphicsContext(context);
+    rhi.Release();
+    return TEST_RESULT();
+}
@@ -0,0 +1,78 @@
+// The virtual linear allocator: reserving commits nothing, allocations commit whole pages of the system even for
+// a smaller granularity, the base never moves, resetting keeps the pages and decommitting gives them back.
+#include "Engine/Memory/VirtualLinearAllocator.h"
+#include "TestCommon.h"
+
+#include <cstring>
+
+namespace
+{
+    bool IsFilled(const uint8_t* p, uint64_t size, uint8_t value)
+    {
+        for (uint64_t i = 0; i < size; ++i)
+        {
+            if (p[i] != value) return false;
+        }
+        return true;
+    }
+
+    void TestCommit()
+    {
+        const uint64_t pageSize = MEM_VIRTUAL_PAGE_SIZE();
+        VirtualLinearAllocator allocator;
+        // a granularity below the page size is raised to it
+        allocator.Initialize(64 * pageSize, 256);
+        uint8_t* base = allocator.GetBase();
+        CHECK(base && allocator.GetReservedSize() == 64 * pageSize && allocator.GetCommittedSize() == 0);
+
+        uint8_t* first = static_cast<uint8_t*>(allocator.AllocatePtr(100));
+        CHECK(first == base && allocator.GetCommittedSize() == pageSize);
+        // the whole committed page is writable
+        memset(first, 1, pageSize);
+
+        // growing commits the pages in between and keeps the data where it was
+        uint8_t* second = static_cast<uint8_t*>(allocator.AllocatePtr(3 * pageSize, 16));
+        CHECK(second && allocator.GetCommittedSize() == 4 * pageSize && allocator.GetBase() == base);
+        memset(second, 2, 3 * pageSize);
+        CHECK(IsFilled(first, 100, 1));
+        CHECK(allocator.GetUsedSize() == (second - base) + 3 * pageSize);
+
+        // past the reserved range
+        CHECK(allocator.Allocate(64 * pageSize) == MAXUINT64);
+        CHECK(allocator.AllocatePtr(64 * pageSize) == nullptr);
+        CHECK(allocator.GetCommittedSize() == 4 * pageSize);
+    }
+
+    void TestResetAndDecommit()
+    {
+        const uint64_t pageSize = MEM_VIRTUAL_PAGE_SIZE();
+        VirtualLinearAllocator allocator;
+        // the initial commit is rounded up to the granularity
+        allocator.Initialize(16 * pageSize, 2 * pageSize, pageSize + 1);
+        const uint64_t granularity = 2 * pageSize;
+        CHECK(allocator.GetCommittedSize() == granularity && allocator.GetUsedSize() == 0);
+
+        uint8_t* p = static_cast<uint8_t*>(allocator.AllocatePtr(pageSize));
+        memset(p, 3, pageSize);
+        // rewinding keeps the pages and their content
+        allocator.Reset();
+        CHECK(allocator.GetUsedSize() == 0 && allocator.GetCommittedSize() == granularity);
+        CHECK(allocator.AllocatePtr(pageSize) == p && IsFilled(p, pageSize, 3));
+
+        // decommitted pages come back zeroed
+        allocator.Reset(true);
+        CHECK(allocator.GetUsedSize() == 0 && allocator.GetCommittedSize() == 0);
+        CHECK(allocator.AllocatePtr(pageSize) == p && allocator.GetCommittedSize() == granularity);
+        CHECK(IsFilled(p, pageSize, 0));
+
+        allocator.Release();
+        CHECK(!allocator.GetBase() && allocator.GetReservedSize() == 0 && allocator.GetCommittedSize() == 0);
+    }
+}
+
+int main()
+{
+    TestCommit();
+    TestResetAndDecommit();
+    return TEST_RESULT();
+}
@@ -0,0 +1,114 @@
+// Offline builder of the shader cache loaded by FileManager::sLoadShaderCache.
+// Compiles every entry point found in the *.hlsl files of a directory with an external compiler and writes the bytecode
+// into the archive. Entries of an existing archive whose key is unchanged are kept without compiling.
+//
+//   ShaderCacheBuilder <shader directory> <archive> "<compiler command>" [D3DCOMPILE flags]
+//
+// {input}, {entry}, {profile} and {output} in the command are replaced for every stage, e.g.
+// "fxc /nologo /Zpc /T {profile} /E {entry} /Fo {output} {input}". The flags name the D3DCOMPILE_* options the command
+// applies and are part of the keys, the runtime only finds stages built with ShaderCache::COMPILE_FLAGS, the default.
+// Only needs the standard library:
+//   g++ -std=c++17 -O2 -IMiniEngine/Engine/Render MiniEngine/Tools/ShaderCacheBuilder/ShaderCacheBuilder.cpp MiniEngine/Engine/Render/ShaderCache.cpp
+#include "ShaderCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    void ReplaceAll(std::string& text, const std::string& pattern, const std::string& value)
+    {
+        for (size_t position = text.find(pattern); position != std::string::npos; position = text.find(pattern, position + value.size()))
+        {
+            text.replace(position, pattern.size(), value);
+        }
+    }
+
+    // whether `source` defines a function named `entry`, the runtime only compiles the stages a shader defines.
+    bool DefinesEntryPoint(const std::string& source, const char* entry)
+    {
+        const std::string name = entry;
+        for (size_t position = source.find(name); position != std::string::npos; position = source.find(name, position + 1))
+        {
+            size_t next = position + name.size();
+            while (next < source.size() && (source[next] == ' ' || source[next] == '\t')) ++next;
+            if (next < source.size() && source[next] == '(') return true;
+        }
+        return false;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 4 && argc != 5)
+    {
+        std::cerr << "usage: ShaderCacheBuilder <shader directory> <archive> \"<compiler command>\" [D3DCOMPILE flags]" << std::endl;
+        return 1;
+    }
+    const std::filesystem::path directory = argv[1];
+    const std::string archivePath = argv[2];
+    const std::string command = argv[3];
+    const uint32_t flags = argc == 5 ? static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 0)) : ShaderCache::COMPILE_FLAGS;
+    const std::string outputPath = archivePath + ".stage";
+
+    // paths are built like the runtime builds them, the includes are resolved relative to them.
+    std::vector<std::filesystem::path> files;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".hlsl") files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    std::vector<ShaderCache::CompileJob> jobs;
+    std::string source;
+    for (const std::filesystem::path& file : files)
+    {
+        if (!ShaderCache::ReadFile(file.generic_string(), source)) continue;
+        for (const ShaderCache::EntryPoint& entryPoint : ShaderCache::ENTRY_POINTS)
+        {
+            if (DefinesEntryPoint(source, entryPoint.mName)) jobs.push_back({ file.generic_string(), entryPoint.mName, entryPoint.mProfile, {}, flags });
+        }
+    }
+
+    ShaderCache previous;
+    std::string archive;
+    if (ShaderCache::ReadFile(archivePath, archive) && !previous.Load(archive.data(), archive.size()))
+    {
+        std::cout << "ignoring outdated archive " << archivePath << std::endl;
+    }
+
+    ShaderCache::CompileFunc compile = [&command, &outputPath](const ShaderCache::CompileJob& job, const std::string&, std::vector<uint8_t>& bytecode)
+    {
+        std::string stageCommand = command;
+        ReplaceAll(stageCommand, "{input}", "\"" + job.mPath + "\"");
+        ReplaceAll(stageCommand, "{entry}", job.mEntry);
+        ReplaceAll(stageCommand, "{profile}", job.mProfile);
+        ReplaceAll(stageCommand, "{output}", "\"" + outputPath + "\"");
+        std::remove(outputPath.c_str());
+        std::string output;
+        if (std::system(stageCommand.c_str()) != 0 || !ShaderCache::ReadFile(outputPath, output))
+        {
+            std::cerr << "failed to compile " << job.mEntry << " of " << job.mPath << std::endl;
+            return false;
+        }
+        bytecode.assign(output.begin(), output.end());
+        return true;
+    };
+    ShaderCache cache;
+    const ShaderCache::BuildStats stats = ShaderCache::Build(previous, jobs, compile, ShaderCache::ReadFile, cache);
+    std::remove(outputPath.c_str());
+
+    const std::vector<uint8_t> serialized = cache.Serialize();
+    std::ofstream output(archivePath, std::ios::binary | std::ios::trunc);
+    if (!output.write(reinterpret_cast<const char*>(serialized.data()), static_cast<std::streamsize>(serialized.size())))
+    {
+        std::cerr << "failed to write " << archivePath << std::endl;
+        return 1;
+    }
+    std::cout << cache.GetNumEntries() << " stages, " << stats.mNumCompiled << " compiled, " << stats.mNumReused << " reused, "
+        << stats.mNumDropped << " dropped, " << stats.mNumFailed << " failed, " << serialized.size() << " bytes" << std::endl;
+    return stats.mNumFailed ? 1 : 0;
+}